@@ -89,6 +89,14 @@ class CRawlogTreeView : public wxScrolledWindow
 	 * any. */
 	void SetSelectedItem(int index, bool force_refresh = false);
 	int GetSelectedItem() const { return m_selectedItem; }
+	/** Returns the index in the rawlog of the entry shown at the given row, or
+	 * -1 if the row does not exist. */
+	int GetRawlogIndexOfItem(int item) const
+	{
+		if (item < 0 || item >= static_cast<int>(m_tree_nodes.size()))
+			return -1;
+		return static_cast<int>(m_tree_nodes[item].index);
+	}
 
    protected:
 	void OnDrawImpl(wxDC& dc);
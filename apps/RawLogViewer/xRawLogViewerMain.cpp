@@ -12,6 +12,7 @@
 #include <mrpt/containers/stl_containers_utils.h>
 #include <mrpt/gui/WxUtils.h>
 #include <mrpt/gui/about_box.h>
+#include <mrpt/img/CExternalImageCache.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/io/CFileGZOutputStream.h>
 #include <mrpt/maps/CColouredPointsMap.h>
@@ -159,6 +160,11 @@ string loadedFileName = "noname.rawlog";
 float timeToLoad = 0;
 double experimentLenght = 0;
 
+// Memory for recently decoded external images, and number of rawlog entries
+// after the selected one whose external images are loaded in the background:
+const size_t EXTERNAL_IMAGE_CACHE_MB = 256;
+const size_t EXTERNAL_IMAGE_PREFETCH_ENTRIES = 10;
+
 xRawLogViewerFrame* theMainWindow = nullptr;
 
 extern std::unique_ptr<CConfigFile> iniFile;
@@ -1992,6 +1998,12 @@ void xRawLogViewerFrame::loadRawlogFile(const string& str, int first, int last)
 	toolbarcomboImages->Clear();
 	CImage::setImagesPathBase(CRawlog::detectImagesDirectory(str));
 
+	// Keep recently viewed external images in memory:
+	auto& imgCache = CExternalImageCache::Instance();
+	imgCache.clear();
+	if (!imgCache.enabled())
+		imgCache.setMaxMemory(EXTERNAL_IMAGE_CACHE_MB << 20);
+
 	// Add found dir to the combo:
 	toolbarcomboImages->Append(CImage::getImagesPathBase().c_str());
 	toolbarcomboImages->SetSelection(0);
@@ -2511,12 +2523,15 @@ void xRawLogViewerFrame::rebuildTreeView()
 // Selection has changed:
 void xRawLogViewerFrame::OntreeViewSelectionChanged(
 	wxWindow* me, CRawlogTreeView* the_tree, TRawlogTreeViewEvent /*ev*/,
-	int /*item_index*/,
-	const mrpt::serialization::CSerializable::Ptr& item_data)
+	int item_index, const mrpt::serialization::CSerializable::Ptr& item_data)
 {
 	auto* win = (xRawLogViewerFrame*)me;
 	win->SelectObjectInTreeView(item_data);
 	the_tree->SetFocus();
+
+	// Load the external images of the next entries in the background:
+	if (const int idx = the_tree->GetRawlogIndexOfItem(item_index); idx >= 0)
+		rawlog.prefetchExternalImages(idx + 1, EXTERNAL_IMAGE_PREFETCH_ENTRIES);
 }
 
 #if wxUSE_STARTUP_TIPS
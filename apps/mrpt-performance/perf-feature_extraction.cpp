@@ -40,6 +40,30 @@ double benchmark_detectFeatures(int N, [[maybe_unused]] int h)
 	return fExt.profiler.getMeanTime("detectFeatures");
 }
 
+// ------------------------------------------------------
+//				Benchmark: tiled detection (4x4 grid)
+// ------------------------------------------------------
+template <TKeyPointMethod FEAT_TYPE>
+double benchmark_detectFeaturesTiled(int N, int nThreads)
+{
+	CImage img;
+	getTestImage(0, img);
+	CFeatureExtraction fExt;
+	fExt.profiler.enable();
+	fExt.options.featsType = FEAT_TYPE;
+	fExt.options.tilingOptions.grid_cols = 4;
+	fExt.options.tilingOptions.grid_rows = 4;
+	fExt.options.tilingOptions.num_threads = nThreads;
+	for (int i = 0; i < N; i++)
+	{
+		CFeatureList fs;
+		fExt.detectFeatures(img, fs, 0, 500);
+		if (i == (N - 1))
+			std::cout << "(" << std::setw(4) << fs.size() << " found)\n";
+	}
+	return fExt.profiler.getMeanTime("detectFeatures");
+}
+
 // ------------------------------------------------------
 //				Benchmark: descriptor
 // ------------------------------------------------------
@@ -117,6 +141,16 @@ void register_tests_feature_extraction()
 		"feature_extraction [640x480]: FAST (OpenCV)",
 		benchmark_detectFeatures<featFAST>, 100);
 
+	lstTests.emplace_back(
+		"feature_extraction [640x480]: FAST, 4x4 tiles, 1 thread",
+		benchmark_detectFeaturesTiled<featFAST>, 100, 1);
+	lstTests.emplace_back(
+		"feature_extraction [640x480]: FAST, 4x4 tiles, 4 threads",
+		benchmark_detectFeaturesTiled<featFAST>, 100, 4);
+	lstTests.emplace_back(
+		"feature_extraction [640x480]: ORB, 4x4 tiles, 4 threads",
+		benchmark_detectFeaturesTiled<featORB>, 10, 4);
+
 	MRPT_TODO("AKAZE crashes inside OpenCV. Disabled for now (Jan 2019)");
 #if 0
 	lstTests.emplace_back(
@@ -8,7 +8,14 @@
    +------------------------------------------------------------------------+ */
 
 #include <mrpt/img/CImage.h>
+#include <mrpt/random/RandomGenerators.h>
+#include <mrpt/vision/CBoWDatabase.h>
 #include <mrpt/vision/CFeatureExtraction.h>
+#include <mrpt/vision/CVisualVocabulary.h>
+#include <mrpt/vision/binary_descriptors.h>
+#include <mrpt/vision/utils.h>
+
+#include <map>
 
 #include "common.h"
 
@@ -258,6 +265,127 @@ double feature_matching_test_FAST_SAD(int w, int h)
 	return T;
 }
 
+// ------------------------------------------------------
+//		Benchmark: brute-force matching of random ORB descriptors
+// ------------------------------------------------------
+static void randomORBFeatures(CFeatureList& lst, size_t n)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	lst.resize(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		auto& f = lst[i];
+		f.type = featORB;
+		f.keypoint.ID = i;
+		f.descriptors.ORB.emplace(32);
+		for (auto& b : *f.descriptors.ORB)
+			b = static_cast<uint8_t>(rng.drawUniform32bit());
+	}
+}
+
+double feature_matching_test_ORB_matrix(int nFeats, int ratioTest)
+{
+	CFeatureList featsL, featsR;
+	randomORBFeatures(featsL, nFeats);
+	randomORBFeatures(featsR, nFeats);
+
+	CTicTac tictac;
+	const size_t N = 10;
+	size_t nMatches = 0;
+
+	TBinaryMatchingOptions opts;
+	if (ratioTest) opts.ratio = 0.8f;
+
+	tictac.Tic();
+	for (size_t i = 0; i < N; i++)
+	{
+		featsL.buildDescriptorMatrix(descORB);
+		featsR.buildDescriptorMatrix(descORB);
+		nMatches += match_binary_descriptors(
+						featsL.descriptorMatrix(), featsR.descriptorMatrix(),
+						opts)
+						.size();
+	}
+	const double T = tictac.Tac() / N;
+	dummy_do_nothing_with_string(std::to_string(nMatches));
+	return T;
+}
+
+double feature_matching_test_ORB_matchFeatures(int nFeats, int h)
+{
+	CFeatureList featsL, featsR;
+	randomORBFeatures(featsL, nFeats);
+	randomORBFeatures(featsR, nFeats);
+
+	TMatchingOptions opt;
+	opt.matching_method = TMatchingOptions::mmDescriptorORB;
+	opt.useEpipolarRestriction = false;
+	opt.useXRestriction = false;
+
+	CMatchedFeatureList matches;
+	CTicTac tictac;
+	const size_t N = 5;
+
+	tictac.Tic();
+	for (size_t i = 0; i < N; i++)
+		matchFeatures(featsL, featsR, matches, opt);
+	const double T = tictac.Tac() / N;
+	dummy_do_nothing_with_string(std::to_string(matches.size()));
+	return T;
+}
+
+static TBagOfWords randomBoW(size_t nWords, size_t vocabularySize)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	std::map<TVisualWordID, float> m;
+	for (size_t i = 0; i < nWords; i++)
+		m[rng.drawUniform32bit() % vocabularySize] += 1.0f / nWords;
+	return TBagOfWords(m.begin(), m.end());
+}
+
+double feature_matching_test_BoW_query(int nImages, int h)
+{
+	// Bag-of-words vectors with ~200 words, out of 1M:
+	const size_t nWords = 200, vocabularySize = 1000000;
+	CBoWDatabase db;
+	for (int i = 0; i < nImages; i++)
+		db.add(randomBoW(nWords, vocabularySize));
+
+	std::vector<TBagOfWords> queries;
+	for (int i = 0; i < 20; i++)
+		queries.push_back(randomBoW(nWords, vocabularySize));
+
+	std::vector<CBoWDatabase::TResult> res;
+	CTicTac tictac;
+	for (const auto& q : queries)
+		db.query(q, 10, res);
+	const double T = tictac.Tac() / queries.size();
+	dummy_do_nothing_with_string(std::to_string(res.size()));
+	return T;
+}
+
+double feature_matching_test_BoW_transform(int nFeats, int h)
+{
+	// Vocabulary from 10^5 random ORB descriptors:
+	std::vector<CFeatureList> training(50);
+	for (auto& img : training)
+		randomORBFeatures(img, 2000);
+	CVisualVocabulary voc;
+	voc.train(training);
+
+	CFeatureList feats;
+	randomORBFeatures(feats, nFeats);
+
+	TBagOfWords bow;
+	CTicTac tictac;
+	const size_t N = 10;
+	for (size_t i = 0; i < N; i++)
+		voc.transform(feats, bow);
+	const double T = tictac.Tac() / N;
+	dummy_do_nothing_with_string(std::to_string(bow.size()));
+	return T;
+}
+
 // ------------------------------------------------------
 // register_tests_feature_extraction
 // ------------------------------------------------------
@@ -281,4 +409,19 @@ void register_tests_feature_matching()
 	lstTests.emplace_back(
 		"feature_matching [640x480]: FAST + SAD",
 		feature_matching_test_FAST_SAD, 640, 480);
+	lstTests.emplace_back(
+		"feature_matching: 5000x5000 ORB, descriptor matrix",
+		feature_matching_test_ORB_matrix, 5000, 0);
+	lstTests.emplace_back(
+		"feature_matching: 5000x5000 ORB, descriptor matrix + ratio test",
+		feature_matching_test_ORB_matrix, 5000, 1);
+	lstTests.emplace_back(
+		"feature_matching: 5000x5000 ORB, matchFeatures()",
+		feature_matching_test_ORB_matchFeatures, 5000, 0);
+	lstTests.emplace_back(
+		"feature_matching: BoW database query, 100k images",
+		feature_matching_test_BoW_query, 100000, 0);
+	lstTests.emplace_back(
+		"feature_matching: BoW transform() 1000 ORB features",
+		feature_matching_test_BoW_transform, 1000, 0);
 }
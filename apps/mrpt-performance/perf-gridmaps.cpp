@@ -202,6 +202,51 @@ double grid_test_9(int a1, int a2)
 	return tictac.Tac() / a1;
 }
 
+// a1: 0=laserScanSimulator() one scan at a time; 1=laserScanSimulatorBatch()
+// with rcmStepping; 2=laserScanSimulatorBatch() with rcmDistanceField
+double grid_test_10(int a1, int a2)
+{
+	getRandomGenerator().randomize(333);
+
+	// Build a map from a scan as seen from several poses:
+	CObservation2DRangeScan scan1;
+	stock_observations::example2DRangeScan(scan1);
+
+	COccupancyGridMap2D gridmap(-20, 20, -20, 20, 0.05f);
+	for (int i = 0; i < 10; i++)
+		gridmap.insertObservation(
+			scan1, CPose3D(0.1 * i, 0.05 * i, 0, DEG2RAD(1.0 * i), 0, 0));
+
+	const size_t N = 1000;
+	std::vector<CPose2D> poses;
+	for (size_t i = 0; i < N; i++)
+		poses.emplace_back(
+			getRandomGenerator().drawUniform(-1.0, 1.0),
+			getRandomGenerator().drawUniform(-1.0, 1.0),
+			getRandomGenerator().drawUniform(-M_PI, M_PI));
+
+	COccupancyGridMap2D::TLaserSimulBatchParams params;
+	params.method = a1 == 2 ? COccupancyGridMap2D::rcmDistanceField
+							: COccupancyGridMap2D::rcmStepping;
+	if (a1 == 2) gridmap.computeClearanceMap(params.threshold);
+
+	std::vector<CObservation2DRangeScan> scans;
+	CTicTac tictac;
+	if (a1 == 0)
+	{
+		CObservation2DRangeScan scan;
+		scan.aperture = params.aperture;
+		scan.maxRange = params.maxRange;
+		for (const auto& pose : poses)
+			gridmap.laserScanSimulator(
+				scan, pose, params.threshold, params.nRays);
+	}
+	else
+		gridmap.laserScanSimulatorBatch(params, poses, scans);
+
+	return tictac.Tac() / N;
+}
+
 // ------------------------------------------------------
 // register_tests_grids
 // ------------------------------------------------------
@@ -218,4 +263,12 @@ void register_tests_grids()
 	lstTests.emplace_back("gridmap2D: resize", grid_test_7);
 	lstTests.emplace_back("gridmap2D: computeLikelihood", grid_test_8);
 	lstTests.emplace_back("gridmap2D: determineMatching2D", grid_test_9, 5000);
+	lstTests.emplace_back(
+		"gridmap2D: laserScanSimulator (per scan)", grid_test_10, 0);
+	lstTests.emplace_back(
+		"gridmap2D: laserScanSimulatorBatch stepping (per scan)", grid_test_10,
+		1);
+	lstTests.emplace_back(
+		"gridmap2D: laserScanSimulatorBatch dist.field (per scan)",
+		grid_test_10, 2);
 }
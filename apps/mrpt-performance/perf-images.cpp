@@ -10,6 +10,7 @@
 #include <mrpt/config/CConfigFileMemory.h>
 #include <mrpt/core/cpu.h>
 #include <mrpt/img/CImage.h>
+#include <mrpt/img/CImageBufferPool.h>
 #include <mrpt/img/TStereoCamera.h>
 #include <mrpt/random.h>
 #include <mrpt/system/filesystem.h>
@@ -172,10 +173,12 @@ double image_halfsample(int w, int h)
 
 	const bool savedFeatSSE2 = mrpt::cpu::supports(mrpt::cpu::feature::SSE2);
 	const bool savedFeatSSSE3 = mrpt::cpu::supports(mrpt::cpu::feature::SSSE3);
+	const bool savedFeatAVX2 = mrpt::cpu::supports(mrpt::cpu::feature::AVX2);
 	if (DISABLE_SIMD)
 	{
 		mrpt::cpu::overrideDetectedFeature(mrpt::cpu::feature::SSE2, false);
 		mrpt::cpu::overrideDetectedFeature(mrpt::cpu::feature::SSSE3, false);
+		mrpt::cpu::overrideDetectedFeature(mrpt::cpu::feature::AVX2, false);
 	}
 
 	const size_t N = 300;
@@ -190,6 +193,8 @@ double image_halfsample(int w, int h)
 			mrpt::cpu::feature::SSE2, savedFeatSSE2);
 		mrpt::cpu::overrideDetectedFeature(
 			mrpt::cpu::feature::SSSE3, savedFeatSSSE3);
+		mrpt::cpu::overrideDetectedFeature(
+			mrpt::cpu::feature::AVX2, savedFeatAVX2);
 	}
 	return tictac.Tac() / N;
 }
@@ -201,10 +206,12 @@ double image_halfsample_smooth(int w, int h)
 
 	const bool savedFeatSSE2 = mrpt::cpu::supports(mrpt::cpu::feature::SSE2);
 	const bool savedFeatSSSE3 = mrpt::cpu::supports(mrpt::cpu::feature::SSSE3);
+	const bool savedFeatAVX2 = mrpt::cpu::supports(mrpt::cpu::feature::AVX2);
 	if (DISABLE_SIMD)
 	{
 		mrpt::cpu::overrideDetectedFeature(mrpt::cpu::feature::SSE2, false);
 		mrpt::cpu::overrideDetectedFeature(mrpt::cpu::feature::SSSE3, false);
+		mrpt::cpu::overrideDetectedFeature(mrpt::cpu::feature::AVX2, false);
 	}
 
 	CTicTac tictac;
@@ -221,15 +228,22 @@ double image_halfsample_smooth(int w, int h)
 			mrpt::cpu::feature::SSE2, savedFeatSSE2);
 		mrpt::cpu::overrideDetectedFeature(
 			mrpt::cpu::feature::SSSE3, savedFeatSSSE3);
+		mrpt::cpu::overrideDetectedFeature(
+			mrpt::cpu::feature::AVX2, savedFeatAVX2);
 	}
 
 	return tictac.Tac() / N;
 }
 
+template <bool DISABLE_AVX2 = false>
 double image_rgb2gray_8u(int w, int h)
 {
 	CImage img(w, h, CH_RGB), img2;
 
+	const bool savedFeatAVX2 = mrpt::cpu::supports(mrpt::cpu::feature::AVX2);
+	if (DISABLE_AVX2)
+		mrpt::cpu::overrideDetectedFeature(mrpt::cpu::feature::AVX2, false);
+
 	CTicTac tictac;
 
 	const size_t N = 300;
@@ -238,9 +252,38 @@ double image_rgb2gray_8u(int w, int h)
 	for (size_t i = 0; i < N; i++)
 		img.grayscale(img2);
 
+	const double t = tictac.Tac() / N;
+
+	mrpt::cpu::overrideDetectedFeature(
+		mrpt::cpu::feature::AVX2, savedFeatAVX2);
+	return t;
+}
+
+template <bool USE_POOL>
+double image_alloc(int w, int h)
+{
+	auto& pool = mrpt::img::CImageBufferPool::Instance();
+	CTicTac tictac;
+
+	const size_t N = 200;
+
+	tictac.Tic();
+	for (size_t i = 0; i < N; i++)
+	{
+		CImage img;
+		if (USE_POOL)
+			pool.resize(img, w, h, CH_RGB);
+		else
+			img.resize(w, h, CH_RGB);
+		// Touch all memory pages, as a grabber would do:
+		auto* d = img.ptrLine<uint8_t>(0);
+		for (size_t k = 0; k < img.getRowStride() * h; k += 4096)
+			d[k] = 0;
+	}
 	return tictac.Tac() / N;
 }
 
+template <bool DISABLE_AVX2 = false>
 double image_KLTscore(int WIN, int N)
 {
 	static const size_t w = 800;
@@ -259,6 +302,10 @@ double image_KLTscore(int WIN, int N)
 	int x = 0;
 	int y = 0;
 
+	const bool savedFeatAVX2 = mrpt::cpu::supports(mrpt::cpu::feature::AVX2);
+	if (DISABLE_AVX2)
+		mrpt::cpu::overrideDetectedFeature(mrpt::cpu::feature::AVX2, false);
+
 	CTicTac tictac;
 	tictac.Tic();
 	for (int i = 0; i < N; i++)
@@ -273,6 +320,8 @@ double image_KLTscore(int WIN, int N)
 
 	double R = tictac.Tac() / N;
 
+	mrpt::cpu::overrideDetectedFeature(
+		mrpt::cpu::feature::AVX2, savedFeatAVX2);
 	return R;
 }
 
@@ -353,7 +402,9 @@ double stereoimage_rectify_prepare_map(int, int)
 	return tictac.Tac() / N;
 }
 
-template <TImageChannels IMG_CHANNELS, int w, int h, int w2, int h2>
+template <
+	TImageChannels IMG_CHANNELS, int w, int h, int w2, int h2,
+	bool INTERNAL_REMAP = false>
 double stereoimage_rectify(int, int)
 {
 	const CImage imgL(w, h, IMG_CHANNELS), imgR(w, h, IMG_CHANNELS);
@@ -368,6 +419,7 @@ double stereoimage_rectify(int, int)
 	mrpt::vision::CStereoRectifyMap rectify_map;
 	rectify_map.enableResizeOutput((w2 != w || h2 != h), w2, h2);
 	rectify_map.setFromCamParams(params);
+	rectify_map.enableInternalRemap(INTERNAL_REMAP);
 
 	CTicTac tictac;
 	const size_t N = 20;
@@ -428,6 +480,12 @@ void register_tests_image()
 			"images: Load JPG 800x600 shared mem", image_saveload<true>, 2, 1);
 	}
 
+	lstTests.emplace_back(
+		"images: Allocate RGB image (1280x960)", image_alloc<false>, 1280, 960);
+	lstTests.emplace_back(
+		"images: Allocate RGB image (1280x960) [CImageBufferPool]",
+		image_alloc<true>, 1280, 960);
+
 	lstTests.emplace_back(
 		"images: Gauss filter (640x480)", image_test_2, 640, 480);
 	lstTests.emplace_back(
@@ -455,7 +513,7 @@ void register_tests_image()
 		"images: Half sample GRAY (1280x1024)", image_halfsample<CH_GRAY>, 1280,
 		1024);
 	lstTests.emplace_back(
-		"images: Half sample GRAY (1280x1024) [SSE2 disabled]",
+		"images: Half sample GRAY (1280x1024) [SIMD disabled]",
 		image_halfsample<CH_GRAY, true>, 1280, 1024);
 
 	lstTests.emplace_back(
@@ -477,7 +535,7 @@ void register_tests_image()
 		"images: Half sample RGB (1280x1024)", image_halfsample<CH_RGB>, 1280,
 		1024);
 	lstTests.emplace_back(
-		"images: Half sample RGB (1280x1024) [SSSE3 disabled]",
+		"images: Half sample RGB (1280x1024) [SIMD disabled]",
 		image_halfsample<CH_RGB>, 1280, 1024);
 
 	lstTests.emplace_back(
@@ -499,7 +557,7 @@ void register_tests_image()
 		"images: Half sample smooth GRAY (1280x1024)",
 		image_halfsample_smooth<CH_GRAY>, 1280, 1024);
 	lstTests.emplace_back(
-		"images: Half sample smooth GRAY (1280x1024) [SSSE3 disabled]",
+		"images: Half sample smooth GRAY (1280x1024) [SIMD disabled]",
 		image_halfsample_smooth<CH_GRAY, true>, 1280, 1024);
 
 	lstTests.emplace_back(
@@ -522,52 +580,61 @@ void register_tests_image()
 		image_halfsample_smooth<CH_RGB>, 1280, 1024);
 
 	lstTests.emplace_back(
-		"images: RGB->GRAY 8u (40x30)", image_rgb2gray_8u, 40, 30);
+		"images: RGB->GRAY 8u (40x30)", image_rgb2gray_8u<>, 40, 30);
+	lstTests.emplace_back(
+		"images: RGB->GRAY 8u (80x60)", image_rgb2gray_8u<>, 80, 60);
 	lstTests.emplace_back(
-		"images: RGB->GRAY 8u (80x60)", image_rgb2gray_8u, 80, 60);
+		"images: RGB->GRAY 8u (160x120)", image_rgb2gray_8u<>, 160, 120);
 	lstTests.emplace_back(
-		"images: RGB->GRAY 8u (160x120)", image_rgb2gray_8u, 160, 120);
+		"images: RGB->GRAY 8u (320x240)", image_rgb2gray_8u<>, 320, 240);
 	lstTests.emplace_back(
-		"images: RGB->GRAY 8u (320x240)", image_rgb2gray_8u, 320, 240);
+		"images: RGB->GRAY 8u (640x480)", image_rgb2gray_8u<>, 640, 480);
 	lstTests.emplace_back(
-		"images: RGB->GRAY 8u (640x480)", image_rgb2gray_8u, 640, 480);
+		"images: RGB->GRAY 8u (800x600)", image_rgb2gray_8u<>, 800, 600);
 	lstTests.emplace_back(
-		"images: RGB->GRAY 8u (800x600)", image_rgb2gray_8u, 800, 600);
+		"images: RGB->GRAY 8u (1024x768)", image_rgb2gray_8u<>, 1024, 768);
 	lstTests.emplace_back(
-		"images: RGB->GRAY 8u (1024x768)", image_rgb2gray_8u, 1024, 768);
+		"images: RGB->GRAY 8u (1280x1024)", image_rgb2gray_8u<>, 1280, 1024);
 	lstTests.emplace_back(
-		"images: RGB->GRAY 8u (1280x1024)", image_rgb2gray_8u, 1280, 1024);
+		"images: RGB->GRAY 8u (1280x1024) [AVX2 disabled]",
+		image_rgb2gray_8u<true>, 1280, 1024);
 
 	lstTests.emplace_back(
-		"images: KLT score (WIN=2 5x5)", image_KLTscore, 2, 1e7);
+		"images: KLT score (WIN=2 5x5)", image_KLTscore<>, 2, 1e7);
+	lstTests.emplace_back(
+		"images: KLT score (WIN=3 7x7)", image_KLTscore<>, 3, 1e7);
 	lstTests.emplace_back(
-		"images: KLT score (WIN=3 7x7)", image_KLTscore, 3, 1e7);
+		"images: KLT score (WIN=4 9x9)", image_KLTscore<>, 4, 1e7);
 	lstTests.emplace_back(
-		"images: KLT score (WIN=4 9x9)", image_KLTscore, 4, 1e7);
+		"images: KLT score (WIN=5 10x10)", image_KLTscore<>, 5, 1e7);
 	lstTests.emplace_back(
-		"images: KLT score (WIN=5 10x10)", image_KLTscore, 5, 1e7);
+		"images: KLT score (WIN=6 13x13)", image_KLTscore<>, 6, 1e7);
 	lstTests.emplace_back(
-		"images: KLT score (WIN=6 13x13)", image_KLTscore, 6, 1e7);
+		"images: KLT score (WIN=7 15x15)", image_KLTscore<>, 7, 1e6);
 	lstTests.emplace_back(
-		"images: KLT score (WIN=7 15x15)", image_KLTscore, 7, 1e6);
+		"images: KLT score (WIN=8 17x17)", image_KLTscore<>, 8, 1e6);
 	lstTests.emplace_back(
-		"images: KLT score (WIN=8 17x17)", image_KLTscore, 8, 1e6);
+		"images: KLT score (WIN=9 19x19)", image_KLTscore<>, 9, 1e6);
 	lstTests.emplace_back(
-		"images: KLT score (WIN=9 19x19)", image_KLTscore, 9, 1e6);
+		"images: KLT score (WIN=10 21x21)", image_KLTscore<>, 10, 1e6);
 	lstTests.emplace_back(
-		"images: KLT score (WIN=10 21x21)", image_KLTscore, 10, 1e6);
+		"images: KLT score (WIN=11 23x23)", image_KLTscore<>, 11, 1e6);
 	lstTests.emplace_back(
-		"images: KLT score (WIN=11 23x23)", image_KLTscore, 11, 1e6);
+		"images: KLT score (WIN=12 25x25)", image_KLTscore<>, 12, 1e6);
 	lstTests.emplace_back(
-		"images: KLT score (WIN=12 25x25)", image_KLTscore, 12, 1e6);
+		"images: KLT score (WIN=13 27x27)", image_KLTscore<>, 13, 1e6);
 	lstTests.emplace_back(
-		"images: KLT score (WIN=13 27x27)", image_KLTscore, 13, 1e6);
+		"images: KLT score (WIN=14 29x29)", image_KLTscore<>, 14, 1e6);
 	lstTests.emplace_back(
-		"images: KLT score (WIN=14 29x29)", image_KLTscore, 14, 1e6);
+		"images: KLT score (WIN=15 31x31)", image_KLTscore<>, 15, 1e6);
 	lstTests.emplace_back(
-		"images: KLT score (WIN=15 31x31)", image_KLTscore, 15, 1e6);
+		"images: KLT score (WIN=16 33x33)", image_KLTscore<>, 16, 1e6);
 	lstTests.emplace_back(
-		"images: KLT score (WIN=16 33x33)", image_KLTscore, 16, 1e6);
+		"images: KLT score (WIN=4 9x9) [AVX2 disabled]", image_KLTscore<true>,
+		4, 1e7);
+	lstTests.emplace_back(
+		"images: KLT score (WIN=16 33x33) [AVX2 disabled]",
+		image_KLTscore<true>, 16, 1e6);
 
 	lstTests.emplace_back(
 		"images: buildPyramid 640x480,4 levs,no smooth,rgb->rgb",
@@ -649,4 +716,17 @@ void register_tests_image()
 	lstTests.emplace_back(
 		"stereo: rectify 1024x768->640x480 GRAY",
 		stereoimage_rectify<CH_GRAY, 1024, 768, 640, 480>);
+
+	lstTests.emplace_back(
+		"stereo: rectify 1024x768 RGB [internal remap]",
+		stereoimage_rectify<CH_RGB, 1024, 768, 1024, 768, true>);
+	lstTests.emplace_back(
+		"stereo: rectify 1024x768->640x480 RGB [internal remap]",
+		stereoimage_rectify<CH_RGB, 1024, 768, 640, 480, true>);
+	lstTests.emplace_back(
+		"stereo: rectify 1024x768 GRAY [internal remap]",
+		stereoimage_rectify<CH_GRAY, 1024, 768, 1024, 768, true>);
+	lstTests.emplace_back(
+		"stereo: rectify 1024x768->640x480 GRAY [internal remap]",
+		stereoimage_rectify<CH_GRAY, 1024, 768, 640, 480, true>);
 }
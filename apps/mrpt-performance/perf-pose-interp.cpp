@@ -14,6 +14,8 @@
 #include <mrpt/random/RandomGenerators.h>
 #include <mrpt/system/datetime.h>
 
+#include <vector>
+
 #include "common.h"
 
 using mrpt::DEG2RAD;
@@ -86,6 +88,65 @@ double pose_interp_test(int a1, int a2)
 	}
 }
 
+// Monotonic queries, as in LIDAR deskewing: compare plain queries,
+// queries with a cursor (search hint) and one batch query.
+enum class QueryMode
+{
+	Plain,
+	Cursor,
+	Batch
+};
+
+template <typename PATH_T, typename pose_t, QueryMode MODE>
+double pose_interp_monotonic_test(int a1, int a2)
+{
+	const long N = 400000;
+	mrpt::system::CTicTac tictac;
+
+	pose_t a =
+		pose_t(mrpt::poses::CPose3D(1.0, 2.0, 0, 10.0_deg, .0, .0).asTPose());
+
+	PATH_T pose_path;
+	// Cursors are only useful with the contiguous index:
+	if (MODE != QueryMode::Plain) pose_path.enableContiguousIndex();
+	const auto t0 = mrpt::Clock::now();
+	using namespace std::chrono_literals;
+	for (long i = 0; i < N / 100; i++)
+		pose_path.insert(t0 + i * 10ms, a);
+
+	// 100 queries per path interval:
+	std::vector<mrpt::Clock::time_point> ts(N);
+	for (long i = 0; i < N; i++)
+		ts[i] = t0 + i * 100us;
+
+	typename PATH_T::pose_t p;
+	bool valid = false;
+	tictac.Tic();
+	if (MODE == QueryMode::Batch)
+	{
+		std::vector<typename PATH_T::pose_t> out;
+		std::vector<bool> outValid;
+		pose_path.interpolate(ts, out, outValid);
+		p = out[N / 2];
+		valid = outValid[N / 2];
+	}
+	else if (MODE == QueryMode::Cursor)
+	{
+		typename PATH_T::TInterpCursor cursor;
+		for (long i = 0; i < N; i++)
+			pose_path.interpolate(ts[i], p, valid, cursor);
+	}
+	else
+	{
+		for (long i = 0; i < N; i++)
+			pose_path.interpolate(ts[i], p, valid);
+	}
+	const double T = tictac.Tac() / N;
+	dummy_do_nothing_with_string(
+		mrpt::format("%s %s", p.asString().c_str(), valid ? "YES" : "NO"));
+	return T;
+}
+
 // ------------------------------------------------------
 // register_tests_pose_interp
 // ------------------------------------------------------
@@ -117,6 +178,19 @@ void register_tests_pose_interp()
 		"CPose3DInterpolator: TPose3D query",
 		&pose_interp_test<CPose3DInterpolator, TPose3D, true, false>);
 
+	lstTests.emplace_back(
+		"CPose3DInterpolator: TPose3D monotonic query",
+		&pose_interp_monotonic_test<
+			CPose3DInterpolator, TPose3D, QueryMode::Plain>);
+	lstTests.emplace_back(
+		"CPose3DInterpolator: TPose3D monotonic query with cursor",
+		&pose_interp_monotonic_test<
+			CPose3DInterpolator, TPose3D, QueryMode::Cursor>);
+	lstTests.emplace_back(
+		"CPose3DInterpolator: TPose3D monotonic batch query",
+		&pose_interp_monotonic_test<
+			CPose3DInterpolator, TPose3D, QueryMode::Batch>);
+
 	lstTests.emplace_back(
 		"CPose2DInterpolator: TPose2D insert pose at end",
 		&pose_interp_test<CPose2DInterpolator, TPose2D, true, true>);
@@ -172,6 +172,91 @@ double yaml_iterate(int, int)
 	return r;
 }
 
+double yaml_ParseEventsFromFile(int, int)
+{
+	if (!prepareYamlTestFile()) return 0;
+	mrpt::system::CTimeLogger tl;
+	for (unsigned int i = 0; i < 10; i++)
+	{
+		size_t nScalars = 0;
+		tl.enter("t");
+		mrpt::containers::yaml::ParseEventsFromFile(
+			fil, [&](const mrpt::containers::yaml::Event& e) {
+				if (e.type == mrpt::containers::yaml::EventType::Scalar)
+					nScalars++;
+				return true;
+			});
+		tl.leave("t");
+		ASSERT_(nScalars > 0);
+	}
+	double r = tl.getMeanTime("t");
+	tl.clear(true);	 // deep clear to silent dtor stats
+	return r;
+}
+
+double yaml_ParseEvents(int, int)
+{
+	if (!prepareYamlTestFile()) return 0;
+	mrpt::system::CTimeLogger tl;
+	for (unsigned int i = 0; i < 10000; i++)
+	{
+		size_t nScalars = 0;
+		tl.enter("t");
+		mrpt::containers::yaml::ParseEvents(
+			smallYamlBlock, [&](const mrpt::containers::yaml::Event& e) {
+				if (e.type == mrpt::containers::yaml::EventType::Scalar)
+					nScalars++;
+				return true;
+			});
+		tl.leave("t");
+		ASSERT_EQUAL_(nScalars, 19U);
+	}
+	double r = tl.getMeanTime("t");
+	tl.clear(true);	 // deep clear to silent dtor stats
+	return r;
+}
+
+// Equivalent to yaml_query() + loading the file, but streaming:
+double yaml_queryEvents(int, int)
+{
+	if (!prepareYamlTestFile()) return 0;
+	mrpt::system::CTimeLogger tl;
+	for (unsigned int i = 0; i < 10; i++)
+	{
+		std::string s1, s2;
+		// Path of map keys to the current node:
+		std::vector<std::string> path;
+		tl.enter("t");
+		mrpt::containers::yaml::ParseEventsFromFile(
+			fil, [&](const mrpt::containers::yaml::Event& e) {
+				using mrpt::containers::yaml;
+				const auto depth = static_cast<size_t>(e.depth);
+				if (e.isMapKey)
+				{
+					path.resize(std::min(path.size(), depth - 1));
+					path.emplace_back(e.value);
+					return true;
+				}
+				if (e.type != yaml::EventType::Scalar) return true;
+				// Map value:
+				if (depth == 4 && path.size() == 4 &&
+					path[0] == "repositories" && path[1] == "imu_compass" &&
+					path[2] == "release" && path[3] == "url")
+					s1 = e.value;
+				// First entry of a sequence, which is a map value:
+				if (s2.empty() && depth == 3 && path.size() == 2 &&
+					path[0] == "release_platforms" && path[1] == "ubuntu")
+					s2 = e.value;
+				return s1.empty() || s2.empty();
+			});
+		tl.leave("t");
+		ASSERT_EQUAL_(s1.size() + s2.size(), 62U);
+	}
+	double r = tl.getMeanTime("t");
+	tl.clear(true);	 // deep clear to silent dtor stats
+	return r;
+}
+
 #ifdef RUN_YAMLCPP_COMPARISON
 double yaml_yamlcpp_FromFile(int, int)
 {
@@ -268,6 +353,11 @@ void register_tests_yaml()
 	lstTests.emplace_back("yaml: FromText() small", &yaml_FromText);
 	lstTests.emplace_back("yaml: query in a big doc", &yaml_query);
 	lstTests.emplace_back("yaml: iterate a big doc", &yaml_iterate);
+	lstTests.emplace_back(
+		"yaml: ParseEventsFromFile() big file", &yaml_ParseEventsFromFile);
+	lstTests.emplace_back("yaml: ParseEvents() small", &yaml_ParseEvents);
+	lstTests.emplace_back(
+		"yaml: query in a big file, streaming", &yaml_queryEvents);
 
 #ifdef RUN_YAMLCPP_COMPARISON
 	lstTests.emplace_back(
@@ -0,0 +1,35 @@
+# Check for the Zstandard (zstd) compression library
+# ===================================================
+set(CMAKE_MRPT_HAS_ZSTD 0)
+set(CMAKE_MRPT_HAS_ZSTD_SYSTEM 0)
+
+option(DISABLE_ZSTD "Do not use the zstd library" 0)
+mark_as_advanced(DISABLE_ZSTD)
+
+if (DISABLE_ZSTD)
+	return()
+endif()
+
+find_path(ZSTD_INCLUDE_DIR zstd.h)
+mark_as_advanced(ZSTD_INCLUDE_DIR)
+
+find_library(ZSTD_LIBRARY NAMES zstd zstd_static)
+mark_as_advanced(ZSTD_LIBRARY)
+
+if(ZSTD_INCLUDE_DIR AND ZSTD_LIBRARY)
+	set(CMAKE_MRPT_HAS_ZSTD 1)
+	set(CMAKE_MRPT_HAS_ZSTD_SYSTEM 1)
+
+	add_library(imp_zstd INTERFACE IMPORTED)
+	set_target_properties(imp_zstd
+		PROPERTIES
+		INTERFACE_INCLUDE_DIRECTORIES "${ZSTD_INCLUDE_DIR}"
+		INTERFACE_LINK_LIBRARIES "${ZSTD_LIBRARY}"
+		)
+endif()
+
+if(${CMAKE_MRPT_HAS_ZSTD} AND "$ENV{VERBOSE}")
+	message(STATUS "libzstd configuration:")
+	message(STATUS "  ZSTD_INCLUDE_DIR: ${ZSTD_INCLUDE_DIR}")
+	message(STATUS "  ZSTD_LIBRARY: ${ZSTD_LIBRARY}")
+endif()
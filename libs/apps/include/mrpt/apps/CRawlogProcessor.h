@@ -30,6 +30,14 @@ namespace mrpt::apps
 {
 /** A virtual class that implements the common stuff around parsing a rawlog
  * file and (optionally) display a progress indicator to the console.
+ *
+ * By default, each entry is read, processed with processOneEntry() and
+ * post-processed with OnPostProcess() in the calling thread, one after the
+ * other. Derived classes with a thread-safe processOneEntry() can set
+ * `m_numThreads` to run a pipeline instead: one thread reads entries, which
+ * are processed by `m_numThreads` worker threads, and post-processed (e.g.
+ * written to an output rawlog) by the calling thread in their original order.
+ *
  * \ingroup mrpt_apps_grp
  */
 class CRawlogProcessor
@@ -41,6 +49,19 @@ class CRawlogProcessor
 	mrpt::system::TTimeStamp m_last_console_update;
 	mrpt::system::CTicTac m_timParse;
 
+	/** Number of threads running processOneEntry() concurrently, or 0 for as
+	 * many as CPU cores. With 1 (default), everything runs in the calling
+	 * thread. Set it to other values only if processOneEntry() is thread-safe
+	 * and does not use `m_rawlogEntry` (it is only updated before each
+	 * OnPostProcess() call).
+	 * \note (New in MRPT 2.4.3) */
+	size_t m_numThreads = 1;
+
+	/** Max. number of entries read but not post-processed yet, per thread,
+	 * when `m_numThreads!=1`. It bounds the memory used by the pipeline.
+	 * \note (New in MRPT 2.4.3) */
+	size_t m_maxQueuedEntriesPerThread = 4;
+
    public:
 	uint64_t m_filSize;
 	size_t m_rawlogEntry;
@@ -62,6 +83,12 @@ class CRawlogProcessor
 	// The main method:
 	void doProcessRawlog()
 	{
+		if (m_numThreads != 1)
+		{
+			doProcessRawlogParallel();
+			return;
+		}
+
 		// The 3 different objects we can read from a rawlog:
 		mrpt::obs::CActionCollection::Ptr actions;
 		mrpt::obs::CSensoryFrame::Ptr SF;
@@ -87,25 +114,7 @@ class CRawlogProcessor
 				}
 
 			// Update status to the console?
-			const mrpt::system::TTimeStamp tNow = mrpt::system::now();
-			if (mrpt::system::timeDifference(m_last_console_update, tNow) >
-				0.25)
-			{
-				m_last_console_update = tNow;
-				uint64_t fil_pos = m_in_rawlog.getPosition();
-				if (verbose)
-				{
-					std::cout << mrpt::format(
-						"Progress: %7u objects --- Pos: %9sB/%c%9sB \r",
-						(unsigned int)(m_rawlogEntry + 1),
-						mrpt::system::unitsFormat(fil_pos).c_str(),
-						(fil_pos > m_filSize ? '>' : ' '),
-						mrpt::system::unitsFormat(m_filSize)
-							.c_str());	// \r -> don't go to the next line...
-
-					std::cout.flush();
-				}
-			}
+			showProgress([this]() { return m_in_rawlog.getPosition(); });
 
 			// Do whatever:
 			bool process_ret = processOneEntry(actions, SF, obs);
@@ -151,6 +160,32 @@ class CRawlogProcessor
 		// Default: Do nothing
 	}
 
+   private:
+	/** Prints the progress to the console, at most every 0.25 s. `getFilePos`
+	 * is only called if needed. */
+	template <class GET_FILE_POS>
+	void showProgress(const GET_FILE_POS& getFilePos)
+	{
+		const mrpt::system::TTimeStamp tNow = mrpt::system::now();
+		if (mrpt::system::timeDifference(m_last_console_update, tNow) <= 0.25)
+			return;
+		m_last_console_update = tNow;
+		if (!verbose) return;
+		const uint64_t fil_pos = getFilePos();
+		std::cout << mrpt::format(
+			"Progress: %7u objects --- Pos: %9sB/%c%9sB \r",
+			(unsigned int)(m_rawlogEntry + 1),
+			mrpt::system::unitsFormat(fil_pos).c_str(),
+			(fil_pos > m_filSize ? '>' : ' '),
+			mrpt::system::unitsFormat(m_filSize)
+				.c_str());	// \r -> don't go to the next line...
+		std::cout.flush();
+	}
+
+	/** doProcessRawlog() with the reader / workers / ordered post-processing
+	 * pipeline, for `m_numThreads!=1` */
+	void doProcessRawlogParallel();
+
 };	// end CRawlogProcessor
 
 /** A virtual class that implements the common stuff around parsing a rawlog
@@ -206,11 +241,32 @@ class CRawlogProcessorOnEachObservation : public CRawlogProcessor
 		return true;  // No error.
 	}
 
+	// Calls postProcessOneObservation() for each observation, in order.
+	void OnPostProcess(
+		[[maybe_unused]] mrpt::obs::CActionCollection::Ptr& actions,
+		mrpt::obs::CSensoryFrame::Ptr& SF,
+		mrpt::obs::CObservation::Ptr& obs) override
+	{
+		if (obs) postProcessOneObservation(obs);
+		else if (SF)
+			for (auto& o : *SF)
+				if (o) postProcessOneObservation(o);
+	}
+
 	// To be implemented by the user. Return false on any error to abort
 	// processing.
 	virtual bool processOneObservation(mrpt::obs::CObservation::Ptr& obs) = 0;
 	virtual bool processOneAction(mrpt::obs::CAction::Ptr&) { return true; }
 
+	/** Invoked after processOneObservation(), always from the calling thread
+	 * and in the rawlog order, even if `m_numThreads!=1`. Reimplement it to
+	 * write results to a shared output.
+	 * \note (New in MRPT 2.4.3) */
+	virtual void postProcessOneObservation(
+		[[maybe_unused]] mrpt::obs::CObservation::Ptr& obs)
+	{
+	}
+
 };	// end CRawlogProcessorOnEachObservation
 
 /** A specialization of CRawlogProcessorOnEachObservation that handles the
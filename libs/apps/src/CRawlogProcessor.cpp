@@ -0,0 +1,231 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "apps-precomp.h"  // Precompiled headers
+//
+#include <mrpt/apps/CRawlogProcessor.h>
+#include <mrpt/system/thread_name.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using namespace mrpt::apps;
+
+namespace
+{
+struct RawlogEntry
+{
+	size_t index = 0;  //!< As in CRawlogProcessor::m_rawlogEntry
+	mrpt::obs::CActionCollection::Ptr actions;
+	mrpt::obs::CSensoryFrame::Ptr SF;
+	mrpt::obs::CObservation::Ptr obs;
+	bool processOk = true;	//!< processOneEntry() result
+};
+}  // namespace
+
+void CRawlogProcessor::doProcessRawlogParallel()
+{
+	const size_t nWorkers = m_numThreads != 0
+		? m_numThreads
+		: std::max(1U, std::thread::hardware_concurrency());
+	const size_t maxInFlight =
+		std::max<size_t>(1, m_maxQueuedEntriesPerThread) * nWorkers;
+
+	// Shared state, protected by "mtx". Entries are numbered in read order
+	// ("seq"), which is the order for OnPostProcess().
+	std::mutex mtx;
+	std::condition_variable cvReader, cvWorkers, cvDone;
+	std::deque<std::pair<size_t, RawlogEntry>> toProcess;
+	std::map<size_t, RawlogEntry> processed;
+	size_t numRead = 0, numInFlight = 0;
+	bool readerDone = false, stop = false;
+	std::exception_ptr error;
+
+	// The reader thread owns the input stream, so it also publishes the
+	// position for the progress indicator:
+	std::atomic<uint64_t> filePos{0};
+
+	const auto setError = [&](std::exception_ptr e) {
+		{
+			std::lock_guard<std::mutex> lck(mtx);
+			if (!error) error = e;
+			stop = true;
+		}
+		cvReader.notify_all();
+		cvWorkers.notify_all();
+		cvDone.notify_all();
+	};
+
+	m_timParse.Tic();
+
+	std::thread reader([&]() {
+		mrpt::system::thread_name("rawlogReader");
+		try
+		{
+			auto arch = mrpt::serialization::archiveFrom(m_in_rawlog);
+			size_t rawlogEntryCount = 0;
+			for (;;)
+			{
+				{
+					std::unique_lock<std::mutex> lck(mtx);
+					cvReader.wait(lck, [&]() {
+						return stop || numInFlight < maxInFlight;
+					});
+					if (stop) break;
+				}
+				RawlogEntry e;
+				if (!mrpt::obs::CRawlog::getActionObservationPairOrObservation(
+						arch, e.actions, e.SF, e.obs, rawlogEntryCount))
+					break;
+				e.index = rawlogEntryCount - 1;
+				filePos = m_in_rawlog.getPosition();
+				{
+					std::lock_guard<std::mutex> lck(mtx);
+					toProcess.emplace_back(numRead++, std::move(e));
+					numInFlight++;
+				}
+				cvWorkers.notify_one();
+			}
+		}
+		catch (...)
+		{
+			// Entries read so far are still processed, as in the serial
+			// version, before rethrowing it:
+			std::lock_guard<std::mutex> lck(mtx);
+			if (!error) error = std::current_exception();
+		}
+		{
+			std::lock_guard<std::mutex> lck(mtx);
+			readerDone = true;
+		}
+		cvWorkers.notify_all();
+		cvDone.notify_all();
+	});
+
+	std::vector<std::thread> workers;
+	for (size_t i = 0; i < nWorkers; i++)
+		workers.emplace_back([&, i]() {
+			mrpt::system::thread_name("rawlogWorker" + std::to_string(i));
+			for (;;)
+			{
+				std::pair<size_t, RawlogEntry> item;
+				{
+					std::unique_lock<std::mutex> lck(mtx);
+					cvWorkers.wait(lck, [&]() {
+						return stop || readerDone || !toProcess.empty();
+					});
+					if (stop || toProcess.empty()) return;
+					item = std::move(toProcess.front());
+					toProcess.pop_front();
+				}
+				auto& e = item.second;
+				try
+				{
+					e.processOk = processOneEntry(e.actions, e.SF, e.obs);
+				}
+				catch (...)
+				{
+					setError(std::current_exception());
+					return;
+				}
+				{
+					std::lock_guard<std::mutex> lck(mtx);
+					processed.emplace(item.first, std::move(e));
+				}
+				cvDone.notify_one();
+			}
+		});
+
+	// Post-process entries in order, in this thread:
+	try
+	{
+		for (size_t nextSeq = 0;;)
+		{
+			// Abort if the user presses ESC:
+			if (mrpt::system::os::kbhit())
+				if (27 == mrpt::system::os::getch())
+				{
+					std::cerr << "Aborted since user pressed ESC.\n";
+					break;
+				}
+
+			std::optional<RawlogEntry> e;
+			bool allDone = false;
+			{
+				std::unique_lock<std::mutex> lck(mtx);
+				// (With a timeout, to keep checking the keyboard)
+				cvDone.wait_for(lck, std::chrono::milliseconds(100), [&]() {
+					return stop || processed.count(nextSeq) != 0 ||
+						(readerDone && nextSeq == numRead);
+				});
+				if (stop) break;
+				if (auto it = processed.find(nextSeq); it != processed.end())
+				{
+					e = std::move(it->second);
+					processed.erase(it);
+				}
+				else
+					allDone = readerDone && nextSeq == numRead;
+			}
+			if (allDone) break;
+			if (!e) continue;
+			nextSeq++;
+
+			m_rawlogEntry = e->index;
+			showProgress([&]() { return filePos.load(); });
+
+			OnPostProcess(e->actions, e->SF, e->obs);
+			const bool process_ret = e->processOk;
+			e.reset();	// Free memory before reading more entries
+
+			{
+				std::lock_guard<std::mutex> lck(mtx);
+				numInFlight--;
+			}
+			cvReader.notify_one();
+
+			if (!process_ret)
+			{
+				std::cerr << "\nParsing stopped due to request from Rawlog "
+							 "filter implementation.\n";
+				break;
+			}
+		}
+	}
+	catch (...)
+	{
+		setError(std::current_exception());
+	}
+
+	// Stop the pipeline (entries still in it are discarded):
+	{
+		std::lock_guard<std::mutex> lck(mtx);
+		stop = true;
+	}
+	cvReader.notify_all();
+	cvWorkers.notify_all();
+	reader.join();
+	for (auto& t : workers)
+		t.join();
+
+	if (verbose) std::cout << "\n";  // new line after the "\r".
+
+	m_timToParse = m_timParse.Tac();
+
+	if (error) std::rethrow_exception(error);
+}
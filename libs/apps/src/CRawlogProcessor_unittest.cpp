@@ -0,0 +1,145 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/3rdparty/tclap/CmdLine.h>
+#include <mrpt/apps/CRawlogProcessor.h>
+#include <mrpt/obs/CObservationComment.h>
+#include <mrpt/system/filesystem.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+constexpr size_t NUM_ENTRIES = 50;
+
+/** Writes a rawlog with NUM_ENTRIES CObservationComment, with their index as
+ * text, and returns its file name. */
+std::string writeTestRawlog()
+{
+	const std::string fil = mrpt::system::getTempFileName() + ".rawlog";
+	mrpt::io::CFileGZOutputStream f(fil);
+	auto arch = mrpt::serialization::archiveFrom(f);
+	for (size_t i = 0; i < NUM_ENTRIES; i++)
+	{
+		mrpt::obs::CObservationComment obs;
+		obs.timestamp = mrpt::Clock::fromDouble(1.0 + i);
+		obs.text = std::to_string(i);
+		arch << obs;
+	}
+	return fil;
+}
+
+size_t entryIndex(const mrpt::obs::CObservation::Ptr& obs)
+{
+	auto c = std::dynamic_pointer_cast<mrpt::obs::CObservationComment>(obs);
+	if (!c) throw std::runtime_error("Unexpected observation class");
+	return std::stoul(c->text);
+}
+
+/** Sleeps a different time for each entry, so workers finish them out of
+ * order, and records the order of OnPostProcess() calls. */
+class TestProcessor : public mrpt::apps::CRawlogProcessor
+{
+   public:
+	TestProcessor(
+		mrpt::io::CFileGZInputStream& in_rawlog, TCLAP::CmdLine& cmdline,
+		size_t numThreads)
+		: CRawlogProcessor(in_rawlog, cmdline, false /*verbose*/)
+	{
+		m_numThreads = numThreads;
+		m_maxQueuedEntriesPerThread = 2;
+	}
+
+	size_t stopAt = NUM_ENTRIES;  //!< Return false for this entry
+	size_t throwAt = NUM_ENTRIES;  //!< Throw for this entry
+	std::vector<size_t> postProcessed, rawlogEntries;
+
+	bool processOneEntry(
+		[[maybe_unused]] mrpt::obs::CActionCollection::Ptr& actions,
+		[[maybe_unused]] mrpt::obs::CSensoryFrame::Ptr& SF,
+		mrpt::obs::CObservation::Ptr& obs) override
+	{
+		const size_t i = entryIndex(obs);
+		std::this_thread::sleep_for(std::chrono::microseconds((i * 37) % 500));
+		if (i == throwAt) throw std::runtime_error("processOneEntry error");
+		return i != stopAt;
+	}
+
+	void OnPostProcess(
+		[[maybe_unused]] mrpt::obs::CActionCollection::Ptr& actions,
+		[[maybe_unused]] mrpt::obs::CSensoryFrame::Ptr& SF,
+		mrpt::obs::CObservation::Ptr& obs) override
+	{
+		postProcessed.push_back(entryIndex(obs));
+		rawlogEntries.push_back(m_rawlogEntry);
+	}
+};
+}  // namespace
+
+TEST(CRawlogProcessor, parallelPostProcessOrder)
+{
+	const auto fil = writeTestRawlog();
+	TCLAP::CmdLine cmdline("CRawlogProcessor_unittest");
+
+	for (const size_t numThreads : {1, 3})
+	{
+		mrpt::io::CFileGZInputStream in(fil);
+		TestProcessor proc(in, cmdline, numThreads);
+		proc.doProcessRawlog();
+
+		ASSERT_EQ(proc.postProcessed.size(), NUM_ENTRIES);
+		for (size_t i = 0; i < NUM_ENTRIES; i++)
+		{
+			EXPECT_EQ(proc.postProcessed[i], i) << "numThreads=" << numThreads;
+			EXPECT_EQ(proc.rawlogEntries[i], i) << "numThreads=" << numThreads;
+		}
+	}
+	mrpt::system::deleteFile(fil);
+}
+
+TEST(CRawlogProcessor, parallelStopOnFalse)
+{
+	const auto fil = writeTestRawlog();
+	TCLAP::CmdLine cmdline("CRawlogProcessor_unittest");
+
+	mrpt::io::CFileGZInputStream in(fil);
+	TestProcessor proc(in, cmdline, 3);
+	proc.stopAt = 20;
+	proc.doProcessRawlog();
+
+	// Entries after the one returning false must not be post-processed, even
+	// if workers already processed them:
+	EXPECT_EQ(proc.postProcessed.size(), proc.stopAt + 1);
+	for (size_t i = 0; i < proc.postProcessed.size(); i++)
+		EXPECT_EQ(proc.postProcessed[i], i);
+	mrpt::system::deleteFile(fil);
+}
+
+TEST(CRawlogProcessor, parallelRethrowsWorkerExceptions)
+{
+	const auto fil = writeTestRawlog();
+	TCLAP::CmdLine cmdline("CRawlogProcessor_unittest");
+
+	mrpt::io::CFileGZInputStream in(fil);
+	TestProcessor proc(in, cmdline, 3);
+	proc.throwAt = 20;
+	EXPECT_THROW(proc.doProcessRawlog(), std::runtime_error);
+
+	// Whatever was post-processed before the error, it was in order and did
+	// not reach the failed entry:
+	EXPECT_LE(proc.postProcessed.size(), proc.throwAt);
+	for (size_t i = 0; i < proc.postProcessed.size(); i++)
+		EXPECT_EQ(proc.postProcessed[i], i);
+	mrpt::system::deleteFile(fil);
+}
@@ -53,6 +53,7 @@ DECLARE_OP_FUNCTION(op_deexternalize);
 DECLARE_OP_FUNCTION(op_export_gps_all);
 DECLARE_OP_FUNCTION(op_export_gps_gas_kml);
 DECLARE_OP_FUNCTION(op_export_gps_kml);
+DECLARE_OP_FUNCTION(op_export_chunked);
 DECLARE_OP_FUNCTION(op_export_enose_txt);
 DECLARE_OP_FUNCTION(op_export_gps_txt);
 DECLARE_OP_FUNCTION(op_export_rawdaq_txt);
@@ -67,6 +68,7 @@ DECLARE_OP_FUNCTION(op_export_odometry_txt);
 
 DECLARE_OP_FUNCTION(op_externalize);
 DECLARE_OP_FUNCTION(op_generate_3d_pointclouds);
+DECLARE_OP_FUNCTION(op_import_chunked);
 DECLARE_OP_FUNCTION(op_info);
 DECLARE_OP_FUNCTION(op_keep_label);
 DECLARE_OP_FUNCTION(op_list_images);
@@ -164,6 +166,25 @@ TCLAP::ValueArg<double> arg_odo_D(
 	"Distance between left-right wheels (meters), used in --recalc-odometry.",
 	false, 0, "D", cmd);
 
+TCLAP::ValueArg<size_t> arg_threads(
+	"", "threads",
+	"Number of threads for the operations that support parallel processing: "
+	"--export-txt, --generate-3d-pointclouds, --list-images and "
+	"--remap-timestamps. Output order is preserved. 0 means as many as CPU "
+	"cores.",
+	false, 1, "N", cmd);
+
+TCLAP::ValueArg<std::string> arg_chunk_compression(
+	"", "chunk-compression",
+	"Compression of chunks for --export-chunked. Default: zstd if available, "
+	"zlib otherwise.",
+	false, "", "none|zlib|zstd", cmd);
+TCLAP::ValueArg<std::string> arg_sensor_labels(
+	"", "sensor-labels",
+	"Comma-separated list of sensor labels to read in --import-chunked "
+	"(default: all).",
+	false, "", "LABEL1,LABEL2", cmd);
+
 TCLAP::SwitchArg arg_overwrite(
 	"w", "overwrite", "Force overwrite target file without prompting.", cmd,
 	false);
@@ -403,6 +424,26 @@ void RawlogEditApp::run(int argc, const char** argv)
 		cmd, false));
 	ops_functors["cut"] = &op_cut;
 
+	arg_ops.push_back(std::make_unique<TCLAP::SwitchArg>(
+		"", "export-chunked",
+		"Op: Convert the input rawlog into a chunked rawlog file: "
+		"observations grouped by sensor label in compressed chunks, with an "
+		"index for fast reads of some sensors or time ranges. Actions are "
+		"not exported.\n"
+		"Requires: -o (or --output)\n"
+		"Optional: --chunk-compression",
+		cmd, false));
+	ops_functors["export-chunked"] = &op_export_chunked;
+
+	arg_ops.push_back(std::make_unique<TCLAP::SwitchArg>(
+		"", "import-chunked",
+		"Op: Convert a chunked rawlog file (the input) back into a "
+		"plain rawlog, optionally with only some sensors or time range.\n"
+		"Requires: -o (or --output)\n"
+		"Optional: --sensor-labels, --from-time, --to-time",
+		cmd, false));
+	ops_functors["import-chunked"] = &op_import_chunked;
+
 	arg_ops.push_back(std::make_unique<TCLAP::SwitchArg>(
 		"", "generate-3d-pointclouds",
 		"Op: (re)generate the 3D pointclouds within "
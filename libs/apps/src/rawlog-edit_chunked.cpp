@@ -0,0 +1,165 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "apps-precomp.h"  // Precompiled headers
+//
+#include <mrpt/obs/CChunkedRawlog.h>
+#include <mrpt/system/string_utils.h>
+
+#include "rawlog-edit-declarations.h"
+
+using namespace mrpt;
+using namespace mrpt::obs;
+using namespace mrpt::system;
+using namespace mrpt::apps;
+using namespace std;
+using namespace mrpt::io;
+
+namespace
+{
+// Returns the output file name, checking it can be (over)written:
+std::string getOutputFileName(TCLAP::CmdLine& cmdline)
+{
+	std::string fil;
+	if (!getArgValue<std::string>(cmdline, "output", fil) || fil.empty())
+		throw runtime_error(
+			"This operation requires an output file. Use '-o file' or "
+			"'--output file'.");
+
+	if (fileExists(fil) && !isFlagSet(cmdline, "overwrite"))
+		throw runtime_error(
+			string("*ABORTING*: Output file already exists: ") + fil +
+			string("\n. Select a different output path, remove the file or "
+				   "force overwrite with '-w' or '--overwrite'."));
+	return fil;
+}
+}  // namespace
+
+// ======================================================================
+//		op_export_chunked
+// ======================================================================
+DECLARE_OP_FUNCTION(op_export_chunked)
+{
+	// A class to do this operation:
+	class CRawlogProcessor_ExportChunked
+		: public CRawlogProcessorOnEachObservation
+	{
+	   public:
+		CChunkedRawlogWriter writer;
+		size_t m_actionsSkipped = 0;
+
+		CRawlogProcessor_ExportChunked(
+			CFileGZInputStream& in_rawlog, TCLAP::CmdLine& cmdline,
+			bool Verbose)
+			: CRawlogProcessorOnEachObservation(in_rawlog, cmdline, Verbose)
+		{
+			CChunkedRawlogWriter::TOptions opts;
+
+			std::string sCompr;
+			if (getArgValue<std::string>(cmdline, "chunk-compression", sCompr))
+			{
+				sCompr = mrpt::system::lowerCase(sCompr);
+				if (sCompr == "none") opts.compression = ChunkCompression::None;
+				else if (sCompr == "zlib")
+					opts.compression = ChunkCompression::Zlib;
+				else if (sCompr == "zstd")
+					opts.compression = ChunkCompression::Zstd;
+				else
+					throw std::runtime_error(
+						"export-chunked: --chunk-compression must be one of: "
+						"none, zlib, zstd");
+			}
+
+			const auto outFile = getOutputFileName(cmdline);
+			VERBOSE_COUT << "Writing chunked rawlog: " << outFile << "\n";
+			writer.open(outFile, opts);
+		}
+
+		bool processOneObservation(CObservation::Ptr&) override { return true; }
+
+		bool processOneAction(CAction::Ptr&) override
+		{
+			m_actionsSkipped++;
+			return true;
+		}
+
+		void postProcessOneObservation(CObservation::Ptr& obs) override
+		{
+			writer.write(*obs);
+		}
+	};
+
+	// Process
+	// ---------------------------------
+	CRawlogProcessor_ExportChunked proc(in_rawlog, cmdline, verbose);
+	proc.doProcessRawlog();
+	proc.writer.close();
+
+	if (proc.m_actionsSkipped)
+		cerr << "[rawlog-edit] Warning: " << proc.m_actionsSkipped
+			 << " actions were not exported (chunked rawlogs only store "
+				"observations).\n";
+
+	// Dump statistics:
+	// ---------------------------------
+	VERBOSE_COUT << "Observations written              : "
+				 << proc.writer.size() << "\n";
+	VERBOSE_COUT << "Time to process file (sec)        : " << proc.m_timToParse
+				 << "\n";
+}
+
+// ======================================================================
+//		op_import_chunked
+// ======================================================================
+DECLARE_OP_FUNCTION(op_import_chunked)
+{
+	std::string inFile;
+	getArgValue<std::string>(cmdline, "input", inFile);
+
+	// Optional filters:
+	CChunkedRawlogReader::TReadFilter filter;
+	std::string sLabels;
+	if (getArgValue<std::string>(cmdline, "sensor-labels", sLabels))
+	{
+		std::vector<std::string> labels;
+		mrpt::system::tokenize(sLabels, " ,", labels);
+		filter.sensorLabels.insert(labels.begin(), labels.end());
+	}
+	double t;
+	if (getArgValue<double>(cmdline, "from-time", t))
+		filter.fromTime = mrpt::Clock::fromDouble(t);
+	if (getArgValue<double>(cmdline, "to-time", t))
+		filter.toTime = mrpt::Clock::fromDouble(t);
+
+	CChunkedRawlogReader reader;
+	reader.open(inFile);
+
+	VERBOSE_COUT << "Chunked rawlog with " << reader.size()
+				 << " observations in " << reader.channels().size()
+				 << " channels:\n";
+	for (const auto& ch : reader.channels())
+		VERBOSE_COUT << " - " << ch.sensorLabel << " (" << ch.className
+					 << "): " << ch.numEntries << " observations\n";
+
+	TOutputRawlogCreator outrawlog;
+
+	mrpt::system::CTicTac tictac;
+	const size_t nRead = reader.read(
+		[&](const CObservation::Ptr& obs) {
+			(*outrawlog.out_rawlog) << obs;
+			return true;
+		},
+		filter);
+
+	// Dump statistics:
+	// ---------------------------------
+	VERBOSE_COUT << "Observations written              : " << nRead << "\n";
+	VERBOSE_COUT << "Time to process file (sec)        : " << tictac.Tac()
+				 << "\n";
+}
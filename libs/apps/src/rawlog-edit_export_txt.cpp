@@ -13,6 +13,8 @@
 
 #include "rawlog-edit-declarations.h"
 
+#include <mutex>
+
 using namespace mrpt;
 using namespace mrpt::obs;
 using namespace mrpt::system;
@@ -34,6 +36,10 @@ DECLARE_OP_FUNCTION(op_export_txt)
 		map<string, FILE*> lstFiles;
 		string m_filPrefix;
 
+		/** Rows formatted by processOneObservation(), not written yet */
+		map<const CObservation*, string> m_pendingRows;
+		std::mutex m_pendingRowsMtx;
+
 	   public:
 		size_t m_entriesSaved;
 
@@ -47,6 +53,9 @@ DECLARE_OP_FUNCTION(op_export_txt)
 
 			m_filPrefix =
 				extractFileDirectory(m_inFile) + extractFileName(m_inFile);
+
+			// Rows are formatted in parallel:
+			getArgValue<size_t>(cmdline, "threads", m_numThreads);
 		}
 
 		// return false on any error.
@@ -62,6 +71,32 @@ DECLARE_OP_FUNCTION(op_export_txt)
 					"observation of type '%s'",
 					obs->GetRuntimeClass()->className));
 
+			ASSERT_(obs->timestamp != INVALID_TIMESTAMP);
+			double sampleTime = mrpt::Clock::toDouble(obs->timestamp);
+
+			// Format the row here, maybe in a worker thread, and write it in
+			// postProcessOneObservation(), in order:
+			std::string row = mrpt::format(
+				"%16.6f "  // TIMESTAMP
+				"%s\n",
+				sampleTime, obs->exportTxtDataRow().c_str());
+
+			std::lock_guard<std::mutex> lck(m_pendingRowsMtx);
+			m_pendingRows[obs.get()] = std::move(row);
+			return true;  // All ok
+		}
+
+		void postProcessOneObservation(CObservation::Ptr& obs) override
+		{
+			std::string row;
+			{
+				std::lock_guard<std::mutex> lck(m_pendingRowsMtx);
+				auto itRow = m_pendingRows.find(obs.get());
+				if (itRow == m_pendingRows.end()) return;
+				row = std::move(itRow->second);
+				m_pendingRows.erase(itRow);
+			}
+
 			auto it = lstFiles.find(obs->sensorLabel);
 
 			FILE* f_this = nullptr;
@@ -94,17 +129,8 @@ DECLARE_OP_FUNCTION(op_export_txt)
 			else
 				f_this = it->second;
 
-			ASSERT_(obs->timestamp != INVALID_TIMESTAMP);
-			double sampleTime = mrpt::Clock::toDouble(obs->timestamp);
-
-			// Time:
-			::fprintf(
-				f_this,
-				"%16.6f "  // TIMESTAMP
-				"%s\n",
-				sampleTime, obs->exportTxtDataRow().c_str());
+			::fputs(row.c_str(), f_this);
 			m_entriesSaved++;
-			return true;  // All ok
 		}
 
 		// Destructor: close files and generate summary files:
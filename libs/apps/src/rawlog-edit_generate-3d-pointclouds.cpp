@@ -13,6 +13,8 @@
 
 #include "rawlog-edit-declarations.h"
 
+#include <atomic>
+
 using namespace mrpt;
 using namespace mrpt::obs;
 using namespace mrpt::system;
@@ -33,14 +35,15 @@ DECLARE_OP_FUNCTION(op_generate_3d_pointclouds)
 		TOutputRawlogCreator outrawlog;
 
 	   public:
-		size_t entries_modified;
+		std::atomic_size_t entries_modified{0};
 
 		CRawlogProcessor_Generate3DPointClouds(
 			CFileGZInputStream& in_rawlog, TCLAP::CmdLine& cmdline,
 			bool Verbose)
 			: CRawlogProcessorOnEachObservation(in_rawlog, cmdline, Verbose)
 		{
-			entries_modified = 0;
+			// Each observation is modified independently:
+			getArgValue<size_t>(cmdline, "threads", m_numThreads);
 		}
 
 		bool processOneObservation(CObservation::Ptr& obs) override
@@ -85,5 +88,5 @@ DECLARE_OP_FUNCTION(op_generate_3d_pointclouds)
 	VERBOSE_COUT << "Time to process file (sec)        : " << proc.m_timToParse
 				 << "\n";
 	VERBOSE_COUT << "Entries modified                  : "
-				 << proc.entries_modified << "\n";
+				 << proc.entries_modified.load() << "\n";
 }
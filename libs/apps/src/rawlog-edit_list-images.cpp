@@ -48,13 +48,16 @@ DECLARE_OP_FUNCTION(op_list_images)
 			if (!m_out.is_open())
 				throw std::runtime_error(
 					"list-images: Cannot open output text file.");
+
+			// Only reading the rawlog can run in parallel with writing:
+			getArgValue<size_t>(cmdline, "threads", m_numThreads);
 		}
 
-		bool processOneObservation(CObservation::Ptr& obs) override
+		bool processOneObservation(CObservation::Ptr&) override { return true; }
+
+		// Write the list in the rawlog order:
+		void postProcessOneObservation(CObservation::Ptr& obs) override
 		{
-			const string label_time = format(
-				"%s_%f", obs->sensorLabel.c_str(),
-				timestampTotime_t(obs->timestamp));
 			if (IS_CLASS(*obs, CObservationStereoImages))
 			{
 				CObservationStereoImages::Ptr obsSt =
@@ -85,8 +88,6 @@ DECLARE_OP_FUNCTION(op_list_images)
 					m_out << obs3D->intensityImage.getExternalStorageFile()
 						  << std::endl;
 			}
-
-			return true;
 		}
 	};
 
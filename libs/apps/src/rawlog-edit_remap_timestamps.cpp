@@ -41,6 +41,8 @@ DECLARE_OP_FUNCTION(op_remap_timestamps)
 			  m_a(a),
 			  m_b(b)
 		{
+			// Each observation is modified independently:
+			getArgValue<size_t>(cmdline, "threads", m_numThreads);
 			VERBOSE_COUT << "Applying timestamps remap a*t+b with: a=" << m_a
 						 << " b=" << m_b << endl;
 		}
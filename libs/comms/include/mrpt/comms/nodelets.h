@@ -8,16 +8,27 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/containers/lockfree_ring_queue.h>
+#include <mrpt/core/demangle.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/system/COutputLogger.h>
 #include <mrpt/typemeta/TTypeName.h>
 #include <mrpt/typemeta/TTypeName_stl.h>
 
 #include <any>
+#include <atomic>
+#include <condition_variable>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <list>
 #include <memory>  // shared_ptr
 #include <mutex>
+#include <thread>
+#include <type_traits>
+#include <typeindex>
 #include <unordered_map>
+#include <vector>
 
 namespace mrpt::comms
 {
@@ -102,6 +113,358 @@ class Topic : public std::enable_shared_from_this<Topic>
 	std::function<void()> m_cleanup;
 };
 
+/** Options for TypedTopic::createSubscriber()
+ * \note (New in MRPT 2.4.3) */
+struct SubscriberOptions
+{
+	/** Max. number of messages waiting to be processed by the subscriber.
+	 * Messages published while its queue is full are dropped for this
+	 * subscriber, and counted in TopicStats::dropped. */
+	std::size_t queue_capacity = 16;
+
+	/** If true, the callback is invoked from a thread owned by the
+	 * subscriber. Otherwise, the user must call TypedSubscriber::spinOnce()
+	 * periodically from any single thread. */
+	bool dedicated_thread = true;
+};
+
+/** Statistics of a TypedTopic, including those of its former subscribers.
+ * \note (New in MRPT 2.4.3) */
+struct TopicStats
+{
+	/** Number of calls to TypedTopic::publish() */
+	uint64_t published = 0;
+	/** Number of messages processed / dropped, summed over all subscribers */
+	uint64_t delivered = 0, dropped = 0;
+	/** Time from publish() to the start of the subscriber callback, in
+	 * seconds. */
+	double latency_mean = 0, latency_max = 0;
+	/** Current number of subscribers */
+	std::size_t num_subscribers = 0;
+};
+
+template <typename T>
+class TypedTopic;
+
+namespace internal
+{
+/** The logger for exceptions thrown by TypedSubscriber callbacks. Its name is
+ * "TypedSubscriber"; its verbosity and callbacks can be changed by users. */
+mrpt::system::COutputLogger& typedSubscriberLogger();
+
+/** The message queue of a TypedSubscriber, shared with its topic. */
+template <typename T>
+struct TypedChannel
+{
+	explicit TypedChannel(std::size_t capacity) : queue(capacity) {}
+
+	mrpt::containers::mpmc_ring_queue<std::shared_ptr<const T>> queue;
+
+	// To wake up and stop the dedicated thread, if any:
+	std::atomic_bool sleeping{false}, stop{false};
+	std::mutex mtx;
+	std::condition_variable cv;
+
+	void push(const std::shared_ptr<const T>& msg)
+	{
+		if (!queue.try_push(msg)) return;
+		// Pairs with the fence in wait(): either the consumer sees the new
+		// message, or we see it sleeping.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (sleeping.load(std::memory_order_relaxed))
+		{
+			std::lock_guard<std::mutex> lck(mtx);
+			cv.notify_one();
+		}
+	}
+
+	/** Waits until there are messages, or `stop` is set */
+	void wait()
+	{
+		std::unique_lock<std::mutex> lck(mtx);
+		sleeping.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		cv.wait(lck, [&]() { return stop || !queue.empty(); });
+		sleeping.store(false, std::memory_order_relaxed);
+	}
+
+	/** Invokes `callback` for up to `maxMessages` pending messages.
+	 * \return The number of processed messages. */
+	template <typename CALLABLE>
+	std::size_t processPending(
+		const CALLABLE& callback, std::size_t maxMessages)
+	{
+		std::size_t n = 0;
+		std::shared_ptr<const T> msg;
+		while (n < maxMessages && !stop && queue.try_pop(msg))
+		{
+			n++;
+			try
+			{
+				callback(msg);
+			}
+			catch (const std::exception& e)
+			{
+				typedSubscriberLogger().logStr(
+					mrpt::system::LVL_ERROR,
+					"Exception in callback:\n" + mrpt::exception_to_str(e));
+			}
+			catch (...)
+			{
+				typedSubscriberLogger().logStr(
+					mrpt::system::LVL_ERROR, "Unknown exception in callback");
+			}
+			msg.reset();
+		}
+		return n;
+	}
+};
+}  // namespace internal
+
+/** A subscriber to a TypedTopic. Messages are received while this object is
+ * alive. See TypedTopic::createSubscriber().
+ * \note (New in MRPT 2.4.3)
+ */
+template <typename T>
+class TypedSubscriber
+{
+   public:
+	using Ptr = std::shared_ptr<TypedSubscriber<T>>;
+	using message_t = std::shared_ptr<const T>;
+	using callback_t = std::function<void(const message_t&)>;
+
+	~TypedSubscriber()
+	{
+		m_cleanup();
+		if (!m_thread.joinable()) return;
+		{
+			std::lock_guard<std::mutex> lck(m_channel->mtx);
+			m_channel->stop = true;
+		}
+		m_channel->cv.notify_one();
+		// The last reference may be released from the callback itself:
+		if (m_thread.get_id() == std::this_thread::get_id()) m_thread.detach();
+		else
+			m_thread.join();
+	}
+
+	/** Invokes the callback for the pending messages, up to `maxMessages`.
+	 * Only for subscribers without a dedicated thread.
+	 * \return The number of processed messages. */
+	std::size_t spinOnce(
+		std::size_t maxMessages = std::numeric_limits<std::size_t>::max())
+	{
+		ASSERTMSG_(
+			!m_thread.joinable(),
+			"spinOnce() cannot be used with a dedicated thread");
+		return m_channel->processPending(*m_callback, maxMessages);
+	}
+
+	/** Statistics of this subscriber queue (pushed, popped, dropped, and
+	 * latencies). */
+	mrpt::containers::ring_queue_stats stats() const
+	{
+		return m_channel->queue.stats();
+	}
+
+	TypedSubscriber(const TypedSubscriber&) = delete;
+	TypedSubscriber& operator=(const TypedSubscriber&) = delete;
+
+   private:
+	friend class TypedTopic<T>;
+
+	TypedSubscriber(
+		callback_t&& callback,
+		std::shared_ptr<internal::TypedChannel<T>> channel,
+		std::function<void()>&& cleanup, bool dedicatedThread)
+		: m_callback(std::make_shared<const callback_t>(std::move(callback))),
+		  m_channel(std::move(channel)),
+		  m_cleanup(std::move(cleanup))
+	{
+		if (!dedicatedThread) return;
+		// Do not capture "this": the thread may outlive this object if it is
+		// destroyed from its own callback.
+		m_thread = std::thread([cb = m_callback, ch = m_channel]() {
+			while (!ch->stop)
+			{
+				ch->processPending(
+					*cb, std::numeric_limits<std::size_t>::max());
+				ch->wait();
+			}
+		});
+	}
+
+	std::shared_ptr<const callback_t> m_callback;
+	std::shared_ptr<internal::TypedChannel<T>> m_channel;
+	std::function<void()> m_cleanup;
+	std::thread m_thread;
+};
+
+/** A topic for messages of type `T`, shared among threads as
+ * `std::shared_ptr<const T>` (no copies nor type erasure per subscriber).
+ * Obtain it from TopicDirectory::getTypedTopic().
+ *
+ * Each subscriber has its own bounded, lock-free queue. publish() only
+ * holds a mutex to copy a pointer to the (immutable) list of subscribers,
+ * and then pushes the message into their queues without any lock, so slow
+ * subscribers never block publishers nor other subscribers: if a subscriber
+ * queue is full, the new message is dropped for that subscriber. Exceptions
+ * thrown by callbacks are reported to internal::typedSubscriberLogger().
+ * Messages are processed either by
+ * a dedicated thread per subscriber, or by the user calling
+ * TypedSubscriber::spinOnce(). Message counters and delivery latencies are
+ * available via stats().
+ *
+ * \code
+ * auto topic = dir->getTypedTopic<mrpt::math::TPose3D>("/robot/odom");
+ * auto sub = topic->createSubscriber(
+ *     [](const std::shared_ptr<const mrpt::math::TPose3D>& p) { ... });
+ * topic->publish(std::make_shared<const mrpt::math::TPose3D>(...));
+ * \endcode
+ *
+ * \note (New in MRPT 2.4.3)
+ */
+template <typename T>
+class TypedTopic : public std::enable_shared_from_this<TypedTopic<T>>
+{
+   private:
+	TypedTopic(std::function<void()>&& cleanup)
+		: m_channels(std::make_shared<const channels_t>()),
+		  m_cleanup(std::move(cleanup))
+	{
+	}
+
+   public:
+	using Ptr = std::shared_ptr<TypedTopic<T>>;
+	using message_t = std::shared_ptr<const T>;
+
+	~TypedTopic() { m_cleanup(); }
+
+	/** Sends a message to all current subscribers. Thread-safe, and never
+	 * waits for subscribers (see the class description). */
+	void publish(const message_t& msg)
+	{
+		ASSERT_(msg);
+		m_published.fetch_add(1, std::memory_order_relaxed);
+		for (const auto& ch : *channels())
+			ch->push(msg);
+	}
+	/** Publishes a copy of `msg`, shared among all subscribers. */
+	void publish(const T& msg) { publish(std::make_shared<const T>(msg)); }
+	void publish(T&& msg)
+	{
+		publish(std::make_shared<const T>(std::move(msg)));
+	}
+
+	/** Creates a new subscriber, which will receive messages until it is
+	 * destroyed. `func` may take either `const std::shared_ptr<const T>&` or
+	 * `const T&`.
+	 */
+	template <typename Callable>
+	typename TypedSubscriber<T>::Ptr createSubscriber(
+		Callable&& func, const SubscriberOptions& options = {})
+	{
+		typename TypedSubscriber<T>::callback_t callback;
+		if constexpr (std::is_invocable_v<Callable, const message_t&>)
+			callback = std::forward<Callable>(func);
+		else
+			callback = [f = std::forward<Callable>(func)](
+						   const message_t& msg) { std::invoke(f, *msg); };
+
+		auto ch = std::make_shared<internal::TypedChannel<T>>(
+			options.queue_capacity);
+		{
+			std::lock_guard<std::mutex> lck(m_mutex);
+			auto channels = std::make_shared<channels_t>(*m_channels);
+			channels->push_back(ch);
+			setChannels(std::move(channels));
+		}
+		auto capturedShared = this->shared_from_this();
+		return typename TypedSubscriber<T>::Ptr(new TypedSubscriber<T>(
+			std::move(callback), ch,
+			[capturedShared, ch]() { capturedShared->removeChannel(ch); },
+			options.dedicated_thread));
+	}
+
+	TopicStats stats() const
+	{
+		std::lock_guard<std::mutex> lck(m_mutex);
+		TopicStats s = m_formerStats;
+		s.published = m_published.load(std::memory_order_relaxed);
+		s.num_subscribers = m_channels->size();
+		double latencySum = s.latency_mean * s.delivered;
+		for (const auto& ch : *m_channels)
+			accumulate(ch->queue.stats(), s, latencySum);
+		s.latency_mean = s.delivered ? latencySum / s.delivered : 0;
+		return s;
+	}
+
+	template <typename CLEANUP>
+	static Ptr create(CLEANUP&& cleanup)
+	{
+		return Ptr(new TypedTopic<T>(std::forward<CLEANUP>(cleanup)));
+	}
+
+   private:
+	using channels_t =
+		std::vector<std::shared_ptr<internal::TypedChannel<T>>>;
+	using channels_ptr_t = std::shared_ptr<const channels_t>;
+
+	static void accumulate(
+		const mrpt::containers::ring_queue_stats& q, TopicStats& s,
+		double& latencySum)
+	{
+		s.delivered += q.popped;
+		s.dropped += q.push_failures;
+		latencySum += q.latency_mean * q.latency_samples;
+		s.latency_max = std::max(s.latency_max, q.latency_max);
+	}
+
+	void removeChannel(const std::shared_ptr<internal::TypedChannel<T>>& ch)
+	{
+		std::lock_guard<std::mutex> lck(m_mutex);
+		auto channels = std::make_shared<channels_t>();
+		for (const auto& c : *m_channels)
+			if (c != ch) channels->push_back(c);
+		setChannels(std::move(channels));
+
+		double latencySum =
+			m_formerStats.latency_mean * m_formerStats.delivered;
+		accumulate(ch->queue.stats(), m_formerStats, latencySum);
+		m_formerStats.latency_mean = m_formerStats.delivered
+			? latencySum / m_formerStats.delivered
+			: 0;
+	}
+
+	/** A copy of the pointer to the current subscribers */
+	channels_ptr_t channels() const
+	{
+		std::lock_guard<std::mutex> lck(m_channelsPtrMutex);
+		return m_channels;
+	}
+	/** Must be called with m_mutex locked */
+	void setChannels(channels_ptr_t channels)
+	{
+		{
+			std::lock_guard<std::mutex> lck(m_channelsPtrMutex);
+			m_channels.swap(channels);
+		}
+		// The old list is released here, out of the lock
+	}
+
+	/** Protects changes to m_channels and m_formerStats */
+	mutable std::mutex m_mutex;
+	/** Current subscribers. Replaced as a whole (copy-on-write), so
+	 * publish() only needs m_channelsPtrMutex to copy this pointer, which
+	 * is never held for longer than that. */
+	channels_ptr_t m_channels;
+	mutable std::mutex m_channelsPtrMutex;
+	std::atomic<uint64_t> m_published{0};
+	/** Stats of the subscribers already destroyed */
+	TopicStats m_formerStats;
+	std::function<void()> m_cleanup;
+};
+
 /** The central directory of existing topics for pub/sub */
 class TopicDirectory : public std::enable_shared_from_this<TopicDirectory>
 {
@@ -129,12 +492,50 @@ class TopicDirectory : public std::enable_shared_from_this<TopicDirectory>
 		return newNode;
 	}
 
+	/** Returns the TypedTopic for the given path, creating it if needed.
+	 * Typed topics are independent of those returned by getTopic(), even for
+	 * the same path.
+	 * \exception std::exception If the topic exists with a different type.
+	 * \note (New in MRPT 2.4.3)
+	 */
+	template <typename T>
+	typename TypedTopic<T>::Ptr getTypedTopic(const std::string& path)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto& entry = m_mapTypedTopics[path];
+		if (auto ptr = entry.topic.lock())
+		{
+			ASSERTMSG_(
+				entry.type == std::type_index(typeid(T)),
+				mrpt::format(
+					"Topic `%s` has type `%s`, requested `%s`", path.c_str(),
+					mrpt::demangle(entry.type.name()).c_str(),
+					mrpt::demangle(typeid(T).name()).c_str()));
+			return std::static_pointer_cast<TypedTopic<T>>(ptr);
+		}
+
+		auto capturedShared = shared_from_this();
+		auto newNode = TypedTopic<T>::create(
+			[=]() { capturedShared->cleanupTypedTopic(path); });
+		entry.topic = newNode;
+		entry.type = std::type_index(typeid(T));
+		return newNode;
+	}
+
 	void cleanupTopic(const std::string& key);
+	void cleanupTypedTopic(const std::string& key);
 	static Ptr create();
 
    private:
 	std::mutex m_mutex;
 	std::unordered_map<std::string, std::weak_ptr<Topic>> m_mapService;
+
+	struct TypedTopicEntry
+	{
+		std::weak_ptr<void> topic;
+		std::type_index type = std::type_index(typeid(void));
+	};
+	std::unordered_map<std::string, TypedTopicEntry> m_mapTypedTopics;
 };
 
 /** @} */  // end grouping
@@ -13,6 +13,12 @@
 
 using namespace mrpt::comms;
 
+mrpt::system::COutputLogger& mrpt::comms::internal::typedSubscriberLogger()
+{
+	static mrpt::system::COutputLogger logger("TypedSubscriber");
+	return logger;
+}
+
 // ------- Subscriber --------------
 Subscriber::Subscriber(
 	std::function<void(const std::any&)>&& func,
@@ -38,7 +44,8 @@ void Topic::publish(const std::any& any)
 	std::lock_guard<std::mutex> lock(m_mutex);
 	for (auto& sub : m_subs)
 	{
-		sub.lock()->pub(any);
+		// It may be expiring, before having called cleanupSubscriber():
+		if (auto s = sub.lock(); s) s->pub(any);
 	}
 }
 
@@ -57,4 +64,13 @@ void TopicDirectory::cleanupTopic(const std::string& key)
 	m_mapService.erase(m_mapService.find(key));
 }
 
+void TopicDirectory::cleanupTypedTopic(const std::string& key)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	// It might have been replaced by a new topic with the same path:
+	if (auto it = m_mapTypedTopics.find(key);
+		it != m_mapTypedTopics.end() && it->second.topic.expired())
+		m_mapTypedTopics.erase(it);
+}
+
 TopicDirectory::Ptr TopicDirectory::create() { return Ptr(new TopicDirectory); }
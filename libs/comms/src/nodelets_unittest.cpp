@@ -18,3 +18,162 @@ TEST(NodeletsTests, pub_sub_multithread_test)
 	NodeletsTest();
 	EXPECT_TRUE(nodelets_test_passed_ok);
 }
+
+namespace
+{
+struct TestMsg
+{
+	int publisher = 0, seq = 0;
+};
+}  // namespace
+
+TEST(NodeletsTests, typed_topic_dedicated_threads)
+{
+	using namespace mrpt::comms;
+	auto dir = TopicDirectory::create();
+	auto topic = dir->getTypedTopic<TestMsg>("/test/msgs");
+	EXPECT_EQ(topic, dir->getTypedTopic<TestMsg>("/test/msgs"));
+
+	constexpr int nPublishers = 3, nMsgs = 200;
+	std::atomic<int> nRx1{0}, nRx2{0};
+	std::vector<int> lastSeq(nPublishers, -1);
+	bool inOrder = true;
+
+	SubscriberOptions opts;
+	opts.queue_capacity = nPublishers * nMsgs;	// No drops
+
+	// Receiving the shared_ptr:
+	auto sub1 = topic->createSubscriber(
+		[&](const std::shared_ptr<const TestMsg>& m) {
+			// Messages from each publisher arrive in order:
+			if (m->seq <= lastSeq[m->publisher]) inOrder = false;
+			lastSeq[m->publisher] = m->seq;
+			nRx1++;
+		},
+		opts);
+	// Receiving the object:
+	auto sub2 =
+		topic->createSubscriber([&](const TestMsg&) { nRx2++; }, opts);
+	EXPECT_EQ(topic->stats().num_subscribers, 2U);
+
+	std::vector<std::thread> publishers;
+	for (int p = 0; p < nPublishers; p++)
+		publishers.emplace_back([&, p]() {
+			for (int i = 0; i < nMsgs; i++)
+				topic->publish(TestMsg{p, i});
+		});
+	for (auto& t : publishers)
+		t.join();
+
+	for (int i = 0; i < 500 && (nRx1 + nRx2) < 2 * nPublishers * nMsgs; i++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	EXPECT_EQ(nRx1, nPublishers * nMsgs);
+	EXPECT_EQ(nRx2, nPublishers * nMsgs);
+	EXPECT_TRUE(inOrder);
+
+	sub2.reset();
+	const TopicStats s = topic->stats();
+	EXPECT_EQ(s.num_subscribers, 1U);
+	EXPECT_EQ(s.published, static_cast<uint64_t>(nPublishers * nMsgs));
+	EXPECT_EQ(s.delivered, static_cast<uint64_t>(2 * nPublishers * nMsgs));
+	EXPECT_EQ(s.dropped, 0U);
+	EXPECT_GE(s.latency_max, s.latency_mean);
+}
+
+TEST(NodeletsTests, typed_topic_spin_and_drops)
+{
+	using namespace mrpt::comms;
+	auto dir = TopicDirectory::create();
+	auto topic = dir->getTypedTopic<TestMsg>("/test/msgs");
+
+	SubscriberOptions opts;
+	opts.dedicated_thread = false;
+	opts.queue_capacity = 4;
+
+	std::vector<const TestMsg*> rx;
+	auto sub = topic->createSubscriber(
+		[&](const std::shared_ptr<const TestMsg>& m) { rx.push_back(m.get()); },
+		opts);
+
+	// Zero copy: all subscribers get the same object.
+	const auto msg = std::make_shared<const TestMsg>();
+	for (int i = 0; i < 10; i++)
+		topic->publish(msg);
+
+	EXPECT_EQ(sub->spinOnce(1), 1U);
+	EXPECT_EQ(sub->spinOnce(), 3U);
+	EXPECT_EQ(sub->spinOnce(), 0U);
+	ASSERT_EQ(rx.size(), 4U);
+	for (const auto* p : rx)
+		EXPECT_EQ(p, msg.get());
+
+	const TopicStats s = topic->stats();
+	EXPECT_EQ(s.published, 10U);
+	EXPECT_EQ(s.delivered, 4U);
+	EXPECT_EQ(s.dropped, 6U);
+
+	// The same path, with another type:
+	EXPECT_ANY_THROW(dir->getTypedTopic<double>("/test/msgs"));
+
+	// The topic is freed with its last user:
+	sub.reset();
+	topic.reset();
+	EXPECT_NO_THROW(dir->getTypedTopic<double>("/test/msgs"));
+}
+
+TEST(NodeletsTests, typed_topic_unsubscribe_from_callback)
+{
+	using namespace mrpt::comms;
+	auto dir = TopicDirectory::create();
+	auto topic = dir->getTypedTopic<int>("/test/int");
+
+	std::atomic_bool done{false};
+	TypedSubscriber<int>::Ptr sub;
+	sub = topic->createSubscriber([&](const int&) {
+		sub.reset();
+		done = true;
+	});
+	topic->publish(1);
+	for (int i = 0; i < 500 && !done; i++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	EXPECT_TRUE(done);
+	EXPECT_EQ(topic->stats().num_subscribers, 0U);
+}
+
+TEST(NodeletsTests, typed_topic_callback_exceptions)
+{
+	using namespace mrpt::comms;
+	auto dir = TopicDirectory::create();
+	auto topic = dir->getTypedTopic<int>("/test/throwing");
+
+	SubscriberOptions opts;
+	opts.dedicated_thread = false;
+
+	std::vector<int> rx;
+	auto sub = topic->createSubscriber(
+		[&](const int& v) {
+			rx.push_back(v);
+			if (v == 1) throw std::runtime_error("std exception");
+			if (v == 2) throw v;  // Not a std::exception
+		},
+		opts);
+
+	auto& logger = internal::typedSubscriberLogger();
+	logger.logging_enable_console_output = false;
+	logger.logging_enable_keep_record = true;
+
+	for (int i = 0; i < 4; i++)
+		topic->publish(i);
+
+	// Exceptions are reported, and later messages still processed:
+	EXPECT_EQ(sub->spinOnce(), 4U);
+	EXPECT_EQ(rx, std::vector<int>({0, 1, 2, 3}));
+
+	const std::string log = logger.getLogAsString();
+	EXPECT_NE(log.find("std exception"), std::string::npos) << log;
+	EXPECT_NE(log.find("Unknown exception"), std::string::npos) << log;
+
+	logger.logging_enable_console_output = true;
+	logger.logging_enable_keep_record = false;
+}
@@ -47,6 +47,8 @@ namespace mrpt::containers
  * with \a get(). However, elements
  *   still in the queue upon destruction will be deleted automatically.
  *
+ * \sa For low-latency, bounded and lock-free alternatives supporting
+ * move-only values, see spsc_ring_queue and mpmc_ring_queue.
  * \ingroup mrpt_containers_grp
  */
 template <class T>
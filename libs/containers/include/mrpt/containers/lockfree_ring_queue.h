@@ -0,0 +1,516 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace mrpt::containers
+{
+/** Statistics of a spsc_ring_queue or mpmc_ring_queue.
+ * Latencies are measured from the moment an element is pushed until it is
+ * popped, and are only updated if latency statistics are enabled.
+ * \ingroup mrpt_containers_grp
+ */
+struct ring_queue_stats
+{
+	/** Number of successfully pushed and popped elements */
+	uint64_t pushed = 0, popped = 0;
+	/** Number of push attempts that failed because the queue was full */
+	uint64_t push_failures = 0;
+	/** Number of popped elements that were considered for latency stats */
+	uint64_t latency_samples = 0;
+	/** Mean and maximum latency, in seconds */
+	double latency_mean = 0, latency_max = 0;
+};
+
+namespace internal
+{
+/** Used to avoid false sharing between producer and consumer indices */
+constexpr std::size_t ring_queue_cacheline = 64;
+
+/** Rounds up to the next power of two (minimum: 2) */
+inline std::size_t ring_queue_capacity(std::size_t n)
+{
+	if (n == 0) throw std::invalid_argument("ring queue capacity must be >0");
+	std::size_t c = 2;
+	while (c < n)
+		c <<= 1;
+	return c;
+}
+
+/** Common members to both queue types: statistics and blocking waits */
+class ring_queue_base
+{
+   public:
+	using clock_t = std::chrono::steady_clock;
+
+	/** Enable/disable latency statistics (default: enabled). Disabling them
+	 * saves two clock reads per element. */
+	void latency_stats_enabled(bool enable) { m_with_latency = enable; }
+	bool latency_stats_enabled() const { return m_with_latency; }
+
+	/** Resets all accumulated latency and failure statistics */
+	void reset_stats()
+	{
+		m_push_failures = 0;
+		m_latency_n = 0;
+		m_latency_sum_ns = 0;
+		m_latency_max_ns = 0;
+	}
+
+   protected:
+	ring_queue_stats stats_impl(uint64_t pushed, uint64_t popped) const
+	{
+		ring_queue_stats s;
+		s.pushed = pushed;
+		s.popped = popped;
+		s.push_failures = m_push_failures.load(std::memory_order_relaxed);
+		s.latency_samples = m_latency_n.load(std::memory_order_relaxed);
+		if (s.latency_samples)
+			s.latency_mean =
+				1e-9 * m_latency_sum_ns.load(std::memory_order_relaxed) /
+				s.latency_samples;
+		s.latency_max = 1e-9 * m_latency_max_ns.load(std::memory_order_relaxed);
+		return s;
+	}
+
+	clock_t::time_point stamp() const
+	{
+		return m_with_latency ? clock_t::now() : clock_t::time_point();
+	}
+
+	void on_push_failure()
+	{
+		m_push_failures.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void on_popped(const clock_t::time_point& pushedAt)
+	{
+		if (!m_with_latency || pushedAt == clock_t::time_point()) return;
+		const uint64_t ns = static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(
+				clock_t::now() - pushedAt)
+				.count());
+		m_latency_n.fetch_add(1, std::memory_order_relaxed);
+		m_latency_sum_ns.fetch_add(ns, std::memory_order_relaxed);
+		uint64_t prevMax = m_latency_max_ns.load(std::memory_order_relaxed);
+		while (ns > prevMax &&
+			   !m_latency_max_ns.compare_exchange_weak(
+				   prevMax, ns, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	/** Retries `f()` until it returns true or the timeout expires, spinning
+	 * first, then yielding, then sleeping for short periods. */
+	template <class F, class Rep, class Period>
+	static bool retry_until(
+		F&& f, const std::chrono::duration<Rep, Period>& timeout)
+	{
+		const auto deadline = clock_t::now() +
+			std::chrono::duration_cast<clock_t::duration>(timeout);
+		for (unsigned int iter = 0;; iter++)
+		{
+			if (f()) return true;
+			if (iter < 64) continue;
+			if (clock_t::now() >= deadline) return false;
+			if (iter < 128) std::this_thread::yield();
+			else
+				std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+	}
+
+   private:
+	std::atomic_bool m_with_latency{true};
+	std::atomic<uint64_t> m_push_failures{0};
+	std::atomic<uint64_t> m_latency_n{0}, m_latency_sum_ns{0},
+		m_latency_max_ns{0};
+};
+
+/** Raw, uninitialized storage for one element of type T */
+template <typename T>
+struct ring_queue_storage
+{
+	alignas(T) unsigned char data[sizeof(T)];
+	ring_queue_base::clock_t::time_point pushedAt;
+
+	T* ptr() { return std::launder(reinterpret_cast<T*>(data)); }
+};
+}  // namespace internal
+
+/** A bounded, lock-free, single-producer single-consumer (SPSC) FIFO queue,
+ * implemented as a ring buffer with a power-of-two capacity.
+ *
+ * Exactly one thread may push and exactly one (possibly different) thread may
+ * pop at any given time. Elements may be move-only types (e.g.
+ * `std::unique_ptr<T>`). Both non-blocking (try_push(), try_pop()) and
+ * blocking calls with a timeout (push(), pop()) are provided, with the
+ * latter spinning, then yielding and finally sleeping while waiting.
+ *
+ * Push-to-pop latency statistics are available via stats().
+ *
+ * \sa mpmc_ring_queue, CThreadSafeQueue
+ * \note Defined in #include <mrpt/containers/lockfree_ring_queue.h>
+ * \note (New in MRPT 2.4.3)
+ * \ingroup mrpt_containers_grp
+ */
+template <typename T>
+class spsc_ring_queue : public internal::ring_queue_base
+{
+   public:
+	using value_type = T;
+
+	/** Creates an empty queue able to hold at least `capacity` elements
+	 * (rounded up to the next power of two) */
+	explicit spsc_ring_queue(std::size_t capacity)
+		: m_capacity(internal::ring_queue_capacity(capacity)),
+		  m_mask(m_capacity - 1),
+		  m_slots(new slot_t[m_capacity])
+	{
+	}
+	~spsc_ring_queue() { clear(); }
+
+	spsc_ring_queue(const spsc_ring_queue&) = delete;
+	spsc_ring_queue& operator=(const spsc_ring_queue&) = delete;
+
+	/** Constructs a new element in place at the end of the queue.
+	 * \return false if the queue was full (the element is not inserted).
+	 * \note Only call from the producer thread. */
+	template <typename... Args>
+	bool try_emplace(Args&&... args)
+	{
+		if (emplace_impl(std::forward<Args>(args)...)) return true;
+		on_push_failure();
+		return false;
+	}
+
+	/** Non-blocking push. \return false if the queue was full. */
+	bool try_push(T&& v) { return try_emplace(std::move(v)); }
+	bool try_push(const T& v) { return try_emplace(v); }
+
+	/** Blocking push: waits up to `timeout` for free space.
+	 * \return false on timeout. */
+	template <class Rep, class Period>
+	bool push(T&& v, const std::chrono::duration<Rep, Period>& timeout)
+	{
+		if (retry_until([&]() { return emplace_impl(std::move(v)); }, timeout))
+			return true;
+		on_push_failure();
+		return false;
+	}
+
+	/** Non-blocking pop into `out`. \return false if the queue was empty.
+	 * \note Only call from the consumer thread. */
+	bool try_pop(T& out)
+	{
+		const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+		if (tail == m_cached_head)
+		{
+			m_cached_head = m_head.load(std::memory_order_acquire);
+			if (tail == m_cached_head) return false;
+		}
+		slot_t& s = m_slots[tail & m_mask];
+		T* p = s.ptr();
+		out = std::move(*p);
+		p->~T();
+		on_popped(s.pushedAt);
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Blocking pop: waits up to `timeout` for an element.
+	 * \return false on timeout. */
+	template <class Rep, class Period>
+	bool pop(T& out, const std::chrono::duration<Rep, Period>& timeout)
+	{
+		return retry_until([&]() { return try_pop(out); }, timeout);
+	}
+
+	/** Destroys all pending elements. \note Only call from the consumer
+	 * thread, or while no other thread is using the queue. */
+	void clear()
+	{
+		const std::size_t head = m_head.load(std::memory_order_acquire);
+		std::size_t tail = m_tail.load(std::memory_order_relaxed);
+		for (; tail != head; ++tail)
+			m_slots[tail & m_mask].ptr()->~T();
+		m_tail.store(tail, std::memory_order_release);
+	}
+
+	/** Approximate number of elements (exact if called from the producer
+	 * or consumer thread while the other one is idle). */
+	std::size_t size() const
+	{
+		const std::size_t tail = m_tail.load(std::memory_order_acquire);
+		const std::size_t head = m_head.load(std::memory_order_acquire);
+		return head - tail;
+	}
+	bool empty() const { return size() == 0; }
+	bool full() const { return size() >= m_capacity; }
+	std::size_t capacity() const { return m_capacity; }
+
+	/** Returns the accumulated statistics */
+	ring_queue_stats stats() const
+	{
+		return stats_impl(
+			m_head.load(std::memory_order_relaxed),
+			m_tail.load(std::memory_order_relaxed));
+	}
+
+   private:
+	using slot_t = internal::ring_queue_storage<T>;
+
+	template <typename... Args>
+	bool emplace_impl(Args&&... args)
+	{
+		const std::size_t head = m_head.load(std::memory_order_relaxed);
+		if (head - m_cached_tail == m_capacity)
+		{
+			m_cached_tail = m_tail.load(std::memory_order_acquire);
+			if (head - m_cached_tail == m_capacity) return false;
+		}
+		slot_t& s = m_slots[head & m_mask];
+		new (s.data) T(std::forward<Args>(args)...);
+		s.pushedAt = stamp();
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	const std::size_t m_capacity, m_mask;
+	std::unique_ptr<slot_t[]> m_slots;
+
+	/** Written by the producer only */
+	alignas(internal::ring_queue_cacheline) std::atomic<std::size_t> m_head{0};
+	std::size_t m_cached_tail = 0;
+	/** Written by the consumer only */
+	alignas(internal::ring_queue_cacheline) std::atomic<std::size_t> m_tail{0};
+	std::size_t m_cached_head = 0;
+};
+
+/** A bounded, lock-free, multiple-producer multiple-consumer (MPMC) FIFO
+ * queue, implemented as a ring buffer of sequence-numbered cells (D. Vyukov's
+ * bounded MPMC queue), with a power-of-two capacity.
+ *
+ * Any number of threads may push and pop concurrently. Elements may be
+ * move-only types. API and statistics are identical to spsc_ring_queue.
+ * If the constructor of T throws while pushing, the exception is propagated
+ * and the queue remains consistent.
+ *
+ * \sa spsc_ring_queue
+ * \note Defined in #include <mrpt/containers/lockfree_ring_queue.h>
+ * \note (New in MRPT 2.4.3)
+ * \ingroup mrpt_containers_grp
+ */
+template <typename T>
+class mpmc_ring_queue : public internal::ring_queue_base
+{
+   public:
+	using value_type = T;
+
+	/** Creates an empty queue able to hold at least `capacity` elements
+	 * (rounded up to the next power of two) */
+	explicit mpmc_ring_queue(std::size_t capacity)
+		: m_capacity(internal::ring_queue_capacity(capacity)),
+		  m_mask(m_capacity - 1),
+		  m_cells(new cell_t[m_capacity])
+	{
+		for (std::size_t i = 0; i < m_capacity; i++)
+			m_cells[i].seq.store(i, std::memory_order_relaxed);
+	}
+	~mpmc_ring_queue() { clear(); }
+
+	mpmc_ring_queue(const mpmc_ring_queue&) = delete;
+	mpmc_ring_queue& operator=(const mpmc_ring_queue&) = delete;
+
+	/** Constructs a new element in place at the end of the queue.
+	 * \return false if the queue was full (the element is not inserted). */
+	template <typename... Args>
+	bool try_emplace(Args&&... args)
+	{
+		if (emplace_impl(std::forward<Args>(args)...)) return true;
+		on_push_failure();
+		return false;
+	}
+
+	/** Non-blocking push. \return false if the queue was full. */
+	bool try_push(T&& v) { return try_emplace(std::move(v)); }
+	bool try_push(const T& v) { return try_emplace(v); }
+
+	/** Blocking push: waits up to `timeout` for free space.
+	 * \return false on timeout. */
+	template <class Rep, class Period>
+	bool push(T&& v, const std::chrono::duration<Rep, Period>& timeout)
+	{
+		if (retry_until([&]() { return emplace_impl(std::move(v)); }, timeout))
+			return true;
+		on_push_failure();
+		return false;
+	}
+
+	/** Non-blocking pop into `out`. \return false if the queue was empty. */
+	bool try_pop(T& out)
+	{
+		cell_t* c;
+		std::size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			c = &m_cells[pos & m_mask];
+			const std::size_t seq = c->seq.load(std::memory_order_acquire);
+			const auto dif = static_cast<std::ptrdiff_t>(seq) -
+				static_cast<std::ptrdiff_t>(pos + 1);
+			if (dif == 0)
+			{
+				if (m_dequeue_pos.compare_exchange_weak(
+						pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (dif < 0)
+				return false;
+			else
+				pos = m_dequeue_pos.load(std::memory_order_relaxed);
+		}
+		if (!c->valid)
+		{
+			// A producer failed to construct this element: skip it.
+			c->seq.store(pos + m_mask + 1, std::memory_order_release);
+			return try_pop(out);
+		}
+		T* p = c->ptr();
+		out = std::move(*p);
+		p->~T();
+		on_popped(c->pushedAt);
+		c->seq.store(pos + m_mask + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Blocking pop: waits up to `timeout` for an element.
+	 * \return false on timeout. */
+	template <class Rep, class Period>
+	bool pop(T& out, const std::chrono::duration<Rep, Period>& timeout)
+	{
+		return retry_until([&]() { return try_pop(out); }, timeout);
+	}
+
+	/** Pops and destroys all pending elements. */
+	void clear()
+	{
+		for (;;)
+		{
+			// Pop into raw storage, so T needs not be default-constructible:
+			cell_t* c;
+			std::size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				c = &m_cells[pos & m_mask];
+				const std::size_t seq = c->seq.load(std::memory_order_acquire);
+				const auto dif = static_cast<std::ptrdiff_t>(seq) -
+					static_cast<std::ptrdiff_t>(pos + 1);
+				if (dif == 0)
+				{
+					if (m_dequeue_pos.compare_exchange_weak(
+							pos, pos + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (dif < 0)
+					return;
+				else
+					pos = m_dequeue_pos.load(std::memory_order_relaxed);
+			}
+			if (c->valid) c->ptr()->~T();
+			c->seq.store(pos + m_mask + 1, std::memory_order_release);
+		}
+	}
+
+	/** Approximate number of elements */
+	std::size_t size() const
+	{
+		const std::size_t deq = m_dequeue_pos.load(std::memory_order_acquire);
+		const std::size_t enq = m_enqueue_pos.load(std::memory_order_acquire);
+		return enq > deq ? enq - deq : 0;
+	}
+	bool empty() const { return size() == 0; }
+	bool full() const { return size() >= m_capacity; }
+	std::size_t capacity() const { return m_capacity; }
+
+	/** Returns the accumulated statistics */
+	ring_queue_stats stats() const
+	{
+		return stats_impl(
+			m_enqueue_pos.load(std::memory_order_relaxed),
+			m_dequeue_pos.load(std::memory_order_relaxed));
+	}
+
+   private:
+	struct cell_t : public internal::ring_queue_storage<T>
+	{
+		std::atomic<std::size_t> seq{0};
+		/** false if T's constructor threw after claiming this cell */
+		bool valid = false;
+	};
+
+	template <typename... Args>
+	bool emplace_impl(Args&&... args)
+	{
+		cell_t* c;
+		std::size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			c = &m_cells[pos & m_mask];
+			const std::size_t seq = c->seq.load(std::memory_order_acquire);
+			const auto dif = static_cast<std::ptrdiff_t>(seq) -
+				static_cast<std::ptrdiff_t>(pos);
+			if (dif == 0)
+			{
+				if (m_enqueue_pos.compare_exchange_weak(
+						pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (dif < 0)
+				return false;
+			else
+				pos = m_enqueue_pos.load(std::memory_order_relaxed);
+		}
+		// Other producers may have already claimed the following cells, so
+		// this one cannot be given back: if T's constructor throws, publish
+		// it as an empty cell that consumers will skip.
+		try
+		{
+			new (c->data) T(std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			c->valid = false;
+			c->seq.store(pos + 1, std::memory_order_release);
+			throw;
+		}
+		c->valid = true;
+		c->pushedAt = stamp();
+		c->seq.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	const std::size_t m_capacity, m_mask;
+	std::unique_ptr<cell_t[]> m_cells;
+
+	alignas(internal::ring_queue_cacheline)
+		std::atomic<std::size_t> m_enqueue_pos{0};
+	alignas(internal::ring_queue_cacheline)
+		std::atomic<std::size_t> m_dequeue_pos{0};
+};
+
+}  // namespace mrpt::containers
@@ -20,6 +20,7 @@
 #include <any>
 #include <array>
 #include <cstdint>
+#include <functional>
 #include <iosfwd>
 #include <limits>
 #include <map>
@@ -60,7 +61,8 @@ namespace mrpt::containers
  *YAML files or as a database.
  *
  * yaml can be used to parse YAML (v1.2) or JSON streams, and to emit YAML.
- * It does not support event-based parsing.
+ * Large documents can also be processed without building the tree, with the
+ * event-based (streaming) API: ParseEvents() and ParseEventsFromFile().
  * The parser uses Pantelis Antoniou's awesome
  *[libfyaml](https://github.com/pantoniou/libfyaml), which
  *[passes](http://matrix.yaml.io/) the full [YAML
@@ -109,6 +111,11 @@ class yaml
 
 		node_t() = default;
 		~node_t() = default;
+		// (Explicitly defaulted: the destructor above would disable moves)
+		node_t(const node_t&) = default;
+		node_t(node_t&&) = default;
+		node_t& operator=(const node_t&) = default;
+		node_t& operator=(node_t&&) = default;
 
 		template <
 			typename T,	 //
@@ -184,10 +191,11 @@ class yaml
 		const std::string_view internalAsStr() const
 		{
 			ASSERT_(isScalar());
-			if (const char* const* s = std::any_cast<const char*>(&asScalar());
+			// (std::string first: the type of all parsed keys)
+			if (const std::string* s = std::any_cast<std::string>(&asScalar());
 				s != nullptr)
 			{ return {*s}; }
-			if (const std::string* s = std::any_cast<std::string>(&asScalar());
+			if (const char* const* s = std::any_cast<const char*>(&asScalar());
 				s != nullptr)
 			{ return {*s}; }
 			if (const std::string_view* s =
@@ -363,6 +371,81 @@ class yaml
 
 	/** @} */
 
+	/** @name Event-based (streaming) parsing
+	 * @{ */
+
+	/** Types of parser events. \sa ParseEvents() */
+	enum class EventType : uint8_t
+	{
+		DocumentStart = 0,
+		DocumentEnd,
+		MapStart,
+		MapEnd,
+		SequenceStart,
+		SequenceEnd,
+		Scalar,
+		/** A reference (`*name`) to a former node with an anchor (`&name`) */
+		Alias
+	};
+
+	/** A parser event. \sa ParseEvents() */
+	struct Event
+	{
+		EventType type = EventType::Scalar;
+
+		/** Scalar: its text (unquoted, escape sequences already processed).
+		 * Alias: the anchor name. Empty for other events.
+		 * It points to the parser buffers: only valid during the callback. */
+		std::string_view value;
+
+		/** Anchor (`&name`) of a scalar, map or sequence, if any. */
+		std::string_view anchor;
+
+		/** Number of maps and sequences enclosing this event (0 for the
+		 * top-level node; MapStart/MapEnd events of a map are at the same
+		 * depth than the map itself). */
+		int depth = 0;
+
+		/** True for scalars, aliases and MapStart/SequenceStart events which
+		 * are a key in a map (instead of a value) */
+		bool isMapKey = false;
+	};
+
+	/** Callback for ParseEvents(). Return false to stop parsing. */
+	using EventHandler = std::function<bool(const Event&)>;
+
+	/** Parses a text as YAML or JSON (autodetected), invoking `handler` for
+	 * each event (start and end of documents, maps and sequences; scalars),
+	 * without building a yaml tree. Use it to extract a few values from large
+	 * documents, or to build custom data structures directly. Parsing stops
+	 * when the end of the text is reached or the handler returns false.
+	 *
+	 * Example: Print all keys in a document, indented by depth:
+	 * \code
+	 * yaml::ParseEvents(text, [](const yaml::Event& e) {
+	 *     if (e.isMapKey && e.type == yaml::EventType::Scalar)
+	 *         std::cout << std::string(2 * e.depth, ' ') << e.value << "\n";
+	 *     return true;
+	 * });
+	 * \endcode
+	 *
+	 * \exception std::exception Upon format errors.
+	 * \sa ParseEventsFromFile()
+	 * \note (New in MRPT 2.4.3)
+	 */
+	static void ParseEvents(
+		const std::string& yamlTextBlock, const EventHandler& handler);
+
+	/** Like ParseEvents(), but reading from a file, which is never loaded
+	 * into memory as a whole.
+	 * \exception std::exception Upon I/O or format errors.
+	 * \note (New in MRPT 2.4.3)
+	 */
+	static void ParseEventsFromFile(
+		const std::string& fileName, const EventHandler& handler);
+
+	/** @} */
+
 	/** @name Content and type checkers
 	 * @{ */
 	/** For map nodes, checks if the given key name exists.
@@ -0,0 +1,164 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/containers/lockfree_ring_queue.h>
+
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+template <class QUEUE>
+static void testFullAndEmpty()
+{
+	QUEUE q(5);
+	EXPECT_EQ(q.capacity(), 8U);
+	EXPECT_TRUE(q.empty());
+
+	typename QUEUE::value_type v;
+	EXPECT_FALSE(q.try_pop(v));
+
+	for (int i = 0; i < 8; i++)
+		EXPECT_TRUE(q.try_push(std::make_unique<int>(i)));
+	EXPECT_TRUE(q.full());
+	EXPECT_FALSE(q.try_push(std::make_unique<int>(100)));
+	EXPECT_FALSE(q.push(std::make_unique<int>(100), 1ms));
+
+	for (int i = 0; i < 8; i++)
+	{
+		ASSERT_TRUE(q.try_pop(v));
+		ASSERT_TRUE(v);
+		EXPECT_EQ(*v, i);
+	}
+	EXPECT_FALSE(q.pop(v, 1ms));
+
+	const auto s = q.stats();
+	EXPECT_EQ(s.pushed, 8U);
+	EXPECT_EQ(s.popped, 8U);
+	EXPECT_EQ(s.push_failures, 2U);
+	EXPECT_EQ(s.latency_samples, 8U);
+	EXPECT_GE(s.latency_max, s.latency_mean);
+
+	// Pending elements must be freed on destruction:
+	for (int i = 0; i < 3; i++)
+		EXPECT_TRUE(q.try_push(std::make_unique<int>(i)));
+}
+
+TEST(lockfree_ring_queue, spsc_full_empty)
+{
+	testFullAndEmpty<
+		mrpt::containers::spsc_ring_queue<std::unique_ptr<int>>>();
+}
+
+TEST(lockfree_ring_queue, mpmc_full_empty)
+{
+	testFullAndEmpty<
+		mrpt::containers::mpmc_ring_queue<std::unique_ptr<int>>>();
+}
+
+TEST(lockfree_ring_queue, spsc_threads_keep_order)
+{
+	constexpr int N = 100000;
+	mrpt::containers::spsc_ring_queue<int> q(64);
+
+	std::thread producer([&]() {
+		for (int i = 0; i < N; i++)
+			while (!q.push(int(i), 10ms))
+			{
+			}
+	});
+
+	int expected = 0;
+	while (expected < N)
+	{
+		int v;
+		if (!q.pop(v, 100ms)) continue;
+		ASSERT_EQ(v, expected);
+		expected++;
+	}
+	producer.join();
+	EXPECT_TRUE(q.empty());
+}
+
+TEST(lockfree_ring_queue, mpmc_threads_no_loss)
+{
+	constexpr int N = 20000, nProducers = 3, nConsumers = 3;
+	mrpt::containers::mpmc_ring_queue<int> q(128);
+
+	std::vector<std::thread> threads;
+	for (int p = 0; p < nProducers; p++)
+		threads.emplace_back([&, p]() {
+			for (int i = 1; i <= N; i++)
+				while (!q.push(int(i + p * N), 10ms))
+				{
+				}
+		});
+
+	std::atomic<int64_t> sum{0};
+	std::atomic<int> count{0};
+	for (int c = 0; c < nConsumers; c++)
+		threads.emplace_back([&]() {
+			while (count < N * nProducers)
+			{
+				int v;
+				if (!q.pop(v, 1ms)) continue;
+				sum += v;
+				count++;
+			}
+		});
+
+	for (auto& t : threads)
+		t.join();
+
+	const int64_t total = int64_t(N) * nProducers;
+	EXPECT_EQ(count, total);
+	EXPECT_EQ(sum, total * (total + 1) / 2);
+}
+
+namespace
+{
+struct ThrowOnNegative
+{
+	ThrowOnNegative() = default;
+	explicit ThrowOnNegative(int v) : value(v)
+	{
+		if (v < 0) throw std::runtime_error("negative");
+	}
+	int value = 0;
+};
+}  // namespace
+
+TEST(lockfree_ring_queue, mpmc_throwing_constructor)
+{
+	mrpt::containers::mpmc_ring_queue<ThrowOnNegative> q(4);
+
+	EXPECT_TRUE(q.try_emplace(1));
+	EXPECT_THROW(q.try_emplace(-1), std::runtime_error);
+	EXPECT_TRUE(q.try_emplace(2));
+
+	// The failed element is skipped, and its cell reused afterwards:
+	for (int round = 0; round < 3; round++)
+	{
+		ThrowOnNegative v;
+		ASSERT_TRUE(q.try_pop(v));
+		EXPECT_EQ(v.value, 1 + 2 * round);
+		ASSERT_TRUE(q.try_pop(v));
+		EXPECT_EQ(v.value, 2 + 2 * round);
+		EXPECT_FALSE(q.try_pop(v));
+
+		EXPECT_TRUE(q.try_emplace(3 + 2 * round));
+		EXPECT_THROW(q.try_emplace(-1), std::runtime_error);
+		EXPECT_TRUE(q.try_emplace(4 + 2 * round));
+	}
+	q.clear();
+	EXPECT_TRUE(q.empty());
+}
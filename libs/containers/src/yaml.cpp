@@ -18,7 +18,7 @@
 #include <fstream>
 #include <iostream>
 #include <istream>
-#include <stack>
+#include <memory>
 
 #if MRPT_HAS_FYAML
 #include <libfyaml.h>
@@ -764,7 +764,7 @@ yaml yaml::FromText(const std::string& yamlTextBlock)
 }
 
 // TODO: Allow users to add custom filters?
-static yaml::scalar_t textToScalar(const std::string& s)
+static yaml::scalar_t textToScalar(const std::string_view& s)
 {
 	// tag:yaml.org,2002:null
 	// https://yaml.org/spec/1.2/spec.html#id2803362
@@ -772,12 +772,10 @@ static yaml::scalar_t textToScalar(const std::string& s)
 
 	// TODO: Try to parse to int or double?
 
-	return {s};
+	return {std::string(s)};
 }
 
 #if MRPT_HAS_FYAML
-static std::optional<yaml::node_t> recursiveParse(struct fy_parser* p);
-
 static bool MRPT_YAML_PARSER_VERBOSE =
 	mrpt::get_env<bool>("MRPT_YAML_PARSER_VERBOSE", false);
 
@@ -824,160 +822,249 @@ static void parseTokenComments(struct fy_token* tk, yaml::node_t& n)
 	}
 }
 
-static std::optional<yaml::node_t> recursiveParse(struct fy_parser* p)
+namespace
 {
-	MRPT_START
+struct ParserDeleter
+{
+	void operator()(struct fy_parser* p) const { fy_parser_destroy(p); }
+};
+using parser_ptr_t = std::unique_ptr<struct fy_parser, ParserDeleter>;
 
-	struct fy_event* event = fy_parser_parse(p);
-	if (!event) return {};
+struct EventDeleter
+{
+	struct fy_parser* p = nullptr;
+	void operator()(struct fy_event* e) const { fy_parser_event_free(p, e); }
+};
 
-	// process event:
-	switch (event->type)
-	{
-		case FYET_NONE:
-		{
-			PARSER_DBG_OUT("Event: None");
-			fy_parser_event_free(p, event);	 // free event
-			return recursiveParse(p);  // Keep going
-		}
-		break;
-		case FYET_STREAM_START:
-		{
-			PARSER_DBG_OUT("Event: Stream start");
-			fy_parser_event_free(p, event);	 // free event
-			return recursiveParse(p);  // Keep going
-		}
-		break;
-		case FYET_STREAM_END:
-		{
-			PARSER_DBG_OUT("Event: Stream end");
-			fy_parser_event_free(p, event);	 // free event
-			return recursiveParse(p);  // Keep going
-		}
-		break;
-		case FYET_DOCUMENT_START:
-		{
-			PARSER_DBG_OUT("Event: Doc start");
-			fy_parser_event_free(p, event);	 // free event
-			return recursiveParse(p);  // Keep going
-		}
-		break;
-		case FYET_DOCUMENT_END:
-		{
-			PARSER_DBG_OUT("Event: Doc end");
-			fy_parser_event_free(p, event);	 // free event
-			return recursiveParse(p);  // Keep going
-		}
-		break;
-		case FYET_MAPPING_START:
-		{
-			PARSER_DBG_OUT("Event: MAP START");
-			fy_parser_event_free(p, event);	 // free event
+std::string_view tokenText(struct fy_token* tk)
+{
+	if (!tk) return {};
+	size_t len = 0;
+	const char* str = fy_token_get_text(tk, &len);
+	if (!str) return {};
+	return {str, len};
+}
 
-			yaml::node_t n;
-			yaml::map_t& m = n.d.emplace<yaml::map_t>();
+parser_ptr_t createParser(bool parseComments)
+{
+	struct fy_parse_cfg cfg = {};
+	cfg.search_path = "";
+	cfg.diag = nullptr;
+	if (parseComments) cfg.flags = FYPCF_PARSE_COMMENTS;
 
-			parseTokenComments(event->scalar.value, n);
+	parser_ptr_t parser(fy_parser_create(&cfg));
+	ASSERT_(parser);
+	return parser;
+}
 
-			for (;;)
-			{
-				// Next event is map key:
-				auto nKey = recursiveParse(p);
-				// end of map reached?
-				if (!nKey.has_value()) break;
+void setParserInputText(struct fy_parser* p, const std::string& text)
+{
+	if (fy_parser_set_string(p, text.data(), text.size()))
+		THROW_EXCEPTION("Error in fy_parser_set_string()");
+}
 
-				ASSERT_(nKey->isScalar());
+void setParserInputFile(struct fy_parser* p, const std::string& fileName)
+{
+	// libfyaml opens the file on the first parse() call: check it here to
+	// report a meaningful error.
+	if (!std::ifstream(fileName).is_open())
+		THROW_EXCEPTION_FMT(
+			"Error opening for read file `%s`", fileName.c_str());
 
-				// Move comments from key:
-				yaml::node_t& val = m[*nKey];
+	if (fy_parser_set_input_file(p, fileName.c_str()))
+		THROW_EXCEPTION_FMT(
+			"Error in fy_parser_set_input_file() for file `%s`",
+			fileName.c_str());
+}
 
-				// and next event is mapped content:
-				auto nVal = recursiveParse(p);
-				ASSERT_(nVal.has_value());
+/** Runs the parser, invoking `f(event, token)` for each event until the end
+ * of the stream, or until `f()` returns false. `token` is the libfyaml token
+ * for comments of scalars and maps and sequences (or null).
+ */
+template <class F>
+void forEachEvent(struct fy_parser* p, const F& f)
+{
+	// For each enclosing map or sequence: whether it is a map, and whether
+	// its next node is a key:
+	struct Level
+	{
+		bool isMap = false;
+		bool nextIsKey = false;
+	};
+	std::vector<Level> levels;
 
-				val = std::move(nVal.value());
-			}
+	// Common to scalars, aliases, and maps and sequences starts:
+	const auto startNode = [&levels](yaml::Event& e) {
+		if (levels.empty() || !levels.back().isMap) return;
+		e.isMapKey = levels.back().nextIsKey;
+		levels.back().nextIsKey = !levels.back().nextIsKey;
+	};
 
-			return n;
-		}
-		break;
-		case FYET_MAPPING_END:
+	for (;;)
+	{
+		struct fy_event* fe = fy_parser_parse(p);
+		if (!fe)
 		{
-			PARSER_DBG_OUT("Event: MAP END");
-			fy_parser_event_free(p, event);	 // free event
-			return {};
+			if (fy_parser_get_stream_error(p))
+				THROW_EXCEPTION(
+					"YAML parser error. Re-run with environment variable "
+					"MRPT_YAML_PARSER_VERBOSE=1 to get more details.");
+			break;	// End of stream
 		}
-		break;
-		case FYET_SEQUENCE_START:
+		const std::unique_ptr<struct fy_event, EventDeleter> feFree(
+			fe, EventDeleter{p});
+
+		yaml::Event e;
+		e.depth = static_cast<int>(levels.size());
+		struct fy_token* tk = nullptr;
+
+		switch (fe->type)
 		{
-			PARSER_DBG_OUT("Event: SEQ START");
-			fy_parser_event_free(p, event);	 // free event
-			yaml::node_t n;
-			yaml::sequence_t& s = n.d.emplace<yaml::sequence_t>();
+			case FYET_DOCUMENT_START:
+				e.type = yaml::EventType::DocumentStart;
+				break;
+			case FYET_DOCUMENT_END:
+				e.type = yaml::EventType::DocumentEnd;
+				break;
+			case FYET_MAPPING_START:
+				e.type = yaml::EventType::MapStart;
+				e.anchor = tokenText(fe->mapping_start.anchor);
+				tk = fe->mapping_start.mapping_start;
+				startNode(e);
+				levels.push_back({true, true});
+				break;
+			case FYET_SEQUENCE_START:
+				e.type = yaml::EventType::SequenceStart;
+				e.anchor = tokenText(fe->sequence_start.anchor);
+				tk = fe->sequence_start.sequence_start;
+				startNode(e);
+				levels.push_back({false, false});
+				break;
+			case FYET_MAPPING_END:
+			case FYET_SEQUENCE_END:
+				e.type = fe->type == FYET_MAPPING_END
+					? yaml::EventType::MapEnd
+					: yaml::EventType::SequenceEnd;
+				ASSERT_(!levels.empty());
+				levels.pop_back();
+				e.depth--;
+				break;
+			case FYET_SCALAR:
+				e.type = yaml::EventType::Scalar;
+				e.value = tokenText(fe->scalar.value);
+				e.anchor = tokenText(fe->scalar.anchor);
+				tk = fe->scalar.value;
+				startNode(e);
+				break;
+			case FYET_ALIAS:
+				e.type = yaml::EventType::Alias;
+				e.value = tokenText(fe->alias.anchor);
+				startNode(e);
+				break;
+			default:  // FYET_NONE, FYET_STREAM_START, FYET_STREAM_END
+				continue;
+		};
 
-			parseTokenComments(event->scalar.value, n);
+		PARSER_DBG_OUT(
+			"Event: type=" << static_cast<int>(e.type) << " depth=" << e.depth
+						   << " isMapKey=" << e.isMapKey << " value='"
+						   << e.value << "' anchor='" << e.anchor << "'");
 
-			for (;;)
-			{
-				auto entry = recursiveParse(p);
-				if (!entry.has_value()) break;	// end of sequence reached?
-				s.push_back(std::move(entry.value()));
-			}
+		if (!f(e, tk)) break;
+	}
+}
 
-			return n;
+/** Builds the tree of the first document in the stream */
+std::optional<yaml::node_t> buildTree(struct fy_parser* p)
+{
+	// Maps and sequences being parsed:
+	struct Level
+	{
+		yaml::node_t node;
+		std::optional<yaml::node_t> key;  // For maps: key of the next value
+		std::string anchor;
+	};
+	std::vector<Level> levels;
+	std::optional<yaml::node_t> root;
+	std::map<std::string, yaml::node_t, std::less<>> anchors;
+
+	// Adds a complete node to its parent map or sequence:
+	const auto addNode = [&](yaml::node_t&& n, const std::string_view& anchor) {
+		if (!anchor.empty()) anchors[std::string(anchor)] = n;
+		if (levels.empty())
+		{
+			root = std::move(n);
+			return;
 		}
-		break;
-		case FYET_SEQUENCE_END:
+		Level& parent = levels.back();
+		if (parent.node.isSequence())
+			std::get<yaml::sequence_t>(parent.node.d).push_back(std::move(n));
+		else if (!parent.key)
 		{
-			PARSER_DBG_OUT("Event: SEQ END");
-			fy_parser_event_free(p, event);	 // free event
-			return {};
+			ASSERTMSG_(n.isScalar(), "Only scalars are supported as map keys");
+			parent.key = std::move(n);
 		}
-		break;
-		case FYET_SCALAR:
+		else
+		{
+			std::get<yaml::map_t>(parent.node.d)
+				.insert_or_assign(std::move(*parent.key), std::move(n));
+			parent.key.reset();
+		}
+	};
+
+	forEachEvent(p, [&](const yaml::Event& e, struct fy_token* tk) {
+		switch (e.type)
 		{
-			size_t strValueLen = 0;
-			const char* strValue =
-				fy_token_get_text(event->scalar.value, &strValueLen);
-			const std::string sValue(strValue, strValueLen);
-
-			PARSER_DBG_OUT(
-				"token: " << reinterpret_cast<void*>(event->scalar.value)
-						  << " Scalar: implicit="
-						  << (event->scalar.tag_implicit ? "1" : "0")
-						  << " tag: " << ((void*)event->scalar.tag)
-						  << " anchor: " << ((void*)event->scalar.anchor)
-						  << fy_token_get_text0(event->scalar.anchor)
-						  << " value: " << sValue);
-
-			if (event->scalar.value)
+			case yaml::EventType::DocumentStart: break;
+			case yaml::EventType::DocumentEnd:
+				return false;  // Only the first document is loaded
+			case yaml::EventType::MapStart:
+			case yaml::EventType::SequenceStart:
+			{
+				Level& l = levels.emplace_back();
+				if (e.type == yaml::EventType::MapStart)
+					l.node.d.emplace<yaml::map_t>();
+				else
+					l.node.d.emplace<yaml::sequence_t>();
+				l.anchor = e.anchor;
+				parseTokenComments(tk, l.node);
+			}
+			break;
+			case yaml::EventType::MapEnd:
+			case yaml::EventType::SequenceEnd:
+			{
+				ASSERT_(!levels.empty());
+				Level l = std::move(levels.back());
+				levels.pop_back();
+				addNode(std::move(l.node), l.anchor);
+			}
+			break;
+			case yaml::EventType::Scalar:
 			{
 				yaml::node_t n;
-				n.d.emplace<yaml::scalar_t>(textToScalar(sValue));
-
-				parseTokenComments(event->scalar.value, n);
-
-				fy_parser_event_free(p, event);	 // free event
-				return n;
+				n.d.emplace<yaml::scalar_t>(textToScalar(e.value));
+				parseTokenComments(tk, n);
+				addNode(std::move(n), e.anchor);
 			}
-			else
+			break;
+			case yaml::EventType::Alias:
 			{
-				THROW_EXCEPTION(
-					"Unexpected empty scalar?! Re-run with environment "
-					"variable MRPT_YAML_PARSER_VERBOSE=1 to get more details.");
+				const auto it = anchors.find(e.value);
+				if (it == anchors.end())
+					THROW_EXCEPTION_FMT(
+						"Alias to unknown anchor `%.*s`",
+						static_cast<int>(e.value.size()), e.value.data());
+				addNode(yaml::node_t(it->second), {});
 			}
-		}
-		break;
-		case FYET_ALIAS:
-			fy_parser_event_free(p, event);	 // free event
-			return recursiveParse(p);  // Keep going
-	};
-
-	THROW_EXCEPTION_FMT("Unexpected parser event type %i", event->type);
+			break;
+		};
+		return true;
+	});
+	return root;
+}
+}  // namespace
 
 #undef PARSER_DBG_OUT
-	MRPT_END
-}
 #endif
 
 void yaml::loadFromText(const std::string& yamlTextBlock)
@@ -988,23 +1075,12 @@ void yaml::loadFromText(const std::string& yamlTextBlock)
 	// Reset:
 	*this = yaml();
 
-	struct fy_parse_cfg cfg;
-	cfg.search_path = "";
-	cfg.diag = nullptr;
-	cfg.flags = FYPCF_PARSE_COMMENTS;
-
-	struct fy_parser* parser = fy_parser_create(&cfg);
-	ASSERT_(parser);
-
-	if (fy_parser_set_string(
-			parser, yamlTextBlock.data(), yamlTextBlock.size()))
-		THROW_EXCEPTION("Error in fy_parser_set_string()");
+	auto parser = createParser(true);
+	setParserInputText(parser.get(), yamlTextBlock);
 
-	auto optNode = recursiveParse(parser);
+	auto optNode = buildTree(parser.get());
 	if (optNode.has_value()) root_ = std::move(optNode.value());
 
-	fy_parser_destroy(parser);
-
 #else
 	THROW_EXCEPTION("MRPT was built without libfyaml");
 #endif
@@ -1021,31 +1097,20 @@ yaml yaml::FromStream(std::istream& i)
 	MRPT_END
 }
 
-// Replicated from mrpt::io to avoid dependency to that module:
-static std::string local_file_get_contents(const std::string& fileName)
-{
-	// Credits: https://stackoverflow.com/a/2602258/1631514
-	// Note: Add "binary" to make sure the "tellg" file size matches the
-	// actual number of read bytes afterwards:
-	std::ifstream t(fileName, std::ios::binary);
-	if (!t.is_open())
-		THROW_EXCEPTION_FMT(
-			"file_get_contents(): Error opening for read file `%s`",
-			fileName.c_str());
-
-	t.seekg(0, std::ios::end);
-	std::size_t size = t.tellg();
-	std::string buffer(size, ' ');
-	t.seekg(0);
-	t.read(&buffer[0], size);
-	return buffer;
-}
-
 void yaml::loadFromFile(const std::string& fileName)
 {
 	MRPT_START
 	clear();
-	this->loadFromText(local_file_get_contents(fileName));
+#if MRPT_HAS_FYAML
+	// Parse it straight from the file, without a copy in memory:
+	auto parser = createParser(true);
+	setParserInputFile(parser.get(), fileName);
+
+	auto optNode = buildTree(parser.get());
+	if (optNode.has_value()) root_ = std::move(optNode.value());
+#else
+	THROW_EXCEPTION("MRPT was built without libfyaml");
+#endif
 	MRPT_END
 }
 
@@ -1073,6 +1138,38 @@ void yaml::loadFromStream(std::istream& i)
 	MRPT_END
 }
 
+void yaml::ParseEvents(
+	const std::string& yamlTextBlock, const EventHandler& handler)
+{
+	MRPT_START
+#if MRPT_HAS_FYAML
+	auto parser = createParser(false);
+	setParserInputText(parser.get(), yamlTextBlock);
+	forEachEvent(parser.get(), [&handler](const Event& e, struct fy_token*) {
+		return handler(e);
+	});
+#else
+	THROW_EXCEPTION("MRPT was built without libfyaml");
+#endif
+	MRPT_END
+}
+
+void yaml::ParseEventsFromFile(
+	const std::string& fileName, const EventHandler& handler)
+{
+	MRPT_START
+#if MRPT_HAS_FYAML
+	auto parser = createParser(false);
+	setParserInputFile(parser.get(), fileName);
+	forEachEvent(parser.get(), [&handler](const Event& e, struct fy_token*) {
+		return handler(e);
+	});
+#else
+	THROW_EXCEPTION("MRPT was built without libfyaml");
+#endif
+	MRPT_END
+}
+
 std::ostream& mrpt::containers::operator<<(std::ostream& o, const yaml& p)
 {
 	YamlEmitOptions eo;
@@ -12,6 +12,7 @@
 #include <mrpt/containers/yaml.h>
 #include <mrpt/io/vector_loadsave.h>
 #include <mrpt/system/COutputLogger.h>	// for enum type tests
+#include <mrpt/system/filesystem.h>
 #include <mrpt/system/os.h>
 
 #include <algorithm>  // count()
@@ -642,6 +643,94 @@ MRPT_TEST(yaml, fromYAML)
 }
 MRPT_TEST_END()
 
+// clang-format off
+const auto sampleYamlBlock_anchors = R"xxx(
+base: &b
+  x: 1
+  y: [2, 3]
+other: *b
+name: &n foo
+name2: *n
+)xxx";
+// clang-format on
+
+MRPT_TEST(yaml, anchorsAndAliases)
+{
+	const auto p = mrpt::containers::yaml::FromText(sampleYamlBlock_anchors);
+	EXPECT_EQ(p["other"]["x"].as<int>(), 1);
+	EXPECT_EQ(p["other"]["y"](1).as<int>(), 3);
+	EXPECT_EQ(p["name2"].as<std::string>(), "foo");
+
+	EXPECT_THROW(
+		mrpt::containers::yaml::FromText("a: *unknown\n"), std::exception);
+}
+MRPT_TEST_END()
+
+MRPT_TEST(yaml, parseErrors)
+{
+	EXPECT_THROW(mrpt::containers::yaml::FromText("a: [1, 2"), std::exception);
+	EXPECT_THROW(
+		mrpt::containers::yaml::FromFile("/nonexistent/file.yaml"),
+		std::exception);
+}
+MRPT_TEST_END()
+
+MRPT_TEST(yaml, parseEvents)
+{
+	using mrpt::containers::yaml;
+
+	std::string keys;
+	size_t nScalars = 0, nMaps = 0, nSeqs = 0, nEnds = 0;
+	yaml::ParseEvents(sampleYamlBlock_3, [&](const yaml::Event& e) {
+		switch (e.type)
+		{
+			case yaml::EventType::Scalar:
+				nScalars++;
+				if (e.isMapKey)
+					keys += mrpt::format(
+						"%s:%i,", std::string(e.value).c_str(), e.depth);
+				break;
+			case yaml::EventType::MapStart: nMaps++; break;
+			case yaml::EventType::SequenceStart: nSeqs++; break;
+			case yaml::EventType::MapEnd:
+			case yaml::EventType::SequenceEnd: nEnds++; break;
+			default: break;
+		};
+		return true;
+	});
+	EXPECT_EQ(keys, "mySeq:1,myMap:1,K:2,Q:2,P:2,nestedMap:2,a:3,b:3,c:3,");
+	EXPECT_EQ(nScalars, 19U);
+	EXPECT_EQ(nMaps, 3U);
+	EXPECT_EQ(nSeqs, 1U);
+	EXPECT_EQ(nEnds, nMaps + nSeqs);
+
+	// Stop as soon as a value is found, from a file:
+	const auto fil = mrpt::system::getTempFileName();
+	{
+		std::ofstream f(fil);
+		f << sampleYamlBlock_3;
+	}
+	std::string P;
+	bool nextIsP = false;
+	yaml::ParseEventsFromFile(fil, [&](const yaml::Event& e) {
+		if (e.type != yaml::EventType::Scalar) return true;
+		if (nextIsP)
+		{
+			P = e.value;
+			return false;
+		}
+		nextIsP = e.isMapKey && e.value == "P" && e.depth == 2;
+		return true;
+	});
+	EXPECT_EQ(P, "-5.0");
+
+	// Same contents than parsing from text:
+	const auto p = yaml::FromFile(fil);
+	EXPECT_EQ(p["myMap"]["nestedMap"]["c"].as<int>(), 3);
+	EXPECT_EQ(p["myMap"]["nestedMap"]["a"].comment(), "comment for a");
+}
+MRPT_TEST_END()
+
 MRPT_TEST(yaml, printInShortFormat)
 {
 	mrpt::containers::yaml n1 = mrpt::containers::yaml::Sequence({1, 2, 3});
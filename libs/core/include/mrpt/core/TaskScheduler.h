@@ -0,0 +1,294 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/pimpl.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mrpt
+{
+/** \addtogroup mrpt_core_grp
+ * @{ */
+
+class TaskGroup;
+
+/** A work-stealing task scheduler, for fine-grained (data) parallelism.
+ *
+ * Each worker thread owns a double-ended queue of tasks: tasks spawned from
+ * within a worker are pushed to, and popped from, the back of its own queue
+ * (LIFO, cache-friendly, no contention), while idle workers steal the oldest
+ * tasks (usually, the largest pieces of work) from the front of other
+ * workers' queues. Tasks submitted from threads that are not workers go to a
+ * shared injection queue.
+ *
+ * Tasks are not used directly, but through a TaskGroup, or the higher-level
+ * mrpt::parallel_for() and mrpt::parallel_reduce(). Threads waiting for a
+ * TaskGroup run pending tasks meanwhile, so nested parallel loops do not
+ * deadlock nor oversubscribe the CPU.
+ *
+ * All MRPT libraries share the scheduler returned by
+ * TaskScheduler::Instance(), with one thread less than CPU cores (the thread
+ * waiting for the results is the remaining one). Its size can be set with the
+ * environment variable `MRPT_NUM_THREADS` (total number of threads, including
+ * the caller: `MRPT_NUM_THREADS=1` runs everything serially), and workers are
+ * pinned to CPU cores if `MRPT_PIN_THREADS=1`.
+ *
+ * Use mrpt::WorkerThreadsPool instead for long-running or blocking jobs
+ * (e.g. I/O), or when std::future results are needed.
+ *
+ * \sa TaskGroup, parallel_for(), parallel_reduce()
+ * \note (New in MRPT 2.4.3)
+ */
+class TaskScheduler
+{
+   public:
+	/** Creates a scheduler with the given number of worker threads, named
+	 * `${name}[i]`. If `pinThreads` is true, worker `i` is bound to CPU core
+	 * `i` (modulo the number of cores; only in Linux and Windows). */
+	explicit TaskScheduler(
+		std::size_t numWorkers, bool pinThreads = false,
+		const std::string& name = "TaskScheduler");
+	~TaskScheduler();
+
+	TaskScheduler(const TaskScheduler&) = delete;
+	TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+	/** The scheduler shared by all MRPT libraries. */
+	static TaskScheduler& Instance();
+
+	/** Number of worker threads (it may be 0, then tasks are run by the
+	 * threads waiting for them). */
+	std::size_t size() const;
+
+	/** The number of threads which may run tasks concurrently: workers plus
+	 * the caller. */
+	std::size_t concurrency() const { return size() + 1; }
+
+	/** Returns true if the calling thread is a worker of this scheduler. */
+	bool isWorkerThread() const;
+
+	/** Runs one pending task (if any) in the calling thread, preferably one
+	 * from its own queue. Returns false if there were none. */
+	bool runPendingTask();
+
+   private:
+	friend class TaskGroup;
+	void submit(std::function<void()>&& f, TaskGroup* group);
+
+	struct Impl;
+	spimpl::unique_impl_ptr<Impl> m_impl;
+};
+
+/** A set of tasks run by a TaskScheduler, which can be waited for as a whole.
+ *
+ * If a task throws, the exception is rethrown by wait() and tasks of the
+ * group not started yet are skipped (see isCancelled()).
+ *
+ * \code
+ * mrpt::TaskGroup g;
+ * g.run([&]() { processLeftImage(); });
+ * g.run([&]() { processRightImage(); });
+ * g.wait();
+ * \endcode
+ *
+ * \note (New in MRPT 2.4.3)
+ */
+class TaskGroup
+{
+   public:
+	explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::Instance())
+		: m_scheduler(scheduler)
+	{
+	}
+	/** Waits for pending tasks, if any (exceptions are ignored). */
+	~TaskGroup();
+
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup& operator=(const TaskGroup&) = delete;
+
+	/** Submits a task. `f` is any callable object without arguments. */
+	template <class F>
+	void run(F&& f)
+	{
+		m_pending.fetch_add(1, std::memory_order_relaxed);
+		m_scheduler.submit(std::forward<F>(f), this);
+	}
+
+	/** Blocks until all tasks end, running pending tasks in the calling thread
+	 * meanwhile. If any task threw, the first exception is rethrown here.
+	 * Afterwards, the group can be reused. */
+	void wait();
+
+	/** Skips tasks of this group which did not start yet. */
+	void cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+
+	/** True after cancel() or an exception in a task, until wait() returns */
+	bool isCancelled() const
+	{
+		return m_cancelled.load(std::memory_order_relaxed);
+	}
+
+	TaskScheduler& scheduler() { return m_scheduler; }
+
+   private:
+	friend class TaskScheduler;
+	void onTaskDone(std::exception_ptr error) noexcept;
+
+	TaskScheduler& m_scheduler;
+	std::atomic_size_t m_pending{0};
+	std::atomic_bool m_cancelled{false};
+	std::mutex m_mtx;
+	std::condition_variable m_cv;
+	std::exception_ptr m_error;
+};
+
+namespace internal
+{
+/** Number of chunks of at most `grain` items for a range of `n` items.
+ * `grain=0` means "automatic": a few chunks per thread, to balance the load.
+ */
+inline std::size_t parallel_num_chunks(
+	std::size_t n, std::size_t grain, const TaskScheduler& s)
+{
+	if (!grain) grain = std::max<std::size_t>(1, n / (4 * s.concurrency()));
+	return (n + grain - 1) / grain;
+}
+
+// Runs f(c) for all c in [c0,c1), by recursive halving: the upper halves are
+// spawned as tasks, ready to be stolen by idle workers.
+template <class F>
+void parallel_chunks_split(
+	TaskGroup& g, std::size_t c0, std::size_t c1, const F& f)
+{
+	while (c1 - c0 > 1 && !g.isCancelled())
+	{
+		const std::size_t mid = c0 + (c1 - c0) / 2;
+		g.run([&g, mid, c1, &f]() { parallel_chunks_split(g, mid, c1, f); });
+		c1 = mid;
+	}
+	if (!g.isCancelled()) f(c0);
+}
+
+// Runs f(c) for all c in [0,nChunks).
+template <class F>
+void parallel_chunks(std::size_t nChunks, const F& f, TaskScheduler& s)
+{
+	if (nChunks == 1 || s.size() == 0)
+	{
+		for (std::size_t c = 0; c < nChunks; c++)
+			f(c);
+		return;
+	}
+	TaskGroup g(s);
+	try
+	{
+		parallel_chunks_split(g, 0, nChunks, f);
+	}
+	catch (...)
+	{
+		g.cancel();	 // ~TaskGroup() waits for the running ones
+		throw;
+	}
+	g.wait();
+}
+}  // namespace internal
+
+/** Runs `f(i0,i1)` for contiguous sub-ranges `[i0,i1)` covering `[begin,end)`
+ * in parallel, with the given TaskScheduler. Returns when all are done.
+ *
+ * Sub-ranges have at most `grain` items (and at least `grain/2`, except if
+ * the whole range is smaller), hence `grain` should be large enough to make
+ * the overhead of one task (~1 us) negligible. With `grain=0`, the range is
+ * split into a few chunks per thread.
+ *
+ * The first exception thrown by `f` (if any) is rethrown by this function.
+ *
+ * \code
+ * mrpt::parallel_for(0, img.rows(), 16, [&](size_t r0, size_t r1) {
+ *     for (size_t r = r0; r < r1; r++) processRow(r);
+ * });
+ * \endcode
+ *
+ * \sa parallel_reduce()
+ * \note (New in MRPT 2.4.3)
+ */
+template <class F>
+void parallel_for(
+	std::size_t begin, std::size_t end, std::size_t grain, const F& f,
+	TaskScheduler& scheduler = TaskScheduler::Instance())
+{
+	if (end <= begin) return;
+	const std::size_t n = end - begin;
+	const std::size_t nChunks =
+		internal::parallel_num_chunks(n, grain, scheduler);
+	internal::parallel_chunks(
+		nChunks,
+		[&](std::size_t c) {
+			f(begin + c * n / nChunks, begin + (c + 1) * n / nChunks);
+		},
+		scheduler);
+}
+
+/** Parallel map-reduce over `[begin,end)`: computes `map(i0,i1)` for
+ * contiguous sub-ranges as in parallel_for(), and reduces the partial results
+ * with `reduce(a,b)`, starting from `identity`.
+ *
+ * The sub-ranges only depend on the range and `grain`, and partial results
+ * are reduced in order, so the result is deterministic even for
+ * non-associative operations (e.g. floating-point sums), for a given `grain`.
+ * Note that this does not hold for `grain=0`, which depends on the number of
+ * threads.
+ *
+ * \code
+ * const double sum = mrpt::parallel_reduce(
+ *     0, v.size(), 4096, 0.0,
+ *     [&](size_t i0, size_t i1) {
+ *         return std::accumulate(&v[i0], &v[0] + i1, 0.0); },
+ *     std::plus<double>());
+ * \endcode
+ *
+ * \sa parallel_for()
+ * \note (New in MRPT 2.4.3)
+ */
+template <class T, class MAP, class REDUCE>
+T parallel_reduce(
+	std::size_t begin, std::size_t end, std::size_t grain, const T& identity,
+	const MAP& map, const REDUCE& reduce,
+	TaskScheduler& scheduler = TaskScheduler::Instance())
+{
+	if (end <= begin) return identity;
+	const std::size_t n = end - begin;
+	const std::size_t nChunks =
+		internal::parallel_num_chunks(n, grain, scheduler);
+	std::vector<std::optional<T>> partial(nChunks);
+	internal::parallel_chunks(
+		nChunks,
+		[&](std::size_t c) {
+			partial[c].emplace(
+				map(begin + c * n / nChunks, begin + (c + 1) * n / nChunks));
+		},
+		scheduler);
+	T result = identity;
+	for (auto& p : partial)
+		result = reduce(result, *p);
+	return result;
+}
+
+/** @} */
+}  // namespace mrpt
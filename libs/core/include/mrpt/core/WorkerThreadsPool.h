@@ -43,6 +43,10 @@ namespace mrpt
  *  - WorkerThreadsPool::POLICY_DROP_OLD: Old jobs in the waiting queue are
  *    discarded. Note that running jobs are never aborted.
  *
+ * For data parallelism (e.g. splitting loops among cores), prefer
+ * mrpt::parallel_for() and mrpt::TaskGroup, which share the threads of
+ * mrpt::TaskScheduler::Instance() with the rest of MRPT.
+ *
  * \note Partly based on: https://github.com/progschj/ThreadPool (ZLib license)
  *
  * \note (New in MRPT 2.1.0)
@@ -0,0 +1,413 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "core-precomp.h"  // Precompiled headers
+//
+#include <mrpt/config.h>
+#include <mrpt/core/TaskScheduler.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/core/get_env.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>	// mbstowcs()
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(MRPT_OS_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace mrpt;
+
+namespace
+{
+struct Task
+{
+	std::function<void()> f;
+	TaskGroup* group = nullptr;
+};
+
+/** Lock-free work-stealing deque of Task pointers (Chase & Lev, 2005), with
+ * the C11 memory orderings of Le et al., "Correct and Efficient Work-Stealing
+ * for Weak Memory Models" (PPoPP 2013). Only the owner thread may push() and
+ * pop() (at the bottom), any thread may steal() (from the top).
+ * Grown arrays are kept alive until destruction, since thieves may still be
+ * reading them. */
+class WorkStealingDeque
+{
+   public:
+	WorkStealingDeque() { m_array.store(newArray(64)); }
+	~WorkStealingDeque()
+	{
+		for (Task* t = pop(); t; t = pop())
+			delete t;
+	}
+
+	void push(Task* t)
+	{
+		const int64_t b = m_bottom.load(std::memory_order_relaxed);
+		const int64_t tp = m_top.load(std::memory_order_acquire);
+		Array* a = m_array.load(std::memory_order_relaxed);
+		if (b - tp > a->mask)
+		{
+			Array* bigger = newArray(2 * (a->mask + 1));
+			for (int64_t i = tp; i < b; i++)
+				bigger->put(i, a->get(i));
+			a = bigger;
+			m_array.store(a, std::memory_order_release);
+		}
+		a->put(b, t);
+		// (Release instead of the original release fence: same guarantees,
+		// and understood by race detectors)
+		m_bottom.store(b + 1, std::memory_order_release);
+	}
+
+	Task* pop()
+	{
+		const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+		Array* a = m_array.load(std::memory_order_relaxed);
+		m_bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t tp = m_top.load(std::memory_order_relaxed);
+		if (tp > b)
+		{  // Empty
+			m_bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		Task* t = a->get(b);
+		if (tp == b)
+		{  // The last one: race against thieves
+			if (!m_top.compare_exchange_strong(
+					tp, tp + 1, std::memory_order_seq_cst,
+					std::memory_order_relaxed))
+				t = nullptr;
+			m_bottom.store(b + 1, std::memory_order_relaxed);
+		}
+		return t;
+	}
+
+	Task* steal()
+	{
+		int64_t tp = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t b = m_bottom.load(std::memory_order_acquire);
+		if (tp >= b) return nullptr;
+		Array* a = m_array.load(std::memory_order_acquire);
+		Task* t = a->get(tp);
+		if (!m_top.compare_exchange_strong(
+				tp, tp + 1, std::memory_order_seq_cst,
+				std::memory_order_relaxed))
+			return nullptr;	 // Lost the race
+		return t;
+	}
+
+   private:
+	struct Array
+	{
+		explicit Array(int64_t size) : mask(size - 1), buf(size) {}
+		const int64_t mask;
+		std::vector<std::atomic<Task*>> buf;
+
+		Task* get(int64_t i) const
+		{
+			return buf[i & mask].load(std::memory_order_relaxed);
+		}
+		void put(int64_t i, Task* t)
+		{
+			buf[i & mask].store(t, std::memory_order_relaxed);
+		}
+	};
+
+	Array* newArray(int64_t size)
+	{
+		m_arrays.push_back(std::make_unique<Array>(size));
+		return m_arrays.back().get();
+	}
+
+	alignas(64) std::atomic<int64_t> m_top{0};
+	alignas(64) std::atomic<int64_t> m_bottom{0};
+	std::atomic<Array*> m_array{nullptr};
+	std::vector<std::unique_ptr<Array>> m_arrays;  // Owner thread only
+};
+
+// The scheduler and worker index of the current thread, if it is a worker:
+thread_local const void* tl_scheduler = nullptr;
+thread_local std::size_t tl_worker = 0;
+
+void setWorkerThreadName(const std::string& name)
+{
+#if defined(MRPT_OS_WINDOWS) && !defined(__MINGW32_MAJOR_VERSION)
+	wchar_t wName[50];
+	const std::size_t maxLen = sizeof(wName) / sizeof(wName[0]) - 1;
+	std::mbstowcs(wName, name.c_str(), maxLen);
+	wName[maxLen] = L'\0';
+	SetThreadDescription(GetCurrentThread(), wName);
+#elif defined(MRPT_OS_LINUX)
+	// Max. 15 chars (plus the null char) in Linux:
+	pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#endif
+}
+
+void pinWorkerThread(std::size_t cpu)
+{
+#if defined(_WIN32)
+	SetThreadAffinityMask(
+		GetCurrentThread(), DWORD_PTR(1) << (cpu % (8 * sizeof(DWORD_PTR))));
+#elif defined(MRPT_OS_LINUX)
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	CPU_SET(cpu % CPU_SETSIZE, &cpuset);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+#else
+	(void)cpu;
+#endif
+}
+}  // namespace
+
+struct TaskScheduler::Impl
+{
+	explicit Impl(std::size_t numWorkers) : queues(numWorkers) {}
+
+	std::vector<WorkStealingDeque> queues;	// One per worker
+	std::vector<std::thread> threads;
+
+	std::mutex injectMtx;
+	std::deque<Task*> injected;	 // Tasks from non-worker threads
+
+	// Number of tasks in all queues (not yet taken by any thread):
+	std::atomic_size_t pending{0};
+	std::atomic_size_t sleeping{0};
+	std::atomic_bool stop{false};
+	std::mutex sleepMtx;
+	std::condition_variable sleepCv;
+
+	Task* takeInjected()
+	{
+		std::lock_guard<std::mutex> lck(injectMtx);
+		if (injected.empty()) return nullptr;
+		Task* t = injected.front();
+		injected.pop_front();
+		return t;
+	}
+
+	// `self`: the caller worker index, or queues.size() for other threads.
+	Task* findTask(std::size_t self)
+	{
+		Task* t = nullptr;
+		if (self < queues.size()) t = queues[self].pop();
+		if (!t && pending.load(std::memory_order_relaxed) != 0)
+		{
+			t = takeInjected();
+			// Steal, starting from a different victim for each thief:
+			const std::size_t n = queues.size();
+			for (std::size_t i = 1; !t && i <= n; i++)
+			{
+				const std::size_t v = (self + i) % (n + 1);
+				if (v < n) t = queues[v].steal();
+			}
+		}
+		if (t) pending.fetch_sub(1, std::memory_order_relaxed);
+		return t;
+	}
+
+	void wakeUpOne()
+	{
+		// seq_cst pairs with the sleepers: either they see `pending!=0` before
+		// blocking, or we see them as sleeping and notify.
+		if (sleeping.load(std::memory_order_seq_cst) == 0) return;
+		std::lock_guard<std::mutex> lck(sleepMtx);
+		sleepCv.notify_one();
+	}
+
+	void workerLoop(std::size_t self)
+	{
+		tl_scheduler = this;
+		tl_worker = self;
+		while (!stop.load(std::memory_order_relaxed))
+		{
+			if (Task* t = findTask(self))
+			{
+				runTask(t);
+				continue;
+			}
+			if (pending.load(std::memory_order_relaxed) != 0)
+			{  // A task is being pushed or taken by another thread
+				std::this_thread::yield();
+				continue;
+			}
+			std::unique_lock<std::mutex> lck(sleepMtx);
+			sleeping.fetch_add(1, std::memory_order_seq_cst);
+			sleepCv.wait(lck, [this]() {
+				return stop.load() ||
+					pending.load(std::memory_order_seq_cst) != 0;
+			});
+			sleeping.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	static void runTask(Task* t)
+	{
+		TaskGroup* g = t->group;
+		std::exception_ptr error;
+		if (!g->isCancelled())
+		{
+			try
+			{
+				t->f();
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+		}
+		delete t;
+		g->onTaskDone(error);
+	}
+
+	// For tasks pending when the scheduler is destroyed: their groups get
+	// an error instead of waiting forever for them.
+	static void discardTask(Task* t)
+	{
+		TaskGroup* g = t->group;
+		delete t;
+		g->onTaskDone(std::make_exception_ptr(std::runtime_error(
+			"TaskScheduler destroyed before running the task")));
+	}
+};
+
+TaskScheduler::TaskScheduler(
+	std::size_t numWorkers, bool pinThreads, const std::string& name)
+	: m_impl(spimpl::make_unique_impl<Impl>(numWorkers))
+{
+	for (std::size_t i = 0; i < numWorkers; i++)
+		m_impl->threads.emplace_back([this, i, pinThreads, name]() {
+			setWorkerThreadName(name + "[" + std::to_string(i) + "]");
+			if (pinThreads) pinWorkerThread(i);
+			m_impl->workerLoop(i);
+		});
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	{
+		std::lock_guard<std::mutex> lck(m_impl->sleepMtx);
+		m_impl->stop = true;
+	}
+	m_impl->sleepCv.notify_all();
+	for (auto& t : m_impl->threads)
+		t.join();
+	for (auto& q : m_impl->queues)
+		while (Task* t = q.pop())
+			Impl::discardTask(t);
+	for (Task* t : m_impl->injected)
+		Impl::discardTask(t);
+}
+
+TaskScheduler& TaskScheduler::Instance()
+{
+	static TaskScheduler inst(
+		std::max<int>(
+			0,
+			mrpt::get_env<int>(
+				"MRPT_NUM_THREADS",
+				std::max(1U, std::thread::hardware_concurrency())) -
+				1),
+		mrpt::get_env<bool>("MRPT_PIN_THREADS", false), "mrpt-tasks");
+	return inst;
+}
+
+std::size_t TaskScheduler::size() const { return m_impl->threads.size(); }
+
+bool TaskScheduler::isWorkerThread() const
+{
+	return tl_scheduler == m_impl.get();
+}
+
+bool TaskScheduler::runPendingTask()
+{
+	const std::size_t self =
+		isWorkerThread() ? tl_worker : m_impl->queues.size();
+	Task* t = m_impl->findTask(self);
+	if (!t) return false;
+	Impl::runTask(t);
+	return true;
+}
+
+void TaskScheduler::submit(std::function<void()>&& f, TaskGroup* group)
+{
+	auto* t = new Task{std::move(f), group};
+	if (size() == 0)
+	{  // No workers: run it now.
+		Impl::runTask(t);
+		return;
+	}
+	// Counted before being visible to thieves, so it never underflows:
+	m_impl->pending.fetch_add(1, std::memory_order_seq_cst);
+	if (isWorkerThread()) m_impl->queues[tl_worker].push(t);
+	else
+	{
+		std::lock_guard<std::mutex> lck(m_impl->injectMtx);
+		m_impl->injected.push_back(t);
+	}
+	m_impl->wakeUpOne();
+}
+
+TaskGroup::~TaskGroup()
+{
+	try
+	{
+		wait();
+	}
+	catch (...)
+	{
+	}
+}
+
+void TaskGroup::wait()
+{
+	while (m_pending.load(std::memory_order_acquire) != 0)
+	{
+		// Help, instead of blocking:
+		if (m_scheduler.runPendingTask()) continue;
+
+		// Tasks of this group are running in other threads:
+		std::unique_lock<std::mutex> lck(m_mtx);
+		m_cv.wait_for(lck, std::chrono::microseconds(200), [this]() {
+			return m_pending.load(std::memory_order_acquire) == 0;
+		});
+	}
+	// The last onTaskDone() may still be holding the mutex:
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lck(m_mtx);
+		error = std::move(m_error);
+		m_error = nullptr;
+	}
+	m_cancelled = false;
+	if (error) std::rethrow_exception(error);
+}
+
+void TaskGroup::onTaskDone(std::exception_ptr error) noexcept
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	if (error && !m_error)
+	{
+		m_error = error;
+		m_cancelled = true;
+	}
+	if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		m_cv.notify_all();
+}
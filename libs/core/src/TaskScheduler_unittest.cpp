@@ -0,0 +1,181 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/core/TaskScheduler.h>
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(TaskScheduler, taskGroup)
+{
+	mrpt::TaskScheduler ts(3);
+	EXPECT_EQ(ts.size(), 3U);
+	EXPECT_FALSE(ts.isWorkerThread());
+
+	std::atomic_int count{0};
+	mrpt::TaskGroup g(ts);
+	for (int i = 0; i < 1000; i++)
+		g.run([&, i]() {
+			count++;
+			// Tasks spawned from tasks:
+			if (i % 10 == 0) g.run([&]() { count++; });
+		});
+	g.wait();
+	EXPECT_EQ(count, 1100);
+
+	// Reusable:
+	g.run([&]() { count = 0; });
+	g.wait();
+	EXPECT_EQ(count, 0);
+}
+
+TEST(TaskScheduler, exceptions)
+{
+	mrpt::TaskScheduler ts(2);
+	mrpt::TaskGroup g(ts);
+	std::atomic_int count{0};
+	for (int i = 0; i < 100; i++)
+		g.run([&, i]() {
+			count++;
+			if (i == 10) throw std::runtime_error("task10");
+		});
+	EXPECT_THROW(g.wait(), std::runtime_error);
+	EXPECT_LE(count, 100);
+
+	// Not cancelled anymore:
+	EXPECT_FALSE(g.isCancelled());
+	g.run([&]() { count = -1; });
+	EXPECT_NO_THROW(g.wait());
+	EXPECT_EQ(count, -1);
+
+	// Via parallel_for(), from a task or from the calling thread:
+	for (size_t bad : {0, 500})
+		EXPECT_THROW(
+			mrpt::parallel_for(
+				0, 1000, 10,
+				[bad](size_t i0, size_t) {
+					if (i0 == bad) throw std::runtime_error("chunk");
+				},
+				ts),
+			std::runtime_error);
+}
+
+TEST(TaskScheduler, parallelFor)
+{
+	for (size_t nWorkers : {0, 1, 4})
+	{
+		mrpt::TaskScheduler ts(nWorkers);
+		for (size_t grain : {0, 1, 7, 100, 5000})
+		{
+			std::vector<int> v(1234, 0);
+			std::atomic_size_t nChunks{0};
+			mrpt::parallel_for(
+				10, v.size(), grain,
+				[&](size_t i0, size_t i1) {
+					nChunks++;
+					ASSERT_LT(i0, i1);
+					if (grain) { ASSERT_LE(i1 - i0, grain); }
+					for (size_t i = i0; i < i1; i++)
+						v[i]++;
+				},
+				ts);
+			for (size_t i = 0; i < v.size(); i++)
+				ASSERT_EQ(v[i], i < 10 ? 0 : 1) << "grain=" << grain;
+			if (grain)
+			{
+				EXPECT_EQ(nChunks, (v.size() - 10 + grain - 1) / grain);
+			}
+		}
+		// Empty range:
+		mrpt::parallel_for(
+			5, 5, 1, [](size_t, size_t) { FAIL(); }, ts);
+	}
+}
+
+TEST(TaskScheduler, parallelReduce)
+{
+	std::vector<double> v(100000);
+	for (size_t i = 0; i < v.size(); i++)
+		v[i] = 1.0 / (1 + i);
+
+	const auto sum = [&](mrpt::TaskScheduler& ts) {
+		return mrpt::parallel_reduce(
+			0, v.size(), 1000, 0.0,
+			[&](size_t i0, size_t i1) {
+				return std::accumulate(&v[i0], &v[0] + i1, 0.0);
+			},
+			std::plus<double>(), ts);
+	};
+
+	mrpt::TaskScheduler ts0(0), ts4(4);
+	const double s0 = sum(ts0), s4 = sum(ts4);
+	EXPECT_NEAR(s0, std::accumulate(v.begin(), v.end(), 0.0), 1e-9);
+	// Deterministic, regardless of the number of threads:
+	EXPECT_EQ(s0, s4);
+
+	// Non-default-constructible types:
+	struct MinMax
+	{
+		explicit MinMax(double a, double b) : lo(a), hi(b) {}
+		double lo, hi;
+	};
+	const auto mm = mrpt::parallel_reduce(
+		0, v.size(), 0, MinMax(1e9, -1e9),
+		[&](size_t i0, size_t i1) {
+			MinMax r(1e9, -1e9);
+			for (size_t i = i0; i < i1; i++)
+				r = MinMax(std::min(r.lo, v[i]), std::max(r.hi, v[i]));
+			return r;
+		},
+		[](const MinMax& a, const MinMax& b) {
+			return MinMax(std::min(a.lo, b.lo), std::max(a.hi, b.hi));
+		},
+		ts4);
+	EXPECT_EQ(mm.lo, v.back());
+	EXPECT_EQ(mm.hi, 1.0);
+}
+
+TEST(TaskScheduler, nested)
+{
+	// Nested loops, and several external threads sharing the scheduler:
+	mrpt::TaskScheduler ts(3);
+	std::vector<std::thread> threads;
+	std::atomic_size_t total{0};
+	for (int t = 0; t < 3; t++)
+		threads.emplace_back([&]() {
+			mrpt::parallel_for(
+				0, 20, 1,
+				[&](size_t i0, size_t i1) {
+					for (size_t i = i0; i < i1; i++)
+						total += mrpt::parallel_reduce(
+							0, 1000, 50, size_t(0),
+							[](size_t j0, size_t j1) { return j1 - j0; },
+							std::plus<size_t>(), ts);
+				},
+				ts);
+		});
+	for (auto& t : threads)
+		t.join();
+	EXPECT_EQ(total, 3U * 20U * 1000U);
+}
+
+TEST(TaskScheduler, sharedInstance)
+{
+	auto& ts = mrpt::TaskScheduler::Instance();
+	EXPECT_EQ(&ts, &mrpt::TaskScheduler::Instance());
+	EXPECT_GE(ts.concurrency(), 1U);
+	const size_t n = mrpt::parallel_reduce(
+		0, 100, 0, size_t(0), [](size_t i0, size_t i1) { return i1 - i0; },
+		std::plus<size_t>());
+	EXPECT_EQ(n, 100U);
+}
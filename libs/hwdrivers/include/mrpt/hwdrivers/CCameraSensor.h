@@ -110,6 +110,11 @@ namespace mrpt::hwdrivers
  * things.
  *    #external_images_own_thread_count = 2    // >=1
  *
+ *    # Grabbed images are stored in buffers from
+ * mrpt::img::CImageBufferPool. Max. number
+ *    #  of unused buffers of each size kept in that (process-wide) pool:
+ *    #image_pool_max_free_buffers = 8
+ *
  *    # (Only when external_images_format=jpg): Optional parameter to set the
  * JPEG compression quality:
  *    #external_images_jpeg_quality = 95    // [1-100]. Default: 95
@@ -564,11 +569,19 @@ class CCameraSensor : public mrpt::system::COutputLogger, public CGenericSensor
 	std::vector<std::thread> m_threadImagesSaver;
 
 	bool m_threadImagesSaverShouldEnd{false};
-	/** The critical section for m_toSaveList */
-	std::mutex m_csToSaveList;
-	/** The queues of objects to be returned by getObservations, one for each
-	 * working thread. */
-	std::vector<TListObservations> m_toSaveList;
+	/** Lock-free queue of observations to be saved by one working thread.
+	 * The only producer is the grabbing thread. */
+	using TToSaveQueue = mrpt::containers::spsc_ring_queue<
+		mrpt::serialization::CSerializable::Ptr>;
+	/** Max. length of each TToSaveQueue. If all of them are full, images are
+	 * saved from the grabbing thread. */
+	static constexpr size_t TO_SAVE_QUEUE_LENGTH = 64;
+	/** The queues of observations pending to be saved, one for each working
+	 * thread. */
+	std::vector<std::unique_ptr<TToSaveQueue>> m_toSaveQueues;
+	/** Sends an observation to the least busy saving thread.
+	 * \return false if all the saving queues are full. */
+	bool enqueueImageToSave(const mrpt::serialization::CSerializable::Ptr& obs);
 	/** Thread to save images to files. */
 	void thread_save_images(unsigned int my_working_thread_index);
 
@@ -10,10 +10,13 @@
 #pragma once
 
 #include <mrpt/config/CConfigFileBase.h>
+#include <mrpt/containers/lockfree_ring_queue.h>
 #include <mrpt/obs/CObservation.h>
 #include <mrpt/typemeta/TEnumType.h>
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <mutex>
 
 namespace mrpt
@@ -48,8 +51,9 @@ struct TSensorClassId
  *sensor
  *thread should invoke "doProcess".
  *			- "max_queue_len": (Optional) The maximum number of objects in the
- *observations queue (default is 200). If overflow occurs, an error message
- *will be issued at run-time.
+ *lock-free observations queue (default is 200). If overflow occurs, an error
+ *message will be issued at run-time and observations are temporarily kept in a
+ *(slower) mutex-protected list, so nothing is lost.
  *			- "grab_decimation": (Optional) Grab only 1 out of N observations
  *captured
  *by the sensor (default is 1, i.e. do not decimate).
@@ -115,11 +119,25 @@ class CGenericSensor
 	 */
 	static void registerClass(const TSensorClassId* pNewClass);
 
+	/** Returns the statistics (number of objects, latency from
+	 * appendObservations() to getObservations(), etc.) of the internal
+	 * lock-free observations queue. \note (New in MRPT 2.4.3) */
+	mrpt::containers::ring_queue_stats getObservationsQueueStats() const
+	{
+		return m_objQueue->stats();
+	}
+
    private:
-	/** The critical section for m_objList */
-	std::mutex m_csObjList;
-	/** The queue of objects to be returned by getObservations */
-	TListObservations m_objList;
+	/** The lock-free queue of objects to be returned by getObservations.
+	 * Multiple producers are allowed since some sensors append observations
+	 * from several worker threads. */
+	std::unique_ptr<mrpt::containers::mpmc_ring_queue<TListObsPair>>
+		m_objQueue;
+	/** Objects that did not fit into m_objQueue, protected by
+	 * m_csObjListOverflow */
+	TListObservations m_objListOverflow;
+	std::mutex m_csObjListOverflow;
+	std::atomic_bool m_objQueueOverflowed{false};
 
 	/** Used in registerClass */
 	using registered_sensor_classes_t =
@@ -135,6 +135,11 @@ namespace mrpt::hwdrivers
  * number of full scans / second
  *   # pcap_repeat_delay = 0.0   // seconds
  *
+ *   # ---- Point cloud generation ----
+ *   # If true, each data packet is decoded into the observation point cloud
+ *   # as soon as it arrives (see setDecodePacketsOnArrival())
+ *   # decode_packets_on_arrival = false
+ *
  *   # ---- Save to PCAP file ----
  *   # If uncommented, a PCAP file named
  * `[pcap_output_prefix]_[DATE_TIME].pcap` will be
@@ -246,6 +251,13 @@ class CVelodyneScanner : public mrpt::hwdrivers::CGenericSensor
 	double m_pcap_read_full_scan_delay_ms{100};
 	/** Default: 0 (in seconds) */
 	double m_pcap_repeat_delay{0.0};
+	/** Default: false. See setDecodePacketsOnArrival() */
+	bool m_decode_on_arrival{false};
+	/** Parameters for decoding packets on arrival */
+	mrpt::obs::CObservationVelodyneScan::TGeneratePointCloudParameters
+		m_decode_params;
+	/** Decoding constants reused among packets decoded on arrival */
+	mrpt::obs::CObservationVelodyneScan::TPacketDecodeCache m_decode_cache;
 
 	/** See the class documentation at the top for expected parameters */
 	void loadConfig_sensorSpecific(
@@ -347,6 +359,24 @@ class CVelodyneScanner : public mrpt::hwdrivers::CGenericSensor
 	 */
 	void setFramePublishing(bool on);
 
+	/** If enabled, each data packet is decoded into the point cloud of the
+	 * in-progress observation as soon as it is received, so returned
+	 * observations already have their
+	 * mrpt::obs::CObservationVelodyneScan::point_cloud populated and the
+	 * decoding cost is spread over the packets instead of being paid once per
+	 * complete scan. Default: false.
+	 * \note (New in MRPT 2.4.3)
+	 */
+	void setDecodePacketsOnArrival(
+		bool enable,
+		const mrpt::obs::CObservationVelodyneScan::TGeneratePointCloudParameters&
+			params = {})
+	{
+		m_decode_on_arrival = enable;
+		m_decode_params = params;
+	}
+	bool getDecodePacketsOnArrival() const { return m_decode_on_arrival; }
+
 	/** @} */
 
 	/** Polls the UDP port for incoming data packets. The user *must* call this
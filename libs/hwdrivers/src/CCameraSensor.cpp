@@ -15,6 +15,7 @@
 #include <mrpt/gui/WxSubsystem.h>
 #include <mrpt/gui/WxUtils.h>
 #include <mrpt/hwdrivers/CCameraSensor.h>
+#include <mrpt/img/CImageBufferPool.h>
 #include <mrpt/obs/CObservationImage.h>
 #include <mrpt/obs/CObservationStereoImages.h>
 #include <mrpt/obs/CRawlog.h>
@@ -376,8 +377,10 @@ void CCameraSensor::initialize()
 		m_threadImagesSaver.clear();
 		m_threadImagesSaver.resize(m_external_image_saver_count);
 
-		m_toSaveList.clear();
-		m_toSaveList.resize(m_external_image_saver_count);
+		m_toSaveQueues.clear();
+		for (unsigned int i = 0; i < m_external_image_saver_count; ++i)
+			m_toSaveQueues.emplace_back(
+				std::make_unique<TToSaveQueue>(TO_SAVE_QUEUE_LENGTH));
 
 		for (unsigned int i = 0; i < m_external_image_saver_count; ++i)
 		{
@@ -708,6 +711,12 @@ void CCameraSensor::loadConfig_sensorSpecific(
 		iniSection, "external_images_own_thread_count",
 		m_external_image_saver_count);
 
+	// Process-wide setting:
+	auto& pool = mrpt::img::CImageBufferPool::Instance();
+	pool.setMaxFreeBuffersPerSize(configSource.read_uint64_t(
+		iniSection, "image_pool_max_free_buffers",
+		pool.getMaxFreeBuffersPerSize()));
+
 	// Sensor pose:
 	m_sensorPose.setFromValues(
 		configSource.read_float(iniSection, "pose_x", 0),
@@ -1235,23 +1244,8 @@ void CCameraSensor::getNextFrame(vector<CSerializable::Ptr>& out_obs)
 	{
 		if (stObs)	// If we have grabbed an stereo observation ...
 		{  // Stereo obs  -------
-			if (m_external_images_own_thread)
-			{
-				m_csToSaveList.lock();
-
-				// Select the "m_toSaveList" with the shortest pending queue:
-				size_t idx_min = 0;
-				for (size_t i = 0; i < m_toSaveList.size(); ++i)
-					if (m_toSaveList[i].size() < m_toSaveList[idx_min].size())
-						idx_min = i;
-				// Insert:
-				m_toSaveList[idx_min].insert(
-					TListObsPair(stObs->timestamp, stObs));
-
-				m_csToSaveList.unlock();
-
-				delayed_insertion_in_obs_queue = true;
-			}
+			if (m_external_images_own_thread && enqueueImageToSave(stObs))
+			{ delayed_insertion_in_obs_queue = true; }
 			else
 			{
 				const string filNameL =
@@ -1293,22 +1287,8 @@ void CCameraSensor::getNextFrame(vector<CSerializable::Ptr>& out_obs)
 		}
 		else if (obs)
 		{  // Monocular image obs  -------
-			if (m_external_images_own_thread)
-			{
-				m_csToSaveList.lock();
-
-				// Select the "m_toSaveList" with the shortest pending queue:
-				size_t idx_min = 0;
-				for (size_t i = 0; i < m_toSaveList.size(); ++i)
-					if (m_toSaveList[i].size() < m_toSaveList[idx_min].size())
-						idx_min = i;
-
-				// Insert:
-				m_toSaveList[idx_min].insert(TListObsPair(obs->timestamp, obs));
-
-				m_csToSaveList.unlock();
-				delayed_insertion_in_obs_queue = true;
-			}
+			if (m_external_images_own_thread && enqueueImageToSave(obs))
+			{ delayed_insertion_in_obs_queue = true; }
 			else
 			{
 				string filName = fileNameStripInvalidChars(
@@ -1618,93 +1598,99 @@ void mrpt::hwdrivers::readConfigIntoVideoSourcePanel(
 /* -----------------------------------------------------
 		THREAD: Saver of external images
    ----------------------------------------------------- */
+bool CCameraSensor::enqueueImageToSave(const CSerializable::Ptr& obs)
+{
+	if (m_toSaveQueues.empty()) return false;
+
+	// Select the queue with the shortest pending list:
+	size_t idx_min = 0;
+	for (size_t i = 0; i < m_toSaveQueues.size(); ++i)
+		if (m_toSaveQueues[i]->size() < m_toSaveQueues[idx_min]->size())
+			idx_min = i;
+
+	// If all saving threads are busy, the caller saves it by itself:
+	return m_toSaveQueues[idx_min]->try_push(obs);
+}
+
 void CCameraSensor::thread_save_images(unsigned int my_working_thread_index)
 {
-	while (!m_threadImagesSaverShouldEnd)
-	{
-		TListObservations newObs;
+	TToSaveQueue& queue = *m_toSaveQueues.at(my_working_thread_index);
 
+	while (!m_threadImagesSaverShouldEnd || !queue.empty())
+	{
 		// is there any new image?
-		m_csToSaveList.lock();
-		m_toSaveList[my_working_thread_index].swap(newObs);
-		m_csToSaveList.unlock();
+		CSerializable::Ptr newObs;
+		if (!queue.pop(newObs, 10ms)) continue;
 
-		for (auto i = newObs.begin(); i != newObs.end(); ++i)
+		// Optional user-code hook:
+		if (m_hook_pre_save)
 		{
-			// Optional user-code hook:
-			if (m_hook_pre_save)
+			if (IS_DERIVED(*newObs, CObservation))
 			{
-				if (IS_DERIVED(*i->second, CObservation))
-				{
-					mrpt::obs::CObservation::Ptr obs =
-						std::dynamic_pointer_cast<mrpt::obs::CObservation>(
-							i->second);
-					m_hook_pre_save(obs, m_hook_pre_save_param);
-				}
+				mrpt::obs::CObservation::Ptr obs =
+					std::dynamic_pointer_cast<mrpt::obs::CObservation>(newObs);
+				m_hook_pre_save(obs, m_hook_pre_save_param);
 			}
+		}
 
-			if (IS_CLASS(*i->second, CObservationImage))
+		if (IS_CLASS(*newObs, CObservationImage))
+		{
+			CObservationImage::Ptr obs =
+				std::dynamic_pointer_cast<CObservationImage>(newObs);
+
+			string filName = fileNameStripInvalidChars(
+								 trim(m_sensorLabel)) +
+				format("_%f.%s", (double)timestampTotime_t(obs->timestamp),
+					   m_external_images_format.c_str());
+
+			obs->image.saveToFile(
+				m_path_for_external_images + string("/") + filName,
+				m_external_images_jpeg_quality);
+			obs->image.setExternalStorage(filName);
+		}
+		else if (IS_CLASS(*newObs, CObservationStereoImages))
+		{
+			CObservationStereoImages::Ptr stObs =
+				std::dynamic_pointer_cast<CObservationStereoImages>(newObs);
+
+			const string filNameL =
+				fileNameStripInvalidChars(trim(m_sensorLabel)) +
+				format(
+					"_L_%f.%s", (double)timestampTotime_t(stObs->timestamp),
+					m_external_images_format.c_str());
+			const string filNameR =
+				fileNameStripInvalidChars(trim(m_sensorLabel)) +
+				format(
+					"_R_%f.%s", (double)timestampTotime_t(stObs->timestamp),
+					m_external_images_format.c_str());
+			const string filNameD =
+				fileNameStripInvalidChars(trim(m_sensorLabel)) +
+				format(
+					"_D_%f.%s", (double)timestampTotime_t(stObs->timestamp),
+					m_external_images_format.c_str());
+
+			stObs->imageLeft.saveToFile(
+				m_path_for_external_images + string("/") + filNameL,
+				m_external_images_jpeg_quality);
+			stObs->imageLeft.setExternalStorage(filNameL);
+
+			if (stObs->hasImageRight)
 			{
-				CObservationImage::Ptr obs =
-					std::dynamic_pointer_cast<CObservationImage>(i->second);
-
-				string filName = fileNameStripInvalidChars(
-									 trim(m_sensorLabel)) +
-					format("_%f.%s", (double)timestampTotime_t(obs->timestamp),
-						   m_external_images_format.c_str());
-
-				obs->image.saveToFile(
-					m_path_for_external_images + string("/") + filName,
+				stObs->imageRight.saveToFile(
+					m_path_for_external_images + string("/") + filNameR,
 					m_external_images_jpeg_quality);
-				obs->image.setExternalStorage(filName);
+				stObs->imageRight.setExternalStorage(filNameR);
 			}
-			else if (IS_CLASS(*i->second, CObservationStereoImages))
+			if (stObs->hasImageDisparity)
 			{
-				CObservationStereoImages::Ptr stObs =
-					std::dynamic_pointer_cast<CObservationStereoImages>(
-						i->second);
-
-				const string filNameL =
-					fileNameStripInvalidChars(trim(m_sensorLabel)) +
-					format(
-						"_L_%f.%s", (double)timestampTotime_t(stObs->timestamp),
-						m_external_images_format.c_str());
-				const string filNameR =
-					fileNameStripInvalidChars(trim(m_sensorLabel)) +
-					format(
-						"_R_%f.%s", (double)timestampTotime_t(stObs->timestamp),
-						m_external_images_format.c_str());
-				const string filNameD =
-					fileNameStripInvalidChars(trim(m_sensorLabel)) +
-					format(
-						"_D_%f.%s", (double)timestampTotime_t(stObs->timestamp),
-						m_external_images_format.c_str());
-
-				stObs->imageLeft.saveToFile(
-					m_path_for_external_images + string("/") + filNameL,
+				stObs->imageDisparity.saveToFile(
+					m_path_for_external_images + string("/") + filNameD,
 					m_external_images_jpeg_quality);
-				stObs->imageLeft.setExternalStorage(filNameL);
-
-				if (stObs->hasImageRight)
-				{
-					stObs->imageRight.saveToFile(
-						m_path_for_external_images + string("/") + filNameR,
-						m_external_images_jpeg_quality);
-					stObs->imageRight.setExternalStorage(filNameR);
-				}
-				if (stObs->hasImageDisparity)
-				{
-					stObs->imageDisparity.saveToFile(
-						m_path_for_external_images + string("/") + filNameD,
-						m_external_images_jpeg_quality);
-					stObs->imageDisparity.setExternalStorage(filNameD);
-				}
+				stObs->imageDisparity.setExternalStorage(filNameD);
 			}
-
-			// Append now:
-			appendObservation(i->second);
 		}
 
-		std::this_thread::sleep_for(2ms);
+		// Append now:
+		appendObservation(newObs);
 	}
 }
@@ -28,6 +28,7 @@ extern "C"
 #endif
 
 #include <mrpt/hwdrivers/CFFMPEG_InputStream.h>
+#include <mrpt/img/CImageBufferPool.h>
 
 using namespace mrpt;
 using namespace mrpt::hwdrivers;
@@ -407,6 +408,9 @@ bool CFFMPEG_InputStream::retrieveFrame(mrpt::img::CImage& out_img)
 				((m_grab_as_grayscale ? 1 : 3) * width))
 				THROW_EXCEPTION("FIXME: linesize!=width case not handled yet.");
 
+			mrpt::img::CImageBufferPool::Instance().resize(
+				out_img, width, height,
+				m_grab_as_grayscale ? mrpt::img::CH_GRAY : mrpt::img::CH_RGB);
 			out_img.loadFromMemoryBuffer(
 				width, height, !m_grab_as_grayscale, ctx->pFrameRGB->data[0]);
 
@@ -12,6 +12,7 @@
 #include <mrpt/hwdrivers/CGenericSensor.h>
 #include <mrpt/obs/CAction.h>
 #include <mrpt/obs/CObservation.h>
+#include <mrpt/system/COutputLogger.h>
 
 using namespace mrpt::obs;
 using namespace mrpt::system;
@@ -19,11 +20,27 @@ using namespace mrpt::hwdrivers;
 using namespace mrpt::serialization;
 using namespace std;
 
+namespace
+{
+/** Most sensors are also a COutputLogger: use it if so, so messages carry
+ * the sensor name and honor its verbosity level. */
+const COutputLogger& sensorLogger(const CGenericSensor* sensor)
+{
+	if (const auto* l = dynamic_cast<const COutputLogger*>(sensor)) return *l;
+	static const COutputLogger defaultLogger("CGenericSensor");
+	return defaultLogger;
+}
+}  // namespace
+
 /*-------------------------------------------------------------
 						Constructor
 -------------------------------------------------------------*/
 CGenericSensor::CGenericSensor()
 {
+	m_objQueue =
+		std::make_unique<mrpt::containers::mpmc_ring_queue<TListObsPair>>(
+			m_max_queue_len);
+
 	const char* sVerbose = getenv("MRPT_HWDRIVERS_VERBOSE");
 	m_verbose = (sVerbose != nullptr) && atoi(sVerbose) != 0;
 }
@@ -34,7 +51,8 @@ CGenericSensor::CGenericSensor()
 CGenericSensor::~CGenericSensor()
 {
 	// Free objects in list, if any:
-	m_objList.clear();
+	m_objQueue->clear();
+	m_objListOverflow.clear();
 }
 
 /*-------------------------------------------------------------
@@ -47,8 +65,6 @@ void CGenericSensor::appendObservations(
 	{
 		m_grab_decimation_counter = 0;
 
-		std::lock_guard<std::mutex> lock(m_csObjList);
-
 		for (const auto& obj : objs)
 		{
 			if (!obj) continue;
@@ -67,7 +83,19 @@ void CGenericSensor::appendObservations(
 				THROW_EXCEPTION("Passed object must be CObservation.");
 
 			// Add it:
-			m_objList.insert(TListObsPair(timestamp, obj));
+			if (m_objQueue->try_emplace(timestamp, obj)) continue;
+
+			// Queue overflow: keep it in the slow path list:
+			std::lock_guard<std::mutex> lock(m_csObjListOverflow);
+			if (!m_objQueueOverflowed)
+				sensorLogger(this).logFmt(
+					LVL_WARN,
+					"Sensor `%s` observations queue is full (max_queue_len="
+					"%zu). Are observations being retrieved?",
+					m_sensorLabel.c_str(), m_max_queue_len);
+
+			m_objListOverflow.insert(TListObsPair(timestamp, obj));
+			m_objQueueOverflowed = true;
 		}
 	}
 }
@@ -77,9 +105,19 @@ void CGenericSensor::appendObservations(
 -------------------------------------------------------------*/
 void CGenericSensor::getObservations(TListObservations& lstObjects)
 {
-	std::lock_guard<std::mutex> lock(m_csObjList);
-	lstObjects = m_objList;
-	m_objList.clear();	// Memory of objects will be freed by invoker.
+	lstObjects.clear();
+	// Memory of objects will be freed by invoker.
+	TListObsPair o;
+	while (m_objQueue->try_pop(o))
+		lstObjects.insert(std::move(o));
+
+	if (m_objQueueOverflowed)
+	{
+		std::lock_guard<std::mutex> lock(m_csObjListOverflow);
+		lstObjects.insert(m_objListOverflow.begin(), m_objListOverflow.end());
+		m_objListOverflow.clear();
+		m_objQueueOverflowed = false;
+	}
 }
 
 /*-------------------------------------------------------------
@@ -124,8 +162,24 @@ void CGenericSensor::loadConfig(
 	m_process_rate = cfg.read_double(
 		sect, "process_rate", 0);  // Leave it to 0 so rawlog-grabber can detect
 	// if it's not set by the user.
-	m_max_queue_len = static_cast<size_t>(
+	const auto max_queue_len = static_cast<size_t>(
 		cfg.read_int(sect, "max_queue_len", int(m_max_queue_len)));
+	ASSERT_GT_(max_queue_len, 0U);
+	if (max_queue_len != m_max_queue_len)
+	{
+		if (m_objQueue->empty())
+		{
+			m_objQueue = std::make_unique<
+				mrpt::containers::mpmc_ring_queue<TListObsPair>>(max_queue_len);
+			m_max_queue_len = max_queue_len;
+		}
+		else
+			sensorLogger(this).logFmt(
+				LVL_WARN,
+				"Sensor `%s`: max_queue_len=%zu ignored since the queue is not "
+				"empty, keeping max_queue_len=%zu",
+				m_sensorLabel.c_str(), max_queue_len, m_max_queue_len);
+	}
 	m_grab_decimation = static_cast<size_t>(
 		cfg.read_int(sect, "grab_decimation", int(m_grab_decimation)));
 
@@ -11,6 +11,7 @@
 //
 #include <mrpt/3rdparty/do_opencv_includes.h>
 #include <mrpt/hwdrivers/CImageGrabber_OpenCV.h>
+#include <mrpt/img/CImageBufferPool.h>
 
 #include <thread>
 
@@ -209,13 +210,14 @@ bool CImageGrabber_OpenCV::getObservation(
 	//  there's no way:
 	for (int nTries = 0; nTries < 10; nTries++)
 	{
-		cv::Mat capImg;
-		if (m_capture->cap.retrieve(capImg))
+		// Let OpenCV write into a buffer from the pool:
+		mrpt::img::CImage capImg;
+		mrpt::img::CImageBufferPool::Instance().attach(capImg);
+		if (m_capture->cap.retrieve(capImg.asCvMatRef()))
 		{
 			// Fill the output class:
 			out_observation.timestamp = mrpt::system::now();
-			out_observation.image =
-				mrpt::img::CImage(capImg, mrpt::img::SHALLOW_COPY);
+			out_observation.image = std::move(capImg);
 			return true;
 		}
 		cerr << "[CImageGrabber_OpenCV] WARNING: Ignoring error #" << nTries + 1
@@ -11,6 +11,7 @@
 //
 #include <mrpt/config.h>
 #include <mrpt/hwdrivers/CImageGrabber_dc1394.h>
+#include <mrpt/img/CImageBufferPool.h>
 
 // Include the libdc1394-2 headers:
 #if MRPT_HAS_LIBDC1394_2
@@ -484,6 +485,8 @@ bool CImageGrabber_dc1394::getObservation(
 		dc1394_convert_frames(frame, new_frame);
 
 		// Fill the output class:
+		mrpt::img::CImageBufferPool::Instance().resize(
+			out_observation.image, width, height, mrpt::img::CH_RGB);
 		out_observation.image.loadFromMemoryBuffer(
 			width, height, true, new_frame->image, true /* BGR -> RGB */);
 
@@ -165,6 +165,8 @@ void CVelodyneScanner::loadConfig_sensorSpecific(
 		sect);
 	MRPT_LOAD_HERE_CONFIG_VAR(
 		pos_packets_min_period, double, m_pos_packets_min_period, cfg, sect);
+	MRPT_LOAD_HERE_CONFIG_VAR(
+		decode_packets_on_arrival, bool, m_decode_on_arrival, cfg, sect);
 
 	using mrpt::DEG2RAD;
 	m_sensorPose = mrpt::poses::CPose3D(
@@ -348,6 +350,13 @@ bool CVelodyneScanner::getNextObservation(
 
 			// Accumulate pkts in the observation object:
 			m_rx_scan->scan_packets.push_back(rx_pkt);
+
+			// Streaming decoding, so the point cloud is ready as soon as the
+			// last packet of the scan arrives:
+			if (m_decode_on_arrival)
+				m_rx_scan->appendPacketToPointCloud(
+					m_rx_scan->scan_packets.back(), m_decode_params,
+					m_decode_cache);
 		}
 
 		return true;
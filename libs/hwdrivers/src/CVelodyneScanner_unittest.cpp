@@ -95,4 +95,53 @@ TEST(CVelodyneScanner, sample_hdl32_dataset)
 	EXPECT_EQ(nScans, 3U);
 }
 
+TEST(CVelodyneScanner, decode_packets_on_arrival)
+{
+	const string fil =
+		UNITTEST_BASEDIR + string("/tests/sample_velodyne_vlp16_gps.pcap");
+
+	if (!mrpt::system::fileExists(fil))
+	{
+		std::cerr << "WARNING: Skipping test due to missing file: " << fil
+				  << "\n";
+		return;
+	}
+
+	CVelodyneScanner velodyne;
+
+	velodyne.setModelName(mrpt::hwdrivers::CVelodyneScanner::VLP16);
+	velodyne.setPCAPInputFile(fil);
+	velodyne.setPCAPInputFileReadOnce(true);
+	velodyne.enableVerbose(false);
+	velodyne.setPCAPVerbosity(false);
+	velodyne.setDecodePacketsOnArrival(true);
+
+	velodyne.initialize();
+
+	size_t nScans = 0;
+	bool rx_ok = true;
+	for (size_t i = 0; i < 1000 && rx_ok; i++)
+	{
+		mrpt::obs::CObservationVelodyneScan::Ptr scan;
+		mrpt::obs::CObservationGPS::Ptr gps;
+		rx_ok = velodyne.getNextObservation(scan, gps);
+		if (!scan) continue;
+		nScans++;
+
+		// Streamed point cloud must match the one decoded at once:
+		const auto streamed = scan->point_cloud;
+		EXPECT_GT(streamed.size(), 0U);
+		scan->generatePointCloud();
+		ASSERT_EQ(streamed.size(), scan->point_cloud.size());
+		for (size_t k = 0; k < streamed.size(); k++)
+		{
+			EXPECT_EQ(streamed.x[k], scan->point_cloud.x[k]);
+			EXPECT_EQ(streamed.y[k], scan->point_cloud.y[k]);
+			EXPECT_EQ(streamed.z[k], scan->point_cloud.z[k]);
+			EXPECT_EQ(streamed.intensity[k], scan->point_cloud.intensity[k]);
+		}
+	};
+	EXPECT_EQ(nScans, 4U);
+}
+
 #endif	// MRPT_HAS_LIBPCAP
@@ -0,0 +1,122 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/pimpl.h>
+#include <mrpt/img/CImage.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mrpt::img
+{
+/** A process-wide, memory-bounded LRU cache of decoded externally-stored
+ * images (see CImage::setExternalStorage()), with a background prefetch
+ * thread.
+ *
+ * When enabled, loading an externally-stored CImage first looks for its file
+ * in this cache, and newly decoded images are added to it. The least recently
+ * used images are evicted when the total size of the cached pixels exceeds
+ * getMaxMemory(). This way, calling CImage::unload() and accessing the same
+ * image again later on (e.g. when scrubbing through a rawlog) does not read
+ * and decode the file again.
+ *
+ * prefetch() enqueues files to be loaded into the cache by a background
+ * thread, typically the images of the next observations in a dataset (see
+ * mrpt::obs::CRawlog::prefetchExternalImages()). If an image is requested
+ * while being prefetched, the caller waits for it instead of loading it
+ * twice.
+ *
+ * Images obtained from the cache are deep copies, so they can be freely
+ * modified without affecting the cached version.
+ *
+ * The cache is disabled (max memory=0) by default, unless the environment
+ * variable `MRPT_EXTERNAL_IMAGE_CACHE_MB` is set to a positive amount of
+ * megabytes. All methods are thread-safe.
+ *
+ * \note (New in MRPT 2.4.3)
+ * \sa CImage::getImagesPathBase()
+ * \ingroup mrpt_img_grp
+ */
+class CExternalImageCache
+{
+   public:
+	/** Returns the unique instance of the cache. */
+	static CExternalImageCache& Instance();
+
+	/** Sets the max. total size of cached pixel data, in bytes. Zero disables
+	 * the cache and frees all cached images. */
+	void setMaxMemory(std::size_t bytes);
+	std::size_t getMaxMemory() const;
+
+	/** Whether getMaxMemory()>0 */
+	bool enabled() const;
+
+	/** Replaces the list of files pending to be loaded in the background by
+	 * the given one, of absolute paths (see
+	 * CImage::getExternalStorageFileAbsolutePath()). Files already in the
+	 * cache are skipped. The files are loaded in order, so put first the
+	 * images to be needed first. Does nothing if the cache is disabled.
+	 */
+	void prefetch(const std::vector<std::string>& files);
+
+	/** Looks for an image in the cache, by the absolute path of its file.
+	 * If it is being loaded by the prefetch thread, waits for it.
+	 * \return false if not found in the cache.
+	 */
+	bool get(const std::string& file, CImage& out);
+
+	/** Adds a deep copy of an image to the cache (evicting older images if
+	 * needed), or does nothing if the cache is disabled. */
+	void insert(const std::string& file, const CImage& img);
+
+	/** Removes all cached images and pending prefetch requests. */
+	void clear();
+
+	/** Usage statistics, as returned by getStats() */
+	struct TStats
+	{
+		/** Number of get() calls served from the cache */
+		uint64_t hits = 0;
+		/** Number of get() calls not found in the cache */
+		uint64_t misses = 0;
+		/** Number of hits that had to wait for the prefetch thread */
+		uint64_t waits = 0;
+		/** Number of images loaded by the prefetch thread */
+		uint64_t prefetched = 0;
+		/** Number of images removed to make room for newer ones */
+		uint64_t evictions = 0;
+		/** Number of images and total pixel bytes currently in the cache */
+		std::size_t images = 0, bytes = 0;
+
+		/** Ratio of get() calls served from the cache */
+		double hitRatio() const
+		{
+			return hits + misses != 0
+				? static_cast<double>(hits) / (hits + misses)
+				: 0;
+		}
+	};
+
+	TStats getStats() const;
+	/** Resets the counters of getStats() (not the current cache contents) */
+	void resetStats();
+
+	~CExternalImageCache();
+
+   private:
+	CExternalImageCache();
+
+	struct Impl;
+	spimpl::unique_impl_ptr<Impl> m_impl;
+};
+
+}  // namespace mrpt::img
@@ -251,7 +251,7 @@ class CImage : public mrpt::serialization::CSerializable, public CCanvas
 	/** Changes the size of the image, erasing previous contents (does NOT scale
 	 * its current content, for that, see scaleImage).
 	 *  - nChannels: Can be 3 for RGB images or 1 for grayscale images.
-	 * \sa scaleImage
+	 * \sa scaleImage, CImageBufferPool
 	 */
 	void resize(
 		std::size_t width, std::size_t height, TImageChannels nChannels,
@@ -824,6 +824,8 @@ class CImage : public mrpt::serialization::CSerializable, public CCanvas
 	 * memory for images that will not be used often.
 	 *  If called for an image without the flag "external storage", it is
 	 * simply ignored.
+	 *  If CExternalImageCache is enabled, loading the image again later on
+	 * takes it from the cache instead of decoding the file again.
 	 * \sa setExternalStorage, forceLoad
 	 */
 	void unload() const noexcept;
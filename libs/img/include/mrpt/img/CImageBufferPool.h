@@ -0,0 +1,108 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/pimpl.h>
+#include <mrpt/img/CImage.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mrpt::img
+{
+/** A process-wide pool of pixel buffers for mrpt::img::CImage.
+ *
+ * High-rate image sources (e.g. cameras) create an image of the same size for
+ * each frame and destroy it shortly after. Drawing the pixel buffers from
+ * this pool, instead of allocating new ones, avoids the allocator overhead and
+ * the page faults of touching fresh memory at each frame.
+ *
+ * Buffers are classified by their size in bytes, hence by image resolution
+ * and pixel format. A buffer returns to the pool automatically when the last
+ * CImage (or `cv::Mat`) referencing it is destroyed or reassigned, so shallow
+ * copies of pooled images are safe. Up to getMaxFreeBuffersPerSize() unused
+ * buffers are kept for each size; the rest are freed.
+ *
+ * Usage:
+ * \code
+ * mrpt::img::CImage img;
+ * // Like img.resize(640, 480, CH_RGB), but reusing a former buffer:
+ * mrpt::img::CImageBufferPool::Instance().resize(img, 640, 480, CH_RGB);
+ * \endcode
+ *
+ * All methods are thread-safe.
+ *
+ * \note Requires MRPT built against OpenCV >=3.0. Otherwise, images are
+ * allocated as usual, without pooling.
+ * \note (New in MRPT 2.4.3)
+ * \sa mrpt::hwdrivers::CCameraSensor
+ * \ingroup mrpt_img_grp
+ */
+class CImageBufferPool
+{
+   public:
+	/** Returns the unique instance of the pool. */
+	static CImageBufferPool& Instance();
+
+	/** Like CImage::resize(), but taking the pixel buffer from the pool if
+	 * possible. The image contents are undefined after this call.
+	 * \sa attach
+	 */
+	void resize(
+		CImage& img, std::size_t width, std::size_t height,
+		TImageChannels nChannels, PixelDepth depth = PixelDepth::D8U);
+
+	/** Makes the next (re)allocations of the pixel buffer of \a img use this
+	 * pool, including those done by OpenCV functions writing into
+	 * `img.asCvMatRef()`, until the image is assigned a different `cv::Mat`
+	 * (e.g. by loading it from a file). */
+	void attach(CImage& img);
+
+	/** Max. number of unused buffers kept for each buffer size (Default=8) */
+	void setMaxFreeBuffersPerSize(std::size_t n);
+	std::size_t getMaxFreeBuffersPerSize() const;
+
+	/** Frees all unused buffers in the pool. */
+	void clear();
+
+	/** Usage statistics, as returned by getStats() */
+	struct TStats
+	{
+		/** Total number of buffers requested to the pool. */
+		uint64_t requests = 0;
+		/** Requests served with an unused buffer from the pool. */
+		uint64_t hits = 0;
+		/** Buffers returned to the pool, for later reuse. */
+		uint64_t recycled = 0;
+		/** Buffers freed when released, since the pool was full. */
+		uint64_t discarded = 0;
+		/** Number of pooled buffers currently owned by images. */
+		std::size_t buffersInUse = 0;
+		/** Number and total size of unused buffers in the pool. */
+		std::size_t freeBuffers = 0, freeBytes = 0;
+
+		/** Ratio of requests served from the pool: hits/requests */
+		double hitRatio() const
+		{
+			return requests != 0 ? static_cast<double>(hits) / requests : 0;
+		}
+	};
+
+	TStats getStats() const;
+	/** Resets the counters of getStats() (not the current buffer counts) */
+	void resetStats();
+
+   private:
+	CImageBufferPool();
+
+	struct Impl;
+	spimpl::unique_impl_ptr<Impl> m_impl;
+};
+
+}  // namespace mrpt::img
@@ -0,0 +1,242 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "img-precomp.h"  // Precompiled headers
+//
+#include <mrpt/core/get_env.h>
+#include <mrpt/img/CExternalImageCache.h>
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace mrpt::img;
+
+struct CExternalImageCache::Impl
+{
+	std::mutex mtx;
+	/** Signals new prefetch requests, finished loads and thread exit */
+	std::condition_variable cv;
+
+	std::size_t maxBytes = 0;
+	TStats stats;
+
+	struct Entry
+	{
+		std::string file;
+		CImage img;
+		std::size_t bytes = 0;
+	};
+	/** Cached images, the most recently used first */
+	std::list<Entry> lru;
+	std::unordered_map<std::string, std::list<Entry>::iterator> index;
+
+	/** Files pending to be prefetched, and the one being loaded */
+	std::deque<std::string> pending;
+	std::unordered_set<std::string> inFlight;
+
+	std::thread prefetchThread;
+	bool quit = false;
+
+	/** Removes the least recently used images until they fit in maxBytes.
+	 * The mutex must be locked. */
+	void evict_locked()
+	{
+		while (stats.bytes > maxBytes && !lru.empty())
+		{
+			const auto& e = lru.back();
+			stats.bytes -= e.bytes;
+			stats.images--;
+			stats.evictions++;
+			index.erase(e.file);
+			lru.pop_back();
+		}
+	}
+
+	/** The mutex must be locked. \a img must not be shared with anyone. */
+	void insert_locked(const std::string& file, CImage&& img)
+	{
+		const std::size_t bytes = img.isEmpty()
+			? 0
+			: img.getRowStride() * img.getHeight();
+		if (bytes > maxBytes) return;
+
+		if (auto it = index.find(file); it != index.end())
+		{
+			stats.bytes -= it->second->bytes;
+			stats.images--;
+			lru.erase(it->second);
+			index.erase(it);
+		}
+		lru.push_front({file, std::move(img), bytes});
+		index[file] = lru.begin();
+		stats.bytes += bytes;
+		stats.images++;
+		evict_locked();
+	}
+
+	void prefetchThreadMain()
+	{
+		std::unique_lock<std::mutex> lck(mtx);
+		for (;;)
+		{
+			cv.wait(lck, [this]() { return quit || !pending.empty(); });
+			if (quit) return;
+
+			const std::string file = std::move(pending.front());
+			pending.pop_front();
+			if (maxBytes == 0 || index.count(file) != 0 ||
+				inFlight.count(file) != 0)
+				continue;
+
+			inFlight.insert(file);
+			lck.unlock();
+
+			CImage img;
+			bool loadOk = false;
+			try
+			{
+				loadOk = img.loadFromFile(file);
+			}
+			catch (const std::exception&)
+			{
+			}
+
+			lck.lock();
+			inFlight.erase(file);
+			if (loadOk)
+			{
+				stats.prefetched++;
+				insert_locked(file, std::move(img));
+			}
+			cv.notify_all();
+		}
+	}
+};
+
+CExternalImageCache& CExternalImageCache::Instance()
+{
+	static CExternalImageCache cache;
+	return cache;
+}
+
+CExternalImageCache::CExternalImageCache()
+	: m_impl(spimpl::make_unique_impl<Impl>())
+{
+	const int megabytes =
+		mrpt::get_env<int>("MRPT_EXTERNAL_IMAGE_CACHE_MB", 0);
+	if (megabytes > 0)
+		m_impl->maxBytes = static_cast<std::size_t>(megabytes) << 20;
+}
+
+CExternalImageCache::~CExternalImageCache()
+{
+	{
+		std::lock_guard<std::mutex> lck(m_impl->mtx);
+		m_impl->quit = true;
+	}
+	m_impl->cv.notify_all();
+	if (m_impl->prefetchThread.joinable()) m_impl->prefetchThread.join();
+}
+
+void CExternalImageCache::setMaxMemory(std::size_t bytes)
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	m_impl->maxBytes = bytes;
+	if (bytes == 0) m_impl->pending.clear();
+	m_impl->evict_locked();
+}
+
+std::size_t CExternalImageCache::getMaxMemory() const
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	return m_impl->maxBytes;
+}
+
+bool CExternalImageCache::enabled() const { return getMaxMemory() != 0; }
+
+void CExternalImageCache::prefetch(const std::vector<std::string>& files)
+{
+	{
+		std::lock_guard<std::mutex> lck(m_impl->mtx);
+		if (m_impl->maxBytes == 0) return;
+
+		m_impl->pending.clear();
+		for (const auto& f : files)
+			if (m_impl->index.count(f) == 0) m_impl->pending.push_back(f);
+
+		if (!m_impl->prefetchThread.joinable())
+			m_impl->prefetchThread =
+				std::thread(&Impl::prefetchThreadMain, m_impl.get());
+	}
+	m_impl->cv.notify_all();
+}
+
+bool CExternalImageCache::get(const std::string& file, CImage& out)
+{
+	CImage cached;
+	{
+		std::unique_lock<std::mutex> lck(m_impl->mtx);
+		auto& d = *m_impl;
+		if (d.inFlight.count(file) != 0)
+		{
+			d.stats.waits++;
+			d.cv.wait(lck, [&]() { return d.inFlight.count(file) == 0; });
+		}
+
+		auto it = d.index.find(file);
+		if (it == d.index.end())
+		{
+			d.stats.misses++;
+			return false;
+		}
+		d.stats.hits++;
+		// Move to the front of the LRU list:
+		d.lru.splice(d.lru.begin(), d.lru, it->second);
+		cached = it->second->img;  // shallow copy
+	}
+	out = cached.makeDeepCopy();
+	return true;
+}
+
+void CExternalImageCache::insert(const std::string& file, const CImage& img)
+{
+	if (!enabled()) return;
+
+	CImage copy = img.makeDeepCopy();
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	m_impl->insert_locked(file, std::move(copy));
+}
+
+void CExternalImageCache::clear()
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	m_impl->pending.clear();
+	m_impl->lru.clear();
+	m_impl->index.clear();
+	m_impl->stats.images = 0;
+	m_impl->stats.bytes = 0;
+}
+
+CExternalImageCache::TStats CExternalImageCache::getStats() const
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	return m_impl->stats;
+}
+
+void CExternalImageCache::resetStats()
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	auto& s = m_impl->stats;
+	s.hits = s.misses = s.waits = s.prefetched = s.evictions = 0;
+}
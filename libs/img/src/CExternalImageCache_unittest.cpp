@@ -0,0 +1,117 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config.h>
+#include <mrpt/core/format.h>
+#include <mrpt/img/CExternalImageCache.h>
+#include <mrpt/system/filesystem.h>
+
+#include <string>
+#include <vector>
+
+#if MRPT_HAS_OPENCV
+
+using namespace mrpt::img;
+
+TEST(CExternalImageCache, LRUEviction)
+{
+	auto& cache = CExternalImageCache::Instance();
+	const auto oldMax = cache.getMaxMemory();
+	cache.clear();
+	cache.resetStats();
+
+	// Room for two 100x100 gray images:
+	cache.setMaxMemory(25000);
+
+	CImage a(100, 100, CH_GRAY), b(100, 100, CH_GRAY), c(100, 100, CH_GRAY);
+	a.filledRectangle(0, 0, 99, 99, TColor(10, 10, 10));
+	b.filledRectangle(0, 0, 99, 99, TColor(20, 20, 20));
+	c.filledRectangle(0, 0, 99, 99, TColor(30, 30, 30));
+
+	cache.insert("/a.png", a);
+	cache.insert("/b.png", b);
+
+	CImage out;
+	EXPECT_TRUE(cache.get("/a.png", out));
+	EXPECT_EQ(out.at<uint8_t>(50, 50), 10);
+	// Deep copy: does not modify the cached image
+	out.filledRectangle(0, 0, 99, 99, TColor(0, 0, 0));
+
+	// "b" is now the least recently used one:
+	cache.insert("/c.png", c);
+	EXPECT_FALSE(cache.get("/b.png", out));
+	EXPECT_TRUE(cache.get("/a.png", out));
+	EXPECT_EQ(out.at<uint8_t>(50, 50), 10);
+	EXPECT_TRUE(cache.get("/c.png", out));
+	EXPECT_EQ(out.at<uint8_t>(50, 50), 30);
+
+	const auto s = cache.getStats();
+	EXPECT_EQ(s.hits, 3U);
+	EXPECT_EQ(s.misses, 1U);
+	EXPECT_EQ(s.evictions, 1U);
+	EXPECT_EQ(s.images, 2U);
+
+	cache.setMaxMemory(oldMax);
+	cache.clear();
+}
+
+TEST(CExternalImageCache, LazyLoadAndPrefetch)
+{
+	auto& cache = CExternalImageCache::Instance();
+	const auto oldMax = cache.getMaxMemory();
+	cache.clear();
+	cache.resetStats();
+	cache.setMaxMemory(10 << 20);
+
+	const std::string dir = mrpt::system::getTempFileName() + "_imgs";
+	ASSERT_TRUE(mrpt::system::createDirectory(dir));
+
+	std::vector<std::string> files;
+	for (int i = 0; i < 3; i++)
+	{
+		CImage img(64, 48, CH_RGB);
+		img.filledRectangle(0, 0, 63, 47, TColor(i * 50, 0, 0));
+		files.push_back(dir + mrpt::format("/img%i.png", i));
+		ASSERT_TRUE(img.saveToFile(files.back()));
+	}
+
+	// Lazy-load: the first access decodes the file, the next ones do not.
+	for (int rep = 0; rep < 2; rep++)
+	{
+		CImage img;
+		img.setExternalStorage(files[0]);
+		EXPECT_EQ(img.getWidth(), 64U);
+		img.unload();
+		EXPECT_EQ(img.getHeight(), 48U);
+	}
+	EXPECT_EQ(cache.getStats().misses, 1U);
+	EXPECT_EQ(cache.getStats().hits, 3U);
+
+	// Background load of the other images:
+	cache.prefetch({files[1], files[2]});
+	for (int i = 1; i < 3; i++)
+	{
+		CImage img;
+		img.setExternalStorage(files[i]);
+		EXPECT_EQ(img.at<uint8_t>(10, 10, 2 /*red*/), i * 50);
+	}
+	const auto s = cache.getStats();
+	// Each one either found in the cache, or loaded in this thread if the
+	// prefetch thread did not start loading it yet:
+	EXPECT_EQ(s.hits + s.misses, 6U);
+	EXPECT_EQ(s.images, 3U);
+
+	mrpt::system::deleteFilesInDirectory(dir, true);
+
+	cache.setMaxMemory(oldMax);
+	cache.clear();
+}
+
+#endif
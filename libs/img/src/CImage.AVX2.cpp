@@ -0,0 +1,370 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "img-precomp.h"  // Precompiled headers
+//
+#include <mrpt/config.h>
+
+#if MRPT_ARCH_INTEL_COMPATIBLE
+// ---------------------------------------------------------------------------
+//   This file contains the AVX2 optimized functions for mrpt::img::CImage
+//   They are the 32-byte wide versions of those in CImage.SSE2.cpp and
+//   CImage.SSSE3.cpp, and return exactly the same results.
+//    See the sources and the doxygen documentation page "sse_optimizations" for
+//    more details.
+// ---------------------------------------------------------------------------
+
+#include <immintrin.h>
+
+#include "CImage.SSEx.h"
+
+/** \addtogroup sse_optimizations
+ *  SSE optimized functions
+ *  @{
+ */
+
+namespace
+{
+// Takes the low 16 bytes of each 128-bit lane of the 16-bit values in "x"
+// (already in the range [0,255]) and packs them into 16 consecutive bytes.
+inline __m128i pack_16x16u_to_8u(__m256i x)
+{
+	const __m256i p = _mm256_permute4x64_epi64(
+		_mm256_packus_epi16(x, x), _MM_SHUFFLE(3, 1, 2, 0));
+	return _mm256_castsi256_si128(p);
+}
+}  // namespace
+
+/** Subsample each 2x2 pixel block into 1x1 pixel, taking the first pixel &
+ * ignoring the other 3
+ *  - <b>Input format:</b> uint8_t, 1 channel
+ *  - <b>Output format:</b> uint8_t, 1 channel
+ *  - <b>Preconditions:</b> none
+ *  - <b>Notes:</b> Same output than image_SSE2_scale_half_1c8u()
+ *  - <b>Requires:</b> AVX2
+ *  - <b>Invoked from:</b> mrpt::img::CImage::scaleHalf()
+ */
+void image_AVX2_scale_half_1c8u(
+	const uint8_t* in, uint8_t* out, int w, int h, size_t step_in,
+	size_t step_out)
+{
+	const __m256i m = _mm256_set1_epi16(0x00ff);
+
+	const int sw = w / 32;
+	const int sh = h / 2;
+	const int out_w = w / 2;
+
+	for (int i = 0; i < sh; i++)
+	{
+		const uint8_t* inp = in;
+		uint8_t* outp = out;
+		for (int j = 0; j < sw; j++)
+		{
+			const __m256i x = _mm256_and_si256(
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(inp)), m);
+			_mm_storeu_si128(
+				reinterpret_cast<__m128i*>(outp), pack_16x16u_to_8u(x));
+			inp += 32;
+			outp += 16;
+		}
+		// Extra pixels? (w mod 32 != 0)
+		for (int p = 16 * sw; p < out_w; p++)
+			out[p] = in[2 * p];
+
+		in += 2 * step_in;	// Skip one row
+		out += step_out;
+	}
+}
+
+/** Average each 2x2 pixels into 1x1 pixel (arithmetic average)
+ *  - <b>Input format:</b> uint8_t, 1 channel
+ *  - <b>Output format:</b> uint8_t, 1 channel
+ *  - <b>Preconditions:</b> none
+ *  - <b>Notes:</b> Same output than image_SSE2_scale_half_smooth_1c8u()
+ *  - <b>Requires:</b> AVX2
+ *  - <b>Invoked from:</b> mrpt::img::CImage::scaleHalf()
+ */
+void image_AVX2_scale_half_smooth_1c8u(
+	const uint8_t* in, uint8_t* out, int w, int h, size_t step_in,
+	size_t step_out)
+{
+	const __m256i m = _mm256_set1_epi16(0x00ff);
+
+	const int sw = w / 32;
+	const int sh = h / 2;
+	const int out_w = w / 2;
+
+	for (int i = 0; i < sh; i++)
+	{
+		const uint8_t* inp = in;
+		uint8_t* outp = out;
+
+		for (int j = 0; j < sw; j++)
+		{
+			__m256i here =
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(inp));
+			__m256i next = _mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(inp + step_in));
+			here = _mm256_avg_epu8(here, next);
+			next = _mm256_srli_epi16(here, 8);
+			here = _mm256_and_si256(here, m);
+			here = _mm256_avg_epu16(here, next);
+			_mm_storeu_si128(
+				reinterpret_cast<__m128i*>(outp), pack_16x16u_to_8u(here));
+			inp += 32;
+			outp += 16;
+		}
+
+		// Extra pixels? (w mod 32 != 0)
+		const uint8_t* nextRow = in + step_in;
+		for (int p = 16 * sw; p < out_w; p++)
+		{
+			const int a = (in[2 * p] + nextRow[2 * p] + 1) >> 1;
+			const int b = (in[2 * p + 1] + nextRow[2 * p + 1] + 1) >> 1;
+			out[p] = static_cast<uint8_t>((a + b + 1) >> 1);
+		}
+
+		in += 2 * step_in;	// Skip one row
+		out += step_out;
+	}
+}
+
+// This is the actual function behind both: image_AVX2_rgb_to_gray_8u() and
+// image_AVX2_bgr_to_gray_8u(). It does the same than the SSSE3 version on two
+// blocks of 16 pixels at once, one in each 128-bit lane, since
+// _mm256_shuffle_epi8() does not cross lanes.
+template <bool IS_RGB>
+void impl_image_AVX2_rgb_or_bgr_to_gray_8u(
+	const uint8_t* in, uint8_t* out, int w, int h, size_t step_in,
+	size_t step_out)
+{
+	// clang-format off
+#define MASK256(...) _mm256_broadcastsi128_si256(_mm_setr_epi8(__VA_ARGS__))
+
+	// Masks:             0       1    2    3     4      5     6    7     8      9     A     B      C    D    E     F
+	// byte #0 of pixels [0-7] from D0
+	const __m256i mask0 = MASK256(0x80, 0x00, 0x80, 0x03, 0x80, 0x06, 0x80, 0x09, 0x80, 0x0C, 0x80, 0x0F, 0x80, 0x80, 0x80, 0x80);
+	// byte #0 of pixels [0-7] from D1
+	const __m256i mask1 = MASK256(0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x02, 0x80, 0x05);
+	// byte #1 of pixels [0-7] from D0
+	const __m256i mask2 = MASK256(0x80, 0x01, 0x80, 0x04, 0x80, 0x07, 0x80, 0x0A, 0x80, 0x0D, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80);
+	// byte #1 of pixels [0-7] from D1
+	const __m256i mask3 = MASK256(0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0x80, 0x03, 0x80, 0x06);
+	// byte #2 of pixels [0-7] from D0
+	const __m256i mask4 = MASK256(0x80, 0x02, 0x80, 0x05, 0x80, 0x08, 0x80, 0x0B, 0x80, 0x0E, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80);
+	// byte #2 of pixels [0-7] from D1
+	const __m256i mask5 = MASK256(0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01, 0x80, 0x04, 0x80, 0x07);
+	// byte #0 of pixels [8-15] from D1
+	const __m256i mask6 = MASK256(0x80, 0x08, 0x80, 0x0B, 0x80, 0x0E, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80);
+	// byte #0 of pixels [8-15] from D2
+	const __m256i mask7 = MASK256(0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01, 0x80, 0x04, 0x80, 0x07, 0x80, 0x0A, 0x80, 0x0D);
+	// byte #1 of pixels [8-15] from D1
+	const __m256i mask8 = MASK256(0x80, 0x09, 0x80, 0x0C, 0x80, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80);
+	// byte #1 of pixels [8-15] from D2
+	const __m256i mask9 = MASK256(0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x02, 0x80, 0x05, 0x80, 0x08, 0x80, 0x0B, 0x80, 0x0E);
+	// byte #2 of pixels [8-15] from D1
+	const __m256i mask10 = MASK256(0x80, 0x0A, 0x80, 0x0D, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80);
+	// byte #2 of pixels [8-15] from D2
+	const __m256i mask11 = MASK256(0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0x80, 0x03, 0x80, 0x06, 0x80, 0x09, 0x80, 0x0C, 0x80, 0x0F);
+	// Gray levels, in the low 8 bytes of each lane:
+	const __m256i mask_low = MASK256(0x01, 0x03, 0x05, 0x07, 0x09, 0x0B, 0x0D, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80);
+
+#undef MASK256
+	// clang-format on
+
+	// Conversion factors for RGB->Y (in the high byte of each 16-bit value)
+	const __m256i VAL_R = _mm256_set1_epi16(static_cast<int16_t>(0x4D00));
+	const __m256i VAL_G = _mm256_set1_epi16(static_cast<int16_t>(0x9600));
+	const __m256i VAL_B = _mm256_set1_epi16(static_cast<int16_t>(0x1D00));
+
+	const __m256i m_r0 = IS_RGB ? mask0 : mask4;
+	const __m256i m_r1 = IS_RGB ? mask1 : mask5;
+	const __m256i m_b0 = IS_RGB ? mask4 : mask0;
+	const __m256i m_b1 = IS_RGB ? mask5 : mask1;
+	const __m256i m_r2 = IS_RGB ? mask6 : mask10;
+	const __m256i m_r3 = IS_RGB ? mask7 : mask11;
+	const __m256i m_b2 = IS_RGB ? mask10 : mask6;
+	const __m256i m_b3 = IS_RGB ? mask11 : mask7;
+
+	auto gray = [&](__m256i r, __m256i g, __m256i b) {
+		return _mm256_adds_epu16(
+			_mm256_mulhi_epu16(r, VAL_R),
+			_mm256_adds_epu16(
+				_mm256_mulhi_epu16(g, VAL_G), _mm256_mulhi_epu16(b, VAL_B)));
+	};
+	// Loads the 16-byte block #k of the two 48-byte groups starting at "p"
+	// (_mm256_loadu2_m128i() is not available in GCC<10)
+	auto load2 = [](const uint8_t* p, int k) {
+		const __m128i lo =
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * k));
+		const __m128i hi =
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48 + 16 * k));
+		return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+	};
+
+	const int sw = w / 32;	// Number of blocks of 32 pixels in each row
+
+	for (int i = 0; i < h; i++)
+	{
+		const uint8_t* inp = in;
+		uint8_t* outp = out;
+
+		for (int j = 0; j < sw; j++)
+		{
+			// Lane #0: pixels [0-15], lane #1: pixels [16-31]
+			const __m256i d0 = load2(inp, 0);
+			const __m256i d1 = load2(inp, 1);
+			const __m256i d2 = load2(inp, 2);
+
+			const __m256i GRAYS_0_7 = gray(
+				_mm256_or_si256(
+					_mm256_shuffle_epi8(d0, m_r0),
+					_mm256_shuffle_epi8(d1, m_r1)),
+				_mm256_or_si256(
+					_mm256_shuffle_epi8(d0, mask2),
+					_mm256_shuffle_epi8(d1, mask3)),
+				_mm256_or_si256(
+					_mm256_shuffle_epi8(d0, m_b0),
+					_mm256_shuffle_epi8(d1, m_b1)));
+			const __m256i GRAYS_8_15 = gray(
+				_mm256_or_si256(
+					_mm256_shuffle_epi8(d1, m_r2),
+					_mm256_shuffle_epi8(d2, m_r3)),
+				_mm256_or_si256(
+					_mm256_shuffle_epi8(d1, mask8),
+					_mm256_shuffle_epi8(d2, mask9)),
+				_mm256_or_si256(
+					_mm256_shuffle_epi8(d1, m_b2),
+					_mm256_shuffle_epi8(d2, m_b3)));
+
+			_mm256_storeu_si256(
+				reinterpret_cast<__m256i*>(outp),
+				_mm256_unpacklo_epi64(
+					_mm256_shuffle_epi8(GRAYS_0_7, mask_low),
+					_mm256_shuffle_epi8(GRAYS_8_15, mask_low)));
+			inp += 3 * 32;
+			outp += 32;
+		}
+		in += step_in;
+		out += step_out;
+	}
+}
+
+/** Convert a BGR image (3cu8) into a GRAYSCALE (1c8u) image, using
+ * Y=77*R+150*G+29*B
+ *  - <b>Input format:</b> uint8_t, 3 channels (BGR order)
+ *  - <b>Output format:</b> uint8_t, 1 channel
+ *  - <b>Preconditions:</b> none
+ *  - <b>Notes:</b> Only the first 32*floor(w/32) columns are converted.
+ *  - <b>Requires:</b> AVX2
+ *  - <b>Invoked from:</b> mrpt::img::CImage::grayscale(),
+ * mrpt::img::CImage::grayscaleInPlace()
+ */
+void image_AVX2_bgr_to_gray_8u(
+	const uint8_t* in, uint8_t* out, int w, int h, size_t step_in,
+	size_t step_out)
+{
+	impl_image_AVX2_rgb_or_bgr_to_gray_8u<false>(
+		in, out, w, h, step_in, step_out);
+}
+
+/** Convert a RGB image (3cu8) into a GRAYSCALE (1c8u) image, using
+ * Y=77*R+150*G+29*B
+ *  - <b>Input format:</b> uint8_t, 3 channels (RGB order)
+ *  - <b>Output format:</b> uint8_t, 1 channel
+ *  - <b>Preconditions:</b> none
+ *  - <b>Notes:</b> Only the first 32*floor(w/32) columns are converted.
+ *  - <b>Requires:</b> AVX2
+ *  - <b>Invoked from:</b> mrpt::img::CImage::grayscale(),
+ * mrpt::img::CImage::grayscaleInPlace()
+ */
+void image_AVX2_rgb_to_gray_8u(
+	const uint8_t* in, uint8_t* out, int w, int h, size_t step_in,
+	size_t step_out)
+{
+	impl_image_AVX2_rgb_or_bgr_to_gray_8u<true>(
+		in, out, w, h, step_in, step_out);
+}
+
+/** Sums of products of the image gradients (central differences) within the
+ * window [x0, x0+win_w-1] x [y0, y0+win_h-1], as used in the KLT/Harris
+ * response. Reads exactly the same pixels than the plain C++ version, i.e.
+ * one pixel beyond each side of the window.
+ *  - <b>Input format:</b> uint8_t, 1 channel
+ *  - <b>Preconditions:</b> x0+win_w <= img_w
+ *  - <b>Requires:</b> AVX2
+ *  - <b>Invoked from:</b> mrpt::img::CImage::KLT_response()
+ */
+void image_AVX2_KLT_gradients(
+	const uint8_t* in, size_t step, unsigned int img_w, unsigned int x0,
+	unsigned int y0, unsigned int win_w, unsigned int win_h, int32_t& gxx,
+	int32_t& gyy, int32_t& gxy)
+{
+	const __m256i iota = _mm256_setr_epi16(
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+	auto load16 = [](const uint8_t* p) {
+		return _mm256_cvtepu8_epi16(
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+	};
+
+	__m256i sxx = _mm256_setzero_si256(), syy = sxx, sxy = sxx;
+	int32_t rxx = 0, ryy = 0, rxy = 0;	// Non-vectorized pixels
+
+	for (unsigned int iy = 0; iy < win_h; iy++)
+	{
+		const uint8_t* row = in + step * (y0 + iy);
+		unsigned int xx = x0;
+		const unsigned int x_end = x0 + win_w;
+
+		// Blocks of 16 pixels (the last one, masked). The "+1" loads must not
+		// go beyond the row end:
+		for (; xx < x_end && xx + 16 < img_w; xx += 16)
+		{
+			const uint8_t* p = row + xx;
+			__m256i dx = _mm256_sub_epi16(load16(p + 1), load16(p - 1));
+			__m256i dy = _mm256_sub_epi16(load16(p + step), load16(p - step));
+			if (x_end - xx < 16)
+			{
+				const __m256i valid = _mm256_cmpgt_epi16(
+					_mm256_set1_epi16(static_cast<int16_t>(x_end - xx)), iota);
+				dx = _mm256_and_si256(dx, valid);
+				dy = _mm256_and_si256(dy, valid);
+			}
+			sxx = _mm256_add_epi32(sxx, _mm256_madd_epi16(dx, dx));
+			syy = _mm256_add_epi32(syy, _mm256_madd_epi16(dy, dy));
+			sxy = _mm256_add_epi32(sxy, _mm256_madd_epi16(dx, dy));
+		}
+		// Pixels too close to the right image border:
+		for (; xx < x_end; xx++)
+		{
+			const uint8_t* p = row + xx;
+			const int32_t dx = p[+1] - p[-1];
+			const int32_t dy = p[+step] - p[-static_cast<ptrdiff_t>(step)];
+			rxx += dx * dx;
+			ryy += dy * dy;
+			rxy += dx * dy;
+		}
+	}
+
+	auto hsum = [](__m256i v) {
+		__m128i s = _mm_add_epi32(
+			_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+		s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+		s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtsi128_si32(s);
+	};
+	gxx = hsum(sxx) + rxx;
+	gyy = hsum(syy) + ryy;
+	gxy = hsum(sxy) + rxy;
+}
+
+/**  @} */
+
+#endif	// end if MRPT_ARCH_INTEL_COMPATIBLE
@@ -49,7 +49,7 @@ void impl_image_SSE2_scale_half_1c8u(
 
 	const int sw = w / 16;
 	const int sh = h / 2;
-	const int rest_w = w - (16 * w);
+	const int rest_w = w - (16 * sw);
 
 	for (int i = 0; i < sh; i++)
 	{
@@ -94,7 +94,7 @@ void impl_image_SSE2_scale_half_smooth_1c8u(
 
 	const int sw = w / 16;
 	const int sh = h / 2;
-	const int rest_w = w - (16 * w);
+	const int rest_w = w - (16 * sw);
 
 	for (int i = 0; i < sh; i++)
 	{
@@ -119,10 +119,13 @@ void impl_image_SSE2_scale_half_smooth_1c8u(
 		if (rest_w != 0)
 		{
 			const uint8_t* ir = in + 16 * sw;
-			const uint8_t* irr = in + step_in;
+			const uint8_t* irr = ir + step_in;
 			for (int p = 0; p < rest_w / 2; p++)
 			{
-				*outp++ = (ir[0] + ir[1] + irr[0] + irr[1]) / 4;
+				// Same rounding than _mm_avg_epu8() + _mm_avg_epu16():
+				const int a = (ir[0] + irr[0] + 1) >> 1;
+				const int b = (ir[1] + irr[1] + 1) >> 1;
+				*outp++ = static_cast<uint8_t>((a + b + 1) >> 1);
 				ir += 2;
 				irr += 2;
 			}
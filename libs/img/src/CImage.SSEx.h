@@ -13,7 +13,7 @@
 #include <cstddef>
 #include <cstdint>
 
-// See documentation in the .cpp files CImage_SSE*.cpp
+// See documentation in the .cpp files CImage.SSE*.cpp, CImage.AVX2.cpp
 
 void image_SSE2_scale_half_1c8u(
 	const uint8_t* in, uint8_t* out, int w, int h, size_t in_step,
@@ -30,3 +30,20 @@ void image_SSSE3_rgb_to_gray_8u(
 void image_SSSE3_bgr_to_gray_8u(
 	const uint8_t* in, uint8_t* out, int w, int h, size_t in_step,
 	size_t out_step);
+
+void image_AVX2_scale_half_1c8u(
+	const uint8_t* in, uint8_t* out, int w, int h, size_t in_step,
+	size_t out_step);
+void image_AVX2_scale_half_smooth_1c8u(
+	const uint8_t* in, uint8_t* out, int w, int h, size_t in_step,
+	size_t out_step);
+void image_AVX2_rgb_to_gray_8u(
+	const uint8_t* in, uint8_t* out, int w, int h, size_t in_step,
+	size_t out_step);
+void image_AVX2_bgr_to_gray_8u(
+	const uint8_t* in, uint8_t* out, int w, int h, size_t in_step,
+	size_t out_step);
+void image_AVX2_KLT_gradients(
+	const uint8_t* in, size_t step, unsigned int img_w, unsigned int x0,
+	unsigned int y0, unsigned int win_w, unsigned int win_h, int32_t& gxx,
+	int32_t& gyy, int32_t& gxy);
@@ -12,6 +12,7 @@
 #include <mrpt/core/cpu.h>
 #include <mrpt/core/get_env.h>
 #include <mrpt/core/round.h>  // for round()
+#include <mrpt/img/CExternalImageCache.h>
 #include <mrpt/img/CImage.h>
 #include <mrpt/io/CFileInputStream.h>
 #include <mrpt/io/CFileOutputStream.h>
@@ -278,8 +279,10 @@ void CImage::resize(
 	// since it will throw if resize() is called from a ctor, where it's
 	// legit for the img to be uninitialized.
 
-	// If we're resizing to exactly the current size, do nothing:
-	if (static_cast<unsigned>(m_impl->img.cols) == width &&
+	// If we're resizing to exactly the current size, do nothing, unless the
+	// buffer is shared with a shallow copy that the caller may overwrite:
+	const bool sharedBuffer = m_impl->img.u && m_impl->img.u->refcount > 1;
+	if (!sharedBuffer && static_cast<unsigned>(m_impl->img.cols) == width &&
 		static_cast<unsigned>(m_impl->img.rows) == height &&
 		m_impl->img.channels() == nChannels &&
 		m_impl->img.depth() == static_cast<int>(pixelDepth2CvDepth(depth)))
@@ -296,9 +299,15 @@ void CImage::resize(
 	static_assert(
 		pixelDepth2CvDepth<int>(PixelDepth::D8U) + CV_8UC(3) == CV_8UC3);
 
-	m_impl->img = cv::Mat(
+	// Always allocate a new buffer (do not create() in place), since it may
+	// be shared with shallow copies of this image. Keep the allocator, e.g.
+	// that of CImageBufferPool:
+	cv::Mat newImg;
+	newImg.allocator = m_impl->img.allocator;
+	newImg.create(
 		static_cast<int>(height), static_cast<int>(width),
 		pixelDepth2CvDepth<int>(depth) + ((nChannels - 1) << CV_CN_SHIFT));
+	m_impl->img = newImg;
 
 #if IMAGE_ALLOC_PERFLOG
 	alloc_tims.leave(sLog.c_str());
@@ -993,15 +1002,41 @@ static bool my_img_to_grayscale(const cv::Mat& src, cv::Mat& dest)
 	if (dest.size() != src.size() || dest.type() != src.type())
 		dest = cv::Mat(src.rows, src.cols, CV_8UC1);
 
-		// If possible, use SSE optimized version:
+		// If possible, use SIMD optimized versions:
 #if MRPT_ARCH_INTEL_COMPATIBLE
-	if ((src.step[0] & 0x0f) == 0 && (dest.step[0] & 0x0f) == 0 &&
-		mrpt::cpu::supports(mrpt::cpu::feature::SSSE3))
+	if (src.type() == CV_8UC3)
 	{
-		image_SSSE3_bgr_to_gray_8u(
-			src.ptr<uint8_t>(), dest.ptr<uint8_t>(), src.cols, src.rows,
-			src.step[0], dest.step[0]);
-		return true;
+		const int w = src.cols, h = src.rows;
+		const uint8_t* in = src.ptr<uint8_t>();
+		uint8_t* out = dest.ptr<uint8_t>();
+		int done = 0;  // Number of already converted columns
+		if (mrpt::cpu::supports(mrpt::cpu::feature::AVX2))
+		{
+			done = w & ~31;
+			image_AVX2_bgr_to_gray_8u(
+				in, out, done, h, src.step[0], dest.step[0]);
+		}
+		if ((src.step[0] & 0x0f) == 0 && (dest.step[0] & 0x0f) == 0 &&
+			mrpt::cpu::supports(mrpt::cpu::feature::SSSE3))
+		{
+			const int n = (w - done) & ~15;
+			image_SSSE3_bgr_to_gray_8u(
+				in + 3 * done, out + done, n, h, src.step[0], dest.step[0]);
+			done += n;
+		}
+		if (done != 0)
+		{
+			// Remaining columns, with the same fixed-point weights:
+			for (int y = 0; y < h; y++)
+			{
+				const uint8_t* bgr = src.ptr<uint8_t>(y) + 3 * done;
+				uint8_t* gray = dest.ptr<uint8_t>(y);
+				for (int x = done; x < w; x++, bgr += 3)
+					gray[x] = static_cast<uint8_t>(
+						(29 * bgr[0] + 150 * bgr[1] + 77 * bgr[2]) >> 8);
+			}
+			return true;
+		}
 	}
 #endif
 
@@ -1057,6 +1092,22 @@ bool CImage::scaleHalf(CImage& out, TInterpolationMethod interp) const
 		return true;
 	}
 
+	if (img.channels() == 1 && mrpt::cpu::supports(mrpt::cpu::feature::AVX2))
+	{
+		if (interp == IMG_INTERP_NN)
+		{
+			image_AVX2_scale_half_1c8u(
+				img.data, img_out.data, w, h, img.step[0], img_out.step[0]);
+			return true;
+		}
+		else if (interp == IMG_INTERP_LINEAR)
+		{
+			image_AVX2_scale_half_smooth_1c8u(
+				img.data, img_out.data, w, h, img.step[0], img_out.step[0]);
+			return true;
+		}
+	}
+
 	if (img.channels() == 1 && mrpt::cpu::supports(mrpt::cpu::feature::SSE2))
 	{
 		if (interp == IMG_INTERP_NN)
@@ -1641,6 +1692,15 @@ void CImage::makeSureImageIsLoaded(bool allowNonInitialized) const
 		string wholeFile;
 		getExternalStorageFileAbsolutePath(wholeFile);
 
+#if MRPT_HAS_OPENCV
+		auto& cache = CExternalImageCache::Instance();
+		if (CImage cached; cache.enabled() && cache.get(wholeFile, cached))
+		{
+			const_cast<cv::Mat&>(m_impl->img) = cached.m_impl->img;
+			return;
+		}
+#endif
+
 		const std::string tmpFile = m_externalFile;
 
 		bool ret = const_cast<CImage*>(this)->loadFromFile(wholeFile);
@@ -1656,6 +1716,10 @@ void CImage::makeSureImageIsLoaded(bool allowNonInitialized) const
 				"Error loading externally-stored image from: %s",
 				wholeFile.c_str());
 
+#if MRPT_HAS_OPENCV
+		cache.insert(wholeFile, *this);
+#endif
+
 		if (MRPT_DEBUG_IMG_LAZY_LOAD)
 			std::cout << "[CImage] Loaded lazy-load image file '" << wholeFile
 					  << "' on this=" << reinterpret_cast<const void*>(this)
@@ -2022,87 +2086,99 @@ float MRPT_DISABLE_FULL_OPTIMIZATION CImage::KLT_response(
 	int32_t gyy = 0;
 
 	const auto* img_data = im1.ptr<uint8_t>(0);
-	switch (half_window_size)
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	if (mrpt::cpu::supports(mrpt::cpu::feature::AVX2))
 	{
-		case 2:
-			image_KLT_response_template<2>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-		case 3:
-			image_KLT_response_template<3>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-		case 4:
-			image_KLT_response_template<4>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-		case 5:
-			image_KLT_response_template<5>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-		case 6:
-			image_KLT_response_template<6>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-		case 7:
-			image_KLT_response_template<7>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-		case 8:
-			image_KLT_response_template<8>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-		case 9:
-			image_KLT_response_template<9>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-		case 10:
-			image_KLT_response_template<10>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-		case 11:
-			image_KLT_response_template<11>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-		case 12:
-			image_KLT_response_template<12>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-		case 13:
-			image_KLT_response_template<13>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-		case 14:
-			image_KLT_response_template<14>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-		case 15:
-			image_KLT_response_template<15>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-		case 16:
-			image_KLT_response_template<16>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-		case 32:
-			image_KLT_response_template<32>(
-				img_data, widthStep, x, y, gxx, gyy, gxy);
-			break;
-
-		default:
-			for (unsigned int yy = min_y; yy <= max_y; yy++)
-			{
-				const uint8_t* p = img_data + widthStep * yy + min_x;
-				for (unsigned int xx = min_x; xx <= max_x; xx++)
+		const unsigned int win = max_x - min_x + 1;
+		image_AVX2_KLT_gradients(
+			img_data, widthStep, img_w, min_x, min_y, win, win, gxx, gyy, gxy);
+	}
+	else
+#endif
+	{
+		switch (half_window_size)
+		{
+			case 2:
+				image_KLT_response_template<2>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+			case 3:
+				image_KLT_response_template<3>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+			case 4:
+				image_KLT_response_template<4>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+			case 5:
+				image_KLT_response_template<5>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+			case 6:
+				image_KLT_response_template<6>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+			case 7:
+				image_KLT_response_template<7>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+			case 8:
+				image_KLT_response_template<8>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+			case 9:
+				image_KLT_response_template<9>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+			case 10:
+				image_KLT_response_template<10>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+			case 11:
+				image_KLT_response_template<11>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+			case 12:
+				image_KLT_response_template<12>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+			case 13:
+				image_KLT_response_template<13>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+			case 14:
+				image_KLT_response_template<14>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+			case 15:
+				image_KLT_response_template<15>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+			case 16:
+				image_KLT_response_template<16>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+			case 32:
+				image_KLT_response_template<32>(
+					img_data, widthStep, x, y, gxx, gyy, gxy);
+				break;
+
+			default:
+				for (unsigned int yy = min_y; yy <= max_y; yy++)
 				{
-					const int32_t dx = p[+1] - p[-1];
-					const int32_t dy = p[+widthStep] - p[-widthStep];
-					gxx += dx * dx;
-					gxy += dx * dy;
-					gyy += dy * dy;
+					const uint8_t* p = img_data + widthStep * yy + min_x;
+					for (unsigned int xx = min_x; xx <= max_x; xx++)
+					{
+						const int32_t dx = p[+1] - p[-1];
+						const int32_t dy = p[+widthStep] - p[-widthStep];
+						gxx += dx * dx;
+						gxy += dx * dy;
+						gyy += dy * dy;
+						p++;
+					}
 				}
-			}
-			break;
+				break;
+		}
 	}
 	// Convert to float's and normalize in the way:
 	const float K = 0.5f / ((max_y - min_y + 1) * (max_x - min_x + 1));
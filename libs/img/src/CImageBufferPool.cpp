@@ -0,0 +1,213 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "img-precomp.h"  // Precompiled headers
+//
+#include <mrpt/img/CImageBufferPool.h>
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+// Universal include for all versions of OpenCV
+#include <mrpt/3rdparty/do_opencv_includes.h>
+
+#define IMG_POOL_ENABLED (MRPT_HAS_OPENCV && MRPT_OPENCV_VERSION_NUM >= 0x300)
+
+using namespace mrpt::img;
+
+struct CImageBufferPool::Impl
+{
+	mutable std::mutex mtx;
+	/** Unused buffers, by size in bytes */
+	std::map<std::size_t, std::vector<void*>> freeBuffers;
+	std::size_t maxFreePerSize = 8;
+	TStats stats;
+
+#if IMG_POOL_ENABLED
+	void* acquire(std::size_t nBytes)
+	{
+		{
+			std::lock_guard<std::mutex> lck(mtx);
+			stats.requests++;
+			stats.buffersInUse++;
+			auto it = freeBuffers.find(nBytes);
+			if (it != freeBuffers.end() && !it->second.empty())
+			{
+				void* p = it->second.back();
+				it->second.pop_back();
+				stats.hits++;
+				stats.freeBuffers--;
+				stats.freeBytes -= nBytes;
+				return p;
+			}
+		}
+		return cv::fastMalloc(nBytes);
+	}
+
+	void release(void* p, std::size_t nBytes)
+	{
+		{
+			std::lock_guard<std::mutex> lck(mtx);
+			stats.buffersInUse--;
+			auto& lst = freeBuffers[nBytes];
+			if (lst.size() < maxFreePerSize)
+			{
+				lst.push_back(p);
+				stats.recycled++;
+				stats.freeBuffers++;
+				stats.freeBytes += nBytes;
+				return;
+			}
+			stats.discarded++;
+		}
+		cv::fastFree(p);
+	}
+
+#if MRPT_OPENCV_VERSION_NUM >= 0x400
+	using access_flags_t = cv::AccessFlag;
+#else
+	using access_flags_t = int;
+#endif
+
+	/** OpenCV calls this allocator to create and release the buffers of the
+	 * cv::Mat objects that have it assigned, and of all their copies. Same
+	 * than cv::StdMatAllocator, but with pooled buffers. */
+	struct Allocator : public cv::MatAllocator
+	{
+		Impl* pool;
+		explicit Allocator(Impl* p) : pool(p) {}
+
+		cv::UMatData* allocate(
+			int dims, const int* sizes, int type, void* data0, size_t* step,
+			access_flags_t /*flags*/,
+			cv::UMatUsageFlags /*usageFlags*/) const override
+		{
+			constexpr size_t AUTOSTEP = 0x7fffffff;	 // CV_AUTOSTEP
+			size_t total = CV_ELEM_SIZE(type);
+			for (int i = dims - 1; i >= 0; i--)
+			{
+				if (step)
+				{
+					if (data0 && step[i] != AUTOSTEP)
+					{
+						CV_Assert(total <= step[i]);
+						total = step[i];
+					}
+					else
+						step[i] = total;
+				}
+				total *= sizes[i];
+			}
+			auto* u = new cv::UMatData(this);
+			u->size = total;
+			if (data0)
+			{
+				// User-provided memory: not handled by the pool.
+				u->data = u->origdata = static_cast<uchar*>(data0);
+				u->flags |= cv::UMatData::USER_ALLOCATED;
+			}
+			else
+			{
+				u->data = static_cast<uchar*>(pool->acquire(total));
+				u->origdata = u->data;
+			}
+			return u;
+		}
+
+		bool allocate(
+			cv::UMatData* u, access_flags_t /*accessFlags*/,
+			cv::UMatUsageFlags /*usageFlags*/) const override
+		{
+			return u != nullptr;
+		}
+
+		void deallocate(cv::UMatData* u) const override
+		{
+			if (!u) return;
+			CV_Assert(u->urefcount == 0);
+			CV_Assert(u->refcount == 0);
+			if (!(u->flags & cv::UMatData::USER_ALLOCATED))
+			{
+				pool->release(u->origdata, u->size);
+				u->origdata = nullptr;
+			}
+			delete u;
+		}
+	};
+
+	Allocator allocator{this};
+#endif
+};
+
+CImageBufferPool& CImageBufferPool::Instance()
+{
+	// Never destroyed: pooled images may outlive other static objects, and
+	// they need the pool to release their buffers.
+	static auto* pool = new CImageBufferPool();
+	return *pool;
+}
+
+CImageBufferPool::CImageBufferPool()
+	: m_impl(spimpl::make_unique_impl<Impl>())
+{
+}
+
+void CImageBufferPool::attach([[maybe_unused]] CImage& img)
+{
+#if IMG_POOL_ENABLED
+	img.asCvMatRef().allocator = &m_impl->allocator;
+#endif
+}
+
+void CImageBufferPool::resize(
+	CImage& img, std::size_t width, std::size_t height,
+	TImageChannels nChannels, PixelDepth depth)
+{
+	attach(img);
+	img.resize(width, height, nChannels, depth);
+}
+
+void CImageBufferPool::setMaxFreeBuffersPerSize(std::size_t n)
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	m_impl->maxFreePerSize = n;
+}
+
+std::size_t CImageBufferPool::getMaxFreeBuffersPerSize() const
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	return m_impl->maxFreePerSize;
+}
+
+void CImageBufferPool::clear()
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+#if IMG_POOL_ENABLED
+	for (auto& kv : m_impl->freeBuffers)
+		for (void* p : kv.second)
+			cv::fastFree(p);
+#endif
+	m_impl->freeBuffers.clear();
+	m_impl->stats.freeBuffers = 0;
+	m_impl->stats.freeBytes = 0;
+}
+
+CImageBufferPool::TStats CImageBufferPool::getStats() const
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	return m_impl->stats;
+}
+
+void CImageBufferPool::resetStats()
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	auto& s = m_impl->stats;
+	s.requests = s.hits = s.recycled = s.discarded = 0;
+}
@@ -0,0 +1,135 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config.h>
+#include <mrpt/img/CImageBufferPool.h>
+
+#include <cstring>
+#include <vector>
+
+#if MRPT_HAS_OPENCV && MRPT_OPENCV_VERSION_NUM >= 0x300
+
+TEST(CImageBufferPool, reuseBuffers)
+{
+	using namespace mrpt::img;
+	auto& pool = CImageBufferPool::Instance();
+	pool.clear();
+	const auto s0 = pool.getStats();
+
+	const uint8_t* data = nullptr;
+	{
+		CImage img;
+		pool.resize(img, 321, 123, CH_RGB);
+		EXPECT_EQ(img.getWidth(), 321U);
+		EXPECT_EQ(img.getHeight(), 123U);
+		EXPECT_TRUE(img.isColor());
+		data = img.ptrLine<uint8_t>(0);
+
+		const auto s = pool.getStats();
+		EXPECT_EQ(s.requests, s0.requests + 1);
+		EXPECT_EQ(s.hits, s0.hits);
+		EXPECT_EQ(s.buffersInUse, s0.buffersInUse + 1);
+	}
+	// Back to the pool:
+	{
+		const auto s = pool.getStats();
+		EXPECT_EQ(s.buffersInUse, s0.buffersInUse);
+		EXPECT_EQ(s.recycled, s0.recycled + 1);
+		EXPECT_EQ(s.freeBuffers, 1U);
+		EXPECT_EQ(s.freeBytes, 321U * 123U * 3U);
+	}
+	// Same size and format: same buffer
+	{
+		CImage img;
+		pool.resize(img, 321, 123, CH_RGB);
+		EXPECT_EQ(img.ptrLine<uint8_t>(0), data);
+		EXPECT_EQ(pool.getStats().hits, s0.hits + 1);
+		EXPECT_EQ(pool.getStats().freeBuffers, 0U);
+
+		// A shallow copy keeps the buffer alive:
+		CImage copy = img;
+		img = CImage();
+		EXPECT_EQ(pool.getStats().buffersInUse, s0.buffersInUse + 1);
+		EXPECT_EQ(copy.ptrLine<uint8_t>(0), data);
+	}
+	EXPECT_EQ(pool.getStats().buffersInUse, s0.buffersInUse);
+
+	// Different size: a new buffer
+	{
+		CImage img;
+		pool.resize(img, 320, 123, CH_GRAY);
+		EXPECT_EQ(pool.getStats().hits, s0.hits + 1);
+		// Resizing an attached image also uses the pool:
+		img.resize(321, 123, CH_RGB);
+		EXPECT_EQ(pool.getStats().hits, s0.hits + 2);
+		EXPECT_EQ(img.ptrLine<uint8_t>(0), data);
+	}
+	pool.clear();
+	EXPECT_EQ(pool.getStats().freeBuffers, 0U);
+}
+
+TEST(CImageBufferPool, maxFreeBuffers)
+{
+	using namespace mrpt::img;
+	auto& pool = CImageBufferPool::Instance();
+	pool.clear();
+	const auto oldMax = pool.getMaxFreeBuffersPerSize();
+	pool.setMaxFreeBuffersPerSize(2);
+
+	const auto s0 = pool.getStats();
+	{
+		std::vector<CImage> imgs(5);
+		for (auto& img : imgs)
+			pool.resize(img, 64, 48, CH_GRAY);
+	}
+	const auto s = pool.getStats();
+	EXPECT_EQ(s.requests, s0.requests + 5);
+	EXPECT_EQ(s.recycled, s0.recycled + 2);
+	EXPECT_EQ(s.discarded, s0.discarded + 3);
+	EXPECT_EQ(s.freeBuffers, 2U);
+
+	pool.setMaxFreeBuffersPerSize(oldMax);
+	pool.clear();
+}
+
+TEST(CImageBufferPool, resizeDoesNotAliasShallowCopies)
+{
+	using namespace mrpt::img;
+	auto& pool = CImageBufferPool::Instance();
+	pool.clear();
+
+	for (const bool attached : {false, true})
+	{
+		// Both to a different size, and to the same size:
+		for (const unsigned int h : {24U, 48U})
+		{
+			CImage img(64, 48, CH_GRAY);
+			if (attached) pool.attach(img);
+			for (unsigned int y = 0; y < 48; y++)
+				std::memset(img.ptrLine<uint8_t>(y), 0x10, 64);
+
+			const CImage copy = img;  // shallow copy
+			img.resize(64, h, CH_GRAY);
+			EXPECT_NE(img.ptrLine<uint8_t>(0), copy.ptrLine<uint8_t>(0));
+			for (unsigned int y = 0; y < h; y++)
+				std::memset(img.ptrLine<uint8_t>(y), 0xff, 64);
+
+			ASSERT_EQ(copy.getWidth(), 64U);
+			ASSERT_EQ(copy.getHeight(), 48U);
+			for (unsigned int y = 0; y < 48; y++)
+				for (unsigned int x = 0; x < 64; x++)
+					EXPECT_EQ(*copy(x, y), 0x10)
+						<< "attached=" << attached << " h=" << h;
+		}
+	}
+	pool.clear();
+}
+
+#endif
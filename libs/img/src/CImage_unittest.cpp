@@ -9,6 +9,7 @@
 
 #include <CTraitsTest.h>
 #include <gtest/gtest.h>
+#include <mrpt/core/cpu.h>
 #include <mrpt/img/CImage.h>
 #include <mrpt/img/TColor.h>
 #include <mrpt/io/CMemoryStream.h>
@@ -579,4 +580,93 @@ TEST(CImage, DifferentAccessMethodsGray)
 	}
 }
 
+// Runs "f" with the AVX2 kernels enabled (if the CPU has them) and disabled:
+template <typename FUNCTOR>
+static void with_and_without_AVX2(FUNCTOR f)
+{
+	using mrpt::cpu::feature;
+	const bool savedAVX2 = mrpt::cpu::supports(feature::AVX2);
+	f();
+	mrpt::cpu::overrideDetectedFeature(feature::AVX2, false);
+	f();
+	mrpt::cpu::overrideDetectedFeature(feature::AVX2, savedAVX2);
+}
+
+TEST(CImage, SIMD_scaleHalf)
+{
+	using namespace mrpt::img;
+
+	// Odd sizes, to exercise the non-vectorized columns too:
+	CImage a(643, 101, CH_GRAY);
+	fillImagePseudoRandom(123, a);
+
+	for (const auto interp : {IMG_INTERP_NN, IMG_INTERP_LINEAR})
+	{
+		std::vector<CImage> res;
+		with_and_without_AVX2([&]() { res.push_back(a.scaleHalf(interp)); });
+		ASSERT_EQ(res.size(), 2U);
+		EXPECT_EQ(res[0].getWidth(), 321U);
+		EXPECT_EQ(res[0].getHeight(), 50U);
+		expect_identical(res[0], res[1], "interp=" + std::to_string(interp));
+	}
+}
+
+TEST(CImage, SIMD_grayscale)
+{
+	using namespace mrpt::img;
+
+	for (const unsigned int w : {70U, 96U, 640U})
+	{
+		CImage a(w, 20, CH_RGB);
+		auto& rnd = mrpt::random::getRandomGenerator();
+		rnd.randomize(w);
+		for (unsigned y = 0; y < a.getHeight(); y++)
+		{
+			auto* p = a.ptrLine<uint8_t>(y);
+			for (unsigned x = 0; x < 3 * w; x++)
+				p[x] = static_cast<uint8_t>(rnd.drawUniform32bit());
+		}
+
+		std::vector<CImage> res;
+		with_and_without_AVX2([&]() { res.push_back(a.grayscale()); });
+
+		for (const auto& g : res)
+		{
+			ASSERT_EQ(g.getWidth(), w);
+			ASSERT_FALSE(g.isColor());
+			for (unsigned y = 0; y < a.getHeight(); y++)
+			{
+				for (unsigned x = 0; x < w; x++)
+				{
+					// BGR order. OpenCV, if used, rounds differently:
+					const auto* bgr = a.ptr<uint8_t>(x, y);
+					const int Y =
+						(29 * bgr[0] + 150 * bgr[1] + 77 * bgr[2]) >> 8;
+					EXPECT_NEAR(g.at<uint8_t>(x, y), Y, 1) << "w=" << w;
+				}
+			}
+		}
+	}
+}
+
+TEST(CImage, SIMD_KLT_response)
+{
+	using namespace mrpt::img;
+
+	CImage a(300, 200, CH_GRAY);
+	fillImagePseudoRandom(321, a);
+
+	for (unsigned int half_win = 1; half_win < 40; half_win++)
+	{
+		for (const unsigned int x : {half_win + 1, 150U, 298U - half_win})
+		{
+			std::vector<float> res;
+			with_and_without_AVX2(
+				[&]() { res.push_back(a.KLT_response(x, 100, half_win)); });
+			// Integer sums: must be exactly equal:
+			EXPECT_EQ(res[0], res[1]) << "half_win=" << half_win;
+		}
+	}
+}
+
 #endif	// MRPT_HAS_OPENCV
@@ -0,0 +1,87 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mrpt::io
+{
+/** A read-only memory mapping of a whole file: its contents are accessible
+ * through data() without reading them into a buffer first, and the OS loads
+ * pages on demand. Useful to parse large files, possibly from several threads
+ * at once.
+ *
+ * \code
+ * mrpt::io::CMemoryMappedFile f("cloud.bin");
+ * const uint8_t* p = f.data();
+ * for (size_t i = 0; i < f.size(); i++) ...
+ * \endcode
+ *
+ * \sa CFileInputStream
+ * \ingroup mrpt_io_grp
+ * \note (New in MRPT 2.4.3)
+ */
+class CMemoryMappedFile
+{
+   public:
+	/** Access pattern hint for the OS. */
+	enum class AccessHint : uint8_t
+	{
+		Normal = 0,
+		/** Read-ahead aggressively (the default) */
+		Sequential,
+		Random
+	};
+
+	CMemoryMappedFile() = default;
+
+	/** Maps the given file. \sa open() */
+	explicit CMemoryMappedFile(
+		const std::string& fileName,
+		AccessHint hint = AccessHint::Sequential);
+
+	~CMemoryMappedFile();
+
+	CMemoryMappedFile(const CMemoryMappedFile&) = delete;
+	CMemoryMappedFile& operator=(const CMemoryMappedFile&) = delete;
+
+	/** Maps the given file, closing any previous one. Empty files can be
+	 * open, with data()==nullptr.
+	 * \exception std::exception On errors opening or mapping the file.
+	 */
+	void open(
+		const std::string& fileName,
+		AccessHint hint = AccessHint::Sequential);
+
+	/** Unmaps the file. Pointers returned by data() become invalid. */
+	void close();
+
+	bool isOpen() const { return m_isOpen; }
+
+	/** The file contents, or nullptr if it is empty or not open */
+	const uint8_t* data() const { return m_data; }
+
+	/** The file size (bytes) */
+	size_t size() const { return m_size; }
+
+	const std::string& fileName() const { return m_fileName; }
+
+   private:
+	const uint8_t* m_data = nullptr;
+	size_t m_size = 0;
+	bool m_isOpen = false;
+	std::string m_fileName;
+	// Win32 handles (unused elsewhere):
+	void* m_hFile = nullptr;
+	void* m_hMapping = nullptr;
+};
+
+}  // namespace mrpt::io
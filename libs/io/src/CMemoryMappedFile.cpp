@@ -0,0 +1,138 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "io-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/exceptions.h>
+#include <mrpt/io/CMemoryMappedFile.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+using namespace mrpt::io;
+
+CMemoryMappedFile::CMemoryMappedFile(
+	const std::string& fileName, AccessHint hint)
+{
+	open(fileName, hint);
+}
+
+CMemoryMappedFile::~CMemoryMappedFile() { close(); }
+
+void CMemoryMappedFile::open(const std::string& fileName, AccessHint hint)
+{
+	close();
+
+#ifdef _WIN32
+	const DWORD flags = hint == AccessHint::Sequential
+		? FILE_FLAG_SEQUENTIAL_SCAN
+		: (hint == AccessHint::Random ? FILE_FLAG_RANDOM_ACCESS
+									  : FILE_ATTRIBUTE_NORMAL);
+	HANDLE hFile = CreateFileA(
+		fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, flags, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+		THROW_EXCEPTION_FMT("Cannot open file: '%s'", fileName.c_str());
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(hFile, &fileSize))
+	{
+		CloseHandle(hFile);
+		THROW_EXCEPTION_FMT("Cannot get size of file: '%s'", fileName.c_str());
+	}
+	m_hFile = hFile;
+	m_size = static_cast<size_t>(fileSize.QuadPart);
+
+	if (m_size != 0)
+	{
+		HANDLE hMapping =
+			CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const void* ptr = hMapping
+			? MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0)
+			: nullptr;
+		if (!ptr)
+		{
+			if (hMapping) CloseHandle(hMapping);
+			CloseHandle(hFile);
+			m_hFile = nullptr;
+			m_size = 0;
+			THROW_EXCEPTION_FMT("Cannot map file: '%s'", fileName.c_str());
+		}
+		m_hMapping = hMapping;
+		m_data = static_cast<const uint8_t*>(ptr);
+	}
+#else
+	const int fd = ::open(fileName.c_str(), O_RDONLY);
+	if (fd < 0)
+		THROW_EXCEPTION_FMT(
+			"Cannot open file: '%s' (%s)", fileName.c_str(),
+			std::strerror(errno));
+
+	struct stat st;
+	if (::fstat(fd, &st) != 0)
+	{
+		::close(fd);
+		THROW_EXCEPTION_FMT("Cannot get size of file: '%s'", fileName.c_str());
+	}
+	m_size = static_cast<size_t>(st.st_size);
+
+	if (m_size != 0)
+	{
+		void* ptr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (ptr == MAP_FAILED)
+		{
+			::close(fd);
+			m_size = 0;
+			THROW_EXCEPTION_FMT(
+				"Cannot map file: '%s' (%s)", fileName.c_str(),
+				std::strerror(errno));
+		}
+		const int advice = hint == AccessHint::Sequential
+			? MADV_SEQUENTIAL
+			: (hint == AccessHint::Random ? MADV_RANDOM : MADV_NORMAL);
+		::madvise(ptr, m_size, advice);
+		m_data = static_cast<const uint8_t*>(ptr);
+	}
+	// The mapping keeps its own reference to the file:
+	::close(fd);
+#endif
+
+	m_fileName = fileName;
+	m_isOpen = true;
+}
+
+void CMemoryMappedFile::close()
+{
+	if (!m_isOpen) return;
+
+#ifdef _WIN32
+	if (m_data) UnmapViewOfFile(m_data);
+	if (m_hMapping) CloseHandle(static_cast<HANDLE>(m_hMapping));
+	if (m_hFile) CloseHandle(static_cast<HANDLE>(m_hFile));
+	m_hMapping = nullptr;
+	m_hFile = nullptr;
+#else
+	if (m_data) ::munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+
+	m_data = nullptr;
+	m_size = 0;
+	m_isOpen = false;
+	m_fileName.clear();
+}
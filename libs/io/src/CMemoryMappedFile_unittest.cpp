@@ -0,0 +1,52 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/io/CMemoryMappedFile.h>
+#include <mrpt/io/vector_loadsave.h>
+#include <mrpt/system/filesystem.h>
+
+#include <cstring>
+
+TEST(CMemoryMappedFile, readContents)
+{
+	const auto fil = mrpt::system::getTempFileName();
+
+	std::vector<uint8_t> buf(100000);
+	for (size_t i = 0; i < buf.size(); i++)
+		buf[i] = static_cast<uint8_t>(i * 7);
+	ASSERT_TRUE(mrpt::io::vectorToBinaryFile(buf, fil));
+
+	mrpt::io::CMemoryMappedFile f(fil);
+	EXPECT_TRUE(f.isOpen());
+	ASSERT_EQ(f.size(), buf.size());
+	EXPECT_EQ(0, std::memcmp(f.data(), buf.data(), buf.size()));
+
+	f.close();
+	EXPECT_FALSE(f.isOpen());
+	EXPECT_EQ(f.data(), nullptr);
+	EXPECT_EQ(f.size(), 0U);
+
+	// Empty file:
+	buf.clear();
+	ASSERT_TRUE(mrpt::io::vectorToBinaryFile(buf, fil));
+	f.open(fil, mrpt::io::CMemoryMappedFile::AccessHint::Random);
+	EXPECT_TRUE(f.isOpen());
+	EXPECT_EQ(f.size(), 0U);
+	f.close();
+
+	mrpt::system::deleteFile(fil);
+}
+
+TEST(CMemoryMappedFile, throwOnError)
+{
+	mrpt::io::CMemoryMappedFile f;
+	EXPECT_ANY_THROW(f.open("/this/file/does/not/exist.bin"));
+	EXPECT_FALSE(f.isOpen());
+}
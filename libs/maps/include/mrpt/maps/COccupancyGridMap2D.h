@@ -24,6 +24,9 @@
 #include <mrpt/tfest/TMatchingPair.h>
 #include <mrpt/typemeta/TEnumType.h>
 
+#include <algorithm>
+#include <array>
+
 namespace mrpt::maps
 {
 /** A class for storing an occupancy grid map.
@@ -105,6 +108,55 @@ class COccupancyGridMap2D
 	 * Voronoi diagram  */
 	mrpt::containers::CDynamicGrid<uint16_t> m_voronoi_diagram;
 
+	/** Exact Euclidean distance transform of the binarized grid, built by
+	 * computeClearanceMap() and incrementally maintained by
+	 * updateClearanceMap(). */
+	struct TClearanceMap
+	{
+		/** Grid size this transform was computed for */
+		uint32_t size_x{0}, size_y{0};
+		/** Cells with a value below this one are obstacles */
+		cellType threshold{0};
+		/** Squared distance (in cell units) to the closest obstacle cell */
+		std::vector<uint32_t> sqDist;
+		/** Linear index (x+y*size_x) of the closest obstacle, or -1 if none */
+		std::vector<int32_t> closest;
+		/** Rectangle {x1,x2,y1,y2} of cells modified since the transform was
+		 * last computed or updated, or x1>x2 if none */
+		std::array<int, 4> changed{{0, -1, 0, -1}};
+
+		bool empty() const { return sqDist.empty(); }
+		bool sizeMatches(uint32_t sx, uint32_t sy) const
+		{
+			return !empty() && size_x == sx && size_y == sy;
+		}
+		bool isUpToDate() const { return changed[0] > changed[1]; }
+		void markChanged(int x1, int x2, int y1, int y2)
+		{
+			if (empty()) return;
+			if (isUpToDate()) changed = {{x1, x2, y1, y2}};
+			else
+			{
+				changed[0] = std::min(changed[0], x1);
+				changed[1] = std::max(changed[1], x2);
+				changed[2] = std::min(changed[2], y1);
+				changed[3] = std::max(changed[3], y2);
+			}
+		}
+		void clear()
+		{
+			size_x = size_y = 0;
+			sqDist.clear();
+			closest.clear();
+			changed = {{0, -1, 0, -1}};
+		}
+	};
+	TClearanceMap m_clearance_map;
+
+	/** Robot size (1/100 cell units) of the last buildVoronoiDiagram() call,
+	 * reused by updateVoronoiDiagram() */
+	int m_voronoi_robot_size_units{0};
+
 	/** True upon construction; used by isEmpty() */
 	bool m_is_empty{true};
 
@@ -129,6 +181,7 @@ class COccupancyGridMap2D
 	inline void setCell_nocheck(int x, int y, float value)
 	{
 		map[x + y * size_x] = p2l(value);
+		m_clearance_map.markChanged(x, x, y, y);
 	}
 
 	/** Read the real valued [0,1] contents of a cell, given its index */
@@ -139,7 +192,10 @@ class COccupancyGridMap2D
 	/** Changes a cell by its absolute index (Do not use it normally) */
 	inline void setRawCell(unsigned int cellIndex, cellType b)
 	{
-		if (cellIndex < size_x * size_y) map[cellIndex] = b;
+		if (cellIndex >= size_x * size_y) return;
+		map[cellIndex] = b;
+		const int x = cellIndex % size_x, y = cellIndex / size_x;
+		m_clearance_map.markChanged(x, x, y, y);
 	}
 
 	/** One of the methods that can be selected for implementing
@@ -351,8 +407,8 @@ class COccupancyGridMap2D
 		if (static_cast<unsigned int>(x) >= size_x ||
 			static_cast<unsigned int>(y) >= size_y)
 			return;
-		else
-			map[x + y * size_x] = p2l(value);
+		map[x + y * size_x] = p2l(value);
+		m_clearance_map.markChanged(x, x, y, y);
 	}
 
 	/** Read the real valued [0,1] contents of a cell, given its index */
@@ -371,8 +427,8 @@ class COccupancyGridMap2D
 	inline cellType* getRow(int cy)
 	{
 		if (cy < 0 || static_cast<unsigned int>(cy) >= size_y) return nullptr;
-		else
-			return &map[0 + cy * size_x];
+		m_clearance_map.markChanged(0, static_cast<int>(size_x) - 1, cy, cy);
+		return &map[0 + cy * size_x];
 	}
 
 	/** Access to a "row": mainly used for drawing grid as a bitmap efficiently,
@@ -670,8 +726,22 @@ class COccupancyGridMap2D
 		float threshold, float robot_size, int x1 = 0, int x2 = 0, int y1 = 0,
 		int y2 = 0);
 
+	/** Incrementally updates the Voronoi diagram built by a previous call to
+	 * buildVoronoiDiagram(), after the cells in the rectangle [x1,x2]x[y1,y2]
+	 * (cell indices, inclusive) have changed. Only the area whose clearance may
+	 * be affected by those cells is recomputed, which makes it suitable for
+	 * online topological planning while the map grows. As in
+	 * updateClearanceMap(), cells modified since the last update are always
+	 * included. If the Voronoi diagram was never built or the grid has been
+	 * resized, the whole diagram is rebuilt.
+	 * \sa buildVoronoiDiagram, updateClearanceMap
+	 * \note (New in MRPT 2.4.3)
+	 */
+	void updateVoronoiDiagram(int x1, int x2, int y1, int y2);
+
 	/** Reads a the clearance of a cell (in centimeters), after building the
-	 * Voronoi diagram with \a buildVoronoiDiagram */
+	 * Voronoi diagram with \a buildVoronoiDiagram. Clearances larger than
+	 * 65535 are saturated to that value. */
 	inline uint16_t getVoroniClearance(int cx, int cy) const
 	{
 #ifdef _DEBUG
@@ -699,6 +769,19 @@ class COccupancyGridMap2D
 		*cell = dist;
 	}
 
+	/** Computes the Voronoi membership and clearance of cells in the
+	 * rectangle [x1,x2]x[y1,y2] from the distance transform, then thins the
+	 * diagram. */
+	void updateVoronoiCells(int x1, int x2, int y1, int y2);
+
+	/** Computes the distance transform considering only obstacles within
+	 * the window {x1,x2,y1,y2}, storing results for cells in `out` (which
+	 * must be contained in the window).
+	 * \return false if an obstacle out of the window might be closer to any
+	 * of the `out` cells than the one found. */
+	bool computeClearanceMapWindow(
+		const std::array<int, 4>& win, const std::array<int, 4>& out);
+
    public:
 	/** Return the auxiliary "basis" map built while building the Voronoi
 	 * diagram \sa buildVoronoiDiagram */
@@ -750,6 +833,57 @@ class COccupancyGridMap2D
 	 */
 	float computeClearance(float x, float y, float maxSearchDistance) const;
 
+	/** @name Distance transform (clearance map)
+		@{ */
+
+	/** Computes the exact Euclidean distance transform of the whole grid,
+	 * i.e. the distance from each cell to its closest occupied cell, where
+	 * "occupied" means an occupancy probability larger than \a threshold.
+	 * It runs in linear time in the number of cells (separable row/column
+	 * lower-envelope algorithm by Felzenszwalb & Huttenlocher), with rows and
+	 * columns distributed among all available CPU cores.
+	 * \sa updateClearanceMap, getClearanceMapDistance
+	 * \note (New in MRPT 2.4.3)
+	 */
+	void computeClearanceMap(float threshold = 0.5f);
+
+	/** Updates the distance transform after the cells in the rectangle
+	 * [x1,x2]x[y1,y2] (cell indices, inclusive) have changed, recomputing only
+	 * a neighborhood around them. The result is identical to calling
+	 * computeClearanceMap() again. Cells modified since the last update with
+	 * setCell(), updateCell(), etc. are always included, even if out of the
+	 * rectangle. Falls back to a full computation if there is no previous
+	 * transform or the grid size changed.
+	 * \note insertObservation() may change any cell, hence a full
+	 * computation is done after it.
+	 * \return The (inclusive) rectangle of cells whose distance may have
+	 * changed, as {x1,x2,y1,y2}.
+	 * \note (New in MRPT 2.4.3)
+	 */
+	std::array<int, 4> updateClearanceMap(int x1, int x2, int y1, int y2);
+
+	/** Returns true if computeClearanceMap() has been called and neither the
+	 * grid size nor any cell changed since then (or since the last
+	 * updateClearanceMap()). */
+	bool hasClearanceMap() const
+	{
+		return m_clearance_map.sizeMatches(size_x, size_y) &&
+			m_clearance_map.isUpToDate();
+	}
+
+	/** Distance (in meters) from the given cell to its closest obstacle, as
+	 * computed by computeClearanceMap(). Returns
+	 * std::numeric_limits<float>::max() if the map has no obstacles at all.
+	 */
+	float getClearanceMapDistance(int cx, int cy) const;
+
+	/** Gets the indices of the closest obstacle cell to (cx,cy), as
+	 * computed by computeClearanceMap().
+	 * \return false if the map has no obstacles at all. */
+	bool getClearanceMapClosestObstacle(int cx, int cy, int& ox, int& oy) const;
+
+	/** @} */
+
 	/** Compute the 'cost' of traversing a segment of the map according to the
 	 * occupancy of traversed cells.
 	 *  \return This returns '1-mean(traversed cells occupancy)', i.e. 0.5 for
@@ -917,6 +1051,73 @@ class COccupancyGridMap2D
 		const TLaserSimulUncertaintyParams& in_params,
 		TLaserSimulUncertaintyResult& out_results) const;
 
+	/** Ray casting algorithms for laserScanSimulatorBatch() */
+	enum TRayCastingMethod
+	{
+		/** Fixed steps of RAYTRACE_STEP_SIZE_IN_CELL_UNITS cells, exactly as
+		 * in laserScanSimulator() */
+		rcmStepping = 0,
+		/** Sphere tracing: each step advances as far as the clearance map
+		 * (see computeClearanceMap()) guarantees there are no obstacles, and
+		 * never less than RAYTRACE_STEP_SIZE_IN_CELL_UNITS cells. Much faster
+		 * in large open areas. */
+		rcmDistanceField
+	};
+
+	/** Input params for laserScanSimulatorBatch() */
+	struct TLaserSimulBatchParams
+	{
+		/** (Default: rcmStepping) The ray casting algorithm */
+		TRayCastingMethod method{rcmStepping};
+		/** (Default: M_PI) The "aperture" or field-of-view of the range finder,
+		 * in radians (typically M_PI = 180 degrees). */
+		float aperture{M_PIf};
+		/** (Default: true) The scanning direction: true=counterclockwise;
+		 * false=clockwise */
+		bool rightToLeft{true};
+		/** (Default: 80) The maximum range allowed by the device, in meters
+		 * (e.g. 80m, 50m,...) */
+		float maxRange{80.f};
+		/** (Default: at origin) The 6D pose of the sensor on the robot */
+		mrpt::poses::CPose3D sensorPose;
+		size_t nRays{361};
+		/** (Default: 1) The rays that will be simulated are at indexes: 0, D,
+		 * 2D, 3D,... The rest are marked as invalid. */
+		unsigned int decimation{1};
+		/** (Default: 0.6f) The minimum occupancy threshold to consider a cell
+		 * to be occupied */
+		float threshold{.6f};
+
+		TLaserSimulBatchParams();
+	};
+
+	/** Simulates one noiseless laser scan from each of the given robot poses,
+	 * distributing the poses among all available CPU cores. Each output
+	 * scan gets the aperture, range and sensor pose from \a in_params.
+	 *
+	 * With rcmStepping, the output is identical to that of calling
+	 * laserScanSimulator() once per pose. With rcmDistanceField, the grid
+	 * must have an up-to-date clearance map (see hasClearanceMap()) computed
+	 * with computeClearanceMap(in_params.threshold), and updated with
+	 * updateClearanceMap() after modifying cells. Since both methods sample
+	 * the rays at discrete points, ranges then differ from rcmStepping in up
+	 * to two cells, except for a few rays grazing obstacle corners, which may
+	 * hit them with one method only. Rays are valid up to the full \a
+	 * maxRange (rcmStepping only reaches RAYTRACE_STEP_SIZE_IN_CELL_UNITS
+	 * times it).
+	 *
+	 * \param out_scans [OUT] Resized to the number of poses. Existing
+	 * objects are reused to avoid reallocations.
+	 * \exception std::exception If rcmDistanceField is requested without an
+	 * up-to-date clearance map for the given threshold.
+	 * \sa laserScanSimulator()
+	 * \note (New in MRPT 2.4.3)
+	 */
+	void laserScanSimulatorBatch(
+		const TLaserSimulBatchParams& in_params,
+		const std::vector<mrpt::poses::CPose2D>& robotPoses,
+		std::vector<mrpt::obs::CObservation2DRangeScan>& out_scans) const;
+
 	/** @} */
 
 	/** Computes the likelihood [0,1] of a set of points, given the current grid
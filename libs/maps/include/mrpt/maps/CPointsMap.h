@@ -32,6 +32,10 @@ DECLARE_MEXPLUS_FROM(mrpt::maps::CPointsMap)
 
 namespace mrpt
 {
+namespace poses
+{
+class CPose3DInterpolator;
+}
 /** \ingroup mrpt_maps_grp */
 namespace maps
 {
@@ -399,7 +403,8 @@ class CPointsMap : public CMetricMap,
 	}
 
 	/** 2D or 3D generic implementation of \a load2D_from_text_file and
-	 * load3D_from_text_file */
+	 * load3D_from_text_file. The file is memory-mapped and its lines parsed
+	 * in parallel. */
 	bool load2Dor3D_from_text_file(const std::string& file, const bool is_3D);
 	bool load2Dor3D_from_text_stream(
 		std::istream& in, mrpt::optional_ref<std::string> outErrorMsg,
@@ -454,6 +459,75 @@ class CPointsMap : public CMetricMap,
 	}
 #endif
 
+	/** Loads the point cloud from a PCL PCD file, without requiring PCL.
+	 * Data can be `ascii`, `binary` or `binary_compressed`. Fields `x y z`
+	 * are required; `intensity` and `rgb` (or `rgba`) are loaded into the
+	 * point intensity (CPointsMapXYZI) or color (CColouredPointsMap), if the
+	 * map class has them. Other fields are ignored.
+	 *
+	 * The file is memory-mapped and decoded (or parsed, for `ascii` files)
+	 * in parallel, directly into the point buffers.
+	 *
+	 * \return false on any error, described in `outErrorMsg` if provided or
+	 * printed to std::cerr otherwise.
+	 * \sa saveToPCDFile(), loadFromLASFile(), loadFromPlyFile()
+	 * \note (New in MRPT 2.4.3)
+	 */
+	bool loadFromPCDFile(
+		const std::string& file,
+		mrpt::optional_ref<std::string> outErrorMsg = std::nullopt);
+
+	/** Saves the point cloud as a PCL PCD file, with `binary` or `ascii`
+	 * data, and fields `x y z`, plus `intensity` (CPointsMapXYZI) or `rgb`
+	 * (CColouredPointsMap).
+	 * \return false on any error writing the file.
+	 * \sa loadFromPCDFile()
+	 * \note (New in MRPT 2.4.3)
+	 */
+	bool saveToPCDFile(const std::string& file, bool binary = true) const;
+
+	/** Loads the point cloud from an ASPRS LAS file (versions 1.0 to 1.4,
+	 * point formats 0 to 10), without requiring libLAS. LAZ (compressed)
+	 * files are not supported. Intensity and RGB are loaded as in
+	 * loadFromPCDFile(), normalized to [0,1] as 8-bit values if all of them
+	 * are below 256, or as 16-bit values otherwise.
+	 *
+	 * \note Coordinates are stored as `float`: use a LAS file offset close
+	 * to the points, or points far from the origin (e.g. UTM) will lose
+	 * precision.
+	 * \return false on any error, described in `outErrorMsg` if provided or
+	 * printed to std::cerr otherwise.
+	 * \sa saveToLASFile(), loadFromPCDFile()
+	 * \note (New in MRPT 2.4.3)
+	 */
+	bool loadFromLASFile(
+		const std::string& file,
+		mrpt::optional_ref<std::string> outErrorMsg = std::nullopt);
+
+	/** Saves the point cloud as an ASPRS LAS 1.2 file, with 1 mm resolution,
+	 * with point format 0 (with intensity, for CPointsMapXYZI) or 2 (for
+	 * CColouredPointsMap).
+	 * \return false on any error writing the file.
+	 * \sa loadFromLASFile()
+	 * \note (New in MRPT 2.4.3)
+	 */
+	bool saveToLASFile(const std::string& file) const;
+
+	/** Loads the point cloud from a PLY file. Files where the first element
+	 * is "vertex" and has no list properties (i.e. all point clouds) are
+	 * memory-mapped and decoded in parallel, directly into the point
+	 * buffers, loading `intensity` and `red green blue` as in
+	 * loadFromPCDFile() (8 and 16 bit integers are normalized to [0,1]).
+	 * Other files are loaded with
+	 * mrpt::opengl::PLY_Importer::loadFromPlyFile().
+	 * \return false on any error (see getLoadPLYErrorString()).
+	 * \note (New in MRPT 2.4.3: faster for binary and large PLY files)
+	 */
+	bool loadFromPlyFile(
+		const std::string& filename,
+		std::vector<std::string>* file_comments = nullptr,
+		std::vector<std::string>* file_obj_info = nullptr);
+
 	/** @} */  // End of: File input/output methods
 	// --------------------------------------------------
 
@@ -852,10 +926,12 @@ class CPointsMap : public CMetricMap,
 	 * and rotated according to the \a sensorPose field in the observation and,
 	 * if provided, to the \a robotPose parameter.
 	 *
-	 * \param scan The Raw LIDAR data to be inserted into this map. It MUST
-	 * contain point cloud data, generated by calling to \a
-	 * mrpt::obs::CObservationVelodyneScan::generatePointCloud() prior to
-	 * insertion in this map.
+	 * \param scan The Raw LIDAR data to be inserted into this map. If it
+	 * contains point cloud data (see \a
+	 * mrpt::obs::CObservationVelodyneScan::generatePointCloud()), it is used
+	 * as is. Otherwise, the raw packets are decoded straight into this map
+	 * with default mrpt::obs::CObservationVelodyneScan parameters, without
+	 * generating any intermediary point cloud (New in MRPT 2.4.3).
 	 * \param robotPose Default to (0,0,0|0deg,0deg,0deg). Changes the frame of
 	 * reference for the point cloud (i.e. the vehicle/robot pose in world
 	 * coordinates).
@@ -904,6 +980,35 @@ class CPointsMap : public CMetricMap,
 	void changeCoordinatesReference(
 		const CPointsMap& other, const mrpt::poses::CPose3D& b);
 
+	/** Motion compensation ("deskewing") of a cloud grabbed by a sensor that
+	 * moved while scanning (e.g. a rotating LIDAR on a vehicle). Each point,
+	 * given in the sensor frame at the time \a point_timestamps[i], is
+	 * transformed with the vehicle pose interpolated at that time from \a
+	 * vehicle_path, composed with \a sensorPose.
+	 *
+	 * The vehicle pose is interpolated once per distinct timestamp in
+	 * consecutive points (e.g. once per LIDAR packet or firing block), and
+	 * the cloud is split into chunks processed in parallel threads.
+	 *
+	 * \param[in] point_timestamps Time of each point. Must have size()
+	 * entries.
+	 * \param[in] vehicle_path The trajectory of the vehicle.
+	 * \param[in] sensorPose The pose of the sensor on the vehicle.
+	 * \param[in] referenceTime If provided, points end up expressed in the
+	 * frame of the vehicle at that time (which must be within \a
+	 * vehicle_path). Otherwise, in the frame of \a vehicle_path.
+	 * \return The number of points kept. Points for which no pose can be
+	 * interpolated are removed from the map.
+	 * \note (New in MRPT 2.4.3)
+	 * \sa mrpt::obs::CObservationVelodyneScan::generatePointCloudAlongSE3Trajectory
+	 */
+	size_t deskew(
+		const std::vector<mrpt::system::TTimeStamp>& point_timestamps,
+		const mrpt::poses::CPose3DInterpolator& vehicle_path,
+		const mrpt::poses::CPose3D& sensorPose = mrpt::poses::CPose3D(),
+		const std::optional<mrpt::system::TTimeStamp>& referenceTime =
+			std::nullopt);
+
 	/** Returns true if the map is empty/no observation has been inserted.
 	 */
 	bool isEmpty() const override;
@@ -133,6 +133,7 @@ void COccupancyGridMap2D::copyMapContentFrom(const COccupancyGridMap2D& o)
 
 	m_basis_map.clear();
 	m_voronoi_diagram.clear();
+	m_clearance_map.clear();
 
 	m_likelihoodCacheOutDated = true;
 	m_is_empty = o.m_is_empty;
@@ -188,6 +189,7 @@ void COccupancyGridMap2D::setSize(
 	// Free these buffers also:
 	m_basis_map.clear();
 	m_voronoi_diagram.clear();
+	m_clearance_map.clear();
 
 	m_is_empty = true;
 
@@ -311,6 +313,7 @@ void COccupancyGridMap2D::resizeGrid(
 	// Free the other buffers:
 	m_basis_map.clear();
 	m_voronoi_diagram.clear();
+	m_clearance_map.clear();
 }
 
 /*---------------------------------------------------------------
@@ -325,6 +328,7 @@ void COccupancyGridMap2D::freeMap()
 
 	m_basis_map.clear();
 	m_voronoi_diagram.clear();
+	m_clearance_map.clear();
 
 	size_x = size_y = 0;
 
@@ -434,6 +438,8 @@ void COccupancyGridMap2D::fill(float default_value)
 		*it = defValue;
 	// For the precomputed likelihood trick:
 	m_likelihoodCacheOutDated = true;
+	m_clearance_map.markChanged(
+		0, static_cast<int>(size_x) - 1, 0, static_cast<int>(size_y) - 1);
 }
 
 /*---------------------------------------------------------------
@@ -448,6 +454,7 @@ void COccupancyGridMap2D::updateCell(int x, int y, float v)
 
 	// Get the current contents of the cell:
 	cellType& theCell = map[x + y * size_x];
+	m_clearance_map.markChanged(x, x, y, y);
 
 	// Compute the new Bayesian-fused value of the cell:
 	if (updateInfoChangeOnly.enabled)
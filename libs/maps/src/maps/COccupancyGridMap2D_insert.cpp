@@ -54,6 +54,8 @@ bool COccupancyGridMap2D::internal_insertObservation(
 	// This is required to indicate the grid map has changed!
 	// For the precomputed likelihood trick:
 	m_likelihoodCacheOutDated = true;
+	m_clearance_map.markChanged(
+		0, static_cast<int>(size_x) - 1, 0, static_cast<int>(size_y) - 1);
 
 	if (robotPose)
 	{
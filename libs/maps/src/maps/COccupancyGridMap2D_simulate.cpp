@@ -9,6 +9,7 @@
 
 #include "maps-precomp.h"  // Precomp header
 //
+#include <mrpt/core/TaskScheduler.h>
 #include <mrpt/core/round.h>  // round()
 #include <mrpt/maps/COccupancyGridMap2D.h>
 #include <mrpt/math/CVectorFixed.h>
@@ -18,6 +19,8 @@
 #include <mrpt/random.h>
 
 #include <Eigen/Dense>
+#include <cmath>
+#include <limits>
 
 using namespace mrpt;
 using namespace mrpt::maps;
@@ -189,6 +192,9 @@ COccupancyGridMap2D::TLaserSimulUncertaintyParams::
 COccupancyGridMap2D::TLaserSimulUncertaintyResult::
 	TLaserSimulUncertaintyResult() = default;
 
+COccupancyGridMap2D::TLaserSimulBatchParams::TLaserSimulBatchParams() =
+	default;
+
 struct TFunctorLaserSimulData
 {
 	const COccupancyGridMap2D::TLaserSimulUncertaintyParams* params;
@@ -302,3 +308,107 @@ void COccupancyGridMap2D::laserScanSimulatorWithUncertainty(
 	out_results.scanWithUncert.rangesCovar.asEigen().diagonal().array() +=
 		0.5 * resolution * resolution;
 }
+
+void COccupancyGridMap2D::laserScanSimulatorBatch(
+	const TLaserSimulBatchParams& in_params,
+	const std::vector<CPose2D>& robotPoses,
+	std::vector<CObservation2DRangeScan>& out_scans) const
+{
+	MRPT_START
+
+	ASSERT_(in_params.decimation >= 1);
+	ASSERT_(in_params.nRays >= 2);
+
+	const size_t N = in_params.nRays;
+	const unsigned int D = in_params.decimation;
+	const float free_thres = 1.0f - in_params.threshold;
+	const bool useDF = in_params.method == rcmDistanceField;
+
+	if (useDF)
+	{
+		ASSERTMSG_(
+			hasClearanceMap() && m_clearance_map.threshold == p2l(free_thres),
+			"rcmDistanceField requires calling computeClearanceMap() first, "
+			"with the same threshold, and updateClearanceMap() after "
+			"modifying cells");
+	}
+	else
+	{
+		ASSERTMSG_(in_params.method == rcmStepping, "Unknown `method` value");
+	}
+
+	const double AA =
+		(in_params.rightToLeft ? 1.0 : -1.0) * (in_params.aperture / (N - 1));
+
+	// Sphere tracing on the clearance map. Distances there are between cell
+	// centers, so a ray point is at least sqrt(d2)-sqrt(2) cells away from
+	// the boundary of any obstacle cell.
+	constexpr uint32_t EDT_INF = std::numeric_limits<uint32_t>::max();
+	constexpr double SQRT2 = 1.4142135623730951;
+	const double minStep = RAYTRACE_STEP_SIZE_IN_CELL_UNITS;
+	const double maxLen = in_params.maxRange / resolution;
+	const auto traceDF = [&](double x, double y, double dir, float& range,
+							 bool& valid) {
+		const double x0 = (x - x_min) / resolution;
+		const double y0 = (y - y_min) / resolution;
+		const double dx = std::cos(dir), dy = std::sin(dir);
+
+		range = in_params.maxRange;
+		valid = false;
+		for (double t = 0;;)
+		{
+			const double cx = x0 + t * dx, cy = y0 + t * dy;
+			if (cx < 0 || cy < 0 || cx >= size_x || cy >= size_y) return;
+			const size_t idx = static_cast<size_t>(cx) +
+				static_cast<size_t>(cy) * size_x;
+			const uint32_t d2 = m_clearance_map.sqDist[idx];
+			if (d2 == 0)
+			{
+				if (std::abs(map[idx]) <= 1) return;
+				range = static_cast<float>(t * resolution);
+				valid = true;
+				return;
+			}
+			if (d2 == EDT_INF) return;	// No obstacles at all
+
+			t += std::max(std::sqrt(double(d2)) - SQRT2, minStep);
+			if (t >= maxLen) return;
+		}
+	};
+
+	out_scans.resize(robotPoses.size());
+
+	mrpt::parallel_for(0, robotPoses.size(), 1, [&](size_t p0, size_t p1) {
+		for (size_t p = p0; p < p1; p++)
+		{
+			auto& scan = out_scans[p];
+			scan.aperture = in_params.aperture;
+			scan.maxRange = in_params.maxRange;
+			scan.rightToLeft = in_params.rightToLeft;
+			scan.sensorPose = in_params.sensorPose;
+			scan.resizeScanAndAssign(N, in_params.maxRange, false);
+
+			// Same as in laserScanSimulator():
+			const auto sensorPose =
+				CPose2D(CPose3D(robotPoses[p]) + in_params.sensorPose);
+			double A = sensorPose.phi() +
+				(in_params.rightToLeft ? -0.5 : +0.5) * in_params.aperture;
+
+			for (size_t i = 0; i < N; i += D, A += AA * D)
+			{
+				bool valid;
+				float range;
+				if (useDF)
+					traceDF(sensorPose.x(), sensorPose.y(), A, range, valid);
+				else
+					simulateScanRay(
+						sensorPose.x(), sensorPose.y(), A, range, valid,
+						in_params.maxRange, free_thres);
+				scan.setScanRange(i, range);
+				scan.setScanRangeValidity(i, valid);
+			}
+		}
+	});
+
+	MRPT_END
+}
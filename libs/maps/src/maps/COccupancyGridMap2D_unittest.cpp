@@ -8,10 +8,16 @@
    +------------------------------------------------------------------------+ */
 
 #include <gtest/gtest.h>
+#include <mrpt/core/round.h>
 #include <mrpt/maps/COccupancyGridMap2D.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/obs/stock_observations.h>
 
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
 using namespace mrpt;
 using namespace mrpt::maps;
 using namespace mrpt::obs;
@@ -33,3 +39,221 @@ TEST(COccupancyGridMap2DTests, insert2DScan)
 		// should have a high "freeness"
 	}
 }
+
+TEST(COccupancyGridMap2DTests, clearanceMap)
+{
+	COccupancyGridMap2D grid(-3.0f, 3.0f, -2.0f, 2.0f, 0.10f);
+	const int sx = grid.getSizeX(), sy = grid.getSizeY();
+
+	const auto checkAgainstBruteForce = [&]() {
+		for (int cy = 0; cy < sy; cy++)
+			for (int cx = 0; cx < sx; cx++)
+			{
+				float d = std::numeric_limits<float>::max();
+				for (int oy = 0; oy < sy; oy++)
+					for (int ox = 0; ox < sx; ox++)
+						if (grid.getCell(ox, oy) < 0.5f)
+							d = std::min(
+								d,
+								grid.getResolution() *
+									std::sqrt(float(
+										square(ox - cx) + square(oy - cy))));
+				EXPECT_NEAR(grid.getClearanceMapDistance(cx, cy), d, 1e-4f)
+					<< "cx=" << cx << " cy=" << cy;
+			}
+	};
+
+	// No obstacles at all:
+	grid.computeClearanceMap();
+	checkAgainstBruteForce();
+
+	// A few obstacles:
+	grid.setCell(10, 10, 0.0f);
+	grid.setCell(50, 30, 0.0f);
+	grid.setCell(55, 35, 0.0f);
+	grid.computeClearanceMap();
+	checkAgainstBruteForce();
+
+	int ox = 0, oy = 0;
+	EXPECT_TRUE(grid.getClearanceMapClosestObstacle(45, 28, ox, oy));
+	EXPECT_EQ(ox, 50);
+	EXPECT_EQ(oy, 30);
+
+	// Incremental updates, adding and removing obstacles:
+	for (int x = 20; x <= 25; x++)
+		grid.setCell(x, 30, 0.0f);
+	grid.updateClearanceMap(20, 25, 30, 30);
+	checkAgainstBruteForce();
+
+	grid.setCell(50, 30, 1.0f);
+	grid.updateClearanceMap(50, 50, 30, 30);
+	checkAgainstBruteForce();
+
+	// Cells modified out of the given rectangle make the map outdated, and
+	// are included in the next update anyway:
+	grid.setCell(5, 5, 0.0f);
+	grid.updateCell(40, 10, 0.01f);
+	EXPECT_FALSE(grid.hasClearanceMap());
+	EXPECT_ANY_THROW(grid.getClearanceMapDistance(0, 0));
+	grid.updateClearanceMap(0, -1, 0, -1);
+	EXPECT_TRUE(grid.hasClearanceMap());
+	checkAgainstBruteForce();
+
+	mrpt::obs::CObservation2DRangeScan scan;
+	stock_observations::example2DRangeScan(scan);
+	grid.insertionOptions.maxDistanceInsertion = 0.4f;	// Do not grow the grid
+	grid.insertObservation(scan);
+	ASSERT_EQ(int(grid.getSizeX()), sx);
+	ASSERT_EQ(int(grid.getSizeY()), sy);
+	EXPECT_FALSE(grid.hasClearanceMap());
+	grid.updateClearanceMap(0, -1, 0, -1);
+	checkAgainstBruteForce();
+}
+
+TEST(COccupancyGridMap2DTests, voronoiDiagram)
+{
+	// Checks that Voronoi cells have the exact clearance (saturated to
+	// uint16_t) of the given obstacles:
+	const auto checkVoronoi = [](const COccupancyGridMap2D& grid,
+								 const std::vector<std::pair<int, int>>& obs) {
+		constexpr int maxClearance = std::numeric_limits<uint16_t>::max();
+		size_t nVoronoi = 0, nSaturated = 0;
+		for (int cy = 0; cy < int(grid.getSizeY()); cy++)
+			for (int cx = 0; cx < int(grid.getSizeX()); cx++)
+			{
+				const uint16_t c = grid.getVoroniClearance(cx, cy);
+				if (!c) continue;
+				nVoronoi++;
+				double d = std::numeric_limits<double>::max();
+				for (const auto& o : obs)
+					d = std::min(
+						d,
+						std::sqrt(double(
+							square(o.first - cx) + square(o.second - cy))));
+				EXPECT_EQ(c, std::min(mrpt::round(100 * d), maxClearance))
+					<< "cx=" << cx << " cy=" << cy;
+				if (c == maxClearance) nSaturated++;
+			}
+		EXPECT_GT(nVoronoi, 0U);
+		return nSaturated;
+	};
+
+	// A corridor: its Voronoi diagram is the center line.
+	{
+		COccupancyGridMap2D grid(-3.0f, 3.0f, -1.0f, 1.05f, 0.10f);
+		grid.fill(1.0f);
+		const int sx = grid.getSizeX(), sy = grid.getSizeY();
+		std::vector<std::pair<int, int>> obs;
+		for (int cx = 0; cx < sx; cx++)
+			for (const int cy : {0, sy - 1})
+			{
+				grid.setCell(cx, cy, 0.0f);
+				obs.emplace_back(cx, cy);
+			}
+		grid.buildVoronoiDiagram(0.5f, 0.0f);
+		EXPECT_EQ(checkVoronoi(grid, obs), 0U);
+
+		for (int cy = 0; cy < sy; cy++)
+			for (int cx = 0; cx < sx; cx++)
+				if (grid.getVoroniClearance(cx, cy))
+					EXPECT_LE(std::abs(2 * cy - (sy - 1)), 2) << "cy=" << cy;
+	}
+
+	// Two obstacles further apart than the largest clearance that fits in
+	// uint16_t (655.35 cells):
+	{
+		COccupancyGridMap2D grid(-71.0f, 71.0f, -0.1f, 0.1f, 0.10f);
+		grid.fill(1.0f);
+		const int sx = grid.getSizeX(), sy = grid.getSizeY();
+		ASSERT_GT(sx, 1400);
+		std::vector<std::pair<int, int>> obs;
+		for (int cy = 0; cy < sy; cy++)
+			for (const int cx : {0, sx - 1})
+			{
+				grid.setCell(cx, cy, 0.0f);
+				obs.emplace_back(cx, cy);
+			}
+		grid.buildVoronoiDiagram(0.5f, 0.0f);
+		EXPECT_GT(checkVoronoi(grid, obs), 0U);
+	}
+}
+
+TEST(COccupancyGridMap2DTests, laserScanSimulatorBatch)
+{
+	// A 10x10m room with thick walls and a square pillar:
+	COccupancyGridMap2D grid(-5.0f, 5.0f, -5.0f, 5.0f, 0.05f);
+	const auto fillRect = [&](float x0, float y0, float x1, float y1,
+							  float p) {
+		for (int cy = grid.y2idx(y0); cy <= grid.y2idx(y1); cy++)
+			for (int cx = grid.x2idx(x0); cx <= grid.x2idx(x1); cx++)
+				grid.setCell(cx, cy, p);
+	};
+	fillRect(-5.0f, -5.0f, 4.99f, 4.99f, 1.0f);
+	fillRect(-5.0f, -5.0f, 4.99f, -4.85f, 0.0f);
+	fillRect(-5.0f, 4.85f, 4.99f, 4.99f, 0.0f);
+	fillRect(-5.0f, -5.0f, -4.85f, 4.99f, 0.0f);
+	fillRect(4.85f, -5.0f, 4.99f, 4.99f, 0.0f);
+	fillRect(2.0f, 2.0f, 3.0f, 3.0f, 0.0f);
+
+	std::vector<CPose2D> poses;
+	for (int i = 0; i < 50; i++)
+		poses.emplace_back(
+			-4.0 + 0.13 * i, -3.5 + 0.11 * i, mrpt::DEG2RAD(7.0 * i));
+
+	COccupancyGridMap2D::TLaserSimulBatchParams p;
+	p.maxRange = 20.0f;
+	p.nRays = 181;
+
+	// Stepping: identical to laserScanSimulator()
+	std::vector<CObservation2DRangeScan> scans;
+	grid.laserScanSimulatorBatch(p, poses, scans);
+	ASSERT_EQ(scans.size(), poses.size());
+	for (size_t i = 0; i < poses.size(); i++)
+	{
+		CObservation2DRangeScan scan;
+		scan.aperture = p.aperture;
+		scan.maxRange = p.maxRange;
+		grid.laserScanSimulator(scan, poses[i], p.threshold, p.nRays);
+
+		ASSERT_EQ(scans[i].getScanSize(), p.nRays);
+		for (size_t k = 0; k < p.nRays; k++)
+		{
+			EXPECT_EQ(scans[i].getScanRange(k), scan.getScanRange(k));
+			EXPECT_EQ(
+				scans[i].getScanRangeValidity(k),
+				scan.getScanRangeValidity(k));
+		}
+	}
+
+	// Distance field: requires the clearance map
+	p.method = COccupancyGridMap2D::rcmDistanceField;
+	std::vector<CObservation2DRangeScan> scansDF;
+	EXPECT_ANY_THROW(grid.laserScanSimulatorBatch(p, poses, scansDF));
+
+	grid.computeClearanceMap(p.threshold);
+	grid.laserScanSimulatorBatch(p, poses, scansDF);
+	ASSERT_EQ(scansDF.size(), poses.size());
+
+	// Same hits up to two cells, except for a few rays grazing corners:
+	size_t nRays = 0, nFar = 0;
+	for (size_t i = 0; i < poses.size(); i++)
+		for (size_t k = 0; k < p.nRays; k++, nRays++)
+		{
+			ASSERT_TRUE(scans[i].getScanRangeValidity(k));
+			EXPECT_TRUE(scansDF[i].getScanRangeValidity(k));
+			if (std::abs(
+					scans[i].getScanRange(k) - scansDF[i].getScanRange(k)) >
+				2 * grid.getResolution())
+				nFar++;
+		}
+	EXPECT_LT(nFar, nRays / 100);
+
+	// Modified cells make the clearance map outdated until it is updated:
+	const int cx = grid.x2idx(0.0f), cy = grid.y2idx(0.0f);
+	grid.setCell(cx, cy, 0.0f);
+	EXPECT_ANY_THROW(grid.laserScanSimulatorBatch(p, poses, scansDF));
+	grid.updateClearanceMap(cx, cx, cy, cy);
+	grid.laserScanSimulatorBatch(p, poses, scansDF);
+	ASSERT_EQ(scansDF.size(), poses.size());
+	EXPECT_TRUE(scansDF[0].getScanRangeValidity(0));
+}
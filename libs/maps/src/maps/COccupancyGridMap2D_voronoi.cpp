@@ -9,15 +9,284 @@
 
 #include "maps-precomp.h"  // Precomp header
 //
+#include <mrpt/core/TaskScheduler.h>
 #include <mrpt/core/round.h>  // round()
 #include <mrpt/maps/COccupancyGridMap2D.h>
 
+#include <atomic>
+#include <limits>
+
 using namespace mrpt;
 using namespace mrpt::maps;
 using namespace mrpt::obs;
 using namespace mrpt::poses;
 using namespace std;
 
+namespace
+{
+constexpr uint32_t EDT_INF = std::numeric_limits<uint32_t>::max();
+
+/** Runs `f(i0,i1)` over [0,n) split in contiguous chunks of up to 64 items,
+ * in the shared mrpt::TaskScheduler. */
+template <typename FUNCTOR>
+void runInParallelChunks(int n, const FUNCTOR& f)
+{
+	mrpt::parallel_for(0, std::max(0, n), 64, [&](size_t i0, size_t i1) {
+		f(static_cast<int>(i0), static_cast<int>(i1));
+	});
+}
+
+/** 1D squared distance transform of the sampled function f[0:n-1] (EDT_INF
+ * for "no obstacle"), via the lower envelope of parabolas (Felzenszwalb &
+ * Huttenlocher, 2012). Outputs the transform in `d` and the index of the
+ * minimizing sample in `arg` (-1 if all samples are EDT_INF).
+ * `v` and `z` are working buffers of n and n+1 elements. */
+void edt1D(
+	const uint32_t* f, int n, uint32_t* d, int32_t* arg, int* v, double* z)
+{
+	int k = -1;
+	for (int q = 0; q < n; q++)
+	{
+		if (f[q] == EDT_INF) continue;
+		const double fq = double(f[q]) + double(q) * q;
+		double s = -std::numeric_limits<double>::infinity();
+		while (k >= 0)
+		{
+			const int vk = v[k];
+			s = (fq - (double(f[vk]) + double(vk) * vk)) / (2.0 * (q - vk));
+			if (s <= z[k]) --k;
+			else
+				break;
+		}
+		++k;
+		v[k] = q;
+		z[k] = (k == 0) ? -std::numeric_limits<double>::infinity() : s;
+		z[k + 1] = std::numeric_limits<double>::infinity();
+	}
+	if (k < 0)
+	{
+		for (int q = 0; q < n; q++)
+		{
+			d[q] = EDT_INF;
+			arg[q] = -1;
+		}
+		return;
+	}
+	int j = 0;
+	for (int q = 0; q < n; q++)
+	{
+		while (z[j + 1] < q)
+			j++;
+		const int64_t dq = int64_t(q - v[j]) * (q - v[j]) + f[v[j]];
+		d[q] = static_cast<uint32_t>(std::min<int64_t>(dq, EDT_INF - 1));
+		arg[q] = v[j];
+	}
+}
+}  // namespace
+
+/*---------------------------------------------------------------
+				computeClearanceMapWindow
+  ---------------------------------------------------------------*/
+bool COccupancyGridMap2D::computeClearanceMapWindow(
+	const std::array<int, 4>& win, const std::array<int, 4>& out)
+{
+	const int wx1 = win[0], wx2 = win[1], wy1 = win[2], wy2 = win[3];
+	const int w = wx2 - wx1 + 1, h = wy2 - wy1 + 1;
+	const cellType thr = m_clearance_map.threshold;
+
+	// 1st pass, along rows: squared horizontal distance to the closest
+	// obstacle within each row, and its "x" index:
+	std::vector<uint32_t> rowSqDist(w * h);
+	std::vector<int32_t> rowClosestX(w * h);
+
+	runInParallelChunks(h, [&](int r0, int r1) {
+		std::vector<int> v(w);
+		std::vector<double> z(w + 1);
+		std::vector<uint32_t> f(w);
+		for (int r = r0; r < r1; r++)
+		{
+			const cellType* row = &map[wx1 + (wy1 + r) * size_x];
+			for (int i = 0; i < w; i++)
+				f[i] = row[i] < thr ? 0 : EDT_INF;
+			edt1D(
+				f.data(), w, &rowSqDist[r * w], &rowClosestX[r * w], v.data(),
+				z.data());
+		}
+	});
+
+	// 2nd pass, along columns:
+	const int ox1 = out[0], ox2 = out[1], oy1 = out[2], oy2 = out[3];
+	std::atomic_bool isExact{true};
+
+	runInParallelChunks(w, [&](int c0, int c1) {
+		std::vector<int> v(h);
+		std::vector<double> z(h + 1);
+		std::vector<uint32_t> f(h), d(h);
+		std::vector<int32_t> arg(h);
+		bool chunkExact = true;
+		for (int c = c0; c < c1; c++)
+		{
+			const int cx = wx1 + c;
+			if (cx < ox1 || cx > ox2) continue;
+			for (int r = 0; r < h; r++)
+				f[r] = rowSqDist[c + r * w];
+			edt1D(f.data(), h, d.data(), arg.data(), v.data(), z.data());
+
+			for (int cy = oy1; cy <= oy2; cy++)
+			{
+				const int r = cy - wy1;
+				const int idx = cx + cy * size_x;
+				m_clearance_map.sqDist[idx] = d[r];
+				m_clearance_map.closest[idx] = arg[r] < 0
+					? -1
+					: (wx1 + rowClosestX[c + arg[r] * w]) +
+						(wy1 + arg[r]) * static_cast<int>(size_x);
+
+				// Could an obstacle out of the window be closer?
+				int64_t distOut = std::numeric_limits<int64_t>::max();
+				if (wx1 > 0) distOut = std::min<int64_t>(distOut, cx - wx1 + 1);
+				if (wy1 > 0) distOut = std::min<int64_t>(distOut, cy - wy1 + 1);
+				if (wx2 < static_cast<int>(size_x) - 1)
+					distOut = std::min<int64_t>(distOut, wx2 - cx + 1);
+				if (wy2 < static_cast<int>(size_y) - 1)
+					distOut = std::min<int64_t>(distOut, wy2 - cy + 1);
+				if (distOut != std::numeric_limits<int64_t>::max() &&
+					(d[r] == EDT_INF || int64_t(d[r]) > distOut * distOut))
+					chunkExact = false;
+			}
+		}
+		if (!chunkExact) isExact = false;
+	});
+
+	return isExact;
+}
+
+/*---------------------------------------------------------------
+				computeClearanceMap
+  ---------------------------------------------------------------*/
+void COccupancyGridMap2D::computeClearanceMap(float threshold)
+{
+	MRPT_START
+
+	m_clearance_map.size_x = size_x;
+	m_clearance_map.size_y = size_y;
+	m_clearance_map.threshold = p2l(1.0f - threshold);
+	m_clearance_map.sqDist.assign(size_x * size_y, EDT_INF);
+	m_clearance_map.closest.assign(size_x * size_y, -1);
+	m_clearance_map.changed = {{0, -1, 0, -1}};
+	if (!size_x || !size_y) return;
+
+	const std::array<int, 4> all = {
+		0, static_cast<int>(size_x) - 1, 0, static_cast<int>(size_y) - 1};
+	computeClearanceMapWindow(all, all);
+
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+				updateClearanceMap
+  ---------------------------------------------------------------*/
+std::array<int, 4> COccupancyGridMap2D::updateClearanceMap(
+	int x1, int x2, int y1, int y2)
+{
+	MRPT_START
+
+	const int sx = static_cast<int>(size_x), sy = static_cast<int>(size_y);
+	const std::array<int, 4> all = {0, sx - 1, 0, sy - 1};
+
+	if (!m_clearance_map.sizeMatches(size_x, size_y))
+	{
+		computeClearanceMap(
+			m_clearance_map.empty() ? 0.5f
+									: 1.0f - l2p(m_clearance_map.threshold));
+		return all;
+	}
+
+	// Also include the cells modified since the last update:
+	if (x1 <= x2 && y1 <= y2) m_clearance_map.markChanged(x1, x2, y1, y2);
+	const auto changed = m_clearance_map.changed;
+	m_clearance_map.changed = {{0, -1, 0, -1}};
+	x1 = changed[0];
+	x2 = changed[1];
+	y1 = changed[2];
+	y2 = changed[3];
+
+	x1 = std::max(0, x1);
+	y1 = std::max(0, y1);
+	x2 = std::min(x2, sx - 1);
+	y2 = std::min(y2, sy - 1);
+	if (x1 > x2 || y1 > y2) return {0, -1, 0, -1};
+
+	// Expand the rectangle of changed cells by R, with R bounding the old
+	// clearance of any cell whose clearance may change. Since the
+	// distance transform is 1-Lipschitz, this is satisfied once R exceeds
+	// (plus a discretization margin) the largest old clearance within the
+	// expanded rectangle itself:
+	const auto expand = [&](int r) -> std::array<int, 4> {
+		return {
+			std::max(0, x1 - r), std::min(sx - 1, x2 + r), std::max(0, y1 - r),
+			std::min(sy - 1, y2 + r)};
+	};
+	int R = 0;
+	std::array<int, 4> affected = expand(R);
+	for (;;)
+	{
+		uint32_t maxSqDist = 0;
+		for (int cy = affected[2]; cy <= affected[3]; cy++)
+			for (int cx = affected[0]; cx <= affected[1]; cx++)
+				maxSqDist = std::max(
+					maxSqDist, m_clearance_map.sqDist[cx + cy * size_x]);
+
+		if (maxSqDist == EDT_INF || affected == all)
+		{
+			affected = all;
+			break;
+		}
+		const int maxClearance =
+			static_cast<int>(std::ceil(std::sqrt(double(maxSqDist)))) + 2;
+		if (R >= maxClearance) break;
+		R = maxClearance;
+		affected = expand(R);
+	}
+
+	// Recompute within a window around the affected area, enlarging it
+	// until no obstacle out of it could be closer than those found inside:
+	for (int margin = std::max(R, 1);; margin *= 2)
+	{
+		const std::array<int, 4> win = {
+			std::max(0, affected[0] - margin),
+			std::min(sx - 1, affected[1] + margin),
+			std::max(0, affected[2] - margin),
+			std::min(sy - 1, affected[3] + margin)};
+		if (computeClearanceMapWindow(win, affected) || win == all) break;
+	}
+
+	return affected;
+
+	MRPT_END
+}
+
+float COccupancyGridMap2D::getClearanceMapDistance(int cx, int cy) const
+{
+	ASSERT_(hasClearanceMap());
+	ASSERT_(cx >= 0 && cy >= 0 && cx < int(size_x) && cy < int(size_y));
+	const uint32_t d2 = m_clearance_map.sqDist[cx + cy * size_x];
+	if (d2 == EDT_INF) return std::numeric_limits<float>::max();
+	return resolution * std::sqrt(static_cast<float>(d2));
+}
+
+bool COccupancyGridMap2D::getClearanceMapClosestObstacle(
+	int cx, int cy, int& ox, int& oy) const
+{
+	ASSERT_(hasClearanceMap());
+	ASSERT_(cx >= 0 && cy >= 0 && cx < int(size_x) && cy < int(size_y));
+	const int32_t idx = m_clearance_map.closest[cx + cy * size_x];
+	if (idx < 0) return false;
+	ox = idx % static_cast<int>(size_x);
+	oy = idx / static_cast<int>(size_x);
+	return true;
+}
+
 /*---------------------------------------------------------------
 				Build_VoronoiDiagram
   ---------------------------------------------------------------*/
@@ -39,7 +308,7 @@ void COccupancyGridMap2D::buildVoronoiDiagram(
 		y2 = min(y2, static_cast<int>(size_y) - 1);
 	}
 
-	int robot_size_units = round(100 * robot_size / resolution);
+	m_voronoi_robot_size_units = round(100 * robot_size / resolution);
 
 	/* We store 0 in cells NOT belonging to Voronoi, or the closest distance
 	 * to obstacle otherwise, the "clearance" in "int" distance units.
@@ -53,21 +322,99 @@ void COccupancyGridMap2D::buildVoronoiDiagram(
 	// freeness threshold
 	voroni_free_threshold = 1.0f - threshold;
 
-	int basis_x[2], basis_y[2];
-	int nBasis;
+	// Clearance of all cells, via an exact Euclidean distance transform:
+	computeClearanceMap(threshold);
 
-	// Build Voronoi:
-	for (int x = x1; x <= x2; x++)
+	updateVoronoiCells(x1, x2, y1, y2);
+}
+
+/*---------------------------------------------------------------
+				updateVoronoiDiagram
+  ---------------------------------------------------------------*/
+void COccupancyGridMap2D::updateVoronoiDiagram(int x1, int x2, int y1, int y2)
+{
+	if (!m_clearance_map.sizeMatches(size_x, size_y) ||
+		m_voronoi_diagram.getSizeX() != size_x ||
+		m_voronoi_diagram.getSizeY() != size_y)
 	{
-		for (int y = y1; y <= y2; y++)
+		buildVoronoiDiagram(
+			1.0f - voroni_free_threshold,
+			m_voronoi_robot_size_units * resolution / 100.0f);
+		return;
+	}
+
+	const auto changed = updateClearanceMap(x1, x2, y1, y2);
+	if (changed[0] > changed[1] || changed[2] > changed[3]) return;
+
+	// Voronoi membership depends on the closest obstacles of each cell and its
+	// neighbors; thinning on the membership of neighbors:
+	const int sx = static_cast<int>(size_x), sy = static_cast<int>(size_y);
+	const int rx1 = std::max(0, changed[0] - 2),
+			  rx2 = std::min(sx - 1, changed[1] + 2);
+	const int ry1 = std::max(0, changed[2] - 2),
+			  ry2 = std::min(sy - 1, changed[3] + 2);
+	for (int y = ry1; y <= ry2; y++)
+		for (int x = rx1; x <= rx2; x++)
+			setVoroniClearance(x, y, 0);
+
+	updateVoronoiCells(rx1, rx2, ry1, ry2);
+}
+
+/*---------------------------------------------------------------
+				updateVoronoiCells
+  ---------------------------------------------------------------*/
+void COccupancyGridMap2D::updateVoronoiCells(int x1, int x2, int y1, int y2)
+{
+	const int sx = static_cast<int>(size_x), sy = static_cast<int>(size_y);
+	const auto& sqDist = m_clearance_map.sqDist;
+	const auto& closest = m_clearance_map.closest;
+
+	// A free cell belongs to the Voronoi diagram if one of its neighbors has
+	// its closest obstacle far apart from the closest obstacle of the cell
+	// (the two "basis" points of the cell):
+	runInParallelChunks(y2 - y1 + 1, [&](int r0, int r1) {
+		for (int y = y1 + r0; y < y1 + r1; y++)
 		{
-			const int Clearance =
-				computeClearance(x, y, basis_x, basis_y, &nBasis);
+			for (int x = x1; x <= x2; x++)
+			{
+				const int idx = x + y * sx;
+				const uint32_t d2 = sqDist[idx];
+				if (d2 == 0 || d2 == EDT_INF) continue;
 
-			if (Clearance > robot_size_units)
-				setVoroniClearance(x, y, Clearance);
+				const int Clearance = round(100 * std::sqrt(double(d2)));
+				if (Clearance <= m_voronoi_robot_size_units) continue;
+
+				const int bx = closest[idx] % sx, by = closest[idx] / sx;
+				// Same criterion than computeClearance(): the two basis must
+				// be separated more than 1.75 times the clearance:
+				const double minBasisSqDist = square(1.75) * d2;
+
+				bool isVoronoi = false;
+				for (int yy = y - 1; !isVoronoi && yy <= y + 1; yy++)
+				{
+					if (yy < 0 || yy >= sy) continue;
+					for (int xx = x - 1; !isVoronoi && xx <= x + 1; xx++)
+					{
+						if (xx < 0 || xx >= sx || (xx == x && yy == y))
+							continue;
+						const int nIdx = xx + yy * sx;
+						if (closest[nIdx] < 0 || sqDist[nIdx] > d2) continue;
+						const int nbx = closest[nIdx] % sx,
+								  nby = closest[nIdx] / sx;
+						if (square(nbx - bx) + square(nby - by) >
+							minBasisSqDist)
+							isVoronoi = true;
+					}
+				}
+				// (Clearances are stored as uint16_t: saturate very large ones)
+				if (isVoronoi)
+					setVoroniClearance(
+						x, y,
+						static_cast<uint16_t>(std::min<int>(
+							Clearance, std::numeric_limits<uint16_t>::max())));
+			}
 		}
-	}
+	});
 
 	// Limpiar: Hacer que los trazos sean de grosor 1:
 	//  Si un punto del diagrama esta rodeada de mas de 2
@@ -82,7 +429,9 @@ void COccupancyGridMap2D::buildVoronoiDiagram(
 				nDiag = 0;
 				for (int xx = x - 1; xx <= (x + 1); xx++)
 					for (int yy = y - 1; yy <= (y + 1); yy++)
-						if (getVoroniClearance(xx, yy)) nDiag++;
+						if (xx >= 0 && yy >= 0 && xx < sx && yy < sy &&
+							getVoroniClearance(xx, yy))
+							nDiag++;
 
 				// Eliminar?
 				if (nDiag > 3) setVoroniClearance(x, y, 0);
@@ -12,6 +12,7 @@
 #include <mrpt/config/CConfigFile.h>
 #include <mrpt/core/SSE_macros.h>
 #include <mrpt/core/SSE_types.h>
+#include <mrpt/core/TaskScheduler.h>
 #include <mrpt/maps/CPointsMap.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/math/TPose2D.h>
@@ -23,12 +24,12 @@
 #include <mrpt/obs/CObservationVelodyneScan.h>
 #include <mrpt/opengl/CPointCloud.h>
 #include <mrpt/opengl/CPointCloudColoured.h>
+#include <mrpt/poses/CPose3DInterpolator.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/CTicTac.h>
 #include <mrpt/system/CTimeLogger.h>
 #include <mrpt/system/os.h>
 
-#include <fstream>
 #include <sstream>
 
 #if MRPT_HAS_MATLAB
@@ -142,23 +143,6 @@ bool CPointsMap::load2Dor3D_from_text_stream(
 	MRPT_END
 }
 
-bool CPointsMap::load2Dor3D_from_text_file(
-	const std::string& file, const bool is_3D)
-{
-	MRPT_START
-
-	// Clear current map:
-	mark_as_modified();
-	this->clear();
-
-	std::ifstream fi(file);
-	if (!fi.is_open()) return false;
-
-	return load2Dor3D_from_text_stream(fi, std::nullopt, is_3D);
-
-	MRPT_END
-}
-
 /*---------------------------------------------------------------
   Implements the writing to a mxArray for Matlab
  ---------------------------------------------------------------*/
@@ -576,6 +560,80 @@ void CPointsMap::changeCoordinatesReference(
 	changeCoordinatesReference(newBase);
 }
 
+size_t CPointsMap::deskew(
+	const std::vector<mrpt::system::TTimeStamp>& point_timestamps,
+	const mrpt::poses::CPose3DInterpolator& vehicle_path,
+	const CPose3D& sensorPose,
+	const std::optional<mrpt::system::TTimeStamp>& referenceTime)
+{
+	MRPT_START
+
+	const size_t N = m_x.size();
+	ASSERT_EQUAL_(point_timestamps.size(), N);
+
+	// Optional change of frame, from the path frame to the vehicle frame at
+	// the reference time:
+	CPose3D refInverse;
+	if (referenceTime)
+	{
+		CPose3D refPose;
+		bool valid;
+		vehicle_path.interpolate(*referenceTime, refPose, valid);
+		ASSERTMSG_(
+			valid, "Cannot interpolate the vehicle pose at referenceTime");
+		refInverse = -refPose;
+	}
+
+	// Points without a valid pose (bytes, not vector<bool>, since several
+	// threads write to it):
+	std::vector<uint8_t> invalid(N, 0);
+
+	auto processRange = [&](size_t i0, size_t i1) {
+		mrpt::system::TTimeStamp lastTim = INVALID_TIMESTAMP;
+		bool lastValid = false;
+		CPose3D vehPose, p(mrpt::poses::UNINITIALIZED_POSE);
+		mrpt::math::CMatrixDouble33 R;
+		mrpt::math::TPoint3D t;
+
+		for (size_t i = i0; i < i1; i++)
+		{
+			// Interpolate once per run of equal timestamps:
+			if (i == i0 || point_timestamps[i] != lastTim)
+			{
+				lastTim = point_timestamps[i];
+				vehicle_path.interpolate(lastTim, vehPose, lastValid);
+				if (lastValid)
+				{
+					p = refInverse + vehPose + sensorPose;
+					R = p.getRotationMatrix();
+					t = p.translation();
+				}
+			}
+			if (!lastValid)
+			{
+				invalid[i] = 1;
+				continue;
+			}
+			const double lx = m_x[i], ly = m_y[i], lz = m_z[i];
+			m_x[i] = d2f(R(0, 0) * lx + R(0, 1) * ly + R(0, 2) * lz + t.x);
+			m_y[i] = d2f(R(1, 0) * lx + R(1, 1) * ly + R(1, 2) * lz + t.y);
+			m_z[i] = d2f(R(2, 0) * lx + R(2, 1) * ly + R(2, 2) * lz + t.z);
+		}
+	};
+
+	mrpt::parallel_for(0, N, 8192 /*grain*/, processRange);
+
+	mark_as_modified();
+
+	const size_t nInvalid = std::count(invalid.begin(), invalid.end(), 1);
+	if (nInvalid)
+		applyDeletionMask(std::vector<bool>(invalid.begin(), invalid.end()));
+
+	return N - nInvalid;
+
+	MRPT_END
+}
+
 /*---------------------------------------------------------------
 				isEmpty
  ---------------------------------------------------------------*/
@@ -1917,10 +1975,8 @@ bool CPointsMap::internal_insertObservation(
 
 		const auto& o = static_cast<const CObservationVelodyneScan&>(obs);
 
-		// Automatically generate pointcloud if needed:
-		if (!o.point_cloud.size())
-			const_cast<CObservationVelodyneScan&>(o).generatePointCloud();
-
+		// Note: if the pointcloud has not been generated, raw packets are
+		// decoded straight into the map by loadFromVelodyneScan().
 		if (insertionOptions.fuseWithExisting)
 		{
 			// Fuse:
@@ -2066,6 +2122,53 @@ void CPointsMap::fuseWith(
 	}
 }
 
+namespace
+{
+/** Decodes Velodyne raw packets straight into a points map, transforming
+ * each point with the sensor global pose on the fly. */
+struct PointCloudStorageWrapper_PointsMap
+	: public CObservationVelodyneScan::PointCloudStorageWrapper
+{
+	CPointsMap& map_;
+	double m00, m01, m02, m03, m10, m11, m12, m13, m20, m21, m22, m23;
+
+	PointCloudStorageWrapper_PointsMap(
+		CPointsMap& map, const mrpt::math::CMatrixDouble44& HM)
+		: map_(map),
+		  m00(HM(0, 0)),
+		  m01(HM(0, 1)),
+		  m02(HM(0, 2)),
+		  m03(HM(0, 3)),
+		  m10(HM(1, 0)),
+		  m11(HM(1, 1)),
+		  m12(HM(1, 2)),
+		  m13(HM(1, 3)),
+		  m20(HM(2, 0)),
+		  m21(HM(2, 1)),
+		  m22(HM(2, 2)),
+		  m23(HM(2, 3))
+	{
+	}
+
+	void reserve(std::size_t n) override { map_.reserve(map_.size() + n); }
+
+	void add_point(
+		float lx, float ly, float lz, uint8_t pt_intensity,
+		[[maybe_unused]] const mrpt::system::TTimeStamp& tim,
+		[[maybe_unused]] const float azimuth,
+		[[maybe_unused]] uint16_t laser_id) override
+	{
+		const float inten = pt_intensity * (1.0f / 255);  // Intensity scale
+		map_.insertPointRGB(
+			m00 * lx + m01 * ly + m02 * lz + m03,
+			m10 * lx + m11 * ly + m12 * lz + m13,
+			m20 * lx + m21 * ly + m22 * lz + m23,  // XYZ
+			inten, inten, inten	 // RGB
+		);
+	}
+};
+}  // namespace
+
 void CPointsMap::loadFromVelodyneScan(
 	const mrpt::obs::CObservationVelodyneScan& scan,
 	const std::optional<const mrpt::poses::CPose3D>& robotPose)
@@ -2074,7 +2177,8 @@ void CPointsMap::loadFromVelodyneScan(
 	ASSERT_EQUAL_(scan.point_cloud.x.size(), scan.point_cloud.z.size());
 	ASSERT_EQUAL_(scan.point_cloud.x.size(), scan.point_cloud.intensity.size());
 
-	if (scan.point_cloud.x.empty()) return;
+	const bool decodeRawPackets = scan.point_cloud.x.empty();
+	if (decodeRawPackets && scan.scan_packets.empty()) return;
 
 	this->mark_as_modified();
 
@@ -2083,14 +2187,6 @@ void CPointsMap::loadFromVelodyneScan(
 		resize(0);	// Resize to 0 instead of clear() so the std::vector<>
 	// memory is not actually deallocated and can be reused.
 
-	// Alloc space:
-	const size_t nOldPtsCount = this->size();
-	const size_t nScanPts = scan.point_cloud.size();
-	const size_t nNewPtsCount = nOldPtsCount + nScanPts;
-	this->resize(nNewPtsCount);
-
-	const float K = 1.0f / 255;	 // Intensity scale.
-
 	// global 3D pose:
 	CPose3D sensorGlobalPose;
 	if (robotPose) sensorGlobalPose = *robotPose + scan.sensorPose;
@@ -2100,6 +2196,22 @@ void CPointsMap::loadFromVelodyneScan(
 	mrpt::math::CMatrixDouble44 HM;
 	sensorGlobalPose.getHomogeneousMatrix(HM);
 
+	if (decodeRawPackets)
+	{
+		// Streaming decoding: no intermediate point cloud is generated.
+		PointCloudStorageWrapper_PointsMap dest(*this, HM);
+		scan.generatePointCloud(dest);
+		return;
+	}
+
+	// Alloc space:
+	const size_t nOldPtsCount = this->size();
+	const size_t nScanPts = scan.point_cloud.size();
+	const size_t nNewPtsCount = nOldPtsCount + nScanPts;
+	this->resize(nNewPtsCount);
+
+	const float K = 1.0f / 255;	 // Intensity scale.
+
 	const double m00 = HM(0, 0), m01 = HM(0, 1), m02 = HM(0, 2), m03 = HM(0, 3);
 	const double m10 = HM(1, 0), m11 = HM(1, 1), m12 = HM(1, 2), m13 = HM(1, 3);
 	const double m20 = HM(2, 0), m21 = HM(2, 1), m22 = HM(2, 2), m23 = HM(2, 3);
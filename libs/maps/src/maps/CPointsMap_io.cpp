@@ -0,0 +1,1283 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "maps-precomp.h"  // Precomp header
+//
+#include <mrpt/config.h>
+#include <mrpt/core/TaskScheduler.h>
+#include <mrpt/core/format.h>
+#include <mrpt/core/reverse_bytes.h>
+#include <mrpt/io/CMemoryMappedFile.h>
+#include <mrpt/maps/CColouredPointsMap.h>
+#include <mrpt/maps/CPointsMap.h>
+#include <mrpt/maps/CPointsMapXYZI.h>
+#include <mrpt/system/string_utils.h>
+
+#include <algorithm>
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <optional>
+
+// File formats of point clouds: text (XYZ), PCD, PLY and LAS.
+//
+// All loaders memory-map the file and decode points straight into the map
+// buffers, in parallel, after a setSize(N). Binary formats are described by a
+// PointsLayout (the offset and type of each field of a point record), so all
+// of them share the same decoder. Text formats are split in blocks of lines,
+// parsed in parallel.
+
+using namespace mrpt::maps;
+
+namespace
+{
+enum class ScalarType : uint8_t
+{
+	Int8,
+	UInt8,
+	Int16,
+	UInt16,
+	Int32,
+	UInt32,
+	Float32,
+	Float64
+};
+
+// A field of the points in a file: in binary files, the value of point #i is
+// at `offset + i * stride`. In text files, `offset` is the column index.
+struct Field
+{
+	bool present = false;
+	ScalarType type = ScalarType::Float32;
+	size_t offset = 0, stride = 0;
+	// Loaded value = raw * scale + shift
+	double scale = 1.0, shift = 0.0;
+
+	void set(ScalarType t, size_t off, size_t strd)
+	{
+		present = true;
+		type = t;
+		offset = off;
+		stride = strd;
+	}
+};
+
+struct PointsLayout
+{
+	size_t numPoints = 0;
+	bool bigEndian = false;
+	Field x, y, z, intensity, r, g, b;
+	// PCD "rgb" and "rgba": `r` holds the color bits packed as 0x??RRGGBB
+	bool packedRGB = false;
+
+	bool hasColor() const
+	{
+		return packedRGB || (r.present && g.present && b.present);
+	}
+	// Text formats: the number of leading columns to parse in each line
+	size_t numColumns() const
+	{
+		size_t n = 0;
+		for (const Field* f : {&x, &y, &z, &intensity, &r, &g, &b})
+			if (f->present) n = std::max(n, f->offset + 1);
+		return n;
+	}
+};
+
+constexpr auto NO_ERROR_LINE = std::numeric_limits<size_t>::max();
+
+bool reportLoadError(
+	mrpt::optional_ref<std::string> outErrorMsg, const char* method,
+	const std::string& msg)
+{
+	const auto s = mrpt::format("[CPointsMap::%s] %s\n", method, msg.c_str());
+	if (outErrorMsg) outErrorMsg.value().get() = s;
+	else
+		std::cerr << s;
+	return false;
+}
+
+template <typename T>
+T readAs(const uint8_t* p, bool swap)
+{
+	T v;
+	std::memcpy(&v, p, sizeof(T));
+	if (swap) mrpt::reverseBytesInPlace(v);
+	return v;
+}
+
+double readScalar(const uint8_t* p, ScalarType t, bool swap)
+{
+	switch (t)
+	{
+		case ScalarType::Int8: return readAs<int8_t>(p, swap);
+		case ScalarType::UInt8: return readAs<uint8_t>(p, swap);
+		case ScalarType::Int16: return readAs<int16_t>(p, swap);
+		case ScalarType::UInt16: return readAs<uint16_t>(p, swap);
+		case ScalarType::Int32: return readAs<int32_t>(p, swap);
+		case ScalarType::UInt32: return readAs<uint32_t>(p, swap);
+		case ScalarType::Float32: return readAs<float>(p, swap);
+		case ScalarType::Float64: return readAs<double>(p, swap);
+	}
+	return 0;
+}
+
+// Writes a value in little endian order:
+template <typename T>
+void putLE(uint8_t* p, T v)
+{
+#if MRPT_IS_BIG_ENDIAN
+	mrpt::reverseBytesInPlace(v);
+#endif
+	std::memcpy(p, &v, sizeof(T));
+}
+
+void unpackRGB(uint32_t rgb, float& R, float& G, float& B)
+{
+	R = static_cast<float>((rgb >> 16) & 0xff) * (1.0f / 255);
+	G = static_cast<float>((rgb >> 8) & 0xff) * (1.0f / 255);
+	B = static_cast<float>(rgb & 0xff) * (1.0f / 255);
+}
+
+template <typename T>
+T normalizedTo(float v)
+{
+	const float m = static_cast<float>(std::numeric_limits<T>::max());
+	return static_cast<T>(std::clamp(v, 0.0f, 1.0f) * m + 0.5f);
+}
+
+// PCD "rgb" fields are declared as float, but PCL writes them in text files
+// as the integer with the same bits. Other tools write the float itself.
+uint32_t packedRGBFromText(double v)
+{
+	if (v >= 0 && v <= 4294967295.0 && v == std::floor(v))
+		return static_cast<uint32_t>(v);
+	const auto f = static_cast<float>(v);
+	uint32_t u;
+	std::memcpy(&u, &f, sizeof(u));
+	return u;
+}
+
+// Where loaded points go: the map coordinates, plus intensity or color if
+// both the map and the file have them (colored maps take the intensity as
+// gray levels, XYZI maps take the red channel as intensity).
+struct PointsOutput
+{
+	float *x = nullptr, *y = nullptr, *z = nullptr;
+	CPointsMapXYZI* xyzi = nullptr;
+	CColouredPointsMap* colored = nullptr;
+	bool useIntensity = false, useColor = false;
+
+	PointsOutput(
+		CPointsMap& m, float* xs, float* ys, float* zs, const PointsLayout& l)
+		: x(xs),
+		  y(ys),
+		  z(zs),
+		  xyzi(dynamic_cast<CPointsMapXYZI*>(&m)),
+		  colored(dynamic_cast<CColouredPointsMap*>(&m))
+	{
+		if (colored)
+		{
+			useColor = l.hasColor();
+			useIntensity = !useColor && l.intensity.present;
+		}
+		else if (xyzi)
+		{
+			useIntensity = l.intensity.present;
+			useColor = !useIntensity && l.hasColor();
+		}
+	}
+
+	// Stores point #i. Its fields are read with `get(field)`, and a packed
+	// color with `getPacked()`.
+	template <class GET, class GET_PACKED>
+	void store(
+		size_t i, const PointsLayout& l, const GET& get,
+		const GET_PACKED& getPacked) const
+	{
+		x[i] = static_cast<float>(get(l.x));
+		y[i] = static_cast<float>(get(l.y));
+		z[i] = static_cast<float>(get(l.z));
+		if (!useIntensity && !useColor) return;
+
+		float R, G, B;
+		if (useIntensity) R = G = B = static_cast<float>(get(l.intensity));
+		else if (l.packedRGB)
+			unpackRGB(getPacked(), R, G, B);
+		else
+		{
+			R = static_cast<float>(get(l.r));
+			G = static_cast<float>(get(l.g));
+			B = static_cast<float>(get(l.b));
+		}
+		if (xyzi) xyzi->setPointColor_fast(i, R, G, B);
+		else
+			colored->setPointColor_fast(i, R, G, B);
+	}
+};
+
+void decodeBinaryPoints(
+	const uint8_t* data, const PointsLayout& l, const PointsOutput& out)
+{
+	const bool swap = l.bigEndian != (MRPT_IS_BIG_ENDIAN != 0);
+	mrpt::parallel_for(0, l.numPoints, 1 << 16, [&](size_t i0, size_t i1) {
+		for (size_t i = i0; i < i1; i++)
+		{
+			out.store(
+				i, l,
+				[&](const Field& f) {
+					return readScalar(
+							   data + f.offset + i * f.stride, f.type, swap) *
+						f.scale +
+						f.shift;
+				},
+				[&]() {
+					return readAs<uint32_t>(
+						data + l.r.offset + i * l.r.stride, swap);
+				});
+		}
+	});
+}
+
+// The max. raw value of some fields (to find out their range):
+double maxRawValue(
+	const uint8_t* data, const PointsLayout& l,
+	std::initializer_list<Field*> fields)
+{
+	const bool swap = l.bigEndian != (MRPT_IS_BIG_ENDIAN != 0);
+	return mrpt::parallel_reduce(
+		0, l.numPoints, 1 << 16, 0.0,
+		[&](size_t i0, size_t i1) {
+			double m = 0;
+			for (size_t i = i0; i < i1; i++)
+				for (const Field* f : fields)
+					m = std::max(
+						m,
+						readScalar(
+							data + f->offset + i * f->stride, f->type, swap));
+			return m;
+		},
+		[](double a, double b) { return std::max(a, b); });
+}
+
+// Parses a number, skipping leading blanks. Like `istream>>`, but much
+// faster. It is locale-independent with std::from_chars(); the strtod()
+// fallback for older standard libraries uses the current C locale, which is
+// "C" unless the program calls setlocale().
+bool parseNumber(const char*& p, const char* end, double& v)
+{
+	while (p < end &&
+		   (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f'))
+		++p;
+	if (p < end && *p == '+') ++p;
+#if defined(__cpp_lib_to_chars)
+	const auto r = std::from_chars(p, end, v);
+	if (r.ec != std::errc()) return false;
+	p = r.ptr;
+	return true;
+#else
+	char buf[64];
+	size_t n = 0;
+	while (n + 1 < sizeof(buf) && p + n < end && !std::isspace(p[n]))
+	{
+		buf[n] = p[n];
+		n++;
+	}
+	buf[n] = '\0';
+	char* numEnd = nullptr;
+	v = std::strtod(buf, &numEnd);
+	if (numEnd == buf) return false;
+	p += numEnd - buf;
+	return true;
+#endif
+}
+
+// Parses up to `n` numbers from a line. Returns how many were read.
+size_t parseNumbers(const char* p, const char* end, double* v, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		if (!parseNumber(p, end, v[i])) return i;
+	return n;
+}
+
+struct TextBlock
+{
+	const char *begin = nullptr, *end = nullptr;
+	// Index (0-based) of the first line, and number of lines in the block
+	size_t firstLine = 0, numLines = 0;
+};
+
+// Splits a text in blocks of ~1MB at line boundaries, counting their lines
+// in parallel. Like std::getline(), a last line without '\n' counts as a
+// line, unless it is empty.
+std::vector<TextBlock> splitTextInBlocks(const char* begin, const char* end)
+{
+	constexpr size_t BLOCK_SIZE = 1 << 20;
+
+	std::vector<TextBlock> blocks;
+	while (begin < end)
+	{
+		TextBlock b;
+		b.begin = begin;
+		b.end = begin + std::min<size_t>(BLOCK_SIZE, end - begin);
+		if (b.end < end)
+		{
+			const auto* nl =
+				static_cast<const char*>(std::memchr(b.end, '\n', end - b.end));
+			b.end = nl ? nl + 1 : end;
+		}
+		blocks.push_back(b);
+		begin = b.end;
+	}
+
+	mrpt::parallel_for(0, blocks.size(), 1, [&](size_t k0, size_t k1) {
+		for (size_t k = k0; k < k1; k++)
+		{
+			auto& b = blocks[k];
+			b.numLines = std::count(b.begin, b.end, '\n');
+			if (b.end[-1] != '\n') b.numLines++;
+		}
+	});
+	for (size_t k = 1; k < blocks.size(); k++)
+		blocks[k].firstLine = blocks[k - 1].firstLine + blocks[k - 1].numLines;
+
+	return blocks;
+}
+
+size_t countLines(const std::vector<TextBlock>& blocks)
+{
+	if (blocks.empty()) return 0;
+	return blocks.back().firstLine + blocks.back().numLines;
+}
+
+// Calls `parseLine(lineBegin, lineEnd, lineIndex, values)` for the first
+// `numLines` lines, in parallel. `values` is a scratch buffer for each
+// thread. Returns the index of the first line for which it returned false, or
+// NO_ERROR_LINE.
+template <class PARSE_LINE>
+size_t parseLinesParallel(
+	const std::vector<TextBlock>& blocks, size_t numLines,
+	const PARSE_LINE& parseLine)
+{
+	std::vector<size_t> firstError(blocks.size(), NO_ERROR_LINE);
+	mrpt::parallel_for(0, blocks.size(), 1, [&](size_t k0, size_t k1) {
+		std::vector<double> values;
+		for (size_t k = k0; k < k1; k++)
+		{
+			const auto& b = blocks[k];
+			size_t line = b.firstLine;
+			for (const char* p = b.begin; p < b.end && line < numLines; line++)
+			{
+				const auto* nl =
+					static_cast<const char*>(std::memchr(p, '\n', b.end - p));
+				const char* lineEnd = nl ? nl : b.end;
+				if (!parseLine(p, lineEnd, line, values))
+				{
+					firstError[k] = line;
+					break;
+				}
+				p = nl ? nl + 1 : b.end;
+			}
+		}
+	});
+	for (const auto e : firstError)
+		if (e != NO_ERROR_LINE) return e;
+	return NO_ERROR_LINE;
+}
+
+// Parses the points of PCD and PLY text files, one per line. `blocks` must
+// have at least `l.numPoints` lines. Returns the index of the first wrong
+// line, or NO_ERROR_LINE.
+size_t parseTextPoints(
+	const std::vector<TextBlock>& blocks, const PointsLayout& l,
+	const PointsOutput& out)
+{
+	const size_t nCols = l.numColumns();
+	return parseLinesParallel(
+		blocks, l.numPoints,
+		[&](const char* b, const char* e, size_t i, std::vector<double>& v) {
+			v.resize(nCols);
+			if (parseNumbers(b, e, v.data(), nCols) != nCols) return false;
+			out.store(
+				i, l,
+				[&](const Field& f) { return v[f.offset] * f.scale + f.shift; },
+				[&]() { return packedRGBFromText(v[l.r.offset]); });
+			return true;
+		});
+}
+
+// Returns the next header line, trimming "\r" and moving `p` to the next one
+bool nextHeaderLine(const char*& p, const char* end, std::string& line)
+{
+	if (p >= end) return false;
+	const auto* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+	const char* lineEnd = nl ? nl : end;
+	line.assign(p, lineEnd);
+	if (!line.empty() && line.back() == '\r') line.pop_back();
+	p = nl ? nl + 1 : end;
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// PCD
+// ---------------------------------------------------------------------------
+std::optional<ScalarType> pcdScalarType(const std::string& type, size_t size)
+{
+	const char t = type.empty() ? ' ' : type[0];
+	if (t == 'F' && size == 4) return ScalarType::Float32;
+	if (t == 'F' && size == 8) return ScalarType::Float64;
+	if (t == 'I' && size == 1) return ScalarType::Int8;
+	if (t == 'I' && size == 2) return ScalarType::Int16;
+	if (t == 'I' && size == 4) return ScalarType::Int32;
+	if (t == 'U' && size == 1) return ScalarType::UInt8;
+	if (t == 'U' && size == 2) return ScalarType::UInt16;
+	if (t == 'U' && size == 4) return ScalarType::UInt32;
+	return std::nullopt;
+}
+
+enum class PCDData : uint8_t
+{
+	Ascii,
+	Binary,
+	BinaryCompressed
+};
+
+// Parses a PCD header, leaving `p` at the beginning of the data.
+// Returns an error description, or an empty string on success.
+std::string parsePCDHeader(
+	const char*& p, const char* end, PointsLayout& l, PCDData& format,
+	size_t& recordSize)
+{
+	std::vector<std::string> fields, types;
+	std::vector<size_t> sizes, counts;
+	size_t width = 0, height = 1;
+	std::optional<size_t> points;
+	std::string data;
+
+	const auto toNumbers = [](const std::vector<std::string>& toks) {
+		std::vector<size_t> v;
+		for (const auto& t : toks)
+			v.push_back(std::stoul(t));
+		return v;
+	};
+
+	try
+	{
+		std::string line;
+		while (data.empty())
+		{
+			if (!nextHeaderLine(p, end, line)) return "Missing DATA in header";
+
+			std::vector<std::string> toks;
+			mrpt::system::tokenize(line, " \t", toks);
+			if (toks.empty() || toks[0][0] == '#') continue;
+
+			const std::string key = toks[0];
+			toks.erase(toks.begin());
+			if (key == "FIELDS") fields = toks;
+			else if (key == "SIZE")
+				sizes = toNumbers(toks);
+			else if (key == "TYPE")
+				types = toks;
+			else if (key == "COUNT")
+				counts = toNumbers(toks);
+			else if (key == "WIDTH" && !toks.empty())
+				width = std::stoul(toks[0]);
+			else if (key == "HEIGHT" && !toks.empty())
+				height = std::stoul(toks[0]);
+			else if (key == "POINTS" && !toks.empty())
+				points = std::stoul(toks[0]);
+			else if (key == "DATA")
+			{
+				if (toks.empty()) return "Missing format in DATA line";
+				data = toks[0];
+			}
+		}
+	}
+	catch (const std::exception&)
+	{
+		return "Invalid number in header";
+	}
+
+	if (counts.empty()) counts.assign(fields.size(), 1);
+	if (fields.empty() || sizes.size() != fields.size() ||
+		types.size() != fields.size() || counts.size() != fields.size())
+		return "Inconsistent FIELDS, SIZE, TYPE and COUNT in header";
+
+	if (data == "ascii") format = PCDData::Ascii;
+	else if (data == "binary")
+		format = PCDData::Binary;
+	else if (data == "binary_compressed")
+		format = PCDData::BinaryCompressed;
+	else
+		return "Unknown DATA format: " + data;
+
+	l.numPoints = points ? *points : width * height;
+	l.bigEndian = false;
+
+	// binary_compressed data are stored field after field:
+	recordSize = 0;
+	size_t column = 0;
+	for (size_t k = 0; k < fields.size(); k++)
+	{
+		const auto& name = fields[k];
+		Field* f = nullptr;
+		if (name == "x") f = &l.x;
+		else if (name == "y")
+			f = &l.y;
+		else if (name == "z")
+			f = &l.z;
+		else if (name == "intensity")
+			f = &l.intensity;
+		else if (name == "rgb" || name == "rgba")
+		{
+			if (sizes[k] != 4) return "Field rgb must have SIZE 4";
+			f = &l.r;
+			l.packedRGB = true;
+		}
+
+		if (f)
+		{
+			const auto t = pcdScalarType(types[k], sizes[k]);
+			if (!t) return "Unsupported TYPE or SIZE of field " + name;
+			switch (format)
+			{
+				case PCDData::Ascii: f->set(*t, column, 0); break;
+				case PCDData::Binary: f->set(*t, recordSize, 0); break;
+				case PCDData::BinaryCompressed:
+					f->set(*t, recordSize * l.numPoints, sizes[k] * counts[k]);
+					break;
+			}
+		}
+		recordSize += sizes[k] * counts[k];
+		column += counts[k];
+	}
+	if (!l.x.present || !l.y.present || !l.z.present)
+		return "Fields x, y and z are required";
+	if (recordSize != 0 &&
+		l.numPoints > std::numeric_limits<size_t>::max() / recordSize)
+		return "Invalid number of points";
+
+	if (format == PCDData::Binary)
+		for (Field* f : {&l.x, &l.y, &l.z, &l.intensity, &l.r})
+			f->stride = recordSize;
+
+	return {};
+}
+
+// LZF decompression, as used by PCD binary_compressed data
+bool lzfDecompress(
+	const uint8_t* in, size_t inSize, uint8_t* out, size_t outSize)
+{
+	const uint8_t* const inEnd = in + inSize;
+	uint8_t* const outBegin = out;
+	uint8_t* const outEnd = out + outSize;
+	while (in < inEnd)
+	{
+		const unsigned ctrl = *in++;
+		if (ctrl < 32)
+		{  // Literal run
+			const size_t len = ctrl + 1;
+			if (len > size_t(inEnd - in) || len > size_t(outEnd - out))
+				return false;
+			std::memcpy(out, in, len);
+			in += len;
+			out += len;
+		}
+		else
+		{  // Back reference
+			size_t len = ctrl >> 5;
+			size_t dist = (ctrl & 0x1f) << 8;
+			if (len == 7)
+			{
+				if (in >= inEnd) return false;
+				len += *in++;
+			}
+			if (in >= inEnd) return false;
+			dist += *in++ + 1;
+			len += 2;
+			if (dist > size_t(out - outBegin) || len > size_t(outEnd - out))
+				return false;
+			const uint8_t* ref = out - dist;
+			// Byte by byte, since both ranges may overlap:
+			for (size_t i = 0; i < len; i++)
+				*out++ = *ref++;
+		}
+	}
+	return out == outEnd;
+}
+
+// ---------------------------------------------------------------------------
+// PLY
+// ---------------------------------------------------------------------------
+std::optional<ScalarType> plyScalarType(const std::string& t)
+{
+	if (t == "char" || t == "int8") return ScalarType::Int8;
+	if (t == "uchar" || t == "uint8") return ScalarType::UInt8;
+	if (t == "short" || t == "int16") return ScalarType::Int16;
+	if (t == "ushort" || t == "uint16") return ScalarType::UInt16;
+	if (t == "int" || t == "int32") return ScalarType::Int32;
+	if (t == "uint" || t == "uint32") return ScalarType::UInt32;
+	if (t == "float" || t == "float32") return ScalarType::Float32;
+	if (t == "double" || t == "float64") return ScalarType::Float64;
+	return std::nullopt;
+}
+
+size_t scalarSize(ScalarType t)
+{
+	switch (t)
+	{
+		case ScalarType::Int8:
+		case ScalarType::UInt8: return 1;
+		case ScalarType::Int16:
+		case ScalarType::UInt16: return 2;
+		case ScalarType::Float64: return 8;
+		default: return 4;
+	}
+}
+
+// Parses the header of a PLY file, leaving `p` at the beginning of the data.
+// Returns false if it is not a point cloud supported by the fast loader:
+// "vertex" must be the first element, without list properties.
+bool parsePLYHeader(
+	const char*& p, const char* end, PointsLayout& l, bool& ascii,
+	std::vector<std::string>& comments, std::vector<std::string>& objInfo)
+{
+	std::string line;
+	if (!nextHeaderLine(p, end, line) || line != "ply") return false;
+
+	// 0: before any element, 1: in "vertex", 2: after "vertex"
+	int state = 0;
+	size_t offset = 0;
+	bool binary = false;
+	for (;;)
+	{
+		if (!nextHeaderLine(p, end, line)) return false;
+		if (line == "end_header") break;
+
+		std::vector<std::string> toks;
+		mrpt::system::tokenize(line, " \t", toks);
+		if (toks.empty()) continue;
+		const auto& key = toks[0];
+
+		if (key == "comment")
+			comments.push_back(line.size() > 8 ? line.substr(8) : "");
+		else if (key == "obj_info")
+			objInfo.push_back(line.size() > 9 ? line.substr(9) : "");
+		else if (key == "format" && toks.size() >= 2)
+		{
+			binary = toks[1] != "ascii";
+			if (toks[1] == "binary_big_endian") l.bigEndian = true;
+			else if (toks[1] == "binary_little_endian")
+				l.bigEndian = false;
+			else if (binary)
+				return false;
+		}
+		else if (key == "element" && toks.size() >= 3)
+		{
+			if (state != 0) state = 2;
+			else if (toks[1] != "vertex")
+				return false;
+			else
+			{
+				state = 1;
+				char* numEnd = nullptr;
+				l.numPoints = std::strtoull(toks[2].c_str(), &numEnd, 10);
+				if (*numEnd != '\0') return false;
+			}
+		}
+		else if (key == "property" && state == 1)
+		{
+			if (toks.size() != 3) return false;	 // e.g. a list
+			const auto t = plyScalarType(toks[1]);
+			if (!t) return false;
+			const auto& name = toks[2];
+
+			Field* f = nullptr;
+			if (name == "x") f = &l.x;
+			else if (name == "y")
+				f = &l.y;
+			else if (name == "z")
+				f = &l.z;
+			else if (name == "intensity")
+				f = &l.intensity;
+			else if (name == "red")
+				f = &l.r;
+			else if (name == "green")
+				f = &l.g;
+			else if (name == "blue")
+				f = &l.b;
+
+			// Text files: offset is the column index
+			if (f)
+			{
+				f->set(*t, offset, 0);
+				if (f != &l.x && f != &l.y && f != &l.z)
+				{
+					// Normalize 8 and 16 bit colors and intensities:
+					if (*t == ScalarType::UInt8) f->scale = 1.0 / 255;
+					if (*t == ScalarType::UInt16) f->scale = 1.0 / 65535;
+				}
+			}
+			offset += binary ? scalarSize(*t) : 1;
+		}
+	}
+	if (!l.x.present || !l.y.present || !l.z.present) return false;
+
+	if (binary)
+	{
+		if (offset != 0 &&
+			l.numPoints > std::numeric_limits<size_t>::max() / offset)
+			return false;
+		for (Field* f : {&l.x, &l.y, &l.z, &l.intensity, &l.r, &l.g, &l.b})
+			f->stride = offset;
+		if (l.numPoints * offset > size_t(end - p)) return false;
+	}
+	ascii = !binary;
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// LAS
+// ---------------------------------------------------------------------------
+constexpr size_t LAS_HEADER_SIZE_1_2 = 227;
+
+// Parses a LAS header. Returns an error description, or an empty string on
+// success.
+std::string parseLASHeader(
+	const uint8_t* d, size_t fileSize, PointsLayout& l, size_t& dataOffset)
+{
+	constexpr bool swap = MRPT_IS_BIG_ENDIAN != 0;
+
+	if (fileSize < LAS_HEADER_SIZE_1_2 || std::memcmp(d, "LASF", 4) != 0)
+		return "Not a LAS file";
+
+	const uint8_t versionMinor = d[25];
+	const auto headerSize = readAs<uint16_t>(d + 94, swap);
+	if (headerSize < LAS_HEADER_SIZE_1_2 || headerSize > fileSize)
+		return mrpt::format("Invalid header size: %u", headerSize);
+	dataOffset = readAs<uint32_t>(d + 96, swap);
+	const uint8_t format = d[104];
+	const auto recordLength = readAs<uint16_t>(d + 105, swap);
+	uint64_t numPoints = readAs<uint32_t>(d + 107, swap);
+	if (numPoints == 0 && versionMinor >= 4 && headerSize >= 255)
+		numPoints = readAs<uint64_t>(d + 247, swap);
+
+	// LAZ files set the two highest bits of the point format:
+	if (format & 0xC0) return "Compressed LAZ files are not supported";
+	if (format > 10)
+		return mrpt::format("Unsupported point format: %u", format);
+
+	const uint16_t minRecordLength[11] = {20, 28, 26, 34, 57, 63,
+										  30, 36, 38, 59, 67};
+	if (recordLength < minRecordLength[format])
+		return mrpt::format(
+			"Invalid record length (%u) for point format %u", recordLength,
+			format);
+	if (dataOffset > fileSize ||
+		numPoints > (fileSize - dataOffset) / recordLength)
+		return "File too short for its number of points";
+
+	l.numPoints = static_cast<size_t>(numPoints);
+	l.bigEndian = false;
+	const size_t stride = recordLength;
+
+	Field* xyz[3] = {&l.x, &l.y, &l.z};
+	for (int i = 0; i < 3; i++)
+	{
+		xyz[i]->set(ScalarType::Int32, 4 * i, stride);
+		xyz[i]->scale = readAs<double>(d + 131 + 8 * i, swap);
+		xyz[i]->shift = readAs<double>(d + 155 + 8 * i, swap);
+	}
+	l.intensity.set(ScalarType::UInt16, 12, stride);
+
+	size_t rgbOffset = 0;
+	if (format == 2) rgbOffset = 20;
+	else if (format == 3 || format == 5)
+		rgbOffset = 28;
+	else if (format == 7 || format == 8 || format == 10)
+		rgbOffset = 30;
+	if (rgbOffset)
+	{
+		l.r.set(ScalarType::UInt16, rgbOffset, stride);
+		l.g.set(ScalarType::UInt16, rgbOffset + 2, stride);
+		l.b.set(ScalarType::UInt16, rgbOffset + 4, stride);
+	}
+	return {};
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// Text files
+// ---------------------------------------------------------------------------
+bool CPointsMap::load2Dor3D_from_text_file(
+	const std::string& file, const bool is_3D)
+{
+	MRPT_START
+
+	// Clear current map:
+	mark_as_modified();
+	this->clear();
+
+	mrpt::io::CMemoryMappedFile f;
+	try
+	{
+		f.open(file);
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+
+	const auto* text = reinterpret_cast<const char*>(f.data());
+	const auto blocks = splitTextInBlocks(text, text + f.size());
+	const size_t N = countLines(blocks);
+	const size_t nCoords = is_3D ? 3 : 2;
+
+	this->setSize(N);
+	float* xs = m_x.data();
+	float* ys = m_y.data();
+	float* zs = m_z.data();
+
+	const size_t errLine = parseLinesParallel(
+		blocks, N,
+		[&](const char* b, const char* e, size_t i, std::vector<double>&) {
+			double v[3] = {0, 0, 0};
+			if (parseNumbers(b, e, v, nCoords) != nCoords) return false;
+			xs[i] = static_cast<float>(v[0]);
+			ys[i] = static_cast<float>(v[1]);
+			zs[i] = static_cast<float>(v[2]);
+			return true;
+		});
+
+	if (errLine != NO_ERROR_LINE)
+	{
+		// Find out the wrong coordinate, for the error message:
+		const auto& b = *std::find_if(
+			blocks.rbegin(), blocks.rend(),
+			[&](const TextBlock& blk) { return blk.firstLine <= errLine; });
+		const char* line = b.begin;
+		for (size_t i = b.firstLine; i < errLine; i++)
+			line = static_cast<const char*>(
+					   std::memchr(line, '\n', b.end - line)) +
+				1;
+		const auto* nl =
+			static_cast<const char*>(std::memchr(line, '\n', b.end - line));
+		double v[3];
+		const size_t nRead = parseNumbers(line, nl ? nl : b.end, v, nCoords);
+
+		this->clear();
+		std::cerr << "[CPointsMap::load2Dor3D_from_text_file] Unexpected "
+					 "format on line "
+				  << (errLine + 1) << " for coordinate #" << (nRead + 1)
+				  << "\n";
+		return false;
+	}
+
+	mark_as_modified();
+	return true;
+
+	MRPT_END
+}
+
+// ---------------------------------------------------------------------------
+// PCD files
+// ---------------------------------------------------------------------------
+bool CPointsMap::loadFromPCDFile(
+	const std::string& file, mrpt::optional_ref<std::string> outErrorMsg)
+{
+	MRPT_START
+
+	const auto error = [&](const std::string& msg) {
+		this->clear();
+		return reportLoadError(outErrorMsg, "loadFromPCDFile", msg);
+	};
+
+	mark_as_modified();
+	this->clear();
+
+	mrpt::io::CMemoryMappedFile f;
+	try
+	{
+		f.open(file);
+	}
+	catch (const std::exception&)
+	{
+		return error("Cannot open file: " + file);
+	}
+
+	const auto* fileBegin = reinterpret_cast<const char*>(f.data());
+	const auto* fileEnd = fileBegin + f.size();
+	const char* p = fileBegin;
+
+	PointsLayout l;
+	PCDData format;
+	size_t recordSize;
+	if (const auto err = parsePCDHeader(p, fileEnd, l, format, recordSize);
+		!err.empty())
+		return error(err);
+
+	const auto* data = f.data() + (p - fileBegin);
+	const size_t dataSize = fileEnd - p;
+	const size_t N = l.numPoints;
+
+	// Check the data size before allocating the points, since N comes from
+	// the (maybe wrong) header:
+	std::vector<TextBlock> blocks;
+	uint32_t compressedSize = 0, uncompressedSize = 0;
+	switch (format)
+	{
+		case PCDData::Ascii:
+			blocks = splitTextInBlocks(p, fileEnd);
+			if (countLines(blocks) < N) return error("Truncated file");
+			break;
+
+		case PCDData::Binary:
+			if (N * recordSize > dataSize) return error("Truncated file");
+			break;
+
+		case PCDData::BinaryCompressed:
+			if (dataSize < 8) return error("Truncated file");
+			compressedSize = readAs<uint32_t>(data, false);
+			uncompressedSize = readAs<uint32_t>(data + 4, false);
+			if (compressedSize > dataSize - 8) return error("Truncated file");
+			if (uncompressedSize != N * recordSize)
+				return error("Unexpected size of compressed data");
+			break;
+	}
+
+	this->setSize(N);
+	const PointsOutput out(*this, m_x.data(), m_y.data(), m_z.data(), l);
+
+	switch (format)
+	{
+		case PCDData::Ascii:
+		{
+			const auto errLine = parseTextPoints(blocks, l, out);
+			if (errLine != NO_ERROR_LINE)
+				return error(mrpt::format(
+					"Unexpected format on point #%zu (line %zu of data)",
+					errLine, errLine + 1));
+		}
+		break;
+
+		case PCDData::Binary:
+			decodeBinaryPoints(data, l, out);
+			break;
+
+		case PCDData::BinaryCompressed:
+		{
+			std::vector<uint8_t> buf(uncompressedSize);
+			if (!lzfDecompress(
+					data + 8, compressedSize, buf.data(), buf.size()))
+				return error("Corrupted compressed data");
+			decodeBinaryPoints(buf.data(), l, out);
+		}
+		break;
+	}
+
+	mark_as_modified();
+	return true;
+
+	MRPT_END
+}
+
+bool CPointsMap::saveToPCDFile(const std::string& file, bool binary) const
+{
+	MRPT_START
+
+	const auto* xyzi = dynamic_cast<const CPointsMapXYZI*>(this);
+	const auto* colored = dynamic_cast<const CColouredPointsMap*>(this);
+	const bool hasExtra = xyzi || colored;
+	const size_t N = size();
+
+	std::ofstream f(file, std::ios::binary);
+	if (!f.is_open()) return false;
+
+	f << "# .PCD v0.7 - Point Cloud Data file format\n"
+	  << "VERSION 0.7\n"
+	  << "FIELDS x y z" << (xyzi ? " intensity" : (colored ? " rgb" : ""))
+	  << "\n"
+	  << "SIZE 4 4 4" << (hasExtra ? " 4" : "") << "\n"
+	  << "TYPE F F F" << (hasExtra ? " F" : "") << "\n"
+	  << "COUNT 1 1 1" << (hasExtra ? " 1" : "") << "\n"
+	  << "WIDTH " << N << "\n"
+	  << "HEIGHT 1\n"
+	  << "VIEWPOINT 0 0 0 1 0 0 0\n"
+	  << "POINTS " << N << "\n"
+	  << "DATA " << (binary ? "binary" : "ascii") << "\n";
+
+	const auto packedColor = [&](size_t i) {
+		float R, G, B;
+		colored->getPointColor_fast(i, R, G, B);
+		return (uint32_t(normalizedTo<uint8_t>(R)) << 16) |
+			(uint32_t(normalizedTo<uint8_t>(G)) << 8) |
+			uint32_t(normalizedTo<uint8_t>(B));
+	};
+
+	if (binary)
+	{
+		const size_t recordSize = hasExtra ? 16 : 12;
+		std::vector<uint8_t> buf(N * recordSize);
+		mrpt::parallel_for(0, N, 1 << 16, [&](size_t i0, size_t i1) {
+			for (size_t i = i0; i < i1; i++)
+			{
+				uint8_t* rec = &buf[i * recordSize];
+				putLE(rec + 0, m_x[i]);
+				putLE(rec + 4, m_y[i]);
+				putLE(rec + 8, m_z[i]);
+				if (xyzi) putLE(rec + 12, xyzi->getPointIntensity_fast(i));
+				else if (colored)
+					putLE(rec + 12, packedColor(i));
+			}
+		});
+		f.write(reinterpret_cast<const char*>(buf.data()), buf.size());
+	}
+	else
+	{
+		char line[128];
+		for (size_t i = 0; i < N; i++)
+		{
+			int n = std::snprintf(
+				line, sizeof(line), "%.9g %.9g %.9g", m_x[i], m_y[i], m_z[i]);
+			if (xyzi)
+				n += std::snprintf(
+					line + n, sizeof(line) - n, " %.9g",
+					xyzi->getPointIntensity_fast(i));
+			else if (colored)
+				n += std::snprintf(
+					line + n, sizeof(line) - n, " %u", packedColor(i));
+			line[n++] = '\n';
+			f.write(line, n);
+		}
+	}
+	return f.good();
+
+	MRPT_END
+}
+
+// ---------------------------------------------------------------------------
+// LAS files
+// ---------------------------------------------------------------------------
+bool CPointsMap::loadFromLASFile(
+	const std::string& file, mrpt::optional_ref<std::string> outErrorMsg)
+{
+	MRPT_START
+
+	const auto error = [&](const std::string& msg) {
+		this->clear();
+		return reportLoadError(outErrorMsg, "loadFromLASFile", msg);
+	};
+
+	mark_as_modified();
+	this->clear();
+
+	mrpt::io::CMemoryMappedFile f;
+	try
+	{
+		f.open(file);
+	}
+	catch (const std::exception&)
+	{
+		return error("Cannot open file: " + file);
+	}
+
+	PointsLayout l;
+	size_t dataOffset = 0;
+	if (const auto err = parseLASHeader(f.data(), f.size(), l, dataOffset);
+		!err.empty())
+		return error(err);
+	const uint8_t* data = f.data() + dataOffset;
+
+	this->setSize(l.numPoints);
+	const PointsOutput out(*this, m_x.data(), m_y.data(), m_z.data(), l);
+
+	// Intensity and RGB are 16 bit, but many files use only the lower 8 bits:
+	const auto normalize = [&](std::initializer_list<Field*> fields) {
+		const double maxVal = maxRawValue(data, l, fields);
+		for (Field* fld : fields)
+			fld->scale = maxVal <= 255 ? 1.0 / 255 : 1.0 / 65535;
+	};
+	if (out.useIntensity) normalize({&l.intensity});
+	if (out.useColor) normalize({&l.r, &l.g, &l.b});
+
+	decodeBinaryPoints(data, l, out);
+
+	mark_as_modified();
+	return true;
+
+	MRPT_END
+}
+
+bool CPointsMap::saveToLASFile(const std::string& file) const
+{
+	MRPT_START
+
+	const auto* xyzi = dynamic_cast<const CPointsMapXYZI*>(this);
+	const auto* colored = dynamic_cast<const CColouredPointsMap*>(this);
+	const size_t N = size();
+	if (N > std::numeric_limits<uint32_t>::max())
+	{
+		std::cerr << "[CPointsMap::saveToLASFile] Too many points for LAS "
+					 "1.2\n";
+		return false;
+	}
+
+	const uint8_t format = colored ? 2 : 0;
+	const size_t recordSize = colored ? 26 : 20;
+
+	// 1 mm resolution, unless the cloud does not fit in int32 coordinates:
+	double offset[3] = {0, 0, 0}, scale[3] = {1e-3, 1e-3, 1e-3};
+	double bbMin[3] = {0, 0, 0}, bbMax[3] = {0, 0, 0};
+	if (N)
+	{
+		const auto bb = boundingBox();
+		for (int k = 0; k < 3; k++)
+		{
+			bbMin[k] = bb.min[k];
+			bbMax[k] = bb.max[k];
+			offset[k] = bbMin[k];
+			const double maxScaled = 2e9 * scale[k];
+			if (bbMax[k] - bbMin[k] > maxScaled)
+				scale[k] = (bbMax[k] - bbMin[k]) / 2e9;
+		}
+	}
+
+	std::vector<uint8_t> buf(LAS_HEADER_SIZE_1_2 + N * recordSize, 0);
+	uint8_t* h = buf.data();
+	std::memcpy(h, "LASF", 4);
+	h[24] = 1;	// Version 1.2
+	h[25] = 2;
+	std::memcpy(h + 26, "MRPT", 4);	 // System identifier
+	std::memcpy(h + 58, "MRPT", 4);	 // Generating software
+	const std::time_t now = std::time(nullptr);
+	if (const std::tm* t = std::gmtime(&now); t)
+	{
+		putLE(h + 90, static_cast<uint16_t>(t->tm_yday + 1));
+		putLE(h + 92, static_cast<uint16_t>(t->tm_year + 1900));
+	}
+	putLE(h + 94, static_cast<uint16_t>(LAS_HEADER_SIZE_1_2));
+	putLE(h + 96, static_cast<uint32_t>(LAS_HEADER_SIZE_1_2));
+	h[104] = format;
+	putLE(h + 105, static_cast<uint16_t>(recordSize));
+	putLE(h + 107, static_cast<uint32_t>(N));
+	putLE(h + 111, static_cast<uint32_t>(N));  // Points of 1st return
+	for (int k = 0; k < 3; k++)
+	{
+		putLE(h + 131 + 8 * k, scale[k]);
+		putLE(h + 155 + 8 * k, offset[k]);
+		putLE(h + 179 + 16 * k, bbMax[k]);
+		putLE(h + 187 + 16 * k, bbMin[k]);
+	}
+
+	uint8_t* records = h + LAS_HEADER_SIZE_1_2;
+	const float* xyz[3] = {m_x.data(), m_y.data(), m_z.data()};
+	mrpt::parallel_for(0, N, 1 << 16, [&](size_t i0, size_t i1) {
+		for (size_t i = i0; i < i1; i++)
+		{
+			uint8_t* rec = records + i * recordSize;
+			for (int k = 0; k < 3; k++)
+				putLE(
+					rec + 4 * k,
+					static_cast<int32_t>(
+						std::lround((xyz[k][i] - offset[k]) / scale[k])));
+			if (xyzi)
+				putLE(
+					rec + 12,
+					normalizedTo<uint16_t>(xyzi->getPointIntensity_fast(i)));
+			rec[14] = 0x09;	 // Return 1 of 1
+			if (colored)
+			{
+				float R, G, B;
+				colored->getPointColor_fast(i, R, G, B);
+				putLE(rec + 20, normalizedTo<uint16_t>(R));
+				putLE(rec + 22, normalizedTo<uint16_t>(G));
+				putLE(rec + 24, normalizedTo<uint16_t>(B));
+			}
+		}
+	});
+
+	std::ofstream f(file, std::ios::binary);
+	if (!f.is_open()) return false;
+	f.write(reinterpret_cast<const char*>(buf.data()), buf.size());
+	return f.good();
+
+	MRPT_END
+}
+
+// ---------------------------------------------------------------------------
+// PLY files
+// ---------------------------------------------------------------------------
+bool CPointsMap::loadFromPlyFile(
+	const std::string& filename, std::vector<std::string>* file_comments,
+	std::vector<std::string>* file_obj_info)
+{
+	MRPT_START
+
+	mark_as_modified();
+	this->clear();
+
+	mrpt::io::CMemoryMappedFile f;
+	try
+	{
+		f.open(filename);
+	}
+	catch (const std::exception&)
+	{
+		// The generic loader below reports the error.
+	}
+
+	const auto* fileBegin = reinterpret_cast<const char*>(f.data());
+	const char* p = fileBegin;
+	PointsLayout l;
+	bool ascii = false;
+	std::vector<std::string> comments, objInfo;
+	if (f.isOpen() &&
+		parsePLYHeader(p, fileBegin + f.size(), l, ascii, comments, objInfo))
+	{
+		// (The header parser already checked the size of binary data)
+		std::vector<TextBlock> blocks;
+		if (ascii) blocks = splitTextInBlocks(p, fileBegin + f.size());
+
+		if (!ascii || countLines(blocks) >= l.numPoints)
+		{
+			this->setSize(l.numPoints);
+			const PointsOutput out(
+				*this, m_x.data(), m_y.data(), m_z.data(), l);
+
+			bool ok = true;
+			if (ascii) ok = parseTextPoints(blocks, l, out) == NO_ERROR_LINE;
+			else
+				decodeBinaryPoints(f.data() + (p - fileBegin), l, out);
+
+			if (ok)
+			{
+				if (file_comments) *file_comments = std::move(comments);
+				if (file_obj_info) *file_obj_info = std::move(objInfo);
+				mark_as_modified();
+				return true;
+			}
+			this->clear();
+		}
+	}
+
+	// Not a plain point cloud, or a wrong file:
+	return mrpt::opengl::PLY_Importer::loadFromPlyFile(
+		filename, file_comments, file_obj_info);
+
+	MRPT_END
+}
@@ -0,0 +1,366 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/io/vector_loadsave.h>
+#include <mrpt/maps/CColouredPointsMap.h>
+#include <mrpt/maps/CPointsMapXYZI.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/system/filesystem.h>
+
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace mrpt::maps;
+
+namespace
+{
+constexpr size_t N = 5000;
+
+// Point #i, with its color (or intensity, as R) in [0,1]:
+void demoPoint(size_t i, float* xyz, float* rgb)
+{
+	xyz[0] = -50.0f + 0.0125f * i;
+	xyz[1] = 10.0f * std::sin(0.01f * i);
+	xyz[2] = 0.001f * (i % 977);
+	rgb[0] = (i % 256) / 255.0f;
+	rgb[1] = ((i * 7) % 256) / 255.0f;
+	rgb[2] = ((i * 13) % 256) / 255.0f;
+}
+
+template <class MAP>
+void loadDemoMap(MAP& m)
+{
+	m.clear();
+	for (size_t i = 0; i < N; i++)
+	{
+		float xyz[3], rgb[3];
+		demoPoint(i, xyz, rgb);
+		m.insertPoint(xyz[0], xyz[1], xyz[2]);
+		if constexpr (!std::is_same_v<MAP, CSimplePointsMap>)
+			m.setPointColor_fast(i, rgb[0], rgb[1], rgb[2]);
+	}
+}
+
+template <class MAP>
+void checkDemoMap(
+	const MAP& m, float xyzTol, float rgbTol, const std::string& desc)
+{
+	ASSERT_EQ(m.size(), N) << desc;
+	for (size_t i = 0; i < N; i++)
+	{
+		float xyz[3], rgb[3];
+		demoPoint(i, xyz, rgb);
+		float x, y, z;
+		m.getPoint(i, x, y, z);
+		EXPECT_NEAR(x, xyz[0], xyzTol) << desc << " i=" << i;
+		EXPECT_NEAR(y, xyz[1], xyzTol) << desc << " i=" << i;
+		EXPECT_NEAR(z, xyz[2], xyzTol) << desc << " i=" << i;
+
+		if constexpr (std::is_same_v<MAP, CPointsMapXYZI>)
+		{
+			EXPECT_NEAR(m.getPointIntensity_fast(i), rgb[0], rgbTol)
+				<< desc << " i=" << i;
+		}
+		if constexpr (std::is_same_v<MAP, CColouredPointsMap>)
+		{
+			float R, G, B;
+			m.getPointColor_fast(i, R, G, B);
+			EXPECT_NEAR(R, rgb[0], rgbTol) << desc << " i=" << i;
+			EXPECT_NEAR(G, rgb[1], rgbTol) << desc << " i=" << i;
+			EXPECT_NEAR(B, rgb[2], rgbTol) << desc << " i=" << i;
+		}
+		if (::testing::Test::HasFailure()) return;
+	}
+}
+
+template <class MAP>
+void do_test_PCD()
+{
+	const auto fil = mrpt::system::getTempFileName();
+	MAP m;
+	loadDemoMap(m);
+
+	for (const bool binary : {true, false})
+	{
+		const std::string desc = binary ? "binary" : "ascii";
+		ASSERT_TRUE(m.saveToPCDFile(fil, binary));
+		MAP m2;
+		std::string errMsg;
+		ASSERT_TRUE(m2.loadFromPCDFile(fil, errMsg)) << errMsg;
+		checkDemoMap(m2, 0, 1e-6f, desc);
+	}
+	mrpt::system::deleteFile(fil);
+}
+
+template <class MAP>
+void do_test_LAS()
+{
+	const auto fil = mrpt::system::getTempFileName();
+	MAP m;
+	loadDemoMap(m);
+
+	ASSERT_TRUE(m.saveToLASFile(fil));
+	MAP m2;
+	std::string errMsg;
+	ASSERT_TRUE(m2.loadFromLASFile(fil, errMsg)) << errMsg;
+	// 1 mm resolution:
+	checkDemoMap(m2, 0.6e-3f, 1e-4f, "LAS");
+
+	mrpt::system::deleteFile(fil);
+}
+
+// Appends the bytes of a float or double in the given byte order:
+template <typename T>
+void appendBytes(std::string& s, T v, bool bigEndian)
+{
+	using U = std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>;
+	U u;
+	std::memcpy(&u, &v, sizeof(u));
+	for (size_t i = 0; i < sizeof(u); i++)
+	{
+		const size_t byte = bigEndian ? sizeof(u) - 1 - i : i;
+		s.push_back(static_cast<char>((u >> (8 * byte)) & 0xff));
+	}
+}
+
+void writeTextFile(const std::string& fil, const std::string& s)
+{
+	std::vector<uint8_t> buf(s.begin(), s.end());
+	ASSERT_TRUE(mrpt::io::vectorToBinaryFile(buf, fil));
+}
+
+}  // namespace
+
+TEST(CSimplePointsMapTests, loadSavePCD) { do_test_PCD<CSimplePointsMap>(); }
+TEST(CColouredPointsMapTests, loadSavePCD)
+{
+	do_test_PCD<CColouredPointsMap>();
+}
+TEST(CPointsMapXYZI, loadSavePCD) { do_test_PCD<CPointsMapXYZI>(); }
+
+TEST(CSimplePointsMapTests, loadSaveLAS) { do_test_LAS<CSimplePointsMap>(); }
+TEST(CColouredPointsMapTests, loadSaveLAS)
+{
+	do_test_LAS<CColouredPointsMap>();
+}
+TEST(CPointsMapXYZI, loadSaveLAS) { do_test_LAS<CPointsMapXYZI>(); }
+
+TEST(CPointsMapTests, loadPCDCompressed)
+{
+	// 3 points, with y==x, so the y block is a LZF back reference to the
+	// x block:
+	const float xs[3] = {1.0f, 2.0f, 3.0f}, zs[3] = {-1.0f, -2.0f, -3.5f};
+	std::string lzf;
+	const auto literal = [&](const float* v) {
+		lzf.push_back(11);	// 12 bytes
+		for (int i = 0; i < 3; i++)
+			appendBytes(lzf, v[i], false);
+	};
+	literal(xs);
+	lzf += "\xE0\x03\x0B";  // copy 12 bytes, 12 bytes back
+	literal(zs);
+
+	std::string s =
+		"# .PCD v0.7\nVERSION 0.7\nFIELDS x y z\nSIZE 4 4 4\nTYPE F F F\n"
+		"COUNT 1 1 1\nWIDTH 3\nHEIGHT 1\nVIEWPOINT 0 0 0 1 0 0 0\n"
+		"POINTS 3\nDATA binary_compressed\n";
+	// Compressed and uncompressed sizes (uint32):
+	s += std::string("\x1D\0\0\0\x24\0\0\0", 8);
+	ASSERT_EQ(lzf.size(), 0x1DU);
+	s += lzf;
+
+	const auto fil = mrpt::system::getTempFileName();
+	writeTextFile(fil, s);
+
+	CSimplePointsMap m;
+	std::string errMsg;
+	ASSERT_TRUE(m.loadFromPCDFile(fil, errMsg)) << errMsg;
+	ASSERT_EQ(m.size(), 3U);
+	for (size_t i = 0; i < 3; i++)
+	{
+		float x, y, z;
+		m.getPoint(i, x, y, z);
+		EXPECT_EQ(x, xs[i]);
+		EXPECT_EQ(y, xs[i]);
+		EXPECT_EQ(z, zs[i]);
+	}
+
+	// Corrupted: back reference before the beginning
+	s[s.size() - 13 - 1] = 30;
+	writeTextFile(fil, s);
+	EXPECT_FALSE(m.loadFromPCDFile(fil, errMsg));
+	EXPECT_EQ(m.size(), 0U);
+
+	mrpt::system::deleteFile(fil);
+}
+
+TEST(CPointsMapTests, loadPCDTruncated)
+{
+	// A header claiming many more points than the file has:
+	const std::string header =
+		"# .PCD v0.7\nVERSION 0.7\nFIELDS x y z\nSIZE 4 4 4\nTYPE F F F\n"
+		"COUNT 1 1 1\nWIDTH 1000000000\nHEIGHT 1\n"
+		"VIEWPOINT 0 0 0 1 0 0 0\nPOINTS 1000000000\n";
+
+	const auto fil = mrpt::system::getTempFileName();
+	for (const std::string data :
+		 {"DATA ascii\n1 2 3\n4 5 6\n", "DATA binary\n0123456789ab"})
+	{
+		writeTextFile(fil, header + data);
+
+		CSimplePointsMap m;
+		std::string errMsg;
+		EXPECT_FALSE(m.loadFromPCDFile(fil, errMsg)) << data;
+		EXPECT_NE(errMsg.find("Truncated file"), std::string::npos) << errMsg;
+		EXPECT_EQ(m.size(), 0U);
+	}
+	mrpt::system::deleteFile(fil);
+}
+
+TEST(CPointsMapTests, loadLASTruncatedHeader)
+{
+	// A LAS 1.4 header (375 bytes) cut at 240 bytes:
+	std::string s(240, '\0');
+	s.replace(0, 4, "LASF");
+	s[24] = 1;	// Version 1.4
+	s[25] = 4;
+	s[94] = static_cast<char>(375 & 0xff);	// Header size
+	s[95] = static_cast<char>(375 >> 8);
+	s[96] = static_cast<char>(375 & 0xff);	// Offset to point data
+	s[97] = static_cast<char>(375 >> 8);
+	s[105] = 20;  // Point format 0 record length
+
+	const auto fil = mrpt::system::getTempFileName();
+	writeTextFile(fil, s);
+
+	CSimplePointsMap m;
+	std::string errMsg;
+	EXPECT_FALSE(m.loadFromLASFile(fil, errMsg));
+	EXPECT_NE(errMsg.find("Invalid header size"), std::string::npos)
+		<< errMsg;
+	EXPECT_EQ(m.size(), 0U);
+
+	mrpt::system::deleteFile(fil);
+}
+
+TEST(CPointsMapTests, loadPLY)
+{
+	const auto fil = mrpt::system::getTempFileName();
+
+	// ASCII, with 8-bit colors and faces:
+	writeTextFile(
+		fil,
+		"ply\nformat ascii 1.0\ncomment Test file\nelement vertex 3\n"
+		"property float x\nproperty float y\nproperty float z\n"
+		"property float nx\nproperty uchar red\nproperty uchar green\n"
+		"property uchar blue\nelement face 1\n"
+		"property list uchar int vertex_indices\nend_header\n"
+		"1 2 3 0 255 0 51\n"
+		"4 5 6 0 0 255 0\n"
+		"-7 8e-1 9.5 0 0 0 255\n"
+		"3 0 1 2\n");
+	{
+		CColouredPointsMap m;
+		std::vector<std::string> comments;
+		ASSERT_TRUE(m.loadFromPlyFile(fil, &comments))
+			<< m.getLoadPLYErrorString();
+		ASSERT_EQ(m.size(), 3U);
+		ASSERT_EQ(comments.size(), 1U);
+		EXPECT_EQ(comments[0], "Test file");
+
+		float x, y, z, R, G, B;
+		m.getPoint(2, x, y, z);
+		EXPECT_EQ(x, -7.0f);
+		EXPECT_EQ(y, 0.8f);
+		EXPECT_EQ(z, 9.5f);
+		m.getPointColor_fast(0, R, G, B);
+		EXPECT_NEAR(R, 1.0f, 1e-6f);
+		EXPECT_NEAR(G, 0.0f, 1e-6f);
+		EXPECT_NEAR(B, 0.2f, 1e-6f);
+	}
+
+	// Binary big endian, with intensity:
+	{
+		std::string s =
+			"ply\nformat binary_big_endian 1.0\nelement vertex 2\n"
+			"property double x\nproperty double y\nproperty double z\n"
+			"property float intensity\nend_header\n";
+		for (int i = 0; i < 2; i++)
+		{
+			appendBytes(s, 1.0 + i, true);
+			appendBytes(s, -2.0 * i, true);
+			appendBytes(s, 0.5, true);
+			appendBytes(s, 0.25f * i, true);
+		}
+		writeTextFile(fil, s);
+
+		CPointsMapXYZI m;
+		ASSERT_TRUE(m.loadFromPlyFile(fil)) << m.getLoadPLYErrorString();
+		ASSERT_EQ(m.size(), 2U);
+		float x, y, z;
+		m.getPoint(1, x, y, z);
+		EXPECT_EQ(x, 2.0f);
+		EXPECT_EQ(y, -2.0f);
+		EXPECT_EQ(z, 0.5f);
+		EXPECT_EQ(m.getPointIntensity_fast(1), 0.25f);
+	}
+	mrpt::system::deleteFile(fil);
+}
+
+TEST(CPointsMapTests, loadTextFile)
+{
+	const auto fil = mrpt::system::getTempFileName();
+	CSimplePointsMap m;
+
+	// Last line without '\n', CR+LF, extra columns:
+	writeTextFile(fil, "1 2 3\r\n  4\t5 6 7\n+8 9e1 -10");
+	ASSERT_TRUE(m.load3D_from_text_file(fil));
+	ASSERT_EQ(m.size(), 3U);
+	float x, y, z;
+	m.getPoint(2, x, y, z);
+	EXPECT_EQ(x, 8.0f);
+	EXPECT_EQ(y, 90.0f);
+	EXPECT_EQ(z, -10.0f);
+
+	ASSERT_TRUE(m.load2D_from_text_file(fil));
+	ASSERT_EQ(m.size(), 3U);
+	m.getPoint(1, x, y, z);
+	EXPECT_EQ(x, 4.0f);
+	EXPECT_EQ(y, 5.0f);
+	EXPECT_EQ(z, 0.0f);
+
+	// Many lines (several parsing blocks):
+	std::string s;
+	for (size_t i = 0; i < 200000; i++)
+		s += std::to_string(i) + " " + std::to_string(i % 100) + " 0.5\n";
+	writeTextFile(fil, s);
+	ASSERT_TRUE(m.load3D_from_text_file(fil));
+	ASSERT_EQ(m.size(), 200000U);
+	m.getPoint(123456, x, y, z);
+	EXPECT_EQ(x, 123456.0f);
+	EXPECT_EQ(y, 56.0f);
+
+	// Wrong lines:
+	writeTextFile(fil, "1 2 3\n4 5\n6 7 8\n");
+	EXPECT_FALSE(m.load3D_from_text_file(fil));
+	EXPECT_EQ(m.size(), 0U);
+	writeTextFile(fil, "1 2 3\n\n");
+	EXPECT_FALSE(m.load3D_from_text_file(fil));
+	s += "1 a 2\n";
+	writeTextFile(fil, s);
+	EXPECT_FALSE(m.load3D_from_text_file(fil));
+
+	EXPECT_FALSE(m.load3D_from_text_file("/this/file/does/not/exist.txt"));
+
+	mrpt::system::deleteFile(fil);
+}
@@ -13,6 +13,7 @@
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/maps/CWeightedPointsMap.h>
 #include <mrpt/poses/CPoint2D.h>
+#include <mrpt/poses/CPose3DInterpolator.h>
 
 #include <sstream>
 
@@ -264,3 +265,47 @@ TEST(CColouredPointsMapTests, loadSaveStreams)
 {
 	do_tests_loadSaveStreams<CColouredPointsMap>();
 }
+
+TEST(CSimplePointsMapTests, deskew)
+{
+	// Vehicle moving along +X at 10 m/s, sensor 1m above it:
+	const auto t0 = mrpt::Clock::now();
+	CPose3DInterpolator path;
+	path.setInterpolationMethod(imLinearSlerp);
+	path.insert(t0, TPose3D(0, 0, 0, 0, 0, 0));
+	path.insert(t0 + std::chrono::seconds(1), TPose3D(10, 0, 0, 0, 0, 0));
+	const CPose3D sensorPose(0, 0, 1, 0, 0, 0);
+
+	// All points seen at (1,2,0) in the sensor frame, every 100 us. Groups
+	// of 4 points share the same timestamp, like firings in a LIDAR packet:
+	const size_t N = 40000;
+	CSimplePointsMap m;
+	std::vector<mrpt::system::TTimeStamp> stamps;
+	for (size_t i = 0; i < N; i++)
+	{
+		m.insertPoint(1, 2, 0);
+		stamps.push_back(t0 + std::chrono::microseconds(100 * (i / 4)));
+	}
+	// Plus one point out of the path time span:
+	m.insertPoint(1, 2, 0);
+	stamps.push_back(t0 + std::chrono::seconds(2));
+
+	const auto nKept = m.deskew(stamps, path, sensorPose);
+	EXPECT_EQ(nKept, N);
+	ASSERT_EQ(m.size(), N);
+	for (size_t i = 0; i < N; i += 997)
+	{
+		const double t = 100e-6 * (i / 4);
+		EXPECT_NEAR(m.getPointsBufferRef_x()[i], 1 + 10 * t, 1e-4);
+		EXPECT_NEAR(m.getPointsBufferRef_y()[i], 2, 1e-4);
+		EXPECT_NEAR(m.getPointsBufferRef_z()[i], 1, 1e-4);
+	}
+
+	// Relative to the vehicle at t0+0.5s:
+	CSimplePointsMap m2;
+	m2.insertPoint(1, 2, 0);
+	m2.deskew(
+		{t0 + std::chrono::milliseconds(100)}, path, sensorPose,
+		t0 + std::chrono::milliseconds(500));
+	EXPECT_NEAR(m2.getPointsBufferRef_x()[0], 1 - 4, 1e-4);
+}
@@ -54,10 +54,12 @@ void CMatrixD::serializeFrom(mrpt::serialization::CArchive& in, uint8_t version)
 /** Serialize CSerializable Object to CSchemeArchiveBase derived object*/
 void CMatrixD::serializeTo(mrpt::serialization::CSchemeArchiveBase& out) const
 {
-	SCHEMA_SERIALIZE_DATATYPE_VERSION(1);
+	SCHEMA_SERIALIZE_DATATYPE_VERSION(2);
 	out["nrows"] = static_cast<uint32_t>(this->rows());
 	out["ncols"] = static_cast<uint32_t>(this->cols());
-	out["data"] = this->inMatlabFormat();
+	// Elements in row-major order:
+	const size_t n = static_cast<size_t>(this->rows()) * this->cols();
+	out["data"].writeArray(n ? this->data() : nullptr, n);
 }
 /** Serialize CSchemeArchiveBase derived object to CSerializable Object*/
 void CMatrixD::serializeFrom(mrpt::serialization::CSchemeArchiveBase& in)
@@ -71,6 +73,15 @@ void CMatrixD::serializeFrom(mrpt::serialization::CSchemeArchiveBase& in)
 			this->fromMatlabStringFormat(static_cast<std::string>(in["data"]));
 		}
 		break;
+		case 2:
+		{
+			const auto nrows = static_cast<uint32_t>(in["nrows"]),
+					   ncols = static_cast<uint32_t>(in["ncols"]);
+			this->setSize(nrows, ncols);
+			const size_t n = static_cast<size_t>(nrows) * ncols;
+			if (n) in["data"].readArray(this->data(), n);
+		}
+		break;
 		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
 	}
 }
@@ -0,0 +1,267 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/obs/CObservation.h>
+#include <mrpt/obs/CSensoryFrame.h>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace mrpt::obs
+{
+/** Compression of the chunks of a chunked rawlog file.
+ * \sa CChunkedRawlogWriter
+ * \ingroup mrpt_obs_grp
+ */
+enum class ChunkCompression : uint8_t
+{
+	None = 0,
+	/** zlib (deflate). Always available. */
+	Zlib = 1,
+	/** Zstandard: much faster than zlib, for similar ratios. Only available
+	 * if MRPT was built with libzstd (`MRPT_HAS_ZSTD`). */
+	Zstd = 2
+};
+
+/** Returns the fastest compression available in this build: Zstd if MRPT
+ * was built with libzstd, Zlib otherwise.
+ * \ingroup mrpt_obs_grp */
+ChunkCompression defaultChunkCompression();
+
+/** Options for CChunkedRawlogWriter
+ * \ingroup mrpt_obs_grp */
+struct TChunkedRawlogWriterOptions
+{
+	/** Chunks are compressed and written once they reach this size
+	 * (uncompressed bytes). Larger chunks compress better, smaller ones
+	 * make reads of short time ranges faster. */
+	size_t chunkSize = 1 << 20;
+
+	ChunkCompression compression = defaultChunkCompression();
+
+	/** Zstd compression level (1-19), or 0 for its default. zlib always
+	 * uses its default level. */
+	int compressionLevel = 0;
+};
+
+/** Which observations to read with CChunkedRawlogReader. Time limits are
+ * inclusive, and INVALID_TIMESTAMP means no limit.
+ * \ingroup mrpt_obs_grp */
+struct TChunkedRawlogReadFilter
+{
+	/** Empty means all */
+	std::set<std::string> sensorLabels;
+	mrpt::system::TTimeStamp fromTime = INVALID_TIMESTAMP;
+	mrpt::system::TTimeStamp toTime = INVALID_TIMESTAMP;
+};
+
+/** Writes a chunked rawlog file: a seekable, indexed alternative to `.rawlog`
+ * files, for fast partial reads by sensor label and time range.
+ *
+ * Observations are grouped in one channel per sensor label. Consecutive
+ * observations of the same channel are serialized into chunks of
+ * ~TOptions::chunkSize bytes, each compressed independently. At close(), an
+ * index of all channels and chunks (with their file offsets, number of
+ * entries and time ranges) is written at the end of the file, so
+ * CChunkedRawlogReader can read only the chunks of the requested sensors and
+ * time range, without decoding the rest.
+ *
+ * File layout (all integers are little-endian):
+ *  - Header: `MRPTCLOG` magic, format version (uint32).
+ *  - Chunks: compressed payload. Once decompressed, a sequence of entries,
+ *    each one: sequence number in the log (uint64), timestamp (int64,
+ *    mrpt::Clock ticks), size (uint32), and the serialized CObservation.
+ *  - Index: channels (label, class name, count, time range), chunks
+ *    (channel, compression, offset, sizes, number of entries, time range,
+ *    first sequence number) and the rawlog comment text.
+ *  - Trailer: offset of the index (uint64), `MRPTCIDX` magic.
+ *
+ * Only observations can be stored ("observations-only" rawlogs): sensory
+ * frames are stored as their individual observations.
+ *
+ * \code
+ * mrpt::obs::CChunkedRawlogWriter w;
+ * w.open("dataset.rawlogc");
+ * for (...) w.write(*obs);
+ * w.close();	// Writes the index
+ * \endcode
+ *
+ * \sa CChunkedRawlogReader, CRawlog::saveToChunkedRawlogFile()
+ * \ingroup mrpt_obs_grp
+ * \note (New in MRPT 2.4.3)
+ */
+class CChunkedRawlogWriter
+{
+   public:
+	using TOptions = TChunkedRawlogWriterOptions;
+
+	CChunkedRawlogWriter() = default;
+	/** Calls close(), ignoring errors */
+	~CChunkedRawlogWriter();
+
+	CChunkedRawlogWriter(const CChunkedRawlogWriter&) = delete;
+	CChunkedRawlogWriter& operator=(const CChunkedRawlogWriter&) = delete;
+
+	/** Creates (or truncates) the output file.
+	 * \exception std::exception On error creating the file, or if the
+	 * compression is not supported in this build. */
+	void open(const std::string& fileName, const TOptions& options = {});
+
+	bool isOpen() const { return m_isOpen; }
+
+	/** Appends one observation to the log. */
+	void write(const CObservation& obs);
+
+	/** Appends the observations of a sensory frame to the log. */
+	void write(const CSensoryFrame& sf);
+
+	/** Sets the rawlog comment text, saved in the index */
+	void setCommentText(const std::string& t) { m_comments = t; }
+
+	/** Number of observations written so far */
+	size_t size() const { return m_numEntries; }
+
+	/** Writes pending chunks and the index, and closes the file. Does nothing
+	 * if it is not open. */
+	void close();
+
+   private:
+	struct Channel
+	{
+		std::string sensorLabel, className;
+		uint64_t count = 0;
+		int64_t tMin = 0, tMax = 0;
+		// Chunk being filled:
+		std::vector<uint8_t> buf;
+		uint32_t bufEntries = 0;
+		int64_t bufTMin = 0, bufTMax = 0;
+		uint64_t bufFirstSeq = 0;
+	};
+	struct ChunkInfo
+	{
+		uint32_t channel = 0;
+		ChunkCompression compression = ChunkCompression::None;
+		uint64_t offset = 0, compressedSize = 0, size = 0;
+		uint32_t numEntries = 0;
+		int64_t tMin = 0, tMax = 0;
+		uint64_t firstSeq = 0;
+	};
+
+	mrpt::io::CFileOutputStream m_out;
+	bool m_isOpen = false;
+	TOptions m_options;
+	std::vector<Channel> m_channels;
+	std::map<std::string, uint32_t> m_channelByLabel;
+	std::vector<ChunkInfo> m_chunks;
+	uint64_t m_numEntries = 0;
+	std::string m_comments;
+
+	void flushChunk(uint32_t channelIdx);
+
+	friend class CChunkedRawlogReader;
+};
+
+/** Reads chunked rawlog files, written by CChunkedRawlogWriter.
+ *
+ * open() only reads the index at the end of the file. Then, read() selects
+ * the chunks of the requested sensor labels which overlap the requested time
+ * range, decompresses them one by one (at most one chunk per channel in
+ * memory), and returns their observations in the original log order.
+ * Observations out of the time range are skipped without deserializing them.
+ *
+ * \code
+ * mrpt::obs::CChunkedRawlogReader r;
+ * r.open("dataset.rawlogc");
+ * mrpt::obs::CChunkedRawlogReader::TReadFilter f;
+ * f.sensorLabels = {"LIDAR", "IMU"};
+ * f.fromTime = mrpt::Clock::fromDouble(t0);
+ * r.read([](const mrpt::obs::CObservation::Ptr& o) {
+ *     // ...
+ *     return true;  // or false to stop reading
+ * }, f);
+ * \endcode
+ *
+ * \sa CChunkedRawlogWriter, CRawlog::loadFromChunkedRawlogFile()
+ * \ingroup mrpt_obs_grp
+ * \note (New in MRPT 2.4.3)
+ */
+class CChunkedRawlogReader
+{
+   public:
+	/** Information about each channel (sensor label) in the file */
+	struct TChannelInfo
+	{
+		std::string sensorLabel;
+		/** Class of the first observation in the channel */
+		std::string className;
+		size_t numEntries = 0;
+		mrpt::system::TTimeStamp firstTimestamp = INVALID_TIMESTAMP;
+		mrpt::system::TTimeStamp lastTimestamp = INVALID_TIMESTAMP;
+	};
+
+	using TReadFilter = TChunkedRawlogReadFilter;
+
+	/** Callback for read(): return false to stop reading. */
+	using ObservationCallback =
+		std::function<bool(const CObservation::Ptr& obs)>;
+
+	CChunkedRawlogReader() = default;
+
+	/** Returns true if the file starts with the chunked rawlog header. */
+	static bool IsChunkedRawlogFile(const std::string& fileName);
+
+	/** Opens a file and reads its index.
+	 * \exception std::exception On errors opening the file, if it is not a
+	 * chunked rawlog, or if it is truncated (e.g. close() was never called
+	 * for it). */
+	void open(const std::string& fileName);
+
+	bool isOpen() const { return m_isOpen; }
+
+	/** Channels in the file (valid after open()) */
+	const std::vector<TChannelInfo>& channels() const { return m_channelsInfo; }
+
+	/** Total number of observations in the file */
+	size_t size() const { return m_numEntries; }
+
+	const std::string& getCommentText() const { return m_comments; }
+
+	/** Reads the observations passing the filter, in their original order,
+	 * and passes them to `callback`.
+	 * \return The number of observations passed to the callback.
+	 * \exception std::exception On read or decompression errors. */
+	size_t read(
+		const ObservationCallback& callback,
+		const TReadFilter& filter = TReadFilter());
+
+	/** \overload Returning the observations in a vector */
+	std::vector<CObservation::Ptr> read(
+		const TReadFilter& filter = TReadFilter());
+
+   private:
+	using ChunkInfo = CChunkedRawlogWriter::ChunkInfo;
+
+	mrpt::io::CFileInputStream m_in;
+	bool m_isOpen = false;
+	std::vector<TChannelInfo> m_channelsInfo;
+	std::vector<ChunkInfo> m_chunks;
+	size_t m_numEntries = 0;
+	std::string m_comments;
+
+	void readChunk(const ChunkInfo& c, std::vector<uint8_t>& out);
+};
+
+}  // namespace mrpt::obs
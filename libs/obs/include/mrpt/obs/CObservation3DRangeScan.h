@@ -583,7 +583,9 @@ class CObservation3DRangeScan : public CObservation
 	/** Gets (or generates upon first request) the 3D point cloud projection
 	 * look-up-table for the current depth camera intrinsics & distortion
 	 * parameters.
-	 * Returns a const reference to a global variable. Multithread safe.
+	 * Returns a const reference to a global cache. Multithread safe: the
+	 * reference remains valid at least until the next call to this method
+	 * from the same thread.
 	 * \sa unprojectInto */
 	const unproject_LUT_t& get_unproj_lut() const;
 
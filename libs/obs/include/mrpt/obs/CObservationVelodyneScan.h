@@ -15,6 +15,7 @@
 #include <mrpt/poses/CPose3D.h>
 #include <mrpt/serialization/CSerializable.h>
 
+#include <memory>
 #include <vector>
 
 namespace mrpt
@@ -51,9 +52,8 @@ namespace obs
  * end of one complete scan)
  * then this observation can be converted / loaded into the following other
  * classes:
- *  - Maps of points (these require first generating the pointcloud in this
- * observation object with
- * mrpt::obs::CObservationVelodyneScan::generatePointCloud() ):
+ *  - Maps of points (raw packets are decoded straight into the map if the
+ * pointcloud in this observation has not been generated):
  *    - mrpt::maps::CPointsMap::loadFromVelodyneScan() (available in all
  * derived classes)
  *    - and the generic method:mrpt::maps::CPointsMap::insertObservation()
@@ -352,9 +352,74 @@ class CObservationVelodyneScan : public CObservation
 	/** \overload For custom data storage as destination of the pointcloud. */
 	void generatePointCloud(
 		PointCloudStorageWrapper& dest,
+		const TGeneratePointCloudParameters& params =
+			TGeneratePointCloudParameters()) const;
+
+	/** Decodes one single raw data packet and appends its points to \a dest,
+	 * so packets can be converted as they arrive from the sensor instead of
+	 * waiting for a complete scan. Neither \a scan_packets nor \a point_cloud
+	 * are modified; this object only provides the calibration, range limits
+	 * and timestamp reference: the time of \a pkt is computed relative to the
+	 * first entry in \a scan_packets and CObservation::timestamp (or taken as
+	 * CObservation::timestamp if \a scan_packets is empty).
+	 * This form recomputes the decoding constants from the calibration on
+	 * each call; streaming code should use the TPacketDecodeCache overload.
+	 * \note `dest.reserve()` is not called by this method.
+	 * \note (New in MRPT 2.4.3)
+	 * \sa appendPacketToPointCloud(), generatePointCloud()
+	 */
+	void generatePointCloudFromPacket(
+		const TVelodyneRawPacket& pkt, PointCloudStorageWrapper& dest,
+		const TGeneratePointCloudParameters& params =
+			TGeneratePointCloudParameters()) const;
+
+	/** Constants derived from the calibration, range limits and
+	 * TGeneratePointCloudParameters, which generatePointCloudFromPacket()
+	 * needs to decode a packet. Keep one object alive among calls for
+	 * consecutive packets to avoid recomputing them (and reallocating their
+	 * buffers) for each packet: they are rebuilt automatically only if any of
+	 * their inputs changes. Not thread-safe: use one object per thread.
+	 * \note (New in MRPT 2.4.3)
+	 */
+	class TPacketDecodeCache
+	{
+	   public:
+		TPacketDecodeCache();
+		~TPacketDecodeCache();
+		TPacketDecodeCache(const TPacketDecodeCache&) = delete;
+		TPacketDecodeCache& operator=(const TPacketDecodeCache&) = delete;
+
+	   private:
+		friend class CObservationVelodyneScan;
+		struct Impl;
+		std::unique_ptr<Impl> m_impl;
+	};
+
+	/** \overload Reusing the decoding constants stored in \a cache, the
+	 * preferred form for per-packet streaming. */
+	void generatePointCloudFromPacket(
+		const TVelodyneRawPacket& pkt, PointCloudStorageWrapper& dest,
+		const TGeneratePointCloudParameters& params,
+		TPacketDecodeCache& cache) const;
+
+	/** Decodes one raw data packet and appends its points to \a point_cloud,
+	 * without clearing its previous contents. Used by
+	 * mrpt::hwdrivers::CVelodyneScanner to build the point cloud while
+	 * packets are being received.
+	 * \note (New in MRPT 2.4.3)
+	 * \sa generatePointCloudFromPacket()
+	 */
+	void appendPacketToPointCloud(
+		const TVelodyneRawPacket& pkt,
 		const TGeneratePointCloudParameters& params =
 			TGeneratePointCloudParameters());
 
+	/** \overload Reusing the decoding constants stored in \a cache */
+	void appendPacketToPointCloud(
+		const TVelodyneRawPacket& pkt,
+		const TGeneratePointCloudParameters& params,
+		TPacketDecodeCache& cache);
+
 	/** Results for generatePointCloudAlongSE3Trajectory() */
 	struct TGeneratePointCloudSE3Results
 	{
@@ -376,7 +441,14 @@ class CObservationVelodyneScan : public CObservation
 	 * contents are kept.
 	 * \param[out] results_stats Stats
 	 * \param[in] params Filtering and other parameters
-	 * \sa generatePointCloud(), TGeneratePointCloudParameters
+	 *
+	 * The vehicle pose is interpolated, and composed with the sensor pose,
+	 * once per data packet (all points in a packet share its timestamp).
+	 * Packets are decoded and transformed in parallel threads for large
+	 * scans; the order of output points is that of the packets.
+	 *
+	 * \sa generatePointCloud(), TGeneratePointCloudParameters,
+	 * mrpt::maps::CPointsMap::deskew()
 	 */
 	void generatePointCloudAlongSE3Trajectory(
 		const mrpt::poses::CPose3DInterpolator& vehicle_path,
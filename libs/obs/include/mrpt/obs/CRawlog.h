@@ -10,6 +10,7 @@
 
 #include <mrpt/config/CConfigFileMemory.h>
 #include <mrpt/obs/CActionCollection.h>
+#include <mrpt/obs/CChunkedRawlog.h>
 #include <mrpt/obs/CObservationComment.h>
 #include <mrpt/obs/CSensoryFrame.h>
 #include <mrpt/poses/CPose2D.h>
@@ -135,6 +136,7 @@ class CRawlog : public mrpt::serialization::CSerializable
 	 *  - Only if `non_obs_objects_are_legal` is true, any `CSerializable`
 	 * object is allowed in the log file. Otherwise, the read stops on classes
 	 * different from the ones listed in the item above.
+	 *  - A chunked rawlog file (see loadFromChunkedRawlogFile()).
 	 * \returns It returns false upon error reading or accessing the file.
 	 */
 	bool loadFromRawLogFile(
@@ -148,6 +150,35 @@ class CRawlog : public mrpt::serialization::CSerializable
 	 */
 	bool saveToRawLogFile(const std::string& fileName) const;
 
+	/** Loads the observations of a chunked rawlog file (see
+	 * CChunkedRawlogReader) which pass the given filter (by sensor label and
+	 * time range), replacing the current contents. Only the needed chunks of
+	 * the file are read.
+	 *
+	 * loadFromRawLogFile() also detects and loads entire chunked rawlogs.
+	 *
+	 * \returns false upon error reading or accessing the file.
+	 * \note (New in MRPT 2.4.3)
+	 */
+	bool loadFromChunkedRawlogFile(
+		const std::string& fileName,
+		const CChunkedRawlogReader::TReadFilter& filter =
+			CChunkedRawlogReader::TReadFilter());
+
+	/** Saves the contents to a chunked rawlog file (see
+	 * CChunkedRawlogWriter). Sensory frames are saved as their individual
+	 * observations. Actions are not supported by this format: they are
+	 * skipped, with a warning.
+	 *
+	 * \returns false if any error is found while writing/creating the target
+	 * file.
+	 * \note (New in MRPT 2.4.3)
+	 */
+	bool saveToChunkedRawlogFile(
+		const std::string& fileName,
+		const CChunkedRawlogWriter::TOptions& options =
+			CChunkedRawlogWriter::TOptions()) const;
+
 	/** Returns the number of actions / observations object in the sequence. */
 	size_t size() const;
 
@@ -409,6 +440,19 @@ class CRawlog : public mrpt::serialization::CSerializable
 		CActionCollection::Ptr& action, CSensoryFrame::Ptr& observations,
 		size_t& rawlogEntry) const;
 
+	/** Requests mrpt::img::CExternalImageCache to load in the background the
+	 * externally-stored images of the entries with indices in the range
+	 * [first, first+count) (clipped to size()), e.g. the next entries to be
+	 * visualized or processed. Supports images of CObservationImage,
+	 * CObservationStereoImages and CObservation3DRangeScan, either directly
+	 * stored as rawlog entries or within sensory frames.
+	 * Former prefetch requests not processed yet are discarded.
+	 * \return The number of image files requested.
+	 * \note Does nothing if the image cache is disabled.
+	 * \note (New in MRPT 2.4.3)
+	 */
+	size_t prefetchExternalImages(size_t first, size_t count) const;
+
 	/** Tries to auto-detect the external-images directory of the given rawlog
 	 *file.
 	 *  This searches for the existence of the directories:
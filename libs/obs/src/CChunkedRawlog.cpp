@@ -0,0 +1,507 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "obs-precomp.h"  // Precompiled headers
+//
+#include <mrpt/config.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/io/zip.h>
+#include <mrpt/obs/CChunkedRawlog.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/serialization/archiveFrom_std_vector.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <queue>
+
+#if MRPT_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace mrpt::obs;
+using namespace mrpt::serialization;
+
+namespace
+{
+const char FILE_MAGIC[8] = {'M', 'R', 'P', 'T', 'C', 'L', 'O', 'G'};
+const char INDEX_MAGIC[8] = {'M', 'R', 'P', 'T', 'C', 'I', 'D', 'X'};
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr size_t HEADER_SIZE = sizeof(FILE_MAGIC) + sizeof(uint32_t);
+constexpr size_t TRAILER_SIZE = sizeof(uint64_t) + sizeof(INDEX_MAGIC);
+
+// Each entry in a chunk: seq (u64), timestamp (i64), size (u32), object
+constexpr size_t ENTRY_HEADER_SIZE = 8 + 8 + 4;
+
+void putLE(std::vector<uint8_t>& buf, uint64_t v, size_t nBytes)
+{
+	for (size_t i = 0; i < nBytes; i++)
+		buf.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+uint64_t getLE(const uint8_t* p, size_t nBytes)
+{
+	uint64_t v = 0;
+	for (size_t i = 0; i < nBytes; i++)
+		v |= uint64_t(p[i]) << (8 * i);
+	return v;
+}
+
+int64_t toTicks(const mrpt::system::TTimeStamp& t)
+{
+	return t.time_since_epoch().count();
+}
+mrpt::system::TTimeStamp fromTicks(int64_t t)
+{
+	return mrpt::Clock::time_point(mrpt::Clock::duration(t));
+}
+
+void checkCompressionSupported(ChunkCompression c)
+{
+	switch (c)
+	{
+		case ChunkCompression::None:
+		case ChunkCompression::Zlib: return;
+		case ChunkCompression::Zstd:
+#if MRPT_HAS_ZSTD
+			return;
+#else
+			THROW_EXCEPTION(
+				"Zstd chunk compression requires MRPT built with libzstd");
+#endif
+		default:
+			THROW_EXCEPTION_FMT(
+				"Unknown chunk compression: %u", static_cast<unsigned>(c));
+	};
+}
+
+void compressChunk(
+	ChunkCompression c, [[maybe_unused]] int level,
+	std::vector<uint8_t>& in, std::vector<uint8_t>& out)
+{
+	switch (c)
+	{
+		case ChunkCompression::None: out.swap(in); break;
+		case ChunkCompression::Zlib:
+			mrpt::io::zip::compress(in.data(), in.size(), out);
+			break;
+		case ChunkCompression::Zstd:
+		{
+#if MRPT_HAS_ZSTD
+			out.resize(ZSTD_compressBound(in.size()));
+			const size_t n = ZSTD_compress(
+				out.data(), out.size(), in.data(), in.size(), level);
+			if (ZSTD_isError(n))
+				THROW_EXCEPTION_FMT("zstd error: %s", ZSTD_getErrorName(n));
+			out.resize(n);
+#endif
+		}
+		break;
+	};
+}
+
+void decompressChunk(
+	ChunkCompression c, std::vector<uint8_t>& in, std::vector<uint8_t>& out,
+	size_t outSize)
+{
+	checkCompressionSupported(c);
+	switch (c)
+	{
+		case ChunkCompression::None: out.swap(in); break;
+		case ChunkCompression::Zlib:
+		{
+			out.resize(outSize);
+			size_t actualSize = 0;
+			mrpt::io::zip::decompress(
+				in.data(), in.size(), out.data(), out.size(), actualSize);
+			out.resize(actualSize);
+		}
+		break;
+		case ChunkCompression::Zstd:
+		{
+#if MRPT_HAS_ZSTD
+			out.resize(outSize);
+			const size_t n =
+				ZSTD_decompress(out.data(), out.size(), in.data(), in.size());
+			if (ZSTD_isError(n))
+				THROW_EXCEPTION_FMT("zstd error: %s", ZSTD_getErrorName(n));
+			out.resize(n);
+#endif
+		}
+		break;
+	};
+	ASSERTMSG_(
+		out.size() == outSize, "Chunked rawlog: corrupted chunk (bad size)");
+}
+}  // namespace
+
+ChunkCompression mrpt::obs::defaultChunkCompression()
+{
+#if MRPT_HAS_ZSTD
+	return ChunkCompression::Zstd;
+#else
+	return ChunkCompression::Zlib;
+#endif
+}
+
+// ---------------------- CChunkedRawlogWriter ------------------------------
+
+CChunkedRawlogWriter::~CChunkedRawlogWriter()
+{
+	try
+	{
+		close();
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[~CChunkedRawlogWriter] Error closing the file: "
+				  << e.what() << "\n";
+	}
+}
+
+void CChunkedRawlogWriter::open(
+	const std::string& fileName, const TOptions& options)
+{
+	MRPT_START
+	close();
+	checkCompressionSupported(options.compression);
+	ASSERT_(options.chunkSize > 0);
+
+	if (!m_out.open(fileName))
+		THROW_EXCEPTION_FMT("Cannot create file: `%s`", fileName.c_str());
+
+	m_options = options;
+	m_channels.clear();
+	m_channelByLabel.clear();
+	m_chunks.clear();
+	m_numEntries = 0;
+	m_comments.clear();
+
+	m_out.Write(FILE_MAGIC, sizeof(FILE_MAGIC));
+	archiveFrom(m_out).WriteAs<uint32_t>(FORMAT_VERSION);
+	m_isOpen = true;
+	MRPT_END
+}
+
+void CChunkedRawlogWriter::write(const CObservation& obs)
+{
+	MRPT_START
+	ASSERTMSG_(m_isOpen, "write() called before open()");
+
+	uint32_t chIdx = 0;
+	if (auto it = m_channelByLabel.find(obs.sensorLabel);
+		it != m_channelByLabel.end())
+		chIdx = it->second;
+	else
+	{
+		chIdx = static_cast<uint32_t>(m_channels.size());
+		m_channelByLabel[obs.sensorLabel] = chIdx;
+		auto& newCh = m_channels.emplace_back();
+		newCh.sensorLabel = obs.sensorLabel;
+		newCh.className = obs.GetRuntimeClass()->className;
+	}
+	Channel& ch = m_channels[chIdx];
+
+	const int64_t t = toTicks(obs.timestamp);
+	const uint64_t seq = m_numEntries++;
+
+	// Entry header, with the object size filled in below:
+	const size_t hdrPos = ch.buf.size();
+	putLE(ch.buf, seq, 8);
+	putLE(ch.buf, static_cast<uint64_t>(t), 8);
+	putLE(ch.buf, 0, 4);
+	archiveFrom(ch.buf) << obs;
+	const uint64_t objSize = ch.buf.size() - hdrPos - ENTRY_HEADER_SIZE;
+	ASSERT_(objSize <= std::numeric_limits<uint32_t>::max());
+	for (size_t i = 0; i < 4; i++)
+		ch.buf[hdrPos + 16 + i] = static_cast<uint8_t>(objSize >> (8 * i));
+
+	if (ch.count++ == 0) ch.tMin = ch.tMax = t;
+	ch.tMin = std::min(ch.tMin, t);
+	ch.tMax = std::max(ch.tMax, t);
+
+	if (ch.bufEntries++ == 0)
+	{
+		ch.bufTMin = ch.bufTMax = t;
+		ch.bufFirstSeq = seq;
+	}
+	ch.bufTMin = std::min(ch.bufTMin, t);
+	ch.bufTMax = std::max(ch.bufTMax, t);
+
+	if (ch.buf.size() >= m_options.chunkSize) flushChunk(chIdx);
+	MRPT_END
+}
+
+void CChunkedRawlogWriter::write(const CSensoryFrame& sf)
+{
+	for (const auto& obs : sf)
+		if (obs) write(*obs);
+}
+
+void CChunkedRawlogWriter::flushChunk(uint32_t channelIdx)
+{
+	Channel& ch = m_channels[channelIdx];
+	if (!ch.bufEntries) return;
+
+	ChunkInfo c;
+	c.channel = channelIdx;
+	c.compression = m_options.compression;
+	c.size = ch.buf.size();
+	c.numEntries = ch.bufEntries;
+	c.tMin = ch.bufTMin;
+	c.tMax = ch.bufTMax;
+	c.firstSeq = ch.bufFirstSeq;
+
+	std::vector<uint8_t> compressed;
+	compressChunk(
+		c.compression, m_options.compressionLevel, ch.buf, compressed);
+	c.offset = m_out.getPosition();
+	c.compressedSize = compressed.size();
+	m_out.Write(compressed.data(), compressed.size());
+	m_chunks.push_back(c);
+
+	ch.buf.clear();
+	ch.bufEntries = 0;
+}
+
+void CChunkedRawlogWriter::close()
+{
+	MRPT_START
+	if (!m_isOpen) return;
+	m_isOpen = false;
+
+	for (uint32_t i = 0; i < m_channels.size(); i++)
+		flushChunk(i);
+
+	const uint64_t indexOffset = m_out.getPosition();
+	auto arch = archiveFrom(m_out);
+	arch.WriteAs<uint32_t>(m_channels.size());
+	for (const auto& ch : m_channels)
+		arch << ch.sensorLabel << ch.className << ch.count << ch.tMin
+			 << ch.tMax;
+	arch.WriteAs<uint64_t>(m_chunks.size());
+	for (const auto& c : m_chunks)
+	{
+		arch << c.channel;
+		arch.WriteAs<uint8_t>(static_cast<uint8_t>(c.compression));
+		arch << c.offset << c.compressedSize << c.size << c.numEntries
+			 << c.tMin << c.tMax << c.firstSeq;
+	}
+	arch << m_comments;
+
+	arch << indexOffset;
+	m_out.Write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+	m_out.close();
+
+	m_channels.clear();
+	m_channelByLabel.clear();
+	m_chunks.clear();
+	MRPT_END
+}
+
+// ---------------------- CChunkedRawlogReader ------------------------------
+
+bool CChunkedRawlogReader::IsChunkedRawlogFile(const std::string& fileName)
+{
+	mrpt::io::CFileInputStream f;
+	if (!f.open(fileName)) return false;
+	char magic[sizeof(FILE_MAGIC)];
+	return f.Read(magic, sizeof(magic)) == sizeof(magic) &&
+		std::memcmp(magic, FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+void CChunkedRawlogReader::open(const std::string& fileName)
+{
+	MRPT_START
+	m_isOpen = false;
+	m_channelsInfo.clear();
+	m_chunks.clear();
+	m_numEntries = 0;
+	m_comments.clear();
+
+	if (!m_in.open(fileName))
+		THROW_EXCEPTION_FMT("Cannot open file: `%s`", fileName.c_str());
+
+	const uint64_t fileSize = m_in.getTotalBytesCount();
+	auto arch = archiveFrom(m_in);
+
+	char magic[sizeof(FILE_MAGIC)];
+	if (fileSize < HEADER_SIZE + TRAILER_SIZE ||
+		m_in.Read(magic, sizeof(magic)) != sizeof(magic) ||
+		std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0)
+		THROW_EXCEPTION_FMT(
+			"Not a chunked rawlog file: `%s`", fileName.c_str());
+
+	if (const auto version = arch.ReadAs<uint32_t>();
+		version > FORMAT_VERSION)
+		THROW_EXCEPTION_FMT(
+			"Unsupported chunked rawlog format version: %u",
+			static_cast<unsigned>(version));
+
+	// Trailer:
+	m_in.Seek(fileSize - TRAILER_SIZE);
+	uint64_t indexOffset = 0;
+	arch >> indexOffset;
+	if (m_in.Read(magic, sizeof(magic)) != sizeof(magic) ||
+		std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 ||
+		indexOffset < HEADER_SIZE || indexOffset > fileSize - TRAILER_SIZE)
+		THROW_EXCEPTION_FMT(
+			"Chunked rawlog `%s` has no valid index (truncated file?)",
+			fileName.c_str());
+
+	// Index:
+	m_in.Seek(indexOffset);
+	const auto numChannels = arch.ReadAs<uint32_t>();
+	ASSERT_LE_(numChannels, fileSize);
+	m_channelsInfo.resize(numChannels);
+	for (auto& ch : m_channelsInfo)
+	{
+		uint64_t count = 0;
+		int64_t tMin = 0, tMax = 0;
+		arch >> ch.sensorLabel >> ch.className >> count >> tMin >> tMax;
+		ch.numEntries = count;
+		ch.firstTimestamp = fromTicks(tMin);
+		ch.lastTimestamp = fromTicks(tMax);
+		m_numEntries += count;
+	}
+	const auto numChunks = arch.ReadAs<uint64_t>();
+	ASSERT_LE_(numChunks, fileSize);
+	m_chunks.resize(numChunks);
+	for (auto& c : m_chunks)
+	{
+		arch >> c.channel;
+		c.compression = static_cast<ChunkCompression>(arch.ReadAs<uint8_t>());
+		arch >> c.offset >> c.compressedSize >> c.size >> c.numEntries >>
+			c.tMin >> c.tMax >> c.firstSeq;
+		ASSERTMSG_(
+			c.channel < numChannels && c.offset >= HEADER_SIZE &&
+				c.offset <= indexOffset &&
+				c.compressedSize <= indexOffset - c.offset,
+			"Chunked rawlog: corrupted index");
+	}
+	arch >> m_comments;
+
+	m_isOpen = true;
+	MRPT_END
+}
+
+void CChunkedRawlogReader::readChunk(
+	const ChunkInfo& c, std::vector<uint8_t>& out)
+{
+	std::vector<uint8_t> compressed(c.compressedSize);
+	m_in.Seek(c.offset);
+	if (m_in.Read(compressed.data(), compressed.size()) != compressed.size())
+		THROW_EXCEPTION("Chunked rawlog: error reading chunk");
+	decompressChunk(c.compression, compressed, out, c.size);
+}
+
+size_t CChunkedRawlogReader::read(
+	const ObservationCallback& callback, const TReadFilter& filter)
+{
+	MRPT_START
+	ASSERTMSG_(m_isOpen, "read() called before open()");
+
+	const bool hasFrom = filter.fromTime != INVALID_TIMESTAMP;
+	const bool hasTo = filter.toTime != INVALID_TIMESTAMP;
+	const int64_t tFrom = hasFrom ? toTicks(filter.fromTime) : 0;
+	const int64_t tTo = hasTo ? toTicks(filter.toTime) : 0;
+	const auto inTimeRange = [&](int64_t t0, int64_t t1) {
+		return (!hasFrom || t1 >= tFrom) && (!hasTo || t0 <= tTo);
+	};
+
+	// Chunks to read, per channel (already in log order):
+	struct ChannelCursor
+	{
+		std::vector<const ChunkInfo*> chunks;
+		size_t nextChunk = 0;
+		std::vector<uint8_t> payload;
+		size_t pos = 0;	 // Current entry in payload
+		uint64_t seq = 0;
+		int64_t t = 0;
+		size_t objSize = 0;
+	};
+	std::vector<ChannelCursor> cursors(m_channelsInfo.size());
+	for (const auto& c : m_chunks)
+	{
+		const auto& label = m_channelsInfo[c.channel].sensorLabel;
+		if (!filter.sensorLabels.empty() && !filter.sensorLabels.count(label))
+			continue;
+		if (!inTimeRange(c.tMin, c.tMax)) continue;
+		cursors[c.channel].chunks.push_back(&c);
+	}
+
+	// Moves a cursor to its next entry, loading chunks as needed.
+	// Returns false at the end.
+	const auto advance = [&](ChannelCursor& cur, bool first) {
+		if (!first) cur.pos += ENTRY_HEADER_SIZE + cur.objSize;
+		while (cur.pos >= cur.payload.size())
+		{
+			if (cur.nextChunk >= cur.chunks.size())
+			{
+				cur.payload.clear();
+				return false;
+			}
+			readChunk(*cur.chunks[cur.nextChunk++], cur.payload);
+			cur.pos = 0;
+		}
+		ASSERTMSG_(
+			cur.payload.size() - cur.pos >= ENTRY_HEADER_SIZE,
+			"Chunked rawlog: corrupted chunk");
+		const uint8_t* p = cur.payload.data() + cur.pos;
+		cur.seq = getLE(p, 8);
+		cur.t = static_cast<int64_t>(getLE(p + 8, 8));
+		cur.objSize = getLE(p + 16, 4);
+		ASSERTMSG_(
+			cur.payload.size() - cur.pos - ENTRY_HEADER_SIZE >= cur.objSize,
+			"Chunked rawlog: corrupted chunk");
+		return true;
+	};
+
+	// Merge channels by sequence number, to restore the original order:
+	using seq_cursor_t = std::pair<uint64_t, size_t>;
+	std::priority_queue<
+		seq_cursor_t, std::vector<seq_cursor_t>, std::greater<seq_cursor_t>>
+		next;
+	for (size_t i = 0; i < cursors.size(); i++)
+		if (!cursors[i].chunks.empty() && advance(cursors[i], true))
+			next.emplace(cursors[i].seq, i);
+
+	size_t numRead = 0;
+	mrpt::io::CMemoryStream objStream;
+	while (!next.empty())
+	{
+		auto& cur = cursors[next.top().second];
+		next.pop();
+
+		if (inTimeRange(cur.t, cur.t))
+		{
+			objStream.assignMemoryNotOwn(
+				cur.payload.data() + cur.pos + ENTRY_HEADER_SIZE, cur.objSize);
+			const auto obs = archiveFrom(objStream).ReadObject<CObservation>();
+			numRead++;
+			if (!callback(obs)) break;
+		}
+		if (advance(cur, false)) next.emplace(cur.seq, &cur - &cursors[0]);
+	}
+	return numRead;
+	MRPT_END
+}
+
+std::vector<CObservation::Ptr> CChunkedRawlogReader::read(
+	const TReadFilter& filter)
+{
+	std::vector<CObservation::Ptr> out;
+	read(
+		[&](const CObservation::Ptr& obs) {
+			out.push_back(obs);
+			return true;
+		},
+		filter);
+	return out;
+}
@@ -0,0 +1,219 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config.h>
+#include <mrpt/io/vector_loadsave.h>
+#include <mrpt/obs/CChunkedRawlog.h>
+#include <mrpt/obs/CObservationOdometry.h>
+#include <mrpt/obs/CRawlog.h>
+#include <mrpt/system/filesystem.h>
+
+#include <vector>
+
+using namespace mrpt::obs;
+
+namespace
+{
+const char* LABELS[3] = {"ODOM", "WHEELS", "VISUAL_ODOM"};
+
+// Observation #i: sensor LABELS[i%3] (except for a few ones), at t0+i/10 s,
+// with x=i.
+CObservationOdometry::Ptr makeObs(size_t i)
+{
+	auto o = CObservationOdometry::Create();
+	o->sensorLabel = LABELS[(i % 7 == 0) ? 0 : i % 3];
+	o->timestamp = mrpt::Clock::fromDouble(1.6e9 + 0.1 * i);
+	o->odometry = mrpt::poses::CPose2D(double(i), 0, 0);
+	return o;
+}
+size_t indexOf(const CObservation::Ptr& o)
+{
+	return static_cast<size_t>(
+		std::dynamic_pointer_cast<CObservationOdometry>(o)->odometry.x());
+}
+
+std::vector<ChunkCompression> compressionsToTest()
+{
+	std::vector<ChunkCompression> v = {
+		ChunkCompression::None, ChunkCompression::Zlib};
+#if MRPT_HAS_ZSTD
+	v.push_back(ChunkCompression::Zstd);
+#endif
+	return v;
+}
+
+constexpr size_t N = 1000;
+
+std::string writeTestFile(ChunkCompression c)
+{
+	const auto fil = mrpt::system::getTempFileName();
+	CChunkedRawlogWriter::TOptions opts;
+	opts.compression = c;
+	opts.chunkSize = 1000;	// bytes: many small chunks
+	CChunkedRawlogWriter w;
+	w.open(fil, opts);
+	w.setCommentText("Test dataset");
+	for (size_t i = 0; i < N; i++)
+		w.write(*makeObs(i));
+	EXPECT_EQ(w.size(), N);
+	w.close();
+	return fil;
+}
+}  // namespace
+
+TEST(CChunkedRawlog, writeReadAll)
+{
+	for (const auto c : compressionsToTest())
+	{
+		const auto fil = writeTestFile(c);
+		EXPECT_TRUE(CChunkedRawlogReader::IsChunkedRawlogFile(fil));
+
+		CChunkedRawlogReader r;
+		r.open(fil);
+		EXPECT_EQ(r.size(), N);
+		EXPECT_EQ(r.getCommentText(), "Test dataset");
+
+		// Channels, in order of appearance:
+		ASSERT_EQ(r.channels().size(), 3U);
+		size_t total = 0;
+		for (size_t i = 0; i < 3; i++)
+		{
+			const auto& ch = r.channels()[i];
+			EXPECT_EQ(ch.sensorLabel, LABELS[i]);
+			EXPECT_EQ(ch.className, "mrpt::obs::CObservationOdometry");
+			EXPECT_LE(ch.firstTimestamp, ch.lastTimestamp);
+			total += ch.numEntries;
+		}
+		EXPECT_EQ(total, N);
+		EXPECT_EQ(r.channels()[0].firstTimestamp, makeObs(0)->timestamp);
+
+		// All, in the original order:
+		const auto all = r.read();
+		ASSERT_EQ(all.size(), N);
+		for (size_t i = 0; i < N; i++)
+		{
+			const auto expected = makeObs(i);
+			EXPECT_EQ(indexOf(all[i]), i);
+			EXPECT_EQ(all[i]->sensorLabel, expected->sensorLabel);
+			EXPECT_EQ(all[i]->timestamp, expected->timestamp);
+		}
+		mrpt::system::deleteFile(fil);
+	}
+}
+
+TEST(CChunkedRawlog, partialReads)
+{
+	const auto fil = writeTestFile(ChunkCompression::Zlib);
+	CChunkedRawlogReader r;
+	r.open(fil);
+
+	const auto check = [&](const CChunkedRawlogReader::TReadFilter& f) {
+		std::vector<size_t> expected, got;
+		for (size_t i = 0; i < N; i++)
+		{
+			const auto o = makeObs(i);
+			const bool labelOk = f.sensorLabels.empty() ||
+				f.sensorLabels.count(o->sensorLabel) != 0;
+			const auto t = o->timestamp;
+			const bool timeOk =
+				(f.fromTime == INVALID_TIMESTAMP || t >= f.fromTime) &&
+				(f.toTime == INVALID_TIMESTAMP || t <= f.toTime);
+			if (labelOk && timeOk) expected.push_back(i);
+		}
+		for (const auto& o : r.read(f))
+			got.push_back(indexOf(o));
+		EXPECT_EQ(got, expected);
+		return got.size();
+	};
+
+	CChunkedRawlogReader::TReadFilter f;
+	f.sensorLabels = {"WHEELS"};
+	EXPECT_EQ(check(f), r.channels()[1].numEntries);
+
+	f.sensorLabels = {"ODOM", "VISUAL_ODOM"};
+	f.fromTime = makeObs(300)->timestamp;
+	f.toTime = makeObs(420)->timestamp;
+	EXPECT_GT(check(f), 50U);
+
+	f.sensorLabels.clear();
+	EXPECT_EQ(check(f), 121U);
+
+	f.fromTime = INVALID_TIMESTAMP;
+	EXPECT_EQ(check(f), 421U);
+
+	f.sensorLabels = {"UNKNOWN"};
+	EXPECT_EQ(check(f), 0U);
+
+	// Stop from the callback:
+	size_t count = 0;
+	const size_t nRead = r.read([&](const CObservation::Ptr& o) {
+		EXPECT_EQ(indexOf(o), count);
+		return ++count < 10;
+	});
+	EXPECT_EQ(nRead, 10U);
+
+	mrpt::system::deleteFile(fil);
+}
+
+TEST(CChunkedRawlog, badFiles)
+{
+	const auto fil = writeTestFile(ChunkCompression::Zlib);
+	std::vector<uint8_t> buf;
+	ASSERT_TRUE(mrpt::io::loadBinaryFile(buf, fil));
+
+	// Truncated (no index):
+	const auto filBad = mrpt::system::getTempFileName();
+	buf.resize(buf.size() - 5);
+	ASSERT_TRUE(mrpt::io::vectorToBinaryFile(buf, filBad));
+	CChunkedRawlogReader r;
+	EXPECT_TRUE(CChunkedRawlogReader::IsChunkedRawlogFile(filBad));
+	EXPECT_THROW(r.open(filBad), std::exception);
+	EXPECT_FALSE(r.isOpen());
+
+	// Not a chunked rawlog:
+	buf.assign(100, 0x20);
+	ASSERT_TRUE(mrpt::io::vectorToBinaryFile(buf, filBad));
+	EXPECT_FALSE(CChunkedRawlogReader::IsChunkedRawlogFile(filBad));
+	EXPECT_THROW(r.open(filBad), std::exception);
+
+	mrpt::system::deleteFile(fil);
+	mrpt::system::deleteFile(filBad);
+}
+
+TEST(CChunkedRawlog, CRawlog)
+{
+	CRawlog rawlog;
+	rawlog.setCommentText("comments");
+	for (size_t i = 0; i < 10; i++)
+		rawlog.insert(makeObs(i));
+	// Sensory frames are saved as observations:
+	CSensoryFrame sf;
+	sf.insert(makeObs(10));
+	sf.insert(makeObs(11));
+	rawlog.insert(sf);
+
+	const auto fil = mrpt::system::getTempFileName();
+	ASSERT_TRUE(rawlog.saveToChunkedRawlogFile(fil));
+
+	// Format auto-detected:
+	CRawlog loaded;
+	ASSERT_TRUE(loaded.loadFromRawLogFile(fil));
+	EXPECT_EQ(loaded.getCommentText(), "comments");
+	ASSERT_EQ(loaded.size(), 12U);
+	for (size_t i = 0; i < loaded.size(); i++)
+		EXPECT_EQ(indexOf(loaded.getAsObservation(i)), i);
+
+	CChunkedRawlogReader::TReadFilter f;
+	f.sensorLabels = {"WHEELS"};
+	ASSERT_TRUE(loaded.loadFromChunkedRawlogFile(fil, f));
+	EXPECT_EQ(loaded.size(), 3U);	// 1, 4, 10
+
+	mrpt::system::deleteFile(fil);
+}
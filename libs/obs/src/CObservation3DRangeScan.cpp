@@ -26,8 +26,10 @@
 #include <mrpt/system/filesystem.h>
 #include <mrpt/system/string_utils.h>
 
+#include <algorithm>
 #include <cstring>
 #include <limits>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 
@@ -74,7 +76,8 @@ struct hash<LUT_info>
 };
 }  // namespace std
 
-static std::unordered_map<LUT_info, CObservation3DRangeScan::unproject_LUT_t>
+static std::unordered_map<
+	LUT_info, std::shared_ptr<const CObservation3DRangeScan::unproject_LUT_t>>
 	LUTs;
 static std::mutex LUTs_mtx;
 
@@ -88,26 +91,29 @@ const CObservation3DRangeScan::unproject_LUT_t&
 	linfo.sensorPose = this->sensorPose;
 	linfo.range_is_depth = this->range_is_depth;
 
-	LUTs_mtx.lock();
-	// Protect against infinite memory growth: imagine sensorPose gets changed
-	// every time for a sweeping sensor, etc.
-	// Unlikely, but "just in case" (TM)
-	if (LUTs.size() > 100) LUTs.clear();
-
-	const unproject_LUT_t& ret = LUTs[linfo];
-
-	LUTs_mtx.unlock();
-
 	ASSERT_EQUAL_(rangeImage.cols(), static_cast<int>(cameraParams.ncols));
 	ASSERT_EQUAL_(rangeImage.rows(), static_cast<int>(cameraParams.nrows));
 
-	// already existed and was filled?
+	// The last LUT returned to each thread, kept alive even if another
+	// thread removes it from the cache:
+	thread_local std::shared_ptr<const unproject_LUT_t> lastLUT;
+
+	// already existed?
+	{
+		std::lock_guard<std::mutex> lck(LUTs_mtx);
+		if (auto it = LUTs.find(linfo); it != LUTs.end())
+		{
+			lastLUT = it->second;
+			return *lastLUT;
+		}
+	}
+
+	// fill LUT upon first use, out of the lock since it is costly:
 	unsigned int H = cameraParams.nrows, W = cameraParams.ncols;
 	const size_t WH = W * H;
-	if (ret.Kxs.size() == WH) return ret;
 
-	// fill LUT upon first use:
-	auto& lut = const_cast<unproject_LUT_t&>(ret);
+	auto newLUT = std::make_shared<unproject_LUT_t>();
+	auto& lut = *newLUT;
 
 	lut.Kxs.resize(WH);
 	lut.Kys.resize(WH);
@@ -174,7 +180,15 @@ const CObservation3DRangeScan::unproject_LUT_t&
 		*kzs_rot++ = v_rot.z;
 	}
 
-	return ret;
+	std::lock_guard<std::mutex> lck(LUTs_mtx);
+	// Protect against infinite memory growth: imagine sensorPose gets changed
+	// every time for a sweeping sensor, etc.
+	// Unlikely, but "just in case" (TM)
+	if (LUTs.size() > 100) LUTs.clear();
+
+	// If another thread built the same LUT meanwhile, keep theirs:
+	lastLUT = LUTs.emplace(linfo, std::move(newLUT)).first->second;
+	return *lastLUT;
 #else
 	THROW_EXCEPTION("This method requires MRPT built against OpenCV");
 #endif
@@ -199,47 +213,30 @@ bool CObservation3DRangeScan::EXTERNALS_AS_TEXT()
 // Data types for memory pooling CObservation3DRangeScan:
 #ifdef COBS3DRANGE_USE_MEMPOOL
 
-#include <mrpt/system/CGenericMemoryPool.h>
+#include <mrpt/system/CObjectPool.h>
 
-// Memory pool for XYZ points ----------------
-struct CObservation3DRangeScan_Points_MemPoolParams
-{
-	/** Width*Height, that is, the number of 3D points */
-	size_t WH{0};
-	inline bool isSuitable(
-		const CObservation3DRangeScan_Points_MemPoolParams& req) const
-	{
-		return WH >= req.WH;
-	}
-};
+// Memory pool for XYZ points, by size class of their capacity ----------------
 struct CObservation3DRangeScan_Points_MemPoolData
 {
 	std::vector<float> pts_x, pts_y, pts_z;
 	/** for each point, the corresponding (x,y) pixel coordinates */
 	std::vector<uint16_t> idxs_x, idxs_y;
 };
-using TMyPointsMemPool = mrpt::system::CGenericMemoryPool<
-	CObservation3DRangeScan_Points_MemPoolParams,
-	CObservation3DRangeScan_Points_MemPoolData>;
+using TMyPointsMemPool =
+	mrpt::system::CObjectPool<CObservation3DRangeScan_Points_MemPoolData>;
 
-// Memory pool for the rangeImage matrix ----------------
-struct CObservation3DRangeScan_Ranges_MemPoolParams
-{
-	/** Size of matrix */
-	int H{0}, W{0};
-	inline bool isSuitable(
-		const CObservation3DRangeScan_Ranges_MemPoolParams& req) const
-	{
-		return H == req.H && W == req.W;
-	}
-};
+// Memory pool for the rangeImage matrix, by (H,W) ----------------
 struct CObservation3DRangeScan_Ranges_MemPoolData
 {
 	mrpt::math::CMatrix_u16 rangeImage;
 };
-using TMyRangesMemPool = mrpt::system::CGenericMemoryPool<
-	CObservation3DRangeScan_Ranges_MemPoolParams,
-	CObservation3DRangeScan_Ranges_MemPoolData>;
+using TMyRangesMemPool = mrpt::system::CObjectPool<
+	CObservation3DRangeScan_Ranges_MemPoolData, uint64_t>;
+
+static uint64_t mempool_range_matrix_key(int H, int W)
+{
+	return (static_cast<uint64_t>(H) << 32) | static_cast<uint32_t>(W);
+}
 
 static void mempool_donate_xyz_buffers(CObservation3DRangeScan& obs)
 {
@@ -249,25 +246,21 @@ static void mempool_donate_xyz_buffers(CObservation3DRangeScan& obs)
 	TMyPointsMemPool* pool = TMyPointsMemPool::getInstance();
 	if (!pool) return;
 
-	CObservation3DRangeScan_Points_MemPoolParams mem_params;
-	mem_params.WH = obs.points3D_x.capacity();
-	if (obs.points3D_y.capacity() != mem_params.WH)
-		obs.points3D_y.resize(mem_params.WH);
-	if (obs.points3D_z.capacity() != mem_params.WH)
-		obs.points3D_z.resize(mem_params.WH);
-	if (obs.points3D_idxs_x.capacity() != mem_params.WH)
-		obs.points3D_idxs_x.resize(mem_params.WH);
-	if (obs.points3D_idxs_y.capacity() != mem_params.WH)
-		obs.points3D_idxs_y.resize(mem_params.WH);
-
-	auto* mem_block = new CObservation3DRangeScan_Points_MemPoolData();
+	const size_t capacity = std::min(
+		{obs.points3D_x.capacity(), obs.points3D_y.capacity(),
+		 obs.points3D_z.capacity(), obs.points3D_idxs_x.capacity(),
+		 obs.points3D_idxs_y.capacity()});
+
+	auto mem_block =
+		std::make_unique<CObservation3DRangeScan_Points_MemPoolData>();
 	obs.points3D_x.swap(mem_block->pts_x);
 	obs.points3D_y.swap(mem_block->pts_y);
 	obs.points3D_z.swap(mem_block->pts_z);
 	obs.points3D_idxs_x.swap(mem_block->idxs_x);
 	obs.points3D_idxs_y.swap(mem_block->idxs_y);
 
-	pool->dump_to_pool(mem_params, mem_block);
+	pool->release(
+		mrpt::system::size_class_floor(capacity), std::move(mem_block));
 }
 void mempool_donate_range_matrix(CObservation3DRangeScan& obs)
 {
@@ -278,14 +271,14 @@ void mempool_donate_range_matrix(CObservation3DRangeScan& obs)
 	TMyRangesMemPool* pool = TMyRangesMemPool::getInstance();
 	if (!pool) return;
 
-	CObservation3DRangeScan_Ranges_MemPoolParams mem_params;
-	mem_params.H = obs.rangeImage.rows();
-	mem_params.W = obs.rangeImage.cols();
+	const auto key =
+		mempool_range_matrix_key(obs.rangeImage.rows(), obs.rangeImage.cols());
 
-	auto* mem_block = new CObservation3DRangeScan_Ranges_MemPoolData();
+	auto mem_block =
+		std::make_unique<CObservation3DRangeScan_Ranges_MemPoolData>();
 	obs.rangeImage.swap(mem_block->rangeImage);
 
-	pool->dump_to_pool(mem_params, mem_block);
+	pool->release(key, std::move(mem_block));
 }
 #endif
 
@@ -1120,12 +1113,8 @@ void CObservation3DRangeScan::resizePoints3DVectors(const size_t WH)
 	TMyPointsMemPool* pool = TMyPointsMemPool::getInstance();
 	if (pool)
 	{
-		CObservation3DRangeScan_Points_MemPoolParams mem_params;
-		mem_params.WH = WH;
-
-		CObservation3DRangeScan_Points_MemPoolData* mem_block =
-			pool->request_memory(mem_params);
-
+		const size_t sizeClass = mrpt::system::size_class_ceil(WH);
+		auto mem_block = pool->tryAcquire(sizeClass);
 		if (mem_block)
 		{  // Take the memory via swaps:
 			points3D_x.swap(mem_block->pts_x);
@@ -1133,7 +1122,16 @@ void CObservation3DRangeScan::resizePoints3DVectors(const size_t WH)
 			points3D_z.swap(mem_block->pts_z);
 			points3D_idxs_x.swap(mem_block->idxs_x);
 			points3D_idxs_y.swap(mem_block->idxs_y);
-			delete mem_block;
+		}
+		else
+		{
+			// Allocate the whole size class, so the buffers can be reused
+			// for any size within it:
+			points3D_x.reserve(sizeClass);
+			points3D_y.reserve(sizeClass);
+			points3D_z.reserve(sizeClass);
+			points3D_idxs_x.reserve(sizeClass);
+			points3D_idxs_y.reserve(sizeClass);
 		}
 	}
 #endif
@@ -1164,17 +1162,10 @@ void CObservation3DRangeScan::rangeImage_setSize(const int H, const int W)
 	TMyRangesMemPool* pool = TMyRangesMemPool::getInstance();
 	if (pool && !ri_done)
 	{
-		CObservation3DRangeScan_Ranges_MemPoolParams mem_params;
-		mem_params.H = H;
-		mem_params.W = W;
-
-		CObservation3DRangeScan_Ranges_MemPoolData* mem_block =
-			pool->request_memory(mem_params);
-
+		auto mem_block = pool->tryAcquire(mempool_range_matrix_key(H, W));
 		if (mem_block)
 		{  // Take the memory via swaps:
 			rangeImage.swap(mem_block->rangeImage);
-			delete mem_block;
 			ri_done = true;
 		}
 	}
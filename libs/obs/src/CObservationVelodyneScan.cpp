@@ -10,12 +10,15 @@
 #include "obs-precomp.h"  // Precompiled headers
 //
 #include <mrpt/containers/stl_containers_utils.h>
+#include <mrpt/core/TaskScheduler.h>
 #include <mrpt/core/round.h>
 #include <mrpt/obs/CObservationVelodyneScan.h>
 #include <mrpt/poses/CPose3DInterpolator.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/serialization/stl_serialization.h>
 
+#include <array>
+#include <exception>
 #include <iostream>
 
 using namespace std;
@@ -134,424 +137,606 @@ static double VLP16AdjustTimeStamp(
 		(firingwithinblock * VLP16_FIRING_TOFFSET);
 }
 
-static void velodyne_scan_to_pointcloud(
-	const Velo& scan, const Velo::TGeneratePointCloudParameters& params,
+namespace
+{
+/** Constants shared by all the packets decoded with the same calibration and
+ * parameters, computed once instead of once per point. */
+struct VelodyneDecodeContext
+{
+	VelodyneDecodeContext() = default;
+	VelodyneDecodeContext(
+		const Velo& scan, const Velo::TGeneratePointCloudParameters& p)
+	{
+		update(scan, p);
+	}
+
+	/** Recomputes all constants, reusing the per-laser buffers */
+	void update(const Velo& scan, const Velo::TGeneratePointCloudParameters& p)
+	{
+		params = p;
+
+		// Access to sin/cos table:
+		mrpt::obs::T2DScanProperties scan_props;
+		scan_props.aperture = 2 * M_PI;
+		scan_props.nRays = Velo::ROTATION_MAX_UNITS;
+		scan_props.rightToLeft = true;
+		// The LUT contains sin/cos values for angles in this order: [180deg
+		// ... 0 deg ... -180 deg]
+		lut_sincos = &velodyne_sincos_tables.getSinCosForScan(scan_props);
+
+		minAzimuth_int = mrpt::round(p.minAzimuth_deg * 100);
+		maxAzimuth_int = mrpt::round(p.maxAzimuth_deg * 100);
+		realMinDist = std::max(mrpt::d2f(scan.minRange), p.minDistance);
+		realMaxDist = std::min(p.maxDistance, mrpt::d2f(scan.maxRange));
+		isolatedPointsFilterDistance_units = mrpt::round(
+			p.isolatedPointsFilterDistance / Velo::DISTANCE_RESOLUTION);
+
+		// This is: 16,32,64 depending on the LIDAR model
+		const auto& lc = scan.calibration.laser_corrections;
+		num_lasers = lc.size();
+		distanceCorrection.resize(num_lasers);
+		cosVert.resize(num_lasers);
+		sinVert.resize(num_lasers);
+		horzOffset.resize(num_lasers);
+		vertOffset.resize(num_lasers);
+		for (size_t i = 0; i < num_lasers; i++)
+		{
+			distanceCorrection[i] = lc[i].distanceCorrection;
+			cosVert[i] = mrpt::d2f(lc[i].cosVertCorrection);
+			sinVert[i] = mrpt::d2f(lc[i].sinVertCorrection);
+			horzOffset[i] = mrpt::d2f(lc[i].horizontalOffsetCorrection);
+			vertOffset[i] = mrpt::d2f(lc[i].verticalOffsetCorrection);
+		}
+		valid = true;
+	}
+
+	/** Whether update() would compute the same constants. Only costs a few
+	 * comparisons per laser, with no memory allocations. */
+	bool matches(
+		const Velo& scan, const Velo::TGeneratePointCloudParameters& p) const
+	{
+		if (!valid || minAzimuth_int != mrpt::round(p.minAzimuth_deg * 100) ||
+			maxAzimuth_int != mrpt::round(p.maxAzimuth_deg * 100) ||
+			realMinDist != std::max(mrpt::d2f(scan.minRange), p.minDistance) ||
+			realMaxDist != std::min(p.maxDistance, mrpt::d2f(scan.maxRange)) ||
+			isolatedPointsFilterDistance_units !=
+				mrpt::round(
+					p.isolatedPointsFilterDistance /
+					Velo::DISTANCE_RESOLUTION))
+			return false;
+
+		const auto& lc = scan.calibration.laser_corrections;
+		if (lc.size() != num_lasers) return false;
+		for (size_t i = 0; i < num_lasers; i++)
+		{
+			if (distanceCorrection[i] != lc[i].distanceCorrection ||
+				cosVert[i] != mrpt::d2f(lc[i].cosVertCorrection) ||
+				sinVert[i] != mrpt::d2f(lc[i].sinVertCorrection) ||
+				horzOffset[i] != mrpt::d2f(lc[i].horizontalOffsetCorrection) ||
+				vertOffset[i] != mrpt::d2f(lc[i].verticalOffsetCorrection))
+				return false;
+		}
+		return true;
+	}
+
+	bool valid = false;
+	Velo::TGeneratePointCloudParameters params;
+	const CSinCosLookUpTableFor2DScans::TSinCosValues* lut_sincos = nullptr;
+	int minAzimuth_int = 0, maxAzimuth_int = 0;
+	float realMinDist = 0, realMaxDist = 0;
+	int isolatedPointsFilterDistance_units = 0;
+	size_t num_lasers = 0;
+	/** Per-laser calibration, indexed by laser ID */
+	std::vector<double> distanceCorrection;
+	std::vector<float> cosVert, sinVert, horzOffset, vertOffset;
+};
+}  // namespace
+
+struct Velo::TPacketDecodeCache::Impl
+{
+	VelodyneDecodeContext ctx;
+};
+
+Velo::TPacketDecodeCache::TPacketDecodeCache() : m_impl(new Impl) {}
+Velo::TPacketDecodeCache::~TPacketDecodeCache() = default;
+
+/** Timestamp of one data packet, from the timestamp of the first packet in
+ * the scan (the observation timestamp) and the packets "us from the top of
+ * the hour" counter. */
+static mrpt::system::TTimeStamp velodyne_packet_timestamp(
+	const Velo& scan, const Velo::TVelodyneRawPacket& raw)
+{
+	if (scan.scan_packets.empty()) return scan.timestamp;
+
+	const uint32_t us_pkt0 = scan.scan_packets[0].gps_timestamp();
+	const uint32_t us_pkt_this = raw.gps_timestamp();
+	// Handle the case of time counter reset by new hour 00:00:00
+	const uint32_t us_ellapsed = (us_pkt_this >= us_pkt0)
+		? (us_pkt_this - us_pkt0)
+		: (1000000UL * 3600UL + us_pkt_this - us_pkt0);
+	return mrpt::system::timestampAdd(scan.timestamp, us_ellapsed * 1e-6);
+}
+
+static void velodyne_packet_to_pointcloud(
+	const Velo::TVelodyneRawPacket& rawPkt,
+	const mrpt::system::TTimeStamp pkt_tim, const VelodyneDecodeContext& ctx,
 	Velo::PointCloudStorageWrapper& out_pc)
 {
 	// Initially based on code from ROS velodyne & from
 	// vtkVelodyneHDLReader::vtkInternal::ProcessHDLPacket().
 	using mrpt::round;
 
-	// Access to sin/cos table:
-	mrpt::obs::T2DScanProperties scan_props;
-	scan_props.aperture = 2 * M_PI;
-	scan_props.nRays = Velo::ROTATION_MAX_UNITS;
-	scan_props.rightToLeft = true;
-	// The LUT contains sin/cos values for angles in this order: [180deg ... 0
-	// deg ... -180 deg]
-	const CSinCosLookUpTableFor2DScans::TSinCosValues& lut_sincos =
-		velodyne_sincos_tables.getSinCosForScan(scan_props);
-
-	const int minAzimuth_int = round(params.minAzimuth_deg * 100);
-	const int maxAzimuth_int = round(params.maxAzimuth_deg * 100);
-	const float realMinDist =
-		std::max(mrpt::d2f(scan.minRange), params.minDistance);
-	const float realMaxDist =
-		std::min(params.maxDistance, mrpt::d2f(scan.maxRange));
-	const auto isolatedPointsFilterDistance_units = mrpt::round(
-		params.isolatedPointsFilterDistance / Velo::DISTANCE_RESOLUTION);
-
-	// This is: 16,32,64 depending on the LIDAR model
-	const size_t num_lasers = scan.calibration.laser_corrections.size();
-
-	out_pc.resizeLaserCount(num_lasers);
-	out_pc.reserve(
-		Velo::SCANS_PER_BLOCK * scan.scan_packets.size() *
-			Velo::BLOCKS_PER_PACKET +
-		16);
+	const Velo::TVelodyneRawPacket* raw = &rawPkt;
+	const auto& params = ctx.params;
+	const auto& lut_sincos = *ctx.lut_sincos;
+	const size_t num_lasers = ctx.num_lasers;
 
-	for (size_t iPkt = 0; iPkt < scan.scan_packets.size(); iPkt++)
+	// Take the median rotational speed as a good value for interpolating
+	// the missing azimuths:
+	int median_azimuth_diff;
 	{
-		const Velo::TVelodyneRawPacket* raw = &scan.scan_packets[iPkt];
+		// In dual return, the azimuth rate is actually twice this
+		// estimation:
+		const unsigned int nBlocksPerAzimuth =
+			(raw->laser_return_mode == Velo::RETMODE_DUAL) ? 2 : 1;
+		const size_t nDiffs = Velo::BLOCKS_PER_PACKET - nBlocksPerAzimuth;
+		std::array<int, Velo::BLOCKS_PER_PACKET> diffs;
+		for (size_t i = 0; i < nDiffs; ++i)
+		{
+			int localDiff = (Velo::ROTATION_MAX_UNITS +
+							 raw->blocks[i + nBlocksPerAzimuth].rotation() -
+							 raw->blocks[i].rotation()) %
+				Velo::ROTATION_MAX_UNITS;
+			diffs[i] = localDiff;
+		}
+		std::nth_element(
+			diffs.begin(), diffs.begin() + Velo::BLOCKS_PER_PACKET / 2,
+			diffs.begin() + nDiffs);  // Calc median
+		median_azimuth_diff = diffs[Velo::BLOCKS_PER_PACKET / 2];
+	}
+
+	// Firings per packet
+	for (int block = 0; block < Velo::BLOCKS_PER_PACKET; block++)
+	{
+		const Velo::raw_block_t& blk = raw->blocks[block];
 
-		mrpt::system::TTimeStamp pkt_tim;  // Find out timestamp of this pkt
+		// ignore packets with mangled or otherwise different contents
+		if ((num_lasers != 64 && Velo::UPPER_BANK != blk.header()) ||
+			(blk.header() != Velo::UPPER_BANK &&
+			 blk.header() != Velo::LOWER_BANK))
 		{
-			const uint32_t us_pkt0 = scan.scan_packets[0].gps_timestamp();
-			const uint32_t us_pkt_this = raw->gps_timestamp();
-			// Handle the case of time counter reset by new hour 00:00:00
-			const uint32_t us_ellapsed = (us_pkt_this >= us_pkt0)
-				? (us_pkt_this - us_pkt0)
-				: (1000000UL * 3600UL + us_pkt_this - us_pkt0);
-			pkt_tim =
-				mrpt::system::timestampAdd(scan.timestamp, us_ellapsed * 1e-6);
+			cerr << "[Velo] skipping invalid packet: block " << block
+				 << " header value is " << blk.header();
+			continue;
 		}
 
-		// Take the median rotational speed as a good value for interpolating
-		// the missing azimuths:
-		int median_azimuth_diff;
+		const int dsr_offset = (blk.header() == Velo::LOWER_BANK) ? 32 : 0;
+		const auto azimuth_raw_f = mrpt::d2f(blk.rotation());
+		const bool block_is_dual_2nd_ranges =
+			(raw->laser_return_mode == Velo::RETMODE_DUAL &&
+			 ((block & 0x01) != 0));
+		const bool block_is_dual_last_ranges =
+			(raw->laser_return_mode == Velo::RETMODE_DUAL &&
+			 ((block & 0x01) == 0));
+
+		if (block_is_dual_last_ranges && !params.dualKeepLast) continue;
+		if (block_is_dual_2nd_ranges && !params.dualKeepStrongest) continue;
+
+		// 1st pass: decode all the ranges of the firing block at once into
+		// fixed-size arrays. These loops have no data-dependent control flow,
+		// so compilers turn them into SIMD code.
+		constexpr int NF = Velo::SCANS_PER_FIRING;
+		std::array<int32_t, NF> rawDist;
+		std::array<int32_t, NF> prevRawDist;
+		std::array<float, NF> distance;
+		std::array<uint8_t, NF> laserIds;
+		std::array<uint8_t, NF> valid;
+
+		for (int k = 0; k < NF; k++)
 		{
-			// In dual return, the azimuth rate is actually twice this
-			// estimation:
-			const unsigned int nBlocksPerAzimuth =
-				(raw->laser_return_mode == Velo::RETMODE_DUAL) ? 2 : 1;
-			const size_t nDiffs = Velo::BLOCKS_PER_PACKET - nBlocksPerAzimuth;
-			std::vector<int> diffs(nDiffs);
-			for (size_t i = 0; i < nDiffs; ++i)
-			{
-				int localDiff = (Velo::ROTATION_MAX_UNITS +
-								 raw->blocks[i + nBlocksPerAzimuth].rotation() -
-								 raw->blocks[i].rotation()) %
-					Velo::ROTATION_MAX_UNITS;
-				diffs[i] = localDiff;
-			}
-			std::nth_element(
-				diffs.begin(), diffs.begin() + Velo::BLOCKS_PER_PACKET / 2,
-				diffs.end());  // Calc median
-			median_azimuth_diff = diffs[Velo::BLOCKS_PER_PACKET / 2];
+			rawDist[k] = blk.laser_returns[k].distance();
+			// In dual return, if the distance is equal in both ranges,
+			// ignore one of them:
+			prevRawDist[k] = block_is_dual_2nd_ranges
+				? raw->blocks[block - 1].laser_returns[k].distance()
+				: -1;
+			// Detect VLP-16 data and adjust laser id if necessary
+			const int rawLaserId = k + dsr_offset;
+			laserIds[k] = static_cast<uint8_t>(
+				(num_lasers == 16 && rawLaserId >= 16) ? rawLaserId - 16
+													   : rawLaserId);
+		}
+		for (int k = 0; k < NF; k++)
+		{
+			const size_t id = laserIds[k];
+			const double corr =
+				id < num_lasers ? ctx.distanceCorrection[id] : .0;
+			distance[k] = mrpt::d2f(
+				rawDist[k] * Velo::DISTANCE_RESOLUTION + corr);
+			valid[k] = rawDist[k] != 0 && rawDist[k] != prevRawDist[k] &&
+				distance[k] >= ctx.realMinDist &&
+				distance[k] <= ctx.realMaxDist;
 		}
 
-		// Firings per packet
-		for (int block = 0; block < Velo::BLOCKS_PER_PACKET; block++)
+		// Isolated points filtering:
+		if (params.filterOutIsolatedPoints)
 		{
-			// ignore packets with mangled or otherwise different contents
-			if ((num_lasers != 64 &&
-				 Velo::UPPER_BANK != raw->blocks[block].header()) ||
-				(raw->blocks[block].header() != Velo::UPPER_BANK &&
-				 raw->blocks[block].header() != Velo::LOWER_BANK))
+			const int32_t th = ctx.isolatedPointsFilterDistance_units;
+			std::array<int32_t, NF> d;
+			for (int k = 0; k < NF; k++)
+				d[k] = static_cast<int16_t>(rawDist[k]);
+			for (int k = 0; k < NF; k++)
 			{
-				cerr << "[Velo] skipping invalid packet: block " << block
-					 << " header value is " << raw->blocks[block].header();
-				continue;
+				const bool prevOk = k == 0 ||
+					(d[k - 1] != 0 && std::abs(d[k] - d[k - 1]) <= th);
+				const bool nextOk = k == NF - 1 ||
+					(d[k + 1] != 0 && std::abs(d[k] - d[k + 1]) <= th);
+				valid[k] = valid[k] && prevOk && nextOk;
 			}
+		}
 
-			const int dsr_offset =
-				(raw->blocks[block].header() == Velo::LOWER_BANK) ? 32 : 0;
-			const auto azimuth_raw_f = mrpt::d2f(raw->blocks[block].rotation());
-			const bool block_is_dual_2nd_ranges =
-				(raw->laser_return_mode == Velo::RETMODE_DUAL &&
-				 ((block & 0x01) != 0));
-			const bool block_is_dual_last_ranges =
-				(raw->laser_return_mode == Velo::RETMODE_DUAL &&
-				 ((block & 0x01) == 0));
-
-			for (int dsr = 0, k = 0; dsr < Velo::SCANS_PER_FIRING; dsr++, k++)
-			{
-				if (!raw->blocks[block]
-						 .laser_returns[k]
-						 .distance())  // Invalid return?
-					continue;
+		// 2nd pass: only for the surviving returns.
+		for (int dsr = 0, k = 0; dsr < NF; dsr++, k++)
+		{
+			if (!valid[k]) continue;
 
-				const auto rawLaserId = static_cast<uint8_t>(dsr + dsr_offset);
-				uint8_t laserId = rawLaserId;
+			const uint8_t laserId = laserIds[k];
+			const bool firingWithinBlock = (k + dsr_offset) != laserId;
 
-				// Detect VLP-16 data and adjust laser id if necessary
-				bool firingWithinBlock = false;
-				if (num_lasers == 16)
+			ASSERT_LT_(laserId, num_lasers);
+
+			// Azimuth correction: correct for the laser rotation as a
+			// function of timing during the firings
+			double timestampadjustment = 0.0;  // [us] since beginning of scan
+			double blockdsr0 = 0.0;
+			double nextblockdsr0 = 1.0;
+			switch (num_lasers)
+			{
+				// VLP-16
+				case 16:
 				{
-					if (laserId >= 16)
+					if (raw->laser_return_mode == Velo::RETMODE_DUAL)
+					{
+						timestampadjustment = VLP16AdjustTimeStamp(
+							block / 2, laserId, firingWithinBlock);
+						nextblockdsr0 =
+							VLP16AdjustTimeStamp(block / 2 + 1, 0, 0);
+						blockdsr0 = VLP16AdjustTimeStamp(block / 2, 0, 0);
+					}
+					else
 					{
-						laserId -= 16;
-						firingWithinBlock = true;
+						timestampadjustment = VLP16AdjustTimeStamp(
+							block, laserId, firingWithinBlock);
+						nextblockdsr0 = VLP16AdjustTimeStamp(block + 1, 0, 0);
+						blockdsr0 = VLP16AdjustTimeStamp(block, 0, 0);
 					}
 				}
-
-				ASSERT_LT_(laserId, num_lasers);
-				const mrpt::obs::VelodyneCalibration::PerLaserCalib& calib =
-					scan.calibration.laser_corrections[laserId];
-
-				// In dual return, if the distance is equal in both ranges,
-				// ignore one of them:
-				if (block_is_dual_2nd_ranges)
+				break;
+				// HDL-32:
+				case 32:
+					timestampadjustment = HDL32AdjustTimeStamp(block, dsr);
+					nextblockdsr0 = HDL32AdjustTimeStamp(block + 1, 0);
+					blockdsr0 = HDL32AdjustTimeStamp(block, 0);
+					break;
+				case 64: break;
+				default:
 				{
-					if (raw->blocks[block].laser_returns[k].distance() ==
-						raw->blocks[block - 1].laser_returns[k].distance())
-						continue;  // duplicated point
-					if (!params.dualKeepStrongest) continue;
+					THROW_EXCEPTION("Error: unhandled LIDAR model!");
 				}
-				if (block_is_dual_last_ranges && !params.dualKeepLast) continue;
+			};
+
+			const int azimuthadjustment = mrpt::round(
+				median_azimuth_diff *
+				((timestampadjustment - blockdsr0) /
+				 (nextblockdsr0 - blockdsr0)));
+
+			const float azimuth_corrected_f = azimuth_raw_f + azimuthadjustment;
+			const int azimuth_corrected =
+				((int)round(azimuth_corrected_f)) % Velo::ROTATION_MAX_UNITS;
+
+			// Filter by azimuth:
+			if (!((ctx.minAzimuth_int < ctx.maxAzimuth_int &&
+				   azimuth_corrected >= ctx.minAzimuth_int &&
+				   azimuth_corrected <= ctx.maxAzimuth_int) ||
+				  (ctx.minAzimuth_int > ctx.maxAzimuth_int &&
+				   (azimuth_corrected <= ctx.maxAzimuth_int ||
+					azimuth_corrected >= ctx.minAzimuth_int))))
+				continue;
 
-				// Return distance:
-				const float distance = mrpt::d2f(
-					raw->blocks[block].laser_returns[k].distance() *
-						Velo::DISTANCE_RESOLUTION +
-					calib.distanceCorrection);
-				if (distance < realMinDist || distance > realMaxDist) continue;
+			// Vertical axis mis-alignment calibration:
+			const float cos_vert_angle = ctx.cosVert[laserId];
+			const float sin_vert_angle = ctx.sinVert[laserId];
+			const float horz_offset = ctx.horzOffset[laserId];
+			const float vert_offset = ctx.vertOffset[laserId];
+
+			float xy_distance = distance[k] * cos_vert_angle;
+			if (vert_offset != .0f)
+				xy_distance += vert_offset * sin_vert_angle;
+
+			const int azimuth_corrected_for_lut =
+				(azimuth_corrected + (Velo::ROTATION_MAX_UNITS / 2)) %
+				Velo::ROTATION_MAX_UNITS;
+			const float cos_azimuth =
+				lut_sincos.ccos[azimuth_corrected_for_lut];
+			const float sin_azimuth =
+				lut_sincos.csin[azimuth_corrected_for_lut];
+
+			// Compute raw position
+			const mrpt::math::TPoint3Df pt(
+				xy_distance * cos_azimuth +
+					horz_offset * sin_azimuth,	// MRPT +X = Velodyne +Y
+				-(xy_distance * sin_azimuth -
+				  horz_offset * cos_azimuth),  // MRPT +Y = Velodyne -X
+				distance[k] * sin_vert_angle + vert_offset);
+
+			bool add_point = true;
+			if (params.filterByROI &&
+				(pt.x > params.ROI_x_max || pt.x < params.ROI_x_min ||
+				 pt.y > params.ROI_y_max || pt.y < params.ROI_y_min ||
+				 pt.z > params.ROI_z_max || pt.z < params.ROI_z_min))
+				add_point = false;
+
+			if (params.filterBynROI &&
+				(pt.x <= params.nROI_x_max && pt.x >= params.nROI_x_min &&
+				 pt.y <= params.nROI_y_max && pt.y >= params.nROI_y_min &&
+				 pt.z <= params.nROI_z_max && pt.z >= params.nROI_z_min))
+				add_point = false;
+
+			if (!add_point) continue;
+
+			// Insert point:
+			out_pc.add_point(
+				pt.x, pt.y, pt.z, blk.laser_returns[k].intensity(), pkt_tim,
+				azimuth_corrected_f, laserId);
+
+		}  // end for k,dsr=[0,31]
+	}  // end for each block [0,11]
+}
 
-				// Isolated points filtering:
-				if (params.filterOutIsolatedPoints)
-				{
-					bool pass_filter = true;
-					const int16_t dist_this =
-						raw->blocks[block].laser_returns[k].distance();
-					if (k > 0)
-					{
-						const int16_t dist_prev =
-							raw->blocks[block].laser_returns[k - 1].distance();
-						if (!dist_prev ||
-							std::abs(dist_this - dist_prev) >
-								isolatedPointsFilterDistance_units)
-							pass_filter = false;
-					}
-					if (k < (Velo::SCANS_PER_FIRING - 1))
-					{
-						const int16_t dist_next =
-							raw->blocks[block].laser_returns[k + 1].distance();
-						if (!dist_next ||
-							std::abs(dist_this - dist_next) >
-								isolatedPointsFilterDistance_units)
-							pass_filter = false;
-					}
-					if (!pass_filter) continue;	 // Filter out this point
-				}
+static void velodyne_scan_to_pointcloud(
+	const Velo& scan, const Velo::TGeneratePointCloudParameters& params,
+	Velo::PointCloudStorageWrapper& out_pc)
+{
+	const VelodyneDecodeContext ctx(scan, params);
 
-				// Azimuth correction: correct for the laser rotation as a
-				// function of timing during the firings
-				double timestampadjustment =
-					0.0;  // [us] since beginning of scan
-				double blockdsr0 = 0.0;
-				double nextblockdsr0 = 1.0;
-				switch (num_lasers)
-				{
-					// VLP-16
-					case 16:
-					{
-						if (raw->laser_return_mode == Velo::RETMODE_DUAL)
-						{
-							timestampadjustment = VLP16AdjustTimeStamp(
-								block / 2, laserId, firingWithinBlock);
-							nextblockdsr0 =
-								VLP16AdjustTimeStamp(block / 2 + 1, 0, 0);
-							blockdsr0 = VLP16AdjustTimeStamp(block / 2, 0, 0);
-						}
-						else
-						{
-							timestampadjustment = VLP16AdjustTimeStamp(
-								block, laserId, firingWithinBlock);
-							nextblockdsr0 =
-								VLP16AdjustTimeStamp(block + 1, 0, 0);
-							blockdsr0 = VLP16AdjustTimeStamp(block, 0, 0);
-						}
-					}
-					break;
-					// HDL-32:
-					case 32:
-						timestampadjustment = HDL32AdjustTimeStamp(block, dsr);
-						nextblockdsr0 = HDL32AdjustTimeStamp(block + 1, 0);
-						blockdsr0 = HDL32AdjustTimeStamp(block, 0);
-						break;
-					case 64: break;
-					default:
-					{
-						THROW_EXCEPTION("Error: unhandled LIDAR model!");
-					}
-				};
-
-				const int azimuthadjustment = mrpt::round(
-					median_azimuth_diff *
-					((timestampadjustment - blockdsr0) /
-					 (nextblockdsr0 - blockdsr0)));
-
-				const float azimuth_corrected_f =
-					azimuth_raw_f + azimuthadjustment;
-				const int azimuth_corrected =
-					((int)round(azimuth_corrected_f)) %
-					Velo::ROTATION_MAX_UNITS;
-
-				// Filter by azimuth:
-				if (!((minAzimuth_int < maxAzimuth_int &&
-					   azimuth_corrected >= minAzimuth_int &&
-					   azimuth_corrected <= maxAzimuth_int) ||
-					  (minAzimuth_int > maxAzimuth_int &&
-					   (azimuth_corrected <= maxAzimuth_int ||
-						azimuth_corrected >= minAzimuth_int))))
-					continue;
-
-				// Vertical axis mis-alignment calibration:
-				const float cos_vert_angle = mrpt::d2f(calib.cosVertCorrection);
-				const float sin_vert_angle = mrpt::d2f(calib.sinVertCorrection);
-				const float horz_offset =
-					mrpt::d2f(calib.horizontalOffsetCorrection);
-				const float vert_offset =
-					mrpt::d2f(calib.verticalOffsetCorrection);
-
-				float xy_distance = distance * cos_vert_angle;
-				if (vert_offset != .0f)
-					xy_distance += vert_offset * sin_vert_angle;
-
-				const int azimuth_corrected_for_lut =
-					(azimuth_corrected + (Velo::ROTATION_MAX_UNITS / 2)) %
-					Velo::ROTATION_MAX_UNITS;
-				const float cos_azimuth =
-					lut_sincos.ccos[azimuth_corrected_for_lut];
-				const float sin_azimuth =
-					lut_sincos.csin[azimuth_corrected_for_lut];
-
-				// Compute raw position
-				const mrpt::math::TPoint3Df pt(
-					xy_distance * cos_azimuth +
-						horz_offset * sin_azimuth,	// MRPT +X = Velodyne +Y
-					-(xy_distance * sin_azimuth -
-					  horz_offset * cos_azimuth),  // MRPT +Y = Velodyne -X
-					distance * sin_vert_angle + vert_offset);
-
-				bool add_point = true;
-				if (params.filterByROI &&
-					(pt.x > params.ROI_x_max || pt.x < params.ROI_x_min ||
-					 pt.y > params.ROI_y_max || pt.y < params.ROI_y_min ||
-					 pt.z > params.ROI_z_max || pt.z < params.ROI_z_min))
-					add_point = false;
-
-				if (params.filterBynROI &&
-					(pt.x <= params.nROI_x_max && pt.x >= params.nROI_x_min &&
-					 pt.y <= params.nROI_y_max && pt.y >= params.nROI_y_min &&
-					 pt.z <= params.nROI_z_max && pt.z >= params.nROI_z_min))
-					add_point = false;
-
-				if (!add_point) continue;
-
-				// Insert point:
-				out_pc.add_point(
-					pt.x, pt.y, pt.z,
-					raw->blocks[block].laser_returns[k].intensity(), pkt_tim,
-					azimuth_corrected_f, laserId);
-
-			}  // end for k,dsr=[0,31]
-		}  // end for each block [0,11]
-	}  // end for each data packet
+	out_pc.resizeLaserCount(ctx.num_lasers);
+	out_pc.reserve(
+		Velo::SCANS_PER_BLOCK * scan.scan_packets.size() *
+			Velo::BLOCKS_PER_PACKET +
+		16);
+
+	for (const auto& pkt : scan.scan_packets)
+		velodyne_packet_to_pointcloud(
+			pkt, velodyne_packet_timestamp(scan, pkt), ctx, out_pc);
 }
 
 void Velo::generatePointCloud(
-	PointCloudStorageWrapper& dest, const TGeneratePointCloudParameters& params)
+	PointCloudStorageWrapper& dest,
+	const TGeneratePointCloudParameters& params) const
 {
 	velodyne_scan_to_pointcloud(*this, params, dest);
 }
 
-void Velo::generatePointCloud(const TGeneratePointCloudParameters& params)
+namespace
 {
-	struct PointCloudStorageWrapper_Inner : public PointCloudStorageWrapper
+/** Appends decoded points to a TPointCloud, without clearing it first */
+struct PointCloudStorageWrapper_TPointCloud
+	: public Velo::PointCloudStorageWrapper
+{
+	Velo::TPointCloud& pc_;
+	const Velo::TGeneratePointCloudParameters& params_;
+
+	PointCloudStorageWrapper_TPointCloud(
+		Velo::TPointCloud& pc, const Velo::TGeneratePointCloudParameters& p)
+		: pc_(pc), params_(p)
 	{
-		Velo& me_;
-		const TGeneratePointCloudParameters& params_;
-		PointCloudStorageWrapper_Inner(
-			Velo& me, const TGeneratePointCloudParameters& p)
-			: me_(me), params_(p)
-		{
-			// Reset point cloud:
-			me_.point_cloud.clear();
-		}
+	}
 
-		void resizeLaserCount(std::size_t n) override
-		{
-			me_.point_cloud.pointsForLaserID.resize(n);
-		}
+	void resizeLaserCount(std::size_t n) override
+	{
+		if (pc_.pointsForLaserID.size() < n) pc_.pointsForLaserID.resize(n);
+	}
 
-		void reserve(std::size_t n) override
+	void reserve(std::size_t n) override
+	{
+		pc_.reserve(n);
+		if (!pc_.pointsForLaserID.empty())
 		{
-			me_.point_cloud.reserve(n);
-			if (!me_.point_cloud.pointsForLaserID.empty())
-			{
-				const std::size_t n_per_ring =
-					100 + n / (me_.point_cloud.pointsForLaserID.size());
-				for (auto& v : me_.point_cloud.pointsForLaserID)
-					v.reserve(n_per_ring);
-			}
+			const std::size_t n_per_ring =
+				100 + n / (pc_.pointsForLaserID.size());
+			for (auto& v : pc_.pointsForLaserID)
+				v.reserve(n_per_ring);
 		}
+	}
 
-		void add_point(
-			float pt_x, float pt_y, float pt_z, uint8_t pt_intensity,
-			const mrpt::system::TTimeStamp& tim, const float azimuth,
-			uint16_t laser_id) override
+	void add_point(
+		float pt_x, float pt_y, float pt_z, uint8_t pt_intensity,
+		const mrpt::system::TTimeStamp& tim, const float azimuth,
+		uint16_t laser_id) override
+	{
+		const auto idx = pc_.x.size();
+		pc_.x.push_back(pt_x);
+		pc_.y.push_back(pt_y);
+		pc_.z.push_back(pt_z);
+		pc_.intensity.push_back(pt_intensity);
+		if (params_.generatePerPointTimestamp) { pc_.timestamp.push_back(tim); }
+		if (params_.generatePerPointAzimuth)
 		{
-			const auto idx = me_.point_cloud.x.size();
-			me_.point_cloud.x.push_back(pt_x);
-			me_.point_cloud.y.push_back(pt_y);
-			me_.point_cloud.z.push_back(pt_z);
-			me_.point_cloud.intensity.push_back(pt_intensity);
-			if (params_.generatePerPointTimestamp)
-			{ me_.point_cloud.timestamp.push_back(tim); }
-			if (params_.generatePerPointAzimuth)
-			{
-				const int azimuth_corrected =
-					round(azimuth) % Velo::ROTATION_MAX_UNITS;
-				me_.point_cloud.azimuth.push_back(
-					azimuth_corrected * ROTATION_RESOLUTION);
-			}
-			me_.point_cloud.laser_id.push_back(laser_id);
-			if (params_.generatePointsForLaserID)
-				me_.point_cloud.pointsForLaserID[laser_id].push_back(idx);
+			const int azimuth_corrected =
+				mrpt::round(azimuth) % Velo::ROTATION_MAX_UNITS;
+			pc_.azimuth.push_back(
+				azimuth_corrected * Velo::ROTATION_RESOLUTION);
 		}
-	};
+		pc_.laser_id.push_back(laser_id);
+		if (params_.generatePointsForLaserID)
+			pc_.pointsForLaserID[laser_id].push_back(idx);
+	}
+};
+}  // namespace
 
-	PointCloudStorageWrapper_Inner my_pc_wrap(*this, params);
+void Velo::generatePointCloud(const TGeneratePointCloudParameters& params)
+{
+	// Reset point cloud:
 	point_cloud.clear();
 
+	PointCloudStorageWrapper_TPointCloud my_pc_wrap(point_cloud, params);
 	generatePointCloud(my_pc_wrap, params);
 }
 
+void Velo::generatePointCloudFromPacket(
+	const TVelodyneRawPacket& pkt, PointCloudStorageWrapper& dest,
+	const TGeneratePointCloudParameters& params) const
+{
+	TPacketDecodeCache cache;
+	generatePointCloudFromPacket(pkt, dest, params, cache);
+}
+
+void Velo::generatePointCloudFromPacket(
+	const TVelodyneRawPacket& pkt, PointCloudStorageWrapper& dest,
+	const TGeneratePointCloudParameters& params,
+	TPacketDecodeCache& cache) const
+{
+	auto& ctx = cache.m_impl->ctx;
+	if (!ctx.matches(*this, params)) ctx.update(*this, params);
+	// Filters and flags are not part of the precomputed constants:
+	ctx.params = params;
+
+	dest.resizeLaserCount(ctx.num_lasers);
+	velodyne_packet_to_pointcloud(
+		pkt, velodyne_packet_timestamp(*this, pkt), ctx, dest);
+}
+
+void Velo::appendPacketToPointCloud(
+	const TVelodyneRawPacket& pkt, const TGeneratePointCloudParameters& params)
+{
+	TPacketDecodeCache cache;
+	appendPacketToPointCloud(pkt, params, cache);
+}
+
+void Velo::appendPacketToPointCloud(
+	const TVelodyneRawPacket& pkt, const TGeneratePointCloudParameters& params,
+	TPacketDecodeCache& cache)
+{
+	PointCloudStorageWrapper_TPointCloud my_pc_wrap(point_cloud, params);
+	generatePointCloudFromPacket(pkt, my_pc_wrap, params, cache);
+}
+
 void Velo::generatePointCloudAlongSE3Trajectory(
 	const mrpt::poses::CPose3DInterpolator& vehicle_path,
 	std::vector<mrpt::math::TPointXYZIu8>& out_points,
 	TGeneratePointCloudSE3Results& results_stats,
 	const TGeneratePointCloudParameters& params)
 {
-	struct PointCloudStorageWrapper_SE3_Interp : public PointCloudStorageWrapper
+	// Points of one packet, in sensor-local coordinates. All points in a
+	// packet share the same timestamp, so the vehicle pose is interpolated
+	// and composed with the sensor pose only once per packet.
+	struct PacketPoints : public PointCloudStorageWrapper
 	{
-		Velo& me_;
-		const mrpt::poses::CPose3DInterpolator& vehicle_path_;
-		std::vector<mrpt::math::TPointXYZIu8>& out_points_;
-		TGeneratePointCloudSE3Results& results_stats_;
-		mrpt::system::TTimeStamp last_query_tim_;
-		mrpt::poses::CPose3D last_query_;
-		bool last_query_valid_;
-
-		void reserve(std::size_t n) override
-		{
-			out_points_.reserve(out_points_.size() + n);
-		}
+		std::vector<float> x, y, z;
+		std::vector<uint8_t> intensity;
 
-		PointCloudStorageWrapper_SE3_Interp(
-			Velo& me, const mrpt::poses::CPose3DInterpolator& vehicle_path,
-			std::vector<mrpt::math::TPointXYZIu8>& out_points,
-			TGeneratePointCloudSE3Results& results_stats)
-			: me_(me),
-			  vehicle_path_(vehicle_path),
-			  out_points_(out_points),
-			  results_stats_(results_stats),
-			  last_query_tim_(INVALID_TIMESTAMP),
-			  last_query_valid_(false)
-		{
-		}
 		void add_point(
 			float pt_x, float pt_y, float pt_z, uint8_t pt_intensity,
-			const mrpt::system::TTimeStamp& tim,
+			[[maybe_unused]] const mrpt::system::TTimeStamp& tim,
 			[[maybe_unused]] const float azimuth,
 			[[maybe_unused]] uint16_t laser_id) override
 		{
-			// Use a cache since it's expected that the same timestamp is
-			// queried several times in a row:
-			if (last_query_tim_ != tim)
-			{
-				last_query_tim_ = tim;
-				vehicle_path_.interpolate(tim, last_query_, last_query_valid_);
-			}
+			x.push_back(pt_x);
+			y.push_back(pt_y);
+			z.push_back(pt_z);
+			intensity.push_back(pt_intensity);
+		}
+		void clear()
+		{
+			x.clear();
+			y.clear();
+			z.clear();
+			intensity.clear();
+		}
+	};
+
+	struct ChunkOutput
+	{
+		std::vector<mrpt::math::TPointXYZIu8> points;
+		TGeneratePointCloudSE3Results stats;
+	};
+
+	const VelodyneDecodeContext ctx(*this, params);
+	const size_t nPkts = scan_packets.size();
+	// Contiguous ranges of packets (min. 16 per range), a few per thread:
+	auto& scheduler = mrpt::TaskScheduler::Instance();
+	const size_t nChunks = std::max<size_t>(
+		1, std::min<size_t>(4 * scheduler.concurrency(), nPkts / 16));
+	std::vector<ChunkOutput> chunks(nChunks);
+
+	mrpt::parallel_for(0, nChunks, 1, [&](size_t chunk0, size_t chunk1) {
+		for (size_t chunkIdx = chunk0; chunkIdx < chunk1; chunkIdx++)
+		{
+			const size_t pkt0 = chunkIdx * nPkts / nChunks,
+						 pkt1 = (chunkIdx + 1) * nPkts / nChunks;
+			ChunkOutput& out = chunks.at(chunkIdx);
+			out.points.reserve((pkt1 - pkt0) * Velo::SCANS_PER_PACKET);
+
+			PacketPoints pkt_pts;
+			mrpt::poses::CPose3D vehicle_pose;
+			mrpt::poses::CPose3D global_sensor_pose(
+				mrpt::poses::UNINITIALIZED_POSE);
 
-			if (last_query_valid_)
+			for (size_t iPkt = pkt0; iPkt < pkt1; iPkt++)
 			{
-				mrpt::poses::CPose3D global_sensor_pose(
-					mrpt::poses::UNINITIALIZED_POSE);
-				global_sensor_pose.composeFrom(last_query_, me_.sensorPose);
-				double gx, gy, gz;
-				global_sensor_pose.composePoint(pt_x, pt_y, pt_z, gx, gy, gz);
-				out_points_.emplace_back(gx, gy, gz, pt_intensity);
-				++results_stats_.num_correctly_inserted_points;
+				const auto& pkt = scan_packets[iPkt];
+				const auto pkt_tim = velodyne_packet_timestamp(*this, pkt);
+
+				pkt_pts.clear();
+				velodyne_packet_to_pointcloud(pkt, pkt_tim, ctx, pkt_pts);
+				const size_t n = pkt_pts.x.size();
+				out.stats.num_points += n;
+				if (!n) continue;
+
+				bool valid;
+				vehicle_path.interpolate(pkt_tim, vehicle_pose, valid);
+				if (!valid) continue;
+
+				global_sensor_pose.composeFrom(vehicle_pose, sensorPose);
+				const auto& R = global_sensor_pose.getRotationMatrix();
+				const double r00 = R(0, 0), r01 = R(0, 1), r02 = R(0, 2);
+				const double r10 = R(1, 0), r11 = R(1, 1), r12 = R(1, 2);
+				const double r20 = R(2, 0), r21 = R(2, 1), r22 = R(2, 2);
+				const double tx = global_sensor_pose.x(),
+							 ty = global_sensor_pose.y(),
+							 tz = global_sensor_pose.z();
+
+				// Transform the whole packet in one tight loop over SoA data:
+				const size_t i0 = out.points.size();
+				out.points.resize(i0 + n);
+				auto* dst = &out.points[i0];
+				const float *xs = pkt_pts.x.data(), *ys = pkt_pts.y.data(),
+							*zs = pkt_pts.z.data();
+				for (size_t k = 0; k < n; k++)
+				{
+					const double lx = xs[k], ly = ys[k], lz = zs[k];
+					dst[k].pt.x = r00 * lx + r01 * ly + r02 * lz + tx;
+					dst[k].pt.y = r10 * lx + r11 * ly + r12 * lz + ty;
+					dst[k].pt.z = r20 * lx + r21 * ly + r22 * lz + tz;
+					dst[k].intensity = pkt_pts.intensity[k];
+				}
+				out.stats.num_correctly_inserted_points += n;
 			}
-			++results_stats_.num_points;
 		}
-	};
-
-	PointCloudStorageWrapper_SE3_Interp my_pc_wrap(
-		*this, vehicle_path, out_points, results_stats);
-	velodyne_scan_to_pointcloud(*this, params, my_pc_wrap);
+	});
+
+	// Gather results, keeping the original packet order:
+	size_t nTotal = 0;
+	for (const auto& c : chunks)
+		nTotal += c.points.size();
+	out_points.reserve(out_points.size() + nTotal);
+	for (const auto& c : chunks)
+	{
+		out_points.insert(out_points.end(), c.points.begin(), c.points.end());
+		results_stats.num_points += c.stats.num_points;
+		results_stats.num_correctly_inserted_points +=
+			c.stats.num_correctly_inserted_points;
+	}
 }
 
 void Velo::TPointCloud::clear()
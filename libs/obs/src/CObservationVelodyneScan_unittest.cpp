@@ -0,0 +1,144 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/core/bits_math.h>
+#include <mrpt/obs/CObservationVelodyneScan.h>
+#include <mrpt/poses/CPose3DInterpolator.h>
+
+#include <cmath>
+#include <cstring>
+
+using mrpt::obs::CObservationVelodyneScan;
+
+namespace
+{
+void putLE16(uint8_t* p, uint16_t v)
+{
+	p[0] = static_cast<uint8_t>(v);
+	p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+/** A synthetic VLP-16 scan: `nPackets` packets, 1.33 ms apart, with
+ * varying azimuths, ranges and intensities. */
+CObservationVelodyneScan syntheticVLP16Scan(
+	size_t nPackets, mrpt::Clock::time_point t0)
+{
+	using Velo = CObservationVelodyneScan;
+
+	Velo scan;
+	scan.timestamp = t0;
+	scan.minRange = 1.0;
+	scan.maxRange = 130.0;
+	scan.sensorPose = mrpt::poses::CPose3D(
+		0.3, -0.1, 1.5, mrpt::DEG2RAD(10.0), mrpt::DEG2RAD(2.0), 0);
+
+	// 16 lasers, -15 to +15 deg:
+	auto& lc = scan.calibration.laser_corrections;
+	lc.resize(16);
+	for (size_t i = 0; i < lc.size(); i++)
+	{
+		const double a = mrpt::DEG2RAD(-15.0 + 2.0 * i);
+		lc[i].verticalCorrection = mrpt::RAD2DEG(a);
+		lc[i].sinVertCorrection = std::sin(a);
+		lc[i].cosVertCorrection = std::cos(a);
+	}
+
+	// Raw packets are little-endian byte streams:
+	static_assert(sizeof(Velo::TVelodyneRawPacket) == Velo::PACKET_SIZE);
+	for (size_t p = 0; p < nPackets; p++)
+	{
+		uint8_t buf[Velo::PACKET_SIZE];
+		std::memset(buf, 0, sizeof(buf));
+		for (int b = 0; b < Velo::BLOCKS_PER_PACKET; b++)
+		{
+			uint8_t* blk = buf + b * sizeof(Velo::raw_block_t);
+			putLE16(blk, Velo::UPPER_BANK);
+			putLE16(blk + 2, (p * Velo::BLOCKS_PER_PACKET + b) * 40 % 36000);
+			for (int k = 0; k < Velo::SCANS_PER_BLOCK; k++)
+			{
+				uint8_t* ret = blk + 4 + 3 * k;
+				// 2 to 10 m, in 2 mm units:
+				putLE16(ret, 1000 + (k * 373 + b * 117 + p * 29) % 4000);
+				ret[2] = static_cast<uint8_t>(k * 7 + b);
+			}
+		}
+		const uint32_t us = 1000 + 1330 * p;
+		uint8_t* tail =
+			buf + Velo::BLOCKS_PER_PACKET * sizeof(Velo::raw_block_t);
+		putLE16(tail, us & 0xffff);
+		putLE16(tail + 2, us >> 16);
+		tail[4] = Velo::RETMODE_STRONGEST;
+		tail[5] = 0x22;	 // VLP-16
+
+		Velo::TVelodyneRawPacket pkt;
+		std::memcpy(&pkt, buf, sizeof(pkt));
+		scan.scan_packets.push_back(pkt);
+	}
+	return scan;
+}
+}  // namespace
+
+TEST(CObservationVelodyneScan, generatePointCloudAlongSE3Trajectory)
+{
+	using mrpt::poses::CPose3D;
+
+	const auto t0 = mrpt::Clock::now();
+	auto scan = syntheticVLP16Scan(300, t0);
+
+	// A curved, climbing and pitching trajectory, which ends before the
+	// last packets of the scan so some points have no valid pose:
+	mrpt::poses::CPose3DInterpolator path;
+	path.setInterpolationMethod(mrpt::poses::imLinearSlerp);
+	for (int i = 0; i <= 7; i++)
+	{
+		const double t = 0.05 * i;
+		path.insert(
+			t0 + std::chrono::milliseconds(50 * i),
+			mrpt::math::TPose3D(
+				8.0 * t, 2.0 * std::sin(3 * t), 0.3 * t, 1.5 * t, 0.1 * t,
+				-0.05 * t));
+	}
+
+	CObservationVelodyneScan::TGeneratePointCloudParameters params;
+	std::vector<mrpt::math::TPointXYZIu8> pts;
+	CObservationVelodyneScan::TGeneratePointCloudSE3Results stats;
+	scan.generatePointCloudAlongSE3Trajectory(path, pts, stats, params);
+
+	// Serial reference: per-point interpolation and composition.
+	params.generatePerPointTimestamp = true;
+	scan.generatePointCloud(params);
+	const auto& pc = scan.point_cloud;
+	ASSERT_GT(pc.size(), 0U);
+	EXPECT_EQ(stats.num_points, pc.size());
+
+	std::vector<mrpt::math::TPointXYZIu8> expected;
+	for (size_t i = 0; i < pc.size(); i++)
+	{
+		CPose3D vehPose;
+		bool valid;
+		path.interpolate(pc.timestamp[i], vehPose, valid);
+		if (!valid) continue;
+		const auto g = (vehPose + scan.sensorPose).composePoint(
+			mrpt::math::TPoint3D(pc.x[i], pc.y[i], pc.z[i]));
+		expected.emplace_back(g.x, g.y, g.z, pc.intensity[i]);
+	}
+	EXPECT_LT(expected.size(), pc.size());
+	EXPECT_GT(expected.size(), 0U);
+	EXPECT_EQ(stats.num_correctly_inserted_points, expected.size());
+
+	ASSERT_EQ(pts.size(), expected.size());
+	for (size_t i = 0; i < pts.size(); i++)
+	{
+		EXPECT_NEAR(pts[i].pt.x, expected[i].pt.x, 1e-4) << "i=" << i;
+		EXPECT_NEAR(pts[i].pt.y, expected[i].pt.y, 1e-4) << "i=" << i;
+		EXPECT_NEAR(pts[i].pt.z, expected[i].pt.z, 1e-4) << "i=" << i;
+		EXPECT_EQ(pts[i].intensity, expected[i].intensity) << "i=" << i;
+	}
+}
@@ -11,7 +11,11 @@
 //
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/io/CFileGZOutputStream.h>
+#include <mrpt/img/CExternalImageCache.h>
 #include <mrpt/io/CFileInputStream.h>
+#include <mrpt/obs/CObservation3DRangeScan.h>
+#include <mrpt/obs/CObservationImage.h>
+#include <mrpt/obs/CObservationStereoImages.h>
 #include <mrpt/obs/CRawlog.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/filesystem.h>
@@ -172,6 +176,9 @@ void CRawlog::serializeFrom(mrpt::serialization::CArchive& in, uint8_t version)
 bool CRawlog::loadFromRawLogFile(
 	const std::string& fileName, bool non_obs_objects_are_legal)
 {
+	if (CChunkedRawlogReader::IsChunkedRawlogFile(fileName))
+		return loadFromChunkedRawlogFile(fileName);
+
 	// Open for read.
 	CFileGZInputStream fi;
 	if (!fi.open(fileName)) return false;
@@ -284,6 +291,67 @@ bool CRawlog::saveToRawLogFile(const std::string& fileName) const
 	}
 }
 
+bool CRawlog::loadFromChunkedRawlogFile(
+	const std::string& fileName,
+	const CChunkedRawlogReader::TReadFilter& filter)
+{
+	try
+	{
+		CChunkedRawlogReader reader;
+		reader.open(fileName);
+
+		clear();
+		m_commentTexts.text = reader.getCommentText();
+		m_seqOfActObs.reserve(reader.size());
+		reader.read(
+			[this](const CObservation::Ptr& obs) {
+				m_seqOfActObs.push_back(obs);
+				return true;
+			},
+			filter);
+		return true;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << mrpt::exception_to_str(e) << std::endl;
+		return false;
+	}
+}
+
+bool CRawlog::saveToChunkedRawlogFile(
+	const std::string& fileName,
+	const CChunkedRawlogWriter::TOptions& options) const
+{
+	try
+	{
+		CChunkedRawlogWriter writer;
+		writer.open(fileName, options);
+		writer.setCommentText(m_commentTexts.text);
+		size_t numSkipped = 0;
+		for (const auto& obj : m_seqOfActObs)
+		{
+			if (auto obs = std::dynamic_pointer_cast<CObservation>(obj); obs)
+				writer.write(*obs);
+			else if (auto sf = std::dynamic_pointer_cast<CSensoryFrame>(obj);
+					 sf)
+				writer.write(*sf);
+			else
+				numSkipped++;
+		}
+		writer.close();
+		if (numSkipped)
+			std::cerr << "[CRawlog::saveToChunkedRawlogFile] Warning: "
+					  << numSkipped
+					  << " entries which are not observations were skipped.\n";
+		return true;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << mrpt::exception_to_str(e) << std::endl;
+		return false;
+	}
+}
+
 void CRawlog::swap(CRawlog& obj)
 {
 	if (this == &obj) return;
@@ -547,3 +615,56 @@ std::string CRawlog::detectImagesDirectory(const std::string& str)
 	else
 		return rawlog_path + "Images";
 }
+
+namespace
+{
+void addExternalImage(
+	const mrpt::img::CImage& img, std::vector<std::string>& files)
+{
+	if (img.isExternallyStored())
+		files.push_back(img.getExternalStorageFileAbsolutePath());
+}
+
+void addExternalImages(
+	const CObservation::Ptr& obs, std::vector<std::string>& files)
+{
+	if (!obs) return;
+	if (auto o = std::dynamic_pointer_cast<CObservationImage>(obs); o)
+		addExternalImage(o->image, files);
+	else if (auto s = std::dynamic_pointer_cast<CObservationStereoImages>(obs);
+			 s)
+	{
+		addExternalImage(s->imageLeft, files);
+		if (s->hasImageRight) addExternalImage(s->imageRight, files);
+		if (s->hasImageDisparity) addExternalImage(s->imageDisparity, files);
+	}
+	else if (auto r = std::dynamic_pointer_cast<CObservation3DRangeScan>(obs);
+			 r)
+	{
+		if (r->hasIntensityImage) addExternalImage(r->intensityImage, files);
+		if (r->hasConfidenceImage)
+			addExternalImage(r->confidenceImage, files);
+	}
+}
+}  // namespace
+
+size_t CRawlog::prefetchExternalImages(size_t first, size_t count) const
+{
+	auto& cache = mrpt::img::CExternalImageCache::Instance();
+	if (!cache.enabled()) return 0;
+
+	std::vector<std::string> files;
+	const size_t last = std::min(first + count, m_seqOfActObs.size());
+	for (size_t i = first; i < last; i++)
+	{
+		const auto& entry = m_seqOfActObs[i];
+		if (auto sf = std::dynamic_pointer_cast<CSensoryFrame>(entry); sf)
+			for (const auto& obs : *sf)
+				addExternalImages(obs, files);
+		else
+			addExternalImages(
+				std::dynamic_pointer_cast<CObservation>(entry), files);
+	}
+	cache.prefetch(files);
+	return files.size();
+}
@@ -194,12 +194,16 @@ void CPointCloud::serializeTo(
 	out["pointSize"] = m_pointSize;
 	const auto N = m_points.size();
 	out["N"] = static_cast<uint64_t>(N);
+	std::vector<float> coords(N);
 	for (size_t i = 0; i < N; i++)
-	{
-		out["xs"][i] = m_points[i].x;
-		out["ys"][i] = m_points[i].y;
-		out["zs"][i] = m_points[i].z;
-	}
+		coords[i] = m_points[i].x;
+	out["xs"].writeArray(coords);
+	for (size_t i = 0; i < N; i++)
+		coords[i] = m_points[i].y;
+	out["ys"].writeArray(coords);
+	for (size_t i = 0; i < N; i++)
+		coords[i] = m_points[i].z;
+	out["zs"].writeArray(coords);
 	out["colorFromDepth_min"]["R"] = m_colorFromDepth_min.R;
 	out["colorFromDepth_min"]["G"] = m_colorFromDepth_min.G;
 	out["colorFromDepth_min"]["B"] = m_colorFromDepth_min.B;
@@ -224,12 +228,16 @@ void CPointCloud::serializeFrom(mrpt::serialization::CSchemeArchiveBase& in)
 			m_pointSize = static_cast<float>(in["pointSize"]);
 			const size_t N = static_cast<uint64_t>(in["N"]);
 			m_points.resize(N);
+			std::vector<float> coords(N);
+			if (N) in["xs"].readArray(coords.data(), N);
 			for (size_t i = 0; i < N; i++)
-			{
-				m_points[i].x = static_cast<float>(in["xs"][i]);
-				m_points[i].y = static_cast<float>(in["ys"][i]);
-				m_points[i].z = static_cast<float>(in["zs"][i]);
-			}
+				m_points[i].x = coords[i];
+			if (N) in["ys"].readArray(coords.data(), N);
+			for (size_t i = 0; i < N; i++)
+				m_points[i].y = coords[i];
+			if (N) in["zs"].readArray(coords.data(), N);
+			for (size_t i = 0; i < N; i++)
+				m_points[i].z = coords[i];
 			m_colorFromDepth_min.R =
 				static_cast<float>(in["colorFromDepth_min"]["R"]);
 			m_colorFromDepth_min.G =
@@ -174,27 +174,16 @@ void CRenderizableShaderTexturedTriangles::render(const RenderContext& rc) const
 // Data types for memory pooling CRenderizableShaderTexturedTriangles:
 #ifdef TEXTUREOBJ_USE_MEMPOOL
 
-#include <mrpt/system/CGenericMemoryPool.h>
+#include <mrpt/system/CObjectPool.h>
 
-struct CRenderizableShaderTexturedTriangles_MemPoolParams
-{
-	/** size of the vector<unsigned char> */
-	size_t len = 0;
-
-	inline bool isSuitable(
-		const CRenderizableShaderTexturedTriangles_MemPoolParams& req) const
-	{
-		return len == req.len;
-	}
-};
 struct CRenderizableShaderTexturedTriangles_MemPoolData
 {
 	vector<unsigned char> data;
 };
 
-using TMyMemPool = mrpt::system::CGenericMemoryPool<
-	CRenderizableShaderTexturedTriangles_MemPoolParams,
-	CRenderizableShaderTexturedTriangles_MemPoolData>;
+// Buffers are classified by the size class of their capacity:
+using TMyMemPool =
+	mrpt::system::CObjectPool<CRenderizableShaderTexturedTriangles_MemPoolData>;
 #endif
 
 void CRenderizableShaderTexturedTriangles::assignImage(
@@ -276,17 +265,15 @@ static unsigned char* reserveDataBuffer(
 	TMyMemPool* pool = TMyMemPool::getInstance();
 	if (pool)
 	{
-		CRenderizableShaderTexturedTriangles_MemPoolParams mem_params;
-		mem_params.len = len;
-
-		CRenderizableShaderTexturedTriangles_MemPoolData* mem_block =
-			pool->request_memory(mem_params);
+		const size_t sizeClass = mrpt::system::size_class_ceil(len);
+		auto mem_block = pool->tryAcquire(sizeClass);
 		if (mem_block)
 		{
 			// Recover the memory block via a swap:
 			data.swap(mem_block->data);
-			delete mem_block;
 		}
+		else
+			data.reserve(sizeClass);
 	}
 #endif
 	data.resize(len);
@@ -537,14 +524,14 @@ void CRenderizableShaderTexturedTriangles::initializeTextures() const
 			TMyMemPool* pool = TMyMemPool::getInstance();
 			if (pool)
 			{
-				CRenderizableShaderTexturedTriangles_MemPoolParams mem_params;
-				mem_params.len = data.size();
+				const size_t sizeClass =
+					mrpt::system::size_class_floor(data.capacity());
 
-				auto* mem_block =
-					new CRenderizableShaderTexturedTriangles_MemPoolData();
+				auto mem_block = std::make_unique<
+					CRenderizableShaderTexturedTriangles_MemPoolData>();
 				data.swap(mem_block->data);
 
-				pool->dump_to_pool(mem_params, mem_block);
+				pool->release(sizeClass, std::move(mem_block));
 			}
 		}
 #endif
@@ -14,6 +14,11 @@
 #include <mrpt/poses/poses_frwds.h>
 #include <mrpt/typemeta/TEnumType.h>
 
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
 namespace mrpt::poses
 {
 /** Type to select the interpolation method in CPoseInterpolatorBase derived
@@ -100,6 +105,7 @@ class CPoseInterpolatorBase
 
 	iterator erase(iterator element_to_erase)
 	{
+		invalidateIndex();
 		m_path.erase(element_to_erase++);
 		return element_to_erase;
 	}
@@ -141,9 +147,68 @@ class CPoseInterpolatorBase
 		const mrpt::Clock::time_point& t, cpose_t& out_interp,
 		bool& out_valid_interp) const;
 
+	/** A hint for interpolate() with the position of the last query in the
+	 * path. If the contiguous index is enabled (see
+	 * enableContiguousIndex()), reusing the same cursor for (roughly)
+	 * monotonically increasing query times turns each lookup into an O(1)
+	 * step, instead of a binary search; otherwise, it is ignored.
+	 * A default-constructed cursor is always valid, and cursors remain valid
+	 * (just less useful) after modifying the path.
+	 * \note (New in MRPT 2.4.3)
+	 */
+	struct TInterpCursor
+	{
+		std::size_t idx = 0;
+	};
+
+	/** \overload Interpolation with a cursor (search hint), for sequences of
+	 * queries with increasing time. Results are identical to those of
+	 * interpolate() without the cursor.
+	 * \note (New in MRPT 2.4.3)
+	 */
+	pose_t& interpolate(
+		const mrpt::Clock::time_point& t, pose_t& out_interp,
+		bool& out_valid_interp, TInterpCursor& cursor) const;
+
+	/** Batch interpolation of a sequence of query times, which should be
+	 * sorted in increasing order for best performance (though it is not
+	 * required). Results are identical to calling interpolate() for each
+	 * time.
+	 * \param[in] ts The query times.
+	 * \param[out] out_interp The interpolated poses, resized to `ts.size()`.
+	 * \param[out] out_valid Whether each interpolated pose is valid, resized
+	 * to `ts.size()`.
+	 * \return The number of valid interpolated poses.
+	 * \note (New in MRPT 2.4.3)
+	 */
+	std::size_t interpolate(
+		const std::vector<mrpt::Clock::time_point>& ts,
+		std::vector<pose_t>& out_interp, std::vector<bool>& out_valid) const;
+
 	/** Clears the current sequence of poses */
 	void clear();
 
+	/** Enables (or disables) a contiguous copy of the path, as sorted
+	 * vectors of times and poses, which makes interpolate() queries faster
+	 * (and O(1) with a TInterpCursor for monotonic query times) at the cost
+	 * of duplicating the memory used by the path. Disabled by default.
+	 *
+	 * The index is kept up to date by insert(), erase(), clear(), filter()
+	 * and when loading the path, but poses modified through non-const
+	 * iterators or at() require calling invalidateIndex() afterwards.
+	 * \note (New in MRPT 2.4.3)
+	 */
+	void enableContiguousIndex(bool enable = true);
+	/** \sa enableContiguousIndex() */
+	bool isContiguousIndexEnabled() const { return m_index.enabled; }
+	/** Marks the contiguous index as outdated, so it is rebuilt in the next
+	 * query. Only needed after modifying poses through non-const iterators
+	 * or at() while the index is enabled.
+	 * \sa enableContiguousIndex()
+	 * \note (New in MRPT 2.4.3)
+	 */
+	void invalidateIndex() { m_index.valid = false; }
+
 	/** Set value of the maximum time to consider interpolation.
 	 * If set to a negative value, the check is disabled (default behavior). */
 	void setMaxTimeInterpolation(const mrpt::Clock::duration& time);
@@ -205,6 +270,33 @@ class CPoseInterpolatorBase
    protected:
 	/** The sequence of poses */
 	TPath m_path;
+
+	/** A contiguous copy of m_path, as sorted vectors of times and poses,
+	 * used for cache-friendly queries if enabled. It is built on demand and
+	 * kept up to date while poses are only appended at the end of the path.
+	 */
+	struct TContiguousIndex
+	{
+		TContiguousIndex() = default;
+		/** Do NOT copy neither the cache nor the mutex */
+		TContiguousIndex(const TContiguousIndex& o) : enabled(o.enabled) {}
+		TContiguousIndex& operator=(const TContiguousIndex& o)
+		{
+			enabled = o.enabled;
+			valid = false;
+			return *this;
+		}
+
+		bool enabled = false;
+		std::vector<mrpt::Clock::time_point> times;
+		std::vector<pose_t> poses;
+		std::atomic_bool valid{false};
+		std::mutex mtx;
+	};
+	mutable TContiguousIndex m_index;
+
+	/** Builds the contiguous index if needed. Thread-safe. */
+	void ensureIndex() const;
 	/** Maximum time considered to interpolate. If the difference between the
 	 * desired timestamp where to interpolate and the next timestamp stored in
 	 * the map is bigger than this value, the interpolation will not be done. */
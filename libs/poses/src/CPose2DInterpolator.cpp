@@ -37,6 +37,7 @@ void CPose2DInterpolator::serializeFrom(
 		break;
 		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
 	};
+	invalidateIndex();
 }
 
 namespace mrpt::poses
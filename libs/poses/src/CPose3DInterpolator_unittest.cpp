@@ -52,3 +52,119 @@ TEST(CPose3DInterpolator, interp)
 			.sum(),
 		2e-4);
 }
+
+TEST(CPose3DInterpolator, batchAndCursor)
+{
+	using namespace mrpt::poses;
+	using mrpt::math::TPose3D;
+
+	const auto t0 = mrpt::Clock::now();
+	const auto dt = std::chrono::milliseconds(10);
+
+	for (const auto method :
+		 {imSpline, imLinear2Neig, imLinear4Neig, imLinearSlerp, imSplineSlerp})
+	{
+		CPose3DInterpolator path;
+		path.setInterpolationMethod(method);
+		path.enableContiguousIndex();
+		for (int i = 0; i < 50; i++)
+			path.insert(
+				t0 + i * dt,
+				TPose3D(0.1 * i, std::sin(0.1 * i), 0.01 * i, 0.02 * i, 0, 0));
+
+		// Sorted queries, including exact matches and out of range ones:
+		std::vector<mrpt::Clock::time_point> ts;
+		for (int i = -10; i < 520; i++)
+			ts.push_back(t0 + i * std::chrono::milliseconds(1));
+
+		std::vector<TPose3D> batch;
+		std::vector<bool> batchValid;
+		const size_t nValid = path.interpolate(ts, batch, batchValid);
+		ASSERT_EQ(batch.size(), ts.size());
+		EXPECT_GT(nValid, 0U);
+
+		// Same results without the contiguous index:
+		CPose3DInterpolator pathNoIndex = path;
+		pathNoIndex.enableContiguousIndex(false);
+		std::vector<TPose3D> batchNoIndex;
+		std::vector<bool> batchNoIndexValid;
+		EXPECT_EQ(
+			pathNoIndex.interpolate(ts, batchNoIndex, batchNoIndexValid),
+			nValid);
+		EXPECT_EQ(batchNoIndexValid, batchValid);
+		for (size_t i = 0; i < ts.size(); i++)
+			if (batchValid[i]) EXPECT_EQ(batchNoIndex[i], batch[i]);
+
+		for (size_t i = 0; i < ts.size(); i++)
+		{
+			TPose3D p;
+			bool valid;
+			path.interpolate(ts[i], p, valid);
+			EXPECT_EQ(valid, batchValid[i]);
+			if (valid) EXPECT_EQ(p, batch[i]);
+		}
+
+		// Cursor with non-monotonic queries:
+		CPose3DInterpolator::TInterpCursor cursor;
+		for (size_t i = 0; i < ts.size(); i += 37)
+		{
+			const size_t j = ts.size() - 1 - i;
+			TPose3D p;
+			bool valid;
+			path.interpolate(ts[j], p, valid, cursor);
+			EXPECT_EQ(valid, batchValid[j]);
+			if (valid) EXPECT_EQ(p, batch[j]);
+		}
+	}
+}
+
+TEST(CPose3DInterpolator, queriesAfterModifications)
+{
+	using namespace mrpt::poses;
+	using mrpt::math::TPose3D;
+
+	const auto t0 = mrpt::Clock::now();
+	const auto dt = std::chrono::milliseconds(100);
+
+	CPose3DInterpolator path;
+	path.enableContiguousIndex();
+	path.insert(t0, TPose3D(0, 0, 0, 0, 0, 0));
+	path.insert(t0 + dt, TPose3D(1, 0, 0, 0, 0, 0));
+
+	TPose3D p;
+	bool valid;
+	path.interpolate(t0 + dt + dt / 2, p, valid);
+	EXPECT_FALSE(valid);
+
+	// Append at the end:
+	path.insert(t0 + 2 * dt, TPose3D(2, 0, 0, 0, 0, 0));
+	path.interpolate(t0 + dt + dt / 2, p, valid);
+	EXPECT_TRUE(valid);
+	EXPECT_NEAR(p.x, 1.5, 1e-9);
+
+	// Insert in the middle:
+	path.insert(t0 + dt / 2, TPose3D(5, 0, 0, 0, 0, 0));
+	path.interpolate(t0 + dt / 2, p, valid);
+	EXPECT_TRUE(valid);
+	EXPECT_NEAR(p.x, 5, 1e-9);
+
+	// Modify through a non-const accessor:
+	path.at(t0 + dt / 2).x = 7;
+	path.invalidateIndex();
+	path.interpolate(t0 + dt / 2, p, valid);
+	EXPECT_NEAR(p.x, 7, 1e-9);
+
+	// Erase:
+	path.erase(path.find(t0 + dt / 2));
+	path.interpolate(t0 + dt / 2, p, valid);
+	EXPECT_TRUE(valid);
+	EXPECT_NEAR(p.x, 0.5, 1e-9);
+
+	// Copies keep the index enabled:
+	path.insert(t0 + dt / 2, TPose3D(7, 0, 0, 0, 0, 0));
+	CPose3DInterpolator path2 = path;
+	EXPECT_TRUE(path2.isContiguousIndexEnabled());
+	path2.interpolate(t0 + dt / 2, p, valid);
+	EXPECT_TRUE(valid);
+	EXPECT_NEAR(p.x, 7, 1e-9);
+}
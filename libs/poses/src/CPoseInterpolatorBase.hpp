@@ -19,6 +19,7 @@
 #include <mrpt/poses/CPose3DPDFParticles.h>
 #include <mrpt/serialization/stl_serialization.h>
 #include <mrpt/system/datetime.h>
+#include <algorithm>
 #include <fstream>
 #include <mrpt/math/interp_fit.hpp>
 
@@ -35,19 +36,100 @@ template <int DIM>
 void CPoseInterpolatorBase<DIM>::clear()
 {
 	m_path.clear();
+	invalidateIndex();
 }
 
 template <int DIM>
 void CPoseInterpolatorBase<DIM>::insert(
 	const mrpt::Clock::time_point& t, const cpose_t& p)
 {
-	m_path[t] = p.asTPose();
+	insert(t, p.asTPose());
 }
 template <int DIM>
 void CPoseInterpolatorBase<DIM>::insert(
 	const mrpt::Clock::time_point& t, const pose_t& p)
 {
+	const bool append = m_path.empty() || t > m_path.rbegin()->first;
 	m_path[t] = p;
+
+	// Keep the contiguous index up to date in the (most common) case of
+	// poses inserted in chronological order:
+	if (append && m_index.enabled && m_index.valid)
+	{
+		m_index.times.push_back(t);
+		m_index.poses.push_back(p);
+	}
+	else
+		invalidateIndex();
+}
+
+template <int DIM>
+void CPoseInterpolatorBase<DIM>::enableContiguousIndex(bool enable)
+{
+	m_index.enabled = enable;
+	m_index.valid = false;
+	if (!enable)
+	{
+		// Free memory:
+		m_index.times = decltype(m_index.times)();
+		m_index.poses = decltype(m_index.poses)();
+	}
+}
+
+template <int DIM>
+void CPoseInterpolatorBase<DIM>::ensureIndex() const
+{
+	if (m_index.valid) return;
+
+	std::lock_guard<std::mutex> lck(m_index.mtx);
+	if (m_index.valid) return;	// Built by another thread meanwhile
+
+	m_index.times.clear();
+	m_index.poses.clear();
+	m_index.times.reserve(m_path.size());
+	m_index.poses.reserve(m_path.size());
+	for (const auto& p : m_path)
+	{
+		m_index.times.push_back(p.first);
+		m_index.poses.push_back(p.second);
+	}
+	m_index.valid = true;
+}
+
+/** Like std::lower_bound() (index of the first element >= t, or N), starting
+ * the search at `hint`, which is updated with the result. */
+static inline size_t interp_lower_bound_with_hint(
+	const std::vector<mrpt::Clock::time_point>& ts,
+	const mrpt::Clock::time_point& t, size_t& hint)
+{
+	const size_t N = ts.size();
+	size_t i = std::min(hint, N);
+
+	// Fast path: the same interval than the last query
+	if ((i == N || t <= ts[i]) && (i == 0 || ts[i - 1] < t)) return i;
+
+	if (i < N && ts[i] < t)
+	{
+		// Forward exponential search, so small steps are O(1):
+		size_t lo = i + 1, hi = N;
+		for (size_t step = 1; i + step < N; step *= 2)
+		{
+			if (!(ts[i + step] < t))
+			{
+				hi = i + step;
+				break;
+			}
+			lo = i + step + 1;
+		}
+		i = std::lower_bound(ts.begin() + lo, ts.begin() + hi, t) -
+			ts.begin();
+	}
+	else
+	{
+		i = std::lower_bound(ts.begin(), ts.begin() + i, t) - ts.begin();
+	}
+	hint = i;
+	return i;
 }
 
 /*---------------------------------------------------------------
@@ -70,6 +152,37 @@ typename CPoseInterpolatorBase<DIM>::pose_t&
 	CPoseInterpolatorBase<DIM>::interpolate(
 		const mrpt::Clock::time_point& t, pose_t& out_interp,
 		bool& out_valid_interp) const
+{
+	TInterpCursor cursor;
+	return interpolate(t, out_interp, out_valid_interp, cursor);
+}
+
+template <int DIM>
+size_t CPoseInterpolatorBase<DIM>::interpolate(
+	const std::vector<mrpt::Clock::time_point>& ts,
+	std::vector<pose_t>& out_interp, std::vector<bool>& out_valid) const
+{
+	const size_t N = ts.size();
+	out_interp.resize(N);
+	out_valid.resize(N);
+
+	TInterpCursor cursor;
+	size_t nValid = 0;
+	for (size_t i = 0; i < N; i++)
+	{
+		bool valid;
+		interpolate(ts[i], out_interp[i], valid, cursor);
+		out_valid[i] = valid;
+		if (valid) nValid++;
+	}
+	return nValid;
+}
+
+template <int DIM>
+typename CPoseInterpolatorBase<DIM>::pose_t&
+	CPoseInterpolatorBase<DIM>::interpolate(
+		const mrpt::Clock::time_point& t, pose_t& out_interp,
+		bool& out_valid_interp, TInterpCursor& cursor) const
 {
 	// Default value in case of invalid interp
 	for (size_t k = 0; k < pose_t::static_size; k++)
@@ -95,53 +208,88 @@ typename CPoseInterpolatorBase<DIM>::pose_t&
 			break;
 	};
 
-	// Out of range?
-	auto it_ge1 = m_path.lower_bound(t);
-
-	// Exact match?
-	if (it_ge1 != m_path.end() && it_ge1->first == t)
+	// Look for the (up to) 4 neighbors of "t": p1 < p2 < t < p3 < p4
+	bool has_p1 = false, has_p2 = false, has_p3 = false, has_p4 = false;
+	if (m_index.enabled)
 	{
-		out_interp = it_ge1->second;
-		out_valid_interp = true;
-		return out_interp;
-	}
+		// Search in the contiguous copy of the path:
+		ensureIndex();
+		const auto& times = m_index.times;
+		const auto& poses = m_index.poses;
+		const size_t N = times.size();
 
-	// Are we in the beginning or the end of the path?
-	if (it_ge1 == m_path.end() || it_ge1 == m_path.begin())
-	{
-		out_valid_interp = false;
-		return out_interp;
-	}  // end
+		const size_t i_ge1 =
+			interp_lower_bound_with_hint(times, t, cursor.idx);
 
-	p3 = *it_ge1;  // Third pair
-	auto it_ge2 = it_ge1;
-	++it_ge2;
-	if (it_ge2 == m_path.end())
-	{
-		if (interp_method_requires_4pts)
+		// Exact match?
+		if (i_ge1 != N && times[i_ge1] == t)
 		{
-			out_valid_interp = false;
+			out_interp = poses[i_ge1];
+			out_valid_interp = true;
 			return out_interp;
 		}
+		if (i_ge1 < N)
+		{
+			has_p3 = true;
+			p3 = {times[i_ge1], poses[i_ge1]};
+		}
+		if (i_ge1 + 1 < N)
+		{
+			has_p4 = true;
+			p4 = {times[i_ge1 + 1], poses[i_ge1 + 1]};
+		}
+		if (i_ge1 >= 1)
+		{
+			has_p2 = true;
+			p2 = {times[i_ge1 - 1], poses[i_ge1 - 1]};
+		}
+		if (i_ge1 >= 2)
+		{
+			has_p1 = true;
+			p1 = {times[i_ge1 - 2], poses[i_ge1 - 2]};
+		}
 	}
 	else
 	{
-		p4 = *(it_ge2);  // Fourth pair
-	}
-
-	p2 = *(--it_ge1);  // Second pair
+		auto it_ge1 = m_path.lower_bound(t);
 
-	if (it_ge1 == m_path.begin())
-	{
-		if (interp_method_requires_4pts)
+		// Exact match?
+		if (it_ge1 != m_path.end() && it_ge1->first == t)
 		{
-			out_valid_interp = false;
+			out_interp = it_ge1->second;
+			out_valid_interp = true;
 			return out_interp;
 		}
+		if (it_ge1 != m_path.end())
+		{
+			has_p3 = true;
+			p3 = *it_ge1;
+			auto it_ge2 = std::next(it_ge1);
+			if (it_ge2 != m_path.end())
+			{
+				has_p4 = true;
+				p4 = *it_ge2;
+			}
+		}
+		if (it_ge1 != m_path.begin())
+		{
+			auto it_lt1 = std::prev(it_ge1);
+			has_p2 = true;
+			p2 = *it_lt1;
+			if (it_lt1 != m_path.begin())
+			{
+				has_p1 = true;
+				p1 = *std::prev(it_lt1);
+			}
+		}
 	}
-	else
+
+	// Are we in the beginning or the end of the path?
+	if (!has_p2 || !has_p3 ||
+		(interp_method_requires_4pts && (!has_p1 || !has_p4)))
 	{
-		p1 = *(--it_ge1);  // First pair
+		out_valid_interp = false;
+		return out_interp;
 	}
 
 	// Test if the difference between the desired timestamp and the next
@@ -437,5 +585,6 @@ void CPoseInterpolatorBase<DIM>::filter(
 		aux[it1->first] = pose_t(auxPose.asTPose());
 	}  // end for it1
 	m_path = aux;
+	invalidateIndex();
 }
 }  // namespace mrpt::poses
@@ -0,0 +1,167 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/serialization/CSchemeArchiveBase.h>
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mrpt::serialization
+{
+/** An in-memory tree of CBOR (RFC 8949) data items, with the same interface
+ * than `Json::Value` (jsoncpp), so it can be used as a schema archive with
+ * CSchemeArchive (see archiveCBOR()).
+ *
+ * Numeric arrays are stored as one contiguous block of bytes each, in the
+ * host byte order, and written as RFC 8746 typed arrays (a tag plus a byte
+ * string), so loading large matrices or point clouds is a single read and
+ * copy per array. Regular CBOR arrays of numbers can also be read as typed
+ * arrays.
+ *
+ * Like `Json::Value`, accessing a missing map key or out-of-range array index
+ * with the non-const operator[] creates it (as null), and a null value turns
+ * into an array or map on its first such access. References to children
+ * remain valid while the parent exists and is not assigned to.
+ *
+ * Writing and reading with `operator<<` and `operator>>` encodes and decodes
+ * one CBOR data item. Use streams in binary mode.
+ *
+ * \sa archiveCBOR()
+ * \ingroup mrpt_serialization_grp
+ * \note (New in MRPT 2.4.3)
+ */
+class CBORValue
+{
+   public:
+	using Int64 = int64_t;
+	using UInt64 = uint64_t;
+
+	enum class Type : uint8_t
+	{
+		Null = 0,
+		Bool,
+		UInt,  //!< Non-negative integers
+		Int,  //!< Negative integers
+		Float,	//!< float or double
+		String,
+		Array,
+		Map,
+		TypedArray
+	};
+
+	CBORValue() = default;
+	CBORValue(const CBORValue& o) { *this = o; }
+	CBORValue(CBORValue&&) = default;
+	CBORValue& operator=(const CBORValue& o);
+	CBORValue& operator=(CBORValue&&) = default;
+	~CBORValue() = default;
+
+	CBORValue& operator=(int32_t v) { return *this = Int64(v); }
+	CBORValue& operator=(uint32_t v) { return *this = UInt64(v); }
+	CBORValue& operator=(Int64 v);
+	CBORValue& operator=(UInt64 v);
+	CBORValue& operator=(float v);
+	CBORValue& operator=(double v);
+	CBORValue& operator=(bool v);
+	CBORValue& operator=(const std::string& v);
+	CBORValue& operator=(const char* v) { return *this = std::string(v); }
+
+	Type type() const { return m_type; }
+	bool isNull() const { return m_type == Type::Null; }
+
+	/** Number of elements of arrays, typed arrays or maps; 0 otherwise. */
+	size_t size() const;
+
+	/** Conversions (null is converted into 0, false or an empty string).
+	 * \exception std::exception If the stored value is of another kind. */
+	int32_t asInt() const { return static_cast<int32_t>(asInt64()); }
+	uint32_t asUInt() const { return static_cast<uint32_t>(asUInt64()); }
+	Int64 asInt64() const;
+	UInt64 asUInt64() const;
+	float asFloat() const { return static_cast<float>(asDouble()); }
+	double asDouble() const;
+	bool asBool() const;
+	std::string asString() const;
+
+	/** Array element access, creating it if needed. */
+	CBORValue& operator[](int index);
+	const CBORValue& operator[](int index) const;
+	/** Map access, creating the key if needed. */
+	CBORValue& operator[](const std::string& key);
+	/** Map access. \exception std::exception If the key does not exist */
+	const CBORValue& operator[](const std::string& key) const;
+
+	bool isMember(const std::string& key) const;
+	/** Map keys, in insertion order */
+	const std::vector<std::string>& getMemberNames() const { return m_keys; }
+
+	/** Stores a numeric array, replacing the former contents. */
+	void setTypedArray(SchemeArrayType type, const void* data, size_t count);
+	template <typename T>
+	void setTypedArray(const std::vector<T>& v)
+	{
+		setTypedArray(
+			internal::scheme_array_type_of<T>(), v.data(), v.size());
+	}
+
+	/** Element type of a typed array. */
+	SchemeArrayType typedArrayType() const { return m_arrayType; }
+
+	/** Reads `count` (which must be equal to size()) elements of a typed
+	 * array or an array of numbers, converting them into `type` if needed. */
+	void getTypedArray(SchemeArrayType type, void* data, size_t count) const;
+	template <typename T>
+	std::vector<T> getTypedArray() const
+	{
+		std::vector<T> v(size());
+		getTypedArray(internal::scheme_array_type_of<T>(), v.data(), v.size());
+		return v;
+	}
+
+	/** Writes this value as one CBOR data item */
+	void encode(std::ostream& out) const;
+	/** Reads one CBOR data item, replacing the current contents.
+	 * Indefinite-length items are not supported. Tags other than typed arrays
+	 * are ignored.
+	 * \exception std::exception On invalid or truncated data. */
+	void decode(std::istream& in);
+
+   private:
+	Type m_type = Type::Null;
+	bool m_single = false;	//!< For Float: encode it as float32
+	SchemeArrayType m_arrayType = SchemeArrayType::UInt8;
+	union
+	{
+		bool b;
+		UInt64 u;
+		Int64 i;
+		double d;
+	} m_num{};
+	std::string m_str;
+	/** Typed array contents, in the host byte order */
+	std::vector<uint8_t> m_bytes;
+	/** Array elements or map values */
+	std::vector<std::unique_ptr<CBORValue>> m_items;
+	/** Map keys, in the same order than m_items */
+	std::vector<std::string> m_keys;
+
+	void reset(Type t);
+	void decode(std::istream& in, int depth);
+};
+
+/** Writes a CBORValue as CBOR binary data */
+std::ostream& operator<<(std::ostream& out, const CBORValue& v);
+/** Reads a CBORValue from CBOR binary data */
+std::istream& operator>>(std::istream& in, CBORValue& v);
+
+}  // namespace mrpt::serialization
@@ -15,12 +15,34 @@
 #include <optional>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 namespace mrpt::serialization
 {
+namespace internal
+{
+/** True for SCHEME_CAPABLE types able to store numeric arrays as a whole
+ * (e.g. CBORValue), instead of as a list of values. */
+template <typename T, typename = void>
+struct scheme_has_typed_arrays : std::false_type
+{
+};
+template <typename T>
+struct scheme_has_typed_arrays<
+	T, std::void_t<decltype(std::declval<T&>().setTypedArray(
+		   SchemeArrayType::UInt8, nullptr, size_t(0)))>> : std::true_type
+{
+};
+}  // namespace internal
+
 /** Base template class for schema-capable "archives", e.g. JSON, YAML,
  * from which to (de)serialize objects.
  *
+ * SCHEME_CAPABLE must provide the interface of `Json::Value` (jsoncpp).
+ * Numeric arrays are stored as lists, unless SCHEME_CAPABLE also has the
+ * methods `setTypedArray()` and `getTypedArray()` of CBORValue.
+ *
  * See \ref mrpt_serialization_grp for examples of use.
  * \ingroup mrpt_serialization_grp
  * \note Original version by https://github.com/rachit173 for GSoC 2018.
@@ -115,6 +137,47 @@ class CSchemeArchive : public mrpt::serialization::CSchemeArchiveBase_impl
 				m_val[std::string(str)]));
 	}
 
+	void writeArray(
+		SchemeArrayType type, const void* data, size_t count) override
+	{
+		if constexpr (internal::scheme_has_typed_arrays<SCHEME_CAPABLE>::value)
+			m_val.setTypedArray(type, data, count);
+		else
+		{
+			m_val = SCHEME_CAPABLE();
+			internal::visit_scheme_array_type(type, [&](auto tag) {
+				using T = decltype(tag);
+				const T* p = static_cast<const T*>(data);
+				for (size_t i = 0; i < count; i++)
+					m_val[static_cast<int>(i)] = toScalar(p[i]);
+			});
+		}
+	}
+	size_t arraySize() const override { return m_val.size(); }
+	void readArray(SchemeArrayType type, void* data, size_t count) override
+	{
+		if constexpr (internal::scheme_has_typed_arrays<SCHEME_CAPABLE>::value)
+			m_val.getTypedArray(type, data, count);
+		else
+		{
+			ASSERT_EQUAL_(count, arraySize());
+			internal::visit_scheme_array_type(type, [&](auto tag) {
+				using T = decltype(tag);
+				T* p = static_cast<T*>(data);
+				for (size_t i = 0; i < count; i++)
+				{
+					const auto& e = m_val[static_cast<int>(i)];
+					if constexpr (std::is_floating_point_v<T>)
+						p[i] = static_cast<T>(e.asDouble());
+					else if constexpr (std::is_signed_v<T>)
+						p[i] = static_cast<T>(e.asInt64());
+					else
+						p[i] = static_cast<T>(e.asUInt64());
+				}
+			});
+		}
+	}
+
 	std::ostream& writeToStream(std::ostream& out) const override
 	{
 		out << m_val;
@@ -128,6 +191,22 @@ class CSchemeArchive : public mrpt::serialization::CSchemeArchiveBase_impl
 
    private:
 	SCHEME_CAPABLE& m_val;
+
+	// Array elements as the scalar types accepted by SCHEME_CAPABLE:
+	template <typename T>
+	static auto toScalar(T v)
+	{
+		if constexpr (std::is_floating_point_v<T>)
+			return static_cast<double>(v);
+		else if constexpr (sizeof(T) == 8 && std::is_signed_v<T>)
+			return typename SCHEME_CAPABLE::Int64(v);
+		else if constexpr (sizeof(T) == 8)
+			return typename SCHEME_CAPABLE::UInt64(v);
+		else if constexpr (std::is_signed_v<T>)
+			return static_cast<int32_t>(v);
+		else
+			return static_cast<uint32_t>(v);
+	}
 };
 
 /** Returns an archive for reading/writing in JSON format.
@@ -136,4 +215,13 @@ class CSchemeArchive : public mrpt::serialization::CSchemeArchiveBase_impl
  * \ingroup mrpt_serialization_grp */
 CSchemeArchiveBase archiveJSON();
 
+/** Returns an archive for reading/writing in the binary CBOR format
+ * (RFC 8949), with numeric arrays (see CSchemeArchiveBase::writeArray())
+ * stored as RFC 8746 typed arrays: a compact and fast alternative to
+ * archiveJSON() for large objects. Streams must be opened in binary mode.
+ * \sa CBORValue
+ * \note (New in MRPT 2.4.3)
+ * \ingroup mrpt_serialization_grp */
+CSchemeArchiveBase archiveCBOR();
+
 }  // namespace mrpt::serialization
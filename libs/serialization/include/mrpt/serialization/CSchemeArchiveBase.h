@@ -15,10 +15,81 @@
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
 namespace mrpt::serialization
 {
+/** Element types of numeric arrays in schema archives.
+ * \sa CSchemeArchiveBase::writeArray()
+ * \ingroup mrpt_serialization_grp
+ */
+enum class SchemeArrayType : uint8_t
+{
+	UInt8 = 0,
+	Int8,
+	UInt16,
+	Int16,
+	UInt32,
+	Int32,
+	UInt64,
+	Int64,
+	Float,
+	Double
+};
+
+namespace internal
+{
+template <typename T>
+constexpr SchemeArrayType scheme_array_type_of()
+{
+	using U = std::remove_cv_t<T>;
+	if constexpr (std::is_same_v<U, uint8_t>) return SchemeArrayType::UInt8;
+	else if constexpr (std::is_same_v<U, int8_t>)
+		return SchemeArrayType::Int8;
+	else if constexpr (std::is_same_v<U, uint16_t>)
+		return SchemeArrayType::UInt16;
+	else if constexpr (std::is_same_v<U, int16_t>)
+		return SchemeArrayType::Int16;
+	else if constexpr (std::is_same_v<U, uint32_t>)
+		return SchemeArrayType::UInt32;
+	else if constexpr (std::is_same_v<U, int32_t>)
+		return SchemeArrayType::Int32;
+	else if constexpr (std::is_same_v<U, uint64_t>)
+		return SchemeArrayType::UInt64;
+	else if constexpr (std::is_same_v<U, int64_t>)
+		return SchemeArrayType::Int64;
+	else if constexpr (std::is_same_v<U, float>)
+		return SchemeArrayType::Float;
+	else
+	{
+		static_assert(
+			std::is_same_v<U, double>, "Unsupported schema array type");
+		return SchemeArrayType::Double;
+	}
+}
+
+/** Calls `f(T())`, with `T` the C++ type of the given array type. */
+template <typename F>
+void visit_scheme_array_type(SchemeArrayType t, F&& f)
+{
+	switch (t)
+	{
+		case SchemeArrayType::UInt8: f(uint8_t()); break;
+		case SchemeArrayType::Int8: f(int8_t()); break;
+		case SchemeArrayType::UInt16: f(uint16_t()); break;
+		case SchemeArrayType::Int16: f(int16_t()); break;
+		case SchemeArrayType::UInt32: f(uint32_t()); break;
+		case SchemeArrayType::Int32: f(int32_t()); break;
+		case SchemeArrayType::UInt64: f(uint64_t()); break;
+		case SchemeArrayType::Int64: f(int64_t()); break;
+		case SchemeArrayType::Float: f(float()); break;
+		case SchemeArrayType::Double: f(double()); break;
+		default: throw std::invalid_argument("Invalid SchemeArrayType");
+	}
+}
+}  // namespace internal
+
 /** Pure virtual class carrying the implementation
  * of CSchemeArchiveBase as per the PIMPL idiom.
  * \ingroup mrpt_serialization_grp
@@ -61,6 +132,16 @@ class CSchemeArchiveBase_impl
 	// Dict accessor
 	virtual CSchemeArchiveBase operator[](std::string) = 0;
 
+	/** Writes a numeric array of `count` elements of type `type`.
+	 * Default implementation: throws (not supported by this archive). */
+	virtual void writeArray(
+		SchemeArrayType type, const void* data, size_t count);
+	/** Number of elements of the array stored in this node */
+	virtual size_t arraySize() const;
+	/** Reads a numeric array of exactly `count` elements (see arraySize()),
+	 * converting them to `type` if stored with another type. */
+	virtual void readArray(SchemeArrayType type, void* data, size_t count);
+
    public:	// should make it private by virtue of friend class
 	void setParent(CSchemeArchiveBase* parent) { m_parent = parent; }
 
@@ -153,6 +234,40 @@ class CSchemeArchiveBase
 		return (*pimpl).operator[](val);
 	}
 
+	/** Writes a numeric array (`T`: 8 to 64 bit integers, float or double),
+	 * with syntax `out["name"].writeArray(v)`. Binary archives (see
+	 * archiveCBOR()) store it as one contiguous block; text archives as a
+	 * list of numbers.
+	 * \note (New in MRPT 2.4.3) */
+	template <typename T>
+	CSchemeArchiveBase& writeArray(const T* data, size_t count)
+	{
+		pimpl->writeArray(
+			internal::scheme_array_type_of<T>(), data, count);
+		return *this;
+	}
+	template <typename T>
+	CSchemeArchiveBase& writeArray(const std::vector<T>& v)
+	{
+		return writeArray(v.data(), v.size());
+	}
+	/** Number of elements of a numeric array written with writeArray() */
+	size_t arraySize() const { return pimpl->arraySize(); }
+	/** Reads a numeric array written with writeArray(), converting its
+	 * elements to `T` if needed. `count` must be equal to arraySize().
+	 * \note (New in MRPT 2.4.3) */
+	template <typename T>
+	void readArray(T* data, size_t count)
+	{
+		pimpl->readArray(internal::scheme_array_type_of<T>(), data, count);
+	}
+	template <typename T>
+	void readArray(std::vector<T>& v)
+	{
+		v.resize(arraySize());
+		readArray(v.data(), v.size());
+	}
+
 	// class CSchemeArchiveBase_impl;
    protected:
 	// Read Object
@@ -0,0 +1,610 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "serialization-precomp.h"	// Precompiled headers
+//
+#include <mrpt/config.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/serialization/CBORValue.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+using namespace mrpt::serialization;
+
+namespace
+{
+// CBOR major types:
+constexpr uint8_t MT_UINT = 0, MT_NEGINT = 1, MT_BYTES = 2, MT_TEXT = 3,
+				  MT_ARRAY = 4, MT_MAP = 5, MT_TAG = 6, MT_SIMPLE = 7;
+
+constexpr int MAX_NESTING_DEPTH = 512;
+// Strings and byte strings are read in blocks of up to this size, so a
+// corrupted length does not allocate more memory than the actual data:
+constexpr size_t MAX_READ_BLOCK = 1 << 20;
+
+size_t elementSize(SchemeArrayType t)
+{
+	size_t sz = 0;
+	internal::visit_scheme_array_type(t, [&](auto tag) { sz = sizeof(tag); });
+	return sz;
+}
+
+// RFC 8746 typed array tags: 0b010_f_s_e_ll, with f: float, s: signed,
+// e: little endian, ll: log2 of the element size (minus 1, for floats).
+uint64_t typedArrayTag(SchemeArrayType t)
+{
+	uint64_t f = 0, s = 0, ll = 0;
+	switch (t)
+	{
+		case SchemeArrayType::UInt8: break;
+		case SchemeArrayType::Int8: s = 1; break;
+		case SchemeArrayType::UInt16: ll = 1; break;
+		case SchemeArrayType::Int16: s = 1, ll = 1; break;
+		case SchemeArrayType::UInt32: ll = 2; break;
+		case SchemeArrayType::Int32: s = 1, ll = 2; break;
+		case SchemeArrayType::UInt64: ll = 3; break;
+		case SchemeArrayType::Int64: s = 1, ll = 3; break;
+		case SchemeArrayType::Float: f = 1, ll = 1; break;
+		case SchemeArrayType::Double: f = 1, ll = 2; break;
+	};
+	// Byte order does not apply to 8-bit types:
+	const uint64_t e = (!MRPT_IS_BIG_ENDIAN && (f || ll)) ? 1 : 0;
+	return 64 | (f << 4) | (s << 3) | (e << 2) | ll;
+}
+
+// Returns false if the tag is not a supported typed array:
+bool parseTypedArrayTag(uint64_t tag, SchemeArrayType& t, bool& littleEndian)
+{
+	if (tag < 64 || tag > 87) return false;
+	const bool f = (tag & 0x10) != 0, s = (tag & 0x08) != 0;
+	const unsigned ll = tag & 0x03;
+	littleEndian = (tag & 0x04) != 0;
+	if (f)
+	{
+		if (s || (ll != 1 && ll != 2)) return false;  // No float16, float128
+		t = ll == 1 ? SchemeArrayType::Float : SchemeArrayType::Double;
+		return true;
+	}
+	if (ll == 0)
+	{
+		if (tag == 76) return false;  // Reserved
+		// (68: "uint8 clamped", as uint8)
+		t = s ? SchemeArrayType::Int8 : SchemeArrayType::UInt8;
+		littleEndian = !MRPT_IS_BIG_ENDIAN;
+		return true;
+	}
+	constexpr SchemeArrayType unsignedTypes[3] = {
+		SchemeArrayType::UInt16, SchemeArrayType::UInt32,
+		SchemeArrayType::UInt64};
+	constexpr SchemeArrayType signedTypes[3] = {
+		SchemeArrayType::Int16, SchemeArrayType::Int32,
+		SchemeArrayType::Int64};
+	t = s ? signedTypes[ll - 1] : unsignedTypes[ll - 1];
+	return true;
+}
+
+void writeHead(std::ostream& out, uint8_t majorType, uint64_t v)
+{
+	uint8_t buf[9];
+	const uint8_t mt = static_cast<uint8_t>(majorType << 5);
+	unsigned nBytes = 0;
+	if (v < 24) buf[0] = mt | static_cast<uint8_t>(v);
+	else if (v <= 0xff)
+		buf[0] = mt | 24, nBytes = 1;
+	else if (v <= 0xffff)
+		buf[0] = mt | 25, nBytes = 2;
+	else if (v <= 0xffffffff)
+		buf[0] = mt | 26, nBytes = 4;
+	else
+		buf[0] = mt | 27, nBytes = 8;
+	for (unsigned k = 0; k < nBytes; k++)
+		buf[1 + k] = static_cast<uint8_t>(v >> (8 * (nBytes - 1 - k)));
+	out.write(reinterpret_cast<const char*>(buf), 1 + nBytes);
+}
+
+template <typename T>
+void writeBigEndian(std::ostream& out, uint8_t initialByte, T v)
+{
+	uint8_t buf[1 + sizeof(T)];
+	buf[0] = initialByte;
+	std::memcpy(buf + 1, &v, sizeof(T));
+#if !MRPT_IS_BIG_ENDIAN
+	std::reverse(buf + 1, buf + 1 + sizeof(T));
+#endif
+	out.write(reinterpret_cast<const char*>(buf), sizeof(buf));
+}
+
+void readBytes(std::istream& in, void* data, size_t n)
+{
+	if (!n) return;
+	in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(n));
+	if (static_cast<size_t>(in.gcount()) != n)
+		THROW_EXCEPTION("CBOR: unexpected end of data");
+}
+
+uint64_t readUIntBigEndian(std::istream& in, unsigned nBytes)
+{
+	uint8_t buf[8];
+	readBytes(in, buf, nBytes);
+	uint64_t v = 0;
+	for (unsigned k = 0; k < nBytes; k++)
+		v = (v << 8) | buf[k];
+	return v;
+}
+
+// Reads the argument of a data item head:
+uint64_t readArgument(std::istream& in, uint8_t info)
+{
+	if (info < 24) return info;
+	switch (info)
+	{
+		case 24: return readUIntBigEndian(in, 1);
+		case 25: return readUIntBigEndian(in, 2);
+		case 26: return readUIntBigEndian(in, 4);
+		case 27: return readUIntBigEndian(in, 8);
+		case 31:
+			THROW_EXCEPTION("CBOR: indefinite-length items are not supported");
+		default: THROW_EXCEPTION("CBOR: malformed data item head");
+	};
+}
+
+// Reads `n` bytes, without trusting `n` for allocating memory:
+template <typename CONTAINER>
+void readBlob(std::istream& in, uint64_t n, CONTAINER& out)
+{
+	out.clear();
+	while (n > 0)
+	{
+		const size_t blk = static_cast<size_t>(
+			std::min<uint64_t>(n, MAX_READ_BLOCK));
+		const size_t prev = out.size();
+		out.resize(prev + blk);
+		readBytes(in, &out[prev], blk);
+		n -= blk;
+	}
+}
+
+double halfToDouble(uint16_t h)
+{
+	const int e = (h >> 10) & 0x1f, m = h & 0x3ff;
+	double v;
+	if (e == 0) v = std::ldexp(m, -24);
+	else if (e != 31)
+		v = std::ldexp(m + 1024, e - 25);
+	else
+		v = m == 0 ? std::numeric_limits<double>::infinity()
+				   : std::numeric_limits<double>::quiet_NaN();
+	return (h & 0x8000) ? -v : v;
+}
+}  // namespace
+
+CBORValue& CBORValue::operator=(const CBORValue& o)
+{
+	if (this == &o) return *this;
+	m_type = o.m_type;
+	m_single = o.m_single;
+	m_arrayType = o.m_arrayType;
+	m_num = o.m_num;
+	m_str = o.m_str;
+	m_bytes = o.m_bytes;
+	m_keys = o.m_keys;
+	std::vector<std::unique_ptr<CBORValue>> items;
+	items.reserve(o.m_items.size());
+	for (const auto& it : o.m_items)
+		items.push_back(std::make_unique<CBORValue>(*it));
+	m_items = std::move(items);
+	return *this;
+}
+
+void CBORValue::reset(Type t)
+{
+	m_type = t;
+	m_single = false;
+	m_num.u = 0;
+	m_str.clear();
+	m_bytes.clear();
+	m_items.clear();
+	m_keys.clear();
+}
+
+CBORValue& CBORValue::operator=(Int64 v)
+{
+	if (v >= 0) return *this = static_cast<UInt64>(v);
+	reset(Type::Int);
+	m_num.i = v;
+	return *this;
+}
+CBORValue& CBORValue::operator=(UInt64 v)
+{
+	reset(Type::UInt);
+	m_num.u = v;
+	return *this;
+}
+CBORValue& CBORValue::operator=(float v)
+{
+	reset(Type::Float);
+	m_num.d = v;
+	m_single = true;
+	return *this;
+}
+CBORValue& CBORValue::operator=(double v)
+{
+	reset(Type::Float);
+	m_num.d = v;
+	return *this;
+}
+CBORValue& CBORValue::operator=(bool v)
+{
+	reset(Type::Bool);
+	m_num.b = v;
+	return *this;
+}
+CBORValue& CBORValue::operator=(const std::string& v)
+{
+	reset(Type::String);
+	m_str = v;
+	return *this;
+}
+
+size_t CBORValue::size() const
+{
+	switch (m_type)
+	{
+		case Type::Array:
+		case Type::Map: return m_items.size();
+		case Type::TypedArray: return m_bytes.size() / elementSize(m_arrayType);
+		default: return 0;
+	};
+}
+
+CBORValue::Int64 CBORValue::asInt64() const
+{
+	switch (m_type)
+	{
+		case Type::Null: return 0;
+		case Type::Bool: return m_num.b ? 1 : 0;
+		case Type::UInt:
+			ASSERTMSG_(
+				m_num.u <= static_cast<UInt64>(
+							   std::numeric_limits<Int64>::max()),
+				"CBOR: integer out of range");
+			return static_cast<Int64>(m_num.u);
+		case Type::Int: return m_num.i;
+		case Type::Float: return static_cast<Int64>(m_num.d);
+		default: THROW_EXCEPTION("CBOR: value is not a number");
+	};
+}
+
+CBORValue::UInt64 CBORValue::asUInt64() const
+{
+	switch (m_type)
+	{
+		case Type::Null: return 0;
+		case Type::Bool: return m_num.b ? 1 : 0;
+		case Type::UInt: return m_num.u;
+		case Type::Int:
+			THROW_EXCEPTION("CBOR: negative value read as unsigned");
+		case Type::Float: return static_cast<UInt64>(m_num.d);
+		default: THROW_EXCEPTION("CBOR: value is not a number");
+	};
+}
+
+double CBORValue::asDouble() const
+{
+	switch (m_type)
+	{
+		case Type::Null: return 0;
+		case Type::Bool: return m_num.b ? 1 : 0;
+		case Type::UInt: return static_cast<double>(m_num.u);
+		case Type::Int: return static_cast<double>(m_num.i);
+		case Type::Float: return m_num.d;
+		default: THROW_EXCEPTION("CBOR: value is not a number");
+	};
+}
+
+bool CBORValue::asBool() const
+{
+	switch (m_type)
+	{
+		case Type::Null: return false;
+		case Type::Bool: return m_num.b;
+		case Type::UInt: return m_num.u != 0;
+		case Type::Int: return true;
+		case Type::Float: return m_num.d != 0;
+		default: THROW_EXCEPTION("CBOR: value is not a boolean");
+	};
+}
+
+std::string CBORValue::asString() const
+{
+	if (m_type == Type::Null) return {};
+	ASSERTMSG_(m_type == Type::String, "CBOR: value is not a string");
+	return m_str;
+}
+
+CBORValue& CBORValue::operator[](int index)
+{
+	ASSERT_GE_(index, 0);
+	if (m_type == Type::Null) reset(Type::Array);
+	ASSERTMSG_(m_type == Type::Array, "CBOR: value is not an array");
+	while (m_items.size() <= static_cast<size_t>(index))
+		m_items.push_back(std::make_unique<CBORValue>());
+	return *m_items[index];
+}
+
+const CBORValue& CBORValue::operator[](int index) const
+{
+	ASSERTMSG_(m_type == Type::Array, "CBOR: value is not an array");
+	ASSERT_LT_(static_cast<size_t>(index), m_items.size());
+	return *m_items[index];
+}
+
+CBORValue& CBORValue::operator[](const std::string& key)
+{
+	if (m_type == Type::Null) reset(Type::Map);
+	ASSERTMSG_(m_type == Type::Map, "CBOR: value is not a map");
+	for (size_t i = 0; i < m_keys.size(); i++)
+		if (m_keys[i] == key) return *m_items[i];
+	m_keys.push_back(key);
+	m_items.push_back(std::make_unique<CBORValue>());
+	return *m_items.back();
+}
+
+const CBORValue& CBORValue::operator[](const std::string& key) const
+{
+	ASSERTMSG_(m_type == Type::Map, "CBOR: value is not a map");
+	for (size_t i = 0; i < m_keys.size(); i++)
+		if (m_keys[i] == key) return *m_items[i];
+	THROW_EXCEPTION_FMT("CBOR: missing key `%s`", key.c_str());
+}
+
+bool CBORValue::isMember(const std::string& key) const
+{
+	return m_type == Type::Map &&
+		std::find(m_keys.begin(), m_keys.end(), key) != m_keys.end();
+}
+
+void CBORValue::setTypedArray(
+	SchemeArrayType type, const void* data, size_t count)
+{
+	reset(Type::TypedArray);
+	m_arrayType = type;
+	const size_t nBytes = count * elementSize(type);
+	m_bytes.resize(nBytes);
+	if (nBytes) std::memcpy(m_bytes.data(), data, nBytes);
+}
+
+void CBORValue::getTypedArray(
+	SchemeArrayType type, void* data, size_t count) const
+{
+	ASSERT_EQUAL_(count, size());
+	if (!count) return;
+
+	if (m_type == Type::TypedArray)
+	{
+		if (type == m_arrayType)
+		{
+			std::memcpy(data, m_bytes.data(), m_bytes.size());
+			return;
+		}
+		// Element type conversion:
+		internal::visit_scheme_array_type(m_arrayType, [&](auto srcTag) {
+			using S = decltype(srcTag);
+			internal::visit_scheme_array_type(type, [&](auto dstTag) {
+				using D = decltype(dstTag);
+				D* dst = static_cast<D*>(data);
+				for (size_t i = 0; i < count; i++)
+				{
+					S s;
+					std::memcpy(&s, &m_bytes[i * sizeof(S)], sizeof(S));
+					dst[i] = static_cast<D>(s);
+				}
+			});
+		});
+		return;
+	}
+
+	ASSERTMSG_(
+		m_type == Type::Array, "CBOR: value is not an array of numbers");
+	internal::visit_scheme_array_type(type, [&](auto tag) {
+		using T = decltype(tag);
+		T* dst = static_cast<T*>(data);
+		for (size_t i = 0; i < count; i++)
+		{
+			const CBORValue& e = *m_items[i];
+			if constexpr (std::is_floating_point_v<T>)
+				dst[i] = static_cast<T>(e.asDouble());
+			else if constexpr (std::is_signed_v<T>)
+				dst[i] = static_cast<T>(e.asInt64());
+			else
+				dst[i] = static_cast<T>(e.asUInt64());
+		}
+	});
+}
+
+void CBORValue::encode(std::ostream& out) const
+{
+	switch (m_type)
+	{
+		case Type::Null: out.put(static_cast<char>(0xf6)); break;
+		case Type::Bool:
+			out.put(static_cast<char>(m_num.b ? 0xf5 : 0xf4));
+			break;
+		case Type::UInt: writeHead(out, MT_UINT, m_num.u); break;
+		case Type::Int:
+			writeHead(out, MT_NEGINT, ~static_cast<uint64_t>(m_num.i));
+			break;
+		case Type::Float:
+			if (m_single)
+				writeBigEndian(out, 0xfa, static_cast<float>(m_num.d));
+			else
+				writeBigEndian(out, 0xfb, m_num.d);
+			break;
+		case Type::String:
+			writeHead(out, MT_TEXT, m_str.size());
+			out.write(m_str.data(), m_str.size());
+			break;
+		case Type::Array:
+			writeHead(out, MT_ARRAY, m_items.size());
+			for (const auto& it : m_items)
+				it->encode(out);
+			break;
+		case Type::Map:
+			writeHead(out, MT_MAP, m_items.size());
+			for (size_t i = 0; i < m_items.size(); i++)
+			{
+				writeHead(out, MT_TEXT, m_keys[i].size());
+				out.write(m_keys[i].data(), m_keys[i].size());
+				m_items[i]->encode(out);
+			}
+			break;
+		case Type::TypedArray:
+			writeHead(out, MT_TAG, typedArrayTag(m_arrayType));
+			writeHead(out, MT_BYTES, m_bytes.size());
+			out.write(
+				reinterpret_cast<const char*>(m_bytes.data()),
+				m_bytes.size());
+			break;
+	};
+	if (!out) THROW_EXCEPTION("CBOR: error writing to output stream");
+}
+
+void CBORValue::decode(std::istream& in) { decode(in, 0); }
+
+void CBORValue::decode(std::istream& in, int depth)
+{
+	ASSERTMSG_(depth < MAX_NESTING_DEPTH, "CBOR: too deeply nested data");
+
+	uint8_t ib;
+	readBytes(in, &ib, 1);
+	const uint8_t mt = ib >> 5, info = ib & 0x1f;
+
+	if (mt == MT_SIMPLE)
+	{
+		switch (info)
+		{
+			case 20: *this = false; return;
+			case 21: *this = true; return;
+			case 22:
+			case 23: reset(Type::Null); return;	 // null, undefined
+			case 25:
+				*this = halfToDouble(
+					static_cast<uint16_t>(readUIntBigEndian(in, 2)));
+				m_single = true;
+				return;
+			case 26:
+			{
+				const auto u = static_cast<uint32_t>(readUIntBigEndian(in, 4));
+				float f;
+				std::memcpy(&f, &u, sizeof(f));
+				*this = f;
+				return;
+			}
+			case 27:
+			{
+				const uint64_t u = readUIntBigEndian(in, 8);
+				double d;
+				std::memcpy(&d, &u, sizeof(d));
+				*this = d;
+				return;
+			}
+			default:
+				THROW_EXCEPTION_FMT(
+					"CBOR: unsupported simple value (%u)",
+					static_cast<unsigned>(info));
+		};
+	}
+
+	const uint64_t arg = readArgument(in, info);
+	switch (mt)
+	{
+		case MT_UINT: *this = static_cast<UInt64>(arg); break;
+		case MT_NEGINT:
+			ASSERTMSG_(
+				arg <= static_cast<uint64_t>(
+						   std::numeric_limits<Int64>::max()),
+				"CBOR: negative integer out of range");
+			*this = -1 - static_cast<Int64>(arg);
+			break;
+		case MT_BYTES:
+			// A plain byte string: a uint8 typed array
+			reset(Type::TypedArray);
+			m_arrayType = SchemeArrayType::UInt8;
+			readBlob(in, arg, m_bytes);
+			break;
+		case MT_TEXT:
+			reset(Type::String);
+			readBlob(in, arg, m_str);
+			break;
+		case MT_ARRAY:
+		{
+			reset(Type::Array);
+			m_items.reserve(static_cast<size_t>(std::min<uint64_t>(arg, 4096)));
+			for (uint64_t k = 0; k < arg; k++)
+			{
+				m_items.push_back(std::make_unique<CBORValue>());
+				m_items.back()->decode(in, depth + 1);
+			}
+		}
+		break;
+		case MT_MAP:
+		{
+			reset(Type::Map);
+			CBORValue key;
+			for (uint64_t k = 0; k < arg; k++)
+			{
+				key.decode(in, depth + 1);
+				ASSERTMSG_(
+					key.type() == Type::String,
+					"CBOR: only text map keys are supported");
+				m_keys.push_back(std::move(key.m_str));
+				m_items.push_back(std::make_unique<CBORValue>());
+				m_items.back()->decode(in, depth + 1);
+			}
+		}
+		break;
+		case MT_TAG:
+		{
+			decode(in, depth + 1);	// The tagged item
+			SchemeArrayType t;
+			bool littleEndian;
+			if (!parseTypedArrayTag(arg, t, littleEndian)) break;  // Ignored
+			ASSERTMSG_(
+				m_type == Type::TypedArray,
+				"CBOR: typed array tag on an item which is not a byte string");
+			const size_t esz = elementSize(t);
+			ASSERTMSG_(
+				m_bytes.size() % esz == 0,
+				"CBOR: typed array size is not a multiple of its element size");
+			m_arrayType = t;
+			if (esz > 1 && littleEndian == bool(MRPT_IS_BIG_ENDIAN))
+				for (size_t i = 0; i < m_bytes.size(); i += esz)
+					std::reverse(&m_bytes[i], &m_bytes[i] + esz);
+		}
+		break;
+	};
+}
+
+std::ostream& mrpt::serialization::operator<<(
+	std::ostream& out, const CBORValue& v)
+{
+	v.encode(out);
+	return out;
+}
+
+std::istream& mrpt::serialization::operator>>(std::istream& in, CBORValue& v)
+{
+	v.decode(in);
+	return in;
+}
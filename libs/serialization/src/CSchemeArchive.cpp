@@ -10,6 +10,7 @@
 #include "serialization-precomp.h"	// Precompiled headers
 //
 #include <mrpt/core/exceptions.h>
+#include <mrpt/serialization/CBORValue.h>
 #include <mrpt/serialization/CSchemeArchive.h>
 
 // Check if we have jsoncpp to enable those tests:
@@ -29,3 +30,12 @@ CSchemeArchiveBase mrpt::serialization::archiveJSON()
 	THROW_EXCEPTION("archiveJSON() requires building MRPT against jsoncpp");
 #endif
 }
+
+static_assert(
+	mrpt::serialization::internal::scheme_has_typed_arrays<CBORValue>::value);
+
+CSchemeArchiveBase mrpt::serialization::archiveCBOR()
+{
+	return mrpt::serialization::CSchemeArchiveBase(
+		std::make_unique<CSchemeArchive<CBORValue>>());
+}
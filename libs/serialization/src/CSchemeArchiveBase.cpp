@@ -24,3 +24,20 @@ void CSchemeArchiveBase_impl::WriteObject(
 {
 	CSchemeArchiveBase::WriteObject(in, obj);
 }
+
+void CSchemeArchiveBase_impl::writeArray(
+	[[maybe_unused]] SchemeArrayType type, [[maybe_unused]] const void* data,
+	[[maybe_unused]] size_t count)
+{
+	THROW_EXCEPTION("This archive does not support numeric arrays");
+}
+size_t CSchemeArchiveBase_impl::arraySize() const
+{
+	THROW_EXCEPTION("This archive does not support numeric arrays");
+}
+void CSchemeArchiveBase_impl::readArray(
+	[[maybe_unused]] SchemeArrayType type, [[maybe_unused]] void* data,
+	[[maybe_unused]] size_t count)
+{
+	THROW_EXCEPTION("This archive does not support numeric arrays");
+}
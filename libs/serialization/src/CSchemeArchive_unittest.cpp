@@ -8,8 +8,10 @@
    +------------------------------------------------------------------------+ */
 
 #include <gtest/gtest.h>
+#include <mrpt/math/CMatrixD.h>
 #include <mrpt/poses/CPose2D.h>
 #include <mrpt/serialization/CArchive.h>
+#include <mrpt/serialization/CBORValue.h>
 #include <mrpt/serialization/CSchemeArchive.h>
 #include <mrpt/serialization/CSchemeArchiveBase.h>
 
@@ -72,3 +74,142 @@ TEST(SchemaSerialization, JSON_raw)
 }
 
 #endif
+
+namespace
+{
+std::string toHex(const std::string& bytes)
+{
+	std::string s;
+	for (unsigned char c : bytes)
+		s += mrpt::format("%02x", c);
+	return s;
+}
+std::string fromHex(const std::string& hex)
+{
+	std::string s;
+	for (size_t i = 0; i + 1 < hex.size(); i += 2)
+		s += static_cast<char>(std::stoi(hex.substr(i, 2), nullptr, 16));
+	return s;
+}
+std::string encode(const CBORValue& v)
+{
+	std::stringstream ss(std::ios::out | std::ios::binary);
+	ss << v;
+	return toHex(ss.str());
+}
+CBORValue decode(const std::string& hex)
+{
+	std::stringstream ss(
+		fromHex(hex), std::ios::in | std::ios::out | std::ios::binary);
+	CBORValue v;
+	ss >> v;
+	return v;
+}
+}  // namespace
+
+TEST(SchemaSerialization, CBOR_encoding)
+{
+	// Examples from RFC 8949, Appendix A:
+	CBORValue v;
+	EXPECT_EQ(encode(v = 0), "00");
+	EXPECT_EQ(encode(v = 23), "17");
+	EXPECT_EQ(encode(v = 24), "1818");
+	EXPECT_EQ(encode(v = 1000), "1903e8");
+	EXPECT_EQ(encode(v = uint64_t(1000000000000)), "1b000000e8d4a51000");
+	EXPECT_EQ(encode(v = -1), "20");
+	EXPECT_EQ(encode(v = -1000), "3903e7");
+	EXPECT_EQ(encode(v = 1.1), "fb3ff199999999999a");
+	EXPECT_EQ(encode(v = 100000.0f), "fa47c35000");
+	EXPECT_EQ(encode(v = true), "f5");
+	EXPECT_EQ(encode(CBORValue()), "f6");
+	EXPECT_EQ(encode(v = "IETF"), "6449455446");
+
+	CBORValue m;
+	m["a"] = 1;
+	m["b"][0] = 2;
+	m["b"][1] = 3;
+	EXPECT_EQ(encode(m), "a26161016162820203");
+
+	// Decoding:
+	EXPECT_EQ(decode("1b000000e8d4a51000").asUInt64(), 1000000000000U);
+	EXPECT_EQ(decode("3903e7").asInt(), -1000);
+	EXPECT_EQ(decode("f93c00").asDouble(), 1.0);  // float16
+	EXPECT_EQ(decode("f97bff").asDouble(), 65504.0);
+	EXPECT_EQ(decode("6449455446").asString(), "IETF");
+	const auto m2 = decode("a26161016162820203");
+	EXPECT_EQ(m2.getMemberNames().size(), 2U);
+	EXPECT_EQ(m2["b"][1].asInt(), 3);
+	// Unknown tags are ignored (0: date/time string):
+	EXPECT_EQ(decode("c074323031332d30332d32315432303a30343a30305a")
+				  .asString(),
+			  "2013-03-21T20:04:00Z");
+
+	// Invalid or unsupported data:
+	EXPECT_ANY_THROW(decode("1903"));  // Truncated
+	EXPECT_ANY_THROW(decode("9fff"));  // Indefinite length
+	EXPECT_ANY_THROW(decode("a1016161"));  // Non-text key
+}
+
+TEST(SchemaSerialization, CBOR_typedArrays)
+{
+	const std::vector<double> d = {1.0, -2.5, 1e6};
+	CBORValue v;
+	v.setTypedArray(d);
+	// RFC 8746 tag 86 (float64, little endian) + 24-byte string:
+	if (!MRPT_IS_BIG_ENDIAN)
+		EXPECT_EQ(
+			encode(v),
+			"d8565818000000000000f03f00000000000004c00000000080842e41");
+
+	const auto v2 = decode(encode(v));
+	EXPECT_EQ(v2.type(), CBORValue::Type::TypedArray);
+	EXPECT_EQ(v2.getTypedArray<double>(), d);
+	// With conversion:
+	EXPECT_EQ(
+		v2.getTypedArray<int32_t>(), std::vector<int32_t>({1, -2, 1000000}));
+
+	// Big endian int16 (tag 73), and regular arrays, are also understood:
+	EXPECT_EQ(
+		decode("d84944fffe0102").getTypedArray<int16_t>(),
+		std::vector<int16_t>({-2, 258}));
+	EXPECT_EQ(
+		decode("83010203").getTypedArray<float>(),
+		std::vector<float>({1, 2, 3}));
+}
+
+TEST(SchemaSerialization, CBOR_archive)
+{
+	mrpt::poses::CPose2D pt1{1.0, 2.0, 3.0}, pt2;
+	mrpt::math::CMatrixD M1(20, 30), M2;
+	for (int r = 0; r < M1.rows(); r++)
+		for (int c = 0; c < M1.cols(); c++)
+			M1(r, c) = r * 0.1 - c;
+
+	std::stringstream ss(
+		std::ios::in | std::ios::out | std::ios::binary);
+	{
+		auto arch = archiveCBOR();
+		arch["pose"] = pt1;
+		arch["matrix"] = M1;
+		arch["name"] = std::string("test");
+		ss << arch;
+	}
+	// Matrix elements as a binary blob, not as text:
+	EXPECT_LT(ss.str().size(), 20U * 30U * 8U + 200U);
+
+	auto arch2 = archiveCBOR();
+	ss >> arch2;
+	arch2["pose"].readTo(pt2);
+	arch2["matrix"].readTo(M2);
+	EXPECT_EQ(static_cast<std::string>(arch2["name"]), "test");
+
+	EXPECT_NEAR(pt1.x(), pt2.x(), 1e-6);
+	EXPECT_NEAR(pt1.y(), pt2.y(), 1e-6);
+	EXPECT_NEAR(pt1.phi(), pt2.phi(), 1e-6);
+	EXPECT_EQ(M1, M2);
+
+	std::vector<float> v;
+	arch2["matrix"]["data"].readArray(v);
+	ASSERT_EQ(v.size(), 20U * 30U);
+	EXPECT_FLOAT_EQ(v[31], static_cast<float>(M1(1, 1)));
+}
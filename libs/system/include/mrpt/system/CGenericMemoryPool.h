@@ -37,6 +37,9 @@ namespace mrpt::system
  *contain the memory blocks (e.g. one or more std::vector).
  *  \tparam DATA_PARAMS A struct with user information about each memory block
  *(e.g. size of a std::vector)
+ *
+ * \deprecated Requests are served by a linear search under a global mutex.
+ * Prefer mrpt::system::CObjectPool.
  * \ingroup mrpt_memory
  */
 template <class DATA_PARAMS, class POOLABLE_DATA>
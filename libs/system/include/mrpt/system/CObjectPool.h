@@ -0,0 +1,374 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mrpt::system
+{
+/** \addtogroup mrpt_memory
+ * @{ */
+
+/** Rounds `n` up to the nearest "size class": values with at most 4
+ * significant bits (8 classes per power of two), so rounding wastes at most
+ * 12.5%. Use it as the key of CObjectPool for objects holding buffers whose
+ * capacity may be larger than requested: request `size_class_ceil(n)`, and
+ * reserve that capacity on misses.
+ * \sa size_class_floor
+ * \note (New in MRPT 2.4.3)
+ */
+inline std::size_t size_class_ceil(std::size_t n)
+{
+	if (n <= 8) return n;
+	std::size_t step = 1;
+	while ((n >> 3) >= (step << 1))
+		step <<= 1;
+	return (n + step - 1) & ~(step - 1);
+}
+
+/** The largest size class (see size_class_ceil()) not greater than `n`. Use
+ * it as the key when returning a buffer with capacity `n` to a CObjectPool.
+ * \note (New in MRPT 2.4.3)
+ */
+inline std::size_t size_class_floor(std::size_t n)
+{
+	if (n <= 8) return n;
+	std::size_t step = 1;
+	while ((n >> 3) >= (step << 1))
+		step <<= 1;
+	return n & ~(step - 1);
+}
+
+/** A thread-safe pool of reusable objects of type `T` (typically, structs
+ * holding large buffers), classified by a key (e.g. a buffer size, or a size
+ * class, see size_class_ceil()).
+ *
+ * Objects are taken with tryAcquire() or acquire() and returned with
+ * release(), or automatically when the Handle returned by acquire() is
+ * destroyed. Each thread keeps a small cache of released objects, so
+ * objects released and acquired again in the same thread do not take any
+ * lock. The rest are kept in per-key lists under a mutex, so all operations
+ * are O(1).
+ *
+ * Up to getMaxFreeObjectsPerKey() free objects are kept for each key, and up
+ * to getMaxFreeObjects() overall; the rest are destroyed when released.
+ *
+ * This class implements the singleton pattern, so a unique instance exists
+ * for each combination of template parameters.
+ *
+ * Usage:
+ * \code
+ * struct Buffers { std::vector<float> xs, ys; };
+ * using Pool = mrpt::system::CObjectPool<Buffers>;
+ *
+ * if (auto* pool = Pool::getInstance())
+ * {
+ *    auto h = pool->acquire(N); // A new object if none was available
+ *    h->xs.resize(N);
+ *    // ...
+ * }  // Back to the pool.
+ * \endcode
+ *
+ * \tparam T The pooled type. Must be default-constructible.
+ * \tparam KEY A hashable key type.
+ * \note (New in MRPT 2.4.3)
+ */
+template <class T, class KEY = std::size_t, class HASH = std::hash<KEY>>
+class CObjectPool
+{
+   public:
+	using pool_t = CObjectPool<T, KEY, HASH>;
+
+	/** Construct-on-first-use (~singleton) pattern: Returns the unique
+	 * instance for these template arguments, or nullptr if it was once
+	 * created but it's been destroyed (i.e. during the program global
+	 * destruction phase).
+	 */
+	static pool_t* getInstance()
+	{
+		static pool_t inst;
+		return destroyed() ? nullptr : &inst;
+	}
+
+	/** RAII owner of a pooled object, which returns it to the pool upon
+	 * destruction (or it is destroyed, if the pool no longer exists). */
+	class Handle
+	{
+	   public:
+		Handle() = default;
+		Handle(const KEY& key, std::unique_ptr<T>&& obj)
+			: m_key(key), m_obj(std::move(obj))
+		{
+		}
+		~Handle() { reset(); }
+
+		Handle(Handle&&) = default;
+		Handle& operator=(Handle&& o)
+		{
+			if (this != &o)
+			{
+				reset();
+				m_key = std::move(o.m_key);
+				m_obj = std::move(o.m_obj);
+			}
+			return *this;
+		}
+
+		T* get() const { return m_obj.get(); }
+		T& operator*() const { return *m_obj; }
+		T* operator->() const { return m_obj.get(); }
+		explicit operator bool() const { return m_obj != nullptr; }
+		const KEY& key() const { return m_key; }
+
+		/** Returns the object to the pool now. */
+		void reset()
+		{
+			if (!m_obj) return;
+			if (auto* pool = pool_t::getInstance())
+				pool->release(m_key, std::move(m_obj));
+			m_obj.reset();
+		}
+
+		/** Takes the ownership of the object, which will not return to the
+		 * pool. */
+		std::unique_ptr<T> detach() { return std::move(m_obj); }
+
+	   private:
+		KEY m_key{};
+		std::unique_ptr<T> m_obj;
+	};
+
+	/** Returns a free object for the given key, or nullptr if none is
+	 * available. */
+	std::unique_ptr<T> tryAcquire(const KEY& key)
+	{
+		m_requests.fetch_add(1, std::memory_order_relaxed);
+
+		// 1st: this thread cache:
+		auto& tc = threadCache();
+		for (std::size_t i = 0; i < tc.n; i++)
+		{
+			if (!(tc.entries[i].first == key)) continue;
+			std::unique_ptr<T> obj = std::move(tc.entries[i].second);
+			tc.entries[i] = std::move(tc.entries[--tc.n]);
+			m_numFree.fetch_sub(1, std::memory_order_relaxed);
+			m_threadCacheHits.fetch_add(1, std::memory_order_relaxed);
+			m_hits.fetch_add(1, std::memory_order_relaxed);
+			return obj;
+		}
+
+		// 2nd: the shared lists:
+		if (m_numFree.load(std::memory_order_relaxed) == 0) return {};
+		std::lock_guard<std::mutex> lck(m_mtx);
+		auto it = m_free.find(key);
+		if (it == m_free.end()) return {};
+		std::unique_ptr<T> obj = std::move(it->second.back());
+		it->second.pop_back();
+		if (it->second.empty()) m_free.erase(it);
+		m_numFree.fetch_sub(1, std::memory_order_relaxed);
+		m_hits.fetch_add(1, std::memory_order_relaxed);
+		return obj;
+	}
+
+	/** Returns a free object for the given key from the pool, or a new
+	 * default-constructed one if none is available. */
+	Handle acquire(const KEY& key)
+	{
+		auto obj = tryAcquire(key);
+		if (!obj) obj = std::make_unique<T>();
+		return Handle(key, std::move(obj));
+	}
+
+	/** Gives an object to the pool, to be returned by later requests for the
+	 * same key. It is destroyed instead if the pool is full. */
+	void release(const KEY& key, std::unique_ptr<T>&& obj)
+	{
+		if (!obj) return;
+		if (m_numFree.load(std::memory_order_relaxed) >=
+			m_maxFreeObjects.load(std::memory_order_relaxed))
+		{
+			m_discarded.fetch_add(1, std::memory_order_relaxed);
+			obj.reset();
+			return;
+		}
+		m_recycled.fetch_add(1, std::memory_order_relaxed);
+		m_numFree.fetch_add(1, std::memory_order_relaxed);
+
+		auto& tc = threadCache();
+		if (tc.n < m_threadCacheSize.load(std::memory_order_relaxed))
+		{
+			tc.entries[tc.n++] = {key, std::move(obj)};
+			return;
+		}
+		releaseShared(key, std::move(obj));
+	}
+
+	/** Max. number of free objects kept for each key (Default=4) */
+	void setMaxFreeObjectsPerKey(std::size_t n) { m_maxFreePerKey = n; }
+	std::size_t getMaxFreeObjectsPerKey() const { return m_maxFreePerKey; }
+
+	/** Max. number of free objects kept overall (Default=32) */
+	void setMaxFreeObjects(std::size_t n) { m_maxFreeObjects = n; }
+	std::size_t getMaxFreeObjects() const { return m_maxFreeObjects; }
+
+	/** Max. number of free objects cached by each thread, up to
+	 * MAX_THREAD_CACHE_SIZE (Default=2). Cached objects can only be reused by
+	 * the same thread, so use small values for large objects typically
+	 * released and acquired by different threads. */
+	void setThreadCacheSize(std::size_t n)
+	{
+		m_threadCacheSize = std::min(n, MAX_THREAD_CACHE_SIZE);
+	}
+	std::size_t getThreadCacheSize() const { return m_threadCacheSize; }
+	static constexpr std::size_t MAX_THREAD_CACHE_SIZE = 4;
+
+	/** Destroys the free objects (except those cached by other threads). */
+	void clear()
+	{
+		auto& tc = threadCache();
+		for (std::size_t i = 0; i < tc.n; i++)
+			tc.entries[i].second.reset();
+		m_numFree.fetch_sub(tc.n, std::memory_order_relaxed);
+		tc.n = 0;
+
+		std::lock_guard<std::mutex> lck(m_mtx);
+		for (const auto& kv : m_free)
+			m_numFree.fetch_sub(kv.second.size(), std::memory_order_relaxed);
+		m_free.clear();
+	}
+
+	/** Usage statistics, as returned by getStats() */
+	struct TStats
+	{
+		/** Number of calls to tryAcquire() or acquire() */
+		uint64_t requests = 0;
+		/** Requests served with a pooled object */
+		uint64_t hits = 0;
+		/** Hits served from the cache of the calling thread */
+		uint64_t threadCacheHits = 0;
+		/** Objects released to the pool / destroyed since it was full */
+		uint64_t recycled = 0, discarded = 0;
+		/** Number of free objects, including those in thread caches */
+		std::size_t freeObjects = 0;
+
+		double hitRatio() const
+		{
+			return requests != 0 ? static_cast<double>(hits) / requests : 0;
+		}
+	};
+
+	TStats getStats() const
+	{
+		TStats s;
+		s.requests = m_requests.load(std::memory_order_relaxed);
+		s.hits = m_hits.load(std::memory_order_relaxed);
+		s.threadCacheHits = m_threadCacheHits.load(std::memory_order_relaxed);
+		s.recycled = m_recycled.load(std::memory_order_relaxed);
+		s.discarded = m_discarded.load(std::memory_order_relaxed);
+		s.freeObjects = m_numFree.load(std::memory_order_relaxed);
+		return s;
+	}
+	/** Resets the counters of getStats() (not the number of free objects) */
+	void resetStats()
+	{
+		m_requests = 0;
+		m_hits = 0;
+		m_threadCacheHits = 0;
+		m_recycled = 0;
+		m_discarded = 0;
+	}
+
+	~CObjectPool()
+	{
+		destroyed() = true;
+		// Objects in the cache of this thread are freed by its dtor, and
+		// those of other threads, when they end.
+		std::lock_guard<std::mutex> lck(m_mtx);
+		m_free.clear();
+	}
+
+	CObjectPool(const CObjectPool&) = delete;
+	CObjectPool& operator=(const CObjectPool&) = delete;
+
+   private:
+	CObjectPool() = default;
+
+	/** Set upon destruction of the instance. Trivially destructible, so it
+	 * remains valid until the end of the program. */
+	static std::atomic_bool& destroyed()
+	{
+		static std::atomic_bool d{false};
+		return d;
+	}
+
+	/** Free objects owned by one thread. Moved to the shared lists when the
+	 * thread ends. */
+	struct ThreadCache
+	{
+		std::array<std::pair<KEY, std::unique_ptr<T>>, MAX_THREAD_CACHE_SIZE>
+			entries;
+		std::size_t n = 0;
+
+		~ThreadCache()
+		{
+			pool_t* pool = pool_t::getInstance();
+			for (std::size_t i = 0; i < n; i++)
+			{
+				if (!pool) break;
+				pool->releaseShared(
+					entries[i].first, std::move(entries[i].second));
+			}
+		}
+	};
+
+	static ThreadCache& threadCache()
+	{
+		thread_local ThreadCache tc;
+		return tc;
+	}
+
+	/** Stores an object already accounted in m_numFree */
+	void releaseShared(const KEY& key, std::unique_ptr<T>&& obj)
+	{
+		std::lock_guard<std::mutex> lck(m_mtx);
+		auto& lst = m_free[key];
+		if (lst.size() >= m_maxFreePerKey)
+		{
+			if (lst.empty()) m_free.erase(key);
+			m_numFree.fetch_sub(1, std::memory_order_relaxed);
+			m_recycled.fetch_sub(1, std::memory_order_relaxed);
+			m_discarded.fetch_add(1, std::memory_order_relaxed);
+			obj.reset();
+			return;
+		}
+		lst.emplace_back(std::move(obj));
+	}
+
+	std::mutex m_mtx;  //!< Protects m_free
+	std::unordered_map<KEY, std::vector<std::unique_ptr<T>>, HASH> m_free;
+
+	std::atomic<std::size_t> m_maxFreePerKey{4}, m_maxFreeObjects{32},
+		m_threadCacheSize{2};
+	std::atomic<std::size_t> m_numFree{0};
+	std::atomic<uint64_t> m_requests{0}, m_hits{0}, m_threadCacheHits{0},
+		m_recycled{0}, m_discarded{0};
+};
+
+/** @} */
+}  // namespace mrpt::system
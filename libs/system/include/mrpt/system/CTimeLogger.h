@@ -12,6 +12,7 @@
 #include <mrpt/core/exceptions.h>
 #include <mrpt/system/COutputLogger.h>
 #include <mrpt/system/CTicTac.h>
+#include <mrpt/system/CTraceProfiler.h>
 
 #include <deque>
 #include <map>
@@ -43,7 +44,10 @@ namespace mrpt::system
  * the latter case (and, actually, in general since it's safer against
  * exceptions), use the RAII helper class CTimeLoggerEntry.
  *
- * \sa CTimeLoggerEntry
+ * While CTraceProfiler is enabled, all sections are also recorded there, even
+ * if this object is disabled.
+ *
+ * \sa CTimeLoggerEntry, CTraceProfiler
  *
  * \note The default behavior is dumping all the information at destruction.
  * \ingroup mrpt_system_grp
@@ -110,6 +114,8 @@ class CTimeLogger : public mrpt::system::COutputLogger
 
 	void do_enter(const std::string_view& func_name) noexcept;
 	double do_leave(const std::string_view& func_name) noexcept;
+	static void trace_enter(const std::string_view& func_name) noexcept;
+	static void trace_leave(const std::string_view& func_name) noexcept;
 
    public:
 	/** Data of each call section: # of calls, minimum, maximum, average and
@@ -180,11 +186,14 @@ class CTimeLogger : public mrpt::system::COutputLogger
 	inline void enter(const std::string_view& func_name) noexcept
 	{
 		if (m_enabled) do_enter(func_name);
+		if (CTraceProfiler::isEnabled()) trace_enter(func_name);
 	}
 	/** End of a named section \return The ellapsed time, in seconds or 0 if
 	 * disabled. \sa enter */
 	inline double leave(const std::string_view& func_name) noexcept
 	{
+		// Even if the profiler was disabled after enter(), to close the scope
+		if (CTraceProfiler::wasEverEnabled()) trace_leave(func_name);
 		return m_enabled ? do_leave(func_name) : 0;
 	}
 	/** Return the mean execution time of the given "section", or 0 if it hasn't
@@ -238,10 +247,13 @@ struct CTimeLoggerEntry
 
    private:
 	// Note we cannot store the string_view since we have no guarantees of the
-	// life-time of the provided string buffer.
-	const std::string m_section_name;
+	// life-time of the provided string buffer. Only copied if the logger was
+	// enabled upon construction.
+	std::string m_section_name;
 	double m_entry = 0;
 	bool stopped_{false};
+	bool m_logged{false}, m_traced{false};
+	trace_scope_id_t m_trace_id{0};
 };
 
 /** A helper class to save CSV stats upon self destruction, for example, at the
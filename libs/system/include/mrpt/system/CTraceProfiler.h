@@ -0,0 +1,238 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/pimpl.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mrpt::system
+{
+/** Unique identifier of a scope name in CTraceProfiler.
+ * \ingroup mrpt_system_grp */
+using trace_scope_id_t = uint32_t;
+
+/** A low-overhead, lock-free hierarchical profiler, for instrumenting hot code
+ * paths that would be too costly to profile with CTimeLogger.
+ *
+ * Scopes are identified by integer ids (see internScope()), which the
+ * MRPT_TRACE_SCOPE() macro obtains only once per call site. Each thread
+ * records its enter/leave events into its own fixed-size ring buffer (the
+ * oldest events being overwritten), and accumulates the time spent in each
+ * node of its own call tree (so the same scope called from different parents
+ * is accounted separately). None of them takes any lock, so the cost of a
+ * profiled scope is basically that of reading the clock twice.
+ *
+ * The results can be obtained, at any time and from any thread, as:
+ * - Per-thread call trees: getCallTrees(), getCallTreesAsText().
+ * - "Folded stacks", for flame graph tools: getFoldedStacks().
+ * - The recent events of the ring buffers in the Chrome trace event format,
+ *   which can be opened with `chrome://tracing` or
+ *   [Perfetto](https://ui.perfetto.dev): saveChromeTrace().
+ *
+ * Usage:
+ * \code
+ * void foo()
+ * {
+ *   MRPT_TRACE_SCOPE("foo");
+ *   // ...
+ * }
+ *
+ * auto& tp = mrpt::system::CTraceProfiler::Instance();
+ * tp.enable();
+ * foo();
+ * tp.saveChromeTrace("trace.json");
+ * \endcode
+ *
+ * While this profiler is enabled, CTimeLoggerEntry and CTimeLogger::enter() /
+ * CTimeLogger::leave() also record their sections here, so code already
+ * instrumented with CTimeLogger shows up in the traces too.
+ *
+ * The profiler is disabled by default, unless the environment variable
+ * `MRPT_TRACE_PROFILER_FILE` is defined: then, it is enabled on start up and
+ * the Chrome trace is saved to that file on exit.
+ *
+ * \note (New in MRPT 2.4.3)
+ * \sa MRPT_TRACE_SCOPE, CTraceScope, CTimeLogger
+ * \ingroup mrpt_system_grp
+ */
+class CTraceProfiler
+{
+   public:
+	/** Returns the unique instance of the profiler, which is never destroyed
+	 * (so it can be used from destructors of static objects). */
+	static CTraceProfiler& Instance();
+	~CTraceProfiler();
+
+	void enable(bool enabled = true)
+	{
+		if (enabled) s_everEnabled.store(true, std::memory_order_relaxed);
+		s_enabled.store(enabled, std::memory_order_relaxed);
+	}
+	void disable() { enable(false); }
+	/** Static and inline, so disabled call sites (e.g. CTimeLogger::enter())
+	 * pay a single relaxed atomic load, without calling Instance(). */
+	static bool isEnabled() noexcept
+	{
+		return s_enabled.load(std::memory_order_relaxed);
+	}
+	/** True if the profiler has been enabled at any time. Used by call sites
+	 * that must forward leave() calls even after disabling the profiler
+	 * (e.g. CTimeLogger::leave()), to skip them if it was never used. */
+	static bool wasEverEnabled() noexcept
+	{
+		return s_everEnabled.load(std::memory_order_relaxed);
+	}
+
+	/** Returns the id of a scope name, registering it the first time.
+	 * This takes a mutex: call it once per call site and keep the id (as
+	 * MRPT_TRACE_SCOPE() does). */
+	trace_scope_id_t internScope(const std::string_view& name);
+
+	/** Like internScope(), but first looks in a per-thread cache indexed by
+	 * the address of the string, so it is cheap for string literals. Used
+	 * for the section names of CTimeLogger. */
+	trace_scope_id_t internScopeCached(const std::string_view& name);
+
+	/** The name of a scope id, or an empty string if not registered. */
+	std::string getScopeName(trace_scope_id_t id) const;
+
+	/** Start of a scope in the calling thread. Normally, use
+	 * MRPT_TRACE_SCOPE() or CTraceScope instead. Does nothing if the profiler
+	 * is disabled. */
+	void enter(trace_scope_id_t id) noexcept;
+	/** End of a scope in the calling thread. If inner scopes were left open,
+	 * they are also closed. Scopes not open in this thread are ignored. */
+	void leave(trace_scope_id_t id) noexcept;
+
+	/** Sets the capacity (number of enter/leave events) of the ring buffer of
+	 * the threads that start using the profiler after this call. Zero
+	 * disables the trace events, keeping the call tree stats only.
+	 * Default: 32768. */
+	void setRingBufferSize(std::size_t numEvents);
+	std::size_t getRingBufferSize() const;
+
+	/** A node of a call tree, with the stats of all calls to a scope from the
+	 * same path of parent scopes. All times are in seconds. */
+	struct TCallTreeNode
+	{
+		std::string name;
+		uint64_t n_calls = 0;
+		double total_t = 0, min_t = 0, max_t = 0;
+		/** In the order they were first called */
+		std::vector<TCallTreeNode> children;
+
+		double mean_t() const { return n_calls ? total_t / n_calls : 0; }
+		/** Total time minus the total time of the children */
+		double self_t() const;
+	};
+
+	/** The call tree of one thread. */
+	struct TThreadCallTree
+	{
+		/** Thread name (see mrpt::system::thread_name()) when it first used
+		 * the profiler. */
+		std::string thread_name;
+		/** Sequential index of the thread, in the order they first used the
+		 * profiler (starting at 1). Also used as "tid" in Chrome traces. */
+		uint32_t thread_index = 0;
+		/** The root node has no name. Its children are the outermost scopes.
+		 */
+		TCallTreeNode root;
+	};
+
+	/** Call trees of all the threads that ever used the profiler. Scopes still
+	 * open do not count their current call. */
+	std::vector<TThreadCallTree> getCallTrees() const;
+
+	/** Call trees in a human-readable table. */
+	std::string getCallTreesAsText() const;
+
+	/** One line per call path, as "thread;scope1;scope2 <self time>", with
+	 * times in microseconds. This is the input format of flamegraph.pl,
+	 * speedscope, etc. */
+	std::string getFoldedStacks() const;
+
+	/** The events in the ring buffers, in the JSON Chrome trace event format.
+	 */
+	std::string getChromeTrace() const;
+
+	/** Saves getChromeTrace() to a file. \return false on error. */
+	bool saveChromeTrace(const std::string& file) const;
+
+	/** Discards all events and stats (scope ids remain valid).
+	 * \note Not thread-safe: call it only when no other thread is using the
+	 * profiler. */
+	void clear();
+
+	CTraceProfiler(const CTraceProfiler&) = delete;
+	CTraceProfiler& operator=(const CTraceProfiler&) = delete;
+	CTraceProfiler(CTraceProfiler&&) = delete;
+	CTraceProfiler& operator=(CTraceProfiler&&) = delete;
+
+   private:
+	CTraceProfiler();
+
+	inline static std::atomic_bool s_enabled{false};
+	inline static std::atomic_bool s_everEnabled{false};
+
+	struct Impl;
+	spimpl::unique_impl_ptr<Impl> m_impl;
+};
+
+/** RAII helper for CTraceProfiler::enter() and CTraceProfiler::leave().
+ * Normally, use the MRPT_TRACE_SCOPE() macro instead.
+ * \ingroup mrpt_system_grp
+ */
+class CTraceScope
+{
+   public:
+	explicit CTraceScope(trace_scope_id_t id) noexcept : m_id(id)
+	{
+		if (CTraceProfiler::isEnabled())
+		{
+			m_active = true;
+			CTraceProfiler::Instance().enter(id);
+		}
+	}
+	~CTraceScope()
+	{
+		if (m_active) CTraceProfiler::Instance().leave(m_id);
+	}
+
+	CTraceScope(const CTraceScope&) = delete;
+	CTraceScope& operator=(const CTraceScope&) = delete;
+
+   private:
+	trace_scope_id_t m_id;
+	bool m_active = false;
+};
+
+}  // namespace mrpt::system
+
+#define MRPT_TRACE_CONCAT_(A, B) A##B
+#define MRPT_TRACE_CONCAT(A, B) MRPT_TRACE_CONCAT_(A, B)
+
+/** Profiles the rest of the current scope with mrpt::system::CTraceProfiler,
+ * under the given name (a string literal). The name is registered only the
+ * first time the line is executed.
+ * \ingroup mrpt_system_grp
+ */
+#define MRPT_TRACE_SCOPE(NAME)                                                 \
+	static const mrpt::system::trace_scope_id_t MRPT_TRACE_CONCAT(             \
+		mrpt_trace_id_, __LINE__) =                                            \
+		mrpt::system::CTraceProfiler::Instance().internScope(NAME);            \
+	const mrpt::system::CTraceScope MRPT_TRACE_CONCAT(                         \
+		mrpt_trace_scope_, __LINE__)(                                          \
+		MRPT_TRACE_CONCAT(mrpt_trace_id_, __LINE__))
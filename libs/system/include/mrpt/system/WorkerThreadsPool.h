@@ -24,6 +24,8 @@ namespace mrpt::system
 /**
  * @brief A simple thread pool
  *
+ * \sa For data parallelism, use mrpt::parallel_for() or mrpt::TaskGroup.
+ *
  * \note Partly based on: https://github.com/progschj/ThreadPool (ZLib license)
  */
 class WorkerThreadsPool
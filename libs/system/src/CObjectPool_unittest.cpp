@@ -0,0 +1,149 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/system/CObjectPool.h>
+
+#include <thread>
+#include <vector>
+
+using mrpt::system::CObjectPool;
+
+namespace
+{
+// Each test uses its own type, hence its own pool instance:
+template <int ID>
+struct TestBuffer
+{
+	std::vector<float> data;
+};
+}  // namespace
+
+TEST(CObjectPool, sizeClasses)
+{
+	using mrpt::system::size_class_ceil;
+	using mrpt::system::size_class_floor;
+
+	for (size_t n = 0; n < 100000; n++)
+	{
+		const size_t c = size_class_ceil(n);
+		ASSERT_GE(c, n);
+		ASSERT_LE(c - n, n / 8);  // <=12.5% waste
+		ASSERT_EQ(size_class_floor(c), c);	// A size class
+
+		const size_t f = size_class_floor(n);
+		ASSERT_LE(f, n);
+		ASSERT_EQ(size_class_ceil(f), f);
+		// No size class in between:
+		if (f != n) ASSERT_EQ(size_class_ceil(f + 1), size_class_ceil(n));
+	}
+	EXPECT_EQ(size_class_ceil(1U << 20), 1U << 20);
+	EXPECT_EQ(size_class_ceil((1U << 20) + 1), (1U << 20) + (1U << 17));
+}
+
+TEST(CObjectPool, acquireRelease)
+{
+	using Pool = CObjectPool<TestBuffer<1>>;
+	auto* pool = Pool::getInstance();
+	ASSERT_TRUE(pool != nullptr);
+	pool->setThreadCacheSize(0);  // Test the shared lists
+
+	EXPECT_FALSE(pool->tryAcquire(100));
+
+	float* buf = nullptr;
+	{
+		auto h = pool->acquire(100);  // A new one
+		ASSERT_TRUE(h);
+		h->data.resize(100);
+		buf = h->data.data();
+	}  // Back to the pool
+
+	EXPECT_FALSE(pool->tryAcquire(200));
+	auto obj = pool->tryAcquire(100);
+	ASSERT_TRUE(obj);
+	EXPECT_EQ(obj->data.data(), buf);
+	EXPECT_FALSE(pool->tryAcquire(100));
+
+	// Per-key limit:
+	pool->setMaxFreeObjectsPerKey(2);
+	for (int i = 0; i < 3; i++)
+		pool->release(5, std::make_unique<TestBuffer<1>>());
+
+	const auto s = pool->getStats();
+	EXPECT_EQ(s.requests, 5U);
+	EXPECT_EQ(s.hits, 1U);
+	EXPECT_EQ(s.threadCacheHits, 0U);
+	EXPECT_EQ(s.recycled, 3U);
+	EXPECT_EQ(s.discarded, 1U);
+	EXPECT_EQ(s.freeObjects, 2U);
+
+	pool->clear();
+	EXPECT_EQ(pool->getStats().freeObjects, 0U);
+	EXPECT_FALSE(pool->tryAcquire(5));
+}
+
+TEST(CObjectPool, threadCache)
+{
+	using Pool = CObjectPool<TestBuffer<2>>;
+	auto* pool = Pool::getInstance();
+	ASSERT_TRUE(pool != nullptr);
+
+	for (int i = 0; i < 10; i++)
+		pool->acquire(1);
+	auto s = pool->getStats();
+	EXPECT_EQ(s.requests, 10U);
+	EXPECT_EQ(s.hits, 9U);
+	EXPECT_EQ(s.threadCacheHits, 9U);
+
+	// Objects cached by a thread go to the shared lists when it ends:
+	std::thread([pool]() {
+		pool->release(2, std::make_unique<TestBuffer<2>>());
+	}).join();
+	EXPECT_TRUE(pool->tryAcquire(2));
+
+	// Total limit:
+	pool->clear();
+	pool->resetStats();
+	pool->setMaxFreeObjects(3);
+	for (int i = 0; i < 5; i++)
+		pool->release(i, std::make_unique<TestBuffer<2>>());
+	s = pool->getStats();
+	EXPECT_EQ(s.freeObjects, 3U);
+	EXPECT_EQ(s.discarded, 2U);
+	pool->clear();
+}
+
+TEST(CObjectPool, multithread)
+{
+	using Pool = CObjectPool<TestBuffer<3>>;
+	auto* pool = Pool::getInstance();
+	ASSERT_TRUE(pool != nullptr);
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++)
+		threads.emplace_back([pool, t]() {
+			for (int i = 0; i < 2000; i++)
+			{
+				auto h = pool->acquire(i % 3);
+				h->data.resize(10, static_cast<float>(t));
+				// Sometimes, released by another thread:
+				if (i % 5 == 0)
+					std::thread([h = std::move(h)]() mutable { h.reset(); })
+						.join();
+			}
+		});
+	for (auto& t : threads)
+		t.join();
+
+	const auto s = pool->getStats();
+	EXPECT_EQ(s.requests, 8000U);
+	EXPECT_GT(s.hitRatio(), 0.5);
+	EXPECT_LE(s.freeObjects, pool->getMaxFreeObjects());
+	pool->clear();
+}
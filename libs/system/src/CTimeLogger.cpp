@@ -373,6 +373,30 @@ double CTimeLogger::do_leave(const std::string_view& func_name) noexcept
 		return 0;  // This shouldn't happen!
 }
 
+void CTimeLogger::trace_enter(const std::string_view& func_name) noexcept
+{
+	try
+	{
+		auto& tp = CTraceProfiler::Instance();
+		tp.enter(tp.internScopeCached(func_name));
+	}
+	catch (...)
+	{
+	}
+}
+
+void CTimeLogger::trace_leave(const std::string_view& func_name) noexcept
+{
+	try
+	{
+		auto& tp = CTraceProfiler::Instance();
+		tp.leave(tp.internScopeCached(func_name));
+	}
+	catch (...)
+	{
+	}
+}
+
 void CTimeLogger::registerUserMeasure(
 	const std::string_view& event_name, const double value,
 	const bool is_time) noexcept
@@ -435,17 +459,30 @@ double CTimeLogger::getLastTime(const std::string& name) const
 
 CTimeLoggerEntry::CTimeLoggerEntry(
 	const CTimeLogger& logger, const std::string_view& section_name)
-	: m_logger(const_cast<CTimeLogger&>(logger)), m_section_name(section_name)
+	: m_logger(const_cast<CTimeLogger&>(logger))
 {
+	if (logger.isEnabled())
+	{
+		m_section_name = section_name;
+		m_logged = true;
+	}
+	if (CTraceProfiler::isEnabled())
+	{
+		auto& tp = CTraceProfiler::Instance();
+		m_trace_id = tp.internScopeCached(section_name);
+		m_traced = true;
+		tp.enter(m_trace_id);
+	}
 	m_entry = logger.m_tictac.Tac();
 }
 void CTimeLoggerEntry::stop()
 {
 	if (stopped_) return;
 	const double leave = m_logger.m_tictac.Tac();
-	const double dt = leave - m_entry;
+	if (m_traced) CTraceProfiler::Instance().leave(m_trace_id);
 
-	m_logger.registerUserMeasure(m_section_name, dt, true);
+	if (m_logged)
+		m_logger.registerUserMeasure(m_section_name, leave - m_entry, true);
 	stopped_ = true;
 }
 
@@ -0,0 +1,631 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "system-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/format.h>
+#include <mrpt/core/get_env.h>
+#include <mrpt/system/CTraceProfiler.h>
+#include <mrpt/system/string_utils.h>
+#include <mrpt/system/thread_name.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+using namespace mrpt::system;
+
+namespace
+{
+constexpr uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t NODES_PER_CHUNK = 1024;
+constexpr uint32_t MAX_NODE_CHUNKS = 64;
+
+enum EventType : uint32_t
+{
+	EV_ENTER = 0,
+	EV_LEAVE = 1
+};
+
+/** An entry of a ring buffer. Fields are atomic since they may be read by
+ * other threads while being overwritten (see TThreadData::push()). */
+struct TEvent
+{
+	std::atomic<uint64_t> t_ns{0};
+	std::atomic<uint32_t> id{0};
+	std::atomic<uint32_t> type{0};
+};
+
+/** A node of the call tree of a thread. Only the owner thread writes to it,
+ * other threads may read the nodes reachable from the root at any time. */
+struct TNode
+{
+	trace_scope_id_t id = 0;
+	uint32_t parent = NO_NODE;
+	/** Children list (the most recently added first) */
+	std::atomic<uint32_t> firstChild{NO_NODE}, nextSibling{NO_NODE};
+	std::atomic<uint64_t> n_calls{0}, total_ns{0},
+		min_ns{std::numeric_limits<uint64_t>::max()}, max_ns{0};
+	/** Start time of the current call (only used by the owner thread) */
+	uint64_t start_ns = 0;
+
+	void resetStats()
+	{
+		n_calls = 0;
+		total_ns = 0;
+		min_ns = std::numeric_limits<uint64_t>::max();
+		max_ns = 0;
+	}
+};
+
+// Since only the owner thread writes to its nodes and events, there is no
+// need for (more costly) atomic read-modify-write operations:
+inline void owner_store(std::atomic<uint64_t>& a, uint64_t v)
+{
+	a.store(v, std::memory_order_relaxed);
+}
+inline uint64_t owner_load(const std::atomic<uint64_t>& a)
+{
+	return a.load(std::memory_order_relaxed);
+}
+
+/** All the data of one thread */
+struct TThreadData
+{
+	std::string name;
+	uint32_t index = 0;
+
+	// Ring buffer: the event #i goes to events[i % capacity].
+	std::unique_ptr<TEvent[]> events;
+	std::size_t capacity = 0;
+	/** Number of events whose writing has started / finished. */
+	std::atomic<uint64_t> nStarted{0}, nWritten{0};
+
+	// Call tree, node #0 is the root:
+	std::array<std::atomic<TNode*>, MAX_NODE_CHUNKS> chunks{};
+	std::vector<std::unique_ptr<TNode[]>> chunksStorage;
+	std::atomic<uint32_t> nNodes{0};
+	/** The innermost open node (only used by the owner thread) */
+	uint32_t current = 0;
+	/** Number of open scopes not in the tree, if it got full */
+	uint32_t untrackedDepth = 0;
+
+	TThreadData(std::size_t ringSize)
+		: events(ringSize ? new TEvent[ringSize] : nullptr), capacity(ringSize)
+	{
+		addNode(0, NO_NODE);  // The root
+	}
+
+	TNode& node(uint32_t i) const
+	{
+		return chunks[i / NODES_PER_CHUNK].load(
+			std::memory_order_acquire)[i % NODES_PER_CHUNK];
+	}
+
+	/** Appends a new child to a node. Returns NO_NODE if the tree is full. */
+	uint32_t addNode(trace_scope_id_t id, uint32_t parent)
+	{
+		const uint32_t i = nNodes.load(std::memory_order_relaxed);
+		const uint32_t c = i / NODES_PER_CHUNK;
+		if (c >= MAX_NODE_CHUNKS) return NO_NODE;
+		if (i % NODES_PER_CHUNK == 0)
+		{
+			chunksStorage.emplace_back(new TNode[NODES_PER_CHUNK]);
+			chunks[c].store(
+				chunksStorage.back().get(), std::memory_order_release);
+		}
+		TNode& n = node(i);
+		n.id = id;
+		n.parent = parent;
+		nNodes.store(i + 1, std::memory_order_release);
+		if (parent != NO_NODE)
+		{
+			// Publish it:
+			TNode& p = node(parent);
+			n.nextSibling.store(
+				p.firstChild.load(std::memory_order_relaxed),
+				std::memory_order_relaxed);
+			p.firstChild.store(i, std::memory_order_release);
+		}
+		return i;
+	}
+
+	uint32_t findOrAddChild(uint32_t parent, trace_scope_id_t id)
+	{
+		for (uint32_t c = node(parent).firstChild.load(
+				 std::memory_order_relaxed);
+			 c != NO_NODE;
+			 c = node(c).nextSibling.load(std::memory_order_relaxed))
+			if (node(c).id == id) return c;
+		return addNode(id, parent);
+	}
+
+	void push(uint64_t t, trace_scope_id_t id, EventType type)
+	{
+		if (!capacity) return;
+		const uint64_t i = owner_load(nStarted);
+		// Readers check nStarted after copying the events, to discard those
+		// that might have been overwritten meanwhile:
+		owner_store(nStarted, i + 1);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		TEvent& e = events[i % capacity];
+		e.t_ns.store(t, std::memory_order_relaxed);
+		e.id.store(id, std::memory_order_relaxed);
+		e.type.store(type, std::memory_order_relaxed);
+		nWritten.store(i + 1, std::memory_order_release);
+	}
+
+	struct TEventCopy
+	{
+		uint64_t t_ns;
+		trace_scope_id_t id;
+		uint32_t type;
+	};
+
+	/** Copies the events in the ring buffer, from the oldest one */
+	std::vector<TEventCopy> copyEvents() const
+	{
+		std::vector<TEventCopy> out;
+		if (!capacity) return out;
+		const uint64_t end = nWritten.load(std::memory_order_acquire);
+		const uint64_t start = end > capacity ? end - capacity : 0;
+		out.reserve(end - start);
+		for (uint64_t i = start; i < end; i++)
+		{
+			const TEvent& e = events[i % capacity];
+			out.push_back(
+				{e.t_ns.load(std::memory_order_relaxed),
+				 e.id.load(std::memory_order_relaxed),
+				 e.type.load(std::memory_order_relaxed)});
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		// Discard the events that were overwritten while copying them:
+		const uint64_t nowStarted = nStarted.load(std::memory_order_relaxed);
+		const uint64_t firstValid =
+			nowStarted > capacity ? nowStarted - capacity : 0;
+		if (firstValid > start)
+			out.erase(
+				out.begin(),
+				out.begin() +
+					static_cast<std::ptrdiff_t>(
+						std::min(firstValid - start, uint64_t(out.size()))));
+		return out;
+	}
+
+	/** Closes the current node */
+	void closeCurrent(uint64_t t)
+	{
+		TNode& n = node(current);
+		const uint64_t dt = t - n.start_ns;
+		owner_store(n.n_calls, owner_load(n.n_calls) + 1);
+		owner_store(n.total_ns, owner_load(n.total_ns) + dt);
+		if (dt < owner_load(n.min_ns)) owner_store(n.min_ns, dt);
+		if (dt > owner_load(n.max_ns)) owner_store(n.max_ns, dt);
+		push(t, n.id, EV_LEAVE);
+		current = n.parent;
+	}
+};
+
+thread_local TThreadData* tlsThreadData = nullptr;
+
+std::string json_escape(const std::string& s)
+{
+	std::string r;
+	r.reserve(s.size());
+	for (const char c : s)
+	{
+		switch (c)
+		{
+			case '"': r += "\\\""; break;
+			case '\\': r += "\\\\"; break;
+			case '\n': r += "\\n"; break;
+			case '\t': r += "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+					r += mrpt::format("\\u%04x", static_cast<unsigned>(c));
+				else
+					r += c;
+		}
+	}
+	return r;
+}
+}  // namespace
+
+struct CTraceProfiler::Impl
+{
+	const std::chrono::steady_clock::time_point t0 =
+		std::chrono::steady_clock::now();
+
+	/** Protects all the variables below */
+	mutable std::mutex mtx;
+	std::vector<std::string> names;
+	std::unordered_map<std::string, trace_scope_id_t> nameToId;
+	/** Never freed, so threads can use their data without any lock, and the
+	 * data of finished threads is kept. */
+	std::vector<std::unique_ptr<TThreadData>> threads;
+	std::size_t ringSize = 32768;
+
+	/** File to save the trace to, from MRPT_TRACE_PROFILER_FILE */
+	std::string saveAtExitFile;
+
+	uint64_t now_ns() const
+	{
+		return static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - t0)
+				.count());
+	}
+
+	TThreadData* threadData() noexcept
+	{
+		if (tlsThreadData) return tlsThreadData;
+		try
+		{
+			std::lock_guard<std::mutex> lck(mtx);
+			auto td = std::make_unique<TThreadData>(ringSize);
+			td->index = static_cast<uint32_t>(threads.size() + 1);
+			td->name = mrpt::system::thread_name();
+			tlsThreadData = td.get();
+			threads.emplace_back(std::move(td));
+		}
+		catch (...)
+		{
+			return nullptr;
+		}
+		return tlsThreadData;
+	}
+
+	std::string name(trace_scope_id_t id) const
+	{
+		return id < names.size() ? names[id] : std::string();
+	}
+
+	/** Builds the call tree of node "n", with the mutex locked */
+	void buildTree(
+		const TThreadData& td, uint32_t n, TCallTreeNode& out) const
+	{
+		const TNode& nd = td.node(n);
+		if (nd.parent != NO_NODE) out.name = name(nd.id);
+		out.n_calls = nd.n_calls.load(std::memory_order_relaxed);
+		out.total_t = 1e-9 * nd.total_ns.load(std::memory_order_relaxed);
+		out.min_t = out.n_calls
+			? 1e-9 * nd.min_ns.load(std::memory_order_relaxed)
+			: 0;
+		out.max_t = 1e-9 * nd.max_ns.load(std::memory_order_relaxed);
+
+		for (uint32_t c = nd.firstChild.load(std::memory_order_acquire);
+			 c != NO_NODE;
+			 c = td.node(c).nextSibling.load(std::memory_order_acquire))
+		{
+			TCallTreeNode child;
+			buildTree(td, c, child);
+			// Skip those never finished, nor with any finished child:
+			if (child.n_calls || !child.children.empty())
+				out.children.emplace_back(std::move(child));
+		}
+		// Children are stored in reverse order:
+		std::reverse(out.children.begin(), out.children.end());
+	}
+};
+
+CTraceProfiler& CTraceProfiler::Instance()
+{
+	// Never destroyed, since CTimeLogger may forward calls to it from the
+	// destructors of other static objects:
+	static CTraceProfiler* tp = new CTraceProfiler();
+	return *tp;
+}
+
+CTraceProfiler::CTraceProfiler() : m_impl(spimpl::make_unique_impl<Impl>())
+{
+	m_impl->saveAtExitFile =
+		mrpt::get_env<std::string>("MRPT_TRACE_PROFILER_FILE");
+	if (m_impl->saveAtExitFile.empty()) return;
+
+	enable();
+	std::atexit([]() {
+		try
+		{
+			const auto& tp = CTraceProfiler::Instance();
+			tp.saveChromeTrace(tp.m_impl->saveAtExitFile);
+		}
+		catch (...)
+		{
+		}
+	});
+}
+
+CTraceProfiler::~CTraceProfiler() = default;
+
+namespace
+{
+// isEnabled() does not create the instance, so create it on start up if it
+// has to be enabled from the environment:
+[[maybe_unused]] const bool traceProfilerEnvInit = []() {
+	if (!mrpt::get_env<std::string>("MRPT_TRACE_PROFILER_FILE").empty())
+		CTraceProfiler::Instance();
+	return true;
+}();
+}  // namespace
+
+trace_scope_id_t CTraceProfiler::internScope(const std::string_view& name)
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	const std::string s(name);
+	if (auto it = m_impl->nameToId.find(s); it != m_impl->nameToId.end())
+		return it->second;
+	const auto id = static_cast<trace_scope_id_t>(m_impl->names.size());
+	m_impl->names.push_back(s);
+	m_impl->nameToId[s] = id;
+	return id;
+}
+
+trace_scope_id_t CTraceProfiler::internScopeCached(
+	const std::string_view& name)
+{
+	struct TCached
+	{
+		std::string name;
+		trace_scope_id_t id;
+	};
+	// The same address may be reused for different strings, hence the name
+	// is also stored and checked:
+	thread_local std::unordered_map<const char*, TCached> cache;
+
+	if (auto it = cache.find(name.data());
+		it != cache.end() && it->second.name == name)
+		return it->second.id;
+
+	const trace_scope_id_t id = internScope(name);
+	// Names built at run time may have ever-changing addresses:
+	if (cache.size() > 4096) cache.clear();
+	cache[name.data()] = {std::string(name), id};
+	return id;
+}
+
+std::string CTraceProfiler::getScopeName(trace_scope_id_t id) const
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	return m_impl->name(id);
+}
+
+void CTraceProfiler::enter(trace_scope_id_t id) noexcept
+{
+	if (!isEnabled()) return;
+	TThreadData* td = m_impl->threadData();
+	if (!td) return;
+
+	if (!td->untrackedDepth)
+	{
+		const uint32_t n = td->findOrAddChild(td->current, id);
+		if (n != NO_NODE) td->current = n;
+		else
+			td->untrackedDepth = 1;	 // The tree is full
+	}
+	else
+		td->untrackedDepth++;
+
+	const uint64_t t = m_impl->now_ns();
+	if (!td->untrackedDepth) td->node(td->current).start_ns = t;
+	td->push(t, id, EV_ENTER);
+}
+
+void CTraceProfiler::leave(trace_scope_id_t id) noexcept
+{
+	const uint64_t t = m_impl->now_ns();
+	// Note: leave() must be processed even if the profiler was disabled
+	// after enter().
+	TThreadData* td = tlsThreadData;
+	if (!td) return;
+
+	if (td->untrackedDepth)
+	{
+		td->untrackedDepth--;
+		td->push(t, id, EV_LEAVE);
+		return;
+	}
+
+	// Find the open scope to close, normally the current one:
+	uint32_t n = td->current;
+	while (n != 0 && td->node(n).id != id)
+		n = td->node(n).parent;
+	if (n == 0) return;	 // Not open
+
+	// Close it, and any inner scope still open:
+	const uint32_t parent = td->node(n).parent;
+	while (td->current != parent)
+		td->closeCurrent(t);
+}
+
+void CTraceProfiler::setRingBufferSize(std::size_t numEvents)
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	m_impl->ringSize = numEvents;
+}
+
+std::size_t CTraceProfiler::getRingBufferSize() const
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	return m_impl->ringSize;
+}
+
+double CTraceProfiler::TCallTreeNode::self_t() const
+{
+	double t = total_t;
+	for (const auto& c : children)
+		t -= c.total_t;
+	return std::max(0.0, t);
+}
+
+std::vector<CTraceProfiler::TThreadCallTree> CTraceProfiler::getCallTrees()
+	const
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	std::vector<TThreadCallTree> trees;
+	for (const auto& td : m_impl->threads)
+	{
+		auto& tree = trees.emplace_back();
+		tree.thread_name = td->name;
+		tree.thread_index = td->index;
+		m_impl->buildTree(*td, 0, tree.root);
+	}
+	return trees;
+}
+
+namespace
+{
+std::string thread_label(const CTraceProfiler::TThreadCallTree& tree)
+{
+	return tree.thread_name.empty()
+		? mrpt::format("thread-%u", static_cast<unsigned>(tree.thread_index))
+		: tree.thread_name;
+}
+
+void call_tree_as_text(
+	const CTraceProfiler::TCallTreeNode& n, int depth, std::string& s)
+{
+	for (const auto& c : n.children)
+	{
+		std::string label(2 * depth, ' ');
+		if (depth) label += "+-> ";
+		label += c.name;
+		s += mrpt::format(
+			"%-39s %8u %7ss %7ss %7ss %7ss %7ss\n",
+			mrpt::system::rightPad(label, 39, true).c_str(),
+			static_cast<unsigned>(c.n_calls),
+			unitsFormat(c.min_t, 1, false).c_str(),
+			unitsFormat(c.mean_t(), 1, false).c_str(),
+			unitsFormat(c.max_t, 1, false).c_str(),
+			unitsFormat(c.total_t, 1, false).c_str(),
+			unitsFormat(c.self_t(), 1, false).c_str());
+		call_tree_as_text(c, depth + 1, s);
+	}
+}
+
+void folded_stacks(
+	const CTraceProfiler::TCallTreeNode& n, const std::string& path,
+	std::string& s)
+{
+	for (const auto& c : n.children)
+	{
+		// ";" separates stack frames:
+		std::string name = c.name;
+		std::replace(name.begin(), name.end(), ';', ':');
+		const std::string p = path + ";" + name;
+
+		const auto us = static_cast<uint64_t>(c.self_t() * 1e6 + 0.5);
+		if (us) s += mrpt::format("%s %lu\n", p.c_str(), (unsigned long)us);
+		folded_stacks(c, p, s);
+	}
+}
+}  // namespace
+
+std::string CTraceProfiler::getCallTreesAsText() const
+{
+	std::string s;
+	for (const auto& tree : getCallTrees())
+	{
+		if (tree.root.children.empty()) continue;
+		s += mrpt::format(
+			"Thread #%u `%s`:\n", static_cast<unsigned>(tree.thread_index),
+			thread_label(tree).c_str());
+		s += mrpt::format(
+			"%-39s %8s %8s %8s %8s %8s %8s\n", "SCOPE", "#CALLS", "MIN.T",
+			"MEAN.T", "MAX.T", "TOTAL", "SELF");
+		call_tree_as_text(tree.root, 0, s);
+	}
+	return s;
+}
+
+std::string CTraceProfiler::getFoldedStacks() const
+{
+	std::string s;
+	for (const auto& tree : getCallTrees())
+	{
+		std::string label = thread_label(tree);
+		std::replace(label.begin(), label.end(), ';', ':');
+		folded_stacks(tree.root, label, s);
+	}
+	return s;
+}
+
+std::string CTraceProfiler::getChromeTrace() const
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+
+	std::string s = "{\"traceEvents\":[\n";
+	bool first = true;
+	const auto newEvent = [&]() {
+		if (!first) s += ",\n";
+		first = false;
+	};
+
+	for (const auto& td : m_impl->threads)
+	{
+		newEvent();
+		s += mrpt::format(
+			"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+			"\"args\":{\"name\":\"%s\"}}",
+			static_cast<unsigned>(td->index),
+			json_escape(
+				td->name.empty() ? mrpt::format("thread-%u", td->index)
+								 : td->name)
+				.c_str());
+
+		// The oldest events in the buffer may be the end of scopes whose
+		// start was overwritten: skip them.
+		unsigned int depth = 0;
+		for (const auto& e : td->copyEvents())
+		{
+			if (e.type == EV_ENTER) depth++;
+			else if (depth == 0)
+				continue;
+			else
+				depth--;
+
+			newEvent();
+			s += mrpt::format(
+				"{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,"
+				"\"tid\":%u}",
+				json_escape(m_impl->name(e.id)).c_str(),
+				e.type == EV_ENTER ? 'B' : 'E', 1e-3 * e.t_ns,
+				static_cast<unsigned>(td->index));
+		}
+	}
+	s += "\n],\"displayTimeUnit\":\"ns\"}\n";
+	return s;
+}
+
+bool CTraceProfiler::saveChromeTrace(const std::string& file) const
+{
+	std::ofstream f(file);
+	if (!f.is_open()) return false;
+	f << getChromeTrace();
+	return f.good();
+}
+
+void CTraceProfiler::clear()
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	for (auto& td : m_impl->threads)
+	{
+		td->nStarted = 0;
+		td->nWritten = 0;
+		const uint32_t nNodes = td->nNodes.load();
+		for (uint32_t i = 0; i < nNodes; i++)
+			td->node(i).resetStats();
+	}
+}
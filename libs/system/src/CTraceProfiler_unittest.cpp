@@ -0,0 +1,253 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/system/CTimeLogger.h>
+#include <mrpt/system/CTraceProfiler.h>
+#include <mrpt/system/thread_name.h>
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+using mrpt::system::CTraceProfiler;
+
+namespace
+{
+// Runs f() in a new thread with the given name (max. 15 chars in Linux), so
+// each test gets its own call tree.
+void runInThread(const std::string& name, const std::function<void()>& f)
+{
+	std::thread t([&]() {
+		mrpt::system::thread_name(name);
+		f();
+	});
+	t.join();
+}
+
+CTraceProfiler::TCallTreeNode treeOfThread(const std::string& name)
+{
+	for (const auto& t : CTraceProfiler::Instance().getCallTrees())
+		if (t.thread_name == name) return t.root;
+	return {};
+}
+
+// Number of occurrences of a substring:
+size_t count(const std::string& s, const std::string& what)
+{
+	size_t n = 0;
+	for (auto p = s.find(what); p != std::string::npos;
+		 p = s.find(what, p + 1))
+		n++;
+	return n;
+}
+
+void leaf()
+{
+	MRPT_TRACE_SCOPE("leaf");
+	std::this_thread::sleep_for(std::chrono::microseconds(100));
+}
+
+void inner(int n)
+{
+	MRPT_TRACE_SCOPE("inner");
+	for (int i = 0; i < n; i++)
+		leaf();
+}
+}  // namespace
+
+TEST(CTraceProfiler, callTree)
+{
+	auto& tp = CTraceProfiler::Instance();
+	tp.enable();
+
+	runInThread("trace-tree", []() {
+		for (int i = 0; i < 3; i++)
+		{
+			MRPT_TRACE_SCOPE("outer");
+			inner(2);
+		}
+		leaf();
+	});
+	tp.disable();
+
+	const auto root = treeOfThread("trace-tree");
+	ASSERT_EQ(root.children.size(), 2U);
+
+	const auto& outer = root.children[0];
+	EXPECT_EQ(outer.name, "outer");
+	EXPECT_EQ(outer.n_calls, 3U);
+	ASSERT_EQ(outer.children.size(), 1U);
+	const auto& in = outer.children[0];
+	EXPECT_EQ(in.name, "inner");
+	EXPECT_EQ(in.n_calls, 3U);
+	ASSERT_EQ(in.children.size(), 1U);
+	EXPECT_EQ(in.children[0].n_calls, 6U);
+	EXPECT_GT(in.children[0].min_t, 50e-6);
+	EXPECT_GE(outer.total_t, in.total_t);
+	EXPECT_GE(in.total_t, in.children[0].total_t);
+
+	// The same scope, from another parent, is another node:
+	EXPECT_EQ(root.children[1].name, "leaf");
+	EXPECT_EQ(root.children[1].n_calls, 1U);
+
+	const std::string folded = tp.getFoldedStacks();
+	EXPECT_NE(folded.find("trace-tree;outer;inner;leaf "), std::string::npos);
+	EXPECT_NE(folded.find("trace-tree;leaf "), std::string::npos);
+
+	tp.clear();
+}
+
+TEST(CTraceProfiler, chromeTrace)
+{
+	auto& tp = CTraceProfiler::Instance();
+	tp.clear();
+	const auto savedRingSize = tp.getRingBufferSize();
+	tp.enable();
+
+	// A ring buffer too small for all the events: the oldest ones are lost,
+	// but the trace must remain consistent.
+	tp.setRingBufferSize(25);
+	runInThread("trace-chrome", []() { inner(20); });
+	tp.setRingBufferSize(savedRingSize);
+	tp.disable();
+
+	const std::string json = tp.getChromeTrace();
+	EXPECT_EQ(json.find("{\"traceEvents\":["), 0U);
+	EXPECT_NE(
+		json.find("\"args\":{\"name\":\"trace-chrome\"}"),
+		std::string::npos);
+	EXPECT_EQ(count(json, "\"ph\":\"B\""), count(json, "\"ph\":\"E\""));
+	EXPECT_LE(count(json, "\"name\":\"leaf\""), 25U);
+	EXPECT_GE(count(json, "\"name\":\"leaf\""), 20U);
+
+	// Stats are not affected by the ring buffer size:
+	const auto root = treeOfThread("trace-chrome");
+	ASSERT_EQ(root.children.size(), 1U);
+	ASSERT_EQ(root.children[0].children.size(), 1U);
+	EXPECT_EQ(root.children[0].children[0].n_calls, 20U);
+
+	tp.clear();
+}
+
+TEST(CTraceProfiler, fromCTimeLogger)
+{
+	auto& tp = CTraceProfiler::Instance();
+	tp.enable();
+
+	runInThread("trace-tlogger", []() {
+		// Even if the CTimeLogger itself is disabled:
+		mrpt::system::CTimeLogger tl(false);
+		for (int i = 0; i < 4; i++)
+		{
+			mrpt::system::CTimeLoggerEntry tle(tl, "section");
+			tl.enter("subsection");
+			tl.leave("subsection");
+		}
+		EXPECT_EQ(tl.getMeanTime("section"), 0);
+	});
+	tp.disable();
+
+	const auto root = treeOfThread("trace-tlogger");
+	ASSERT_EQ(root.children.size(), 1U);
+	EXPECT_EQ(root.children[0].name, "section");
+	EXPECT_EQ(root.children[0].n_calls, 4U);
+	ASSERT_EQ(root.children[0].children.size(), 1U);
+	EXPECT_EQ(root.children[0].children[0].name, "subsection");
+	EXPECT_EQ(root.children[0].children[0].n_calls, 4U);
+
+	tp.clear();
+}
+
+TEST(CTraceProfiler, disableWithinCTimeLoggerSection)
+{
+	auto& tp = CTraceProfiler::Instance();
+	tp.enable();
+
+	runInThread("trace-tl-dis", [&]() {
+		mrpt::system::CTimeLogger tl(false);
+		tl.enter("a");
+		tp.disable();
+		tl.leave("a");	// Must close "a" anyway
+		tp.enable();
+		tl.enter("b");
+		tl.leave("b");
+	});
+	tp.disable();
+
+	// "b" must not be nested in "a":
+	const auto root = treeOfThread("trace-tl-dis");
+	ASSERT_EQ(root.children.size(), 2U);
+	EXPECT_EQ(root.children[0].name, "a");
+	EXPECT_EQ(root.children[1].name, "b");
+	EXPECT_TRUE(root.children[0].children.empty());
+
+	tp.clear();
+}
+
+TEST(CTraceProfiler, unbalancedLeave)
+{
+	auto& tp = CTraceProfiler::Instance();
+	tp.enable();
+
+	runInThread("trace-unbal", [&]() {
+		const auto a = tp.internScope("a"), b = tp.internScope("b");
+		tp.leave(a);  // Not open: ignored
+		tp.enter(a);
+		tp.enter(b);
+		tp.leave(a);  // Closes "b" too
+	});
+	tp.disable();
+
+	const auto root = treeOfThread("trace-unbal");
+	ASSERT_EQ(root.children.size(), 1U);
+	EXPECT_EQ(root.children[0].n_calls, 1U);
+	ASSERT_EQ(root.children[0].children.size(), 1U);
+	EXPECT_EQ(root.children[0].children[0].n_calls, 1U);
+
+	tp.clear();
+}
+
+TEST(CTraceProfiler, readWhileRecording)
+{
+	auto& tp = CTraceProfiler::Instance();
+	const auto savedRingSize = tp.getRingBufferSize();
+	tp.setRingBufferSize(64);
+	tp.enable();
+
+	std::atomic_bool done{false};
+	std::thread t([&]() {
+		mrpt::system::thread_name("trace-rw");
+		for (int i = 0; i < 20000; i++)
+		{
+			MRPT_TRACE_SCOPE("rw.outer");
+			MRPT_TRACE_SCOPE("rw.inner");
+		}
+		done = true;
+	});
+	while (!done)
+	{
+		// No orphan "E" events. At most, the 2 scopes may be still open:
+		const std::string json = tp.getChromeTrace();
+		const size_t nB = count(json, "\"ph\":\"B\""),
+					 nE = count(json, "\"ph\":\"E\"");
+		EXPECT_GE(nB, nE);
+		EXPECT_LE(nB, nE + 2);
+		tp.getCallTrees();
+	}
+	t.join();
+	tp.disable();
+	tp.setRingBufferSize(savedRingSize);
+
+	const auto root = treeOfThread("trace-rw");
+	ASSERT_EQ(root.children.size(), 1U);
+	EXPECT_EQ(root.children[0].n_calls, 20000U);
+
+	tp.clear();
+}
@@ -17,12 +17,14 @@ MRPT_WARNING(
 	"warning)")
 #endif
 
+#include <mrpt/vision/CBoWDatabase.h>
 #include <mrpt/vision/CDifodo.h>
 #include <mrpt/vision/CFeatureExtraction.h>
 #include <mrpt/vision/CImagePyramid.h>
 #include <mrpt/vision/CStereoRectifyMap.h>
 #include <mrpt/vision/CUndistortMap.h>
 #include <mrpt/vision/CVideoFileWriter.h>
+#include <mrpt/vision/CVisualVocabulary.h>
 #include <mrpt/vision/TKeyPoint.h>
 #include <mrpt/vision/chessboard_camera_calib.h>
 #include <mrpt/vision/chessboard_find_corners.h>
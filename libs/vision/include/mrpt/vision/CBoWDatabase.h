@@ -0,0 +1,86 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/serialization/CSerializable.h>
+#include <mrpt/vision/types.h>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace mrpt::vision
+{
+/** \addtogroup  mrptvision_features
+	@{ */
+
+/** A database of images represented as bag-of-words vectors, with an
+ * inverted file (for each visual word, the list of images with that word)
+ * for fast retrieval of the most similar images to a query.
+ *
+ * Similarity is the L1 score by Nister and Stewenius:
+ * `s(v,w) = 1 - 0.5*|v-w|_1` for L1-normalized vectors, in the range [0,1]
+ * (1: identical). Only the words shared by the query and each image are
+ * visited.
+ *
+ * \sa CVisualVocabulary
+ * \note (New in MRPT 2.4.3)
+ */
+class CBoWDatabase : public mrpt::serialization::CSerializable
+{
+	DEFINE_SERIALIZABLE(CBoWDatabase, mrpt::vision)
+
+   public:
+	using image_id_t = uint32_t;
+
+	CBoWDatabase() = default;
+
+	/** Adds an image, returning its ID (consecutive numbers from 0). */
+	image_id_t add(const TBagOfWords& bow);
+
+	std::size_t size() const { return m_imageCount; }
+	bool empty() const { return m_imageCount == 0; }
+	void clear();
+
+	struct TResult
+	{
+		TResult() = default;
+		TResult(image_id_t id, double s) : image(id), score(s) {}
+
+		image_id_t image = 0;
+		double score = 0;  //!< Similarity in [0,1]
+	};
+
+	/** Returns the (up to) `maxResults` images most similar to the query, by
+	 * descending score. Images sharing no word with the query are never
+	 * reported.
+	 * \param maxImageID If given, only images with ID <= this value are
+	 * considered (e.g. to ignore the most recent keyframes).
+	 */
+	void query(
+		const TBagOfWords& bow, std::size_t maxResults,
+		std::vector<TResult>& results,
+		image_id_t maxImageID = std::numeric_limits<image_id_t>::max()) const;
+
+   private:
+	struct TEntry
+	{
+		TEntry() = default;
+		TEntry(image_id_t i, float w) : image(i), weight(w) {}
+
+		image_id_t image = 0;
+		float weight = 0;
+	};
+	/** For each word: images containing it, by increasing image ID */
+	std::vector<std::vector<TEntry>> m_invertedFile;
+	uint32_t m_imageCount = 0;
+};
+
+/** @} */
+}  // namespace mrpt::vision
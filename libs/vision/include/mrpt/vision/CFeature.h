@@ -13,6 +13,7 @@
 #include <mrpt/math/CMatrixF.h>
 #include <mrpt/math/KDTreeCapable.h>
 #include <mrpt/vision/TKeyPoint.h>
+#include <mrpt/vision/binary_descriptors.h>
 #include <mrpt/vision/types.h>
 
 #include <optional>
@@ -157,6 +158,13 @@ class CFeature : public mrpt::serialization::CSerializable
 
 	TDescriptors descriptors;
 
+	/** Returns the binary descriptor of the given type (descORB, descBLD or
+	 * descLATCH). Throws if the feature has no such descriptor.
+	 * \note (New in MRPT 2.4.3)
+	 */
+	const std::vector<uint8_t>& getBinaryDescriptor(
+		TDescriptorType descriptor) const;
+
 	/** Return the first found descriptor, as a matrix.
 	 * \return false on error, i.e. there is no valid descriptor.
 	 */
@@ -281,6 +289,10 @@ class CFeatureList : public mrpt::math::KDTreeCapable<CFeatureList>
 	/** The actual container with the list of features */
 	TInternalFeatList m_feats;
 
+	/** Optional contiguous copy of binary descriptors.
+	 * \sa buildDescriptorMatrix() */
+	TBinaryDescriptorMatrix m_descMatrix;
+
    public:
 	/** The type of the first feature in the list */
 	inline TKeyPointMethod get_type() const
@@ -327,6 +339,42 @@ class CFeatureList : public mrpt::math::KDTreeCapable<CFeatureList>
 	/** Call this when the list of features has been modified so the KD-tree is
 	 * marked as outdated. */
 	inline void mark_kdtree_as_outdated() const { kdtree_mark_as_outdated(); }
+
+	/** @name Contiguous storage of binary descriptors
+		@{ */
+
+	/** Packs the binary descriptors of the given type (descORB, descBLD or
+	 * descLATCH) of all features into one contiguous, row-major matrix, for
+	 * use with the fast matching functions in
+	 * mrpt/vision/binary_descriptors.h and by matchFeatures().
+	 *
+	 * All features must have a descriptor of that type, with the same length.
+	 * The matrix is discarded when features are added or removed, and must be
+	 * rebuilt by the user if descriptors are modified in place.
+	 * \sa descriptorMatrix(), match_binary_descriptors()
+	 * \note (New in MRPT 2.4.3)
+	 */
+	void buildDescriptorMatrix(TDescriptorType descriptor = descORB);
+
+	/** Returns true if buildDescriptorMatrix() was called for that descriptor
+	 * type and the matrix is still in sync with the list size. */
+	bool hasDescriptorMatrix(TDescriptorType descriptor = descORB) const
+	{
+		return !m_descMatrix.empty() && m_descMatrix.type == descriptor &&
+			m_descMatrix.rows() == m_feats.size();
+	}
+
+	/** The matrix built by buildDescriptorMatrix() (empty if none) */
+	const TBinaryDescriptorMatrix& descriptorMatrix() const
+	{
+		return m_descMatrix;
+	}
+
+	/** Frees the memory of the descriptor matrix, if any */
+	void clearDescriptorMatrix() { m_descMatrix.clear(); }
+
+	/** @} */
+
 	/** @name Method and datatypes to emulate a STL container
 		@{ */
 	using iterator = TInternalFeatList::iterator;
@@ -346,6 +394,7 @@ class CFeatureList : public mrpt::math::KDTreeCapable<CFeatureList>
 	inline iterator erase(const iterator& it)
 	{
 		mark_kdtree_as_outdated();
+		m_descMatrix.clear();
 		return m_feats.erase(it);
 	}
 
@@ -354,22 +403,26 @@ class CFeatureList : public mrpt::math::KDTreeCapable<CFeatureList>
 	inline void clear()
 	{
 		m_feats.clear();
+		m_descMatrix.clear();
 		mark_kdtree_as_outdated();
 	}
 	inline void resize(size_t N)
 	{
 		m_feats.resize(N);
+		m_descMatrix.clear();
 		mark_kdtree_as_outdated();
 	}
 
 	inline void emplace_back(CFeature&& f)
 	{
 		mark_kdtree_as_outdated();
+		m_descMatrix.clear();
 		m_feats.emplace_back(std::move(f));
 	}
 	inline void push_back(const CFeature& f)
 	{
 		mark_kdtree_as_outdated();
+		m_descMatrix.clear();
 		m_feats.push_back(f);
 	}
 
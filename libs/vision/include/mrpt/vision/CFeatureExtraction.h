@@ -286,6 +286,33 @@ class CFeatureExtraction
 			bool rotationInvariance{true};
 			int half_ssd_size{3};
 		} LATCHOptions;
+
+		/** Tiled detection options. If grid_cols*grid_rows>1, detectFeatures()
+		 * splits the image into a grid of cells, runs the detector on each
+		 * cell in parallel with its own feature budget, and merges the
+		 * results. This gives a more uniform spatial distribution of
+		 * features, and scales with the number of cores.
+		 * Not applicable to featLSD (lines), which always uses the whole
+		 * image. \note (New in MRPT 2.4.3)
+		 */
+		struct TTilingOptions
+		{
+			/** Number of grid cells in each direction (default=1: no tiling)
+			 */
+			unsigned int grid_cols{1}, grid_rows{1};
+			/** Max number of features per cell. Default (0): the
+			 * `nDesiredFeatures` argument of detectFeatures() divided by the
+			 * number of cells, or no limit if that is also 0. */
+			unsigned int max_features_per_cell{0};
+			/** Extra pixels around each cell passed to the detector, so
+			 * keypoints near cell boundaries get the same response, patch and
+			 * descriptors as with the whole image. It is always enlarged to
+			 * at least `patchSize/2+1`. Default=32 (enough for ORB). */
+			unsigned int border{32};
+			/** Maximum number of cells detected in parallel, by the shared
+			 * mrpt::TaskScheduler::Instance() (default=0: no limit) */
+			unsigned int num_threads{0};
+		} tilingOptions;
 	};
 
 	/** Set all the parameters of the desired method here before calling
@@ -299,6 +326,10 @@ class CFeatureExtraction
 	 * nDesiredFeatures (op. input) Number of features to be extracted.
 	 * Default: all possible.
 	 *
+	 * If enabled in TOptions::tilingOptions, the image is processed as a
+	 * grid of cells in parallel (use a CImagePyramid level as input for
+	 * multi-scale tiled detection).
+	 *
 	 * \sa computeDescriptors
 	 */
 	void detectFeatures(
@@ -514,5 +545,11 @@ class CFeatureExtraction
 		unsigned int init_ID, unsigned int nDesiredFeatures,
 		const TImageROI& ROI = TImageROI());
 
+	/** Implementation of detectFeatures() for TOptions::tilingOptions. */
+	void detectFeaturesTiled(
+		const mrpt::img::CImage& img, CFeatureList& feats,
+		unsigned int init_ID, unsigned int nDesiredFeatures,
+		const TImageROI& ROI);
+
 };	// end of class
 }  // namespace mrpt::vision
@@ -171,6 +171,26 @@ class CStereoRectifyMap
 		return m_interpolation_method;
 	}
 
+	/** If enabled (default=false), rectify() uses MRPT's own remap kernels
+	 * instead of OpenCV's `cv::remap()`: the output rows of both images are
+	 * split among up to \a num_threads parallel tasks (0=automatic), and an
+	 * AVX2 version is used for grayscale images if the CPU supports it.
+	 * Output pixels are bilinear interpolations with 1/32 pixel resolution
+	 * (like `cv::remap()` with these maps), rounded to the nearest integer.
+	 * It is only used for 8-bit, 1 or 3 channel images with IMG_INTERP_LINEAR
+	 * or IMG_INTERP_NN interpolation; `cv::remap()` is used otherwise.
+	 * This parameter can be safely changed at any instant.
+	 * \note (New in MRPT 2.4.3)
+	 */
+	void enableInternalRemap(bool enable = true, unsigned int num_threads = 0)
+	{
+		m_internal_remap = enable;
+		m_internal_remap_threads = num_threads;
+	}
+
+	/** \sa enableInternalRemap */
+	bool isEnabledInternalRemap() const { return m_internal_remap; }
+
 	/** If enabled (default=false), the principal points in both output images
 	 * will coincide.
 	 * \note Call this method before building the rectification maps, otherwise
@@ -262,6 +282,8 @@ class CStereoRectifyMap
 	mrpt::img::TImageSize m_resize_output_value{0, 0};
 	mrpt::img::TInterpolationMethod m_interpolation_method{
 		mrpt::img::IMG_INTERP_LINEAR};
+	bool m_internal_remap{false};
+	unsigned int m_internal_remap_threads{0};
 
 	std::vector<int16_t> m_dat_mapx_left, m_dat_mapx_right;
 	std::vector<uint16_t> m_dat_mapy_left, m_dat_mapy_right;
@@ -65,6 +65,22 @@ class CUndistortMap
 	 */
 	void undistort(mrpt::img::CImage& in_out_img) const;
 
+	/** If enabled (default=false), undistort() uses MRPT's own remap kernels
+	 * instead of OpenCV's `cv::remap()`, splitting the image rows among up
+	 * to \a num_threads parallel tasks (0=automatic), with an AVX2 version for
+	 * grayscale images. Only used for 8-bit, 1 or 3 channel images.
+	 * \sa CStereoRectifyMap::enableInternalRemap()
+	 * \note (New in MRPT 2.4.3)
+	 */
+	void enableInternalRemap(bool enable = true, unsigned int num_threads = 0)
+	{
+		m_internal_remap = enable;
+		m_internal_remap_threads = num_threads;
+	}
+
+	/** \sa enableInternalRemap */
+	bool isEnabledInternalRemap() const { return m_internal_remap; }
+
 	/** Returns the camera parameters which were used to generate the distortion
 	 * map, as passed by the user to \a setFromCamParams */
 	inline const mrpt::img::TCamera& getCameraParams() const
@@ -86,5 +102,13 @@ class CUndistortMap
 	/** A copy of the data provided by the user */
 	mrpt::img::TCamera m_camera_params;
 
+	bool m_internal_remap{false};
+	unsigned int m_internal_remap_threads{0};
+
+	/** Undistorts with MRPT's remap, if enabled and the image format is
+	 * supported. \return false if not done. */
+	bool internal_remap(
+		const mrpt::img::CImage& in_img, mrpt::img::CImage& out_img) const;
+
 };	// end class
 }  // namespace mrpt::vision
@@ -0,0 +1,131 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/serialization/CSerializable.h>
+#include <mrpt/vision/CFeature.h>
+#include <mrpt/vision/types.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace mrpt::vision
+{
+/** \addtogroup  mrptvision_features
+	@{ */
+
+/** A visual vocabulary tree (D. Nister and H. Stewenius, "Scalable
+ * Recognition with a Vocabulary Tree", CVPR 2006) for binary descriptors
+ * (ORB, BLD, LATCH).
+ *
+ * The vocabulary is a tree with `branching` children per node and up to
+ * `levels` levels, built by hierarchical k-majority clustering (k-means for
+ * Hamming space) of training descriptors. Its leaves are the visual words.
+ * Each word has an inverse document frequency (IDF) weight,
+ * `log(N/N_i)`, with N the number of training images and N_i those images
+ * with at least one descriptor in that word.
+ *
+ * Images (CFeatureList) are converted into TF-IDF weighted bag-of-words
+ * vectors with transform(), which can be stored and queried with
+ * CBoWDatabase, e.g. to retrieve candidate keyframes for loop closure.
+ *
+ * \code
+ *  CVisualVocabulary voc;
+ *  voc.train(training_images); // std::vector<CFeatureList>
+ *  CBoWDatabase db;
+ *  for (const auto& kf : keyframes) db.add(voc.transform(kf));
+ *  std::vector<CBoWDatabase::TResult> candidates;
+ *  db.query(voc.transform(current_feats), 10, candidates);
+ * \endcode
+ *
+ * \sa CBoWDatabase
+ * \note (New in MRPT 2.4.3)
+ */
+class CVisualVocabulary : public mrpt::serialization::CSerializable
+{
+	DEFINE_SERIALIZABLE(CVisualVocabulary, mrpt::vision)
+
+   public:
+	CVisualVocabulary() = default;
+
+	struct TTrainingParams
+	{
+		TTrainingParams() = default;
+
+		/** The binary descriptor to use: descORB, descBLD or descLATCH */
+		TDescriptorType descriptor = descORB;
+		/** Number of children per node ("k") */
+		uint32_t branching = 10;
+		/** Maximum depth of the tree ("L"): up to branching^levels words */
+		uint32_t levels = 5;
+		/** Maximum k-majority iterations per node */
+		uint32_t max_iterations = 10;
+		/** Seed for the k-means++ initialization */
+		uint32_t random_seed = 1234;
+	};
+
+	/** Builds the vocabulary from a set of training images, replacing any
+	 * previous contents. All features must have the selected descriptor. */
+	void train(
+		const std::vector<CFeatureList>& images, const TTrainingParams& params);
+
+	/// \overload With default parameters.
+	void train(const std::vector<CFeatureList>& images)
+	{
+		train(images, TTrainingParams());
+	}
+
+	bool empty() const { return m_words == 0; }
+	/** Number of visual words (leaves of the tree) */
+	std::size_t wordCount() const { return m_words; }
+	/** Length of the descriptors, in bytes */
+	std::size_t descriptorBytes() const { return m_descBytes; }
+	TDescriptorType descriptorType() const { return m_descriptor; }
+	/** The IDF weight of a given word */
+	float idf(TVisualWordID word) const { return m_idf.at(word); }
+
+	/** Finds the visual word of one descriptor, with `descriptorBytes()`
+	 * bytes, by descending the tree towards the closest node at each level.
+	 */
+	TVisualWordID quantize(const uint8_t* descriptor) const;
+
+	/** Converts a list of features into its TF-IDF weighted, L1-normalized,
+	 * bag-of-words vector. Words with zero IDF weight are dropped.
+	 * \param[out] out_words Optional: if not null, filled with the word of
+	 * each feature.
+	 */
+	void transform(
+		const CFeatureList& feats, TBagOfWords& out,
+		std::vector<TVisualWordID>* out_words = nullptr) const;
+
+	/// \overload
+	TBagOfWords transform(const CFeatureList& feats) const
+	{
+		TBagOfWords bow;
+		transform(feats, bow);
+		return bow;
+	}
+
+   private:
+	TDescriptorType m_descriptor = descORB;
+	uint32_t m_descBytes = 0;
+	uint32_t m_words = 0;
+
+	/** Tree nodes (node 0 is the root). The children of each node are
+	 * contiguous: [firstChild, firstChild+numChildren). For leaves,
+	 * numChildren=0 and "word" holds their visual word. */
+	std::vector<uint32_t> m_firstChild, m_numChildren, m_word;
+	/** Centroid of each node, `m_descBytes` bytes per node */
+	std::vector<uint8_t> m_centroids;
+	/** IDF weight of each word */
+	std::vector<float> m_idf;
+};
+
+/** @} */
+}  // namespace mrpt::vision
@@ -0,0 +1,138 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <mrpt/core/aligned_std_vector.h>
+#include <mrpt/vision/types.h>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace mrpt::vision
+{
+/** \addtogroup  mrptvision_features
+	@{ */
+
+/** Contiguous, row-major storage of binary descriptors (ORB, BLD, LATCH) for
+ * a set of features: row `i` holds the descriptor of the i-th feature.
+ *
+ * Rows are zero-padded up to a multiple of 32 bytes, so distance kernels can
+ * process whole 256-bit words without tail handling. Padding bytes are
+ * always zero, hence they do not alter Hamming distances.
+ *
+ * \sa CFeatureList::buildDescriptorMatrix(), match_binary_descriptors()
+ * \note (New in MRPT 2.4.3)
+ */
+class TBinaryDescriptorMatrix
+{
+   public:
+	/** Row strides are multiples of this number of bytes */
+	static constexpr std::size_t ROW_ALIGNMENT = 32;
+
+	TBinaryDescriptorMatrix() = default;
+
+	/** Resizes the matrix and sets all bytes (including padding) to zero */
+	void resize(std::size_t nRows, std::size_t bytesPerRow);
+	void clear();
+
+	std::size_t rows() const { return m_rows; }
+	/** Length of each descriptor, in bytes (without padding) */
+	std::size_t bytesPerRow() const { return m_bytesPerRow; }
+	/** Distance between the start of consecutive rows, in bytes */
+	std::size_t rowStride() const { return m_stride; }
+	bool empty() const { return m_rows == 0; }
+
+	/** The descriptor type stored in the matrix, or descAny if unknown */
+	TDescriptorType type{descAny};
+
+	uint8_t* row(std::size_t i) { return m_data.data() + i * m_stride; }
+	const uint8_t* row(std::size_t i) const
+	{
+		return m_data.data() + i * m_stride;
+	}
+	const uint8_t* data() const { return m_data.data(); }
+
+   private:
+	std::size_t m_rows = 0, m_bytesPerRow = 0, m_stride = 0;
+	mrpt::aligned_std_vector<uint8_t> m_data;
+};
+
+/** Hamming distance (number of different bits) between two binary
+ * descriptors of `nBytes` bytes each. */
+uint32_t hamming_distance(
+	const uint8_t* a, const uint8_t* b, std::size_t nBytes);
+
+/** Computes the Hamming distances between one `query` row and all the rows of
+ * `train`. Uses AVX2 instructions if supported by the CPU at runtime.
+ * \param[in] query Pointer to the query descriptor, which must be
+ * `train.rowStride()` bytes long (including zero padding).
+ * \param[out] out_distances Resized to `train.rows()`.
+ */
+void hamming_distances(
+	const uint8_t* query, const TBinaryDescriptorMatrix& train,
+	std::vector<uint32_t>& out_distances);
+
+/** Options for match_binary_descriptors() */
+struct TBinaryMatchingOptions
+{
+	/** Pairings with a Hamming distance above this value are discarded */
+	uint32_t max_distance = std::numeric_limits<uint32_t>::max();
+
+	/** Lowe's ratio test: a pairing is accepted only if its distance is below
+	 * `ratio * second_best_distance`. Set to 0 (default) to disable it. */
+	float ratio = 0;
+
+	/** If true, only keep pairings `i->j` such that `i` is also the best
+	 * match of `j` (mutual nearest neighbors). */
+	bool cross_check = false;
+
+	/** Maximum number of parallel tasks, run by the shared
+	 * mrpt::TaskScheduler::Instance(). 0 (default) means one per thread of
+	 * the scheduler; 1 runs serially in the calling thread. */
+	unsigned int num_threads = 0;
+};
+
+/** One pairing found by match_binary_descriptors() */
+struct TBinaryDescriptorMatch
+{
+	uint32_t query_idx = 0, train_idx = 0;
+	/** Hamming distance of the best and second-best candidates. The latter is
+	 * `std::numeric_limits<uint32_t>::max()` if there is only one train row. */
+	uint32_t distance = 0, second_distance = 0;
+};
+
+/** Brute-force matching of two sets of binary descriptors with Hamming
+ * distance, optional ratio test and optional cross check. Query rows are
+ * distributed among several threads.
+ *
+ * For each query descriptor, the best pairing (lowest distance, lowest train
+ * index in case of ties) is returned if it passes all the tests in `options`.
+ * The output is sorted by `query_idx`.
+ *
+ * \code
+ *  CFeatureList feats1, feats2; // with ORB descriptors
+ *  feats1.buildDescriptorMatrix(descORB);
+ *  feats2.buildDescriptorMatrix(descORB);
+ *  TBinaryMatchingOptions opts;
+ *  opts.ratio = 0.8f;
+ *  const auto matches = match_binary_descriptors(
+ *      feats1.descriptorMatrix(), feats2.descriptorMatrix(), opts);
+ * \endcode
+ *
+ * \sa TBinaryDescriptorMatrix, matchFeatures()
+ * \note (New in MRPT 2.4.3)
+ */
+std::vector<TBinaryDescriptorMatch> match_binary_descriptors(
+	const TBinaryDescriptorMatrix& query, const TBinaryDescriptorMatrix& train,
+	const TBinaryMatchingOptions& options = TBinaryMatchingOptions());
+
+/** @} */
+}  // namespace mrpt::vision
@@ -84,6 +84,8 @@ using TCalibrationImageList = std::map<std::string, TImageCalibData>;
  * >camera-calib-gui application</a> is a user-friendly GUI to this class.
  * \return false on any error (more info will be dumped to cout), or true on
  * success.
+ * \note Since MRPT 2.4.3, images are loaded and checkerboards detected in
+ * parallel, using all the hardware cores.
  * \sa CImage::findChessboardCorners, checkerBoardStereoCalibration
  */
 bool checkerBoardCameraCalibration(
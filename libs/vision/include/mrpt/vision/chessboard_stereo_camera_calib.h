@@ -68,6 +68,14 @@ struct TStereoCalibParams
 	/** Maximum number of iterations of the optimizer (default=300) */
 	size_t maxIters{2000};
 
+	/** Maximum number of parallel tasks for detecting the checkerboards in
+	 * the images and for evaluating the residuals & Jacobians of the
+	 * optimizer, run by the shared mrpt::TaskScheduler::Instance().
+	 * 0 (default) means no limit (one task per image or image pair).
+	 * \note (New in MRPT 2.4.3)
+	 */
+	unsigned int num_threads{0};
+
 	/** Select which distortion parameters (of both left/right cameras) will be
 	 * optimzed:
 	 *  k1,k2,k3 are the r^2, r^4 and r^6 radial distorion coeficients, and t1
@@ -144,6 +152,9 @@ using TCalibrationStereoImageList = std::vector<TImageStereoCalibData>;
  *  from a sequence of pairs of captured images of a checkerboard.
  *  A custom implementation of an optimizer (Levenberg-Marquartd) seeks for the
  * set of selected parameters to estimate that minimize the reprojection errors.
+ *  Each iteration solves the sparse normal equations via the Schur complement
+ * of the (block-diagonal) camera poses, so its cost grows linearly with the
+ * number of image pairs.
  *
  *  \param input_images [IN/OUT] At input, this list must have one entry for
  * each image to process. At output the original, detected checkboard and
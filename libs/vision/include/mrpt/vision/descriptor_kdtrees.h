@@ -12,6 +12,12 @@
 #include <mrpt/vision/CFeature.h>
 #include <mrpt/vision/types.h>
 
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace mrpt
 {
 namespace vision
@@ -149,6 +155,130 @@ struct TSURFDescriptorsKDTreeIndex
 	const CFeatureList& m_feats;
 };	// end of TSURFDescriptorsKDTreeIndex
 
+/** An index for fast k-nearest neighbors queries of binary descriptors (ORB,
+ * BLD, LATCH) in Hamming space, built with multi-index hashing (M. Norouzi,
+ * A. Punjani and D.J. Fleet, "Fast Search in Hamming Space with Multi-Index
+ * Hashing", CVPR 2012).
+ *
+ * Each descriptor is split into `m` substrings of `substringBytes` bytes,
+ * each one indexed in its own hash table. A descriptor at a Hamming distance
+ * `d` from the query must have at least one substring within a distance
+ * `floor(d/m)`, so neighbors are found by probing buckets at increasing
+ * substring radius `r`. The search stops as soon as the k-th neighbor found
+ * is closer than any descriptor not yet probed, or when `r` reaches
+ * TSearchParams::max_substring_radius. Hence, all neighbors at a distance
+ * below `m*(max_substring_radius+1)` are always found: e.g. 48 bits for ORB
+ * (32 bytes), 2-byte substrings (m=16) and the default radius of 2.
+ *
+ * Descriptors can be inserted incrementally (e.g. the features of each new
+ * keyframe in a place recognition database), each one with an arbitrary
+ * user ID (e.g. the keyframe ID).
+ *
+ * Example of usage:
+ *  \code
+ *    TBinaryDescriptorsMIHIndex index(32); // ORB descriptors
+ *    index.insert(keyframe_feats, descORB, keyframe_id);
+ *    ...
+ *    std::vector<TBinaryDescriptorsMIHIndex::TResult> nn;
+ *    index.knnSearch(query_feat.descriptors.ORB->data(), 2, nn);
+ *  \endcode
+ *
+ * \note Queries are const and can run in parallel, but not simultaneously
+ * with insertions.
+ * \sa CFeatureList, match_binary_descriptors()
+ * \note (New in MRPT 2.4.3)
+ */
+class TBinaryDescriptorsMIHIndex
+{
+   public:
+	/** \param descriptorBytes The length of all descriptors (32 for ORB).
+	 * \param substringBytes Length of each hashed substring, in range [1,4].
+	 * The best value is around `log2(N)/8`, for N the expected number of
+	 * descriptors.
+	 */
+	explicit TBinaryDescriptorsMIHIndex(
+		std::size_t descriptorBytes, std::size_t substringBytes = 2);
+
+	/** Builds the index for all descriptors of the given type in a list of
+	 * features, with user IDs equal to each feature index. */
+	TBinaryDescriptorsMIHIndex(
+		const CFeatureList& feats, TDescriptorType descriptor = descORB,
+		std::size_t substringBytes = 2);
+
+	/** Adds one descriptor with `descriptorBytes()` bytes.
+	 * \return The index of the new entry */
+	std::size_t insert(const uint8_t* descriptor, uint64_t userID = 0);
+
+	/** Adds the descriptors of all features in the list, all of them with the
+	 * same user ID. \return The index of the first new entry */
+	std::size_t insert(
+		const CFeatureList& feats, TDescriptorType descriptor = descORB,
+		uint64_t userID = 0);
+
+	std::size_t size() const { return m_userIDs.size(); }
+	bool empty() const { return m_userIDs.empty(); }
+	void clear();
+
+	std::size_t descriptorBytes() const { return m_descBytes; }
+	/** Number of substrings (and hash tables), `m` */
+	std::size_t substringCount() const { return m_tables.size(); }
+
+	const uint8_t* descriptor(std::size_t idx) const
+	{
+		return &m_descriptors[idx * m_descBytes];
+	}
+	uint64_t userID(std::size_t idx) const { return m_userIDs[idx]; }
+
+	struct TSearchParams
+	{
+		/** Maximum search radius in each substring. Larger values increase
+		 * recall at a higher cost (see class description). */
+		uint32_t max_substring_radius = 2;
+
+		/** Neighbors farther than this distance are not reported */
+		uint32_t max_distance = std::numeric_limits<uint32_t>::max();
+
+		/** Stop after computing the full distance to this number of
+		 * candidates (0: no limit). */
+		std::size_t max_candidates = 0;
+	};
+
+	struct TResult
+	{
+		TResult() = default;
+		TResult(std::size_t i, uint32_t d) : idx(i), distance(d) {}
+
+		std::size_t idx = 0;  //!< Index of the entry in the database
+		uint32_t distance = 0;	//!< Hamming distance to the query
+	};
+
+	/** Finds the (up to) `k` nearest descriptors to the query, which must
+	 * have `descriptorBytes()` bytes.
+	 * \param[out] out Sorted by ascending distance, then by index.
+	 * \return The number of neighbors found.
+	 */
+	std::size_t knnSearch(
+		const uint8_t* query, std::size_t k, std::vector<TResult>& out,
+		const TSearchParams& params) const;
+
+	/// \overload With default search parameters.
+	std::size_t knnSearch(
+		const uint8_t* query, std::size_t k, std::vector<TResult>& out) const
+	{
+		return knnSearch(query, k, out, TSearchParams());
+	}
+
+   private:
+	std::size_t m_descBytes, m_substringBytes;
+	std::vector<uint8_t> m_descriptors;
+	std::vector<uint64_t> m_userIDs;
+	/** One table per substring: substring value -> entry indices */
+	std::vector<std::unordered_map<uint32_t, std::vector<uint32_t>>> m_tables;
+
+	uint32_t substring(const uint8_t* desc, std::size_t i) const;
+	std::size_t substringBits(std::size_t i) const;
+};
+
 /** @} */
 
 namespace detail
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <mrpt/containers/yaml.h>
+#include <mrpt/core/pimpl.h>
 #include <mrpt/img/CImage.h>
 #include <mrpt/system/CTimeLogger.h>
 #include <mrpt/vision/TKeyPoint.h>
@@ -131,6 +132,13 @@ namespace mrpt::vision
  * be automatically removed from the list of features.
  *            Otherwise, the user will have to manually remove them by checking
  * the track_status field. </td> </tr>
+ *   <tr><td align="center" > reuse_previous_image  </td>  <td align="center"
+ * > 1 </td>
+ *      <td> If !=0, the data derived from "new_img" (its grayscale version,
+ * and the image pyramid in CFeatureTracker_KL) is kept and reused when that
+ * same image (or a shallow copy of it) is passed as "old_img" in the next
+ * call, as in the usual sequential tracking loop. Set to 0 if images are
+ * modified in-place between calls. </td> </tr>
  * </table>
  *
  *  This class also offers a time profiler, disabled by default (see
@@ -240,6 +248,9 @@ struct CGenericFeatureTracker
 		const size_t nNewlyDetectedFeats, const size_t desired_num_features);
 
    private:
+	/** For use when "reuse_previous_image"!=0: the last "new_img" and its
+	 * grayscale version */
+	mrpt::img::CImage m_last_new_img, m_last_new_img_gray;
 	/** for use when "update_patches_every">=1 */
 	size_t m_update_patches_counter{0};
 	/** For use when "check_KLT_response_every">=1 */
@@ -276,6 +287,9 @@ using CGenericFeatureTrackerAutoPtr = std::unique_ptr<CGenericFeatureTracker>;
  *of
  *LK tracking such as a feature is marked as "lost".
  *
+ *  The image pyramid of each "new_img" is kept for the next call (see
+ *"reuse_previous_image" in CGenericFeatureTracker).
+ *
  *  \sa OpenCV's method cvCalcOpticalFlowPyrLK
  */
 struct CFeatureTracker_KL : public CGenericFeatureTracker
@@ -297,6 +311,10 @@ struct CFeatureTracker_KL : public CGenericFeatureTracker
 		TKeyPointfList& inout_featureList) override;
 
    private:
+	/** Pyramid of the last "new_img", for "reuse_previous_image" */
+	struct Impl;
+	mrpt::pimpl<Impl> m_impl;
+
 	template <typename FEATLIST>
 	void trackFeatures_impl_templ(
 		const mrpt::img::CImage& old_img, const mrpt::img::CImage& new_img,
@@ -41,6 +41,15 @@ using TLandmarkLocationsMap = std::map<TLandmarkID, mrpt::math::TPoint3D>;
  * consecutive IDs. */
 using TLandmarkLocationsVec = std::vector<mrpt::math::TPoint3D>;
 
+/** Index of a visual word in a CVisualVocabulary */
+using TVisualWordID = uint32_t;
+
+/** A bag-of-words representation of an image: pairs of (word, weight),
+ * sorted by ascending word ID, with weights normalized to sum 1.
+ * \sa CVisualVocabulary::transform(), CBoWDatabase
+ */
+using TBagOfWords = std::vector<std::pair<TVisualWordID, float>>;
+
 /** Types of key point detectors */
 enum TKeyPointMethod : int8_t
 {
@@ -0,0 +1,123 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/vision/CBoWDatabase.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace mrpt::vision;
+
+IMPLEMENTS_SERIALIZABLE(CBoWDatabase, CSerializable, mrpt::vision)
+
+CBoWDatabase::image_id_t CBoWDatabase::add(const TBagOfWords& bow)
+{
+	ASSERTMSG_(
+		m_imageCount < std::numeric_limits<image_id_t>::max(),
+		"Too many images in CBoWDatabase");
+
+	const image_id_t id = m_imageCount++;
+	for (const auto& wv : bow)
+	{
+		if (wv.second == 0) continue;
+		if (wv.first >= m_invertedFile.size())
+			m_invertedFile.resize(wv.first + 1);
+		m_invertedFile[wv.first].emplace_back(id, wv.second);
+	}
+	return id;
+}
+
+void CBoWDatabase::clear()
+{
+	m_invertedFile.clear();
+	m_imageCount = 0;
+}
+
+void CBoWDatabase::query(
+	const TBagOfWords& bow, std::size_t maxResults,
+	std::vector<TResult>& results, image_id_t maxImageID) const
+{
+	results.clear();
+	if (maxResults == 0 || empty()) return;
+
+	// For L1-normalized vectors:
+	//  |v-w|_1 = 2 + sum_{i: v_i!=0, w_i!=0} (|v_i-w_i| - |v_i| - |w_i|)
+	// so only the words in common need to be visited:
+	std::vector<float> acc(m_imageCount, 0.0f);
+	std::vector<image_id_t> touched;
+	for (const auto& wv : bow)
+	{
+		if (wv.second == 0 || wv.first >= m_invertedFile.size()) continue;
+		const float vi = wv.second;
+		for (const auto& e : m_invertedFile[wv.first])
+		{
+			if (e.image > maxImageID) break;  // Sorted by image ID
+			if (acc[e.image] == 0) touched.push_back(e.image);
+			acc[e.image] +=
+				std::abs(vi) + std::abs(e.weight) - std::abs(vi - e.weight);
+		}
+	}
+
+	results.reserve(touched.size());
+	for (const auto id : touched)
+		if (acc[id] > 0) results.emplace_back(id, 0.5 * acc[id]);
+
+	auto better = [](const TResult& a, const TResult& b) {
+		return a.score > b.score || (a.score == b.score && a.image < b.image);
+	};
+	if (results.size() > maxResults)
+	{
+		std::partial_sort(
+			results.begin(), results.begin() + maxResults, results.end(),
+			better);
+		results.resize(maxResults);
+	}
+	else
+		std::sort(results.begin(), results.end(), better);
+}
+
+uint8_t CBoWDatabase::serializeGetVersion() const { return 0; }
+void CBoWDatabase::serializeTo(mrpt::serialization::CArchive& out) const
+{
+	out << m_imageCount << static_cast<uint32_t>(m_invertedFile.size());
+	for (const auto& lst : m_invertedFile)
+	{
+		out << static_cast<uint32_t>(lst.size());
+		for (const auto& e : lst)
+			out << e.image << e.weight;
+	}
+}
+
+void CBoWDatabase::serializeFrom(
+	mrpt::serialization::CArchive& in, uint8_t version)
+{
+	switch (version)
+	{
+		case 0:
+		{
+			uint32_t nWords;
+			in >> m_imageCount >> nWords;
+			m_invertedFile.clear();
+			m_invertedFile.resize(nWords);
+			for (auto& lst : m_invertedFile)
+			{
+				uint32_t n;
+				in >> n;
+				lst.resize(n);
+				for (auto& e : lst)
+					in >> e.image >> e.weight;
+			}
+		}
+		break;
+		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
+	};
+}
@@ -21,6 +21,7 @@
 #include <mrpt/vision/types.h>
 #include <mrpt/vision/utils.h>
 
+#include <cstring>
 #include <iostream>
 
 using namespace mrpt;
@@ -697,6 +698,31 @@ float CFeature::descriptorLogPolarImgDistanceTo(
 	MRPT_END
 }  // end descriptorPolarImgDistanceTo
 
+const std::vector<uint8_t>& CFeature::getBinaryDescriptor(
+	TDescriptorType descriptor) const
+{
+	switch (descriptor)
+	{
+		case descORB:
+			ASSERTMSG_(
+				descriptors.hasDescriptorORB(), "Feature has no ORB descriptor");
+			return *descriptors.ORB;
+		case descBLD:
+			ASSERTMSG_(
+				descriptors.hasDescriptorBLD(), "Feature has no BLD descriptor");
+			return *descriptors.BLD;
+		case descLATCH:
+			ASSERTMSG_(
+				descriptors.hasDescriptorLATCH(),
+				"Feature has no LATCH descriptor");
+			return *descriptors.LATCH;
+		default:
+			THROW_EXCEPTION(
+				"Only binary descriptors (descORB, descBLD, descLATCH) are "
+				"supported");
+	};
+}
+
 // --------------------------------------------------
 //        descriptorORBDistanceTo
 // --------------------------------------------------
@@ -706,24 +732,11 @@ uint8_t CFeature::descriptorORBDistanceTo(const CFeature& oFeature) const
 		descriptors.hasDescriptorORB() &&
 		oFeature.descriptors.hasDescriptorORB());
 	ASSERT_(descriptors.ORB->size() == oFeature.descriptors.ORB->size());
-	const std::vector<uint8_t>& t_desc = *descriptors.ORB;
-	const std::vector<uint8_t>& o_desc = *oFeature.descriptors.ORB;
-
-	// Descriptors XOR + Hamming weight
-	uint8_t distance = 0;
-	for (uint8_t k = 0; k < t_desc.size(); ++k)
-	{
-		// from : Wegner, Peter (1960), "A technique for counting ones in a
-		// binary computer", Communications of the ACM 3 (5): 322,
-		// doi:10.1145/367236.367286
-		uint8_t x_or = t_desc[k] ^ o_desc[k];
-		uint8_t count;
-		for (count = 0; x_or; count++)	// ...
-			x_or &= x_or - 1;  // ...
-		distance += count;
-	}
-
-	return distance;
+	// Note: the result overflows for descriptors longer than 255 bits. Kept
+	// as uint8_t for backwards compatibility.
+	return static_cast<uint8_t>(mrpt::vision::hamming_distance(
+		descriptors.ORB->data(), oFeature.descriptors.ORB->data(),
+		descriptors.ORB->size()));
 }
 
 // # added by Raghavender Sahdev
@@ -1075,6 +1088,29 @@ void CFeatureList::copyListFrom(const CFeatureList& otherList)
 	}
 }  // end-copyListFrom
 
+// --------------------------------------------------
+// buildDescriptorMatrix()
+// --------------------------------------------------
+void CFeatureList::buildDescriptorMatrix(TDescriptorType descriptor)
+{
+	MRPT_START
+
+	m_descMatrix.clear();
+	if (m_feats.empty()) return;
+
+	const size_t descLen = m_feats[0].getBinaryDescriptor(descriptor).size();
+	m_descMatrix.resize(m_feats.size(), descLen);
+	m_descMatrix.type = descriptor;
+
+	for (size_t i = 0; i < m_feats.size(); i++)
+	{
+		const auto& d = m_feats[i].getBinaryDescriptor(descriptor);
+		ASSERT_EQUAL_(d.size(), descLen);
+		std::memcpy(m_descMatrix.row(i), d.data(), descLen);
+	}
+	MRPT_END
+}
+
 const CFeature* CFeatureList::getByID(const TFeatureID& ID) const
 {
 	for (const auto& f : *this)
@@ -40,6 +40,13 @@ void CFeatureExtraction::detectFeatures(
 {
 	CTimeLoggerEntry tle(profiler, "detectFeatures");
 
+	const auto& tiling = options.tilingOptions;
+	if (tiling.grid_cols * tiling.grid_rows > 1 && options.featsType != featLSD)
+	{
+		detectFeaturesTiled(img, feats, init_ID, nDesiredFeatures, ROI);
+		return;
+	}
+
 	switch (options.featsType)
 	{
 		case featHarris:
@@ -210,6 +217,12 @@ void CFeatureExtraction::TOptions::dumpToTextStream(std::ostream& out) const
 	LOADABLEOPTS_DUMP_VAR(LATCHOptions.half_ssd_size, int)
 	LOADABLEOPTS_DUMP_VAR(LATCHOptions.rotationInvariance, bool)
 
+	LOADABLEOPTS_DUMP_VAR(tilingOptions.grid_cols, int)
+	LOADABLEOPTS_DUMP_VAR(tilingOptions.grid_rows, int)
+	LOADABLEOPTS_DUMP_VAR(tilingOptions.max_features_per_cell, int)
+	LOADABLEOPTS_DUMP_VAR(tilingOptions.border, int)
+	LOADABLEOPTS_DUMP_VAR(tilingOptions.num_threads, int)
+
 	out << "\n";
 }
 
@@ -298,4 +311,11 @@ void CFeatureExtraction::TOptions::loadFromConfigFile(
 	MRPT_LOAD_CONFIG_VAR(LATCHOptions.half_ssd_size, int, iniFile, section)
 	MRPT_LOAD_CONFIG_VAR(
 		LATCHOptions.rotationInvariance, bool, iniFile, section)
+
+	MRPT_LOAD_CONFIG_VAR(tilingOptions.grid_cols, int, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(tilingOptions.grid_rows, int, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(
+		tilingOptions.max_features_per_cell, int, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(tilingOptions.border, int, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(tilingOptions.num_threads, int, iniFile, section)
 }
@@ -0,0 +1,237 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/TaskScheduler.h>
+#include <mrpt/vision/CFeatureExtraction.h>
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+using namespace mrpt;
+using namespace mrpt::vision;
+using namespace mrpt::img;
+using namespace mrpt::system;
+
+namespace
+{
+struct TCell
+{
+	// Cell area [x0,x1)x[y0,y1):
+	unsigned int x0, x1, y0, y1;
+	// Image area passed to the detector (the cell plus its border):
+	unsigned int cropX0, cropY0, cropW, cropH;
+};
+
+struct TCandidate
+{
+	CFeature* feat;
+	unsigned int cell;	// Index of the source cell
+	unsigned int rank;	// Order within the cell (detectors sort by quality)
+};
+
+// Min. distance between features of the given detector, or 0 if none.
+float detectorMinDistance(const CFeatureExtraction::TOptions& o)
+{
+	switch (o.featsType)
+	{
+		case featKLT:
+		case featHarris: return o.harrisOptions.min_distance;
+		case featFAST: return o.FASTOptions.min_distance;
+		case featORB: return o.ORBOptions.min_distance;
+		default: return 0;
+	};
+}
+}  // namespace
+
+void CFeatureExtraction::detectFeaturesTiled(
+	const CImage& img, CFeatureList& feats, unsigned int init_ID,
+	unsigned int nDesiredFeatures, const TImageROI& ROI)
+{
+	MRPT_START
+
+	CTimeLoggerEntry tle(profiler, "detectFeaturesTiled");
+
+	const auto& tiling = options.tilingOptions;
+	const unsigned int nCols = tiling.grid_cols, nRows = tiling.grid_rows;
+	ASSERT_(nCols >= 1 && nRows >= 1);
+
+	// Area to split into cells: the ROI, if defined, or the whole image:
+	const unsigned int imgW = img.getWidth(), imgH = img.getHeight();
+	unsigned int ax0 = 0, ax1 = imgW, ay0 = 0, ay1 = imgH;
+	if (ROI.xMin != 0 || ROI.xMax != 0 || ROI.yMin != 0 || ROI.yMax != 0)
+	{
+		ASSERT_(ROI.xMin < ROI.xMax && ROI.xMax < imgW);
+		ASSERT_(ROI.yMin < ROI.yMax && ROI.yMax < imgH);
+		ax0 = ROI.xMin;
+		ax1 = ROI.xMax + 1;
+		ay0 = ROI.yMin;
+		ay1 = ROI.yMax + 1;
+	}
+	ASSERTMSG_(
+		ax1 - ax0 >= nCols && ay1 - ay0 >= nRows,
+		"Tiling grid is larger than the image");
+
+	const unsigned int border =
+		std::max(tiling.border, options.patchSize / 2 + 1);
+
+	std::vector<TCell> cells;
+	cells.reserve(nCols * nRows);
+	for (unsigned int r = 0; r < nRows; r++)
+	{
+		for (unsigned int c = 0; c < nCols; c++)
+		{
+			TCell cell;
+			cell.x0 = ax0 + (ax1 - ax0) * c / nCols;
+			cell.x1 = ax0 + (ax1 - ax0) * (c + 1) / nCols;
+			cell.y0 = ay0 + (ay1 - ay0) * r / nRows;
+			cell.y1 = ay0 + (ay1 - ay0) * (r + 1) / nRows;
+			cell.cropX0 = cell.x0 > border ? cell.x0 - border : 0;
+			cell.cropY0 = cell.y0 > border ? cell.y0 - border : 0;
+			cell.cropW = std::min(imgW, cell.x1 + border) - cell.cropX0;
+			cell.cropH = std::min(imgH, cell.y1 + border) - cell.cropY0;
+			cells.push_back(cell);
+		}
+	}
+
+	const unsigned int nCells = cells.size();
+	const unsigned int cellBudget = tiling.max_features_per_cell != 0
+		? tiling.max_features_per_cell
+		: (nDesiredFeatures + nCells - 1) / nCells;
+
+	// Per-cell detection. Each task uses its own extractor, with the same
+	// options but no tiling:
+	TOptions cellOptions = options;
+	cellOptions.tilingOptions = TOptions::TTilingOptions();
+	cellOptions.addNewFeatures = false;
+
+	std::vector<CFeatureList> cellFeats(nCells);
+	auto detectCells = [&](std::size_t i0, std::size_t i1) {
+		CFeatureExtraction fe;
+		fe.options = cellOptions;
+		CImage crop;
+		for (std::size_t i = i0; i < i1; i++)
+		{
+			const TCell& cell = cells[i];
+			img.extract_patch(
+				crop, cell.cropX0, cell.cropY0, cell.cropW, cell.cropH);
+
+			// Ask for more features than the budget, proportionally to the
+			// extra area of the border:
+			unsigned int nWanted = 0;
+			if (cellBudget != 0)
+			{
+				const double areaRatio = double(cell.cropW) * cell.cropH /
+					(double(cell.x1 - cell.x0) * (cell.y1 - cell.y0));
+				nWanted = static_cast<unsigned int>(
+					std::ceil(cellBudget * areaRatio));
+			}
+
+			CFeatureList lst;
+			fe.detectFeatures(crop, lst, 0, nWanted);
+
+			// Back to image coordinates, and keep only those in this cell
+			// (the rest belong to a neighbor cell):
+			auto& out = cellFeats[i];
+			for (auto& f : lst)
+			{
+				f.keypoint.pt.x += cell.cropX0;
+				f.keypoint.pt.y += cell.cropY0;
+				const float x = f.keypoint.pt.x, y = f.keypoint.pt.y;
+				if (x < cell.x0 || x >= cell.x1 || y < cell.y0 || y >= cell.y1)
+					continue;
+				out.emplace_back(std::move(f));
+				if (cellBudget != 0 && out.size() >= cellBudget) break;
+			}
+		}
+	};
+
+	// By default, one task per cell, so the load is balanced among threads
+	// even if some cells have much more texture than others:
+	const unsigned int grain = tiling.num_threads != 0
+		? (nCells + tiling.num_threads - 1) / tiling.num_threads
+		: 1;
+	{
+		CTimeLoggerEntry tle2(profiler, "detectFeaturesTiled.detect");
+		mrpt::parallel_for(0, nCells, grain, detectCells);
+	}
+
+	// Merge: sort by response, then by rank within each cell (some detectors
+	// leave "response" unset but return features sorted by quality), so
+	// that the global limit of features is distributed evenly among cells.
+	std::vector<TCandidate> cands;
+	for (unsigned int i = 0; i < nCells; i++)
+		for (unsigned int k = 0; k < cellFeats[i].size(); k++)
+			cands.push_back({&cellFeats[i][k], i, k});
+
+	std::sort(
+		cands.begin(), cands.end(),
+		[](const TCandidate& a, const TCandidate& b) {
+			if (a.feat->response != b.feat->response)
+				return a.feat->response > b.feat->response;
+			if (a.rank != b.rank) return a.rank < b.rank;
+			return a.cell < b.cell;
+		});
+
+	// Enforce the min-distance between features of neighboring cells
+	// (within each cell, the detector already did it):
+	const float minDist = detectorMinDistance(options);
+	const bool doFilterMinDist = minDist > 1;
+	const unsigned int gridW = doFilterMinDist ? 1 + imgW / minDist : 1;
+	const unsigned int gridH = doFilterMinDist ? 1 + imgH / minDist : 1;
+	// Accepted features in each grid bucket: (x, y, cell)
+	std::vector<std::vector<std::tuple<float, float, unsigned int>>> grid(
+		gridW * gridH);
+
+	if (!options.addNewFeatures) feats.clear();
+	TFeatureID nextID = init_ID;
+	unsigned int nAccepted = 0;
+
+	for (const auto& cand : cands)
+	{
+		if (nDesiredFeatures != 0 && nAccepted >= nDesiredFeatures) break;
+
+		const float x = cand.feat->keypoint.pt.x, y = cand.feat->keypoint.pt.y;
+		if (doFilterMinDist)
+		{
+			const int gx = static_cast<int>(x / minDist);
+			const int gy = static_cast<int>(y / minDist);
+			bool tooClose = false;
+			for (int iy = std::max(0, gy - 1);
+				 !tooClose && iy <= std::min<int>(gridH - 1, gy + 1); iy++)
+			{
+				for (int ix = std::max(0, gx - 1);
+					 !tooClose && ix <= std::min<int>(gridW - 1, gx + 1); ix++)
+				{
+					for (const auto& [ox, oy, oCell] : grid[iy * gridW + ix])
+					{
+						if (oCell == cand.cell) continue;
+						const float dx = ox - x, dy = oy - y;
+						if (dx * dx + dy * dy < minDist * minDist)
+						{
+							tooClose = true;
+							break;
+						}
+					}
+				}
+			}
+			if (tooClose) continue;
+			grid[gy * gridW + gx].emplace_back(x, y, cand.cell);
+		}
+
+		CFeature& f = *cand.feat;
+		f.keypoint.ID = nextID++;
+		feats.emplace_back(std::move(f));
+		nAccepted++;
+	}
+
+	MRPT_END
+}
@@ -0,0 +1,80 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config.h>
+#include <mrpt/vision/CFeatureExtraction.h>
+#include <test_mrpt_common.h>
+
+#if MRPT_HAS_OPENCV
+TEST(CFeatureExtraction, tiledFAST)
+#else
+TEST(CFeatureExtraction, DISABLED_tiledFAST)
+#endif
+{
+	using namespace std::string_literals;
+	using namespace mrpt::vision;
+
+	const auto fil = mrpt::UNITTEST_BASEDIR +
+		"/share/mrpt/datasets/stereo-calib/0_left.jpg"s;
+	mrpt::img::CImage img;
+	if (!img.loadFromFile(fil))
+	{
+		GTEST_FAIL() << "Error loading: " << fil;
+		return;
+	}
+
+	CFeatureExtraction fext;
+	fext.options.featsType = featFAST;
+	fext.options.patchSize = 0;
+	fext.options.FASTOptions.threshold = 10;
+	fext.options.FASTOptions.min_distance = 4;
+	auto& tiling = fext.options.tilingOptions;
+	tiling.grid_cols = 4;
+	tiling.grid_rows = 3;
+	tiling.max_features_per_cell = 20;
+
+	CFeatureList feats1;
+	tiling.num_threads = 1;
+	fext.detectFeatures(img, feats1, 100);
+
+	CFeatureList featsN;
+	tiling.num_threads = 4;
+	fext.detectFeatures(img, featsN, 100);
+
+	// The result does not depend on the number of threads:
+	ASSERT_EQ(feats1.size(), featsN.size());
+	for (size_t i = 0; i < feats1.size(); i++)
+	{
+		EXPECT_EQ(feats1[i].keypoint.ID, 100 + i);
+		EXPECT_EQ(featsN[i].keypoint.ID, 100 + i);
+		EXPECT_EQ(feats1[i].keypoint.pt.x, featsN[i].keypoint.pt.x);
+		EXPECT_EQ(feats1[i].keypoint.pt.y, featsN[i].keypoint.pt.y);
+	}
+
+	// Per-cell budget:
+	const unsigned int W = img.getWidth(), H = img.getHeight();
+	std::vector<size_t> count(12, 0);
+	for (const auto& f : feats1)
+	{
+		const auto cx = static_cast<unsigned int>(f.keypoint.pt.x) * 4 / W;
+		const auto cy = static_cast<unsigned int>(f.keypoint.pt.y) * 3 / H;
+		ASSERT_LT(cx, 4U);
+		ASSERT_LT(cy, 3U);
+		count[cy * 4 + cx]++;
+	}
+	for (const auto c : count)
+		EXPECT_LE(c, tiling.max_features_per_cell);
+	EXPECT_GT(feats1.size(), 100U);
+
+	// Global limit:
+	CFeatureList feats;
+	fext.detectFeatures(img, feats, 0, 50);
+	EXPECT_EQ(feats.size(), 50U);
+}
@@ -14,6 +14,8 @@
 
 #include <Eigen/Dense>
 
+#include "remap_fixed_point.h"
+
 using namespace mrpt;
 using namespace mrpt::poses;
 using namespace mrpt::vision;
@@ -282,6 +284,30 @@ void CStereoRectifyMap::rectify(
 	out_right_image.resize(
 		trg_size.width, trg_size.height, in_left_image.getChannelCount());
 
+	if (m_internal_remap && isSet() &&
+		(m_interpolation_method == IMG_INTERP_LINEAR ||
+		 m_interpolation_method == IMG_INTERP_NN))
+	{
+		ASSERT_EQUAL_(
+			m_dat_mapy_left.size(),
+			static_cast<size_t>(trg_size.width) * trg_size.height);
+		ASSERT_EQUAL_(m_dat_mapy_right.size(), m_dat_mapy_left.size());
+
+		mrpt::vision::internal::TFixedPointRemapJob jobs[2];
+		if (mrpt::vision::internal::prepare_remap_job(
+				in_left_image, out_left_image, m_dat_mapx_left.data(),
+				m_dat_mapy_left.data(), jobs[0]) &&
+			mrpt::vision::internal::prepare_remap_job(
+				in_right_image, out_right_image, m_dat_mapx_right.data(),
+				m_dat_mapy_right.data(), jobs[1]))
+		{
+			mrpt::vision::internal::remap_fixed_point_8u(
+				jobs, 2, m_interpolation_method == IMG_INTERP_LINEAR,
+				m_internal_remap_threads);
+			return;
+		}
+	}
+
 	const cv::Mat in_left = in_left_image.asCvMat<cv::Mat>(SHALLOW_COPY);
 	const cv::Mat in_right = in_right_image.asCvMat<cv::Mat>(SHALLOW_COPY);
 
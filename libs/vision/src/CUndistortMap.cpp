@@ -14,6 +14,8 @@
 // Universal include for all versions of OpenCV
 #include <mrpt/3rdparty/do_opencv_includes.h>
 
+#include "remap_fixed_point.h"
+
 using namespace mrpt;
 using namespace mrpt::vision;
 using namespace mrpt::img;
@@ -77,6 +79,8 @@ void CUndistortMap::undistort(
 	out_img.resize(
 		in_img.getWidth(), in_img.getHeight(), in_img.getChannelCount());
 
+	if (internal_remap(in_img, out_img)) return;
+
 	cv::remap(
 		in_img.asCvMat<Mat>(SHALLOW_COPY), out_img.asCvMat<Mat>(SHALLOW_COPY),
 		mapx, mapy, INTER_LINEAR);
@@ -102,6 +106,18 @@ void CUndistortMap::undistort(mrpt::img::CImage& in_out_img) const
 		m_camera_params.nrows, m_camera_params.ncols, CV_16UC1,
 		const_cast<uint16_t*>(&m_dat_mapy[0]));
 
+	if (m_internal_remap)
+	{
+		CImage out(
+			in_out_img.getWidth(), in_out_img.getHeight(),
+			in_out_img.getChannelCount());
+		if (internal_remap(in_out_img, out))
+		{
+			in_out_img = std::move(out);
+			return;
+		}
+	}
+
 	cv::Mat in = in_out_img.asCvMat<cv::Mat>(SHALLOW_COPY);
 	cv::Mat out(in.size(), in.type());
 
@@ -111,3 +127,21 @@ void CUndistortMap::undistort(mrpt::img::CImage& in_out_img) const
 #endif
 	MRPT_END
 }
+
+bool CUndistortMap::internal_remap(
+	const mrpt::img::CImage& in_img, mrpt::img::CImage& out_img) const
+{
+	if (!m_internal_remap) return false;
+
+	ASSERT_EQUAL_(out_img.getWidth(), m_camera_params.ncols);
+	ASSERT_EQUAL_(out_img.getHeight(), m_camera_params.nrows);
+
+	mrpt::vision::internal::TFixedPointRemapJob job;
+	if (!mrpt::vision::internal::prepare_remap_job(
+			in_img, out_img, m_dat_mapx.data(), m_dat_mapy.data(), job))
+		return false;
+
+	mrpt::vision::internal::remap_fixed_point_8u(
+		&job, 1, true /*bilinear*/, m_internal_remap_threads);
+	return true;
+}
@@ -0,0 +1,143 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/core/cpu.h>
+#include <mrpt/random.h>
+#include <mrpt/vision/CStereoRectifyMap.h>
+#include <mrpt/vision/CUndistortMap.h>
+
+#include <cstdlib>
+
+#if MRPT_HAS_OPENCV
+
+using namespace mrpt::img;
+
+namespace
+{
+TCamera testCamera()
+{
+	TCamera cam;
+	cam.ncols = 320;
+	cam.nrows = 240;
+	cam.setIntrinsicParamsFromValues(300, 305, 161.5, 118.2);
+	cam.setDistortionPlumbBob(-0.25, 0.08, 0.001, -0.002);
+	return cam;
+}
+
+CImage randomImage(TImageChannels ch, uint32_t seed)
+{
+	mrpt::random::Randomize(seed);
+	auto& rng = mrpt::random::getRandomGenerator();
+	CImage img(320, 240, ch);
+	for (unsigned y = 0; y < img.getHeight(); y++)
+	{
+		auto* row = img.ptrLine<uint8_t>(y);
+		for (unsigned x = 0; x < img.getRowStride(); x++)
+			row[x] = static_cast<uint8_t>(rng.drawUniform32bit());
+	}
+	return img;
+}
+
+// Max. absolute difference between pixels:
+int maxDiff(const CImage& a, const CImage& b)
+{
+	EXPECT_EQ(a.getWidth(), b.getWidth());
+	EXPECT_EQ(a.getHeight(), b.getHeight());
+	EXPECT_EQ(a.getChannelCount(), b.getChannelCount());
+	int m = 0;
+	const unsigned n = a.getWidth() * a.getChannelCount();
+	for (unsigned y = 0; y < a.getHeight(); y++)
+		for (unsigned x = 0; x < n; x++)
+			m = std::max(
+				m,
+				std::abs(a.ptrLine<uint8_t>(y)[x] - b.ptrLine<uint8_t>(y)[x]));
+	return m;
+}
+}  // namespace
+
+TEST(CUndistortMap, internalRemap)
+{
+	mrpt::vision::CUndistortMap um;
+	um.setFromCamParams(testCamera());
+
+	const bool savedFeatAVX2 = mrpt::cpu::supports(mrpt::cpu::feature::AVX2);
+
+	for (const auto ch : {CH_GRAY, CH_RGB})
+	{
+		const CImage in = randomImage(ch, 123);
+
+		CImage outOpenCV;
+		um.enableInternalRemap(false);
+		um.undistort(in, outOpenCV);
+
+		// Single and multi-threaded, with and without AVX2:
+		CImage outRef;
+		for (unsigned int nThreads : {1, 3})
+		{
+			for (const bool avx2 : {false, true})
+			{
+				if (avx2 && !savedFeatAVX2) continue;
+				mrpt::cpu::overrideDetectedFeature(
+					mrpt::cpu::feature::AVX2, avx2);
+
+				CImage out;
+				um.enableInternalRemap(true, nThreads);
+				um.undistort(in, out);
+
+				// Same interpolation than OpenCV, up to rounding:
+				EXPECT_LE(maxDiff(out, outOpenCV), 1);
+				// All versions must be bit-exact:
+				if (outRef.isEmpty()) outRef = out;
+				else
+					EXPECT_EQ(maxDiff(out, outRef), 0);
+
+				// In-place:
+				CImage inout = in.makeDeepCopy();
+				um.undistort(inout);
+				EXPECT_EQ(maxDiff(inout, outRef), 0);
+			}
+		}
+	}
+	mrpt::cpu::overrideDetectedFeature(
+		mrpt::cpu::feature::AVX2, savedFeatAVX2);
+}
+
+TEST(CStereoRectifyMap, internalRemap)
+{
+	TStereoCamera params;
+	params.leftCamera = testCamera();
+	params.rightCamera = testCamera();
+	params.rightCameraPose =
+		mrpt::math::TPose3DQuat(0.12, 0.005, -0.002, 1.0, 0, 0, 0);
+
+	for (const bool resize : {false, true})
+	{
+		mrpt::vision::CStereoRectifyMap rm;
+		rm.enableResizeOutput(resize, 200, 150);
+		rm.setFromCamParams(params);
+
+		for (const auto ch : {CH_GRAY, CH_RGB})
+		{
+			const CImage inL = randomImage(ch, 1), inR = randomImage(ch, 2);
+
+			CImage outL1, outR1, outL2, outR2;
+			rm.enableInternalRemap(false);
+			rm.rectify(inL, inR, outL1, outR1);
+			rm.enableInternalRemap(true);
+			rm.rectify(inL, inR, outL2, outR2);
+
+			EXPECT_EQ(outL2.getWidth(), resize ? 200U : 320U);
+			EXPECT_LE(maxDiff(outL1, outL2), 1);
+			EXPECT_LE(maxDiff(outR1, outR2), 1);
+		}
+	}
+}
+
+#endif
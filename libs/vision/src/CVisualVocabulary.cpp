@@ -0,0 +1,368 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/random/RandomGenerators.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/serialization/stl_serialization.h>
+#include <mrpt/vision/CVisualVocabulary.h>
+#include <mrpt/vision/binary_descriptors.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+using namespace mrpt::vision;
+
+IMPLEMENTS_SERIALIZABLE(CVisualVocabulary, CSerializable, mrpt::vision)
+
+namespace
+{
+// Hierarchical k-majority clustering of a set of binary descriptors.
+struct VocabularyBuilder
+{
+	VocabularyBuilder(
+		const std::vector<uint8_t>& data_, std::size_t descBytes,
+		const CVisualVocabulary::TTrainingParams& params_)
+		: data(data_),
+		  B(descBytes),
+		  params(params_),
+		  rng(params_.random_seed),
+		  wordOfDescriptor(data_.size() / descBytes)
+	{
+	}
+
+	const std::vector<uint8_t>& data;  // All training descriptors
+	const std::size_t B;  // Descriptor length (bytes)
+	const CVisualVocabulary::TTrainingParams& params;
+	mrpt::random::CRandomGenerator rng;
+
+	// Output tree, same layout as in CVisualVocabulary:
+	std::vector<uint32_t> firstChild, numChildren, word;
+	std::vector<uint8_t> centroids;
+	uint32_t nWords = 0;
+	std::vector<TVisualWordID> wordOfDescriptor;
+
+	const uint8_t* desc(uint32_t i) const { return &data[i * B]; }
+
+	uint32_t newNode()
+	{
+		const auto idx = static_cast<uint32_t>(firstChild.size());
+		firstChild.push_back(0);
+		numChildren.push_back(0);
+		word.push_back(0);
+		centroids.resize(centroids.size() + B, 0);
+		return idx;
+	}
+
+	void makeLeaf(uint32_t node, const std::vector<uint32_t>& idxs)
+	{
+		word[node] = nWords++;
+		for (const auto i : idxs)
+			wordOfDescriptor[i] = word[node];
+	}
+
+	// Bitwise majority of a set of descriptors:
+	void majority(const std::vector<uint32_t>& idxs, uint8_t* out) const
+	{
+		std::vector<uint32_t> ones(8 * B, 0);
+		for (const auto i : idxs)
+		{
+			const uint8_t* d = desc(i);
+			for (std::size_t bit = 0; bit < 8 * B; bit++)
+				ones[bit] += (d[bit / 8] >> (bit % 8)) & 1;
+		}
+		std::memset(out, 0, B);
+		for (std::size_t bit = 0; bit < 8 * B; bit++)
+			if (2 * ones[bit] > idxs.size())
+				out[bit / 8] |= static_cast<uint8_t>(1 << (bit % 8));
+	}
+
+	// Splits "idxs" into up to "k" clusters (k-means++ seeding + k-majority
+	// iterations). Empty clusters are dropped.
+	std::vector<std::vector<uint32_t>> cluster(
+		const std::vector<uint32_t>& idxs, std::vector<uint8_t>& outCentroids)
+	{
+		const std::size_t N = idxs.size(), k = params.branching;
+		// k-means++ seeding:
+		std::vector<double> minDist2(N, std::numeric_limits<double>::max());
+		const uint8_t* first = desc(idxs[rng.drawUniform32bit() % N]);
+		std::vector<uint8_t> C(first, first + B);
+		while (C.size() / B < k)
+		{
+			const uint8_t* last = &C[C.size() - B];
+			double sum = 0;
+			for (std::size_t i = 0; i < N; i++)
+			{
+				const double d = hamming_distance(desc(idxs[i]), last, B);
+				minDist2[i] = std::min(minDist2[i], d * d);
+				sum += minDist2[i];
+			}
+			if (sum == 0) break;  // All remaining descriptors are duplicates
+
+			double r = rng.drawUniform(0.0, sum);
+			std::size_t sel = 0;
+			for (; sel + 1 < N; sel++)
+			{
+				r -= minDist2[sel];
+				if (r <= 0) break;
+			}
+			C.resize(C.size() + B);
+			std::memcpy(&C[C.size() - B], desc(idxs[sel]), B);
+		}
+		const std::size_t nC = C.size() / B;
+
+		// k-majority iterations:
+		std::vector<uint32_t> assign(N, 0);
+		std::vector<std::vector<uint32_t>> clusters(nC);
+		for (uint32_t iter = 0; iter < params.max_iterations; iter++)
+		{
+			bool changed = (iter == 0);
+			for (std::size_t i = 0; i < N; i++)
+			{
+				const uint8_t* di = desc(idxs[i]);
+				uint32_t best = 0;
+				uint32_t bestDist = std::numeric_limits<uint32_t>::max();
+				for (std::size_t c = 0; c < nC; c++)
+				{
+					const auto d = hamming_distance(di, &C[c * B], B);
+					if (d < bestDist)
+					{
+						bestDist = d;
+						best = static_cast<uint32_t>(c);
+					}
+				}
+				if (assign[i] != best)
+				{
+					assign[i] = best;
+					changed = true;
+				}
+			}
+			if (!changed) break;
+
+			for (auto& c : clusters)
+				c.clear();
+			for (std::size_t i = 0; i < N; i++)
+				clusters[assign[i]].push_back(idxs[i]);
+			for (std::size_t c = 0; c < nC; c++)
+				if (!clusters[c].empty()) majority(clusters[c], &C[c * B]);
+		}
+
+		// Drop empty clusters:
+		std::vector<std::vector<uint32_t>> out;
+		outCentroids.clear();
+		for (std::size_t c = 0; c < nC; c++)
+		{
+			if (clusters[c].empty()) continue;
+			out.emplace_back(std::move(clusters[c]));
+			outCentroids.insert(
+				outCentroids.end(), C.begin() + c * B, C.begin() + (c + 1) * B);
+		}
+		return out;
+	}
+
+	void build(uint32_t node, const std::vector<uint32_t>& idxs, uint32_t level)
+	{
+		if (level >= params.levels || idxs.size() <= 1)
+		{
+			makeLeaf(node, idxs);
+			return;
+		}
+
+		std::vector<std::vector<uint32_t>> clusters;
+		std::vector<uint8_t> C;
+		if (idxs.size() <= params.branching)
+		{
+			// One child per descriptor:
+			for (const auto i : idxs)
+			{
+				clusters.push_back({i});
+				C.insert(C.end(), desc(i), desc(i) + B);
+			}
+		}
+		else
+			clusters = cluster(idxs, C);
+
+		if (clusters.size() == 1)
+		{
+			// Cannot split any further (all descriptors are identical)
+			makeLeaf(node, idxs);
+			return;
+		}
+
+		// Allocate all children contiguously, then recurse:
+		const uint32_t first = static_cast<uint32_t>(firstChild.size());
+		for (std::size_t c = 0; c < clusters.size(); c++)
+		{
+			const auto child = newNode();
+			std::memcpy(&centroids[child * B], &C[c * B], B);
+		}
+		firstChild[node] = first;
+		numChildren[node] = static_cast<uint32_t>(clusters.size());
+
+		for (std::size_t c = 0; c < clusters.size(); c++)
+			build(first + static_cast<uint32_t>(c), clusters[c], level + 1);
+	}
+};
+}  // namespace
+
+void CVisualVocabulary::train(
+	const std::vector<CFeatureList>& images, const TTrainingParams& params)
+{
+	MRPT_START
+
+	ASSERT_GE_(params.branching, 2U);
+	ASSERT_GE_(params.levels, 1U);
+	ASSERT_GE_(params.max_iterations, 1U);
+
+	// Gather all descriptors:
+	std::vector<uint8_t> data;
+	std::vector<uint32_t> imageOf;
+	std::size_t B = 0;
+	for (std::size_t img = 0; img < images.size(); img++)
+	{
+		for (const auto& f : images[img])
+		{
+			const auto& d = f.getBinaryDescriptor(params.descriptor);
+			if (B == 0) B = d.size();
+			ASSERT_EQUAL_(d.size(), B);
+			data.insert(data.end(), d.begin(), d.end());
+			imageOf.push_back(static_cast<uint32_t>(img));
+		}
+	}
+	ASSERTMSG_(!imageOf.empty(), "No training descriptors");
+
+	VocabularyBuilder vb(data, B, params);
+	std::vector<uint32_t> all(imageOf.size());
+	for (std::size_t i = 0; i < all.size(); i++)
+		all[i] = static_cast<uint32_t>(i);
+
+	const auto root = vb.newNode();
+	vb.build(root, all, 0);
+
+	m_descriptor = params.descriptor;
+	m_descBytes = static_cast<uint32_t>(B);
+	m_words = vb.nWords;
+	m_firstChild = std::move(vb.firstChild);
+	m_numChildren = std::move(vb.numChildren);
+	m_word = std::move(vb.word);
+	m_centroids = std::move(vb.centroids);
+
+	// IDF weights: log(N/N_i)
+	std::vector<uint32_t> imagesWithWord(m_words, 0);
+	std::vector<uint32_t> lastImage(
+		m_words, std::numeric_limits<uint32_t>::max());
+	for (std::size_t i = 0; i < imageOf.size(); i++)
+	{
+		const auto w = vb.wordOfDescriptor[i];
+		if (lastImage[w] == imageOf[i]) continue;
+		lastImage[w] = imageOf[i];
+		imagesWithWord[w]++;
+	}
+	m_idf.resize(m_words);
+	for (uint32_t w = 0; w < m_words; w++)
+		m_idf[w] = static_cast<float>(
+			std::log(double(images.size()) / double(imagesWithWord[w])));
+
+	MRPT_END
+}
+
+TVisualWordID CVisualVocabulary::quantize(const uint8_t* descriptor) const
+{
+	ASSERTMSG_(!empty(), "The vocabulary is empty");
+	uint32_t node = 0;
+	while (m_numChildren[node] != 0)
+	{
+		const uint32_t first = m_firstChild[node];
+		uint32_t best = first, bestDist = std::numeric_limits<uint32_t>::max();
+		for (uint32_t c = first; c < first + m_numChildren[node]; c++)
+		{
+			const auto d = hamming_distance(
+				descriptor, &m_centroids[c * m_descBytes], m_descBytes);
+			if (d < bestDist)
+			{
+				bestDist = d;
+				best = c;
+			}
+		}
+		node = best;
+	}
+	return m_word[node];
+}
+
+void CVisualVocabulary::transform(
+	const CFeatureList& feats, TBagOfWords& out,
+	std::vector<TVisualWordID>* out_words) const
+{
+	MRPT_START
+
+	out.clear();
+	std::vector<TVisualWordID> words;
+	words.reserve(feats.size());
+	for (const auto& f : feats)
+	{
+		const auto& d = f.getBinaryDescriptor(m_descriptor);
+		ASSERT_EQUAL_(d.size(), m_descBytes);
+		words.push_back(quantize(d.data()));
+	}
+	if (out_words) *out_words = words;
+	if (words.empty()) return;
+
+	// TF-IDF: (n_w/n) * idf_w, then L1 normalization:
+	std::sort(words.begin(), words.end());
+	double sum = 0;
+	for (std::size_t i = 0; i < words.size();)
+	{
+		std::size_t j = i;
+		while (j < words.size() && words[j] == words[i])
+			j++;
+		const double w = double(j - i) / words.size() * m_idf[words[i]];
+		if (w > 0)
+		{
+			out.emplace_back(words[i], static_cast<float>(w));
+			sum += w;
+		}
+		i = j;
+	}
+	if (sum > 0)
+		for (auto& p : out)
+			p.second = static_cast<float>(p.second / sum);
+
+	MRPT_END
+}
+
+uint8_t CVisualVocabulary::serializeGetVersion() const { return 0; }
+void CVisualVocabulary::serializeTo(mrpt::serialization::CArchive& out) const
+{
+	out << static_cast<uint16_t>(m_descriptor) << m_descBytes << m_words
+		<< m_firstChild << m_numChildren << m_word << m_centroids << m_idf;
+}
+
+void CVisualVocabulary::serializeFrom(
+	mrpt::serialization::CArchive& in, uint8_t version)
+{
+	switch (version)
+	{
+		case 0:
+		{
+			uint16_t desc;
+			in >> desc >> m_descBytes >> m_words >> m_firstChild >>
+				m_numChildren >> m_word >> m_centroids >> m_idf;
+			m_descriptor = static_cast<TDescriptorType>(desc);
+			ASSERT_EQUAL_(m_firstChild.size(), m_numChildren.size());
+			ASSERT_EQUAL_(m_firstChild.size(), m_word.size());
+			ASSERT_EQUAL_(m_centroids.size(), m_descBytes * m_word.size());
+			ASSERT_EQUAL_(m_idf.size(), m_words);
+		}
+		break;
+		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
+	};
+}
@@ -0,0 +1,165 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/random/RandomGenerators.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/vision/CBoWDatabase.h>
+#include <mrpt/vision/CVisualVocabulary.h>
+
+using namespace mrpt::vision;
+
+namespace
+{
+// Synthetic "scene": each image has features drawn from its own subset of
+// descriptor prototypes, plus a few bits of noise.
+struct SyntheticScenes
+{
+	static constexpr size_t NUM_IMAGES = 20, FEATS_PER_IMAGE = 40;
+
+	std::vector<std::vector<uint8_t>> prototypes;
+
+	SyntheticScenes()
+	{
+		auto& rng = mrpt::random::getRandomGenerator();
+		prototypes.resize(NUM_IMAGES * FEATS_PER_IMAGE);
+		for (auto& p : prototypes)
+		{
+			p.resize(32);
+			for (auto& b : p)
+				b = static_cast<uint8_t>(rng.drawUniform32bit());
+		}
+	}
+
+	CFeatureList image(size_t idx, unsigned int noiseBits) const
+	{
+		auto& rng = mrpt::random::getRandomGenerator();
+		CFeatureList lst;
+		for (size_t i = 0; i < FEATS_PER_IMAGE; i++)
+		{
+			auto d = prototypes[idx * FEATS_PER_IMAGE + i];
+			for (unsigned int k = 0; k < noiseBits; k++)
+			{
+				const auto bit = rng.drawUniform32bit() % 256;
+				d[bit / 8] ^= static_cast<uint8_t>(1 << (bit % 8));
+			}
+			CFeature f;
+			f.type = featORB;
+			f.descriptors.ORB = d;
+			lst.emplace_back(std::move(f));
+		}
+		return lst;
+	}
+};
+}  // namespace
+
+TEST(CVisualVocabulary, trainAndQuery)
+{
+	mrpt::random::getRandomGenerator().randomize(1234);
+	const SyntheticScenes scenes;
+
+	std::vector<CFeatureList> training;
+	for (size_t i = 0; i < SyntheticScenes::NUM_IMAGES; i++)
+		training.push_back(scenes.image(i, 0));
+
+	CVisualVocabulary::TTrainingParams params;
+	params.branching = 6;
+	params.levels = 4;
+	CVisualVocabulary voc;
+	voc.train(training, params);
+	EXPECT_FALSE(voc.empty());
+	EXPECT_EQ(voc.descriptorBytes(), 32U);
+	EXPECT_GT(voc.wordCount(), SyntheticScenes::NUM_IMAGES);
+	EXPECT_LE(voc.wordCount(), 6U * 6U * 6U * 6U);
+
+	CBoWDatabase db;
+	for (const auto& img : training)
+	{
+		const auto bow = voc.transform(img);
+		ASSERT_FALSE(bow.empty());
+		double sum = 0;
+		for (const auto& wv : bow)
+			sum += wv.second;
+		EXPECT_NEAR(sum, 1.0, 1e-4);
+		db.add(bow);
+	}
+	EXPECT_EQ(db.size(), SyntheticScenes::NUM_IMAGES);
+
+	// Noisy views of each image must retrieve it:
+	size_t hits = 0;
+	std::vector<CBoWDatabase::TResult> res;
+	for (size_t i = 0; i < SyntheticScenes::NUM_IMAGES; i++)
+	{
+		db.query(voc.transform(scenes.image(i, 4)), 3, res);
+		ASSERT_FALSE(res.empty());
+		EXPECT_LE(res.size(), 3U);
+		for (size_t k = 1; k < res.size(); k++)
+			EXPECT_GE(res[k - 1].score, res[k].score);
+		if (res[0].image == i) hits++;
+	}
+	EXPECT_GE(hits, SyntheticScenes::NUM_IMAGES - 1);
+
+	// Exact query: score 1
+	db.query(voc.transform(training[3]), 1, res);
+	ASSERT_EQ(res.size(), 1U);
+	EXPECT_EQ(res[0].image, 3U);
+	EXPECT_NEAR(res[0].score, 1.0, 1e-4);
+
+	// maxImageID:
+	db.query(voc.transform(training[10]), 5, res, 9);
+	for (const auto& r : res)
+		EXPECT_LE(r.image, 9U);
+}
+
+TEST(CVisualVocabulary, serialization)
+{
+	mrpt::random::getRandomGenerator().randomize(4321);
+	const SyntheticScenes scenes;
+
+	std::vector<CFeatureList> training;
+	for (size_t i = 0; i < 5; i++)
+		training.push_back(scenes.image(i, 0));
+
+	CVisualVocabulary voc;
+	voc.train(training);
+	CBoWDatabase db;
+	for (const auto& img : training)
+		db.add(voc.transform(img));
+
+	mrpt::io::CMemoryStream buf;
+	auto arch = mrpt::serialization::archiveFrom(buf);
+	arch << voc << db;
+	buf.Seek(0);
+
+	CVisualVocabulary voc2;
+	CBoWDatabase db2;
+	arch >> voc2 >> db2;
+
+	EXPECT_EQ(voc2.wordCount(), voc.wordCount());
+	EXPECT_EQ(db2.size(), db.size());
+
+	const auto query = scenes.image(2, 3);
+	std::vector<TVisualWordID> w1, w2;
+	TBagOfWords bow1, bow2;
+	voc.transform(query, bow1, &w1);
+	voc2.transform(query, bow2, &w2);
+	EXPECT_EQ(w1, w2);
+	EXPECT_EQ(bow1, bow2);
+
+	std::vector<CBoWDatabase::TResult> r1, r2;
+	db.query(bow1, 5, r1);
+	db2.query(bow2, 5, r2);
+	ASSERT_EQ(r1.size(), r2.size());
+	for (size_t i = 0; i < r1.size(); i++)
+	{
+		EXPECT_EQ(r1[i].image, r2[i].image);
+		EXPECT_DOUBLE_EQ(r1[i].score, r2[i].score);
+	}
+}
@@ -0,0 +1,99 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/config.h>
+
+#if MRPT_ARCH_INTEL_COMPATIBLE
+// ---------------------------------------------------------------------------
+//   This file contains the AVX2 kernels for binary descriptor matching.
+//   It is compiled with "-mavx2" and must be only called after checking
+//   mrpt::cpu::supports(mrpt::cpu::feature::AVX2).
+// ---------------------------------------------------------------------------
+
+#include <immintrin.h>
+
+#include "binary_descriptors.SIMD.h"
+
+namespace
+{
+// Number of set bits of each byte, looking up each nibble in a table
+// (W. Mula's algorithm):
+inline __m256i popcount_bytes(const __m256i x)
+{
+	// clang-format off
+	const __m256i lut = _mm256_setr_epi8(
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	// clang-format on
+	const __m256i low_mask = _mm256_set1_epi8(0x0f);
+
+	const __m256i lo = _mm256_and_si256(x, low_mask);
+	const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), low_mask);
+	return _mm256_add_epi8(
+		_mm256_shuffle_epi8(lut, lo), _mm256_shuffle_epi8(lut, hi));
+}
+
+// Sum of the four 64bit lanes, whose values (from _mm256_sad_epu8()) fit in
+// 32 bits. It only extracts 32bit lanes, which also works in 32bit builds:
+inline uint32_t hsum_epi64(const __m256i v)
+{
+	__m128i s = _mm_add_epi64(
+		_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+	s = _mm_add_epi64(s, _mm_unpackhi_epi64(s, s));
+	return static_cast<uint32_t>(_mm_cvtsi128_si32(s));
+}
+
+inline __m256i load(const uint8_t* p)
+{
+	return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+}  // namespace
+
+/** Hamming distances between one query descriptor and `nRows` train
+ * descriptors, stored every `stride` bytes.
+ *  - <b>Preconditions:</b> `stride` is a multiple of 32. The query is
+ * `stride` bytes long. Padding bytes are zero.
+ */
+void binary_descriptors_AVX2_hamming(
+	const uint8_t* query, const uint8_t* train, std::size_t nRows,
+	std::size_t stride, uint32_t* out)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const std::size_t nWords = stride / 32;
+
+	if (nWords == 1)
+	{
+		// Most common case (ORB): keep the query in a register
+		const __m256i q = load(query);
+		for (std::size_t r = 0; r < nRows; r++, train += stride)
+		{
+			const __m256i cnt =
+				popcount_bytes(_mm256_xor_si256(q, load(train)));
+			out[r] = hsum_epi64(_mm256_sad_epu8(cnt, zero));
+		}
+		return;
+	}
+
+	for (std::size_t r = 0; r < nRows; r++, train += stride)
+	{
+		// Byte counters are reduced into 64bit lanes after each word:
+		__m256i acc = zero;
+		for (std::size_t w = 0; w < nWords; w++)
+		{
+			const __m256i cnt = popcount_bytes(
+				_mm256_xor_si256(load(query + 32 * w), load(train + 32 * w)));
+			acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, zero));
+		}
+		out[r] = hsum_epi64(acc);
+	}
+}
+
+#endif	// MRPT_ARCH_INTEL_COMPATIBLE
@@ -0,0 +1,20 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/config.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// See documentation in binary_descriptors.AVX2.cpp
+
+void binary_descriptors_AVX2_hamming(
+	const uint8_t* query, const uint8_t* train, std::size_t nRows,
+	std::size_t stride, uint32_t* out);
@@ -0,0 +1,215 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/TaskScheduler.h>
+#include <mrpt/core/cpu.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/vision/binary_descriptors.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "binary_descriptors.SIMD.h"
+
+using namespace mrpt::vision;
+
+namespace
+{
+inline uint32_t popcount64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return static_cast<uint32_t>(__builtin_popcountll(x));
+#else
+	x = x - ((x >> 1) & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return static_cast<uint32_t>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+inline uint64_t load_u64(const uint8_t* p)
+{
+	uint64_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+// Portable version of hamming_distances(), for strides multiple of 8 bytes:
+void hamming_distances_u64(
+	const uint8_t* query, const uint8_t* train, std::size_t nRows,
+	std::size_t stride, uint32_t* out)
+{
+	const std::size_t nWords = stride / 8;
+	for (std::size_t r = 0; r < nRows; r++, train += stride)
+	{
+		uint32_t d = 0;
+		for (std::size_t w = 0; w < nWords; w++)
+			d += popcount64(load_u64(query + 8 * w) ^ load_u64(train + 8 * w));
+		out[r] = d;
+	}
+}
+
+void hamming_distances_dispatch(
+	const uint8_t* query, const TBinaryDescriptorMatrix& train, uint32_t* out)
+{
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	static const bool hasAVX2 = mrpt::cpu::supports(mrpt::cpu::feature::AVX2);
+	if (hasAVX2)
+	{
+		binary_descriptors_AVX2_hamming(
+			query, train.data(), train.rows(), train.rowStride(), out);
+		return;
+	}
+#endif
+	hamming_distances_u64(
+		query, train.data(), train.rows(), train.rowStride(), out);
+}
+
+struct TBestCandidate
+{
+	uint32_t distance = std::numeric_limits<uint32_t>::max();
+	uint32_t idx = 0;
+};
+}  // namespace
+
+void TBinaryDescriptorMatrix::resize(std::size_t nRows, std::size_t bytesPerRow)
+{
+	m_rows = nRows;
+	m_bytesPerRow = bytesPerRow;
+	m_stride =
+		ROW_ALIGNMENT * ((bytesPerRow + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT);
+	m_data.assign(m_rows * m_stride, 0);
+}
+
+void TBinaryDescriptorMatrix::clear()
+{
+	m_rows = m_bytesPerRow = m_stride = 0;
+	m_data.clear();
+	m_data.shrink_to_fit();
+	type = descAny;
+}
+
+uint32_t mrpt::vision::hamming_distance(
+	const uint8_t* a, const uint8_t* b, std::size_t nBytes)
+{
+	uint32_t d = 0;
+	std::size_t i = 0;
+	for (; i + 8 <= nBytes; i += 8)
+		d += popcount64(load_u64(a + i) ^ load_u64(b + i));
+	for (; i < nBytes; i++)
+		d += popcount64(static_cast<uint8_t>(a[i] ^ b[i]));
+	return d;
+}
+
+void mrpt::vision::hamming_distances(
+	const uint8_t* query, const TBinaryDescriptorMatrix& train,
+	std::vector<uint32_t>& out_distances)
+{
+	out_distances.resize(train.rows());
+	if (train.empty()) return;
+	hamming_distances_dispatch(query, train, out_distances.data());
+}
+
+std::vector<TBinaryDescriptorMatch> mrpt::vision::match_binary_descriptors(
+	const TBinaryDescriptorMatrix& query, const TBinaryDescriptorMatrix& train,
+	const TBinaryMatchingOptions& options)
+{
+	MRPT_START
+
+	std::vector<TBinaryDescriptorMatch> matches;
+	if (query.empty() || train.empty()) return matches;
+
+	ASSERT_EQUAL_(query.bytesPerRow(), train.bytesPerRow());
+	ASSERT_EQUAL_(query.rowStride(), train.rowStride());
+
+	const std::size_t nQ = query.rows(), nT = train.rows();
+
+	// Give each task at least ~1M descriptor comparisons:
+	std::size_t nTasks = options.num_threads != 0
+		? options.num_threads
+		: mrpt::TaskScheduler::Instance().concurrency();
+	nTasks = std::max<std::size_t>(
+		1, std::min(nTasks, (nQ * nT) / (std::size_t(1) << 20)));
+	nTasks = std::min(nTasks, nQ);
+	const std::size_t grain = (nQ + nTasks - 1) / nTasks;
+
+	// Per query: best and second best distances:
+	std::vector<TBinaryDescriptorMatch> best(nQ);
+
+	// Per train row: best query (only for cross checking). Partial results
+	// are merged in order of increasing query indices, so keeping the first
+	// strict minimum preserves "lowest index wins" on ties:
+	using best_of_train_t = std::vector<TBestCandidate>;
+	const best_of_train_t bestOfTrain = mrpt::parallel_reduce(
+		0, nQ, grain, best_of_train_t(),
+		[&](std::size_t i0, std::size_t i1) {
+			std::vector<uint32_t> d(nT);
+			best_of_train_t bt(options.cross_check ? nT : 0);
+			for (std::size_t i = i0; i < i1; i++)
+			{
+				hamming_distances_dispatch(query.row(i), train, d.data());
+
+				uint32_t d1 = std::numeric_limits<uint32_t>::max(), d2 = d1;
+				uint32_t j1 = 0;
+				for (std::size_t j = 0; j < nT; j++)
+				{
+					const uint32_t dj = d[j];
+					if (dj < d1)
+					{
+						d2 = d1;
+						d1 = dj;
+						j1 = static_cast<uint32_t>(j);
+					}
+					else if (dj < d2)
+						d2 = dj;
+				}
+				auto& b = best[i];
+				b.query_idx = static_cast<uint32_t>(i);
+				b.train_idx = j1;
+				b.distance = d1;
+				b.second_distance = d2;
+
+				if (options.cross_check)
+				{
+					for (std::size_t j = 0; j < nT; j++)
+						if (d[j] < bt[j].distance)
+						{
+							bt[j].distance = d[j];
+							bt[j].idx = static_cast<uint32_t>(i);
+						}
+				}
+			}
+			return bt;
+		},
+		[](best_of_train_t a, const best_of_train_t& b) {
+			if (a.empty()) return best_of_train_t(b);
+			for (std::size_t j = 0; j < b.size(); j++)
+				if (b[j].distance < a[j].distance) a[j] = b[j];
+			return a;
+		});
+
+	matches.reserve(nQ);
+	for (const auto& b : best)
+	{
+		if (b.distance > options.max_distance) continue;
+		if (options.ratio > 0 &&
+			b.second_distance != std::numeric_limits<uint32_t>::max() &&
+			!(b.distance < options.ratio * b.second_distance))
+			continue;
+		if (options.cross_check &&
+			bestOfTrain[b.train_idx].idx != b.query_idx)
+			continue;
+		matches.push_back(b);
+	}
+	return matches;
+
+	MRPT_END
+}
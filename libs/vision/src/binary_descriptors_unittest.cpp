@@ -0,0 +1,225 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/random/RandomGenerators.h>
+#include <mrpt/vision/CFeature.h>
+#include <mrpt/vision/binary_descriptors.h>
+#include <mrpt/vision/utils.h>
+
+#include <limits>
+
+using namespace mrpt::vision;
+
+static void randomBinaryFeatures(
+	CFeatureList& lst, size_t n, size_t descLen, TDescriptorType type)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	lst.clear();
+	for (size_t i = 0; i < n; i++)
+	{
+		CFeature f;
+		f.type = featORB;
+		f.keypoint.ID = i;
+		std::vector<uint8_t> d(descLen);
+		for (auto& b : d)
+			b = static_cast<uint8_t>(rng.drawUniform32bit());
+		if (type == descORB) f.descriptors.ORB = d;
+		else
+			f.descriptors.LATCH = d;
+		lst.emplace_back(std::move(f));
+	}
+}
+
+static uint32_t naiveHamming(
+	const std::vector<uint8_t>& a, const std::vector<uint8_t>& b)
+{
+	uint32_t d = 0;
+	for (size_t i = 0; i < a.size(); i++)
+		for (int bit = 0; bit < 8; bit++)
+			d += ((a[i] ^ b[i]) >> bit) & 1;
+	return d;
+}
+
+TEST(BinaryDescriptors, hammingDistances)
+{
+	mrpt::random::getRandomGenerator().randomize(123);
+
+	// 32 bytes (ORB), and lengths requiring several words or padding:
+	for (size_t len : {32U, 64U, 13U, 48U})
+	{
+		CFeatureList feats;
+		randomBinaryFeatures(feats, 50, len, descLATCH);
+		feats.buildDescriptorMatrix(descLATCH);
+		ASSERT_TRUE(feats.hasDescriptorMatrix(descLATCH));
+		EXPECT_FALSE(feats.hasDescriptorMatrix(descORB));
+
+		const auto& M = feats.descriptorMatrix();
+		EXPECT_EQ(M.rows(), feats.size());
+		EXPECT_EQ(M.bytesPerRow(), len);
+		EXPECT_EQ(M.rowStride() % TBinaryDescriptorMatrix::ROW_ALIGNMENT, 0U);
+
+		std::vector<uint32_t> dists;
+		for (size_t i = 0; i < feats.size(); i++)
+		{
+			hamming_distances(M.row(i), M, dists);
+			ASSERT_EQ(dists.size(), feats.size());
+			for (size_t j = 0; j < feats.size(); j++)
+			{
+				const auto& di = *feats[i].descriptors.LATCH;
+				const auto& dj = *feats[j].descriptors.LATCH;
+				const uint32_t expected = naiveHamming(di, dj);
+				EXPECT_EQ(dists[j], expected);
+				EXPECT_EQ(
+					hamming_distance(di.data(), dj.data(), len), expected);
+			}
+		}
+	}
+}
+
+TEST(BinaryDescriptors, matrixInvalidation)
+{
+	CFeatureList feats;
+	randomBinaryFeatures(feats, 10, 32, descORB);
+	feats.buildDescriptorMatrix(descORB);
+	EXPECT_TRUE(feats.hasDescriptorMatrix(descORB));
+
+	feats.push_back(feats[0]);
+	EXPECT_FALSE(feats.hasDescriptorMatrix(descORB));
+
+	// Features without the requested descriptor:
+	EXPECT_ANY_THROW(feats.buildDescriptorMatrix(descLATCH));
+	// Non-binary descriptors:
+	EXPECT_ANY_THROW(feats.buildDescriptorMatrix(descSIFT));
+}
+
+TEST(BinaryDescriptors, bruteForceMatching)
+{
+	mrpt::random::getRandomGenerator().randomize(1234);
+
+	CFeatureList feats1, feats2;
+	randomBinaryFeatures(feats1, 300, 32, descORB);
+	randomBinaryFeatures(feats2, 200, 32, descORB);
+
+	// Make some pairs close to each other:
+	for (size_t i = 0; i < 100; i++)
+	{
+		auto d = *feats1[2 * i].descriptors.ORB;
+		d[i % 32] ^= 0x01;
+		feats2[i].descriptors.ORB = d;
+	}
+	feats1.buildDescriptorMatrix(descORB);
+	feats2.buildDescriptorMatrix(descORB);
+
+	// Brute force reference:
+	const size_t N1 = feats1.size(), N2 = feats2.size();
+	std::vector<TBinaryDescriptorMatch> ref(N1);
+	std::vector<uint32_t> bestOf2(N2, std::numeric_limits<uint32_t>::max());
+	std::vector<uint32_t> bestIdxOf2(N2, 0);
+	for (size_t i = 0; i < N1; i++)
+	{
+		auto& r = ref[i];
+		r.query_idx = i;
+		r.distance = r.second_distance = std::numeric_limits<uint32_t>::max();
+		for (size_t j = 0; j < N2; j++)
+		{
+			const auto d = naiveHamming(
+				*feats1[i].descriptors.ORB, *feats2[j].descriptors.ORB);
+			if (d < r.distance)
+			{
+				r.second_distance = r.distance;
+				r.distance = d;
+				r.train_idx = j;
+			}
+			else if (d < r.second_distance)
+				r.second_distance = d;
+			if (d < bestOf2[j])
+			{
+				bestOf2[j] = d;
+				bestIdxOf2[j] = i;
+			}
+		}
+	}
+
+	for (unsigned int nThreads : {1U, 3U, 0U})
+	{
+		for (int mode = 0; mode < 3; mode++)
+		{
+			TBinaryMatchingOptions opts;
+			opts.num_threads = nThreads;
+			if (mode == 1) opts.ratio = 0.7f;
+			if (mode == 2)
+			{
+				opts.cross_check = true;
+				opts.max_distance = 10;
+			}
+
+			std::vector<TBinaryDescriptorMatch> expected;
+			for (const auto& r : ref)
+			{
+				if (r.distance > opts.max_distance) continue;
+				if (mode == 1 && !(r.distance < opts.ratio * r.second_distance))
+					continue;
+				if (mode == 2 && bestIdxOf2[r.train_idx] != r.query_idx)
+					continue;
+				expected.push_back(r);
+			}
+
+			const auto matches = match_binary_descriptors(
+				feats1.descriptorMatrix(), feats2.descriptorMatrix(), opts);
+
+			ASSERT_EQ(matches.size(), expected.size());
+			for (size_t k = 0; k < matches.size(); k++)
+			{
+				EXPECT_EQ(matches[k].query_idx, expected[k].query_idx);
+				EXPECT_EQ(matches[k].train_idx, expected[k].train_idx);
+				EXPECT_EQ(matches[k].distance, expected[k].distance);
+				EXPECT_EQ(
+					matches[k].second_distance, expected[k].second_distance);
+			}
+			if (mode != 0) EXPECT_GE(matches.size(), 100U);
+		}
+	}
+}
+
+TEST(BinaryDescriptors, matchFeaturesORB)
+{
+	mrpt::random::getRandomGenerator().randomize(12345);
+
+	CFeatureList feats1, feats2;
+	randomBinaryFeatures(feats1, 50, 32, descORB);
+	randomBinaryFeatures(feats2, 50, 32, descORB);
+	for (size_t i = 0; i < feats2.size(); i++)
+	{
+		// feats2[i] is a noisy copy of feats1[49-i]:
+		auto d = *feats1[49 - i].descriptors.ORB;
+		d[i % 32] ^= 0x11;
+		feats2[i].descriptors.ORB = d;
+	}
+
+	TMatchingOptions opts;
+	opts.matching_method = TMatchingOptions::mmDescriptorORB;
+	opts.useEpipolarRestriction = false;
+	opts.useXRestriction = false;
+	opts.maxORB_dist = 20;
+
+	// With and without precomputed descriptor matrices:
+	for (int pass = 0; pass < 2; pass++)
+	{
+		if (pass == 1)
+		{
+			feats1.buildDescriptorMatrix(descORB);
+			feats2.buildDescriptorMatrix(descORB);
+		}
+		CMatchedFeatureList matches;
+		EXPECT_EQ(matchFeatures(feats1, feats2, matches, opts), 50U);
+		for (const auto& m : matches)
+			EXPECT_EQ(m.first.keypoint.ID + m.second.keypoint.ID, 49U);
+	}
+}
@@ -11,6 +11,7 @@
 //
 #include <mrpt/3rdparty/do_opencv_includes.h>
 #include <mrpt/config/CConfigFileMemory.h>
+#include <mrpt/core/TaskScheduler.h>
 #include <mrpt/system/filesystem.h>
 #include <mrpt/vision/chessboard_camera_calib.h>
 #include <mrpt/vision/chessboard_find_corners.h>
@@ -100,30 +101,61 @@ bool mrpt::vision::checkerBoardCameraCalibration(
 			}
 		}
 
-		// First: Assure all images are loaded:
-		// -------------------------------------------
-		TCalibrationImageList::iterator it;
-		for (it = images.begin(); it != images.end(); ++it)
-		{
-			TImageCalibData& dat = it->second;
+		// Load the images (if needed) and detect the checkerboard in all of
+		// them, in parallel:
+		// -------------------------------------------------------------------
+		vector<TCalibrationImageList::iterator> imgIts;
+		for (auto it = images.begin(); it != images.end(); ++it)
+			imgIts.push_back(it);
 
-			dat.projectedPoints_distorted.clear();	// Clear reprojected points.
+		struct TDetection
+		{
+			TImageSize size{0, 0};
+			bool found = false;
+			vector<TPixelCoordf> corners;
+		};
+		vector<TDetection> detections(imgIts.size());
+
+		const auto detectImage = [&](size_t idx) {
+			const string& file = imgIts[idx]->first;
+			TImageCalibData& dat = imgIts[idx]->second;
+
+			// Clear reprojected points:
+			dat.projectedPoints_distorted.clear();
 			dat.projectedPoints_undistorted.clear();
 
 			// Skip if images are marked as "externalStorage":
 			if (!dat.img_original.isExternallyStored() &&
-				!mrpt::system::extractFileExtension(it->first).empty())
+				!mrpt::system::extractFileExtension(file).empty())
 			{
-				if (!dat.img_original.loadFromFile(it->first))
+				if (!dat.img_original.loadFromFile(file))
 					THROW_EXCEPTION_FMT(
-						"Error reading image: %s", it->first.c_str());
+						"Error reading image: %s", file.c_str());
 
 				dat.img_checkboard = dat.img_original;
 				dat.img_rectified = dat.img_original;
 			}
-		}
 
-		// For each image, find checkerboard corners:
+			// Make grayscale version:
+			const CImage img_gray(
+				dat.img_original, FAST_REF_OR_CONVERT_TO_GRAY);
+
+			// Do detection (this includes the "refine corners" with
+			// cvFindCornerSubPix):
+			TDetection& det = detections[idx];
+			det.size = img_gray.getSize();
+			det.found = mrpt::vision::findChessboardCorners(
+				img_gray, det.corners, check_size_x, check_size_y,
+				normalize_image,  // normalize_image
+				useScaramuzzaAlternativeDetector);
+		};
+		// One task per image, since detection times vary a lot:
+		mrpt::parallel_for(0, imgIts.size(), 1, [&](size_t i0, size_t i1) {
+			for (size_t idx = i0; idx < i1; idx++)
+				detectImage(idx);
+		});
+
+		// For each image, check the found checkerboard corners:
 		// -----------------------------------------------
 		vector<vector<cv::Point3f>>
 			objectPoints;  // final container for detected stuff
@@ -134,25 +166,23 @@ bool mrpt::vision::checkerBoardCameraCalibration(
 		vector<string> pointsIdx2imageFile;
 		cv::Size imgSize(0, 0);
 
+		TCalibrationImageList::iterator it;
 		unsigned int i;
 		for (i = 0, it = images.begin(); it != images.end(); it++, i++)
 		{
 			TImageCalibData& dat = it->second;
-
-			// Make grayscale version:
-			const CImage img_gray(
-				dat.img_original, FAST_REF_OR_CONVERT_TO_GRAY);
+			const TDetection& det = detections[i];
 
 			if (!i)
 			{
-				imgSize = cv::Size(img_gray.getWidth(), img_gray.getHeight());
+				imgSize = cv::Size(det.size.x, det.size.y);
 				out_camera_params.ncols = imgSize.width;
 				out_camera_params.nrows = imgSize.height;
 			}
 			else
 			{
-				if (imgSize.height != (int)img_gray.getHeight() ||
-					imgSize.width != (int)img_gray.getWidth())
+				if (imgSize.height != det.size.y ||
+					imgSize.width != det.size.x)
 				{
 					std::cout << "ERROR: All the images must have the same size"
 							  << std::endl;
@@ -163,7 +193,7 @@ bool mrpt::vision::checkerBoardCameraCalibration(
 			// Try with expanded versions of the image if it fails to detect the
 			// checkerboard:
 			unsigned corners_count;
-			bool corners_found = false;
+			bool corners_found = det.found;
 
 			corners_count = CORNERS_COUNT;
 
@@ -173,14 +203,7 @@ bool mrpt::vision::checkerBoardCameraCalibration(
 
 			dat.detected_corners.clear();
 
-			// Do detection (this includes the "refine corners" with
-			// cvFindCornerSubPix):
-			vector<TPixelCoordf> detectedCoords;
-			corners_found = mrpt::vision::findChessboardCorners(
-				img_gray, detectedCoords, check_size_x, check_size_y,
-				normalize_image,  // normalize_image
-				useScaramuzzaAlternativeDetector);
-
+			const vector<TPixelCoordf>& detectedCoords = det.corners;
 			corners_count = detectedCoords.size();
 
 			// Copy the data into the overall array of coords:
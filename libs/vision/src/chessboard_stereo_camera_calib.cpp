@@ -10,6 +10,7 @@
 #include "vision-precomp.h"	 // Precompiled headers
 //
 #include <mrpt/config/CConfigFileMemory.h>
+#include <mrpt/core/TaskScheduler.h>
 #include <mrpt/math/CVectorDynamic.h>
 #include <mrpt/math/robust_kernels.h>
 #include <mrpt/math/wrap2pi.h>
@@ -22,6 +23,7 @@
 
 #include <Eigen/Dense>
 #include <algorithm>  // reverse()
+#include <numeric>	// accumulate()
 
 #include "chessboard_stereo_camera_calib_internal.h"
 
@@ -39,6 +41,18 @@ using namespace mrpt::poses;
 using namespace mrpt::math;
 using namespace std;
 
+namespace
+{
+// Grain for mrpt::parallel_for() over `n` items, with at most `numThreads`
+// parallel tasks (0: one task per item, to balance uneven loads):
+size_t grain_for_num_threads(size_t n, unsigned int numThreads)
+{
+	return numThreads != 0
+		? std::max<size_t>(1, (n + numThreads - 1) / numThreads)
+		: 1;
+}
+}  // namespace
+
 /* -------------------------------------------------------
 				checkerBoardStereoCalibration
    ------------------------------------------------------- */
@@ -74,6 +88,61 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 		// are valid pairs to be used
 		// in the optimization
 
+		// Detect the checkerboards in all the left/right images in parallel
+		// (image "j" is the left (even j) or right (odd j) one of pair j/2):
+		std::vector<TImageSize> detectedImgSizes(2 * images.size());
+		std::vector<uint8_t> cornersFound(2 * images.size(), 0);
+
+		const auto detectImage = [&](size_t j) {
+			TImageCalibData& dat =
+				(j % 2) == 0 ? images[j / 2].left : images[j / 2].right;
+			dat.detected_corners.clear();
+
+			// Make grayscale version:
+			const CImage img_gray(
+				dat.img_original, FAST_REF_OR_CONVERT_TO_GRAY);
+			detectedImgSizes[j] = img_gray.getSize();
+
+			// Do detection (this includes the "refine corners" with
+			// cvFindCornerSubPix):
+			cornersFound[j] = mrpt::vision::findChessboardCorners(
+				img_gray, dat.detected_corners, p.check_size_x,
+				p.check_size_y,
+				p.normalize_image  // normalize_image
+			);
+		};
+
+		// Detect in batches, so the user callback (which may not be
+		// thread-safe) is called from this thread after each one:
+		const size_t nImgs = 2 * images.size();
+		const size_t batchSize = !p.callback
+			? nImgs
+			: (p.num_threads != 0
+				   ? p.num_threads
+				   : mrpt::TaskScheduler::Instance().concurrency());
+		for (size_t b0 = 0; b0 < nImgs; b0 += batchSize)
+		{
+			const size_t b1 = std::min(nImgs, b0 + batchSize);
+			mrpt::parallel_for(
+				b0, b1, grain_for_num_threads(b1 - b0, p.num_threads),
+				[&](size_t j0, size_t j1) {
+					for (size_t j = j0; j < j1; j++)
+						detectImage(j);
+				});
+
+			if (p.callback)
+			{
+				// User Callback
+				cbPars.calibRound = -1;	 // Detecting corners
+				cbPars.current_iter = 0;
+				cbPars.current_rmse = 0;
+				cbPars.nImgsProcessed = b1;
+				cbPars.nImgsToProcess = nImgs;
+				(*p.callback)(cbPars, p.callback_user_param);
+			}
+		}
+
+		// Check the detected corners, in order:
 		for (size_t i = 0; i < images.size(); i++)
 		{
 			// Do loop for each left/right image:
@@ -83,15 +152,11 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 			for (int lr = 0; lr < 2; lr++)
 			{
 				TImageCalibData& dat = *dats[lr];
-				dat.detected_corners.clear();
-
-				// Make grayscale version:
-				const CImage img_gray(
-					dat.img_original, FAST_REF_OR_CONVERT_TO_GRAY);
+				const TImageSize& thisImgSize = detectedImgSizes[2 * i + lr];
 
 				if (!i)
 				{
-					imgSize[lr] = img_gray.getSize();
+					imgSize[lr] = thisImgSize;
 					if (lr == 0)
 					{
 						out.cam_params.leftCamera.ncols = imgSize[lr].x;
@@ -105,8 +170,8 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 				}
 				else
 				{
-					if (imgSize[lr].y != (int)img_gray.getHeight() ||
-						imgSize[lr].x != (int)img_gray.getWidth())
+					if (imgSize[lr].y != thisImgSize.y ||
+						imgSize[lr].x != thisImgSize.x)
 					{
 						std::cout << "ERROR: All the images in each left/right "
 									 "channel must have the same size."
@@ -115,13 +180,7 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 					}
 				}
 
-				// Do detection (this includes the "refine corners" with
-				// cvFindCornerSubPix):
-				corners_found[lr] = mrpt::vision::findChessboardCorners(
-					img_gray, dat.detected_corners, p.check_size_x,
-					p.check_size_y,
-					p.normalize_image  // normalize_image
-				);
+				corners_found[lr] = cornersFound[2 * i + lr] != 0;
 
 				if (corners_found[lr] &&
 					dat.detected_corners.size() != CORNERS_COUNT)
@@ -132,16 +191,6 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 						"%s img #%u: %s\n", lr == 0 ? "LEFT" : "RIGHT",
 						static_cast<unsigned int>(i),
 						corners_found[lr] ? "DETECTED" : "NOT DETECTED");
-				// User Callback?
-				if (p.callback)
-				{
-					cbPars.calibRound = -1;	 // Detecting corners
-					cbPars.current_iter = 0;
-					cbPars.current_rmse = 0;
-					cbPars.nImgsProcessed = i * 2 + lr + 1;
-					cbPars.nImgsToProcess = images.size() * 2;
-					(*p.callback)(cbPars, p.callback_user_param);
-				}
 
 				if (corners_found[lr])
 				{
@@ -282,9 +331,9 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 		size_t iter = 0;
 		double err = 0;
 		std::vector<size_t> vars_to_optimize;
-		// Hessian matrix  (Declared here so it's accessible as the final
-		// uncertainty measure)
-		mrpt::math::CMatrixDouble H;
+		// Hessian matrix and gradient (Declared here so it's accessible as the
+		// final uncertainty measure)
+		TNormalEquations normEqs;
 
 		for (int calibRound = 0; calibRound < 2; calibRound++)
 		{
@@ -326,17 +375,17 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 			TResidualJacobianList res_jacob;
 			err = recompute_errors_and_Jacobians(
 				lm_stat, res_jacob, false /* no robust */,
-				p.robust_kernel_param);
+				p.robust_kernel_param, p.num_threads);
 
 			// Build linear system:
-			mrpt::math::CVectorDynamic<double> minus_g;	 // minus gradient
-			build_linear_system(res_jacob, vars_to_optimize, minus_g, H);
+			build_linear_system(
+				res_jacob, vars_to_optimize, normEqs, p.num_threads);
 
-			ASSERT_EQUAL_(nUnknowns, (size_t)H.cols());
+			ASSERT_EQUAL_(nUnknowns, normEqs.numUnknowns());
 			// Lev-Marq. parameters:
 			double nu = 2;
-			double lambda = tau * H.asEigen().diagonal().array().maxCoeff();
-			bool done = (minus_g.array().abs().maxCoeff() < t1);
+			double lambda = tau * normEqs.maxDiagonal();
+			bool done = (normEqs.maxAbsGradient() < t1);
 			int numItersImproving = 0;
 			bool use_robust = false;
 
@@ -353,14 +402,8 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 				}
 
 				// Solve for increment: (H + \lambda I) eps = -gradient
-				auto HH = H;
-				for (size_t i = 0; i < nUnknowns; i++)
-					HH(i, i) += lambda;
-				// HH(i,i)*= (1.0 + lambda);
-
-				Eigen::LLT<Eigen::MatrixXd> llt(
-					HH.asEigen().selfadjointView<Eigen::Lower>());
-				if (llt.info() != Eigen::Success)
+				mrpt::math::CVectorDynamic<double> eps;
+				if (!solve_lm_step(normEqs, lambda, eps))
 				{
 					lambda *= nu;
 					nu *= 2;
@@ -373,8 +416,6 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 							 << lambda << endl;
 					continue;
 				}
-				const auto eps = mrpt::math::CVectorDynamic<double>(
-					llt.solve(minus_g.asEigen()).eval());
 
 				const double eps_norm = eps.norm();
 				if (eps_norm < t2 * (eps_norm + t2))
@@ -398,7 +439,7 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 				// discriminant:
 				double err_new = recompute_errors_and_Jacobians(
 					new_lm_stat, new_res_jacob, use_robust,
-					p.robust_kernel_param);
+					p.robust_kernel_param, p.num_threads);
 
 				if (err_new < err)
 				{
@@ -421,10 +462,10 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 
 					err = err_new;
 					build_linear_system(
-						res_jacob, vars_to_optimize, minus_g, H);
+						res_jacob, vars_to_optimize, normEqs, p.num_threads);
 
 					// Too small gradient?
-					done = (minus_g.array().abs().maxCoeff() < t1);
+					done = (normEqs.maxAbsGradient() < t1);
 					// lambda *= max(1.0/3.0, 1-std::pow(2*l-1,3.0) );
 					lambda *= 0.6;
 					lambda = std::max(lambda, 1e-100);
@@ -502,21 +543,23 @@ bool mrpt::vision::checkerBoardStereoCalibration(
 			out.image_pair_was_used[valid_image_pair_indice] = true;
 
 		// Uncertainties ---------------------
-		// The order of inv. variances in the diagonal of the Hessian is:
-		//  * N x Manifold Epsilon of left camera pose (6)
+		// The order of inv. variances in the diagonal of the Hessian block of
+		// the shared variables is:
 		//  * Manifold Epsilon of right2left pose (6)
 		//  * Left-cam-params (<=9)
 		//  * Right-cam-params (<=9)
 		out.left_params_inv_variance.fill(0);
 		out.right_params_inv_variance.fill(0);
-		const size_t base_idx_H_CPs = H.cols() - 2 * nUnknownsCamParams;
+		const auto& H_ss = normEqs.H_ss;
+		const size_t base_idx_H_CPs = 6;
 		for (size_t i = 0; i < nUnknownsCamParams; i++)
 		{
 			out.left_params_inv_variance[vars_to_optimize[i]] =
-				H(base_idx_H_CPs + i, base_idx_H_CPs + i);
+				H_ss(base_idx_H_CPs + i, base_idx_H_CPs + i);
 			out.right_params_inv_variance[vars_to_optimize[i]] =
-				H(base_idx_H_CPs + nUnknownsCamParams + i,
-				  base_idx_H_CPs + nUnknownsCamParams + i);
+				H_ss(
+					base_idx_H_CPs + nUnknownsCamParams + i,
+					base_idx_H_CPs + nUnknownsCamParams + i);
 		}
 
 		// Draw projected points
@@ -753,52 +796,79 @@ static void project_point(
 			 params.dist[2] * (r2 + 2 * square(y)));
 }
 
-// Build the "-gradient" and the Hessian matrix:
-// Variables are in these order:
-//  * N x Manifold Epsilon of left camera pose (6)
-//  * Manifold Epsilon of right2left pose (6)
-//  * Left-cam-params (<=9)
-//  * Right-cam-params (<=9)
+// Build the "-gradient" and the Hessian matrix, in block form (see
+// TNormalEquations).
 void mrpt::vision::build_linear_system(
 	const TResidualJacobianList& res_jac, const std::vector<size_t>& var_indxs,
-	mrpt::math::CVectorDynamic<double>& minus_g, mrpt::math::CMatrixDouble& H)
+	TNormalEquations& ne, unsigned int num_threads)
 {
 	const size_t N = res_jac.size();  // Number of stereo image pairs
-	const size_t nMaxUnknowns = N * 6 + 6 + 9 + 9;
-
-	// Reset to zeros:
-	auto minus_g_tot =
-		mrpt::math::CVectorDynamic<double>::Zero(nMaxUnknowns, 1);
-	auto H_tot = mrpt::math::CMatrixDouble::Zero(nMaxUnknowns, nMaxUnknowns);
 
-	// Sum the contribution from each observation:
-	for (size_t i = 0; i < N; i++)
+	// Indices of the shared variables in each observation Jacobian, whose 30
+	// columns are:
+	//  eps_left_cam (6), eps_right2left_cam (6), left_cam_params (9),
+	//  right_cam_params (9)
+	// Fixed (non-optimizable) camera parameters are ignored.
+	const size_t N_Cs = var_indxs.size();  // [0-8]
+	const size_t nShared = 6 + 2 * N_Cs;
+	std::vector<size_t> sharedIdxs(nShared);
+	for (size_t i = 0; i < 6; i++)
+		sharedIdxs[i] = 6 + i;
+	for (size_t i = 0; i < N_Cs; i++)
 	{
-		const size_t nObs = res_jac[i].size();
-		for (size_t j = 0; j < nObs; j++)
+		sharedIdxs[6 + i] = 12 + var_indxs[i];
+		sharedIdxs[6 + N_Cs + i] = 21 + var_indxs[i];
+	}
+
+	ne.H_pp.resize(N);
+	ne.H_ps.resize(N);
+	ne.minus_g_p.resize(N);
+
+	// Contributions of each image pair to the shared variables blocks:
+	std::vector<Eigen::MatrixXd> H_ss_i(N);
+	std::vector<Eigen::VectorXd> minus_g_s_i(N);
+
+	const auto accumImagePair = [&](size_t i) {
+		// Sum the contribution from each observation of this image pair:
+		Eigen::Matrix<double, 30, 30> Hi;
+		Eigen::Matrix<double, 30, 1> gi;
+		Hi.setZero();
+		gi.setZero();
+		for (const TResidJacobElement& rje : res_jac[i])
 		{
-			const TResidJacobElement& rje = res_jac[i][j];
-			// Sub-Hessian & sub-gradient are variables in this order:
-			//  eps_left_cam, eps_right2left_cam, left_cam_params,
-			//  right_cam_params
-			const Eigen::Matrix<double, 30, 30> Hij = rje.J.transpose() * rje.J;
-			const Eigen::Matrix<double, 30, 1> gij =
-				rje.J.transpose() * rje.residual;
-
-			// Assemble in their place:
-			minus_g_tot.block<6, 1>(i * 6, 0) -= gij.block<6, 1>(0, 0);
-			minus_g_tot.block<6 + 9 + 9, 1>(N * 6, 0) -=
-				gij.block<6 + 9 + 9, 1>(6, 0);
-
-			H_tot.block<6, 6>(i * 6, i * 6) += Hij.block<6, 6>(0, 0);
-
-			H_tot.block<6 + 9 + 9, 6 + 9 + 9>(N * 6, N * 6) +=
-				Hij.block<6 + 9 + 9, 6 + 9 + 9>(6, 6);
-			H_tot.block<6, 6 + 9 + 9>(i * 6, N * 6) +=
-				Hij.block<6, 6 + 9 + 9>(0, 6);
-			H_tot.block<6 + 9 + 9, 6>(N * 6, i * 6) +=
-				Hij.block<6 + 9 + 9, 6>(6, 0);
+			Hi.noalias() += rje.J.transpose() * rje.J;
+			gi.noalias() += rje.J.transpose() * rje.residual;
 		}
+
+		// Assemble in their place:
+		ne.H_pp[i] = Hi.block<6, 6>(0, 0);
+		ne.minus_g_p[i] = -gi.block<6, 1>(0, 0);
+
+		ne.H_ps[i].resize(6, nShared);
+		H_ss_i[i].resize(nShared, nShared);
+		minus_g_s_i[i].resize(nShared);
+		for (size_t c = 0; c < nShared; c++)
+		{
+			ne.H_ps[i].col(c) = Hi.block<6, 1>(0, sharedIdxs[c]);
+			minus_g_s_i[i][c] = -gi[sharedIdxs[c]];
+			for (size_t r = 0; r < nShared; r++)
+				H_ss_i[i](r, c) = Hi(sharedIdxs[r], sharedIdxs[c]);
+		}
+	};
+	mrpt::parallel_for(
+		0, N, grain_for_num_threads(N, num_threads),
+		[&](size_t i0, size_t i1) {
+			for (size_t i = i0; i < i1; i++)
+				accumImagePair(i);
+		});
+
+	// Sum in a fixed order, so results do not depend on the threads:
+	ne.H_ss.setZero(nShared, nShared);
+	ne.minus_g_s.setZero(nShared);
+	for (size_t i = 0; i < N; i++)
+	{
+		ne.H_ss += H_ss_i[i];
+		ne.minus_g_s += minus_g_s_i[i];
 	}
 
 #if 0
@@ -806,70 +876,80 @@ void mrpt::vision::build_linear_system(
 	// -----------------------------------------------------------------
 	// In the left->right pose increment: Add cost if we know that both cameras are almost parallel:
 	const double cost_lr_angular = 1e10;
-	H_tot.block<3,3>(N*6+3,N*6+3) += Eigen::Matrix<double,3,3>::Identity() * cost_lr_angular;
+	ne.H_ss.block<3,3>(3,3) += Eigen::Matrix<double,3,3>::Identity() * cost_lr_angular;
 #endif
 
-	// Ignore those derivatives of "fixed" (non-optimizable) variables in camera
-	// parameters
-	// --------------------------------------------------------------------------------------
-	const size_t N_Cs = var_indxs.size();  // [0-8]
-	const size_t nUnknowns = N * 6 + 6 + 2 * N_Cs;
-	const size_t nUnkPoses = N * 6 + 6;
-
-	minus_g.setZero(nUnknowns, 1);
-	H.setZero(nUnknowns, nUnknowns);
-	// Copy unmodified all but the cam. params:
-	minus_g.asEigen().block(0, 0, nUnkPoses, 1) =
-		minus_g_tot.asEigen().block(0, 0, nUnkPoses, 1);
-	H.asEigen().block(0, 0, nUnkPoses, nUnkPoses) =
-		H_tot.asEigen().block(0, 0, nUnkPoses, nUnkPoses);
-
-	// Selective copy cam. params parts:
-	for (size_t i = 0; i < N_Cs; i++)
-	{
-		minus_g[nUnkPoses + i] = minus_g_tot[nUnkPoses + var_indxs[i]];
-		minus_g[nUnkPoses + N_Cs + i] =
-			minus_g_tot[nUnkPoses + 9 + var_indxs[i]];
-	}
+}  // end of build_linear_system
 
-	for (size_t k = 0; k < nUnkPoses; k++)
-	{
-		for (size_t i = 0; i < N_Cs; i++)
-		{
-			H(nUnkPoses + i, k) = H(k, nUnkPoses + i) =
-				H_tot(k, nUnkPoses + var_indxs[i]);
-			H(nUnkPoses + i + N_Cs, k) = H(k, nUnkPoses + i + N_Cs) =
-				H_tot(k, nUnkPoses + 9 + var_indxs[i]);
-		}
-	}
+double mrpt::vision::TNormalEquations::maxDiagonal() const
+{
+	double m = H_ss.size() ? H_ss.diagonal().maxCoeff() : 0;
+	for (const auto& H : H_pp)
+		m = std::max(m, H.diagonal().maxCoeff());
+	return m;
+}
 
-	for (size_t i = 0; i < N_Cs; i++)
-	{
-		for (size_t j = 0; j < N_Cs; j++)
-		{
-			H(nUnkPoses + i, nUnkPoses + j) =
-				H_tot(nUnkPoses + var_indxs[i], nUnkPoses + var_indxs[j]);
-			H(nUnkPoses + N_Cs + i, nUnkPoses + N_Cs + j) = H_tot(
-				nUnkPoses + 9 + var_indxs[i], nUnkPoses + 9 + var_indxs[j]);
-		}
-	}
+double mrpt::vision::TNormalEquations::maxAbsGradient() const
+{
+	double m = minus_g_s.size() ? minus_g_s.array().abs().maxCoeff() : 0;
+	for (const auto& g : minus_g_p)
+		m = std::max(m, g.array().abs().maxCoeff());
+	return m;
+}
 
-#if 0
+// Normal equations, with the damped poses blocks U_i=H_pp[i]+lambda*I, the
+// cross terms W_i=H_ps[i], and the damped shared block V=H_ss+lambda*I:
+//
+//  [ U    W ] [eps_p]   [ -g_p ]
+//  [ W^t  V ] [eps_s] = [ -g_s ]
+//
+// Eliminating the poses:
+//  (V - sum_i W_i^t U_i^-1 W_i) eps_s = -g_s - sum_i W_i^t U_i^-1 (-g_p_i)
+//  eps_p_i = U_i^-1 (-g_p_i - W_i eps_s)
+//
+// The cost is linear with the number of image pairs, instead of cubic for
+// the dense system.
+bool mrpt::vision::solve_lm_step(
+	const TNormalEquations& ne, double lambda,
+	mrpt::math::CVectorDynamic<double>& eps)
+{
+	const size_t N = ne.numPoses();
+	const size_t nShared = ne.numShared();
+
+	Eigen::MatrixXd S = ne.H_ss;
+	S.diagonal().array() += lambda;
+	Eigen::VectorXd rhs = ne.minus_g_s;
+
+	// U_i^-1 * [W_i, -g_p_i], for each image pair:
+	std::vector<Eigen::MatrixXd> Uinv_W_g(N);
+	for (size_t i = 0; i < N; i++)
 	{
-		CMatrixDouble M1 = H_tot;
-		CMatrixDouble g1 = minus_g_tot;
-		M1.saveToTextFile("H1.txt");
-		g1.saveToTextFile("g1.txt");
-
-		CMatrixDouble M2 = H;
-		CMatrixDouble g2 = minus_g;
-		M2.saveToTextFile("H2.txt");
-		g2.saveToTextFile("g2.txt");
-		mrpt::system::pause();
+		Eigen::Matrix<double, 6, 6> U = ne.H_pp[i];
+		U.diagonal().array() += lambda;
+		const Eigen::LLT<Eigen::Matrix<double, 6, 6>> llt(U);
+		if (llt.info() != Eigen::Success) return false;
+
+		Eigen::MatrixXd W_g(6, nShared + 1);
+		W_g << ne.H_ps[i], ne.minus_g_p[i];
+		Uinv_W_g[i] = llt.solve(W_g);
+
+		S.noalias() -= ne.H_ps[i].transpose() * Uinv_W_g[i].leftCols(nShared);
+		rhs.noalias() -= ne.H_ps[i].transpose() * Uinv_W_g[i].col(nShared);
 	}
-#endif
 
-}  // end of build_linear_system
+	// Reduced system:
+	const Eigen::LLT<Eigen::MatrixXd> llt(S.selfadjointView<Eigen::Lower>());
+	if (llt.info() != Eigen::Success) return false;
+	const Eigen::VectorXd eps_s = llt.solve(rhs);
+
+	// Back-substitution:
+	eps.resize(ne.numUnknowns());
+	for (size_t i = 0; i < N; i++)
+		eps.asEigen().segment<6>(6 * i) = Uinv_W_g[i].col(nShared) -
+			Uinv_W_g[i].leftCols(nShared) * eps_s;
+	eps.asEigen().tail(nShared) = eps_s;
+	return true;
+}
 
 //  * N x Manifold Epsilon of left camera pose (6)
 //  * Manifold Epsilon of right2left pose (6)
@@ -1064,9 +1144,8 @@ void eval_dA_eps_D_p(
 // cameras:
 double mrpt::vision::recompute_errors_and_Jacobians(
 	const lm_stat_t& lm_stat, TResidualJacobianList& res_jac,
-	bool use_robust_kernel, double kernel_param)
+	bool use_robust_kernel, double kernel_param, unsigned int num_threads)
 {
-	double total_err = 0;
 	const size_t N = lm_stat.valid_image_pair_indices.size();
 	res_jac.resize(N);
 
@@ -1093,9 +1172,17 @@ double mrpt::vision::recompute_errors_and_Jacobians(
 	camparam_r.p1(lm_stat.right_cam_params[7]);
 	camparam_r.p2(lm_stat.right_cam_params[8]);
 
-	// process all points from all N image pairs:
-	for (size_t k = 0; k < N; k++)
-	{
+	// Squared errors of each image pair, summed at the end in a fixed order
+	// so the result does not depend on the threads:
+	std::vector<double> pair_errs(N, 0.0);
+
+#if defined(COMPARE_NUMERIC_JACOBIANS)
+	num_threads = 1;  // Debug output to a single file
+#endif
+
+	// process all points from the k'th image pair:
+	const auto processImagePair = [&](size_t k) {
+		double& total_err = pair_errs[k];
 		const size_t k_idx = lm_stat.valid_image_pair_indices[k];
 		const size_t nPts = lm_stat.obj_points.size();
 		res_jac[k].resize(nPts);
@@ -1255,9 +1342,17 @@ double mrpt::vision::recompute_errors_and_Jacobians(
 			}
 #endif
 		}  // for i
-	}  // for k
+	};
+
+	// All N image pairs:
+	mrpt::parallel_for(
+		0, N, grain_for_num_threads(N, num_threads),
+		[&](size_t k0, size_t k1) {
+			for (size_t k = k0; k < k1; k++)
+				processImagePair(k);
+		});
 
-	return total_err;
+	return std::accumulate(pair_errs.begin(), pair_errs.end(), 0.0);
 }  // end of recompute_errors_and_Jacobians
 
 // Ctor:
@@ -10,9 +10,11 @@
 #pragma once
 
 #include <mrpt/core/aligned_std_vector.h>
+#include <mrpt/math/CVectorDynamic.h>
 #include <mrpt/math/geometry.h>
 #include <mrpt/poses/CPose3D.h>
 #include <mrpt/vision/chessboard_camera_calib.h>
+#include <mrpt/vision/chessboard_stereo_camera_calib.h>
 
 #include <Eigen/Dense>
 
@@ -72,13 +74,47 @@ struct TResidJacobElement
 using TResidualJacobianList =
 	std::vector<mrpt::aligned_std_vector<TResidJacobElement>>;
 
+/** Normal equations (H=J'*J and -g=-J'*r) of the Lev-Marq. problem, in block
+ * form. Each left camera pose only appears in the observations of its own
+ * image pair, so the poses part of the Hessian is block-diagonal, and only
+ * the "shared" variables couple all of them. Variables are in this order:
+ *  * N x Manifold Epsilon of left camera pose (6)
+ *  * Shared: Manifold Epsilon of right2left pose (6), left-cam-params (<=9),
+ *    right-cam-params (<=9)
+ */
+struct TNormalEquations
+{
+	/** Per image pair: Hessian block of its left camera pose (6x6) */
+	mrpt::aligned_std_vector<Eigen::Matrix<double, 6, 6>> H_pp;
+	/** Per image pair: Hessian block pose-shared variables (6 x nShared) */
+	std::vector<Eigen::MatrixXd> H_ps;
+	/** Hessian block of the shared variables (nShared x nShared) */
+	Eigen::MatrixXd H_ss;
+	/** Minus gradient, per image pair pose and for the shared variables */
+	mrpt::aligned_std_vector<Eigen::Matrix<double, 6, 1>> minus_g_p;
+	Eigen::VectorXd minus_g_s;
+
+	size_t numPoses() const { return H_pp.size(); }
+	size_t numShared() const { return static_cast<size_t>(H_ss.rows()); }
+	size_t numUnknowns() const { return 6 * numPoses() + numShared(); }
+	double maxDiagonal() const;
+	double maxAbsGradient() const;
+};
+
 // Auxiliary functions for the Lev-Marq algorithm:
 double recompute_errors_and_Jacobians(
 	const lm_stat_t& lm_stat, TResidualJacobianList& res_jac,
-	bool use_robust_kernel, double kernel_param);
+	bool use_robust_kernel, double kernel_param, unsigned int num_threads);
 void build_linear_system(
 	const TResidualJacobianList& res_jac, const std::vector<size_t>& var_indxs,
-	mrpt::math::CVectorDynamic<double>& minus_g, mrpt::math::CMatrixDouble& H);
+	TNormalEquations& ne, unsigned int num_threads);
+/** Solves (H + lambda*I)*eps = -g, by first solving the reduced system of the
+ * shared variables (the Schur complement of the poses blocks), then each
+ * pose from it. Returns false if the system is not positive definite.
+ */
+bool solve_lm_step(
+	const TNormalEquations& ne, double lambda,
+	mrpt::math::CVectorDynamic<double>& eps);
 void add_lm_increment(
 	const mrpt::math::CVectorDynamic<double>& eps,
 	const std::vector<size_t>& var_indxs, lm_stat_t& new_lm_stat);
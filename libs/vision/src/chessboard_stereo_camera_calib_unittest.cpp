@@ -9,9 +9,12 @@
 
 #include <gtest/gtest.h>
 #include <mrpt/config.h>
+#include <mrpt/random.h>
 #include <mrpt/vision/chessboard_stereo_camera_calib.h>
 #include <test_mrpt_common.h>
 
+#include "chessboard_stereo_camera_calib_internal.h"
+
 #if MRPT_HAS_OPENCV
 TEST(Vision, checkerBoardStereoCalibration)
 #else
@@ -103,3 +106,74 @@ TEST(Vision, DISABLED_checkerBoardStereoCalibration_empty)
 		mrpt::vision::checkerBoardStereoCalibration(images, params, out);
 	EXPECT_FALSE(ok);
 }
+
+// The Schur-complement solution of the Lev-Marq. step must be the same than
+// that of the whole (dense) linear system:
+TEST(Vision, checkerBoardStereoCalibration_SchurSolver)
+{
+	using namespace mrpt::vision;
+
+	mrpt::random::Randomize(1234);
+	auto& rng = mrpt::random::getRandomGenerator();
+
+	const size_t N = 6, nObsPerPair = 20;
+	const std::vector<size_t> var_indxs = {0, 1, 2, 3, 4, 5};
+	const size_t nShared = 6 + 2 * var_indxs.size();
+	const size_t nUnknowns = 6 * N + nShared;
+
+	// Columns of the shared variables in each 4x30 Jacobian:
+	std::vector<size_t> sharedCols;
+	for (size_t i = 0; i < 6; i++)
+		sharedCols.push_back(6 + i);
+	for (size_t v : var_indxs)
+		sharedCols.push_back(12 + v);
+	for (size_t v : var_indxs)
+		sharedCols.push_back(21 + v);
+
+	TResidualJacobianList res_jac(N);
+	Eigen::MatrixXd H = Eigen::MatrixXd::Zero(nUnknowns, nUnknowns);
+	Eigen::VectorXd minus_g = Eigen::VectorXd::Zero(nUnknowns);
+	for (size_t i = 0; i < N; i++)
+	{
+		res_jac[i].resize(nObsPerPair);
+		for (auto& rje : res_jac[i])
+		{
+			for (int r = 0; r < 4; r++)
+			{
+				rje.residual[r] = rng.drawGaussian1D_normalized();
+				for (int c = 0; c < 30; c++)
+					rje.J(r, c) = rng.drawGaussian1D_normalized();
+			}
+			// Dense Jacobian wrt all the unknowns:
+			Eigen::MatrixXd J = Eigen::MatrixXd::Zero(4, nUnknowns);
+			J.block<4, 6>(0, 6 * i) = rje.J.block<4, 6>(0, 0);
+			for (size_t c = 0; c < nShared; c++)
+				J.col(6 * N + c) = rje.J.col(sharedCols[c]);
+			H += J.transpose() * J;
+			minus_g -= J.transpose() * rje.residual;
+		}
+	}
+
+	TNormalEquations ne, ne1;
+	build_linear_system(res_jac, var_indxs, ne, 3);
+	build_linear_system(res_jac, var_indxs, ne1, 1);
+	EXPECT_EQ(ne.numUnknowns(), nUnknowns);
+	// Results must not depend on the number of threads:
+	EXPECT_EQ((ne.H_ss - ne1.H_ss).norm(), 0.0);
+	EXPECT_EQ((ne.minus_g_s - ne1.minus_g_s).norm(), 0.0);
+	EXPECT_NEAR(ne.maxDiagonal(), H.diagonal().maxCoeff(), 1e-9);
+	EXPECT_NEAR(ne.maxAbsGradient(), minus_g.array().abs().maxCoeff(), 1e-9);
+
+	for (const double lambda : {1e-3, 10.0})
+	{
+		Eigen::MatrixXd HH = H;
+		HH.diagonal().array() += lambda;
+		const Eigen::VectorXd eps_dense = HH.llt().solve(minus_g);
+
+		mrpt::math::CVectorDynamic<double> eps;
+		ASSERT_TRUE(solve_lm_step(ne, lambda, eps));
+		ASSERT_EQ(static_cast<size_t>(eps.size()), nUnknowns);
+		EXPECT_LT((eps.asEigen() - eps_dense).norm(), 1e-9 * eps_dense.norm())
+			<< "lambda=" << lambda;
+	}
+}
@@ -0,0 +1,190 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/vision/binary_descriptors.h>
+#include <mrpt/vision/descriptor_kdtrees.h>
+
+#include <algorithm>
+#include <queue>
+#include <unordered_set>
+
+using namespace mrpt::vision;
+
+TBinaryDescriptorsMIHIndex::TBinaryDescriptorsMIHIndex(
+	std::size_t descriptorBytes, std::size_t substringBytes)
+	: m_descBytes(descriptorBytes), m_substringBytes(substringBytes)
+{
+	ASSERT_GT_(m_descBytes, 0U);
+	ASSERT_(m_substringBytes >= 1 && m_substringBytes <= 4);
+	m_tables.resize((m_descBytes + m_substringBytes - 1) / m_substringBytes);
+}
+
+TBinaryDescriptorsMIHIndex::TBinaryDescriptorsMIHIndex(
+	const CFeatureList& feats, TDescriptorType descriptor,
+	std::size_t substringBytes)
+	: TBinaryDescriptorsMIHIndex(
+		  feats.empty() ? 32U
+						: feats[0].getBinaryDescriptor(descriptor).size(),
+		  substringBytes)
+{
+	for (std::size_t i = 0; i < feats.size(); i++)
+	{
+		const auto& d = feats[i].getBinaryDescriptor(descriptor);
+		ASSERT_EQUAL_(d.size(), m_descBytes);
+		insert(d.data(), i);
+	}
+}
+
+void TBinaryDescriptorsMIHIndex::clear()
+{
+	m_descriptors.clear();
+	m_userIDs.clear();
+	for (auto& t : m_tables)
+		t.clear();
+}
+
+uint32_t TBinaryDescriptorsMIHIndex::substring(
+	const uint8_t* desc, std::size_t i) const
+{
+	const std::size_t i0 = i * m_substringBytes,
+					  i1 = std::min(m_descBytes, i0 + m_substringBytes);
+	uint32_t key = 0;
+	for (std::size_t b = i0; b < i1; b++)
+		key = (key << 8) | desc[b];
+	return key;
+}
+
+std::size_t TBinaryDescriptorsMIHIndex::substringBits(std::size_t i) const
+{
+	const std::size_t i0 = i * m_substringBytes;
+	return 8 * (std::min(m_descBytes, i0 + m_substringBytes) - i0);
+}
+
+std::size_t TBinaryDescriptorsMIHIndex::insert(
+	const uint8_t* descriptor, uint64_t userID)
+{
+	ASSERTMSG_(
+		m_userIDs.size() < std::numeric_limits<uint32_t>::max(),
+		"Too many descriptors in TBinaryDescriptorsMIHIndex");
+
+	const auto idx = static_cast<uint32_t>(m_userIDs.size());
+	m_descriptors.insert(
+		m_descriptors.end(), descriptor, descriptor + m_descBytes);
+	m_userIDs.push_back(userID);
+
+	for (std::size_t i = 0; i < m_tables.size(); i++)
+		m_tables[i][substring(descriptor, i)].push_back(idx);
+
+	return idx;
+}
+
+std::size_t TBinaryDescriptorsMIHIndex::insert(
+	const CFeatureList& feats, TDescriptorType descriptor, uint64_t userID)
+{
+	const std::size_t first = size();
+	m_descriptors.reserve(m_descriptors.size() + feats.size() * m_descBytes);
+	m_userIDs.reserve(m_userIDs.size() + feats.size());
+	for (const auto& f : feats)
+	{
+		const auto& d = f.getBinaryDescriptor(descriptor);
+		ASSERT_EQUAL_(d.size(), m_descBytes);
+		insert(d.data(), userID);
+	}
+	return first;
+}
+
+std::size_t TBinaryDescriptorsMIHIndex::knnSearch(
+	const uint8_t* query, std::size_t k, std::vector<TResult>& out,
+	const TSearchParams& params) const
+{
+	out.clear();
+	if (k == 0 || empty()) return 0;
+
+	const std::size_t m = m_tables.size();
+
+	// Max-heap with the best k results so far:
+	auto worse = [](const TResult& a, const TResult& b) {
+		return a.distance < b.distance ||
+			(a.distance == b.distance && a.idx < b.idx);
+	};
+	std::priority_queue<TResult, std::vector<TResult>, decltype(worse)> best(
+		worse);
+
+	std::unordered_set<uint32_t> checked;
+	bool candidatesExhausted = false;
+
+	std::vector<uint32_t> keys(m);
+	for (std::size_t i = 0; i < m; i++)
+		keys[i] = substring(query, i);
+
+	for (uint32_t r = 0;
+		 r <= params.max_substring_radius && !candidatesExhausted; r++)
+	{
+		bool anyTableProbed = false;
+		for (std::size_t i = 0; i < m && !candidatesExhausted; i++)
+		{
+			const auto nBits = substringBits(i);
+			if (r > nBits) continue;
+			anyTableProbed = true;
+			const auto& table = m_tables[i];
+
+			// Enumerate all masks with exactly "r" bits set (Gosper's hack):
+			const uint64_t limit = uint64_t(1) << nBits;
+			for (uint64_t mask = (uint64_t(1) << r) - 1; mask < limit;)
+			{
+				const auto it =
+					table.find(keys[i] ^ static_cast<uint32_t>(mask));
+				if (it != table.end())
+				{
+					for (const uint32_t idx : it->second)
+					{
+						if (!checked.insert(idx).second) continue;
+
+						const uint32_t d = hamming_distance(
+							query, descriptor(idx), m_descBytes);
+						if (d <= params.max_distance)
+						{
+							const TResult res(idx, d);
+							if (best.size() < k) best.push(res);
+							else if (worse(res, best.top()))
+							{
+								best.pop();
+								best.push(res);
+							}
+						}
+						if (params.max_candidates != 0 &&
+							checked.size() >= params.max_candidates)
+						{
+							candidatesExhausted = true;
+							break;
+						}
+					}
+				}
+				if (mask == 0 || candidatesExhausted) break;
+				const uint64_t c = mask & (~mask + 1), rr = mask + c;
+				mask = (((rr ^ mask) >> 2) / c) | rr;
+			}
+		}
+		if (!anyTableProbed) break;
+
+		// Entries not found yet have all their substrings at a distance
+		// >r, hence a full distance >= m*(r+1):
+		if (best.size() == k && best.top().distance < m * (r + 1)) break;
+	}
+
+	out.resize(best.size());
+	for (std::size_t i = out.size(); i-- > 0;)
+	{
+		out[i] = best.top();
+		best.pop();
+	}
+	return out.size();
+}
@@ -0,0 +1,137 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/random/RandomGenerators.h>
+#include <mrpt/vision/binary_descriptors.h>
+#include <mrpt/vision/descriptor_kdtrees.h>
+
+#include <algorithm>
+
+using namespace mrpt::vision;
+
+namespace
+{
+// A database of "nKeyframes" keyframes, with "nFeats" ORB features each:
+std::vector<CFeatureList> randomKeyframes(size_t nKeyframes, size_t nFeats)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	std::vector<CFeatureList> kfs(nKeyframes);
+	for (auto& kf : kfs)
+	{
+		kf.resize(nFeats);
+		for (size_t i = 0; i < nFeats; i++)
+		{
+			auto& d = kf[i].descriptors.ORB.emplace(32);
+			for (auto& b : d)
+				b = static_cast<uint8_t>(rng.drawUniform32bit());
+		}
+	}
+	return kfs;
+}
+
+// A copy of "d" with "nFlips" random bits flipped:
+std::vector<uint8_t> addNoise(std::vector<uint8_t> d, unsigned int nFlips)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	for (unsigned int i = 0; i < nFlips; i++)
+	{
+		const auto bit = rng.drawUniform32bit() % (8 * d.size());
+		d[bit / 8] ^= uint8_t(1) << (bit % 8);
+	}
+	return d;
+}
+}  // namespace
+
+TEST(TBinaryDescriptorsMIHIndex, knnSearchVsBruteForce)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(1234);
+
+	const auto kfs = randomKeyframes(20, 100);
+
+	// Incremental insertion, one keyframe at a time:
+	TBinaryDescriptorsMIHIndex index(32);
+	EXPECT_EQ(index.substringCount(), 16U);
+	std::vector<std::vector<uint8_t>> all;
+	for (size_t kf = 0; kf < kfs.size(); kf++)
+	{
+		EXPECT_EQ(index.insert(kfs[kf], descORB, kf), all.size());
+		for (const auto& f : kfs[kf])
+			all.push_back(*f.descriptors.ORB);
+	}
+	ASSERT_EQ(index.size(), all.size());
+
+	const size_t K = 3;
+	for (unsigned int q = 0; q < 200; q++)
+	{
+		const size_t target = rng.drawUniform32bit() % all.size();
+		const auto query = addNoise(all[target], q % 40);
+
+		// Brute force:
+		std::vector<TBinaryDescriptorsMIHIndex::TResult> gt;
+		for (size_t i = 0; i < all.size(); i++)
+			gt.emplace_back(
+				i, hamming_distance(query.data(), all[i].data(), 32));
+		std::sort(gt.begin(), gt.end(), [](const auto& a, const auto& b) {
+			return a.distance < b.distance ||
+				(a.distance == b.distance && a.idx < b.idx);
+		});
+
+		// Exhaustive substring radius: exact results
+		TBinaryDescriptorsMIHIndex::TSearchParams exact;
+		exact.max_substring_radius = 16;
+		std::vector<TBinaryDescriptorsMIHIndex::TResult> res;
+		ASSERT_EQ(index.knnSearch(query.data(), K, res, exact), K);
+		for (size_t i = 0; i < K; i++)
+		{
+			EXPECT_EQ(res[i].idx, gt[i].idx);
+			EXPECT_EQ(res[i].distance, gt[i].distance);
+		}
+
+		// Default params: neighbors below 16*(2+1) bits are always found
+		index.knnSearch(query.data(), K, res);
+		for (size_t i = 0; i < K; i++)
+		{
+			if (gt[i].distance >= 48) break;
+			ASSERT_LT(i, res.size());
+			EXPECT_EQ(res[i].idx, gt[i].idx);
+			EXPECT_EQ(res[i].distance, gt[i].distance);
+		}
+		ASSERT_FALSE(res.empty());
+		EXPECT_EQ(res[0].idx, target);
+		EXPECT_EQ(index.userID(res[0].idx), target / 100);
+	}
+}
+
+TEST(TBinaryDescriptorsMIHIndex, searchParams)
+{
+	mrpt::random::getRandomGenerator().randomize(123);
+	const auto kfs = randomKeyframes(1, 500);
+	const TBinaryDescriptorsMIHIndex index(kfs[0], descORB, 1);
+	EXPECT_EQ(index.substringCount(), 32U);
+	EXPECT_EQ(index.userID(42), 42U);
+
+	const auto query = addNoise(*kfs[0][7].descriptors.ORB, 5);
+	std::vector<TBinaryDescriptorsMIHIndex::TResult> res;
+
+	TBinaryDescriptorsMIHIndex::TSearchParams p;
+	p.max_distance = 10;
+	EXPECT_EQ(index.knnSearch(query.data(), 5, res, p), 1U);
+	EXPECT_EQ(res.at(0).idx, 7U);
+	EXPECT_LE(res.at(0).distance, 5U);
+
+	p = TBinaryDescriptorsMIHIndex::TSearchParams();
+	p.max_substring_radius = 8;
+	p.max_candidates = 3;
+	EXPECT_LE(index.knnSearch(query.data(), 5, res, p), 3U);
+
+	EXPECT_EQ(index.knnSearch(query.data(), 0, res), 0U);
+	EXPECT_TRUE(res.empty());
+}
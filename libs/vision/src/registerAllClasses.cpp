@@ -23,6 +23,8 @@ MRPT_INITIALIZER(registerAllClasses_mrpt_vision)
 {
 #if !defined(DISABLE_MRPT_AUTO_CLASS_REGISTRATION)
 	registerClass(CLASS_ID(CFeature));
+	registerClass(CLASS_ID(CVisualVocabulary));
+	registerClass(CLASS_ID(CBoWDatabase));
 
 	registerClass(CLASS_ID(CLandmark));
 	registerClass(CLASS_ID(CLandmarksMap));
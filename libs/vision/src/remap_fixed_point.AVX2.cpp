@@ -0,0 +1,133 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/config.h>
+
+#if MRPT_ARCH_INTEL_COMPATIBLE
+// ---------------------------------------------------------------------------
+//   This file contains the AVX2 kernels for remapping images with
+//   fixed-point maps. It is compiled with "-mavx2" and must be only called
+//   after checking mrpt::cpu::supports(mrpt::cpu::feature::AVX2).
+// ---------------------------------------------------------------------------
+
+#include <immintrin.h>
+
+#include "remap_fixed_point.h"
+
+using namespace mrpt::vision::internal;
+
+/** Processes 8 output pixels per iteration. Each source pixel and its right
+ * neighbor are read with a 32-bit gather, for the pixel row and the next one.
+ * Groups of 8 pixels with any neighbor (or gathered byte) out of the source
+ * image are done one by one with remap_pixel_8u().
+ * Output is exactly the same than remap_pixel_8u(): the horizontal and
+ * vertical interpolations are done with 16-bit integer weights, with a
+ * single rounding at the end.
+ */
+void remap_fixed_point_AVX2_row_1c(
+	const TFixedPointRemapJob& job, int y, bool bilinear)
+{
+	const std::size_t mapIdx = static_cast<std::size_t>(y) * job.dstWidth;
+	const int16_t* xy = job.mapXY + 2 * mapIdx;
+	const uint16_t* frac = job.mapFrac + mapIdx;
+	uint8_t* d = job.dst + y * job.dstStride;
+	const auto* src = reinterpret_cast<const int*>(job.src);
+	const auto* srcNextRow =
+		reinterpret_cast<const int*>(job.src + job.srcStride);
+
+	// Valid ranges (exclusive) for the 32-bit gathers:
+	const __m256i minusOne = _mm256_set1_epi32(-1);
+	const __m256i maxX = _mm256_set1_epi32(job.srcWidth - 3);
+	const __m256i maxY = _mm256_set1_epi32(job.srcHeight - (bilinear ? 1 : 0));
+	const __m256i stride = _mm256_set1_epi32(static_cast<int>(job.srcStride));
+
+	const __m256i lowByte = _mm256_set1_epi32(0xff);
+	const __m256i fracMask = _mm256_set1_epi32(REMAP_FRAC_MASK);
+	const __m256i fracOne = _mm256_set1_epi32(REMAP_FRAC_ONE);
+	const __m256i rounding =
+		_mm256_set1_epi32(1 << (2 * REMAP_FRAC_BITS - 1));
+	// Bytes 0 and 1 of each 32-bit word into two 16-bit words:
+	// clang-format off
+	const __m256i twoBytesToWords = _mm256_setr_epi8(
+		0, -1, 1, -1, 4, -1, 5, -1, 8, -1, 9, -1, 12, -1, 13, -1,
+		0, -1, 1, -1, 4, -1, 5, -1, 8, -1, 9, -1, 12, -1, 13, -1);
+	// clang-format on
+
+	int x = 0;
+	for (; x + 8 <= job.dstWidth; x += 8)
+	{
+		// 8 (x,y) int16 pairs, as 32-bit words:
+		const __m256i mxy =
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(xy + 2 * x));
+		const __m256i sx = _mm256_srai_epi32(_mm256_slli_epi32(mxy, 16), 16);
+		const __m256i sy = _mm256_srai_epi32(mxy, 16);
+
+		const __m256i inside = _mm256_and_si256(
+			_mm256_and_si256(
+				_mm256_cmpgt_epi32(sx, minusOne),
+				_mm256_cmpgt_epi32(maxX, sx)),
+			_mm256_and_si256(
+				_mm256_cmpgt_epi32(sy, minusOne),
+				_mm256_cmpgt_epi32(maxY, sy)));
+		if (_mm256_movemask_epi8(inside) != -1)
+		{
+			for (int i = x; i < x + 8; i++)
+				remap_pixel_8u(
+					job, xy[2 * i], xy[2 * i + 1], frac[i], d + i, bilinear);
+			continue;
+		}
+
+		const __m256i idx =
+			_mm256_add_epi32(_mm256_mullo_epi32(sy, stride), sx);
+		const __m256i g0 = _mm256_i32gather_epi32(src, idx, 1);
+
+		__m256i res;
+		if (!bilinear) { res = _mm256_and_si256(g0, lowByte); }
+		else
+		{
+			const __m256i g1 = _mm256_i32gather_epi32(srcNextRow, idx, 1);
+
+			const __m256i f = _mm256_cvtepu16_epi32(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(frac + x)));
+			const __m256i fx = _mm256_and_si256(f, fracMask);
+			const __m256i fy = _mm256_and_si256(
+				_mm256_srli_epi32(f, REMAP_FRAC_BITS), fracMask);
+			// (32-f, f) pairs of 16-bit weights:
+			const __m256i wx = _mm256_or_si256(
+				_mm256_sub_epi32(fracOne, fx), _mm256_slli_epi32(fx, 16));
+			const __m256i wy = _mm256_or_si256(
+				_mm256_sub_epi32(fracOne, fy), _mm256_slli_epi32(fy, 16));
+
+			// Horizontal interpolation (<= 255*32, fits in 16 bits):
+			const __m256i top = _mm256_madd_epi16(
+				_mm256_shuffle_epi8(g0, twoBytesToWords), wx);
+			const __m256i bottom = _mm256_madd_epi16(
+				_mm256_shuffle_epi8(g1, twoBytesToWords), wx);
+			// Vertical interpolation:
+			const __m256i v = _mm256_madd_epi16(
+				_mm256_or_si256(top, _mm256_slli_epi32(bottom, 16)), wy);
+			res = _mm256_srli_epi32(
+				_mm256_add_epi32(v, rounding), 2 * REMAP_FRAC_BITS);
+		}
+
+		// 8x32bit -> 8x8bit:
+		const __m256i r16 = _mm256_packus_epi32(res, res);
+		const __m256i r8 = _mm256_packus_epi16(r16, r16);
+		_mm_storel_epi64(
+			reinterpret_cast<__m128i*>(d + x),
+			_mm_unpacklo_epi32(
+				_mm256_castsi256_si128(r8), _mm256_extracti128_si256(r8, 1)));
+	}
+	for (; x < job.dstWidth; x++)
+		remap_pixel_8u(job, xy[2 * x], xy[2 * x + 1], frac[x], d + x, bilinear);
+}
+
+#endif	// MRPT_ARCH_INTEL_COMPATIBLE
@@ -0,0 +1,157 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/TaskScheduler.h>
+#include <mrpt/core/cpu.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "remap_fixed_point.h"
+
+using namespace mrpt::vision::internal;
+
+namespace
+{
+// Plain C++ version, any number of channels:
+template <int CN>
+void remap_row_8u(const TFixedPointRemapJob& job, int y, bool bilinear)
+{
+	const int cn = CN != 0 ? CN : job.channels;
+	const std::size_t mapIdx = static_cast<std::size_t>(y) * job.dstWidth;
+	const int16_t* xy = job.mapXY + 2 * mapIdx;
+	const uint16_t* frac = job.mapFrac + mapIdx;
+	uint8_t* d = job.dst + y * job.dstStride;
+	const std::size_t stride = job.srcStride;
+
+	for (int x = 0; x < job.dstWidth; x++, d += cn)
+	{
+		const int sx = xy[2 * x], sy = xy[2 * x + 1];
+		if (sx < 0 || sy < 0 || sx + 1 >= job.srcWidth ||
+			sy + 1 >= job.srcHeight)
+		{
+			remap_pixel_8u(job, sx, sy, frac[x], d, bilinear);
+			continue;
+		}
+		// All neighbors are within the image:
+		const uint8_t* s = job.src + sy * stride + sx * cn;
+		if (!bilinear)
+		{
+			for (int ch = 0; ch < cn; ch++)
+				d[ch] = s[ch];
+			continue;
+		}
+		const int fx = frac[x] & REMAP_FRAC_MASK;
+		const int fy = (frac[x] >> REMAP_FRAC_BITS) & REMAP_FRAC_MASK;
+		for (int ch = 0; ch < cn; ch++)
+		{
+			const int top = s[ch] * (REMAP_FRAC_ONE - fx) + s[ch + cn] * fx;
+			const int bottom = s[ch + stride] * (REMAP_FRAC_ONE - fx) +
+				s[ch + stride + cn] * fx;
+			d[ch] = static_cast<uint8_t>(
+				(top * (REMAP_FRAC_ONE - fy) + bottom * fy +
+				 (1 << (2 * REMAP_FRAC_BITS - 1))) >>
+				(2 * REMAP_FRAC_BITS));
+		}
+	}
+}
+
+void remap_row_8u_dispatch(
+	const TFixedPointRemapJob& job, int y, bool bilinear,
+	[[maybe_unused]] bool useAVX2)
+{
+	switch (job.channels)
+	{
+		case 1:
+#if MRPT_ARCH_INTEL_COMPATIBLE
+			if (useAVX2)
+			{
+				remap_fixed_point_AVX2_row_1c(job, y, bilinear);
+				return;
+			}
+#endif
+			remap_row_8u<1>(job, y, bilinear);
+			break;
+		case 3: remap_row_8u<3>(job, y, bilinear); break;
+		default: remap_row_8u<0>(job, y, bilinear); break;
+	}
+}
+}  // namespace
+
+bool mrpt::vision::internal::prepare_remap_job(
+	const mrpt::img::CImage& in, mrpt::img::CImage& out, const int16_t* mapXY,
+	const uint16_t* mapFrac, TFixedPointRemapJob& job)
+{
+	using namespace mrpt::img;
+
+	if (in.getPixelDepth() != PixelDepth::D8U ||
+		out.getPixelDepth() != PixelDepth::D8U)
+		return false;
+	const int cn = static_cast<int>(in.getChannelCount());
+	if ((cn != 1 && cn != 3) ||
+		static_cast<int>(out.getChannelCount()) != cn)
+		return false;
+
+	job.src = in.ptrLine<uint8_t>(0);
+	job.srcWidth = static_cast<int>(in.getWidth());
+	job.srcHeight = static_cast<int>(in.getHeight());
+	job.srcStride = in.getRowStride();
+	job.dst = out.ptrLine<uint8_t>(0);
+	job.dstWidth = static_cast<int>(out.getWidth());
+	job.dstHeight = static_cast<int>(out.getHeight());
+	job.dstStride = out.getRowStride();
+	job.channels = cn;
+	job.mapXY = mapXY;
+	job.mapFrac = mapFrac;
+	return true;
+}
+
+void mrpt::vision::internal::remap_fixed_point_8u(
+	const TFixedPointRemapJob* jobs, std::size_t nJobs, bool bilinear,
+	unsigned int numThreads)
+{
+	const bool useAVX2 = mrpt::cpu::supports(mrpt::cpu::feature::AVX2);
+
+	std::size_t totalRows = 0, totalPixels = 0;
+	for (std::size_t i = 0; i < nJobs; i++)
+	{
+		ASSERT_(jobs[i].src != jobs[i].dst);
+		totalRows += jobs[i].dstHeight;
+		totalPixels += static_cast<std::size_t>(jobs[i].dstHeight) *
+			jobs[i].dstWidth;
+	}
+
+	// Processes rows [r0,r1) of the concatenation of all jobs:
+	const auto processRows = [&](std::size_t r0, std::size_t r1) {
+		std::size_t jobFirstRow = 0;
+		for (std::size_t i = 0; i < nJobs && r0 < r1; i++)
+		{
+			const auto& job = jobs[i];
+			const std::size_t jobEnd = jobFirstRow + job.dstHeight;
+			for (; r0 < r1 && r0 < jobEnd; r0++)
+				remap_row_8u_dispatch(
+					job, static_cast<int>(r0 - jobFirstRow), bilinear,
+					useAVX2);
+			jobFirstRow = jobEnd;
+		}
+	};
+
+	// Tasks of at least ~64K output pixels, in the shared TaskScheduler:
+	std::size_t nChunks = numThreads != 0
+		? numThreads
+		: 4 * mrpt::TaskScheduler::Instance().concurrency();
+	nChunks = std::max<std::size_t>(
+		1, std::min(nChunks, totalPixels / (std::size_t(1) << 16)));
+	nChunks = std::min(nChunks, std::max<std::size_t>(1, totalRows));
+
+	mrpt::parallel_for(
+		0, totalRows, (totalRows + nChunks - 1) / nChunks, processRows);
+}
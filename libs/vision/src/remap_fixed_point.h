@@ -0,0 +1,104 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/config.h>
+#include <mrpt/img/CImage.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mrpt::vision::internal
+{
+/** Number of bits of the fractional part of each map coordinate. This is the
+ * format of the maps generated by cv::initUndistortRectifyMap() with
+ * `CV_16SC2` maps, that is, `INTER_BITS` in OpenCV. */
+constexpr int REMAP_FRAC_BITS = 5;
+constexpr int REMAP_FRAC_ONE = 1 << REMAP_FRAC_BITS;
+constexpr int REMAP_FRAC_MASK = REMAP_FRAC_ONE - 1;
+
+/** One image to be remapped with remap_fixed_point_8u().
+ * For each output pixel (x,y) at index i=x+y*dstWidth, the source point is
+ * (mapXY[2*i] + fx/32, mapXY[2*i+1] + fy/32), with fx (lowest 5 bits) and
+ * fy (next 5 bits) from mapFrac[i]. */
+struct TFixedPointRemapJob
+{
+	const uint8_t* src = nullptr;
+	int srcWidth = 0, srcHeight = 0;
+	std::size_t srcStride = 0;
+	uint8_t* dst = nullptr;
+	int dstWidth = 0, dstHeight = 0;
+	std::size_t dstStride = 0;
+	/** Number of channels (bytes per pixel) of both src and dst */
+	int channels = 1;
+	const int16_t* mapXY = nullptr;
+	const uint16_t* mapFrac = nullptr;
+};
+
+/** Fills a job with the given images (the output one must have been already
+ * allocated) and maps. Returns false if any image is not 8-bit with 1 or 3
+ * channels, so the job cannot be done with remap_fixed_point_8u().
+ */
+bool prepare_remap_job(
+	const mrpt::img::CImage& in, mrpt::img::CImage& out,
+	const int16_t* mapXY, const uint16_t* mapFrac,
+	TFixedPointRemapJob& job);
+
+/** Remaps 8-bit images with fixed-point maps, splitting the output rows of
+ * all jobs into tasks for mrpt::TaskScheduler::Instance(). Source pixels out
+ * of the image are taken as zeros.
+ * \param bilinear Bilinear interpolation if true; the integer part of each
+ * coordinate is used otherwise (nearest-neighbor-like, like OpenCV).
+ * \param numThreads Max. number of tasks (0: automatic).
+ */
+void remap_fixed_point_8u(
+	const TFixedPointRemapJob* jobs, std::size_t nJobs, bool bilinear,
+	unsigned int numThreads);
+
+/** Remaps one output pixel (all its channels). Used by all the kernels for
+ * the pixels whose neighbors are not all within the source image. */
+inline void remap_pixel_8u(
+	const TFixedPointRemapJob& job, int sx, int sy, unsigned int frac,
+	uint8_t* dst, bool bilinear)
+{
+	const int cn = job.channels;
+	const auto pixel = [&](int x, int y, int ch) -> int {
+		if (x < 0 || y < 0 || x >= job.srcWidth || y >= job.srcHeight)
+			return 0;
+		return job.src[y * job.srcStride + x * cn + ch];
+	};
+
+	if (!bilinear)
+	{
+		for (int ch = 0; ch < cn; ch++)
+			dst[ch] = static_cast<uint8_t>(pixel(sx, sy, ch));
+		return;
+	}
+	const int fx = frac & REMAP_FRAC_MASK;
+	const int fy = (frac >> REMAP_FRAC_BITS) & REMAP_FRAC_MASK;
+	for (int ch = 0; ch < cn; ch++)
+	{
+		const int top = pixel(sx, sy, ch) * (REMAP_FRAC_ONE - fx) +
+			pixel(sx + 1, sy, ch) * fx;
+		const int bottom = pixel(sx, sy + 1, ch) * (REMAP_FRAC_ONE - fx) +
+			pixel(sx + 1, sy + 1, ch) * fx;
+		dst[ch] = static_cast<uint8_t>(
+			(top * (REMAP_FRAC_ONE - fy) + bottom * fy +
+			 (1 << (2 * REMAP_FRAC_BITS - 1))) >>
+			(2 * REMAP_FRAC_BITS));
+	}
+}
+
+}  // namespace mrpt::vision::internal
+
+// AVX2 kernel (see remap_fixed_point.AVX2.cpp): remaps the output row y of a
+// single-channel job.
+void remap_fixed_point_AVX2_row_1c(
+	const mrpt::vision::internal::TFixedPointRemapJob& job, int y,
+	bool bilinear);
@@ -21,6 +21,18 @@ using namespace mrpt::tfest;
 using namespace mrpt::math;
 using namespace std;
 
+namespace
+{
+// True if both images share the same pixel buffer (e.g. shallow copies)
+bool isSameImageBuffer(const CImage& a, const CImage& b)
+{
+	if (a.isEmpty() || b.isEmpty()) return false;
+	return a.getWidth() == b.getWidth() && a.getHeight() == b.getHeight() &&
+		a.getChannelCount() == b.getChannelCount() &&
+		a.ptrLine<uint8_t>(0) == b.ptrLine<uint8_t>(0);
+}
+}  // namespace
+
 // ------------------------------- internal helper templates
 // ---------------------------------
 namespace mrpt::vision::detail
@@ -454,9 +466,26 @@ void CGenericFeatureTracker::internal_trackFeatures(
 	// =========================================
 	m_timlog.enter("CGenericFeatureTracker.to_grayscale");
 
-	const CImage prev_gray(old_img, FAST_REF_OR_CONVERT_TO_GRAY);
+	// Reuse the conversion of the previous "new_img", if it is "old_img" now:
+	const bool reuse_previous_image =
+		extra_params.getOrDefault<int>("reuse_previous_image", 1) != 0;
+	const CImage prev_gray =
+		(reuse_previous_image && isSameImageBuffer(old_img, m_last_new_img))
+		? m_last_new_img_gray
+		: CImage(old_img, FAST_REF_OR_CONVERT_TO_GRAY);
 	const CImage cur_gray(new_img, FAST_REF_OR_CONVERT_TO_GRAY);
 
+	if (reuse_previous_image)
+	{
+		m_last_new_img = new_img;
+		m_last_new_img_gray = cur_gray;
+	}
+	else
+	{
+		m_last_new_img = CImage();
+		m_last_new_img_gray = CImage();
+	}
+
 	m_timlog.leave("CGenericFeatureTracker.to_grayscale");
 
 	// =================================
@@ -25,6 +25,31 @@ using namespace mrpt::vision;
 using namespace mrpt::img;
 using namespace std;
 
+#if MRPT_HAS_OPENCV
+struct CFeatureTracker_KL::Impl
+{
+	/** Shallow copy of the last "new_img": holding a reference guarantees
+	 * its buffer is not freed and reused by a different image. */
+	CImage lastImg;
+	std::vector<cv::Mat> lastPyramid;
+	cv::Size lastWindow;
+	int lastLevels = -1;
+
+	bool isLastImage(const CImage& img, const cv::Size& win, int levels) const
+	{
+		if (lastLevels != levels || lastWindow != win || lastImg.isEmpty())
+			return false;
+		const cv::Mat& a = img.asCvMatRef();
+		const cv::Mat& b = lastImg.asCvMatRef();
+		return a.data == b.data && a.size == b.size && a.type() == b.type();
+	}
+};
+#else
+struct CFeatureTracker_KL::Impl
+{
+};
+#endif
+
 /** Track a set of features from old_img -> new_img using sparse optimal flow
  *(classic KL method)
  *  Optional parameters that can be passed in "extra_params":
@@ -49,6 +74,8 @@ void CFeatureTracker_KL::trackFeatures_impl_templ(
 	const int LK_epsilon = extra_params.getOrDefault<int>("LK_epsilon", 0.1);
 	const float LK_max_tracking_error =
 		extra_params.getOrDefault<float>("LK_max_tracking_error", 150.0f);
+	const bool reuse_previous_image =
+		extra_params.getOrDefault<int>("reuse_previous_image", 1) != 0;
 
 	// Both images must be of the same size
 	ASSERT_(
@@ -79,13 +106,41 @@ void CFeatureTracker_KL::trackFeatures_impl_templ(
 
 		const cv::Mat& prev = prev_gray.asCvMatRef();
 		const cv::Mat& cur = cur_gray.asCvMatRef();
+		const cv::Size window(window_width, window_height);
+
+		// Pyramids: reuse the one of the previous "new_img", if possible:
+		if (!m_impl) m_impl = mrpt::make_impl<Impl>();
+		std::vector<cv::Mat> prevPyramid, curPyramid;
+		if (reuse_previous_image &&
+			m_impl->isLastImage(old_img, window, LK_levels))
+			prevPyramid = std::move(m_impl->lastPyramid);
+		else
+		{
+			m_timlog.enter("KL.buildPyramid");
+			cv::buildOpticalFlowPyramid(prev, prevPyramid, window, LK_levels);
+			m_timlog.leave("KL.buildPyramid");
+		}
+		m_timlog.enter("KL.buildPyramid");
+		cv::buildOpticalFlowPyramid(cur, curPyramid, window, LK_levels);
+		m_timlog.leave("KL.buildPyramid");
 
+		// (OpenCV tracks the points in parallel, with SIMD kernels)
+		m_timlog.enter("KL.calcOpticalFlowPyrLK");
 		cv::calcOpticalFlowPyrLK(
-			prev, cur, points_prev, points_cur, status, track_error,
-			cv::Size(window_width, window_height), LK_levels,
+			prevPyramid, curPyramid, points_prev, points_cur, status,
+			track_error, window, LK_levels,
 			cv::TermCriteria(
 				cv::TermCriteria::MAX_ITER | cv::TermCriteria::EPS,
 				LK_max_iters, LK_epsilon));
+		m_timlog.leave("KL.calcOpticalFlowPyrLK");
+
+		if (reuse_previous_image)
+		{
+			m_impl->lastImg = new_img;
+			m_impl->lastPyramid = std::move(curPyramid);
+			m_impl->lastWindow = window;
+			m_impl->lastLevels = LK_levels;
+		}
 
 		for (size_t i = 0; i < nFeatures; ++i)
 		{
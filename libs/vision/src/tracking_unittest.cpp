@@ -0,0 +1,138 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2022, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/config.h>
+#include <mrpt/vision/tracking.h>
+
+#include <cmath>
+#include <vector>
+
+#if MRPT_HAS_OPENCV
+
+using namespace mrpt::img;
+using namespace mrpt::vision;
+
+namespace
+{
+constexpr unsigned int W = 320, H = 240;
+
+/** Writes into \a img (RGB) a smooth texture, shifted \a k pixels right and
+ * \a k/2 down. */
+void drawFrame(CImage& img, int k)
+{
+	for (unsigned int y = 0; y < H; y++)
+	{
+		auto* row = img.ptrLine<uint8_t>(y);
+		for (unsigned int x = 0; x < W; x++)
+		{
+			const double u = x - k, v = y - 0.5 * k;
+			const double val = 128 +
+				50 * std::sin(0.21 * u) * std::cos(0.17 * v) +
+				40 * std::sin(0.05 * u + 0.09 * v);
+			for (int c = 0; c < 3; c++)
+				row[3 * x + c] = static_cast<uint8_t>(val + 5 * c);
+		}
+	}
+}
+
+CImage makeFrame(int k)
+{
+	CImage img(W, H, CH_RGB);
+	drawFrame(img, k);
+	return img;
+}
+
+TKeyPointfList initialFeatures()
+{
+	TKeyPointfList feats;
+	for (unsigned int y = 40; y < H - 40; y += 20)
+		for (unsigned int x = 40; x < W - 40; x += 20)
+			feats.emplace_back(x, y);
+	for (size_t i = 0; i < feats.size(); i++)
+		feats[i].ID = i;
+	return feats;
+}
+
+void expectSameFeatures(const TKeyPointfList& a, const TKeyPointfList& b)
+{
+	ASSERT_EQ(a.size(), b.size());
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		EXPECT_EQ(a[i].pt.x, b[i].pt.x) << "i=" << i;
+		EXPECT_EQ(a[i].pt.y, b[i].pt.y) << "i=" << i;
+		EXPECT_EQ(a[i].track_status, b[i].track_status) << "i=" << i;
+	}
+}
+}  // namespace
+
+TEST(CFeatureTracker_KL, reusePreviousImageSameResults)
+{
+	std::vector<CImage> frames;
+	for (int k = 0; k < 6; k++)
+		frames.push_back(makeFrame(k));
+
+	CFeatureTracker_KL trackerReuse, trackerNoReuse;
+	trackerReuse.extra_params["reuse_previous_image"] = 1;
+	trackerNoReuse.extra_params["reuse_previous_image"] = 0;
+	TKeyPointfList featsReuse = initialFeatures(),
+				   featsNoReuse = initialFeatures();
+	const TKeyPointfList feats0 = initialFeatures();
+
+	for (size_t k = 1; k < frames.size(); k++)
+	{
+		trackerReuse.trackFeatures(frames[k - 1], frames[k], featsReuse);
+		trackerNoReuse.trackFeatures(frames[k - 1], frames[k], featsNoReuse);
+		expectSameFeatures(featsReuse, featsNoReuse);
+	}
+
+	// And the features actually followed the texture:
+	size_t nTracked = 0;
+	for (size_t i = 0; i < featsReuse.size(); i++)
+	{
+		if (featsReuse[i].track_status != status_TRACKED) continue;
+		nTracked++;
+		EXPECT_NEAR(featsReuse[i].pt.x, feats0[i].pt.x + 5, 0.5);
+		EXPECT_NEAR(featsReuse[i].pt.y, feats0[i].pt.y + 2.5, 0.5);
+	}
+	EXPECT_GT(nTracked, featsReuse.size() / 2);
+}
+
+TEST(CFeatureTracker_KL, reusePreviousImageModifiedInPlace)
+{
+	// Documented caveat: with reuse_previous_image!=0, modifying "new_img"
+	// in-place before passing it as "old_img" in the next call makes the
+	// tracker use its previous contents.
+	const CImage frame0 = makeFrame(0), frame3 = makeFrame(3);
+
+	for (const bool reuse : {true, false})
+	{
+		CFeatureTracker_KL tracker;
+		tracker.extra_params["reuse_previous_image"] = reuse ? 1 : 0;
+		TKeyPointfList feats = initialFeatures();
+
+		CImage img = makeFrame(1);
+		tracker.trackFeatures(frame0, img, feats);
+		drawFrame(img, 2);	// Same buffer, new contents
+		tracker.trackFeatures(img, frame3, feats);
+
+		// Reference: tracking from the frame the tracker actually used.
+		CFeatureTracker_KL ref;
+		ref.extra_params["reuse_previous_image"] = 0;
+		TKeyPointfList refFeats = initialFeatures();
+		const CImage frame1 = makeFrame(1), frame2 = makeFrame(2);
+		ref.trackFeatures(frame0, frame1, refFeats);
+		ref.trackFeatures(reuse ? frame1 : frame2, frame3, refFeats);
+
+		SCOPED_TRACE(reuse ? "reuse=1" : "reuse=0");
+		expectSameFeatures(feats, refFeats);
+	}
+}
+
+#endif
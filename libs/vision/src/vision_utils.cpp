@@ -23,10 +23,12 @@
 #include <mrpt/system/filesystem.h>
 #include <mrpt/vision/CFeature.h>
 #include <mrpt/vision/CFeatureExtraction.h>
+#include <mrpt/vision/binary_descriptors.h>
 #include <mrpt/vision/pinhole.h>
 #include <mrpt/vision/utils.h>
 
 #include <Eigen/Dense>
+#include <cstring>
 
 using namespace mrpt;
 using namespace mrpt::vision;
@@ -352,9 +354,71 @@ size_t vision::matchFeatures(
 	int minLeftIdx = 0, minRightIdx;
 	int nMatches = 0;
 
-	// For each feature in list1 ...
-	for (lFeat = 0, itList1 = list1.begin(); itList1 != list1.end();
-		 ++itList1, ++lFeat)
+	// Keeps the best pairing for each right feature:
+	auto processCandidate = [&](int leftIdx, int rightIdx, double minVal) {
+		int auxIdx = idxRightList[rightIdx];
+		if (auxIdx != FEAT_FREE)
+		{
+			if (distCorrs[auxIdx] > minVal)
+			{
+				// We've found a better match
+				distCorrs[leftIdx] = minVal;
+				idxLeftList[leftIdx] = rightIdx;
+				idxRightList[rightIdx] = leftIdx;
+
+				distCorrs[auxIdx] = 1.0;
+				idxLeftList[auxIdx] = FEAT_FREE;
+			}  // end-if
+		}  // end-if
+		else
+		{
+			idxRightList[rightIdx] = leftIdx;
+			idxLeftList[leftIdx] = rightIdx;
+			distCorrs[leftIdx] = minVal;
+			nMatches++;
+		}
+	};
+
+	// Fast path for ORB without geometric restrictions: brute-force,
+	// parallel Hamming matching on contiguous descriptor matrices.
+	const bool useBinaryMatcher =
+		options.matching_method == TMatchingOptions::mmDescriptorORB &&
+		!options.useEpipolarRestriction && !options.useXRestriction;
+	if (useBinaryMatcher)
+	{
+		// Reuse the lists' matrices, if the user already built them:
+		TBinaryDescriptorMatrix tmp1, tmp2;
+		auto getMatrix = [](const CFeatureList& l, TBinaryDescriptorMatrix& tmp)
+			-> const TBinaryDescriptorMatrix& {
+			if (l.hasDescriptorMatrix(descORB)) return l.descriptorMatrix();
+			ASSERT_(l[0].descriptors.hasDescriptorORB());
+			const size_t len = l[0].descriptors.ORB->size();
+			tmp.resize(l.size(), len);
+			tmp.type = descORB;
+			for (size_t i = 0; i < l.size(); i++)
+			{
+				const auto& d = l[i].descriptors.ORB;
+				ASSERT_(d.has_value() && d->size() == len);
+				std::memcpy(tmp.row(i), d->data(), len);
+			}
+			return tmp;
+		};
+		const auto& m1 = getMatrix(list1, tmp1);
+		const auto& m2 = getMatrix(list2, tmp2);
+
+		for (const auto& m : match_binary_descriptors(m1, m2))
+		{
+			// Same acceptance criteria than the generic loop below:
+			if (m.distance < options.maxORB_dist)
+				processCandidate(
+					static_cast<int>(m.query_idx),
+					static_cast<int>(m.train_idx), m.distance);
+		}
+	}
+
+	// For each feature in list1 (unless already done above)...
+	for (lFeat = 0, itList1 = list1.begin();
+		 !useBinaryMatcher && itList1 != list1.end(); ++itList1, ++lFeat)
 	{
 		// For SIFT & SURF
 		minDist1 = 1e5;
@@ -597,29 +661,7 @@ size_t vision::matchFeatures(
 
 		// PROCESS THE RESULTS
 		if (cond1 && cond2)	 // The minimum distance must be below a threshold
-		{
-			int auxIdx = idxRightList[minRightIdx];
-			if (auxIdx != FEAT_FREE)
-			{
-				if (distCorrs[auxIdx] > minVal)
-				{
-					// We've found a better match
-					distCorrs[minLeftIdx] = minVal;
-					idxLeftList[minLeftIdx] = minRightIdx;
-					idxRightList[minRightIdx] = minLeftIdx;
-
-					distCorrs[auxIdx] = 1.0;
-					idxLeftList[auxIdx] = FEAT_FREE;
-				}  // end-if
-			}  // end-if
-			else
-			{
-				idxRightList[minRightIdx] = minLeftIdx;
-				idxLeftList[minLeftIdx] = minRightIdx;
-				distCorrs[minLeftIdx] = minVal;
-				nMatches++;
-			}
-		}  // end if
+			processCandidate(minLeftIdx, minRightIdx, minVal);
 	}  // end for 'list1' (left features)
 
 	if (!options.addMatches) matches.clear();